@@ -0,0 +1,606 @@
+'''
+vendor A/B benchmark: runs the same scenario against each backend and
+prints the percentiles side by side, e.g.
+    python ab_bench.py --backend agora=agoradl/build/lib/libagorawrapper.so \
+        --backend zego=zegodl/build/lib/libzegowrapper.so --appid <agora app id> \
+        -n 4 -d 60 --profile 640x480@15:1000 --video wudao_640x480.yuv --audio wudao.wav
+every backend gets the same source media, video profile (rtc_setVideoProfile,
+setVideoEncoderConfiguration on agora and setVideoConfig on zego), robot
+count and duration. the robots of a backend run at the same time, each in
+its own process since a wrapper holds one engine per process; the backends
+run one after the other so they do not compete for the cpu.
+a robot records the stats callbacks with rtc_startStatsRecording and samples
+its own cpu and rss, the runner maps the columns of each vendor onto the
+common metrics of VENDOR_COLUMNS.
+--backend mock runs robots that fake an engine in python, which checks the
+harness without any wrapper. the linux builds of the wrappers run against
+the mock sdks, RTC_MOCK_CONFIG is set up so they report stats every second
+unless it is already set
+'''
+import argparse
+import array
+import ctypes
+import json
+import math
+import os
+import random
+import shutil
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+import wave
+
+import fleet
+import stats_csv
+
+# (metric, label, unit) in report order
+METRICS = [
+    ("encode_fps", "encoder fps", "fps"),
+    ("send_kbps", "video send bitrate", "kbps"),
+    ("recv_kbps", "video recv bitrate", "kbps"),
+    ("audio_kbps", "audio send bitrate", "kbps"),
+    ("rtt", "rtt", "ms"),
+    ("tx_loss", "send loss", "%"),
+    ("rx_loss", "recv loss", "%"),
+    ("delay", "end-to-end delay", "ms"),
+    ("cpu", "process cpu", "%"),
+    ("rss", "process rss", "MB"),
+]
+
+# vendor -> metric -> (stats kind, value of a row). zego reports loss as a
+# fraction and splits the delay into network and jitter buffer
+VENDOR_COLUMNS = {
+    "agora": {
+        "encode_fps": ("local_video", lambda r: r["encoderOutputFrameRate"]),
+        "send_kbps": ("local_video", lambda r: r["sentBitrate"]),
+        "recv_kbps": ("remote_video", lambda r: r["receivedBitrate"]),
+        "audio_kbps": ("local_audio", lambda r: r["sentBitrate"]),
+        "rtt": ("rtc", lambda r: r["gatewayRtt"]),
+        "tx_loss": ("rtc", lambda r: r["txPacketLossRate"]),
+        "rx_loss": ("rtc", lambda r: r["rxPacketLossRate"]),
+        "delay": ("remote_video", lambda r: r["delay"]),
+    },
+    "zego": {
+        "encode_fps": ("publisher", lambda r: r["videoEncodeFPS"]),
+        "send_kbps": ("publisher", lambda r: r["videoKBPS"]),
+        "recv_kbps": ("player", lambda r: r["videoKBPS"]),
+        "audio_kbps": ("publisher", lambda r: r["audioKBPS"]),
+        "rtt": ("publisher", lambda r: r["rtt"]),
+        "tx_loss": ("publisher", lambda r: r["packetLostRate"] * 100),
+        "rx_loss": ("player", lambda r: r["packetLostRate"] * 100),
+        "delay": ("player", lambda r: r["peerToPeerDelay"] + r["delay"]),
+    },
+    "mock": {
+        "encode_fps": ("local", lambda r: r["encode_fps"]),
+        "send_kbps": ("local", lambda r: r["send_kbps"]),
+        "recv_kbps": ("remote", lambda r: r["recv_kbps"]),
+        "audio_kbps": ("local", lambda r: r["audio_kbps"]),
+        "rtt": ("local", lambda r: r["rtt"]),
+        "tx_loss": ("local", lambda r: r["tx_loss"]),
+        "rx_loss": ("remote", lambda r: r["rx_loss"]),
+        "delay": ("remote", lambda r: r["delay"]),
+    },
+}
+
+DEFAULT_DLLS = {
+    "agora": "agoradl/bin/agorawrapper.dll" if sys.platform == "win32" else "agoradl/build/lib/libagorawrapper.so",
+    "zego": "zegodl/bin/zegowrapper.dll" if sys.platform == "win32" else "zegodl/build/lib/libzegowrapper.so",
+}
+
+AUDIO_CHUNK_MS = 10
+
+# kbps the mock reports for an audio profile, numbered like ZegoAudioConfigPreset
+MOCK_AUDIO_KBPS = [16, 48, 56, 128, 192]
+
+
+class VideoSource(object):
+    '''
+    I420 frames of the profile size, read from a raw .yuv file and looped,
+    or a moving gradient so the encoder has something to do
+    '''
+
+    def __init__(self, path, width, height):
+        self.size = width * height * 3 // 2
+        self.file = None
+        self.frames = []
+        if path:
+            self.file = open(path, "rb")
+            return
+        row = bytes(x * 255 // width for x in range(width))
+        luma = row * height
+        chroma = bytes([128]) * (width * height // 2)
+        step = width * height // 60
+        for i in range(60):
+            shift = i * step
+            self.frames.append(luma[shift:] + luma[:shift] + chroma)
+
+    def next(self, index):
+        if self.file is None:
+            return self.frames[index % len(self.frames)]
+        frame = self.file.read(self.size)
+        if len(frame) < self.size:
+            self.file.seek(0)
+            frame = self.file.read(self.size)
+        return frame
+
+
+class AudioSource(object):
+    '''16 bit PCM of a wav file, or a 440Hz tone, in AUDIO_CHUNK_MS chunks'''
+
+    def __init__(self, path, sample_rate, channels):
+        if path:
+            with wave.open(path, "rb") as f:
+                if f.getsampwidth() != 2:
+                    raise ValueError("%s: only 16 bit wav is supported" % path)
+                self.sample_rate = f.getframerate()
+                self.channels = f.getnchannels()
+                self.pcm = f.readframes(f.getnframes())
+        else:
+            self.sample_rate = sample_rate
+            self.channels = channels
+            samples = array.array("h")
+            for i in range(sample_rate):
+                value = int(8000 * math.sin(2 * math.pi * 440 * i / sample_rate))
+                samples.extend([value] * channels)
+            self.pcm = samples.tobytes()
+        self.chunk = self.sample_rate * AUDIO_CHUNK_MS // 1000 * self.channels * 2
+        self.pos = 0
+
+    def next(self):
+        if self.pos + self.chunk > len(self.pcm):
+            self.pos = 0
+        chunk = self.pcm[self.pos:self.pos + self.chunk]
+        self.pos += self.chunk
+        return chunk
+
+
+class MockEngine(object):
+    '''
+    the rtc.RtcEngine calls a robot makes, without a wrapper. the stats
+    are plausible numbers around the profile, except the encoder fps which
+    is what the robot really pushed, and go to a json file
+    '''
+
+    def __init__(self, peers):
+        self.backend = "mock"
+        self.peers = peers
+        self.profile = (640, 480, 15, 1000)
+        self.audio_kbps = 48
+        self.frames = 0
+        self.kinds = {"local": [], "remote": []}
+        self.path = None
+        self.recording = threading.Event()
+        self.random = random.Random()
+
+    def create(self, appid=None):
+        pass
+
+    def destroy(self):
+        pass
+
+    def join(self, channel, uid):
+        self.joinTime = time.time()
+
+    def wait_join(self, timeout_ms):
+        return int((time.time() - self.joinTime) * 1000)
+
+    def leave(self):
+        pass
+
+    def enable_video(self, enable=True):
+        pass
+
+    def enable_audio(self, enable=True):
+        pass
+
+    def set_video_profile(self, width, height, fps, bitrate_kbps):
+        self.profile = (width, height, fps, bitrate_kbps)
+
+    def set_audio_profile(self, profile, codec=None):
+        if not 0 <= profile < len(MOCK_AUDIO_KBPS):
+            raise ValueError("mock audio profile %d" % profile)
+        self.audio_kbps = MOCK_AUDIO_KBPS[profile]
+
+    def enable_custom_video_capture(self):
+        pass
+
+    def enable_custom_audio_capture(self, sample_rate, channels):
+        pass
+
+    def add_view(self, hwnd):
+        pass
+
+    def set_view_size(self, hwnd, width, height):
+        pass
+
+    def enable_headless(self, enable=True):
+        pass
+
+    def push_video_frame(self, i420, width, height, stride=None):
+        self.frames += 1
+
+    def push_audio_frame(self, pcm):
+        pass
+
+    def start_stats_recording(self, path):
+        self.path = path
+        self.recording.set()
+        self.task = threading.Thread(target=self._report, daemon=True)
+        self.task.start()
+
+    def _report(self):
+        frames = self.frames
+        last = time.time()
+        kbps = self.profile[3]
+        while self.recording.is_set():
+            time.sleep(1)
+            now = time.time()
+            unix_us = int(now * 1000000)
+            self.kinds["local"].append({"unix_us": unix_us, "encode_fps": (self.frames - frames) / (now - last),
+                                        "send_kbps": kbps * self.random.uniform(0.9, 1.1), "audio_kbps": self.audio_kbps,
+                                        "rtt": self.random.randint(20, 60), "tx_loss": 0})
+            for _ in range(self.peers):
+                self.kinds["remote"].append({"unix_us": unix_us, "recv_kbps": kbps * self.random.uniform(0.9, 1.1),
+                                             "rx_loss": 0, "delay": self.random.randint(40, 80)})
+            frames = self.frames
+            last = now
+
+    def stop_stats_recording(self):
+        self.recording.clear()
+        self.task.join()
+        with open(self.path, "w") as f:
+            json.dump({"vendor": "mock", "kinds": self.kinds}, f)
+        return sum(len(rows) for rows in self.kinds.values())
+
+    def set_log_level(self, level):
+        pass
+
+
+def rss_mb():
+    '''resident set of this process, None when it can not be read'''
+    if sys.platform == "win32":
+        class PROCESS_MEMORY_COUNTERS(ctypes.Structure):
+            _fields_ = [("cb", ctypes.c_uint32), ("PageFaultCount", ctypes.c_uint32)] + \
+                [(name, ctypes.c_size_t) for name in ("PeakWorkingSetSize", "WorkingSetSize", "QuotaPeakPagedPoolUsage",
+                                                      "QuotaPagedPoolUsage", "QuotaPeakNonPagedPoolUsage",
+                                                      "QuotaNonPagedPoolUsage", "PagefileUsage", "PeakPagefileUsage")]
+        counters = PROCESS_MEMORY_COUNTERS()
+        counters.cb = ctypes.sizeof(counters)
+        process = ctypes.windll.kernel32.GetCurrentProcess()
+        if not ctypes.windll.psapi.GetProcessMemoryInfo(process, ctypes.byref(counters), counters.cb):
+            return None
+        return counters.WorkingSetSize / 1048576.0
+    try:
+        with open("/proc/self/statm") as f:
+            return int(f.read().split()[1]) * os.sysconf("SC_PAGE_SIZE") / 1048576.0
+    except (OSError, ValueError):
+        return None
+
+
+class ProcessSampler(object):
+    '''cpu (100 is one core) and rss of this process once a second'''
+
+    def __init__(self):
+        self.samples = []
+        self.stopped = threading.Event()
+        self.task = threading.Thread(target=self._run, daemon=True)
+        self.task.start()
+
+    def _run(self):
+        times = os.times()
+        cpu = times.user + times.system
+        last = time.time()
+        while not self.stopped.wait(1):
+            times = os.times()
+            now = time.time()
+            sample = {"unix_us": int(now * 1000000), "cpu": (times.user + times.system - cpu) * 100 / (now - last)}
+            rss = rss_mb()
+            if rss is not None:
+                sample["rss"] = rss
+            self.samples.append(sample)
+            cpu = times.user + times.system
+            last = now
+
+    def stop(self):
+        self.stopped.set()
+        self.task.join()
+        return self.samples
+
+
+def add_views(engine, count, headless=False):
+    '''
+    a withdrawn tkinter window of count frames whose handles become the
+    views, the first shows the local preview. both wrappers only subscribe
+    to the remote video that gets a view, and play its low stream as the
+    tiles are small. headless needs no window: the numbers 1..count are the
+    views, all of them for remote streams, which are decoded into a null
+    renderer
+    '''
+    if headless:
+        engine.enable_headless()
+        for view in range(1, count + 1):
+            engine.add_view(view)
+            engine.set_view_size(view, 160, 120)
+        return None
+    if count <= 0:
+        return None
+    import tkinter
+    window = tkinter.Tk()
+    window.withdraw()
+    for _ in range(count):
+        frame = tkinter.Frame(window, width=160, height=120)
+        frame.pack()
+        engine.add_view(frame.winfo_id())
+        engine.set_view_size(frame.winfo_id(), 160, 120)
+    window.update()
+    return window
+
+
+def push_video(engine, source, width, height, fps, stop):
+    interval = 1.0 / fps
+    due = time.time()
+    index = 0
+    while not stop.is_set():
+        engine.push_video_frame(source.next(index), width, height)
+        index += 1
+        due += interval
+        delay = due - time.time()
+        if delay > 0:
+            time.sleep(delay)
+        else:
+            # fell behind, do not burst to catch up
+            due = time.time()
+
+
+def push_audio(engine, source, stop):
+    interval = AUDIO_CHUNK_MS / 1000.0
+    due = time.time()
+    while not stop.is_set():
+        engine.push_audio_frame(source.next())
+        due += interval
+        delay = due - time.time()
+        if delay > 0:
+            time.sleep(delay)
+
+
+def run_robot(config):
+    '''one robot, started by the runner with --robot <config json>'''
+    width, height, fps, kbps = config["profile"]
+    if config["backend"] == "mock":
+        engine = MockEngine(config["robots"] - 1)
+    else:
+        import rtc
+        engine = rtc.RtcEngine(config["dll"])
+    video = VideoSource(config["video"], width, height)
+    audio = AudioSource(config["audio"], config["sampleRate"], config["channels"])
+
+    result = {"pid": os.getpid(), "start_us": int(time.time() * 1000000), "join_ms": None}
+    engine.create(config["appid"])
+    try:
+        window = add_views(engine, config["views"], config["headless"])
+        engine.set_video_profile(width, height, fps, kbps)
+        if config["audioProfile"] is not None:
+            engine.set_audio_profile(config["audioProfile"], config["audioCodec"])
+        engine.enable_custom_video_capture()
+        engine.enable_custom_audio_capture(audio.sample_rate, audio.channels)
+        engine.start_stats_recording(config["stats"])
+        engine.join(config["channel"], config["uid"])
+        result["join_ms"] = engine.wait_join(config["joinTimeoutMs"])
+        if result["join_ms"] is not None:
+            sampler = ProcessSampler()
+            stop = threading.Event()
+            # push_audio_frame blocks while the capture buffer is full, the
+            # threads are daemons so a stalled sdk can not hang the robot
+            tasks = [threading.Thread(target=push_video, args=(engine, video, width, height, fps, stop), daemon=True),
+                     threading.Thread(target=push_audio, args=(engine, audio, stop), daemon=True)]
+            for task in tasks:
+                task.start()
+            time.sleep(config["duration"])
+            stop.set()
+            for task in tasks:
+                task.join(1)
+            result["process"] = sampler.stop()
+        result["samples"] = engine.stop_stats_recording()
+        engine.leave()
+    finally:
+        engine.destroy()
+
+    with open(config["result"], "w") as f:
+        json.dump(result, f)
+
+
+def load_stats(path):
+    '''rows of every kind as dicts, the mock writes json instead of a stats file'''
+    with open(path, "rb") as f:
+        mock = f.read(1) == b"{"
+    if mock:
+        with open(path) as f:
+            stats = json.load(f)
+        return stats["vendor"], stats["kinds"]
+    header, _ = stats_csv.read(path)
+    kinds = {}
+    for kind in header["kinds"].values():
+        names = ["unix_us", kind["key"]] + [name for name, _ in kind["fields"]]
+        kinds[kind["name"]] = [dict(zip(names, row)) for row in kind["rows"]]
+    return header["vendor"], kinds
+
+
+def collect(workdir, robots, warmup_s):
+    '''
+    metric -> values of every robot after the warmup, the join times and
+    the number of robots that did not finish
+    '''
+    values = dict((name, []) for name, _, _ in METRICS)
+    joins = []
+    failed = 0
+    for i in range(robots):
+        path = os.path.join(workdir, "robot_%d.json" % i)
+        if not os.path.exists(path):
+            failed += 1
+            continue
+        with open(path) as f:
+            result = json.load(f)
+        if result["join_ms"] is None:
+            failed += 1
+            continue
+        joins.append(result["join_ms"])
+        since = result["start_us"] + result["join_ms"] * 1000 + int(warmup_s * 1000000)
+
+        vendor, kinds = load_stats(os.path.join(workdir, "robot_%d.stats" % i))
+        for name, (kind, value) in VENDOR_COLUMNS[vendor].items():
+            values[name].extend(value(row) for row in kinds.get(kind, []) if row["unix_us"] >= since)
+        for sample in result.get("process", []):
+            if sample["unix_us"] < since:
+                continue
+            for name in ("cpu", "rss"):
+                if name in sample:
+                    values[name].append(sample[name])
+    return values, joins, failed
+
+
+def summarize(values):
+    if not values:
+        return None
+    return {"n": len(values), "mean": sum(values) / len(values), "p50": fleet.percentile(values, 50),
+            "p90": fleet.percentile(values, 90), "p99": fleet.percentile(values, 99), "max": max(values)}
+
+
+def run_backend(args, name, dll, workdir, channel):
+    width, height, fps, kbps = args.profile
+    env = dict(os.environ)
+    if "RTC_MOCK_CONFIG" not in env:
+        # only read by the mock sdks, the other robots are the simulated peers
+        env["RTC_MOCK_CONFIG"] = json.dumps({"peers": args.robots - 1, "statsIntervalMs": 1000, "qualityIntervalMs": 1000,
+                                             "captureWidth": width, "captureHeight": height, "captureFps": fps})
+    processes = []
+    for i in range(args.robots):
+        config = {"backend": name, "dll": dll, "appid": args.appid, "channel": channel, "uid": str(1000 + i),
+                  "robots": args.robots, "views": args.views, "headless": args.headless, "profile": args.profile, "video": args.video, "audio": args.audio,
+                  "audioProfile": args.audio_profile, "audioCodec": args.audio_codec,
+                  "sampleRate": args.sample_rate, "channels": args.channels, "duration": args.duration,
+                  "joinTimeoutMs": args.join_timeout * 1000,
+                  "stats": os.path.join(workdir, "robot_%d.stats" % i), "result": os.path.join(workdir, "robot_%d.json" % i)}
+        processes.append(subprocess.Popen([sys.executable, os.path.abspath(__file__), "--robot", json.dumps(config)], env=env))
+
+    deadline = time.time() + args.join_timeout + args.duration + 30
+    for p in processes:
+        try:
+            p.wait(max(1, deadline - time.time()))
+        except subprocess.TimeoutExpired:
+            p.kill()
+            p.wait()
+
+    values, joins, failed = collect(workdir, args.robots, args.warmup)
+    return {"dll": dll, "robots": args.robots, "failed": failed, "join_ms": summarize(joins),
+            "metrics": dict((metric, summarize(values[metric])) for metric, _, _ in METRICS)}
+
+
+def format_cell(summary):
+    if summary is None:
+        return "%-30s" % "-"
+    return "%-30s" % ("%.1f/%.1f/%.1f n:%d" % (summary["p50"], summary["p90"], summary["p99"], summary["n"]))
+
+
+def report(args, results):
+    width, height, fps, kbps = args.profile
+    print("scenario: %d robots x %ds (%ds warmup), %dx%d@%dfps %dkbps, video %s, audio %s" % (
+        args.robots, args.duration, args.warmup, width, height, fps, kbps,
+        args.video or "gradient", args.audio or "440Hz %dHz/%dch" % (args.sample_rate, args.channels)))
+    names = list(results)
+    print("%-20s %-5s %s" % ("p50/p90/p99", "", "".join("%-30s" % name for name in names)))
+    for metric, label, unit in METRICS:
+        print("%-20s %-5s %s" % (label, unit, "".join(format_cell(results[name]["metrics"][metric]) for name in names)))
+    print("%-20s %-5s %s" % ("join", "ms", "".join(format_cell(results[name]["join_ms"]) for name in names)))
+    print("%-20s %-5s %s" % ("failed robots", "", "".join("%-30d" % results[name]["failed"] for name in names)))
+
+
+def parse_profile(text):
+    '''WxH@FPS:KBPS'''
+    try:
+        size, rest = text.split("@")
+        width, height = size.split("x")
+        fps, kbps = rest.split(":")
+        return [int(width), int(height), int(fps), int(kbps)]
+    except ValueError:
+        raise argparse.ArgumentTypeError("expected WxH@FPS:KBPS, e.g. 640x480@15:1000")
+
+
+def parse_backend(text):
+    name, _, dll = text.partition("=")
+    if name not in VENDOR_COLUMNS:
+        raise argparse.ArgumentTypeError("backend is one of %s" % ", ".join(VENDOR_COLUMNS))
+    if name != "mock" and not dll:
+        dll = DEFAULT_DLLS[name]
+    return name, dll
+
+
+def add_scenario_arguments(parser):
+    '''the options of a scenario that every run shares, sweep_bench.py uses them too'''
+    parser.add_argument("-n", "--robots", type=int, default=2, help="robots per backend, in one channel")
+    parser.add_argument("-d", "--duration", type=int, default=30, help="seconds every robot publishes")
+    parser.add_argument("-w", "--warmup", type=int, default=5, help="seconds after the join that are not counted")
+    parser.add_argument("--video", help="raw I420 file of the profile size, looped; a moving gradient by default")
+    parser.add_argument("--audio", help="16 bit wav, looped; a 440Hz tone by default")
+    parser.add_argument("--sample-rate", type=int, default=48000, help="of the tone")
+    parser.add_argument("--channels", type=int, default=1, choices=(1, 2), help="of the tone")
+    parser.add_argument("--views", type=int, default=0,
+                        help="views of every robot in a hidden tkinter window, 0 subscribes no remote video")
+    parser.add_argument("--headless", action="store_true",
+                        help="no window and no preview, the --views are slots whose remote video is decoded into a null renderer")
+    parser.add_argument("--appid", help="agora app id, zego has its id built in")
+    parser.add_argument("--join-timeout", type=int, default=30, help="seconds a robot waits for its join")
+    parser.add_argument("--keep", action="store_true", help="keep the stats files of the robots")
+    parser.add_argument("--robot", help=argparse.SUPPRESS)
+
+
+def run_scenario(args, name, dll, label):
+    '''the robots of one backend in a channel of their own, returns the summaries'''
+    workdir = tempfile.mkdtemp(prefix="ab_%s_" % name)
+    channel = "ab_%d_%d" % (os.getpid(), int(time.time() * 1000) % 100000000)
+    print("%s: %d robots for %ds%s" % (label, args.robots, args.duration, " (" + dll + ")" if dll else ""))
+    result = run_backend(args, name, dll, workdir, channel)
+    if args.keep:
+        print("%s: stats in %s" % (label, workdir))
+    else:
+        shutil.rmtree(workdir, ignore_errors=True)
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description="run the same scenario against each backend and compare")
+    parser.add_argument("--backend", type=parse_backend, action="append", metavar="NAME[=DLL]",
+                        help="agora, zego or mock, repeat to compare; the dll defaults to the build output")
+    parser.add_argument("--profile", type=parse_profile, default=[640, 480, 15, 1000], help="WxH@FPS:KBPS")
+    parser.add_argument("--audio-profile", type=int, help="vendor audio preset, AUDIO_PROFILE_TYPE or ZegoAudioConfigPreset")
+    parser.add_argument("--audio-codec", help="che.audio.specify.codec name (agora) or ZegoAudioCodecID (zego)")
+    parser.add_argument("-o", "--output", help="also write the summaries as json")
+    add_scenario_arguments(parser)
+    args = parser.parse_args()
+
+    if args.robot:
+        run_robot(json.loads(args.robot))
+        return
+
+    backends = args.backend or [("mock", "")]
+    if any(name == "agora" for name, _ in backends) and not args.appid:
+        parser.error("agora needs --appid")
+
+    results = {}
+    for name, dll in backends:
+        label = name
+        while label in results:
+            label += "'"
+        results[label] = run_scenario(args, name, dll, label)
+
+    report(args, results)
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump({"scenario": {"robots": args.robots, "duration": args.duration, "warmup": args.warmup,
+                                    "profile": args.profile, "video": args.video, "audio": args.audio},
+                       "backends": results}, f, indent=2)
+
+
+if __name__ == '__main__':
+    main()
@@ -1,11 +1,12 @@
 import ctypes
 import os
-import tkinter
 import json
 import sys
 import random
 import numpy as np
 import threading, queue
+import fleet
+import config_abi
 
 
 
@@ -20,6 +21,14 @@ profile = {"bitrate": "1000", "fps": "15", "resolution": str(v_w)+"*"+str(v_h)}
 uid = random.randint(0,1000)
 
 isRobot = False
+# no window and no preview, the remote video is decoded into a null renderer
+headless = False
+# the remote audio is pulled into no device every 10ms (rtc_startAudioSink), a robot then
+# decodes the audio of the channel like a listener would, without a sound card
+audioSink = False
+# an existing directory: every remote user goes to <uid>.wav and the mix to mixed.wav
+# (rtc_startAudioRecording), for call quality investigations
+audioRecordDir = None
 
 disableVideo = False
 disableAudio = False
@@ -39,6 +48,11 @@ customAudioSrc = ".\\data\\wudao-2-48.wav"
 
 dllpath = "agoradl/bin"
 
+# agora_native (agoradl/python) takes numpy frames and pcm bytes as they are
+# and releases the GIL while they are copied, built with -DAGORADL_BUILD_PYTHON=ON.
+# the capture threads fall back to ctypes when it is not installed
+native = None
+
 loopback = False
 current_dir = os.path.abspath(os.path.dirname(__file__))
 customVideoSrc = os.path.join(current_dir, customVideoSrc)
@@ -46,6 +60,7 @@ customAudioSrc = os.path.join(current_dir, customAudioSrc)
 
 if isRobot == True:
     enableCustomCapture = True
+    headless = True
 
 if enableCustomCapture == True:
     import cv2
@@ -78,8 +93,11 @@ def customVCapture(queue, agora):
         frame = cv2.cvtColor(frame, cv2.COLOR_BGR2YUV_I420)  
         #cv2.imshow("test", frame)
         #frame = frame.astype(np.uint8)
-        data_p = frame.ctypes.data_as(ctypes.c_char_p)
-        agora.pushVideoFrame(data_p, v_w, v_h)
+        if native is not None:
+            native.pushVideoFrame(frame, v_w, v_h)
+        else:
+            data_p = frame.ctypes.data_as(ctypes.c_char_p)
+            agora.pushVideoFrame(data_p, v_w, v_h)
         
         if cv2.waitKey(delay):
     	    pass
@@ -100,7 +118,9 @@ def customACapture(queue, agora):
         converted, state = audioop.ratecv(data, width, inchannels, insamplerate, robot_audio_samplrate, state)
         if robot_audio_chans == 1:
             converted = audioop.tomono(converted, 2, 1, 0)
-        if len(converted) > 0:
+        if len(converted) > 0 and native is not None:
+            native.pushAudioFrame(converted)
+        elif len(converted) > 0:
             agora.pushAudioFrame(ctypes.c_char_p(converted), ctypes.c_ulong(len(converted)))
         else:
             wf.rewind()
@@ -135,6 +155,35 @@ vQueue = None
 aCapTask = None
 aQueue = None
 
+# tickets of the config posted to the engine thread, polled by the ui loop
+tickets = []
+
+def pollConfig(agora):
+    '''
+    True once every posted config is done, prints the first failure.
+    called from window.after / fleet.run_headless, never blocks on the engine
+    '''
+    try:
+        return config_abi.poll_all(agora, tickets)
+    except config_abi.ConfigError as e:
+        print(e)
+        return True
+
+def startCustomCapture(agora, barrier):
+    global vCapTask, vQueue, aCapTask, aQueue
+    if barrier == True:
+        fleet.wait_ready(agora)
+    try:
+        vQueue = queue.Queue()
+        vCapTask = threading.Thread(target=customVCapture, args=(vQueue, agora))
+        vCapTask.start()  
+
+        aQueue = queue.Queue()
+        aCapTask = threading.Thread(target=customACapture, args=(aQueue, agora))
+        aCapTask.start()
+    except Exception as e:
+        print(e)
+
 
 if __name__ ==  '__main__':
     try:
@@ -146,33 +195,46 @@ if __name__ ==  '__main__':
             os.add_dll_directory(current_dir)
 
         agora = ctypes.cdll.LoadLibrary("agorawrapper.dll")
-
-        window = tkinter.Tk()
-        window.title("agora for test")
-        window.geometry('480x960')
+        sys.path.insert(0, current_dir)
+        try:
+            import agora_native as native
+        except ImportError:
+            pass
 
         NUMBER_OF_FRAMES = 8
-        relative_height = 1 / float(NUMBER_OF_FRAMES)
+        window = None
+        if headless == True:
+            #the views are only slots of the remote streams
+            for number in range(NUMBER_OF_FRAMES):
+                agora.addView(ctypes.c_ulonglong(number + 1))
+        else:
+            import tkinter
+            window = tkinter.Tk()
+            window.title("agora for test")
+            window.geometry('480x960')
 
-        for number in range(NUMBER_OF_FRAMES):
-            display_frame = tkinter.Frame(window, bg='')
-            relative_y = number * relative_height
-            display_frame.place(relx = 0, rely = relative_y,
-                    anchor = tkinter.NW, relwidth = 1, relheight = relative_height)
-            frame_id = display_frame.winfo_id()
-            agora.addView(ctypes.c_ulonglong(frame_id))
+            relative_height = 1 / float(NUMBER_OF_FRAMES)
 
-        agora.createEngine(ctypes.c_char_p(bytes(app_id, 'utf-8')))
+            for number in range(NUMBER_OF_FRAMES):
+                display_frame = tkinter.Frame(window, bg='')
+                relative_y = number * relative_height
+                display_frame.place(relx = 0, rely = relative_y,
+                        anchor = tkinter.NW, relwidth = 1, relheight = relative_height)
+                frame_id = display_frame.winfo_id()
+                agora.addView(ctypes.c_ulonglong(frame_id))
 
-        enableAudio = json.dumps({"enable": "true"})
-        if disableAudio == True:
-            enableAudio = json.dumps({"enable": "false"})
-        agora.enableAudio(ctypes.c_char_p(bytes(enableAudio, 'utf-8')))
-        
-        enableVideo = json.dumps({"enable": "true"})
-        if disableVideo == True:
-            enableVideo = json.dumps({"enable": "false"})
-        agora.enableVideo(ctypes.c_char_p(bytes(enableVideo, 'utf-8')))
+        agora.createEngine(ctypes.c_char_p(bytes(app_id, 'utf-8')))
+        if headless == True:
+            agora.rtc_enableHeadless(ctypes.c_int(1))
+        if audioSink == True:
+            agora.rtc_startAudioSink(ctypes.c_int(48000), ctypes.c_int(1), ctypes.c_int(1))
+        if audioRecordDir is not None:
+            agora.rtc_startAudioRecording(ctypes.c_char_p(bytes(audioRecordDir, 'utf-8')), ctypes.c_int(48000), ctypes.c_int(1))
+
+        #the config and the join are posted, they run on the engine thread in this order
+        tickets.append(config_abi.post(agora, config_abi.AGORA_ABI_VERSION, config_abi.agora_items([
+            config_abi.agora_enable_audio(not disableAudio),
+            config_abi.agora_enable_video(not disableVideo)])))
 
         if baselineVideo == True:
             #100:high， 66:baseline
@@ -184,7 +246,8 @@ if __name__ ==  '__main__':
         if isRobot == True:
             agora.logOff()
             agora.muteAllRemoteVideoStreams()
-            agora.muteAllRemoteAudioStreams()
+            if audioSink == False:
+                agora.muteAllRemoteAudioStreams()
             #agora.stopPreview()
         if enableCustomCapture == True:
             agora.enableVideoCustomCap()
@@ -198,14 +261,11 @@ if __name__ ==  '__main__':
         #agora.setRecordingDevice(ctypes.c_char_p(bytes("{0.0.1.00000000}.{5c5eacc2-a2df-47db-9e25-5e6da81b5ae8}", 'utf-8')))
         #agora.setVideoDevice(ctypes.c_char_p(bytes("YY开播", 'utf-8')))
 
-        channelProfile = json.dumps({"channelprofile": "1"})
-        agora.setChannelProfile(ctypes.c_char_p(bytes(channelProfile,'utf-8')))
-
-        clientRole = json.dumps({"clientrole": "1"})
-        agora.setClientRole(ctypes.c_char_p(bytes(clientRole,'utf-8')))
-
-        vprofile = json.dumps(profile)
-        agora.setVideoProfile(ctypes.c_char_p(bytes(vprofile, 'utf-8')))
+        width, height = [int(v) for v in profile["resolution"].split("*")]
+        tickets.append(config_abi.post(agora, config_abi.AGORA_ABI_VERSION, config_abi.agora_items([
+            config_abi.agora_channel_profile(1),
+            config_abi.agora_client_role(1),
+            config_abi.agora_video_profile(width, height, int(profile["fps"]), int(profile["bitrate"]))])))
         
         if disable3A == True:
             parameter = '{"che.audio.bypass.apm" : true}'
@@ -222,21 +282,31 @@ if __name__ ==  '__main__':
             parameter = json.dumps({"che.audio.specify.codec": audioSpecifyCodec})
             agora.setParameters(ctypes.c_char_p(bytes(parameter, 'utf-8')))
 
-        channel = json.dumps({"channelId":channel_name,"uid":str(uid)})
-        agora.joinChannel(ctypes.c_char_p(bytes(channel, 'utf-8')))
+        if fleet.churn():
+            for ticket in tickets:
+                config_abi.wait(agora, ticket)
+            fleet.run_churn(agora, channel_name, uid)
+            sys.exit(0)
+
+        tickets.append(config_abi.post(agora, config_abi.AGORA_ABI_VERSION,
+                                       config_abi.agora_items([config_abi.agora_join(channel_name, uid)])))
 
         if enableCustomCapture == True:
-            try:
-                vQueue = queue.Queue()
-                vCapTask = threading.Thread(target=customVCapture, args=(vQueue, agora))
-                vCapTask.start()  
-
-                aQueue = queue.Queue()
-                aCapTask = threading.Thread(target=customACapture, args=(aQueue, agora))
-                aCapTask.start()
-            except Exception as e:
-                print(e)
-        window.mainloop()
+            if fleet.launched():
+                #hold the media until the whole fleet has joined
+                threading.Thread(target=startCustomCapture, args=(agora, True), daemon=True).start()
+            else:
+                startCustomCapture(agora, False)
+        elif fleet.launched():
+            threading.Thread(target=fleet.wait_ready, args=(agora,), daemon=True).start()
+        if window is not None:
+            def afterConfig():
+                if not pollConfig(agora):
+                    window.after(100, afterConfig)
+            window.after(100, afterConfig)
+            window.mainloop()
+        else:
+            fleet.run_headless(poll=lambda: pollConfig(agora))
 
     except Exception as e:
         print(e)
@@ -247,5 +317,9 @@ if __name__ ==  '__main__':
         if aCapTask is not None:
             aQueue.put("done")
             aCapTask.join()
-        agora.leaveChannel()
+        if audioRecordDir is not None:
+            # puts the real sizes into the wav headers
+            agora.rtc_stopAudioRecording()
+        #destroyEngine runs the posted leave before the engine goes away
+        agora.postLeaveChannel()
         agora.destroyEngine()
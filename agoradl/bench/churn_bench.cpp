@@ -0,0 +1,36 @@
+// churn_bench : join/leave churn of one robot against agorawrapper, build
+// with AGORADL_MOCK_SDK to run it without network or devices
+//
+//   churn_bench [cycles] [holdms] [output]
+//
+// mock knobs come from RTC_MOCK_CONFIG, e.g. {"peers":16,"peerChurnMs":200}
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+extern "C" void createEngine(void* lpExtInfo);
+extern "C" void destroyEngine();
+extern "C" int runChurnBenchmark(void* lpExtInfo);
+extern "C" void addView(void* lpExtInfo);
+
+int main(int argc, char* argv[])
+{
+	std::string cycles = argc > 1 ? argv[1] : "100";
+	std::string holdms = argc > 2 ? argv[2] : "100";
+
+	std::string params = "{\"channelId\":\"churn\",\"uid\":\"0\",\"cycles\":\"" + cycles + "\",\"holdms\":\"" + holdms + "\"";
+	if (argc > 3)
+		params += ",\"output\":\"" + std::string(argv[3]) + "\"";
+	params += "}";
+
+	// placeholder views, the robot scripts add 8 tkinter frames the same way
+	for (int i = 0; i < 8; i++)
+		addView((void*)(uintptr_t)(i + 1));
+
+	createEngine((void*)"churn_bench");
+	int nFailed = runChurnBenchmark((void*)params.c_str());
+	destroyEngine();
+
+	return nFailed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
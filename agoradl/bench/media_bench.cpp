@@ -0,0 +1,281 @@
+// media_bench : google benchmark of the buffers the media callbacks go through
+//
+//   CircleBuffer    pushAudioFrame -> onRecordAudioFrame, 10ms pcm at 16/32/48k
+//   Semaphore       the two counters inside CircleBuffer
+//   CAgVideoBuffer  pushVideoFrame -> onCaptureVideoFrame, i420 at 480p/720p/1080p
+//   CExtendVideoFrameObserver::onCaptureVideoFrame
+//   CImageScaler    one remote frame into a 320x240 tile of the compositor
+//
+// the */threads:2 runs put a producer and a consumer on the same object.
+// every op is timed on its own so the counters carry the p50/p99 latency next
+// to the mean ns per op; the steady_clock read adds ~20ns to those values.
+//
+//   media_bench --benchmark_out=media.json --benchmark_out_format=json
+//   python bench_compare.py agoradl/bench/baseline/media_bench.json media.json
+#include <benchmark/benchmark.h>
+#include "CircleBuffer.h"
+#include "AgVideoBuffer.h"
+#include "ExtendVideoFrameObserver.h"
+#include "HdrHistogram.h"
+#include "ImageScaler.h"
+#include <chrono>
+#include <vector>
+
+// 10s in ns, a blocked op longer than that is clamped
+#define BENCH_HIGHEST_TRACKABLE	(10LL * 1000 * 1000 * 1000)
+
+static const int g_nVideoSizes[][2] = { { 640, 480 }, { 1280, 720 }, { 1920, 1080 } };
+
+// times one op per iteration into a histogram and reports its percentiles
+class CBenchLatency
+{
+public:
+	CBenchLatency() : m_histogram(BENCH_HIGHEST_TRACKABLE, 3) {}
+
+	void Start() { m_start = std::chrono::steady_clock::now(); }
+	void Stop() { m_histogram.record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count()); }
+
+	void Report(benchmark::State& state)
+	{
+		state.counters["p50_ns"] = benchmark::Counter((double)m_histogram.getValueAtPercentile(50.0), benchmark::Counter::kAvgThreads);
+		state.counters["p99_ns"] = benchmark::Counter((double)m_histogram.getValueAtPercentile(99.0), benchmark::Counter::kAvgThreads);
+	}
+
+private:
+	CHdrHistogram m_histogram;
+	std::chrono::steady_clock::time_point m_start;
+};
+
+static unsigned int PcmBytes(int nSampleRate)
+{
+	// 10ms of 16 bit stereo
+	return nSampleRate / 100 * 2 * 2;
+}
+
+static void BM_CircleBuffer_WriteRead(benchmark::State& state)
+{
+	CircleBuffer circleBuffer(MAX_AUDIO_SAMPLE_SIZE, CIC_WAITTIMEOUT);
+	unsigned int nBytes = PcmBytes((int)state.range(0));
+	std::vector<BYTE> pcm(nBytes, 1), out(nBytes);
+	unsigned int nRead = 0;
+	int audioTime = 0;
+	CBenchLatency latency;
+
+	for (auto _ : state)
+	{
+		latency.Start();
+		circleBuffer.writeBuffer(pcm.data(), nBytes);
+		circleBuffer.readBuffer(out.data(), nBytes, &nRead, audioTime);
+		latency.Stop();
+	}
+
+	state.SetBytesProcessed(state.iterations() * nBytes);
+	state.SetItemsProcessed(state.iterations());
+	latency.Report(state);
+}
+BENCHMARK(BM_CircleBuffer_WriteRead)->Arg(16000)->Arg(32000)->Arg(48000);
+
+// thread 0 pushes, thread 1 pulls; both run the same number of iterations so
+// neither is left blocked on a semaphore when the run ends
+static void BM_CircleBuffer_ProducerConsumer(benchmark::State& state)
+{
+	static CircleBuffer* lpCircleBuffer = nullptr;
+	if (state.thread_index() == 0)
+		lpCircleBuffer = new CircleBuffer(MAX_AUDIO_SAMPLE_SIZE, CIC_WAITTIMEOUT);
+
+	unsigned int nBytes = PcmBytes((int)state.range(0));
+	std::vector<BYTE> pcm(nBytes, 1);
+	unsigned int nRead = 0;
+	int audioTime = 0;
+	CBenchLatency latency;
+	bool bProducer = state.thread_index() == 0;
+
+	for (auto _ : state)
+	{
+		latency.Start();
+		if (bProducer)
+			lpCircleBuffer->writeBuffer(pcm.data(), nBytes);
+		else
+			lpCircleBuffer->readBuffer(pcm.data(), nBytes, &nRead, audioTime);
+		latency.Stop();
+	}
+
+	state.SetBytesProcessed(state.iterations() * nBytes);
+	state.SetItemsProcessed(state.iterations());
+	latency.Report(state);
+
+	if (state.thread_index() == 0)
+	{
+		delete lpCircleBuffer;
+		lpCircleBuffer = nullptr;
+	}
+}
+BENCHMARK(BM_CircleBuffer_ProducerConsumer)->Arg(16000)->Arg(32000)->Arg(48000)->Threads(2)->UseRealTime();
+
+static void BM_Semaphore_AcquireRelease(benchmark::State& state)
+{
+	static Semaphore semaphore(1, 1);
+	CBenchLatency latency;
+
+	for (auto _ : state)
+	{
+		latency.Start();
+		semaphore.acquire();
+		semaphore.release();
+		latency.Stop();
+	}
+
+	state.SetItemsProcessed(state.iterations());
+	latency.Report(state);
+}
+BENCHMARK(BM_Semaphore_AcquireRelease)->ThreadRange(1, 4)->UseRealTime();
+
+// one release wakes the other thread, the op is a full round trip
+static void BM_Semaphore_PingPong(benchmark::State& state)
+{
+	static Semaphore ping(0, 1);
+	static Semaphore pong(0, 1);
+	CBenchLatency latency;
+
+	for (auto _ : state)
+	{
+		latency.Start();
+		if (state.thread_index() == 0)
+		{
+			ping.release();
+			pong.acquire();
+		}
+		else
+		{
+			ping.acquire();
+			pong.release();
+		}
+		latency.Stop();
+	}
+
+	state.SetItemsProcessed(state.iterations());
+	latency.Report(state);
+}
+BENCHMARK(BM_Semaphore_PingPong)->Threads(2)->UseRealTime();
+
+static void VideoSizeArgs(benchmark::internal::Benchmark* b)
+{
+	for (auto& size : g_nVideoSizes)
+		b->Args({ size[0], size[1] });
+}
+
+static void BM_AgVideoBuffer_WriteRead(benchmark::State& state)
+{
+	int nWidth = (int)state.range(0), nHeight = (int)state.range(1);
+	int nBytes = nWidth * nHeight * 3 / 2;
+	std::vector<BYTE> frame(nBytes, 1), out(nBytes);
+	int ts = 0, w = 0, h = 0;
+	CBenchLatency latency;
+
+	for (auto _ : state)
+	{
+		latency.Start();
+		CAgVideoBuffer::GetInstance()->writeBuffer(frame.data(), nWidth, nHeight);
+		CAgVideoBuffer::GetInstance()->readBuffer(out.data(), ts, w, h);
+		latency.Stop();
+	}
+
+	state.SetBytesProcessed(state.iterations() * nBytes);
+	state.SetItemsProcessed(state.iterations());
+	latency.Report(state);
+}
+BENCHMARK(BM_AgVideoBuffer_WriteRead)->Apply(VideoSizeArgs);
+
+// pushVideoFrame from python against onCaptureVideoFrame on the SDK thread
+static void BM_AgVideoBuffer_WriterReader(benchmark::State& state)
+{
+	int nWidth = (int)state.range(0), nHeight = (int)state.range(1);
+	int nBytes = nWidth * nHeight * 3 / 2;
+	std::vector<BYTE> frame(nBytes, 1);
+	int ts = 0, w = 0, h = 0;
+	CBenchLatency latency;
+	bool bWriter = state.thread_index() == 0;
+
+	if (bWriter)
+		CAgVideoBuffer::GetInstance()->writeBuffer(frame.data(), nWidth, nHeight);
+
+	for (auto _ : state)
+	{
+		latency.Start();
+		if (bWriter)
+			CAgVideoBuffer::GetInstance()->writeBuffer(frame.data(), nWidth, nHeight);
+		else
+			CAgVideoBuffer::GetInstance()->readBuffer(frame.data(), ts, w, h);
+		latency.Stop();
+	}
+
+	state.SetBytesProcessed(state.iterations() * nBytes);
+	state.SetItemsProcessed(state.iterations());
+	latency.Report(state);
+}
+BENCHMARK(BM_AgVideoBuffer_WriterReader)->Apply(VideoSizeArgs)->Threads(2)->UseRealTime();
+
+static void BM_ExtendVideoFrameObserver_OnCapture(benchmark::State& state)
+{
+	int nWidth = (int)state.range(0), nHeight = (int)state.range(1);
+	int nBytes = nWidth * nHeight * 3 / 2;
+	std::vector<BYTE> frame(nBytes, 1), sdkFrame(nBytes);
+	CExtendVideoFrameObserver observer;
+	CBenchLatency latency;
+
+	CAgVideoBuffer::GetInstance()->writeBuffer(frame.data(), nWidth, nHeight);
+
+	agora::media::IVideoFrameObserver::VideoFrame videoFrame;
+	memset(&videoFrame, 0, sizeof(videoFrame));
+	for (auto _ : state)
+	{
+		// the SDK hands over its own capture size every time
+		videoFrame.width = nWidth;
+		videoFrame.height = nHeight;
+		videoFrame.yBuffer = sdkFrame.data();
+		videoFrame.uBuffer = sdkFrame.data() + nWidth * nHeight;
+		videoFrame.vBuffer = sdkFrame.data() + nWidth * nHeight * 5 / 4;
+
+		latency.Start();
+		observer.onCaptureVideoFrame(videoFrame);
+		latency.Stop();
+	}
+
+	state.SetBytesProcessed(state.iterations() * nBytes);
+	state.SetItemsProcessed(state.iterations());
+	latency.Report(state);
+}
+BENCHMARK(BM_ExtendVideoFrameObserver_OnCapture)->Apply(VideoSizeArgs);
+
+// the three planes of an I420 frame the way CVideoCompositor::PutFrame scales them
+static void BM_ImageScaler_ScaleI420(benchmark::State& state)
+{
+	int nWidth = (int)state.range(0), nHeight = (int)state.range(1);
+	int nTileWidth = 320, nTileHeight = 240;
+	int nBytes = nWidth * nHeight * 3 / 2;
+	std::vector<BYTE> frame(nBytes), tile(nTileWidth * nTileHeight * 3 / 2);
+	for (int i = 0; i < nBytes; i++)
+		frame[i] = (BYTE)(i * 7);
+	const BYTE* lpU = frame.data() + nWidth * nHeight;
+	const BYTE* lpV = lpU + nWidth * nHeight / 4;
+	BYTE* lpTileU = tile.data() + nTileWidth * nTileHeight;
+	BYTE* lpTileV = lpTileU + nTileWidth * nTileHeight / 4;
+	CBenchLatency latency;
+
+	for (auto _ : state)
+	{
+		latency.Start();
+		CImageScaler::ScalePlane(frame.data(), nWidth, nWidth, nHeight, tile.data(), nTileWidth, nTileWidth, nTileHeight);
+		CImageScaler::ScalePlane(lpU, nWidth / 2, nWidth / 2, nHeight / 2, lpTileU, nTileWidth / 2, nTileWidth / 2, nTileHeight / 2);
+		CImageScaler::ScalePlane(lpV, nWidth / 2, nWidth / 2, nHeight / 2, lpTileV, nTileWidth / 2, nTileWidth / 2, nTileHeight / 2);
+		latency.Stop();
+		benchmark::DoNotOptimize(tile.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * nBytes);
+	state.SetItemsProcessed(state.iterations());
+	latency.Report(state);
+}
+BENCHMARK(BM_ImageScaler_ScaleI420)->Apply(VideoSizeArgs);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,568 @@
+// pipeline_sim : replays the custom capture pipeline on a virtual clock
+//
+//   python push loop -> pushAudioFrame -> CircleBuffer -> onRecordAudioFrame (10ms pulls)
+//   python push loop -> pushVideoFrame -> CAgVideoBuffer -> onCaptureVideoFrame (fps pulls)
+//
+// the real buffers and observers run in a single thread; every push and pull is
+// an event on the virtual clock, so an hour of traffic takes seconds and the
+// same seed gives the same numbers. the buffers are switched to CIC_NOWAIT and
+// the blocking of the real threads is replayed by the event loop instead.
+//
+//   pipeline_sim [key=value ...]
+//
+//   seconds=3600        simulated time
+//   seed=1              every random delay comes from this seed
+//   audio=1 video=1     0 leaves the stream out
+//   rate=32000 channels=1 chunk=1024
+//                       robot_audio_samplrate/robot_audio_chans of agora.py, chunk is
+//                       the 48k frames read from the wav per push
+//   pushmode=backpressure
+//                       backpressure: agora.py, push again as soon as the write returns
+//                       paced: push one chunk per chunk duration, drop it when full
+//   pushcostus=200 pushjitterus=1000
+//                       python work per audio push plus uniform 0..jitter
+//   pullwait=block      block: the SDK thread waits in readBuffer (wrapper default)
+//                       none: an underrun goes out as silence
+//   pulljitterus=0      uniform 0..jitter added to every SDK callback deadline
+//   width=640 height=480 srcfps=25 fps=15
+//                       v_w/v_h of agora.py, source file fps and encoder fps,
+//                       the I420 frame has to fit VIDEO_BUF_SIZE
+//   videocostus=8000 videojitterus=4000
+//                       cv2 read/resize/convert per frame, the loop then waits 1000/srcfps ms
+//   output=file         also write the report to file
+//
+// latency is push to consume in us: the push time of the oldest byte of every
+// audio frame and of every newly seen video frame. jitter is the change of that
+// latency between two consecutive frames. drops are pushes nobody consumed,
+// repeats are video pulls that got the previous frame again.
+#include "CircleBuffer.h"
+#include "AgVideoBuffer.h"
+#include "ExtendAudioFrameObserver.h"
+#include "ExtendVideoFrameObserver.h"
+#include "HdrHistogram.h"
+#include "MediaClock.h"
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+// one hour in us, anything slower is clamped
+#define SIM_HIGHEST_TRACKABLE	(3600LL * 1000 * 1000)
+// push times kept for video frames still in flight
+#define SIM_VIDEO_RING			1024
+
+struct SIM_CONFIG
+{
+	int64_t seconds = 3600;
+	int seed = 1;
+	bool audio = true;
+	bool video = true;
+
+	int rate = 32000;
+	int channels = 1;
+	int chunk = 1024;
+	bool pushPaced = false;
+	int pushCostUs = 200;
+	int pushJitterUs = 1000;
+	bool pullBlock = true;
+	int pullJitterUs = 0;
+
+	int width = 640;
+	int height = 480;
+	int srcFps = 25;
+	int fps = 15;
+	int videoCostUs = 8000;
+	int videoJitterUs = 4000;
+
+	std::string output;
+
+	bool Parse(int argc, char* argv[]);
+};
+
+bool SIM_CONFIG::Parse(int argc, char* argv[])
+{
+	std::map<std::string, int*> ints = {
+		{ "seed", &seed }, { "rate", &rate }, { "channels", &channels }, { "chunk", &chunk },
+		{ "pushcostus", &pushCostUs }, { "pushjitterus", &pushJitterUs }, { "pulljitterus", &pullJitterUs },
+		{ "width", &width }, { "height", &height }, { "srcfps", &srcFps }, { "fps", &fps },
+		{ "videocostus", &videoCostUs }, { "videojitterus", &videoJitterUs },
+	};
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg(argv[i]);
+		size_t pos = arg.find('=');
+		if (pos == std::string::npos)
+			return false;
+		std::string key = arg.substr(0, pos), value = arg.substr(pos + 1);
+
+		if (ints.count(key))
+			*ints[key] = atoi(value.c_str());
+		else if (key == "seconds")
+			seconds = atoll(value.c_str());
+		else if (key == "audio")
+			audio = value != "0";
+		else if (key == "video")
+			video = value != "0";
+		else if (key == "pushmode" && (value == "paced" || value == "backpressure"))
+			pushPaced = value == "paced";
+		else if (key == "pullwait" && (value == "block" || value == "none"))
+			pullBlock = value == "block";
+		else if (key == "output")
+			output = value;
+		else
+			return false;
+	}
+	// a frame has to fit the single frame of CAgVideoBuffer
+	return rate >= 100 && channels > 0 && chunk > 0 && width > 1 && height > 1 && srcFps > 0 && fps > 0
+		&& (int64_t)width * height * 3 / 2 <= VIDEO_BUF_SIZE;
+}
+
+class CVirtualClock : public IMediaClock
+{
+public:
+	CVirtualClock() : m_nNowUs(0) {}
+	virtual int64_t NowUs() override { return m_nNowUs; }
+	void Set(int64_t nNowUs) { m_nNowUs = nNowUs; }
+
+private:
+	int64_t m_nNowUs;
+};
+
+enum SIM_EVENT_TYPE
+{
+	SIM_AUDIO_PUSH = 0,
+	SIM_AUDIO_PULL,
+	SIM_VIDEO_PUSH,
+	SIM_VIDEO_PULL,
+};
+
+struct SIM_EVENT
+{
+	int64_t nTimeUs;
+	int64_t nOrder;		// keeps events of the same us in posting order
+	SIM_EVENT_TYPE type;
+
+	bool operator>(const SIM_EVENT& other) const
+	{
+		return nTimeUs != other.nTimeUs ? nTimeUs > other.nTimeUs : nOrder > other.nOrder;
+	}
+};
+
+// latency and jitter of one stream
+class CSimLatency
+{
+public:
+	CSimLatency() : m_latency(SIM_HIGHEST_TRACKABLE, 3), m_jitter(SIM_HIGHEST_TRACKABLE, 3), m_nLastUs(-1) {}
+
+	void Record(int64_t nLatencyUs)
+	{
+		m_latency.record(nLatencyUs);
+		if (m_nLastUs >= 0)
+			m_jitter.record(nLatencyUs > m_nLastUs ? nLatencyUs - m_nLastUs : m_nLastUs - nLatencyUs);
+		m_nLastUs = nLatencyUs;
+	}
+
+	void Print(std::ostream& os, const char* lpName)
+	{
+		m_latency.printPercentiles(os, (std::string(lpName) + ".latency").c_str(), "us");
+		m_jitter.printPercentiles(os, (std::string(lpName) + ".jitter").c_str(), "us");
+	}
+
+private:
+	CHdrHistogram m_latency;
+	CHdrHistogram m_jitter;
+	int64_t m_nLastUs;
+};
+
+class CPipelineSim
+{
+public:
+	CPipelineSim(const SIM_CONFIG& config);
+	~CPipelineSim();
+
+	void Run();
+	void Report(std::ostream& os, double wallSeconds);
+
+private:
+	void Post(int64_t nTimeUs, SIM_EVENT_TYPE type);
+	int64_t Jitter(int nMaxUs);
+
+	void StartAudio();
+	void AudioPush();
+	void AudioPull();
+	void StartVideo();
+	void VideoPush();
+	void VideoPull();
+
+	static BYTE Pattern(int64_t nOffset) { return (BYTE)(nOffset ^ (nOffset >> 8) ^ (nOffset >> 16) ^ 0x5a); }
+
+	SIM_CONFIG		m_config;
+	CVirtualClock	m_clock;
+	std::mt19937	m_random;
+	std::priority_queue<SIM_EVENT, std::vector<SIM_EVENT>, std::greater<SIM_EVENT>> m_events;
+	int64_t			m_nOrder;
+	int64_t			m_nEndUs;
+
+	// audio, offsets count the bytes that went through the CircleBuffer
+	CExtendAudioFrameObserver	m_audioObserver;
+	agora::media::IAudioFrameObserver::AudioFrame m_audioFrame;
+	std::vector<BYTE>	m_audioChunk;
+	std::vector<BYTE>	m_audioOut;
+	unsigned int		m_nChunkBytes;
+	unsigned int		m_nFrameBytes;
+	int64_t				m_nChunkUs;
+	int64_t				m_nWritten;
+	int64_t				m_nRead;
+	std::deque<std::pair<int64_t, int64_t>> m_pushLog;	// end offset, push time of every chunk in the buffer
+	int64_t				m_nPushIndex;
+	int64_t				m_nPullIndex;
+	bool				m_bProducerBlocked;
+	int64_t				m_nProducerBlockedUs;
+	bool				m_bConsumerBlocked;
+	int64_t				m_nConsumerBlockedUs;
+
+	int64_t				m_nAudioPushes;
+	int64_t				m_nAudioDropped;
+	int64_t				m_nAudioPulls;
+	int64_t				m_nAudioUnderruns;
+	int64_t				m_nAudioLate;
+	int64_t				m_nAudioCorrupt;
+	CSimLatency			m_audioLatency;
+	CHdrHistogram		m_pushBlocked;
+	CHdrHistogram		m_pullStall;
+
+	// video, the frame sequence number rides in the first 8 bytes of the Y plane
+	CExtendVideoFrameObserver	m_videoObserver;
+	std::vector<BYTE>	m_videoFrame;
+	std::vector<BYTE>	m_sdkFrame;
+	int64_t				m_nPushTimes[SIM_VIDEO_RING];
+	int64_t				m_nVideoSeq;
+	int64_t				m_nLastSeq;
+	int64_t				m_nVideoPullIndex;
+
+	int64_t				m_nVideoPushes;
+	int64_t				m_nVideoPulls;
+	int64_t				m_nVideoUnderruns;
+	int64_t				m_nVideoDrops;
+	int64_t				m_nVideoRepeats;
+	CSimLatency			m_videoLatency;
+};
+
+CPipelineSim::CPipelineSim(const SIM_CONFIG& config)
+	: m_config(config)
+	, m_random(config.seed)
+	, m_nOrder(0)
+	, m_nEndUs(config.seconds * 1000000)
+	, m_nWritten(0)
+	, m_nRead(0)
+	, m_nPushIndex(0)
+	, m_nPullIndex(0)
+	, m_bProducerBlocked(false)
+	, m_nProducerBlockedUs(0)
+	, m_bConsumerBlocked(false)
+	, m_nConsumerBlockedUs(0)
+	, m_nAudioPushes(0)
+	, m_nAudioDropped(0)
+	, m_nAudioPulls(0)
+	, m_nAudioUnderruns(0)
+	, m_nAudioLate(0)
+	, m_nAudioCorrupt(0)
+	, m_pushBlocked(SIM_HIGHEST_TRACKABLE, 3)
+	, m_pullStall(SIM_HIGHEST_TRACKABLE, 3)
+	, m_nVideoSeq(0)
+	, m_nLastSeq(0)
+	, m_nVideoPullIndex(0)
+	, m_nVideoPushes(0)
+	, m_nVideoPulls(0)
+	, m_nVideoUnderruns(0)
+	, m_nVideoDrops(0)
+	, m_nVideoRepeats(0)
+{
+	CMediaClock::SetClock(&m_clock);
+	memset(&m_audioFrame, 0, sizeof(m_audioFrame));
+	memset(m_nPushTimes, 0, sizeof(m_nPushTimes));
+}
+
+CPipelineSim::~CPipelineSim()
+{
+	CMediaClock::SetClock(nullptr);
+}
+
+void CPipelineSim::Post(int64_t nTimeUs, SIM_EVENT_TYPE type)
+{
+	if (nTimeUs < m_nEndUs)
+		m_events.push({ nTimeUs, m_nOrder++, type });
+}
+
+int64_t CPipelineSim::Jitter(int nMaxUs)
+{
+	return nMaxUs > 0 ? std::uniform_int_distribution<int>(0, nMaxUs)(m_random) : 0;
+}
+
+void CPipelineSim::Run()
+{
+	if (m_config.audio)
+		StartAudio();
+	if (m_config.video)
+		StartVideo();
+
+	while (!m_events.empty())
+	{
+		SIM_EVENT event = m_events.top();
+		m_events.pop();
+		m_clock.Set(event.nTimeUs);
+
+		switch (event.type)
+		{
+		case SIM_AUDIO_PUSH: AudioPush(); break;
+		case SIM_AUDIO_PULL: AudioPull(); break;
+		case SIM_VIDEO_PUSH: VideoPush(); break;
+		case SIM_VIDEO_PULL: VideoPull(); break;
+		}
+	}
+}
+
+void CPipelineSim::StartAudio()
+{
+	CircleBuffer* lpBuffer = CircleBuffer::GetInstance();
+	lpBuffer->setAudioInfo(m_config.rate, m_config.channels);
+	lpBuffer->setWaitTimeout(CIC_NOWAIT);
+
+	// audioop.ratecv turns every 1024 frames of the 48k wav into this many
+	m_nChunkBytes = (unsigned int)(((int64_t)m_config.chunk * m_config.rate + 24000) / 48000) * m_config.channels * 2;
+	m_nChunkUs = (int64_t)m_config.chunk * 1000000 / 48000;
+	m_nFrameBytes = m_config.rate / 100 * m_config.channels * 2;
+	m_audioChunk.resize(m_nChunkBytes);
+	m_audioOut.resize(m_nFrameBytes);
+
+	m_audioFrame.type = agora::media::IAudioFrameObserver::FRAME_TYPE_PCM16;
+	m_audioFrame.samples = m_config.rate / 100;
+	m_audioFrame.bytesPerSample = 2;
+	m_audioFrame.buffer = m_audioOut.data();
+
+	Post(0, SIM_AUDIO_PUSH);
+	Post(Jitter(m_config.pullJitterUs), SIM_AUDIO_PULL);
+}
+
+void CPipelineSim::AudioPush()
+{
+	int64_t now = m_clock.NowUs();
+	CircleBuffer* lpBuffer = CircleBuffer::GetInstance();
+
+	for (unsigned int i = 0; i < m_nChunkBytes; i++)
+		m_audioChunk[i] = Pattern(m_nWritten + i);
+
+	if (lpBuffer->writeBuffer(m_audioChunk.data(), m_nChunkBytes))
+	{
+		m_pushLog.push_back(std::make_pair(m_nWritten + m_nChunkBytes, now));
+		m_nWritten += m_nChunkBytes;
+		m_nAudioPushes++;
+
+		// the SDK thread was waiting in readBuffer
+		if (m_bConsumerBlocked && lpBuffer->getUsedSize() >= m_nFrameBytes)
+			Post(now, SIM_AUDIO_PULL);
+	}
+	else if (m_config.pushPaced)
+	{
+		m_nAudioDropped++;
+	}
+	else
+	{
+		// the python thread sits in writeBuffer until the SDK pulls
+		m_bProducerBlocked = true;
+		m_nProducerBlockedUs = now;
+		return;
+	}
+
+	m_nPushIndex++;
+	if (m_config.pushPaced)
+		Post(m_nPushIndex * m_nChunkUs + Jitter(m_config.pushJitterUs), SIM_AUDIO_PUSH);
+	else
+		Post(now + m_config.pushCostUs + Jitter(m_config.pushJitterUs), SIM_AUDIO_PUSH);
+}
+
+void CPipelineSim::AudioPull()
+{
+	int64_t now = m_clock.NowUs();
+	CircleBuffer* lpBuffer = CircleBuffer::GetInstance();
+	bool bEnough = lpBuffer->getUsedSize() >= m_nFrameBytes;
+
+	if (!bEnough && m_config.pullBlock)
+	{
+		// waits in readBuffer, AudioPush posts the pull again
+		if (!m_bConsumerBlocked)
+		{
+			m_bConsumerBlocked = true;
+			m_nConsumerBlockedUs = now;
+			m_nAudioUnderruns++;
+		}
+		return;
+	}
+
+	m_audioObserver.onRecordAudioFrame(m_audioFrame);
+	m_nAudioPulls++;
+
+	if (bEnough)
+	{
+		for (unsigned int i = 0; i < m_nFrameBytes; i++)
+		{
+			if (m_audioOut[i] != Pattern(m_nRead + i))
+			{
+				m_nAudioCorrupt++;
+				break;
+			}
+		}
+
+		while (!m_pushLog.empty() && m_pushLog.front().first <= m_nRead)
+			m_pushLog.pop_front();
+		if (!m_pushLog.empty())
+			m_audioLatency.Record(now - m_pushLog.front().second);
+		m_nRead += m_nFrameBytes;
+	}
+	else
+	{
+		m_nAudioUnderruns++;
+	}
+
+	if (m_bConsumerBlocked)
+	{
+		m_pullStall.record(now - m_nConsumerBlockedUs);
+		m_bConsumerBlocked = false;
+	}
+
+	if (m_bProducerBlocked && lpBuffer->getFreeSize() >= m_nChunkBytes)
+	{
+		m_pushBlocked.record(now - m_nProducerBlockedUs);
+		m_bProducerBlocked = false;
+		Post(now + m_config.pushCostUs + Jitter(m_config.pushJitterUs), SIM_AUDIO_PUSH);
+	}
+
+	// the 10ms audio clock does not wait for a late callback, missed ticks are gone
+	int64_t next = 0;
+	do
+	{
+		m_nPullIndex++;
+		next = m_nPullIndex * 10000 + Jitter(m_config.pullJitterUs);
+		if (next < now)
+			m_nAudioLate++;
+	} while (next < now);
+	Post(next, SIM_AUDIO_PULL);
+}
+
+void CPipelineSim::StartVideo()
+{
+	int nBytes = m_config.width * m_config.height * 3 / 2;
+	m_videoFrame.assign(nBytes, 0x80);
+	m_sdkFrame.assign(nBytes, 0);
+
+	Post(0, SIM_VIDEO_PUSH);
+	Post(Jitter(m_config.pullJitterUs), SIM_VIDEO_PULL);
+}
+
+void CPipelineSim::VideoPush()
+{
+	int64_t now = m_clock.NowUs();
+
+	m_nVideoSeq++;
+	memcpy(m_videoFrame.data(), &m_nVideoSeq, sizeof(m_nVideoSeq));
+	m_nPushTimes[m_nVideoSeq % SIM_VIDEO_RING] = now;
+	CAgVideoBuffer::GetInstance()->writeBuffer(m_videoFrame.data(), m_config.width, m_config.height, m_config.width);
+	m_nVideoPushes++;
+
+	// customVCapture: read, resize, convert, push, then cv2.waitKey(1000/fps)
+	Post(now + m_config.videoCostUs + Jitter(m_config.videoJitterUs) + (1000 / m_config.srcFps) * 1000, SIM_VIDEO_PUSH);
+}
+
+void CPipelineSim::VideoPull()
+{
+	int64_t now = m_clock.NowUs();
+	int nWidth = m_config.width, nHeight = m_config.height;
+
+	agora::media::IVideoFrameObserver::VideoFrame videoFrame;
+	memset(&videoFrame, 0, sizeof(videoFrame));
+	videoFrame.width = nWidth;
+	videoFrame.height = nHeight;
+	videoFrame.yBuffer = m_sdkFrame.data();
+	videoFrame.uBuffer = m_sdkFrame.data() + nWidth * nHeight;
+	videoFrame.vBuffer = m_sdkFrame.data() + nWidth * nHeight * 5 / 4;
+	m_videoObserver.onCaptureVideoFrame(videoFrame);
+	m_nVideoPulls++;
+
+	int64_t nSeq = 0;
+	memcpy(&nSeq, m_sdkFrame.data(), sizeof(nSeq));
+	if (nSeq == 0)
+	{
+		m_nVideoUnderruns++;
+	}
+	else if (nSeq == m_nLastSeq)
+	{
+		m_nVideoRepeats++;
+	}
+	else
+	{
+		m_nVideoDrops += nSeq - m_nLastSeq - 1;
+		m_videoLatency.Record(now - m_nPushTimes[nSeq % SIM_VIDEO_RING]);
+		m_nLastSeq = nSeq;
+	}
+
+	m_nVideoPullIndex++;
+	Post(m_nVideoPullIndex * 1000000 / m_config.fps + Jitter(m_config.pullJitterUs), SIM_VIDEO_PULL);
+}
+
+void CPipelineSim::Report(std::ostream& os, double wallSeconds)
+{
+	os << "pipeline_sim: " << m_config.seconds << " s simulated in " << wallSeconds << " s, seed " << m_config.seed << std::endl;
+
+	if (m_config.audio)
+	{
+		os << "audio " << m_config.rate << " Hz " << m_config.channels << " ch, "
+			<< (m_config.pushPaced ? "paced" : "backpressure") << " push of " << m_nChunkBytes << " B, "
+			<< m_nFrameBytes << " B pulls, " << (m_config.pullBlock ? "blocking" : "non blocking") << " read" << std::endl;
+		os << "  pushes:" << m_nAudioPushes << " dropped:" << m_nAudioDropped
+			<< " pulls:" << m_nAudioPulls << " underruns:" << m_nAudioUnderruns
+			<< " late:" << m_nAudioLate << " corrupt:" << m_nAudioCorrupt << std::endl;
+		m_audioLatency.Print(os, "audio");
+		m_pushBlocked.printPercentiles(os, "audio.pushBlocked", "us");
+		m_pullStall.printPercentiles(os, "audio.pullStall", "us");
+	}
+
+	if (m_config.video)
+	{
+		os << "video " << m_config.width << "x" << m_config.height << ", "
+			<< m_config.srcFps << " fps source, " << m_config.fps << " fps pulls" << std::endl;
+		os << "  pushes:" << m_nVideoPushes << " pulls:" << m_nVideoPulls
+			<< " underruns:" << m_nVideoUnderruns << " drops:" << m_nVideoDrops
+			<< " repeats:" << m_nVideoRepeats << std::endl;
+		m_videoLatency.Print(os, "video");
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	SIM_CONFIG config;
+	if (!config.Parse(argc, argv))
+	{
+		std::cerr << "usage: pipeline_sim [key=value ...], see the top of bench/pipeline_sim.cpp" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	CPipelineSim sim(config);
+	sim.Run();
+	double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	sim.Report(std::cout, wallSeconds);
+	if (!config.output.empty())
+	{
+		std::ofstream file(config.output);
+		sim.Report(file, wallSeconds);
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,812 @@
+#include "MockRtcEngine.h"
+#include "../agora/include/IAgoraService.h"
+#include "json/json.h"
+#include "Logger.h"
+#include <cstdlib>
+#include <cmath>
+#include <cstring>
+#include <memory>
+
+static int64_t NowMs()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool MOCK_CONFIG::Parse(const char* lpJson, const char* lpPrefix)
+{
+	Json::Value root;
+	Json::CharReaderBuilder builder;
+	JSONCPP_STRING err;
+
+	std::string rawJson(lpJson);
+	const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+	if (!reader->parse(rawJson.c_str(), rawJson.c_str() + rawJson.length(), &root, &err) || !root.isObject())
+		return false;
+
+	struct { const char* lpName; int* pValue; } fields[] = {
+		{ "joinLatencyMs", &joinLatencyMs },
+		{ "leaveLatencyMs", &leaveLatencyMs },
+		{ "jitterMs", &jitterMs },
+		{ "peers", &peers },
+		{ "peerJoinMs", &peerJoinMs },
+		{ "firstFrameMs", &firstFrameMs },
+		{ "peerChurnMs", &peerChurnMs },
+		{ "captureWidth", &captureWidth },
+		{ "captureHeight", &captureHeight },
+		{ "captureFps", &captureFps },
+		{ "audioSampleRate", &audioSampleRate },
+		{ "audioChannels", &audioChannels },
+		{ "statsIntervalMs", &statsIntervalMs },
+		{ "videoBitrate", &videoBitrate },
+		{ "audioBitrate", &audioBitrate },
+		{ "speakerMs", &speakerMs },
+		{ "remoteFps", &remoteFps },
+		{ "audioDropPermille", &audioDropPermille },
+	};
+
+	bool bFound = false;
+	for (auto& field : fields)
+	{
+		const Json::Value& value = root[std::string(lpPrefix) + field.lpName];
+		if (value.isNumeric())
+		{
+			*field.pValue = value.asInt();
+			bFound = true;
+		}
+	}
+	return bFound;
+}
+
+CMockMediaEngine::CMockMediaEngine()
+	: m_lpVideoObserver(nullptr)
+	, m_nRenderTicks(0)
+	, m_lpAudioObserver(nullptr)
+	, m_bAudioSink(false)
+	, m_nSinkSampleRate(0)
+	, m_nSinkChannels(0)
+	, m_dSinkPhase(0)
+	, m_sinkRandom(std::random_device()())
+	, m_nRemotePeers(0)
+	, m_nMixedSampleRate(0)
+	, m_nMixedSamples(0)
+	, m_dMixedPhase(0)
+{
+	memset(&m_videoFrame, 0, sizeof(m_videoFrame));
+	memset(&m_renderFrame, 0, sizeof(m_renderFrame));
+	memset(&m_audioFrame, 0, sizeof(m_audioFrame));
+	memset(&m_playbackFrame, 0, sizeof(m_playbackFrame));
+}
+
+CMockMediaEngine::~CMockMediaEngine()
+{
+	Stop();
+}
+
+void CMockMediaEngine::SetConfig(const MOCK_CONFIG& config)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_config = config;
+}
+
+void CMockMediaEngine::Stop()
+{
+	registerVideoFrameObserver(nullptr);
+	registerAudioFrameObserver(nullptr);
+}
+
+int CMockMediaEngine::registerVideoFrameObserver(agora::media::IVideoFrameObserver* observer)
+{
+	if (m_videoCadence.IsRunning())
+	{
+		m_videoCadence.Stop();
+		LOG_INFO("mock capture video: %lld frames, %lld dropped", (long long)m_videoCadence.GetTicks(), (long long)m_videoCadence.GetDropped());
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_lockRender);
+		m_lpVideoObserver = observer;
+	}
+	if (!observer)
+		return 0;
+
+	int nFps = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		int nWidth = m_config.captureWidth & ~1;
+		int nHeight = m_config.captureHeight & ~1;
+		nFps = m_config.captureFps > 0 ? m_config.captureFps : 15;
+
+		m_videoBuffer.assign(nWidth * nHeight * 3 / 2, 0);
+		m_videoFrame.type = agora::media::IVideoFrameObserver::FRAME_TYPE_YUV420;
+		m_videoFrame.width = nWidth;
+		m_videoFrame.height = nHeight;
+		m_videoFrame.yStride = nWidth;
+		m_videoFrame.uStride = nWidth / 2;
+		m_videoFrame.vStride = nWidth / 2;
+		m_videoFrame.yBuffer = m_videoBuffer.data();
+		m_videoFrame.uBuffer = m_videoBuffer.data() + nWidth * nHeight;
+		m_videoFrame.vBuffer = m_videoBuffer.data() + nWidth * nHeight * 5 / 4;
+		m_videoFrame.rotation = 0;
+	}
+
+	m_videoCadence.Start(1000000 / nFps, [this]() { CaptureVideoFrame(); });
+	return 0;
+}
+
+void CMockMediaEngine::CaptureVideoFrame()
+{
+	m_videoFrame.renderTimeMs = NowMs();
+	m_lpVideoObserver->onCaptureVideoFrame(m_videoFrame);
+}
+
+// horizontal bars moving down a frame per call, tinted by the uid
+void CMockMediaEngine::RenderVideoFrame(uid_t uid, int nWidth, int nHeight)
+{
+	std::lock_guard<std::mutex> lock(m_lockRender);
+	if (!m_lpVideoObserver)
+		return;
+
+	size_t nLumaSize = (size_t)nWidth * nHeight;
+	if (m_renderBuffer.size() < nLumaSize * 3 / 2)
+		m_renderBuffer.resize(nLumaSize * 3 / 2);
+	unsigned char* lpY = m_renderBuffer.data();
+	for (int y = 0; y < nHeight; y++)
+		memset(lpY + (size_t)y * nWidth, (int)((y + m_nRenderTicks) & 0xff), nWidth);
+	memset(lpY + nLumaSize, 64 + (int)(uid * 40 % 128), nLumaSize / 4);
+	memset(lpY + nLumaSize * 5 / 4, 64 + (int)(uid * 72 % 128), nLumaSize / 4);
+	m_nRenderTicks++;
+
+	m_renderFrame.type = agora::media::IVideoFrameObserver::FRAME_TYPE_YUV420;
+	m_renderFrame.width = nWidth;
+	m_renderFrame.height = nHeight;
+	m_renderFrame.yStride = nWidth;
+	m_renderFrame.uStride = nWidth / 2;
+	m_renderFrame.vStride = nWidth / 2;
+	m_renderFrame.yBuffer = lpY;
+	m_renderFrame.uBuffer = lpY + nLumaSize;
+	m_renderFrame.vBuffer = lpY + nLumaSize * 5 / 4;
+	m_renderFrame.renderTimeMs = NowMs();
+	m_lpVideoObserver->onRenderVideoFrame(uid, m_renderFrame);
+}
+
+int CMockMediaEngine::registerAudioFrameObserver(agora::media::IAudioFrameObserver* observer)
+{
+	if (m_audioCadence.IsRunning())
+	{
+		m_audioCadence.Stop();
+		LOG_INFO("mock record audio: %lld frames, %lld dropped", (long long)m_audioCadence.GetTicks(), (long long)m_audioCadence.GetDropped());
+	}
+
+	m_lpAudioObserver = observer;
+	if (!observer)
+		return 0;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_audioFrame.type = agora::media::IAudioFrameObserver::FRAME_TYPE_PCM16;
+		m_audioFrame.samplesPerSec = m_config.audioSampleRate;
+		m_audioFrame.channels = m_config.audioChannels;
+		m_audioFrame.bytesPerSample = 2;
+		m_audioFrame.samples = m_config.audioSampleRate / 100;
+		// the observer may rewrite channels/samplesPerSec, leave room for 8 channels
+		m_audioBuffer.assign(m_audioFrame.samples * 8 * 2, 0);
+		m_audioFrame.buffer = m_audioBuffer.data();
+	}
+
+	m_audioCadence.Start(10000, [this]() { RecordAudioFrame(); });
+	return 0;
+}
+
+void CMockMediaEngine::RecordAudioFrame()
+{
+	m_audioFrame.renderTimeMs = NowMs();
+	m_lpAudioObserver->onRecordAudioFrame(m_audioFrame);
+	PlaybackAudioFrames();
+}
+
+void CMockMediaEngine::PlaybackAudioFrames()
+{
+	std::lock_guard<std::mutex> lock(m_lockPlayback);
+	m_playbackFrame.type = agora::media::IAudioFrameObserver::FRAME_TYPE_PCM16;
+	m_playbackFrame.bytesPerSample = 2;
+	m_playbackFrame.channels = 1;
+	m_playbackFrame.renderTimeMs = NowMs();
+
+	// every peer a pitch of its own, 220..605Hz
+	for (uid_t uid : m_vecPeers)
+	{
+		m_playbackFrame.samples = 480;
+		m_playbackFrame.samplesPerSec = 48000;
+		m_playbackBuffer.resize(m_playbackFrame.samples);
+		m_playbackFrame.buffer = m_playbackBuffer.data();
+		FillTone(m_playbackBuffer.data(), m_playbackFrame.samples, 48000, 220 + 55 * (uid % 8), m_mapPeerPhase[uid]);
+		m_lpAudioObserver->onPlaybackAudioFrameBeforeMixing(uid, m_playbackFrame);
+	}
+
+	if (m_nMixedSampleRate <= 0)
+		return;
+	m_playbackFrame.samples = m_nMixedSamples;
+	m_playbackFrame.samplesPerSec = m_nMixedSampleRate;
+	m_playbackBuffer.resize(m_nMixedSamples);
+	m_playbackFrame.buffer = m_playbackBuffer.data();
+	if (m_vecPeers.empty())
+		memset(m_playbackBuffer.data(), 0, m_nMixedSamples * sizeof(int16_t));
+	else
+		FillTone(m_playbackBuffer.data(), m_nMixedSamples, m_nMixedSampleRate, 440, m_dMixedPhase);
+	m_lpAudioObserver->onMixedAudioFrame(m_playbackFrame);
+}
+
+void CMockMediaEngine::FillTone(int16_t* lpPcm, int nSamples, int nSampleRate, double dFrequency, double& dPhase)
+{
+	double dStep = 2 * M_PI * dFrequency / nSampleRate;
+	for (int i = 0; i < nSamples; i++)
+		lpPcm[i] = (int16_t)(8192 * sin(dPhase + dStep * i));
+	dPhase = fmod(dPhase + dStep * nSamples, 2 * M_PI);
+}
+
+void CMockMediaEngine::SetRemotePeers(const std::unordered_set<uid_t>& setPeers)
+{
+	m_nRemotePeers.store((int)setPeers.size());
+	std::lock_guard<std::mutex> lock(m_lockPlayback);
+	m_vecPeers.assign(setPeers.begin(), setPeers.end());
+}
+
+void CMockMediaEngine::SetMixedAudio(int nSampleRate, int nSamples)
+{
+	std::lock_guard<std::mutex> lock(m_lockPlayback);
+	m_nMixedSampleRate = nSampleRate;
+	m_nMixedSamples = nSamples;
+	m_dMixedPhase = 0;
+}
+
+void CMockMediaEngine::SetAudioSink(bool bEnable, int nSampleRate, int nChannels)
+{
+	std::lock_guard<std::mutex> lock(m_lockSink);
+	m_bAudioSink = bEnable;
+	m_nSinkSampleRate = nSampleRate;
+	m_nSinkChannels = nChannels;
+	m_dSinkPhase = 0;
+}
+
+// the mix of the peers is a tone at -12 dBFS, a dropped frame is all zeros like a decoder that ran dry
+int CMockMediaEngine::pullAudioFrame(agora::media::IAudioFrameObserver::AudioFrame* frame)
+{
+	if (!frame || !frame->buffer)
+		return -ERR_INVALID_ARGUMENT;
+
+	int nDropPermille = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		nDropPermille = m_config.audioDropPermille;
+	}
+
+	std::lock_guard<std::mutex> lock(m_lockSink);
+	if (!m_bAudioSink || frame->type != agora::media::IAudioFrameObserver::FRAME_TYPE_PCM16 || frame->bytesPerSample != 2
+		|| frame->samplesPerSec != m_nSinkSampleRate || frame->channels != m_nSinkChannels || frame->samples <= 0)
+		return -ERR_NOT_READY;
+
+	int16_t* lpPcm = (int16_t*)frame->buffer;
+	size_t nCount = (size_t)frame->samples * frame->channels;
+	double dStep = 2 * M_PI * 440 / m_nSinkSampleRate;
+	bool bDrop = nDropPermille > 0 && std::uniform_int_distribution<int>(0, 999)(m_sinkRandom) < nDropPermille;
+	if (m_nRemotePeers.load() <= 0 || bDrop)
+		memset(lpPcm, 0, nCount * sizeof(int16_t));
+	else
+	{
+		for (int i = 0; i < frame->samples; i++)
+		{
+			int16_t nSample = (int16_t)(8192 * sin(m_dSinkPhase + dStep * i));
+			for (int c = 0; c < frame->channels; c++)
+				lpPcm[(size_t)i * frame->channels + c] = nSample;
+		}
+	}
+	// the tone goes on through a dropped frame, like the talker does
+	m_dSinkPhase = fmod(m_dSinkPhase + dStep * frame->samples, 2 * M_PI);
+	frame->renderTimeMs = NowMs();
+	return 0;
+}
+
+CMockRtcEngine::CMockRtcEngine()
+	: m_lpEventHandler(nullptr)
+	, m_random(std::random_device()())
+	, m_nUID(0)
+	, m_bDefaultMuteRemoteVideo(false)
+	, m_bDualStream(false)
+	, m_nVolumeIntervalMs(0)
+	, m_nActiveSpeaker(0)
+	, m_nSpeakerElapsedMs(0)
+	, m_nGeneration(0)
+{
+	const char* lpConfig = getenv("RTC_MOCK_CONFIG");
+	if (lpConfig)
+		m_config.Parse(lpConfig, "");
+	m_mediaEngine.SetConfig(m_config);
+}
+
+CMockRtcEngine::~CMockRtcEngine()
+{
+	m_renderCadence.Stop();
+	m_mediaEngine.Stop();
+	m_loop.Stop();
+}
+
+bool CMockRtcEngine::SetConfig(const char* lpJson, const char* lpPrefix)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	bool bFound = m_config.Parse(lpJson, lpPrefix);
+	m_mediaEngine.SetConfig(m_config);
+	return bFound;
+}
+
+int CMockRtcEngine::setVideoEncoderConfiguration(const VideoEncoderConfiguration& config)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (config.dimensions.width > 0 && config.dimensions.height > 0)
+	{
+		m_config.captureWidth = config.dimensions.width;
+		m_config.captureHeight = config.dimensions.height;
+	}
+	if (config.frameRate > 0)
+		m_config.captureFps = config.frameRate;
+	if (config.bitrate > 0)
+		m_config.videoBitrate = config.bitrate;
+	m_mediaEngine.SetConfig(m_config);
+	return 0;
+}
+
+// only the bitrate of the profile, the recorded frames keep their format
+int CMockRtcEngine::setAudioProfile(AUDIO_PROFILE_TYPE profile, AUDIO_SCENARIO_TYPE scenario)
+{
+	// kbps of each AUDIO_PROFILE_TYPE, the default is music standard
+	static const int nBitrates[AUDIO_PROFILE_NUM] = { 48, 18, 48, 56, 128, 192, 16 };
+	if (profile < AUDIO_PROFILE_DEFAULT || profile >= AUDIO_PROFILE_NUM)
+		return -2;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_config.audioBitrate = nBitrates[profile];
+	return 0;
+}
+
+int CMockRtcEngine::setDefaultMuteAllRemoteVideoStreams(bool mute)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_bDefaultMuteRemoteVideo = mute;
+	return 0;
+}
+
+// unmuting a peer in the channel decodes its first frame firstFrameMs later
+int CMockRtcEngine::muteRemoteVideoStream(uid_t userId, bool mute)
+{
+	int nFirstFrameMs = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		bool bSubscribed = IsVideoSubscribed(userId);
+		m_mapMuteRemoteVideo[userId] = mute;
+		if (mute || bSubscribed || m_setPeers.find(userId) == m_setPeers.end())
+			return 0;
+		nFirstFrameMs = m_config.firstFrameMs;
+	}
+	FirstVideoDecoded(m_nGeneration, userId, Delay(nFirstFrameMs));
+	return 0;
+}
+
+int CMockRtcEngine::setRemoteVideoStreamType(uid_t userId, REMOTE_VIDEO_STREAM_TYPE streamType)
+{
+	if (streamType != REMOTE_VIDEO_STREAM_HIGH && streamType != REMOTE_VIDEO_STREAM_LOW)
+		return -ERR_INVALID_ARGUMENT;
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_mapRemoteStreamType[userId] = streamType;
+	return 0;
+}
+
+int CMockRtcEngine::enableAudioVolumeIndication(int interval, int smooth, bool report_vad)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_nVolumeIntervalMs = interval > 0 ? interval : 0;
+	return 0;
+}
+
+int CMockRtcEngine::enableDualStreamMode(bool enabled)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_bDualStream = enabled;
+	return 0;
+}
+
+// under m_mutex
+bool CMockRtcEngine::IsVideoSubscribed(uid_t uid)
+{
+	auto it = m_mapMuteRemoteVideo.find(uid);
+	return !(it == m_mapMuteRemoteVideo.end() ? m_bDefaultMuteRemoteVideo : it->second);
+}
+
+int CMockRtcEngine::initialize(const RtcEngineContext& context)
+{
+	m_lpEventHandler = context.eventHandler;
+	return 0;
+}
+
+void CMockRtcEngine::release(bool sync)
+{
+	delete this;
+}
+
+int CMockRtcEngine::Delay(int nMs)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_config.jitterMs <= 0)
+		return nMs;
+	return nMs + std::uniform_int_distribution<int>(0, m_config.jitterMs)(m_random);
+}
+
+int CMockRtcEngine::Elapsed()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return (int)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_joinTime).count();
+}
+
+int CMockRtcEngine::joinChannel(const char* token, const char* channelId, const char* info, uid_t uid)
+{
+	if (!channelId)
+		return -ERR_INVALID_ARGUMENT;
+
+	MOCK_CONFIG config;
+	uid_t nUID = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		config = m_config;
+		m_strChannel = channelId;
+		m_setPeers.clear();
+		m_mediaEngine.SetRemotePeers(std::unordered_set<uid_t>());
+		m_mapMuteRemoteVideo.clear();
+		m_mapRemoteStreamType.clear();
+		m_nActiveSpeaker = 0;
+		m_nSpeakerElapsedMs = 0;
+		m_nUID = uid != 0 ? uid : std::uniform_int_distribution<uid_t>(1, 0x7fffffff)(m_random);
+		nUID = m_nUID;
+		m_joinTime = std::chrono::steady_clock::now();
+	}
+	unsigned int nGeneration = ++m_nGeneration;
+
+	m_renderCadence.Stop();
+	if (config.remoteFps > 0)
+		m_renderCadence.Start(1000000 / config.remoteFps, [this, nGeneration]() { RenderRemoteVideo(nGeneration); });
+
+	int nJoinMs = Delay(config.joinLatencyMs);
+	// a later join rewrites the channel, the callback keeps the one of its session
+	std::string strChannel = channelId;
+	m_loop.Post(nJoinMs, [this, nGeneration, strChannel, nUID]() {
+		if (nGeneration == m_nGeneration && m_lpEventHandler)
+			m_lpEventHandler->onJoinChannelSuccess(strChannel.c_str(), nUID, Elapsed());
+	});
+
+	for (int i = 0; i < config.peers; i++)
+		PeerJoin(nGeneration, 1000000 + i, nJoinMs + Delay(config.peerJoinMs * (i + 1)));
+
+	if (config.statsIntervalMs > 0)
+		m_loop.Post(nJoinMs + config.statsIntervalMs, [this, nGeneration]() { ReportStats(nGeneration); });
+
+	int nVolumeIntervalMs = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		nVolumeIntervalMs = m_nVolumeIntervalMs;
+	}
+	if (nVolumeIntervalMs > 0)
+		m_loop.Post(nJoinMs + nVolumeIntervalMs, [this, nGeneration]() { ReportVolume(nGeneration); });
+
+	return 0;
+}
+
+// the local stats, one remote video/audio report per configured peer, churned peers included,
+// video only of the subscribed ones, and the call stats summing them up
+void CMockRtcEngine::ReportStats(unsigned int nGeneration)
+{
+	if (nGeneration != m_nGeneration || !m_lpEventHandler)
+		return;
+
+	// m_random is shared with Delay on the caller threads, the report draws from its own
+	MOCK_CONFIG config;
+	std::minstd_rand random;
+	bool bDualStream = false;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		config = m_config;
+		bDualStream = m_bDualStream;
+		random.seed(m_random());
+	}
+	int nElapsedS = Elapsed() / 1000;
+
+	LocalVideoStats localVideo;
+	memset(&localVideo, 0, sizeof(localVideo));
+	localVideo.sentFrameRate = localVideo.encoderOutputFrameRate = localVideo.captureFrameRate = config.captureFps;
+	localVideo.targetBitrate = config.videoBitrate;
+	localVideo.sentBitrate = localVideo.encodedBitrate = config.videoBitrate * std::uniform_int_distribution<int>(90, 110)(random) / 100;
+	localVideo.encodedFrameWidth = config.captureWidth;
+	localVideo.encodedFrameHeight = config.captureHeight;
+	localVideo.encodedFrameCount = config.captureFps * nElapsedS;
+	m_lpEventHandler->onLocalVideoStats(localVideo);
+
+	LocalAudioStats localAudio;
+	memset(&localAudio, 0, sizeof(localAudio));
+	localAudio.numChannels = config.audioChannels;
+	localAudio.sentSampleRate = config.audioSampleRate;
+	localAudio.sentBitrate = config.audioBitrate;
+	m_lpEventHandler->onLocalAudioStats(localAudio);
+
+	int nRxVideoKBitRate = 0;
+	for (int i = 0; i < config.peers; i++)
+	{
+		bool bSubscribed = false;
+		bool bLowStream = false;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			bSubscribed = IsVideoSubscribed(1000000 + i);
+			auto it = m_mapRemoteStreamType.find(1000000 + i);
+			bLowStream = it != m_mapRemoteStreamType.end() && it->second == REMOTE_VIDEO_STREAM_LOW;
+		}
+		RemoteVideoStats remoteVideo;
+		memset(&remoteVideo, 0, sizeof(remoteVideo));
+		remoteVideo.uid = 1000000 + i;
+		remoteVideo.width = bLowStream ? 160 : 640;
+		remoteVideo.height = bLowStream ? 120 : 480;
+		remoteVideo.delay = 40 + std::uniform_int_distribution<int>(0, 40)(random);
+		remoteVideo.receivedBitrate = bLowStream ? 100 + std::uniform_int_distribution<int>(0, 40)(random)
+			: 800 + std::uniform_int_distribution<int>(0, 400)(random);
+		remoteVideo.rxStreamType = bLowStream ? REMOTE_VIDEO_STREAM_LOW : REMOTE_VIDEO_STREAM_HIGH;
+		remoteVideo.decoderOutputFrameRate = remoteVideo.rendererOutputFrameRate = 15;
+		remoteVideo.totalActiveTime = remoteVideo.publishDuration = nElapsedS;
+		if (bSubscribed)
+			m_lpEventHandler->onRemoteVideoStats(remoteVideo);
+
+		RemoteAudioStats remoteAudio;
+		memset(&remoteAudio, 0, sizeof(remoteAudio));
+		remoteAudio.uid = remoteVideo.uid;
+		remoteAudio.quality = QUALITY_EXCELLENT;
+		remoteAudio.networkTransportDelay = 20 + std::uniform_int_distribution<int>(0, 20)(random);
+		remoteAudio.jitterBufferDelay = 30;
+		remoteAudio.numChannels = 1;
+		remoteAudio.receivedSampleRate = 48000;
+		remoteAudio.receivedBitrate = 48;
+		remoteAudio.totalActiveTime = remoteAudio.publishDuration = nElapsedS;
+		m_lpEventHandler->onRemoteAudioStats(remoteAudio);
+		if (bSubscribed)
+			nRxVideoKBitRate += remoteVideo.receivedBitrate;
+	}
+
+	RtcStats rtc;
+	rtc.duration = nElapsedS;
+	// the low stream goes out next to the high one
+	rtc.txVideoKBitRate = localVideo.sentBitrate + (bDualStream ? 120 : 0);
+	rtc.txAudioKBitRate = localAudio.sentBitrate;
+	rtc.txKBitRate = rtc.txVideoKBitRate + rtc.txAudioKBitRate;
+	rtc.rxVideoKBitRate = nRxVideoKBitRate;
+	rtc.rxAudioKBitRate = 48 * config.peers;
+	rtc.rxKBitRate = rtc.rxVideoKBitRate + rtc.rxAudioKBitRate;
+	rtc.lastmileDelay = 10 + std::uniform_int_distribution<int>(0, 20)(random);
+	rtc.gatewayRtt = 20 + std::uniform_int_distribution<int>(0, 40)(random);
+	rtc.userCount = config.peers + 1;
+	m_lpEventHandler->onRtcStats(rtc);
+
+	m_loop.Post(config.statsIntervalMs, [this, nGeneration]() { ReportStats(nGeneration); });
+}
+
+// the local report, then the active speaker loud and two other peers in the background
+void CMockRtcEngine::ReportVolume(unsigned int nGeneration)
+{
+	if (nGeneration != m_nGeneration || !m_lpEventHandler)
+		return;
+
+	int nIntervalMs = 0;
+	std::vector<AudioVolumeInfo> speakers;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		nIntervalMs = m_nVolumeIntervalMs;
+		if (m_config.speakerMs > 0 && !m_setPeers.empty())
+		{
+			std::vector<uid_t> peers(m_setPeers.begin(), m_setPeers.end());
+			m_nSpeakerElapsedMs += nIntervalMs;
+			if (m_setPeers.find(m_nActiveSpeaker) == m_setPeers.end() || m_nSpeakerElapsedMs >= m_config.speakerMs)
+			{
+				m_nActiveSpeaker = peers[std::uniform_int_distribution<size_t>(0, peers.size() - 1)(m_random)];
+				m_nSpeakerElapsedMs = 0;
+			}
+
+			AudioVolumeInfo info;
+			memset(&info, 0, sizeof(info));
+			info.uid = m_nActiveSpeaker;
+			info.volume = std::uniform_int_distribution<unsigned int>(180, 230)(m_random);
+			info.vad = 1;
+			speakers.push_back(info);
+			for (int i = 0; i < 2 && (size_t)i + 1 < peers.size(); i++)
+			{
+				uid_t uid = peers[std::uniform_int_distribution<size_t>(0, peers.size() - 1)(m_random)];
+				if (uid == m_nActiveSpeaker)
+					continue;
+				info.uid = uid;
+				info.volume = std::uniform_int_distribution<unsigned int>(10, 40)(m_random);
+				info.vad = 0;
+				speakers.push_back(info);
+			}
+		}
+	}
+	if (nIntervalMs <= 0)
+		return;
+
+	AudioVolumeInfo local;
+	memset(&local, 0, sizeof(local));
+	m_lpEventHandler->onAudioVolumeIndication(&local, 1, 0);
+	unsigned int nTotal = speakers.empty() ? 0 : speakers[0].volume;
+	m_lpEventHandler->onAudioVolumeIndication(speakers.empty() ? NULL : &speakers[0], (unsigned int)speakers.size(), nTotal);
+
+	m_loop.Post(nIntervalMs, [this, nGeneration]() { ReportVolume(nGeneration); });
+}
+
+void CMockRtcEngine::PeerJoin(unsigned int nGeneration, uid_t uid, int nDelayMs)
+{
+	int nFirstFrameMs = 0;
+	int nChurnMs = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		nFirstFrameMs = m_config.firstFrameMs;
+		nChurnMs = m_config.peerChurnMs;
+	}
+
+	m_loop.Post(nDelayMs, [this, nGeneration, uid]() {
+		if (nGeneration != m_nGeneration || !m_lpEventHandler)
+			return;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_setPeers.insert(uid);
+			m_mediaEngine.SetRemotePeers(m_setPeers);
+		}
+		m_lpEventHandler->onUserJoined(uid, Elapsed());
+	});
+	FirstVideoDecoded(nGeneration, uid, nDelayMs + Delay(nFirstFrameMs));
+
+	if (nChurnMs <= 0)
+		return;
+
+	// leave after nChurnMs and come back nChurnMs later
+	int nOfflineMs = nDelayMs + Delay(nChurnMs);
+	m_loop.Post(nOfflineMs, [this, nGeneration, uid, nChurnMs]() {
+		if (nGeneration != m_nGeneration || !m_lpEventHandler)
+			return;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_setPeers.erase(uid);
+			m_mediaEngine.SetRemotePeers(m_setPeers);
+			m_mapMuteRemoteVideo.erase(uid);
+			m_mapRemoteStreamType.erase(uid);
+		}
+		m_lpEventHandler->onUserOffline(uid, USER_OFFLINE_QUIT);
+		PeerJoin(nGeneration, uid, Delay(nChurnMs));
+	});
+}
+
+// only while the peer is in the channel and its video is subscribed
+void CMockRtcEngine::FirstVideoDecoded(unsigned int nGeneration, uid_t uid, int nDelayMs)
+{
+	m_loop.Post(nDelayMs, [this, nGeneration, uid]() {
+		if (nGeneration != m_nGeneration || !m_lpEventHandler)
+			return;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_setPeers.find(uid) == m_setPeers.end() || !IsVideoSubscribed(uid))
+				return;
+		}
+		m_lpEventHandler->onFirstRemoteVideoDecoded(uid, 640, 480, Elapsed());
+	});
+}
+
+void CMockRtcEngine::RenderRemoteVideo(unsigned int nGeneration)
+{
+	std::vector<std::pair<uid_t, bool>> vecPeers;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (nGeneration != m_nGeneration)
+			return;
+		for (uid_t uid : m_setPeers)
+		{
+			if (!IsVideoSubscribed(uid))
+				continue;
+			auto it = m_mapRemoteStreamType.find(uid);
+			vecPeers.push_back(std::make_pair(uid, it != m_mapRemoteStreamType.end() && it->second == REMOTE_VIDEO_STREAM_LOW));
+		}
+	}
+	for (auto& peer : vecPeers)
+		m_mediaEngine.RenderVideoFrame(peer.first, peer.second ? 160 : 640, peer.second ? 120 : 480);
+}
+
+int CMockRtcEngine::setExternalAudioSink(bool enabled, int sampleRate, int channels)
+{
+	if (enabled && (sampleRate <= 0 || sampleRate % 100 != 0 || channels < 1 || channels > 2))
+		return -ERR_INVALID_ARGUMENT;
+	m_mediaEngine.SetAudioSink(enabled, sampleRate, channels);
+	return 0;
+}
+
+int CMockRtcEngine::setMixedAudioFrameParameters(int sampleRate, int samplesPerCall)
+{
+	if (sampleRate <= 0 || samplesPerCall <= 0)
+		return -ERR_INVALID_ARGUMENT;
+	m_mediaEngine.SetMixedAudio(sampleRate, samplesPerCall);
+	return 0;
+}
+
+int CMockRtcEngine::leaveChannel()
+{
+	unsigned int nGeneration = ++m_nGeneration;
+	m_renderCadence.Stop();
+	int nLeaveMs = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		nLeaveMs = m_config.leaveLatencyMs;
+	}
+	m_mediaEngine.SetRemotePeers(std::unordered_set<uid_t>());
+
+	m_loop.Post(Delay(nLeaveMs), [this, nGeneration]() {
+		if (nGeneration != m_nGeneration || !m_lpEventHandler)
+			return;
+		RtcStats stats;
+		stats.duration = (unsigned int)(Elapsed() / 1000);
+		m_lpEventHandler->onLeaveChannel(stats);
+	});
+	return 0;
+}
+
+int CMockRtcEngine::queryInterface(INTERFACE_ID_TYPE iid, void** inter)
+{
+	if (!inter)
+		return -ERR_INVALID_ARGUMENT;
+
+	switch (iid)
+	{
+	case agora::AGORA_IID_RTC_ENGINE_PARAMETER:
+		*inter = static_cast<IRtcEngineParameter*>(new CMockRtcEngineParameter(this));
+		return 0;
+	case agora::AGORA_IID_MEDIA_ENGINE:
+		*inter = static_cast<agora::media::IMediaEngine*>(&m_mediaEngine);
+		return 0;
+	default:
+		*inter = nullptr;
+		return -ERR_NOT_SUPPORTED;
+	}
+}
+
+const char* CMockRtcEngine::getVersion(int* build)
+{
+	if (build)
+		*build = 0;
+	return "mock";
+}
+
+const char* CMockRtcEngine::getErrorDescription(int code)
+{
+	return "mock engine";
+}
+
+int CMockRtcEngineParameter::setParameters(const char* parameters)
+{
+	if (!parameters)
+		return -ERR_INVALID_ARGUMENT;
+	// real SDK keys like che.video.* are accepted and ignored
+	m_lpEngine->SetConfig(parameters, "mock.");
+	return 0;
+}
+
+AGORA_API agora::rtc::IRtcEngine* AGORA_CALL createAgoraRtcEngine()
+{
+	return new CMockRtcEngine();
+}
+
+AGORA_API const char* AGORA_CALL getAgoraSdkVersion(int* build)
+{
+	if (build)
+		*build = 0;
+	return "mock";
+}
+
+AGORA_API const char* AGORA_CALL getAgoraSdkErrorDescription(int err)
+{
+	return "mock engine";
+}
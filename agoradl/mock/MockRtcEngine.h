@@ -0,0 +1,393 @@
+#pragma once
+#include "../agora/include/IAgoraRtcEngine.h"
+#include "../agora/include/IAgoraMediaEngine.h"
+#include "MockCadence.h"
+#include "MockEventLoop.h"
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace agora;
+using namespace agora::rtc;
+
+/**
+	knobs of the mock engine, read from the RTC_MOCK_CONFIG environment
+	variable when the engine is created, e.g. {"peers":8,"joinLatencyMs":50},
+	and from setParameters with a "mock." prefix, e.g. {"mock.peers":8}
+*/
+struct MOCK_CONFIG
+{
+	int joinLatencyMs;		// joinChannel -> onJoinChannelSuccess
+	int leaveLatencyMs;		// leaveChannel -> onLeaveChannel
+	int jitterMs;			// uniform 0..jitterMs added to every delay
+	int peers;				// remote users already in the channel
+	int peerJoinMs;			// stagger between two peers showing up after the join
+	int firstFrameMs;		// onUserJoined -> onFirstRemoteVideoDecoded
+	int peerChurnMs;		// 0 keeps the peers, otherwise each peer leaves and comes back every peerChurnMs
+	int captureWidth;		// onCaptureVideoFrame size and rate, setVideoEncoderConfiguration overrides them
+	int captureHeight;
+	int captureFps;
+	int audioSampleRate;	// onRecordAudioFrame format, one frame every 10ms
+	int audioChannels;
+	int statsIntervalMs;	// 0 is off, otherwise local and per peer remote stats callbacks at this interval (the SDK uses 2000)
+	int videoBitrate;		// kbps the local stats report, setVideoEncoderConfiguration overrides it
+	int audioBitrate;		// kbps the local stats report, setAudioProfile overrides it
+	int speakerMs;			// 0 keeps the peers silent, otherwise a random peer becomes the active speaker every speakerMs
+	int remoteFps;			// 0 is off, otherwise onRenderVideoFrame of every subscribed peer at this rate
+	int audioDropPermille;	// pulled frames of the external audio sink that come out as digital silence, an underrun
+
+	MOCK_CONFIG()
+		: joinLatencyMs(50)
+		, leaveLatencyMs(10)
+		, jitterMs(0)
+		, peers(0)
+		, peerJoinMs(20)
+		, firstFrameMs(100)
+		, peerChurnMs(0)
+		, captureWidth(640)
+		, captureHeight(480)
+		, captureFps(15)
+		, audioSampleRate(32000)
+		, audioChannels(1)
+		, statsIntervalMs(0)
+		, videoBitrate(1000)
+		, audioBitrate(48)
+		, speakerMs(0)
+		, remoteFps(0)
+		, audioDropPermille(0)
+	{}
+
+	bool Parse(const char* lpJson, const char* lpPrefix);
+};
+
+/**
+	media engine handed out by queryInterface. a registered video observer
+	gets onCaptureVideoFrame at captureFps and a registered audio observer
+	gets onRecordAudioFrame every 10ms, both from their own thread like the
+	SDK capture threads, until the observer is unregistered. the engine hands
+	the decoded remote frames to the video observer through RenderVideoFrame.
+	with the external audio sink on, pullAudioFrame hands out a 440Hz tone
+	while peers are in the channel and digital silence otherwise. the audio
+	observer also gets onPlaybackAudioFrameBeforeMixing of every peer, a
+	48kHz mono tone of its own pitch, and onMixedAudioFrame once
+	setMixedAudioFrameParameters set its format, both right after
+	onRecordAudioFrame
+*/
+class CMockMediaEngine : public agora::media::IMediaEngine
+{
+public:
+	CMockMediaEngine();
+	~CMockMediaEngine();
+
+	void SetConfig(const MOCK_CONFIG& config);
+	void Stop();
+	// onRenderVideoFrame of a moving pattern, from the render thread of the engine
+	void RenderVideoFrame(uid_t uid, int nWidth, int nHeight);
+	// setExternalAudioSink of the engine
+	void SetAudioSink(bool bEnable, int nSampleRate, int nChannels);
+	void SetRemotePeers(const std::unordered_set<uid_t>& setPeers);
+	// setMixedAudioFrameParameters of the engine, mono
+	void SetMixedAudio(int nSampleRate, int nSamples);
+
+	// owned by CMockRtcEngine, AutoPtr releasing it is a no op
+	virtual void release() override {}
+	virtual int registerAudioFrameObserver(agora::media::IAudioFrameObserver* observer) override;
+	virtual int registerVideoFrameObserver(agora::media::IVideoFrameObserver* observer) override;
+	virtual int registerVideoRenderFactory(agora::media::IExternalVideoRenderFactory* factory) override { return 0; }
+	virtual int pushAudioFrame(agora::media::MEDIA_SOURCE_TYPE type, agora::media::IAudioFrameObserver::AudioFrame* frame, bool wrap) override { return 0; }
+	virtual int pushAudioFrame(agora::media::IAudioFrameObserver::AudioFrame* frame) override { return 0; }
+	// -ERR_NOT_READY unless the sink is on and the frame has its format
+	virtual int pullAudioFrame(agora::media::IAudioFrameObserver::AudioFrame* frame) override;
+	virtual int setExternalVideoSource(bool enable, bool useTexture) override { return 0; }
+	virtual int pushVideoFrame(agora::media::ExternalVideoFrame *frame) override { return 0; }
+	virtual int registerVideoEncodedImageReceiver(agora::media::IVideoEncodedImageReceiver* receiver) override { return 0; }
+
+private:
+	void CaptureVideoFrame();
+	void RecordAudioFrame();
+	void PlaybackAudioFrames();
+	// a tone at -12 dBFS, dPhase goes on into the next frame
+	void FillTone(int16_t* lpPcm, int nSamples, int nSampleRate, double dFrequency, double& dPhase);
+
+	std::mutex			m_mutex;
+	MOCK_CONFIG			m_config;
+
+	// the capture cadence is stopped before it changes, the render thread holds m_lockRender
+	agora::media::IVideoFrameObserver*			m_lpVideoObserver;
+	std::mutex									m_lockRender;
+	agora::media::IVideoFrameObserver::VideoFrame	m_renderFrame;
+	std::vector<unsigned char>					m_renderBuffer;
+	int64_t										m_nRenderTicks;
+	agora::media::IVideoFrameObserver::VideoFrame	m_videoFrame;
+	std::vector<unsigned char>					m_videoBuffer;
+	CMockCadence								m_videoCadence;
+
+	agora::media::IAudioFrameObserver*			m_lpAudioObserver;
+	agora::media::IAudioFrameObserver::AudioFrame	m_audioFrame;
+	std::vector<unsigned char>					m_audioBuffer;
+	CMockCadence								m_audioCadence;
+
+	// the external audio sink, under m_lockSink
+	std::mutex									m_lockSink;
+	bool										m_bAudioSink;
+	int											m_nSinkSampleRate;
+	int											m_nSinkChannels;
+	double										m_dSinkPhase;
+	std::mt19937								m_sinkRandom;
+	std::atomic<int>							m_nRemotePeers;
+
+	// the playback frames of the audio observer, under m_lockPlayback
+	std::mutex									m_lockPlayback;
+	std::vector<uid_t>							m_vecPeers;
+	std::unordered_map<uid_t, double>			m_mapPeerPhase;
+	int											m_nMixedSampleRate;
+	int											m_nMixedSamples;
+	double										m_dMixedPhase;
+	agora::media::IAudioFrameObserver::AudioFrame	m_playbackFrame;
+	std::vector<int16_t>						m_playbackBuffer;
+};
+
+/**
+	in process stand in for the Agora engine, no network and no devices.
+	joinChannel/leaveChannel answer on a private callback thread after the
+	configured latency and simulate remote peers joining and leaving,
+	everything else succeeds without doing anything.
+*/
+class CMockRtcEngine : public IRtcEngine
+{
+public:
+	CMockRtcEngine();
+	~CMockRtcEngine();
+
+	bool SetConfig(const char* lpJson, const char* lpPrefix);
+
+	virtual int initialize(const RtcEngineContext& context) override;
+	virtual void release(bool sync = false) override;
+	virtual int joinChannel(const char* token, const char* channelId, const char* info, uid_t uid) override;
+	virtual int leaveChannel() override;
+	virtual int queryInterface(INTERFACE_ID_TYPE iid, void** inter) override;
+	virtual int setVideoEncoderConfiguration(const VideoEncoderConfiguration& config) override;
+	virtual int setAudioProfile(AUDIO_PROFILE_TYPE profile, AUDIO_SCENARIO_TYPE scenario) override;
+	// a peer whose video is muted gets no onFirstRemoteVideoDecoded and no remote video stats
+	virtual int setDefaultMuteAllRemoteVideoStreams(bool mute) override;
+	virtual int muteRemoteVideoStream(uid_t userId, bool mute) override;
+	// the local and the remote onAudioVolumeIndication every interval while in the channel
+	virtual int enableAudioVolumeIndication(int interval, int smooth, bool report_vad) override;
+	// the peers publish a dual stream, the low one is reported as 160x120 at a fraction of the bitrate
+	virtual int setRemoteVideoStreamType(uid_t userId, REMOTE_VIDEO_STREAM_TYPE streamType) override;
+	virtual int enableDualStreamMode(bool enabled) override;
+	// the playout goes to pullAudioFrame of the media engine
+	virtual int setExternalAudioSink(bool enabled, int sampleRate, int channels) override;
+	// the format of onMixedAudioFrame, mono
+	virtual int setMixedAudioFrameParameters(int sampleRate, int samplesPerCall) override;
+	virtual const char* getVersion(int* build) override;
+	virtual const char* getErrorDescription(int code) override;
+
+private:
+	int Delay(int nMs);
+	int Elapsed();
+	void PeerJoin(unsigned int nGeneration, uid_t uid, int nDelayMs);
+	void ReportStats(unsigned int nGeneration);
+	void ReportVolume(unsigned int nGeneration);
+	void FirstVideoDecoded(unsigned int nGeneration, uid_t uid, int nDelayMs);
+	// one frame of every subscribed peer, the low stream at 160x120
+	void RenderRemoteVideo(unsigned int nGeneration);
+	bool IsVideoSubscribed(uid_t uid);
+
+	IRtcEngineEventHandler*	m_lpEventHandler;
+	CMockEventLoop			m_loop;
+	CMockMediaEngine		m_mediaEngine;
+	// the decoder, at remoteFps while in the channel
+	CMockCadence			m_renderCadence;
+	std::mutex				m_mutex;
+	MOCK_CONFIG				m_config;
+	std::mt19937			m_random;
+	std::string				m_strChannel;
+	uid_t					m_nUID;
+	// under m_mutex, the peers in the channel and the video the wrapper subscribed to
+	std::unordered_set<uid_t>			m_setPeers;
+	std::unordered_map<uid_t, bool>	m_mapMuteRemoteVideo;
+	std::unordered_map<uid_t, REMOTE_VIDEO_STREAM_TYPE> m_mapRemoteStreamType;
+	bool					m_bDefaultMuteRemoteVideo;
+	bool					m_bDualStream;
+	int						m_nVolumeIntervalMs;
+	uid_t					m_nActiveSpeaker;
+	int						m_nSpeakerElapsedMs;	// since the active speaker changed
+	std::chrono::steady_clock::time_point m_joinTime;	// under m_mutex
+	// bumped by every join/leave, stale callbacks of an earlier session are dropped
+	std::atomic<unsigned int> m_nGeneration;
+
+public:
+	// not simulated
+	virtual int setChannelProfile(CHANNEL_PROFILE_TYPE profile) override { return 0; }
+	virtual int setClientRole(CLIENT_ROLE_TYPE role) override { return 0; }
+	virtual int switchChannel(const char* token, const char* channelId) override { return 0; }
+	virtual int renewToken(const char* token) override { return 0; }
+	virtual int registerLocalUserAccount( const char* appId, const char* userAccount) override { return 0; }
+	virtual int joinChannelWithUserAccount(const char* token, const char* channelId, const char* userAccount) override { return 0; }
+	virtual int getUserInfoByUserAccount(const char* userAccount, UserInfo* userInfo) override { return 0; }
+	virtual int getUserInfoByUid(uid_t uid, UserInfo* userInfo) override { return 0; }
+	virtual int startEchoTest() override { return 0; }
+	virtual int startEchoTest(int intervalInSeconds) override { return 0; }
+	virtual int stopEchoTest() override { return 0; }
+	virtual int enableVideo() override { return 0; }
+	virtual int disableVideo() override { return 0; }
+	virtual int setVideoProfile(VIDEO_PROFILE_TYPE profile, bool swapWidthAndHeight) override { return 0; }
+	virtual int setCameraCapturerConfiguration(const CameraCapturerConfiguration& config) override { return 0; }
+	virtual int setupLocalVideo(const VideoCanvas& canvas) override { return 0; }
+	virtual int setupRemoteVideo(const VideoCanvas& canvas) override { return 0; }
+	virtual int startPreview() override { return 0; }
+	virtual int setRemoteUserPriority(uid_t uid, PRIORITY_TYPE userPriority) override { return 0; }
+	virtual int stopPreview() override { return 0; }
+	virtual int enableAudio() override { return 0; }
+	virtual int enableLocalAudio(bool enabled) override { return 0; }
+	virtual int disableAudio() override { return 0; }
+	virtual int muteLocalAudioStream(bool mute) override { return 0; }
+	virtual int muteAllRemoteAudioStreams(bool mute) override { return 0; }
+	virtual int setDefaultMuteAllRemoteAudioStreams(bool mute) override { return 0; }
+	virtual int muteRemoteAudioStream(uid_t userId, bool mute) override { return 0; }
+	virtual int muteLocalVideoStream(bool mute) override { return 0; }
+	virtual int enableLocalVideo(bool enabled) override { return 0; }
+	virtual int muteAllRemoteVideoStreams(bool mute) override { return 0; }
+	virtual int setRemoteDefaultVideoStreamType(REMOTE_VIDEO_STREAM_TYPE streamType) override { return 0; }
+	virtual int startAudioRecording(const char* filePath, AUDIO_RECORDING_QUALITY_TYPE quality) override { return 0; }
+	virtual int startAudioRecording(const AudioRecordingConfiguration& config) override { return 0; }
+	virtual int stopAudioRecording() override { return 0; }
+	virtual int startAudioMixing(const char* filePath, bool loopback, bool replace, int cycle) override { return 0; }
+	virtual int stopAudioMixing() override { return 0; }
+	virtual int pauseAudioMixing() override { return 0; }
+	virtual int resumeAudioMixing() override { return 0; }
+	virtual int adjustAudioMixingVolume(int volume) override { return 0; }
+	virtual int adjustAudioMixingPlayoutVolume(int volume) override { return 0; }
+	virtual int getAudioMixingPlayoutVolume() override { return 0; }
+	virtual int adjustAudioMixingPublishVolume(int volume) override { return 0; }
+	virtual int getAudioMixingPublishVolume() override { return 0; }
+	virtual int getAudioMixingDuration() override { return 0; }
+	virtual int getAudioMixingCurrentPosition() override { return 0; }
+	virtual int setAudioMixingPosition(int pos ) override { return 0; }
+	virtual int getEffectsVolume() override { return 0; }
+	virtual int setEffectsVolume(int volume) override { return 0; }
+	virtual int setVolumeOfEffect(int soundId, int volume) override { return 0; }
+	virtual int playEffect(int soundId, const char* filePath, int loopCount, double pitch, double pan, int gain, bool publish = false, int startPos = 0) override { return 0; }
+	virtual int stopEffect(int soundId) override { return 0; }
+	virtual int stopAllEffects() override { return 0; }
+	virtual int preloadEffect(int soundId, const char* filePath) override { return 0; }
+	virtual int unloadEffect(int soundId) override { return 0; }
+	virtual int pauseEffect(int soundId) override { return 0; }
+	virtual int pauseAllEffects() override { return 0; }
+	virtual int resumeEffect(int soundId) override { return 0; }
+	virtual int resumeAllEffects() override { return 0; }
+	virtual int enableSoundPositionIndication(bool enabled) override { return 0; }
+	virtual int setRemoteVoicePosition(uid_t uid, double pan, double gain) override { return 0; }
+	virtual int setLocalVoicePitch(double pitch) override { return 0; }
+	virtual int setLocalVoiceEqualization(AUDIO_EQUALIZATION_BAND_FREQUENCY bandFrequency, int bandGain) override { return 0; }
+	virtual int setLocalVoiceReverb(AUDIO_REVERB_TYPE reverbKey, int value) override { return 0; }
+	virtual int setLocalVoiceChanger(VOICE_CHANGER_PRESET voiceChanger) override { return 0; }
+	virtual int setLocalVoiceReverbPreset(AUDIO_REVERB_PRESET reverbPreset) override { return 0; }
+	virtual int setLogFile(const char* filePath) override { return 0; }
+	virtual int setLogWriter(agora::commons::ILogWriter* pLogWriter) override { return 0; }
+	virtual int releaseLogWriter() override { return 0; }
+	virtual int setLogFilter(unsigned int filter) override { return 0; }
+	virtual int setLogFileSize(unsigned int fileSizeInKBytes) override { return 0; }
+	virtual int setLocalRenderMode(RENDER_MODE_TYPE renderMode) override { return 0; }
+	virtual int setRemoteRenderMode(uid_t userId, RENDER_MODE_TYPE renderMode) override { return 0; }
+	virtual int setLocalVideoMirrorMode(VIDEO_MIRROR_MODE_TYPE mirrorMode) override { return 0; }
+	virtual int setExternalAudioSource(bool enabled, int sampleRate, int channels) override { return 0; }
+	virtual int setRecordingAudioFrameParameters(int sampleRate, int channel, RAW_AUDIO_FRAME_OP_MODE_TYPE mode, int samplesPerCall) override { return 0; }
+	virtual int setPlaybackAudioFrameParameters(int sampleRate, int channel, RAW_AUDIO_FRAME_OP_MODE_TYPE mode, int samplesPerCall) override { return 0; }
+	virtual int adjustRecordingSignalVolume(int volume) override { return 0; }
+	virtual int adjustPlaybackSignalVolume(int volume) override { return 0; }
+	virtual int enableWebSdkInteroperability(bool enabled) override { return 0; }
+	virtual int setLocalPublishFallbackOption(STREAM_FALLBACK_OPTIONS option) override { return 0; }
+	virtual int setRemoteSubscribeFallbackOption(STREAM_FALLBACK_OPTIONS option) override { return 0; }
+#if defined(__ANDROID__) || (defined(__APPLE__) && TARGET_OS_IOS)
+	virtual int switchCamera() override { return 0; }
+	virtual int setDefaultAudioRouteToSpeakerphone(bool defaultToSpeaker) override { return 0; }
+	virtual int setEnableSpeakerphone(bool speakerOn) override { return 0; }
+	virtual int setInEarMonitoringVolume(int volume) override { return 0; }
+	virtual bool isSpeakerphoneEnabled() override { return false; }
+#endif
+#if (defined(__APPLE__) && TARGET_OS_IOS)
+	virtual int setAudioSessionOperationRestriction(AUDIO_SESSION_OPERATION_RESTRICTION restriction) override { return 0; }
+#endif
+#if (defined(__APPLE__) && TARGET_OS_MAC && !TARGET_OS_IPHONE) || defined(_WIN32)
+	virtual int enableLoopbackRecording(bool enabled, const char* deviceName = NULL) override { return 0; }
+#if (defined(__APPLE__) && TARGET_OS_MAC && !TARGET_OS_IPHONE)
+	virtual int startScreenCaptureByDisplayId(unsigned int displayId, const Rectangle& regionRect, const ScreenCaptureParameters& captureParams) override { return 0; }
+#endif
+#if defined(_WIN32)
+	virtual int startScreenCaptureByScreenRect(const Rectangle& screenRect, const Rectangle& regionRect, const ScreenCaptureParameters& captureParams) override { return 0; }
+#endif
+	virtual int startScreenCaptureByWindowId(view_t windowId, const Rectangle& regionRect, const ScreenCaptureParameters& captureParams) override { return 0; }
+	virtual int setScreenCaptureContentHint(VideoContentHint contentHint) override { return 0; }
+	virtual int updateScreenCaptureParameters(const ScreenCaptureParameters& captureParams) override { return 0; }
+	virtual int updateScreenCaptureRegion(const Rectangle& regionRect) override { return 0; }
+	virtual int stopScreenCapture() override { return 0; }
+	virtual int startScreenCapture(WindowIDType windowId, int captureFreq, const Rect *rect, int bitrate) override { return 0; }
+	virtual int updateScreenCaptureRegion(const Rect *rect) override { return 0; }
+#endif
+	virtual int getCallId(agora::util::AString& callId) override { return 0; }
+	virtual int rate(const char* callId, int rating, const char* description) override { return 0; }
+	virtual int complain(const char* callId, const char* description) override { return 0; }
+	virtual int enableLastmileTest() override { return 0; }
+	virtual int disableLastmileTest() override { return 0; }
+	virtual int startLastmileProbeTest(const LastmileProbeConfig& config) override { return 0; }
+	virtual int stopLastmileProbeTest() override { return 0; }
+	virtual int setEncryptionSecret(const char* secret) override { return 0; }
+	virtual int setEncryptionMode(const char* encryptionMode) override { return 0; }
+	virtual int registerPacketObserver(IPacketObserver* observer) override { return 0; }
+	virtual int createDataStream(int* streamId, bool reliable, bool ordered) override { return 0; }
+	virtual int sendStreamMessage(int streamId, const char* data, size_t length) override { return 0; }
+	virtual int addPublishStreamUrl(const char *url, bool transcodingEnabled) override { return 0; }
+	virtual int removePublishStreamUrl(const char *url) override { return 0; }
+	virtual int setLiveTranscoding(const LiveTranscoding &transcoding) override { return 0; }
+	virtual int addVideoWatermark(const RtcImage& watermark) override { return 0; }
+	virtual int clearVideoWatermarks() override { return 0; }
+	virtual int setBeautyEffectOptions(bool enabled, BeautyOptions options) override { return 0; }
+	virtual int addInjectStreamUrl(const char* url, const InjectStreamConfig& config) override { return 0; }
+	virtual int startChannelMediaRelay(const ChannelMediaRelayConfiguration &configuration) override { return 0; }
+	virtual int updateChannelMediaRelay(const ChannelMediaRelayConfiguration &configuration) override { return 0; }
+	virtual int stopChannelMediaRelay() override { return 0; }
+	virtual int removeInjectStreamUrl(const char* url) override { return 0; }
+	virtual bool registerEventHandler(IRtcEngineEventHandler *eventHandler) override { return false; }
+	virtual bool unregisterEventHandler(IRtcEngineEventHandler *eventHandler) override { return false; }
+	virtual int sendCustomReportMessage(const char *id, const char* category, const char* event, const char* label, int value) override { return 0; }
+	virtual CONNECTION_STATE_TYPE getConnectionState() override { return {}; }
+	virtual int registerMediaMetadataObserver(IMetadataObserver *observer, IMetadataObserver::METADATA_TYPE type) override { return 0; }
+};
+
+/**
+	parameter interface handed out by queryInterface, only understands the
+	"mock." keys of setParameters
+*/
+class CMockRtcEngineParameter final : public IRtcEngineParameter
+{
+public:
+	CMockRtcEngineParameter(CMockRtcEngine* lpEngine) : m_lpEngine(lpEngine) {}
+
+	virtual void release() override { delete this; }
+	virtual int setParameters(const char* parameters) override;
+
+	virtual int setBool(const char* key, bool value) override { return 0; }
+	virtual int setInt(const char* key, int value) override { return 0; }
+	virtual int setUInt(const char* key, unsigned int value) override { return 0; }
+	virtual int setNumber(const char* key, double value) override { return 0; }
+	virtual int setString(const char* key, const char* value) override { return 0; }
+	virtual int setObject(const char* key, const char* value) override { return 0; }
+	virtual int getBool(const char* key, bool& value) override { return 0; }
+	virtual int getInt(const char* key, int& value) override { return 0; }
+	virtual int getUInt(const char* key, unsigned int& value) override { return 0; }
+	virtual int getNumber(const char* key, double& value) override { return 0; }
+	virtual int getString(const char* key, agora::util::AString& value) override { return 0; }
+	virtual int getObject(const char* key, agora::util::AString& value) override { return 0; }
+	virtual int getArray(const char* key, agora::util::AString& value) override { return 0; }
+	virtual int setProfile(const char* profile, bool merge) override { return 0; }
+	virtual int convertPath(const char* filePath, agora::util::AString& value) override { return 0; }
+
+private:
+	CMockRtcEngine* m_lpEngine;
+};
@@ -0,0 +1,558 @@
+/**
+	agora_native: CPython module over the agorawrapper exports, a drop in for
+	the ctypes handle of agora.py, config_abi.py and event_abi.py:
+		import agora_native as agora
+		agora.createEngine(app_id)
+		agora.pushVideoFrame(i420, w, h)
+	frames and pcm are taken through the buffer protocol (numpy arrays, bytes,
+	bytearray, memoryview, ctypes arrays) without a copy on the python side,
+	a 2-d frame may have padded rows. the GIL is released while the wrapper
+	copies a frame or waits for the engine thread, so capture threads and
+	the python loop run in parallel.
+	every function takes positional arguments only, the string arguments are
+	str or bytes
+*/
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include "AgoraConfig.h"
+#include "AgoraEvent.h"
+
+#if PY_VERSION_HEX < 0x03070000
+#error agora_native needs python 3.7 for METH_FASTCALL
+#endif
+
+extern "C"
+{
+	void createEngine(void* lpExtInfo);
+	void destroyEngine();
+	int getConfigAbiVersion();
+	int getConfigItemSize();
+	int applyConfig(int nAbiVersion, AGORA_CONFIG_ITEM* lpItems, int nCount);
+	int64_t postConfig(int nAbiVersion, const AGORA_CONFIG_ITEM* lpItems, int nCount);
+	int64_t postLeaveChannel();
+	int pollCommand(int64_t nTicket);
+	int waitCommand(int64_t nTicket, int nTimeoutMs);
+	int getEventAbiVersion();
+	int getEventSize();
+	int pollEvents(AGORA_EVENT* lpEvents, int nMax);
+	int startStatsRecording(const char* lpPath);
+	int64_t stopStatsRecording();
+	int joinChannel(void* lpExtInfo);
+	int waitJoinChannel(int timeoutMs);
+	int leaveChannel();
+	int enableVideo(void* lpExtInfo);
+	int enableAudio(void* lpExtInfo);
+	void setParameters(void* lpExtInfo);
+	int setVideoProfile(void* lpExtInfo);
+	int setChannelProfile(void* lpExtInfo);
+	int setClientRole(void* lpExtInfo);
+	void enableVideoCustomCap();
+	int pushVideoFrameStrided(const char* buff, int w, int h, int nStride);
+	void enableAudioCustomCap(int nSampleRate, int nChannels);
+	void pushAudioFrame(char* buff, int size);
+	void muteAllRemoteVideoStreams();
+	void muteAllRemoteAudioStreams();
+	int setAudioProfile(int profile, int scenario);
+	void stopPreview();
+	void logOff();
+	void setLogLevel(int nLevel);
+}
+
+static bool CheckArgs(const char* lpName, Py_ssize_t nArgs, Py_ssize_t nMin, Py_ssize_t nMax)
+{
+	if (nArgs >= nMin && nArgs <= nMax)
+		return true;
+
+	if (nMin == nMax)
+		PyErr_Format(PyExc_TypeError, "%s() takes %zd arguments (%zd given)", lpName, nMin, nArgs);
+	else
+		PyErr_Format(PyExc_TypeError, "%s() takes %zd to %zd arguments (%zd given)", lpName, nMin, nMax, nArgs);
+	return false;
+}
+
+static bool GetInt(PyObject* lpArg, int& nValue)
+{
+	long nLong = PyLong_AsLong(lpArg);
+	if (nLong == -1 && PyErr_Occurred())
+		return false;
+	if (nLong < INT32_MIN || nLong > INT32_MAX)
+	{
+		PyErr_SetString(PyExc_OverflowError, "argument does not fit an int");
+		return false;
+	}
+	nValue = (int)nLong;
+	return true;
+}
+
+static bool GetInt64(PyObject* lpArg, int64_t& nValue)
+{
+	long long nLong = PyLong_AsLongLong(lpArg);
+	if (nLong == -1 && PyErr_Occurred())
+		return false;
+	nValue = nLong;
+	return true;
+}
+
+// utf-8 of a str, or the bytes of a bytes object. the pointer lives as long as lpArg
+static const char* GetString(PyObject* lpArg)
+{
+	if (PyUnicode_Check(lpArg))
+		return PyUnicode_AsUTF8(lpArg);
+	if (PyBytes_Check(lpArg))
+		return PyBytes_AS_STRING(lpArg);
+
+	PyErr_SetString(PyExc_TypeError, "expected str or bytes");
+	return NULL;
+}
+
+/**
+	the wrapper exports taking one json string and returning an int
+*/
+typedef int (*JSON_EXPORT)(void* lpExtInfo);
+
+static PyObject* CallJson(const char* lpName, JSON_EXPORT lpExport, PyObject* const* lpArgs, Py_ssize_t nArgs)
+{
+	if (!CheckArgs(lpName, nArgs, 1, 1))
+		return NULL;
+	const char* lpJson = GetString(lpArgs[0]);
+	if (lpJson == NULL)
+		return NULL;
+
+	// the calls go through the command queue and wait for the engine thread
+	int nResult;
+	Py_BEGIN_ALLOW_THREADS
+	nResult = lpExport((void*)lpJson);
+	Py_END_ALLOW_THREADS
+	return PyLong_FromLong(nResult);
+}
+
+#define JSON_METHOD(name) \
+	static PyObject* Py_##name(PyObject*, PyObject* const* lpArgs, Py_ssize_t nArgs) \
+	{ \
+		return CallJson(#name, name, lpArgs, nArgs); \
+	}
+
+JSON_METHOD(joinChannel)
+JSON_METHOD(enableVideo)
+JSON_METHOD(enableAudio)
+JSON_METHOD(setVideoProfile)
+JSON_METHOD(setChannelProfile)
+JSON_METHOD(setClientRole)
+
+/**
+	the exports without arguments, the GIL is released because most of them
+	end up waiting for the engine thread
+*/
+#define VOID_METHOD(name) \
+	static PyObject* Py_##name(PyObject*, PyObject* const*, Py_ssize_t nArgs) \
+	{ \
+		if (!CheckArgs(#name, nArgs, 0, 0)) \
+			return NULL; \
+		Py_BEGIN_ALLOW_THREADS \
+		name(); \
+		Py_END_ALLOW_THREADS \
+		Py_RETURN_NONE; \
+	}
+
+VOID_METHOD(destroyEngine)
+VOID_METHOD(enableVideoCustomCap)
+VOID_METHOD(muteAllRemoteVideoStreams)
+VOID_METHOD(muteAllRemoteAudioStreams)
+VOID_METHOD(stopPreview)
+VOID_METHOD(logOff)
+
+#define INT_METHOD(name) \
+	static PyObject* Py_##name(PyObject*, PyObject* const*, Py_ssize_t nArgs) \
+	{ \
+		if (!CheckArgs(#name, nArgs, 0, 0)) \
+			return NULL; \
+		return PyLong_FromLong(name()); \
+	}
+
+INT_METHOD(getConfigAbiVersion)
+INT_METHOD(getConfigItemSize)
+INT_METHOD(getEventAbiVersion)
+INT_METHOD(getEventSize)
+
+static PyObject* Py_createEngine(PyObject*, PyObject* const* lpArgs, Py_ssize_t nArgs)
+{
+	if (!CheckArgs("createEngine", nArgs, 1, 1))
+		return NULL;
+	const char* lpAppId = GetString(lpArgs[0]);
+	if (lpAppId == NULL)
+		return NULL;
+
+	Py_BEGIN_ALLOW_THREADS
+	createEngine((void*)lpAppId);
+	Py_END_ALLOW_THREADS
+	Py_RETURN_NONE;
+}
+
+static PyObject* Py_setParameters(PyObject*, PyObject* const* lpArgs, Py_ssize_t nArgs)
+{
+	if (!CheckArgs("setParameters", nArgs, 1, 1))
+		return NULL;
+	const char* lpJson = GetString(lpArgs[0]);
+	if (lpJson == NULL)
+		return NULL;
+
+	Py_BEGIN_ALLOW_THREADS
+	setParameters((void*)lpJson);
+	Py_END_ALLOW_THREADS
+	Py_RETURN_NONE;
+}
+
+/**
+	the config items of applyConfig/postConfig, any buffer holding whole
+	AGORA_CONFIG_ITEMs, usually a config_abi.agora_items array.
+	nCount may be left out, it defaults to every item of the buffer
+*/
+static bool GetConfigItems(PyObject* const* lpArgs, Py_ssize_t nArgs, int nFlags, int& nAbiVersion, Py_buffer& view, int& nCount)
+{
+	if (!GetInt(lpArgs[0], nAbiVersion))
+		return false;
+	if (PyObject_GetBuffer(lpArgs[1], &view, nFlags | PyBUF_C_CONTIGUOUS) != 0)
+		return false;
+
+	Py_ssize_t nItems = view.len / (Py_ssize_t)sizeof(AGORA_CONFIG_ITEM);
+	nCount = (int)nItems;
+	if (nArgs == 3 && !GetInt(lpArgs[2], nCount))
+	{
+		PyBuffer_Release(&view);
+		return false;
+	}
+	if (nCount < 0 || nCount > nItems)
+	{
+		PyBuffer_Release(&view);
+		PyErr_Format(PyExc_ValueError, "%d config items do not fit a buffer of %zd bytes", nCount, view.len);
+		return false;
+	}
+	return true;
+}
+
+static PyObject* Py_applyConfig(PyObject*, PyObject* const* lpArgs, Py_ssize_t nArgs)
+{
+	if (!CheckArgs("applyConfig", nArgs, 2, 3))
+		return NULL;
+
+	int nAbiVersion, nCount;
+	Py_buffer view;
+	// the wrapper writes nResult and nSdkError back into the items
+	if (!GetConfigItems(lpArgs, nArgs, PyBUF_WRITABLE, nAbiVersion, view, nCount))
+		return NULL;
+
+	int nResult;
+	Py_BEGIN_ALLOW_THREADS
+	nResult = applyConfig(nAbiVersion, (AGORA_CONFIG_ITEM*)view.buf, nCount);
+	Py_END_ALLOW_THREADS
+	PyBuffer_Release(&view);
+	return PyLong_FromLong(nResult);
+}
+
+static PyObject* Py_postConfig(PyObject*, PyObject* const* lpArgs, Py_ssize_t nArgs)
+{
+	if (!CheckArgs("postConfig", nArgs, 2, 3))
+		return NULL;
+
+	int nAbiVersion, nCount;
+	Py_buffer view;
+	if (!GetConfigItems(lpArgs, nArgs, PyBUF_SIMPLE, nAbiVersion, view, nCount))
+		return NULL;
+
+	// copied into the command queue, the buffer is free again on return
+	int64_t nTicket = postConfig(nAbiVersion, (const AGORA_CONFIG_ITEM*)view.buf, nCount);
+	PyBuffer_Release(&view);
+	return PyLong_FromLongLong(nTicket);
+}
+
+static PyObject* Py_postLeaveChannel(PyObject*, PyObject* const*, Py_ssize_t nArgs)
+{
+	if (!CheckArgs("postLeaveChannel", nArgs, 0, 0))
+		return NULL;
+	return PyLong_FromLongLong(postLeaveChannel());
+}
+
+static PyObject* Py_pollCommand(PyObject*, PyObject* const* lpArgs, Py_ssize_t nArgs)
+{
+	int64_t nTicket;
+	if (!CheckArgs("pollCommand", nArgs, 1, 1) || !GetInt64(lpArgs[0], nTicket))
+		return NULL;
+	return PyLong_FromLong(pollCommand(nTicket));
+}
+
+static PyObject* Py_waitCommand(PyObject*, PyObject* const* lpArgs, Py_ssize_t nArgs)
+{
+	int64_t nTicket;
+	int nTimeoutMs = -1;
+	if (!CheckArgs("waitCommand", nArgs, 1, 2) || !GetInt64(lpArgs[0], nTicket) || (nArgs == 2 && !GetInt(lpArgs[1], nTimeoutMs)))
+		return NULL;
+
+	int nResult;
+	Py_BEGIN_ALLOW_THREADS
+	nResult = waitCommand(nTicket, nTimeoutMs);
+	Py_END_ALLOW_THREADS
+	return PyLong_FromLong(nResult);
+}
+
+static PyObject* Py_leaveChannel(PyObject*, PyObject* const*, Py_ssize_t nArgs)
+{
+	if (!CheckArgs("leaveChannel", nArgs, 0, 0))
+		return NULL;
+
+	int nResult;
+	Py_BEGIN_ALLOW_THREADS
+	nResult = leaveChannel();
+	Py_END_ALLOW_THREADS
+	return PyLong_FromLong(nResult);
+}
+
+static PyObject* Py_waitJoinChannel(PyObject*, PyObject* const* lpArgs, Py_ssize_t nArgs)
+{
+	int nTimeoutMs;
+	if (!CheckArgs("waitJoinChannel", nArgs, 1, 1) || !GetInt(lpArgs[0], nTimeoutMs))
+		return NULL;
+
+	int nResult;
+	Py_BEGIN_ALLOW_THREADS
+	nResult = waitJoinChannel(nTimeoutMs);
+	Py_END_ALLOW_THREADS
+	return PyLong_FromLong(nResult);
+}
+
+/**
+	pollEvents(buffer[, nMax]): fills a writable buffer of AGORA_EVENTs, e.g.
+	the array of event_abi.EventReader, returns the number of events
+*/
+static PyObject* Py_pollEvents(PyObject*, PyObject* const* lpArgs, Py_ssize_t nArgs)
+{
+	if (!CheckArgs("pollEvents", nArgs, 1, 2))
+		return NULL;
+
+	Py_buffer view;
+	if (PyObject_GetBuffer(lpArgs[0], &view, PyBUF_WRITABLE | PyBUF_C_CONTIGUOUS) != 0)
+		return NULL;
+
+	Py_ssize_t nEvents = view.len / (Py_ssize_t)sizeof(AGORA_EVENT);
+	int nMax = (int)nEvents;
+	if (nArgs == 2 && !GetInt(lpArgs[1], nMax))
+	{
+		PyBuffer_Release(&view);
+		return NULL;
+	}
+	if (nMax > nEvents)
+	{
+		PyBuffer_Release(&view);
+		PyErr_Format(PyExc_ValueError, "%d events do not fit a buffer of %zd bytes", nMax, view.len);
+		return NULL;
+	}
+
+	int nCount = pollEvents((AGORA_EVENT*)view.buf, nMax);
+	PyBuffer_Release(&view);
+	return PyLong_FromLong(nCount);
+}
+
+static PyObject* Py_startStatsRecording(PyObject*, PyObject* const* lpArgs, Py_ssize_t nArgs)
+{
+	if (!CheckArgs("startStatsRecording", nArgs, 1, 1))
+		return NULL;
+	const char* lpPath = GetString(lpArgs[0]);
+	if (lpPath == NULL)
+		return NULL;
+	return PyLong_FromLong(startStatsRecording(lpPath));
+}
+
+static PyObject* Py_stopStatsRecording(PyObject*, PyObject* const*, Py_ssize_t nArgs)
+{
+	if (!CheckArgs("stopStatsRecording", nArgs, 0, 0))
+		return NULL;
+
+	// joins the writer thread after its last flush
+	int64_t nWritten;
+	Py_BEGIN_ALLOW_THREADS
+	nWritten = stopStatsRecording();
+	Py_END_ALLOW_THREADS
+	return PyLong_FromLongLong(nWritten);
+}
+
+/**
+	pushVideoFrame(frame, w, h): an I420 frame of w*h*3/2 bytes. a 2-d buffer
+	has to be (h*3/2, w) bytes, e.g. the output of
+	cv2.cvtColor(COLOR_BGR2YUV_I420) or a slice of it, and may have rows
+	further apart than w. any other contiguous buffer is copied as is.
+	raises ValueError for anything else
+*/
+static PyObject* Py_pushVideoFrame(PyObject*, PyObject* const* lpArgs, Py_ssize_t nArgs)
+{
+	int w, h;
+	if (!CheckArgs("pushVideoFrame", nArgs, 3, 3) || !GetInt(lpArgs[1], w) || !GetInt(lpArgs[2], h))
+		return NULL;
+	if (w <= 0 || h <= 0 || (w & 1) || (h & 1))
+	{
+		PyErr_Format(PyExc_ValueError, "bad frame size %dx%d, I420 needs positive even dimensions", w, h);
+		return NULL;
+	}
+
+	Py_buffer view;
+	if (PyObject_GetBuffer(lpArgs[0], &view, PyBUF_STRIDES) != 0)
+		return NULL;
+
+	Py_ssize_t nFrameBytes = (Py_ssize_t)w * h * 3 / 2;
+	Py_ssize_t nStride = 0;
+	if (view.ndim == 2)
+	{
+		// the rows of a wider image pushed as a narrower frame would be read with the wrong stride
+		if (view.itemsize == 1 && view.strides[1] == 1 && view.shape[0] == h * 3 / 2 && view.shape[1] == w && view.strides[0] >= w)
+			nStride = view.strides[0];
+	}
+	else if (PyBuffer_IsContiguous(&view, 'C') && view.len >= nFrameBytes)
+	{
+		nStride = w;
+	}
+
+	if (nStride == 0 || nStride > INT32_MAX)
+	{
+		PyBuffer_Release(&view);
+		PyErr_Format(PyExc_ValueError, "frame is not a %dx%d I420 image: %zd bytes, %d dimensions", w, h, view.len, view.ndim);
+		return NULL;
+	}
+
+	// the strided push checks the size against the capture buffer, a contiguous frame is one row apart
+	int nResult = AGORA_CONFIG_OK;
+	Py_BEGIN_ALLOW_THREADS
+	nResult = pushVideoFrameStrided((const char*)view.buf, w, h, (int)nStride);
+	Py_END_ALLOW_THREADS
+	PyBuffer_Release(&view);
+
+	if (nResult != AGORA_CONFIG_OK)
+	{
+		PyErr_Format(PyExc_ValueError, "%dx%d frame does not fit the capture buffer", w, h);
+		return NULL;
+	}
+	Py_RETURN_NONE;
+}
+
+static PyObject* Py_enableAudioCustomCap(PyObject*, PyObject* const* lpArgs, Py_ssize_t nArgs)
+{
+	int nSampleRate, nChannels;
+	if (!CheckArgs("enableAudioCustomCap", nArgs, 2, 2) || !GetInt(lpArgs[0], nSampleRate) || !GetInt(lpArgs[1], nChannels))
+		return NULL;
+
+	Py_BEGIN_ALLOW_THREADS
+	enableAudioCustomCap(nSampleRate, nChannels);
+	Py_END_ALLOW_THREADS
+	Py_RETURN_NONE;
+}
+
+/**
+	pushAudioFrame(pcm[, size]): the interleaved 16 bit pcm of a contiguous
+	buffer, bytes or an int16 numpy array. size in bytes defaults to all of it.
+	the wrapper may wait for room in the audio ring, the GIL is free meanwhile
+*/
+static PyObject* Py_pushAudioFrame(PyObject*, PyObject* const* lpArgs, Py_ssize_t nArgs)
+{
+	if (!CheckArgs("pushAudioFrame", nArgs, 1, 2))
+		return NULL;
+
+	Py_buffer view;
+	if (PyObject_GetBuffer(lpArgs[0], &view, PyBUF_C_CONTIGUOUS) != 0)
+		return NULL;
+
+	int nSize = view.len > INT32_MAX ? INT32_MAX : (int)view.len;
+	if (nArgs == 2 && !GetInt(lpArgs[1], nSize))
+	{
+		PyBuffer_Release(&view);
+		return NULL;
+	}
+	if (nSize < 0 || nSize > view.len)
+	{
+		PyBuffer_Release(&view);
+		PyErr_Format(PyExc_ValueError, "size %d is larger than the buffer of %zd bytes", nSize, view.len);
+		return NULL;
+	}
+
+	Py_BEGIN_ALLOW_THREADS
+	pushAudioFrame((char*)view.buf, nSize);
+	Py_END_ALLOW_THREADS
+	PyBuffer_Release(&view);
+	Py_RETURN_NONE;
+}
+
+static PyObject* Py_setAudioProfile(PyObject*, PyObject* const* lpArgs, Py_ssize_t nArgs)
+{
+	int nProfile, nScenario;
+	if (!CheckArgs("setAudioProfile", nArgs, 2, 2) || !GetInt(lpArgs[0], nProfile) || !GetInt(lpArgs[1], nScenario))
+		return NULL;
+
+	int nResult;
+	Py_BEGIN_ALLOW_THREADS
+	nResult = setAudioProfile(nProfile, nScenario);
+	Py_END_ALLOW_THREADS
+	return PyLong_FromLong(nResult);
+}
+
+static PyObject* Py_setLogLevel(PyObject*, PyObject* const* lpArgs, Py_ssize_t nArgs)
+{
+	int nLevel;
+	if (!CheckArgs("setLogLevel", nArgs, 1, 1) || !GetInt(lpArgs[0], nLevel))
+		return NULL;
+	setLogLevel(nLevel);
+	Py_RETURN_NONE;
+}
+
+#define METHOD(name, doc)	{ #name, (PyCFunction)(void(*)(void))Py_##name, METH_FASTCALL, doc }
+
+static PyMethodDef g_methods[] =
+{
+	METHOD(createEngine, "createEngine(app_id)"),
+	METHOD(destroyEngine, "destroyEngine()"),
+	METHOD(getConfigAbiVersion, "getConfigAbiVersion() -> int"),
+	METHOD(getConfigItemSize, "getConfigItemSize() -> int"),
+	METHOD(applyConfig, "applyConfig(abi_version, items[, count]) -> result, blocks until the engine thread ran the items"),
+	METHOD(postConfig, "postConfig(abi_version, items[, count]) -> ticket"),
+	METHOD(postLeaveChannel, "postLeaveChannel() -> ticket"),
+	METHOD(pollCommand, "pollCommand(ticket) -> result"),
+	METHOD(waitCommand, "waitCommand(ticket[, timeout_ms]) -> result"),
+	METHOD(getEventAbiVersion, "getEventAbiVersion() -> int"),
+	METHOD(getEventSize, "getEventSize() -> int"),
+	METHOD(pollEvents, "pollEvents(events[, max]) -> count"),
+	METHOD(startStatsRecording, "startStatsRecording(path) -> 0 or -1"),
+	METHOD(stopStatsRecording, "stopStatsRecording() -> samples written"),
+	METHOD(joinChannel, "joinChannel(json) -> result"),
+	METHOD(waitJoinChannel, "waitJoinChannel(timeout_ms) -> elapsed ms or -1"),
+	METHOD(leaveChannel, "leaveChannel() -> result"),
+	METHOD(enableVideo, "enableVideo(json) -> result"),
+	METHOD(enableAudio, "enableAudio(json) -> result"),
+	METHOD(setParameters, "setParameters(json)"),
+	METHOD(setVideoProfile, "setVideoProfile(json) -> result"),
+	METHOD(setChannelProfile, "setChannelProfile(json) -> result"),
+	METHOD(setClientRole, "setClientRole(json) -> result"),
+	METHOD(enableVideoCustomCap, "enableVideoCustomCap()"),
+	METHOD(pushVideoFrame, "pushVideoFrame(i420, w, h)"),
+	METHOD(enableAudioCustomCap, "enableAudioCustomCap(sample_rate, channels)"),
+	METHOD(pushAudioFrame, "pushAudioFrame(pcm[, size])"),
+	METHOD(muteAllRemoteVideoStreams, "muteAllRemoteVideoStreams()"),
+	METHOD(muteAllRemoteAudioStreams, "muteAllRemoteAudioStreams()"),
+	METHOD(setAudioProfile, "setAudioProfile(profile, scenario) -> result"),
+	METHOD(stopPreview, "stopPreview()"),
+	METHOD(logOff, "logOff()"),
+	METHOD(setLogLevel, "setLogLevel(level)"),
+	{ NULL, NULL, 0, NULL },
+};
+
+static struct PyModuleDef g_module =
+{
+	PyModuleDef_HEAD_INIT,
+	"agora_native",
+	"agorawrapper exports with buffer protocol frame and pcm push",
+	-1,
+	g_methods,
+	NULL,
+	NULL,
+	NULL,
+	NULL,
+};
+
+PyMODINIT_FUNC PyInit_agora_native()
+{
+	return PyModule_Create(&g_module);
+}
@@ -1,7 +1,9 @@
 #include "AGEngineEventHandler.h"
-#include "AGEventDef.h"
+#include "AgoraEvent.h"
 #include "AGExtInfoManager.h"
 #include "AgoraObject.h"
+#include "ChurnBench.h"
+#include "AgoraStatsSchema.h"
 #include <iostream>
 
 CAGEngineEventHandler::CAGEngineEventHandler(void)
@@ -12,9 +14,54 @@ CAGEngineEventHandler::~CAGEngineEventHandler(void)
 {
 }
 
-void CAGEngineEventHandler::SetMsgReceiver(HWND hWnd)
+/**
+	forget the last join result, called before every joinChannel
+*/
+void CAGEngineEventHandler::ResetJoinState()
+{
+	std::lock_guard<std::mutex> locker(m_joinMutex);
+	m_bJoined = false;
+	m_bLeft = false;
+	m_nJoinElapsed = -1;
+}
+
+void CAGEngineEventHandler::ResetSubscriptions(IRtcEngine* lpEngine)
 {
-	m_hMainWnd = (HWND)hWnd;
+	m_subscriber.Reset(lpEngine);
+}
+
+/**
+	block until onJoinChannelSuccess arrives
+Parameters:
+	@param nTimeoutMs	maximum time to wait, <0 waits forever
+	@return elapsed (ms) reported by the SDK, or -1 on timeout
+*/
+int CAGEngineEventHandler::WaitJoinChannel(int nTimeoutMs)
+{
+	std::unique_lock<std::mutex> locker(m_joinMutex);
+	if (nTimeoutMs < 0)
+		m_joinCond.wait(locker, [this] {return m_bJoined; });
+	else if (!m_joinCond.wait_for(locker, std::chrono::milliseconds(nTimeoutMs), [this] {return m_bJoined; }))
+		return -1;
+
+	return m_nJoinElapsed;
+}
+
+/**
+	block until onLeaveChannel arrives
+Parameters:
+	@param nTimeoutMs	maximum time to wait, <0 waits forever
+	@return false on timeout
+*/
+bool CAGEngineEventHandler::WaitLeaveChannel(int nTimeoutMs)
+{
+	std::unique_lock<std::mutex> locker(m_joinMutex);
+	if (nTimeoutMs < 0)
+		m_joinCond.wait(locker, [this] {return m_bLeft; });
+	else if (!m_joinCond.wait_for(locker, std::chrono::milliseconds(nTimeoutMs), [this] {return m_bLeft; }))
+		return false;
+
+	return true;
 }
 
 /**
@@ -33,18 +80,19 @@ void CAGEngineEventHandler::SetMsgReceiver(HWND hWnd)
 */
 void CAGEngineEventHandler::onJoinChannelSuccess(const char* channel, uid_t uid, int elapsed)
 {
-	if (m_hMainWnd == NULL)
-		return;
-
-	LPAGE_JOINCHANNEL_SUCCESS lpData = new AGE_JOINCHANNEL_SUCCESS;
-
-	int nChannelLen = strlen(channel) + 1;
-	lpData->channel = new char[nChannelLen];
-	lpData->uid = uid;
-	lpData->elapsed = elapsed;
+	{
+		std::lock_guard<std::mutex> locker(m_joinMutex);
+		m_bJoined = true;
+		m_nJoinElapsed = elapsed;
+	}
+	m_joinCond.notify_all();
+	CChurnBench::GetInstance()->Record(CHURN_JOIN_ELAPSED, elapsed);
 
-	strcpy_s(lpData->channel, nChannelLen, channel);
-	::PostMessage(m_hMainWnd, WM_MSGID(EID_JOINCHANNEL_SUCCESS), (WPARAM)lpData, 0);
+	AGORA_EVENT event;
+	CAgoraEventRing::Init(event, AGORA_EVENT_JOIN_CHANNEL_SUCCESS, uid);
+	event.nArgs[0] = elapsed;
+	CAgoraEventRing::SetText(event, channel);
+	CAgoraEventRing::GetInstance()->Push(event);
 }
 
 /**
@@ -60,19 +108,11 @@ Parameters
 */
 void CAGEngineEventHandler::onRejoinChannelSuccess(const char* channel, uid_t uid, int elapsed)
 {
-	if (m_hMainWnd == NULL)
-		return;
-
-	LPAGE_REJOINCHANNEL_SUCCESS lpData = new AGE_REJOINCHANNEL_SUCCESS;
-
-	int nChannelLen = strlen(channel) + 1;
-	lpData->channel = new char[nChannelLen];
-	lpData->uid = uid;
-	lpData->elapsed = elapsed;
-
-	strcpy_s(lpData->channel, nChannelLen, channel);
-
-	::PostMessage(m_hMainWnd, WM_MSGID(EID_REJOINCHANNEL_SUCCESS), (WPARAM)lpData, 0);
+	AGORA_EVENT event;
+	CAgoraEventRing::Init(event, AGORA_EVENT_REJOIN_CHANNEL_SUCCESS, uid);
+	event.nArgs[0] = elapsed;
+	CAgoraEventRing::SetText(event, channel);
+	CAgoraEventRing::GetInstance()->Push(event);
 }
 
 /**
@@ -90,7 +130,11 @@ Parameters
 */
 void CAGEngineEventHandler::onWarning(int warn, const char* msg)
 {
-
+	AGORA_EVENT event;
+	CAgoraEventRing::Init(event, AGORA_EVENT_WARNING, 0);
+	event.nArgs[0] = warn;
+	CAgoraEventRing::SetText(event, msg);
+	CAgoraEventRing::GetInstance()->Push(event);
 }
 
 /**
@@ -107,25 +151,12 @@ Parameters
 */
 void CAGEngineEventHandler::onError(int err, const char* msg)
 {
-	if (m_hMainWnd == NULL)
-		return;
-
-	LPAGE_ERROR lpData = new AGE_ERROR;
-
-	int nMsgLen = 0;
-
+	AGORA_EVENT event;
+	CAgoraEventRing::Init(event, AGORA_EVENT_ERROR, 0);
+	event.nArgs[0] = err;
 	// attention: the pointer of msg maybe NULL!!!
-	if (msg != NULL) {
-		nMsgLen = strlen(msg) + 1;
-		lpData->msg = new char[nMsgLen];
-		strcpy_s(lpData->msg, nMsgLen, msg);
-	}
-	else
-		lpData->msg = NULL;
-
-	lpData->err = err;
-
-	::PostMessage(m_hMainWnd, WM_MSGID(EID_ERROR), (WPARAM)lpData, 0);
+	CAgoraEventRing::SetText(event, msg);
+	CAgoraEventRing::GetInstance()->Push(event);
 }
 
 /**
@@ -147,17 +178,12 @@ Parameters
 */
 void CAGEngineEventHandler::onAudioQuality(uid_t uid, int quality, unsigned short delay, unsigned short lost)
 {
-	if (m_hMainWnd == NULL)
-		return;
-
-	LPAGE_AUDIO_QUALITY lpData = new AGE_AUDIO_QUALITY;
-
-	lpData->uid = uid;
-	lpData->quality = quality;
-	lpData->delay = delay;
-	lpData->lost = lost;
-
-	::PostMessage(m_hMainWnd, WM_MSGID(EID_AUDIO_QUALITY), (WPARAM)lpData, 0);
+	AGORA_EVENT event;
+	CAgoraEventRing::Init(event, AGORA_EVENT_AUDIO_QUALITY, uid);
+	event.nArgs[0] = quality;
+	event.nArgs[1] = delay;
+	event.nArgs[2] = lost;
+	CAgoraEventRing::GetInstance()->Push(event);
 }
 
 
@@ -182,17 +208,18 @@ Parameters
 */
 void CAGEngineEventHandler::onAudioVolumeIndication(const AudioVolumeInfo* speakers, unsigned int speakerNumber, int totalVolume)
 {
-	if (m_hMainWnd == NULL)
-		return;
-
-	LPAGE_AUDIO_VOLUME_INDICATION lpData = new AGE_AUDIO_VOLUME_INDICATION;
-
-	lpData->speakers = new AudioVolumeInfo[speakerNumber];
-	memcpy(lpData->speakers, speakers, speakerNumber * sizeof(AudioVolumeInfo));
-	lpData->speakerNumber = speakerNumber;
-	lpData->totalVolume = totalVolume;
+	CAgoraEventRing *lpEventRing = CAgoraEventRing::GetInstance();
+	for (unsigned int i = 0; i < speakerNumber; i++)
+	{
+		AGORA_EVENT event;
+		CAgoraEventRing::Init(event, AGORA_EVENT_AUDIO_VOLUME_INDICATION, speakers[i].uid);
+		event.nArgs[0] = (int32_t)speakers[i].volume;
+		event.nArgs[1] = (int32_t)speakers[i].vad;
+		event.nArgs[2] = totalVolume;
+		lpEventRing->Push(event);
+	}
 
-	::PostMessage(m_hMainWnd, WM_MSGID(EID_AUDIO_VOLUME_INDICATION), (WPARAM)lpData, 0);
+	m_subscriber.OnAudioVolumeIndication(speakers, speakerNumber);
 }
 
 /**
@@ -208,14 +235,21 @@ Parameters
 void CAGEngineEventHandler::onLeaveChannel(const RtcStats& stat)
 {
 	clearViews();
-	if (m_hMainWnd == NULL)
-		return;
-
-	LPAGE_LEAVE_CHANNEL lpData = new AGE_LEAVE_CHANNEL;
-
-	memcpy(&lpData->rtcStat, &stat, sizeof(RtcStats));
+	{
+		std::lock_guard<std::mutex> locker(m_joinMutex);
+		m_bJoined = false;
+		m_bLeft = true;
+		m_nJoinElapsed = -1;
+	}
+	m_joinCond.notify_all();
 
-	::PostMessage(m_hMainWnd, WM_MSGID(EID_LEAVE_CHANNEL), (WPARAM)lpData, 0);
+	AGORA_EVENT event;
+	CAgoraEventRing::Init(event, AGORA_EVENT_LEAVE_CHANNEL, 0);
+	event.nArgs[0] = (int32_t)stat.duration;
+	event.nArgs[1] = stat.txKBitRate;
+	event.nArgs[2] = stat.rxKBitRate;
+	event.nArgs[3] = (int32_t)stat.userCount;
+	CAgoraEventRing::GetInstance()->Push(event);
 }
 
 /**
@@ -228,7 +262,23 @@ Parameters
 */
 void CAGEngineEventHandler::onRtcStats(const RtcStats& stat)
 {
+	if (!CStatsRecorder::IsRecording())
+		return;
 
+	STATS_SAMPLE sample;
+	CStatsRecorder::Init(sample, STATS_RTC, 0);
+	sample.nValues[0] = stat.txKBitRate;
+	sample.nValues[1] = stat.rxKBitRate;
+	sample.nValues[2] = stat.txVideoKBitRate;
+	sample.nValues[3] = stat.rxVideoKBitRate;
+	sample.nValues[4] = stat.lastmileDelay;
+	sample.nValues[5] = stat.gatewayRtt;
+	sample.nValues[6] = stat.txPacketLossRate;
+	sample.nValues[7] = stat.rxPacketLossRate;
+	sample.nValues[8] = stat.userCount;
+	sample.nValues[9] = CStatsRecorder::Scale(stat.cpuAppUsage);
+	sample.nValues[10] = stat.memoryAppUsageInKbytes;
+	CStatsRecorder::GetInstance()->Record(sample);
 }
 
 
@@ -237,14 +287,10 @@ void CAGEngineEventHandler::onRtcStats(const RtcStats& stat)
 */
 void CAGEngineEventHandler::onMediaEngineEvent(int evt)
 {
-	if (m_hMainWnd == NULL)
-		return;
-
-	LPAGE_MEDIA_ENGINE_EVENT lpData = new AGE_MEDIA_ENGINE_EVENT;
-
-	lpData->evt = evt;
-
-	::PostMessage(m_hMainWnd, WM_MSGID(EID_MEDIA_ENGINE_EVENT), (WPARAM)lpData, 0);
+	AGORA_EVENT event;
+	CAgoraEventRing::Init(event, AGORA_EVENT_MEDIA_ENGINE_EVENT, 0);
+	event.nArgs[0] = evt;
+	CAgoraEventRing::GetInstance()->Push(event);
 }
 
 /**
@@ -260,20 +306,12 @@ Parameters
 */
 void CAGEngineEventHandler::onAudioDeviceStateChanged(const char* deviceId, int deviceType, int deviceState)
 {
-	if (m_hMainWnd == NULL)
-		return;
-
-	LPAGE_AUDIO_DEVICE_STATE_CHANGED lpData = new AGE_AUDIO_DEVICE_STATE_CHANGED;
-
-	int nDeviceIDLen = strlen(deviceId) + 1;
-
-	lpData->deviceId = new char[nDeviceIDLen];
-
-	strcpy_s(lpData->deviceId, nDeviceIDLen, deviceId);
-	lpData->deviceType = deviceType;
-	lpData->deviceState = deviceState;
-
-	::PostMessage(m_hMainWnd, WM_MSGID(EID_AUDIO_DEVICE_STATE_CHANGED), (WPARAM)lpData, 0);
+	AGORA_EVENT event;
+	CAgoraEventRing::Init(event, AGORA_EVENT_AUDIO_DEVICE_STATE_CHANGED, 0);
+	event.nArgs[0] = deviceType;
+	event.nArgs[1] = deviceState;
+	CAgoraEventRing::SetText(event, deviceId);
+	CAgoraEventRing::GetInstance()->Push(event);
 }
 
 /**
@@ -289,20 +327,12 @@ Parameters
 */
 void CAGEngineEventHandler::onVideoDeviceStateChanged(const char* deviceId, int deviceType, int deviceState)
 {
-	if (m_hMainWnd == NULL)
-		return;
-
-	LPAGE_VIDEO_DEVICE_STATE_CHANGED lpData = new AGE_VIDEO_DEVICE_STATE_CHANGED;
-
-	int nDeviceIDLen = strlen(deviceId) + 1;
-
-	lpData->deviceId = new char[nDeviceIDLen];
-
-	strcpy_s(lpData->deviceId, nDeviceIDLen, deviceId);
-	lpData->deviceType = deviceType;
-	lpData->deviceState = deviceState;
-
-	::PostMessage(m_hMainWnd, WM_MSGID(EID_VIDEO_DEVICE_STATE_CHANGED), (WPARAM)lpData, 0);
+	AGORA_EVENT event;
+	CAgoraEventRing::Init(event, AGORA_EVENT_VIDEO_DEVICE_STATE_CHANGED, 0);
+	event.nArgs[0] = deviceType;
+	event.nArgs[1] = deviceState;
+	CAgoraEventRing::SetText(event, deviceId);
+	CAgoraEventRing::GetInstance()->Push(event);
 }
 
 /**
@@ -319,14 +349,10 @@ Parameters
 */
 void CAGEngineEventHandler::onLastmileQuality(int quality)
 {
-	if (m_hMainWnd == NULL)
-		return;
-
-	LPAGE_LASTMILE_QUALITY lpData = new AGE_LASTMILE_QUALITY;
-
-	lpData->quality = quality;
-
-	::PostMessage(m_hMainWnd, WM_MSGID(EID_LASTMILE_QUALITY), (WPARAM)lpData, 0);
+	AGORA_EVENT event;
+	CAgoraEventRing::Init(event, AGORA_EVENT_LASTMILE_QUALITY, 0);
+	event.nArgs[0] = quality;
+	CAgoraEventRing::GetInstance()->Push(event);
 }
 
 
@@ -343,15 +369,12 @@ Parameters
 */
 void CAGEngineEventHandler::onFirstLocalVideoFrame(int width, int height, int elapsed)
 {
-	LPAGE_FIRST_LOCAL_VIDEO_FRAME lpData = new AGE_FIRST_LOCAL_VIDEO_FRAME;
-
-	lpData->width = width;
-	lpData->height = height;
-	lpData->elapsed = elapsed;
-
-	if (m_hMainWnd != NULL)
-		::PostMessage(m_hMainWnd, WM_MSGID(EID_FIRST_LOCAL_VIDEO_FRAME), (WPARAM)lpData, 0);
-
+	AGORA_EVENT event;
+	CAgoraEventRing::Init(event, AGORA_EVENT_FIRST_LOCAL_VIDEO_FRAME, 0);
+	event.nArgs[0] = width;
+	event.nArgs[1] = height;
+	event.nArgs[2] = elapsed;
+	CAgoraEventRing::GetInstance()->Push(event);
 }
 
 /**
@@ -373,28 +396,19 @@ Parameters
 */
 void CAGEngineEventHandler::onFirstRemoteVideoDecoded(uid_t uid, int width, int height, int elapsed)
 {
-	VideoCanvas canvas;
-	canvas.renderMode = RENDER_MODE_FIT;
-	CAGExtInfoManager *lpExtInfoManager = CAGExtInfoManager::GetAGExtInfoManager();
-	canvas.uid = uid;
-	canvas.view = lpExtInfoManager->GetOneFreeView();
-
-	m_mapViews.insert(std::make_pair(canvas.uid, canvas.view));
-	CAgoraObject::GetAgoraObject(nullptr)->GetEngine()->setupRemoteVideo(canvas);
+	CChurnBench::CScopedTimer timer(CHURN_FIRST_VIDEO_HANDLER);
+	CChurnBench::GetInstance()->Record(CHURN_FIRST_VIDEO_ELAPSED, elapsed);
 
+	// the view was handed out in onUserJoined, this only catches a user the SDK did not announce
+	if (!m_subscriber.IsKnown(uid))
+		m_subscriber.OnUserJoined(uid);
 
-
-	if (m_hMainWnd == NULL)
-		return;
-
-	LPAGE_FIRST_REMOTE_VIDEO_DECODED lpData = new AGE_FIRST_REMOTE_VIDEO_DECODED;
-
-	lpData->uid = uid;
-	lpData->width = width;
-	lpData->height = height;
-	lpData->elapsed = elapsed;
-
-	::PostMessage(m_hMainWnd, WM_MSGID(EID_FIRST_REMOTE_VIDEO_DECODED), (WPARAM)lpData, 0);
+	AGORA_EVENT event;
+	CAgoraEventRing::Init(event, AGORA_EVENT_FIRST_REMOTE_VIDEO_DECODED, uid);
+	event.nArgs[0] = width;
+	event.nArgs[1] = height;
+	event.nArgs[2] = elapsed;
+	CAgoraEventRing::GetInstance()->Push(event);
 }
 
 /**
@@ -411,17 +425,12 @@ Parameters
 */
 void CAGEngineEventHandler::onFirstRemoteVideoFrame(uid_t uid, int width, int height, int elapsed)
 {
-	if (m_hMainWnd == NULL)
-		return;
-
-	LPAGE_FIRST_REMOTE_VIDEO_FRAME lpData = new AGE_FIRST_REMOTE_VIDEO_FRAME;
-
-	lpData->uid = uid;
-	lpData->width = width;
-	lpData->height = height;
-	lpData->elapsed = elapsed;
-
-	::PostMessage(m_hMainWnd, WM_MSGID(EID_FIRST_REMOTE_VIDEO_FRAME), (WPARAM)lpData, 0);
+	AGORA_EVENT event;
+	CAgoraEventRing::Init(event, AGORA_EVENT_FIRST_REMOTE_VIDEO_FRAME, uid);
+	event.nArgs[0] = width;
+	event.nArgs[1] = height;
+	event.nArgs[2] = elapsed;
+	CAgoraEventRing::GetInstance()->Push(event);
 }
 
 /**
@@ -446,15 +455,16 @@ Parameters
 */
 void CAGEngineEventHandler::onUserJoined(uid_t uid, int elapsed)
 {
-	if (m_hMainWnd == NULL)
-		return;
+	CChurnBench::CScopedTimer timer(CHURN_USER_JOINED_HANDLER);
+	CChurnBench::GetInstance()->Record(CHURN_USER_JOINED_ELAPSED, elapsed);
 
-	LPAGE_USER_JOINED lpData = new AGE_USER_JOINED;
+	// subscribed with the other joins of the same PARTICIPANT_BATCH_MS
+	m_subscriber.OnUserJoined(uid);
 
-	lpData->uid = uid;
-	lpData->elapsed = elapsed;
-
-	::PostMessage(m_hMainWnd, WM_MSGID(EID_USER_JOINED), (WPARAM)lpData, 0);
+	AGORA_EVENT event;
+	CAgoraEventRing::Init(event, AGORA_EVENT_USER_JOINED, uid);
+	event.nArgs[0] = elapsed;
+	CAgoraEventRing::GetInstance()->Push(event);
 }
 
 /**
@@ -470,24 +480,15 @@ Parameters
 */
 void CAGEngineEventHandler::onUserOffline(uid_t uid, USER_OFFLINE_REASON_TYPE reason)
 {
+	CChurnBench::CScopedTimer timer(CHURN_USER_OFFLINE_HANDLER);
 
-	auto it = m_mapViews.find(uid);
-	if (it != m_mapViews.end())
-	{
-		CAGExtInfoManager::GetAGExtInfoManager()->FreeView((AHANDLE)it->second);
-		m_mapViews.erase(it);
-		
-	}
-
-	if (m_hMainWnd == NULL)
-		return;
-
-	LPAGE_USER_OFFLINE lpData = new AGE_USER_OFFLINE;
+	// the freed view goes to the loudest waiting user with the next batch
+	m_subscriber.OnUserOffline(uid);
 
-	lpData->uid = uid;
-	lpData->reason = reason;
-
-	::PostMessage(m_hMainWnd, WM_MSGID(EID_USER_OFFLINE), (WPARAM)lpData, 0);
+	AGORA_EVENT event;
+	CAgoraEventRing::Init(event, AGORA_EVENT_USER_OFFLINE, uid);
+	event.nArgs[0] = reason;
+	CAgoraEventRing::GetInstance()->Push(event);
 }
 
 /**
@@ -505,15 +506,10 @@ Parameters
 */
 void CAGEngineEventHandler::onUserMuteAudio(uid_t uid, bool muted)
 {
-	if (m_hMainWnd == NULL)
-		return;
-
-	LPAGE_USER_MUTE_AUDIO lpData = new AGE_USER_MUTE_AUDIO;
-
-	lpData->uid = uid;
-	lpData->muted = muted;
-
-	::PostMessage(m_hMainWnd, WM_MSGID(EID_USER_MUTE_AUDIO), (WPARAM)lpData, 0);
+	AGORA_EVENT event;
+	CAgoraEventRing::Init(event, AGORA_EVENT_USER_MUTE_AUDIO, uid);
+	event.nArgs[0] = muted ? 1 : 0;
+	CAgoraEventRing::GetInstance()->Push(event);
 }
 
 /**
@@ -535,15 +531,10 @@ Parameters
 */
 void CAGEngineEventHandler::onUserMuteVideo(uid_t uid, bool muted)
 {
-	if (m_hMainWnd == NULL)
-		return;
-
-	LPAGE_USER_MUTE_VIDEO lpData = new AGE_USER_MUTE_VIDEO;
-
-	lpData->uid = uid;
-	lpData->muted = muted;
-
-	::PostMessage(m_hMainWnd, WM_MSGID(EID_USER_MUTE_VIDEO), (WPARAM)lpData, 0);
+	AGORA_EVENT event;
+	CAgoraEventRing::Init(event, AGORA_EVENT_USER_MUTE_VIDEO, uid);
+	event.nArgs[0] = muted ? 1 : 0;
+	CAgoraEventRing::GetInstance()->Push(event);
 }
 
 /**
@@ -559,19 +550,12 @@ Parameters
 */
 void CAGEngineEventHandler::onStreamMessage(uid_t uid, int streamId, const char* data, size_t length)
 {
-	if (m_hMainWnd == NULL)
-		return;
-
-	LPAGE_STREAM_MESSAGE lpData = new AGE_STREAM_MESSAGE;
-
-	lpData->uid = uid;
-	lpData->streamId = streamId;
-	lpData->data = new char[length];
-	lpData->length = length;
-
-	memcpy_s(lpData->data, length, data, length);
-
-	::PostMessage(m_hMainWnd, WM_MSGID(EID_STREAM_MESSAGE), (WPARAM)lpData, 0);
+	AGORA_EVENT event;
+	CAgoraEventRing::Init(event, AGORA_EVENT_STREAM_MESSAGE, uid);
+	event.nArgs[0] = streamId;
+	event.nArgs[1] = (int32_t)length;
+	memcpy(event.szText, data, length < AGORA_EVENT_TEXT ? length : AGORA_EVENT_TEXT);
+	CAgoraEventRing::GetInstance()->Push(event);
 }
 
 /**
@@ -584,15 +568,11 @@ Parameters
 */
 void CAGEngineEventHandler::onApiCallExecuted(const char* api, int error)
 {
-	if (m_hMainWnd == NULL)
-		return;
-
-	LPAGE_APICALL_EXECUTED lpData = new AGE_APICALL_EXECUTED;
-
-	strcpy_s(lpData->api, 128, api);
-	lpData->error = error;
-
-	::PostMessage(m_hMainWnd, WM_MSGID(EID_APICALL_EXECUTED), (WPARAM)lpData, 0);
+	AGORA_EVENT event;
+	CAgoraEventRing::Init(event, AGORA_EVENT_APICALL_EXECUTED, 0);
+	event.nArgs[0] = error;
+	CAgoraEventRing::SetText(event, api);
+	CAgoraEventRing::GetInstance()->Push(event);
 }
 
 /**
@@ -608,27 +588,35 @@ Parameters
 */
 void CAGEngineEventHandler::onLocalVideoStats(const LocalVideoStats& stats)
 {
-	if (g_Logon == true)
+	if (CStatsRecorder::IsRecording())
 	{
-		std::cout << "agora LocalVideoStats sentBitrate:" << stats.sentBitrate << " sent fps:" << stats.sentFrameRate << " enc fps:" << stats.encoderOutputFrameRate
-			<< " rendererOutputFrameRate:" << stats.rendererOutputFrameRate << " targetBitrate:" << stats.targetBitrate
-			<< " targetFrameRate:" << stats.targetFrameRate << " qualityAdaptIndication:" << stats.qualityAdaptIndication
-			<< " encodedBitrate:" << stats.encodedBitrate << " w:" << stats.encodedFrameWidth
-			<< " h:" << stats.encodedFrameHeight << " encodedFrameCount:" << stats.encodedFrameCount
-			<< " codecType:" << stats.codecType << " txPacketLossRate:" << stats.txPacketLossRate
-			<< " cap fps:" << stats.captureFrameRate << " videoQualityPoint:" << stats.videoQualityPoint
-			<< std::endl;
+		STATS_SAMPLE sample;
+		CStatsRecorder::Init(sample, STATS_LOCAL_VIDEO, 0);
+		sample.nValues[0] = stats.sentBitrate;
+		sample.nValues[1] = stats.sentFrameRate;
+		sample.nValues[2] = stats.encoderOutputFrameRate;
+		sample.nValues[3] = stats.rendererOutputFrameRate;
+		sample.nValues[4] = stats.targetBitrate;
+		sample.nValues[5] = stats.targetFrameRate;
+		sample.nValues[6] = stats.qualityAdaptIndication;
+		sample.nValues[7] = stats.encodedBitrate;
+		sample.nValues[8] = stats.encodedFrameWidth;
+		sample.nValues[9] = stats.encodedFrameHeight;
+		sample.nValues[10] = stats.encodedFrameCount;
+		sample.nValues[11] = stats.codecType;
+		sample.nValues[12] = stats.txPacketLossRate;
+		sample.nValues[13] = stats.captureFrameRate;
+		sample.nValues[14] = stats.videoQualityPoint;
+		CStatsRecorder::GetInstance()->Record(sample);
 	}
 
-	if (m_hMainWnd == NULL)
-		return;
-
-	LPAGE_LOCAL_VIDEO_STAT lpData = new AGE_LOCAL_VIDEO_STAT;
-
-	lpData->sentBitrate = stats.sentBitrate;
-	lpData->sentFrameRate = stats.sentFrameRate;
-
-	::PostMessage(m_hMainWnd, WM_MSGID(EID_LOCAL_VIDEO_STAT), (WPARAM)lpData, 0);
+	AGORA_EVENT event;
+	CAgoraEventRing::Init(event, AGORA_EVENT_LOCAL_VIDEO_STAT, 0);
+	event.nArgs[0] = stats.sentBitrate;
+	event.nArgs[1] = stats.sentFrameRate;
+	event.nArgs[2] = stats.encodedFrameWidth;
+	event.nArgs[3] = stats.encodedFrameHeight;
+	CAgoraEventRing::GetInstance()->Push(event);
 }
 
 /**
@@ -641,56 +629,72 @@ Parameters
 */
 void CAGEngineEventHandler::onRemoteVideoStats(const RemoteVideoStats& stats)
 {
-	if (g_Logon == true)
+	if (CStatsRecorder::IsRecording())
 	{
-		std::cout << "agora RemoteVideoStats uid:" << stats.uid << " width:" << stats.width << " height:" << stats.height
-			<< " receivedBitrate:" << stats.receivedBitrate << " decoderOutputFrameRate:" << stats.decoderOutputFrameRate
-			<< " rendererOutputFrameRate:" << stats.rendererOutputFrameRate << " packetLossRate:" << stats.packetLossRate
-			<< " rxStreamType:" << stats.rxStreamType << " totalFrozenTime:" << stats.totalFrozenTime
-			<< " frozenRate:" << stats.frozenRate << " totalActiveTime:" << stats.totalActiveTime
-			<< " publishDuration:" << stats.publishDuration
-			<< std::endl;
+		STATS_SAMPLE sample;
+		CStatsRecorder::Init(sample, STATS_REMOTE_VIDEO, stats.uid);
+		sample.nValues[0] = stats.delay;
+		sample.nValues[1] = stats.width;
+		sample.nValues[2] = stats.height;
+		sample.nValues[3] = stats.receivedBitrate;
+		sample.nValues[4] = stats.decoderOutputFrameRate;
+		sample.nValues[5] = stats.rendererOutputFrameRate;
+		sample.nValues[6] = stats.packetLossRate;
+		sample.nValues[7] = stats.rxStreamType;
+		sample.nValues[8] = stats.totalFrozenTime;
+		sample.nValues[9] = stats.frozenRate;
+		sample.nValues[10] = stats.totalActiveTime;
+		sample.nValues[11] = stats.publishDuration;
+		CStatsRecorder::GetInstance()->Record(sample);
 	}
-	
-	if (m_hMainWnd == NULL)
-		return;
-
-	LPAGE_REMOTE_VIDEO_STAT lpData = new AGE_REMOTE_VIDEO_STAT;
 
-	lpData->uid = stats.uid;
-	lpData->delay = stats.delay;
-	lpData->width = stats.width;
-	lpData->height = stats.height;
-	lpData->receivedFrameRate = stats.decoderOutputFrameRate;
-	lpData->receivedBitrate = stats.receivedBitrate;
-	lpData->receivedFrameRate = stats.decoderOutputFrameRate;
+	// a script may resize the view at any time, the stats come every two seconds
+	m_subscriber.OnRemoteVideoStats(stats);
 
-	::PostMessage(m_hMainWnd, WM_MSGID(EID_REMOTE_VIDEO_STAT), (WPARAM)lpData, 0);
+	AGORA_EVENT event;
+	CAgoraEventRing::Init(event, AGORA_EVENT_REMOTE_VIDEO_STAT, stats.uid);
+	event.nArgs[0] = stats.width;
+	event.nArgs[1] = stats.height;
+	event.nArgs[2] = stats.receivedBitrate;
+	event.nArgs[3] = stats.decoderOutputFrameRate;
+	CAgoraEventRing::GetInstance()->Push(event);
 }
 
 
 void CAGEngineEventHandler::onLocalAudioStats(const LocalAudioStats& stats)
 {
-	if (g_Logon == true)
-	{
-		std::cout << "agora onLocalAudioStats numChannels:" << stats.numChannels << " sentSampleRate:" << stats.sentSampleRate
-			<< " sentBitrate:" << stats.sentBitrate << " txPacketLossRate:" << stats.txPacketLossRate
-			<< std::endl;
-	}
+	if (!CStatsRecorder::IsRecording())
+		return;
+
+	STATS_SAMPLE sample;
+	CStatsRecorder::Init(sample, STATS_LOCAL_AUDIO, 0);
+	sample.nValues[0] = stats.numChannels;
+	sample.nValues[1] = stats.sentSampleRate;
+	sample.nValues[2] = stats.sentBitrate;
+	sample.nValues[3] = stats.txPacketLossRate;
+	CStatsRecorder::GetInstance()->Record(sample);
 }
 
 void CAGEngineEventHandler::onRemoteAudioStats(const RemoteAudioStats& stats)
 {
-	if(g_Logon == true)
-	{
-		std::cout << "agora onRemoteAudioStats uid:" << stats.uid << " quality:" << stats.quality 
-			<< " networkTransportDelay:" << stats.networkTransportDelay << " jitterBufferDelay:" << stats.jitterBufferDelay
-			<< " audioLossRate:" << stats.audioLossRate << " numChannels:" << stats.numChannels  
-			<< " receivedSampleRate:" << stats.receivedSampleRate << " receivedBitrate:" << stats.receivedBitrate
-			<< " totalFrozenTime:" << stats.totalFrozenTime << " frozenRate:" << stats.frozenRate  
-			<< " totalActiveTime:" << stats.totalActiveTime << " publishDuration:" << stats.publishDuration
-			<< std::endl;
-	}
+	m_subscriber.OnRemoteAudioStats(stats);
+	if (!CStatsRecorder::IsRecording())
+		return;
+
+	STATS_SAMPLE sample;
+	CStatsRecorder::Init(sample, STATS_REMOTE_AUDIO, stats.uid);
+	sample.nValues[0] = stats.quality;
+	sample.nValues[1] = stats.networkTransportDelay;
+	sample.nValues[2] = stats.jitterBufferDelay;
+	sample.nValues[3] = stats.audioLossRate;
+	sample.nValues[4] = stats.numChannels;
+	sample.nValues[5] = stats.receivedSampleRate;
+	sample.nValues[6] = stats.receivedBitrate;
+	sample.nValues[7] = stats.totalFrozenTime;
+	sample.nValues[8] = stats.frozenRate;
+	sample.nValues[9] = stats.totalActiveTime;
+	sample.nValues[10] = stats.publishDuration;
+	CStatsRecorder::GetInstance()->Record(sample);
 }
 
 /**
@@ -702,8 +706,9 @@ Deprecated as of v2.4.1. Use LOCAL_VIDEO_STREAM_STATE_CAPTURING (1) in the onLoc
 */
 void CAGEngineEventHandler::onCameraReady()
 {
-	if (m_hMainWnd != NULL)
-		::PostMessage(m_hMainWnd, WM_MSGID(EID_CAMERA_READY), 0, 0);
+	AGORA_EVENT event;
+	CAgoraEventRing::Init(event, AGORA_EVENT_CAMERA_READY, 0);
+	CAgoraEventRing::GetInstance()->Push(event);
 }
 
 /**
@@ -711,8 +716,9 @@ void CAGEngineEventHandler::onCameraReady()
 */
 void CAGEngineEventHandler::onVideoStopped()
 {
-	if (m_hMainWnd != NULL)
-		::PostMessage(m_hMainWnd, WM_MSGID(EID_VIDEO_STOPPED), 0, 0);
+	AGORA_EVENT event;
+	CAgoraEventRing::Init(event, AGORA_EVENT_VIDEO_STOPPED, 0);
+	CAgoraEventRing::GetInstance()->Push(event);
 }
 
 /**
@@ -724,8 +730,9 @@ Deprecated as of v2.4.1. Use LOCAL_VIDEO_STREAM_STATE_STOPPED(0) in the onLocalV
 */
 void CAGEngineEventHandler::onConnectionLost()
 {
-	if (m_hMainWnd != NULL)
-		::PostMessage(m_hMainWnd, WM_MSGID(EID_CONNECTION_LOST), 0, 0);
+	AGORA_EVENT event;
+	CAgoraEventRing::Init(event, AGORA_EVENT_CONNECTION_LOST, 0);
+	CAgoraEventRing::GetInstance()->Push(event);
 }
 
 /**
@@ -750,7 +757,9 @@ If the SDK fails to rejoin the channel 20 minutes after being disconnected from
 */
 void CAGEngineEventHandler::onConnectionInterrupted()
 {
-
+	AGORA_EVENT event;
+	CAgoraEventRing::Init(event, AGORA_EVENT_CONNECTION_INTERRUPTED, 0);
+	CAgoraEventRing::GetInstance()->Push(event);
 }
 
 /**
@@ -758,9 +767,10 @@ void CAGEngineEventHandler::onConnectionInterrupted()
 */
 void CAGEngineEventHandler::onUserEnableVideo(uid_t uid, bool enabled)
 {
-	//	if (m_hMainWnd != NULL)
-	//		::PostMessage(m_hMainWnd, WM_MSGID(EID_CONNECTION_LOST), 0, 0);
-
+	AGORA_EVENT event;
+	CAgoraEventRing::Init(event, AGORA_EVENT_USER_ENABLE_VIDEO, uid);
+	event.nArgs[0] = enabled ? 1 : 0;
+	CAgoraEventRing::GetInstance()->Push(event);
 }
 
 /**
@@ -773,9 +783,10 @@ REMOTE_VIDEO_STATE_DECODING (2) and REMOTE_VIDEO_STATE_REASON_REMOTE_UNMUTED (6)
 */
 void CAGEngineEventHandler::onStartRecordingService(int error)
 {
-	if (m_hMainWnd != NULL)
-		::PostMessage(m_hMainWnd, WM_MSGID(EID_START_RCDSRV), 0, 0);
-
+	AGORA_EVENT event;
+	CAgoraEventRing::Init(event, AGORA_EVENT_START_RECORDING_SERVICE, 0);
+	event.nArgs[0] = error;
+	CAgoraEventRing::GetInstance()->Push(event);
 }
 
 /**
@@ -783,9 +794,10 @@ Deprecated
 */
 void CAGEngineEventHandler::onStopRecordingService(int error)
 {
-	if (m_hMainWnd != NULL)
-		::PostMessage(m_hMainWnd, WM_MSGID(EID_STOP_RCDSRV), 0, 0);
-
+	AGORA_EVENT event;
+	CAgoraEventRing::Init(event, AGORA_EVENT_STOP_RECORDING_SERVICE, 0);
+	event.nArgs[0] = error;
+	CAgoraEventRing::GetInstance()->Push(event);
 }
 
 /**
@@ -793,18 +805,14 @@ Deprecated
 */
 void CAGEngineEventHandler::onRefreshRecordingServiceStatus(int status)
 {
-	if (m_hMainWnd == NULL)
-		return;
-
-	LPAGE_RCDSRV_STATUS lpData = new AGE_RCDSRV_STATUS;
-
-	lpData->status = status;
-
-	::PostMessage(m_hMainWnd, WM_MSGID(EID_REFREASH_RCDSRV), (WPARAM)lpData, 0);
+	AGORA_EVENT event;
+	CAgoraEventRing::Init(event, AGORA_EVENT_RECORDING_SERVICE_STATUS, 0);
+	event.nArgs[0] = status;
+	CAgoraEventRing::GetInstance()->Push(event);
 }
 
 void CAGEngineEventHandler::clearViews()
 {
-	m_mapViews.clear();
+	m_subscriber.Clear();
 	CAGExtInfoManager::GetAGExtInfoManager()->FreeAllView();
 }
\ No newline at end of file
@@ -0,0 +1,192 @@
+#include "AgoraBackend.h"
+#include "AgoraObject.h"
+#include "AgoraConfig.h"
+#include "AgoraEvent.h"
+#include "AgoraStatsSchema.h"
+#include "CommandQueue.h"
+#include "Singleton.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+IRtcBackend* GetRtcBackend()
+{
+	return CAgoraBackend::GetInstance();
+}
+
+RTC_DEFINE_SINGLETON(CAgoraBackend)
+
+CAgoraBackend::CAgoraBackend()
+	: m_bEngine(false)
+{
+}
+
+const STATS_SCHEMA_SET& CAgoraBackend::GetStatsSchemas()
+{
+	return g_agoraStatsSchemas;
+}
+
+static AGORA_CONFIG_ITEM MakeConfigItem(AGORA_CONFIG_TYPE type)
+{
+	AGORA_CONFIG_ITEM item;
+	memset(&item, 0, sizeof(item));
+	item.nType = type;
+	return item;
+}
+
+int CAgoraBackend::CreateEngine(const char* lpAppId)
+{
+	// the event ring is allocated here, before the engine can call back
+	CAgoraEventRing::GetInstance();
+	CAgoraObject::GetAgoraObject((char*)lpAppId);
+	m_bEngine = true;
+	return RTC_OK;
+}
+
+void CAgoraBackend::DestroyEngine()
+{
+	// whatever is still queued runs against the engine before it goes away
+	CCommandQueue::GetInstance()->Stop();
+	CAgoraObject::CloseAgoraObject();
+	m_bEngine = false;
+}
+
+/**
+Parameters:
+@param lpUserId	the uid, a decimal number up to UINT32_MAX
+*/
+int CAgoraBackend::JoinChannel(const char* lpChannelId, const char* lpUserId)
+{
+	char* lpEnd = nullptr;
+	errno = 0;
+	unsigned long long nUID = strtoull(lpUserId, &lpEnd, 10);
+	if (*lpUserId == '\0' || *lpUserId == '-' || *lpEnd != '\0' || errno == ERANGE || nUID > UINT32_MAX
+		|| strlen(lpChannelId) > AGORA_MAX_CHANNEL_ID)
+		return RTC_ERR_INVALID_ARG;
+
+	AGORA_CONFIG_ITEM item = MakeConfigItem(AGORA_CONFIG_JOIN_CHANNEL);
+	item.config.join.nUID = (uint32_t)nUID;
+	strcpy_s(item.config.join.szChannelId, sizeof(item.config.join.szChannelId), lpChannelId);
+	return CCommandQueue::GetInstance()->Run(&item, 1);
+}
+
+int CAgoraBackend::WaitJoinChannel(int nTimeoutMs)
+{
+	int nElapsedMs = CAgoraObject::GetAgoraObject(nullptr)->WaitJoinChannel(nTimeoutMs);
+	return nElapsedMs < 0 ? RTC_ERR_TIMEOUT : nElapsedMs;
+}
+
+int CAgoraBackend::LeaveChannel()
+{
+	return CCommandQueue::GetInstance()->RunLeaveChannel();
+}
+
+int CAgoraBackend::EnableVideo(bool bEnable)
+{
+	AGORA_CONFIG_ITEM item = MakeConfigItem(AGORA_CONFIG_ENABLE_VIDEO);
+	item.config.enable.bEnable = bEnable ? 1 : 0;
+	return CCommandQueue::GetInstance()->Run(&item, 1);
+}
+
+int CAgoraBackend::EnableAudio(bool bEnable)
+{
+	AGORA_CONFIG_ITEM item = MakeConfigItem(AGORA_CONFIG_ENABLE_AUDIO);
+	item.config.enable.bEnable = bEnable ? 1 : 0;
+	return CCommandQueue::GetInstance()->Run(&item, 1);
+}
+
+int CAgoraBackend::EnableDualStream(bool bEnable)
+{
+	AGORA_CONFIG_ITEM item = MakeConfigItem(AGORA_CONFIG_DUAL_STREAM);
+	item.config.enable.bEnable = bEnable ? 1 : 0;
+	return CCommandQueue::GetInstance()->Run(&item, 1);
+}
+
+int CAgoraBackend::EnableHeadless(bool bEnable)
+{
+	AGORA_CONFIG_ITEM item = MakeConfigItem(AGORA_CONFIG_HEADLESS);
+	item.config.enable.bEnable = bEnable ? 1 : 0;
+	return CCommandQueue::GetInstance()->Run(&item, 1);
+}
+
+int CAgoraBackend::EnableRemoteVideoFrames(bool bEnable)
+{
+	AGORA_CONFIG_ITEM item = MakeConfigItem(AGORA_CONFIG_REMOTE_VIDEO_FRAMES);
+	item.config.enable.bEnable = bEnable ? 1 : 0;
+	return CCommandQueue::GetInstance()->Run(&item, 1);
+}
+
+int CAgoraBackend::EnableAudioSink(bool bEnable, int nSampleRate, int nChannels)
+{
+	AGORA_CONFIG_ITEM item = MakeConfigItem(AGORA_CONFIG_AUDIO_SINK);
+	item.config.audioSink.bEnable = bEnable ? 1 : 0;
+	item.config.audioSink.nSampleRate = nSampleRate;
+	item.config.audioSink.nChannels = nChannels;
+	return CCommandQueue::GetInstance()->Run(&item, 1);
+}
+
+// not through the queue, the puller calls every 10ms
+bool CAgoraBackend::PullAudioFrame(int16_t* lpPcm, int nSamples, int nSampleRate, int nChannels)
+{
+	return CAgoraObject::GetAgoraObject(nullptr)->PullAudioFrame(lpPcm, nSamples, nSampleRate, nChannels) != FALSE;
+}
+
+// the SDK mixes in its own channels, nChannels is not used
+// the users come as decoded and the mix as the SDK mixes them, nChannels is not configurable
+int CAgoraBackend::EnableAudioRecording(bool bEnable, int nSampleRate, int /*nChannels*/)
+{
+	AGORA_CONFIG_ITEM item = MakeConfigItem(AGORA_CONFIG_AUDIO_RECORDING);
+	item.config.audioRecording.bEnable = bEnable ? 1 : 0;
+	item.config.audioRecording.nSampleRate = nSampleRate;
+	return CCommandQueue::GetInstance()->Run(&item, 1);
+}
+
+int CAgoraBackend::SetVideoProfile(int nWidth, int nHeight, int nFps, int nBitrate)
+{
+	AGORA_CONFIG_ITEM item = MakeConfigItem(AGORA_CONFIG_VIDEO_PROFILE);
+	item.config.videoProfile.nWidth = nWidth;
+	item.config.videoProfile.nHeight = nHeight;
+	item.config.videoProfile.nFps = nFps;
+	item.config.videoProfile.nBitrate = nBitrate;
+	return CCommandQueue::GetInstance()->Run(&item, 1);
+}
+
+/**
+	the profile goes through the queue with the default scenario, the codec is a
+	private parameter of the SDK and set right away like setParameters
+Parameters:
+@param lpCodec	a codec name of che.audio.specify.codec, letters, digits and _
+*/
+int CAgoraBackend::SetAudioProfile(int nProfile, const char* lpCodec)
+{
+	if (lpCodec != NULL)
+	{
+		size_t nLength = strlen(lpCodec);
+		if (nLength == 0 || nLength > 32 || strspn(lpCodec, "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_") != nLength)
+			return RTC_ERR_INVALID_ARG;
+	}
+
+	AGORA_CONFIG_ITEM item = MakeConfigItem(AGORA_CONFIG_AUDIO_PROFILE);
+	item.config.audioProfile.nProfile = nProfile;
+	item.config.audioProfile.nScenario = AUDIO_SCENARIO_DEFAULT;
+	int nRet = CCommandQueue::GetInstance()->Run(&item, 1);
+	if (nRet != RTC_OK || lpCodec == NULL)
+		return nRet;
+
+	char szParameter[64];
+	snprintf(szParameter, sizeof(szParameter), "{\"che.audio.specify.codec\":\"%s\"}", lpCodec);
+	return CCommandQueue::GetInstance()->RunCommand(ENGINE_COMMAND_SET_PARAMETERS, szParameter);
+}
+
+// the video observer copies the frame pushed into CAgVideoBuffer
+int CAgoraBackend::EnableCustomVideoCapture()
+{
+	return CCommandQueue::GetInstance()->RunCommand(ENGINE_COMMAND_CUSTOM_VIDEO_CAPTURE);
+}
+
+// the audio observer replaces the recorded frames with the PCM pushed into CircleBuffer
+int CAgoraBackend::EnableCustomAudioCapture(int nSampleRate, int nChannels)
+{
+	return CCommandQueue::GetInstance()->RunCommand(ENGINE_COMMAND_CUSTOM_AUDIO_CAPTURE, nullptr, nSampleRate, nChannels);
+}
@@ -0,0 +1,28 @@
+#include "AgoraChurnTarget.h"
+#include "AgoraObject.h"
+
+CAgoraChurnTarget::CAgoraChurnTarget(const char* lpChannelName, UINT nUID)
+	: m_strChannelName(lpChannelName)
+	, m_nUID(nUID)
+{
+}
+
+void CAgoraChurnTarget::Join()
+{
+	CAgoraObject::GetAgoraObject(nullptr)->JoinChannel(m_strChannelName.c_str(), m_nUID, nullptr);
+}
+
+bool CAgoraChurnTarget::WaitJoin(int nTimeoutMs)
+{
+	return CAgoraObject::GetAgoraObject(nullptr)->WaitJoinChannel(nTimeoutMs) >= 0;
+}
+
+void CAgoraChurnTarget::Leave()
+{
+	CAgoraObject::GetAgoraObject(nullptr)->LeaveChannel();
+}
+
+int CAgoraChurnTarget::WaitLeave(int nTimeoutMs)
+{
+	return CAgoraObject::GetAgoraObject(nullptr)->WaitLeaveChannel(nTimeoutMs) ? 1 : -1;
+}
@@ -0,0 +1,196 @@
+#include "AgoraConfig.h"
+#include "AgoraObject.h"
+#include <string.h>
+
+static bool InRange(int32_t nValue, int32_t nMin, int32_t nMax)
+{
+	return nValue >= nMin && nValue <= nMax;
+}
+
+/**
+	check the fields of one item without touching the engine
+Parameters:
+@param item	item to check
+@return AGORA_CONFIG_OK, AGORA_CONFIG_ERR_TYPE or AGORA_CONFIG_ERR_INVALID_ARG
+*/
+int CAgoraConfig::Validate(const AGORA_CONFIG_ITEM& item)
+{
+	bool bValid = false;
+
+	switch (item.nType)
+	{
+	case AGORA_CONFIG_VIDEO_PROFILE:
+	{
+		const AGORA_VIDEO_PROFILE_CONFIG& profile = item.config.videoProfile;
+		bValid = InRange(profile.nWidth, 1, AGORA_MAX_VIDEO_DIMENSION)
+			&& InRange(profile.nHeight, 1, AGORA_MAX_VIDEO_DIMENSION)
+			&& InRange(profile.nFps, 1, AGORA_MAX_VIDEO_FPS)
+			&& profile.nBitrate >= COMPATIBLE_BITRATE;
+		break;
+	}
+	case AGORA_CONFIG_ENABLE_VIDEO:
+	case AGORA_CONFIG_ENABLE_AUDIO:
+	case AGORA_CONFIG_DUAL_STREAM:
+	case AGORA_CONFIG_HEADLESS:
+	case AGORA_CONFIG_REMOTE_VIDEO_FRAMES:
+		bValid = InRange(item.config.enable.bEnable, 0, 1);
+		break;
+	case AGORA_CONFIG_CHANNEL_PROFILE:
+		bValid = InRange(item.config.channelProfile.nProfile, CHANNEL_PROFILE_COMMUNICATION, CHANNEL_PROFILE_GAME);
+		break;
+	case AGORA_CONFIG_CLIENT_ROLE:
+		bValid = InRange(item.config.clientRole.nRole, CLIENT_ROLE_BROADCASTER, CLIENT_ROLE_AUDIENCE);
+		break;
+	case AGORA_CONFIG_AUDIO_PROFILE:
+		bValid = InRange(item.config.audioProfile.nProfile, AUDIO_PROFILE_DEFAULT, AUDIO_PROFILE_NUM - 1)
+			&& InRange(item.config.audioProfile.nScenario, AUDIO_SCENARIO_DEFAULT, AUDIO_SCENARIO_NUM - 1);
+		break;
+	case AGORA_CONFIG_AUDIO_SINK:
+	{
+		const AGORA_AUDIO_SINK_CONFIG& sink = item.config.audioSink;
+		bValid = InRange(sink.bEnable, 0, 1)
+			&& (!sink.bEnable || ((sink.nSampleRate == 8000 || sink.nSampleRate == 16000 || sink.nSampleRate == 32000
+				|| sink.nSampleRate == 44100 || sink.nSampleRate == 48000) && InRange(sink.nChannels, 1, 2)));
+		break;
+	}
+	case AGORA_CONFIG_AUDIO_RECORDING:
+	{
+		const AGORA_AUDIO_RECORDING_CONFIG& recording = item.config.audioRecording;
+		bValid = InRange(recording.bEnable, 0, 1)
+			&& (!recording.bEnable || recording.nSampleRate == 8000 || recording.nSampleRate == 16000 || recording.nSampleRate == 32000
+				|| recording.nSampleRate == 44100 || recording.nSampleRate == 48000);
+		break;
+	}
+	case AGORA_CONFIG_JOIN_CHANNEL:
+	{
+		// must be terminated inside the array and not empty
+		size_t nLen = strnlen(item.config.join.szChannelId, sizeof(item.config.join.szChannelId));
+		bValid = nLen > 0 && nLen < sizeof(item.config.join.szChannelId);
+		break;
+	}
+	default:
+		return AGORA_CONFIG_ERR_TYPE;
+	}
+
+	return bValid ? AGORA_CONFIG_OK : AGORA_CONFIG_ERR_INVALID_ARG;
+}
+
+/**
+	validate one item and hand it to the engine
+Parameters:
+@param item	item to apply, nResult and nSdkError are filled in
+@return item.nResult
+*/
+int CAgoraConfig::Apply(AGORA_CONFIG_ITEM& item)
+{
+	item.nSdkError = 0;
+	item.nResult = Validate(item);
+	if (item.nResult != AGORA_CONFIG_OK)
+		return item.nResult;
+
+	CAgoraObject* lpAgoraObject = CAgoraObject::GetAgoraObject(nullptr);
+	IRtcEngine* lpEngine = lpAgoraObject->GetEngine();
+	int nRet = 0;
+
+	switch (item.nType)
+	{
+	case AGORA_CONFIG_VIDEO_PROFILE:
+	{
+		VideoEncoderConfiguration vec;
+		vec.dimensions.width = item.config.videoProfile.nWidth;
+		vec.dimensions.height = item.config.videoProfile.nHeight;
+		vec.frameRate = static_cast<FRAME_RATE>(item.config.videoProfile.nFps);
+		vec.bitrate = item.config.videoProfile.nBitrate;
+		nRet = lpEngine->setVideoEncoderConfiguration(vec);
+		break;
+	}
+	case AGORA_CONFIG_ENABLE_VIDEO:
+		// CAgoraObject keeps the enabled state, it only reports success
+		nRet = lpAgoraObject->EnableVideo(item.config.enable.bEnable) ? 0 : -ERR_FAILED;
+		break;
+	case AGORA_CONFIG_ENABLE_AUDIO:
+		nRet = item.config.enable.bEnable ? lpEngine->enableAudio() : lpEngine->disableAudio();
+		break;
+	case AGORA_CONFIG_CHANNEL_PROFILE:
+		nRet = lpEngine->setChannelProfile((CHANNEL_PROFILE_TYPE)item.config.channelProfile.nProfile);
+		break;
+	case AGORA_CONFIG_CLIENT_ROLE:
+		nRet = lpEngine->setClientRole((CLIENT_ROLE_TYPE)item.config.clientRole.nRole);
+		break;
+	case AGORA_CONFIG_AUDIO_PROFILE:
+		nRet = lpEngine->setAudioProfile((AUDIO_PROFILE_TYPE)item.config.audioProfile.nProfile,
+			(AUDIO_SCENARIO_TYPE)item.config.audioProfile.nScenario);
+		break;
+	case AGORA_CONFIG_JOIN_CHANNEL:
+		nRet = lpAgoraObject->JoinChannel(item.config.join.szChannelId, item.config.join.nUID, nullptr) ? 0 : -ERR_FAILED;
+		break;
+	case AGORA_CONFIG_DUAL_STREAM:
+		nRet = lpAgoraObject->EnableDualStream(item.config.enable.bEnable) ? 0 : -ERR_FAILED;
+		break;
+	case AGORA_CONFIG_HEADLESS:
+		nRet = lpAgoraObject->EnableHeadless(item.config.enable.bEnable) ? 0 : -ERR_FAILED;
+		break;
+	case AGORA_CONFIG_REMOTE_VIDEO_FRAMES:
+		nRet = lpAgoraObject->EnableRemoteVideoFrames(item.config.enable.bEnable) ? 0 : -ERR_FAILED;
+		break;
+	case AGORA_CONFIG_AUDIO_SINK:
+		nRet = lpAgoraObject->EnableAudioSink(item.config.audioSink.bEnable, item.config.audioSink.nSampleRate,
+			item.config.audioSink.nChannels) ? 0 : -ERR_FAILED;
+		break;
+	case AGORA_CONFIG_AUDIO_RECORDING:
+		nRet = lpAgoraObject->EnableAudioRecording(item.config.audioRecording.bEnable, item.config.audioRecording.nSampleRate)
+			? 0 : -ERR_FAILED;
+		break;
+	}
+
+	item.nSdkError = nRet;
+	item.nResult = nRet == 0 ? AGORA_CONFIG_OK : AGORA_CONFIG_ERR_SDK;
+	return item.nResult;
+}
+
+/**
+	apply a batch in order
+Parameters:
+@param lpItems	items to apply, every nResult is filled in
+@param nCount	number of items
+@return AGORA_CONFIG_OK, or the nResult of the first item that failed
+*/
+int CAgoraConfig::ApplyBatch(AGORA_CONFIG_ITEM* lpItems, int nCount)
+{
+	if (nCount < 0 || (nCount > 0 && lpItems == nullptr))
+		return AGORA_CONFIG_ERR_INVALID_ARG;
+
+	int nFailed = -1;
+	for (int i = 0; i < nCount; i++)
+	{
+		lpItems[i].nSdkError = 0;
+		lpItems[i].nResult = Validate(lpItems[i]);
+		if (lpItems[i].nResult != AGORA_CONFIG_OK && nFailed < 0)
+			nFailed = i;
+	}
+
+	if (nFailed < 0)
+	{
+		for (int i = 0; i < nCount; i++)
+		{
+			if (Apply(lpItems[i]) != AGORA_CONFIG_OK)
+			{
+				nFailed = i;
+				break;
+			}
+		}
+	}
+
+	if (nFailed < 0)
+		return AGORA_CONFIG_OK;
+
+	// whatever was not applied is reported as skipped, invalid items keep their own error
+	for (int i = 0; i < nCount; i++)
+	{
+		if (i == nFailed || lpItems[i].nResult != AGORA_CONFIG_OK)
+			continue;
+		if (i > nFailed || lpItems[nFailed].nResult != AGORA_CONFIG_ERR_SDK)
+			lpItems[i].nResult = AGORA_CONFIG_ERR_SKIPPED;
+	}
+	return lpItems[nFailed].nResult;
+}
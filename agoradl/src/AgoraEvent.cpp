@@ -0,0 +1,65 @@
+#include "AgoraEvent.h"
+#include "MediaClock.h"
+#include <string.h>
+
+/**
+	the ring lives for the whole process, a callback still running while the
+	dll unloads must not write into freed memory
+*/
+CAgoraEventRing* CAgoraEventRing::GetInstance()
+{
+	static CAgoraEventRing* lpEventRing = new CAgoraEventRing();
+	return lpEventRing;
+}
+
+CAgoraEventRing::CAgoraEventRing()
+	: m_nDroppedReported(0)
+{
+}
+
+void CAgoraEventRing::Init(AGORA_EVENT& event, int nType, uint32_t nUID)
+{
+	memset(&event, 0, sizeof(event));
+	event.nType = nType;
+	event.nUID = nUID;
+	event.nTimestampUs = CMediaClock::NowUs();
+}
+
+void CAgoraEventRing::SetText(AGORA_EVENT& event, const char* lpText)
+{
+	if (lpText == NULL)
+	{
+		event.szText[0] = 0;
+		return;
+	}
+
+	size_t nLen = strnlen(lpText, AGORA_EVENT_TEXT - 1);
+	memcpy(event.szText, lpText, nLen);
+	event.szText[nLen] = 0;
+}
+
+/**
+	copy out the pending events in the order they were pushed
+Parameters:
+@param lpEvents	array of nMax records owned by the caller
+@param nMax	size of lpEvents
+@return number of records written
+*/
+int CAgoraEventRing::Poll(AGORA_EVENT* lpEvents, int nMax)
+{
+	std::lock_guard<std::mutex> lock(m_lockPoll);
+
+	int nCount = 0;
+	uint64_t nDropped = m_ring.GetDropped();
+	if (nDropped != m_nDroppedReported && nMax > 0)
+	{
+		Init(lpEvents[nCount], AGORA_EVENT_DROPPED, 0);
+		lpEvents[nCount].nArgs[0] = (int32_t)(nDropped - m_nDroppedReported);
+		m_nDroppedReported = nDropped;
+		nCount++;
+	}
+
+	while (nCount < nMax && m_ring.Pop(lpEvents[nCount]))
+		nCount++;
+	return nCount;
+}
@@ -1,5 +1,8 @@
 #include "AgoraObject.h"
 #include "AGExtInfoManager.h"
+#include "ParticipantRegistry.h"
+#include "NullVideoRender.h"
+#include "Logger.h"
 #include "../agora/include/IAgoraRtcChannel.h"
 
 //#include "Base64.h"
@@ -16,12 +19,16 @@ CAGEngineEventHandler CAgoraObject::m_EngineEventHandler;
 CExtendVideoFrameObserver CAgoraObject::m_CExtendVideoFrameObserver;
 CExtendAudioFrameObserver CAgoraObject::m_CExtendAudioFrameObserver;
 
-std::atomic<bool> g_Logon = true;
-
 
 CAgoraObject::CAgoraObject(void)
 	: m_dwEngineFlag(0)
 	, m_bVideoEnable(FALSE)
+	, m_bDualStream(TRUE)
+	, m_bHeadless(FALSE)
+	, m_bCustomVideoCapture(FALSE)
+	, m_bRemoteVideoFrames(FALSE)
+	, m_bCustomAudioCapture(FALSE)
+	, m_bAudioRecording(FALSE)
 	, m_bLocalAudioMuted(FALSE)
 {
 	m_strChannelName.clear();
@@ -97,6 +104,8 @@ CAgoraObject *CAgoraObject::GetAgoraObject(char* lpAppId)
 */
 void CAgoraObject::CloseAgoraObject()
 {
+	// the batched joins and leaves call the engine
+	CParticipantRegistry::GetInstance()->StopBatching();
 	if (m_lpAgoraEngine != NULL)
 		m_lpAgoraEngine->release();
 
@@ -107,24 +116,6 @@ void CAgoraObject::CloseAgoraObject()
 	m_lpAgoraObject = NULL;
 }
 
-/**
-  Setting Message Handler
-Parameters:
-	@param hWnd     A handle to the handler
- */
-void CAgoraObject::SetMsgHandlerWnd(AHANDLE hWnd)
-{
-	m_EngineEventHandler.SetMsgReceiver((HWND)hWnd);
-}
-
-/**
-	retrieve the handle of the message handler
-*/
-AHANDLE CAgoraObject::GetMsgHandlerWnd()
-{
-	return (AHANDLE)m_EngineEventHandler.GetMsgReceiver();
-}
-
 /**
    Join a channel for streaming or communication.
 Parameters:
@@ -134,16 +125,26 @@ Parameters:
 */
 BOOL CAgoraObject::JoinChannel(const char* lpChannelName, UINT nUID, const char* lpToken)
 {
+	int nRet = 0;
+	// a headless robot has no preview, every view is a slot for a remote stream
+	if (!m_bHeadless)
+	{
+		VideoCanvas canvas;
+		canvas.renderMode = RENDER_MODE_FIT;
+		CAGExtInfoManager *lpExtInfoManager = CAGExtInfoManager::GetAGExtInfoManager();
+		canvas.uid = nUID;
+
+		canvas.view = lpExtInfoManager->GetFirstView();
 
-	VideoCanvas canvas;
-	canvas.renderMode = RENDER_MODE_FIT;
-	CAGExtInfoManager *lpExtInfoManager = CAGExtInfoManager::GetAGExtInfoManager();
-	canvas.uid = nUID;
-	
-	canvas.view = lpExtInfoManager->GetFirstView();
+		m_localView = canvas.view;
+		nRet = GetEngine()->setupLocalVideo(canvas);
+	}
 
-	m_localView = canvas.view;
-	int nRet = GetEngine()->setupLocalVideo(canvas);
+	m_EngineEventHandler.ResetJoinState();
+	m_EngineEventHandler.ResetSubscriptions(m_lpAgoraEngine);
+	m_lpAgoraEngine->enableDualStreamMode(m_bDualStream ? true : false);
+	// the subscriber gives the views to the active speakers
+	m_lpAgoraEngine->enableAudioVolumeIndication(SPEAKER_REPORT_INTERVAL_MS, 3, false);
 
 
 	if (!lpToken || 0 == _tcslen(lpToken))
@@ -154,22 +155,48 @@ BOOL CAgoraObject::JoinChannel(const char* lpChannelName, UINT nUID, const char*
 	if (nRet == 0)
 		m_strChannelName = (char*)lpChannelName;
 
-	m_lpAgoraEngine->startPreview();
+	if (!m_bHeadless)
+		m_lpAgoraEngine->startPreview();
 	return nRet == 0 ? TRUE : FALSE;
 }
 
+/**
+	wait for the pending JoinChannel to be confirmed by the SDK
+Parameters:
+@param nTimeoutMs	maximum time to wait, <0 waits forever
+@return elapsed (ms) reported in onJoinChannelSuccess, or -1 on timeout
+*/
+int CAgoraObject::WaitJoinChannel(int nTimeoutMs)
+{
+	return m_EngineEventHandler.WaitJoinChannel(nTimeoutMs);
+}
+
 /**
 	Leave the channel
 */
 BOOL CAgoraObject::LeaveChannel()
 {
-	CAGExtInfoManager::GetAGExtInfoManager()->FreeView((AHANDLE)m_localView);
-	m_lpAgoraEngine->stopPreview();
+	if (m_localView != nullptr)
+		CAGExtInfoManager::GetAGExtInfoManager()->FreeView((VHANDLE)m_localView);
+	m_localView = nullptr;
+	if (!m_bHeadless)
+		m_lpAgoraEngine->stopPreview();
 	int nRet = m_lpAgoraEngine->leaveChannel();
 
 	return nRet == 0 ? TRUE : FALSE;
 }
 
+/**
+	wait for onLeaveChannel after LeaveChannel
+Parameters:
+@param nTimeoutMs	maximum time to wait, <0 waits forever
+@return false on timeout
+*/
+bool CAgoraObject::WaitLeaveChannel(int nTimeoutMs)
+{
+	return m_EngineEventHandler.WaitLeaveChannel(nTimeoutMs);
+}
+
 /**
 	get current channel name
 */
@@ -200,6 +227,159 @@ BOOL CAgoraObject::EnableVideo(BOOL bEnable)
 	return nRet == 0 ? TRUE : FALSE;
 }
 
+/**
+	publish the low stream next to the high one, the receivers play it in
+	small views. on by default and applied again by every JoinChannel
+ Parameters:
+	@param bEnable true to send both streams
+*/
+BOOL CAgoraObject::EnableDualStream(BOOL bEnable)
+{
+	int nRet = m_lpAgoraEngine->enableDualStreamMode(bEnable ? true : false);
+	if (nRet == 0)
+		m_bDualStream = bEnable;
+
+	return nRet == 0 ? TRUE : FALSE;
+}
+
+/**
+	render the remote streams into CNullVideoRenderFactory instead of windows
+	and skip the local preview, for robots that need no HWND. the views added
+	are then only slots, any distinct non NULL handles will do. call before
+	JoinChannel
+ Parameters:
+	@param bEnable true for headless
+*/
+BOOL CAgoraObject::EnableHeadless(BOOL bEnable)
+{
+	agora::util::AutoPtr<agora::media::IMediaEngine> mediaEngine;
+	mediaEngine.queryInterface(m_lpAgoraEngine, agora::AGORA_IID_MEDIA_ENGINE);
+	if (!mediaEngine)
+		return FALSE;
+
+	int nRet = mediaEngine->registerVideoRenderFactory(bEnable ? CNullVideoRenderFactory::GetInstance() : NULL);
+	if (nRet == 0)
+		m_bHeadless = bEnable;
+
+	return nRet == 0 ? TRUE : FALSE;
+}
+
+BOOL CAgoraObject::IsHeadless()
+{
+	return m_bHeadless;
+}
+
+/**
+	the SDK takes the frames of the video observer, which copies the frame
+	pushed into CAgVideoBuffer
+*/
+BOOL CAgoraObject::EnableCustomVideoCapture(BOOL bEnable)
+{
+	m_bCustomVideoCapture = bEnable;
+	return UpdateVideoFrameObserver();
+}
+
+/**
+	the video observer gets every decoded remote frame in onRenderVideoFrame
+	and hands it to CVideoCompositor. without custom capture the frames of
+	the camera go through the observer untouched. call before JoinChannel
+ Parameters:
+	@param bEnable true to get the frames
+*/
+BOOL CAgoraObject::EnableRemoteVideoFrames(BOOL bEnable)
+{
+	m_bRemoteVideoFrames = bEnable;
+	return UpdateVideoFrameObserver();
+}
+
+/**
+	the SDK takes the recorded frames of the audio observer, which copies
+	the PCM pushed into CircleBuffer
+*/
+BOOL CAgoraObject::EnableCustomAudioCapture(BOOL bEnable)
+{
+	m_bCustomAudioCapture = bEnable;
+	return UpdateAudioFrameObserver();
+}
+
+/**
+	the audio observer copies every remote user before mixing and the mixed
+	audio into CAudioRecorder. the users come in the format they were
+	decoded in, the mix at nSampleRate in the channels of the SDK
+ Parameters:
+	@param bEnable true to record
+	@param nSampleRate 8000, 16000, 32000, 44100 or 48000
+*/
+BOOL CAgoraObject::EnableAudioRecording(BOOL bEnable, int nSampleRate)
+{
+	if (bEnable && m_lpAgoraEngine->setMixedAudioFrameParameters(nSampleRate, nSampleRate / 100) != 0)
+		return FALSE;
+	m_bAudioRecording = bEnable;
+	return UpdateAudioFrameObserver();
+}
+
+/**
+	the mixed remote audio goes to the external sink instead of the playout
+	device, it is pulled 10ms at a time with PullAudioFrame. call before
+	JoinChannel
+ Parameters:
+	@param bEnable true to pull the audio
+	@param nSampleRate 8000, 16000, 32000, 44100 or 48000
+	@param nChannels 1 or 2
+*/
+BOOL CAgoraObject::EnableAudioSink(BOOL bEnable, int nSampleRate, int nChannels)
+{
+	return m_lpAgoraEngine->setExternalAudioSink(bEnable != FALSE, nSampleRate, nChannels) == 0 ? TRUE : FALSE;
+}
+
+/**
+	from the CAudioSink thread, in the format given to EnableAudioSink
+ Parameters:
+	@param lpPcm nSamples * nChannels interleaved samples
+	@param nSamples samples per channel
+*/
+BOOL CAgoraObject::PullAudioFrame(int16_t* lpPcm, int nSamples, int nSampleRate, int nChannels)
+{
+	agora::util::AutoPtr<agora::media::IMediaEngine> mediaEngine;
+	mediaEngine.queryInterface(m_lpAgoraEngine, agora::AGORA_IID_MEDIA_ENGINE);
+	if (!mediaEngine)
+		return FALSE;
+
+	agora::media::IAudioFrameObserver::AudioFrame frame;
+	memset(&frame, 0, sizeof(frame));
+	frame.type = agora::media::IAudioFrameObserver::FRAME_TYPE_PCM16;
+	frame.samples = nSamples;
+	frame.bytesPerSample = 2;
+	frame.channels = nChannels;
+	frame.samplesPerSec = nSampleRate;
+	frame.buffer = lpPcm;
+	return mediaEngine->pullAudioFrame(&frame) == 0 ? TRUE : FALSE;
+}
+
+BOOL CAgoraObject::UpdateVideoFrameObserver()
+{
+	agora::util::AutoPtr<agora::media::IMediaEngine> mediaEngine;
+	mediaEngine.queryInterface(m_lpAgoraEngine, agora::AGORA_IID_MEDIA_ENGINE);
+	if (!mediaEngine)
+		return FALSE;
+
+	m_CExtendVideoFrameObserver.EnableCustomCapture(m_bCustomVideoCapture != FALSE);
+	BOOL bRegister = m_bCustomVideoCapture || m_bRemoteVideoFrames;
+	return mediaEngine->registerVideoFrameObserver(bRegister ? &m_CExtendVideoFrameObserver : NULL) == 0 ? TRUE : FALSE;
+}
+
+BOOL CAgoraObject::UpdateAudioFrameObserver()
+{
+	agora::util::AutoPtr<agora::media::IMediaEngine> mediaEngine;
+	mediaEngine.queryInterface(m_lpAgoraEngine, agora::AGORA_IID_MEDIA_ENGINE);
+	if (!mediaEngine)
+		return FALSE;
+
+	m_CExtendAudioFrameObserver.EnableCustomCapture(m_bCustomAudioCapture != FALSE);
+	BOOL bRegister = m_bCustomAudioCapture || m_bAudioRecording;
+	return mediaEngine->registerAudioFrameObserver(bRegister ? &m_CExtendAudioFrameObserver : NULL) == 0 ? TRUE : FALSE;
+}
+
 /**
 	check if video enabled
 */
@@ -267,4 +447,109 @@ BOOL CAgoraObject::MuteLocalVideo(BOOL bMuted)
 BOOL CAgoraObject::IsLocalVideoMuted()
 {
 	return m_bLocalVideoMuted;
+}
+
+BOOL CAgoraObject::SetParameters(const char* lpParameters)
+{
+	if (m_lpAgoraEngine == NULL)
+		return FALSE;
+
+	AParameter apm(*m_lpAgoraEngine);
+	if (apm.get() == NULL)
+		return FALSE;
+	return apm->setParameters(lpParameters) == 0 ? TRUE : FALSE;
+}
+
+BOOL CAgoraObject::MuteAllRemoteVideo(BOOL bMuted)
+{
+	if (m_lpAgoraEngine == NULL)
+		return FALSE;
+
+	return m_lpAgoraEngine->muteAllRemoteVideoStreams(bMuted != FALSE) == 0 ? TRUE : FALSE;
+}
+
+BOOL CAgoraObject::MuteAllRemoteAudio(BOOL bMuted)
+{
+	if (m_lpAgoraEngine == NULL)
+		return FALSE;
+
+	return m_lpAgoraEngine->muteAllRemoteAudioStreams(bMuted != FALSE) == 0 ? TRUE : FALSE;
+}
+
+BOOL CAgoraObject::StopPreview()
+{
+	if (m_lpAgoraEngine == NULL)
+		return FALSE;
+
+	return m_lpAgoraEngine->stopPreview() == 0 ? TRUE : FALSE;
+}
+
+BOOL CAgoraObject::SetRecordingDevice(const char* lpDeviceId)
+{
+	if (m_lpAgoraEngine == NULL)
+		return FALSE;
+
+	AAudioDeviceManager adm(m_lpAgoraEngine);
+	if (adm.get() == NULL)
+		return FALSE;
+	int ret = adm->setRecordingDevice(lpDeviceId);
+	if (ret != 0)
+		LOG_ERROR("setRecordingDevice failed :%d", ret);
+	return ret == 0 ? TRUE : FALSE;
+}
+
+BOOL CAgoraObject::SetVideoDevice(const char* lpDeviceId)
+{
+	if (m_lpAgoraEngine == NULL)
+		return FALSE;
+
+	AVideoDeviceManager vdm(m_lpAgoraEngine);
+	if (vdm.get() == NULL)
+		return FALSE;
+	int ret = vdm->setDevice(lpDeviceId);
+	if (ret != 0)
+		LOG_ERROR("Video setDevice failed :%d", ret);
+	return ret == 0 ? TRUE : FALSE;
+}
+
+void CAgoraObject::LogRecordingDevices()
+{
+	if (m_lpAgoraEngine == NULL)
+		return;
+
+	AAudioDeviceManager adm(m_lpAgoraEngine);
+	IAudioDeviceCollection* adc = adm.get() != NULL ? adm->enumerateRecordingDevices() : NULL;
+	if (adc == NULL)
+		return;
+	char deviceName[MAX_DEVICE_ID_LENGTH] = { 0 };
+	char deviceId[MAX_DEVICE_ID_LENGTH] = { 0 };
+	SetConsoleOutputCP(65001);
+	LOG_INFO("Audio Recording Devices");
+	for (auto i = 0; i < adc->getCount(); i++)
+	{
+		adc->getDevice(i, deviceName, deviceId);
+		LOG_INFO("deviceName:%s deviceId:%s", deviceName, deviceId);
+	}
+	adc->release();
+}
+
+void CAgoraObject::LogVideoDevices()
+{
+	if (m_lpAgoraEngine == NULL)
+		return;
+
+	AVideoDeviceManager vdm(m_lpAgoraEngine);
+	IVideoDeviceCollection* vdc = vdm.get() != NULL ? vdm->enumerateVideoDevices() : NULL;
+	if (vdc == NULL)
+		return;
+	char deviceName[MAX_DEVICE_ID_LENGTH] = { 0 };
+	char deviceId[MAX_DEVICE_ID_LENGTH] = { 0 };
+	SetConsoleOutputCP(65001);
+	LOG_INFO("Video Devices");
+	for (auto i = 0; i < vdc->getCount(); i++)
+	{
+		vdc->getDevice(i, deviceName, deviceId);
+		LOG_INFO("deviceName:%s deviceId:%s", deviceName, deviceId);
+	}
+	vdc->release();
 }
\ No newline at end of file
@@ -0,0 +1,23 @@
+#include "AgoraStatsSchema.h"
+
+// the agora stats are integers except the cpu usage of RtcStats
+static const STATS_SCHEMA g_statsSchemas[] =
+{
+	{ STATS_LOCAL_VIDEO, "local_video", "uid", { STATS_I("sentBitrate"), STATS_I("sentFrameRate"), STATS_I("encoderOutputFrameRate"),
+		STATS_I("rendererOutputFrameRate"), STATS_I("targetBitrate"), STATS_I("targetFrameRate"), STATS_I("qualityAdaptIndication"),
+		STATS_I("encodedBitrate"), STATS_I("encodedFrameWidth"), STATS_I("encodedFrameHeight"), STATS_I("encodedFrameCount"),
+		STATS_I("codecType"), STATS_I("txPacketLossRate"), STATS_I("captureFrameRate"), STATS_I("videoQualityPoint"), { NULL, 0 } } },
+	{ STATS_REMOTE_VIDEO, "remote_video", "uid", { STATS_I("delay"), STATS_I("width"), STATS_I("height"), STATS_I("receivedBitrate"),
+		STATS_I("decoderOutputFrameRate"), STATS_I("rendererOutputFrameRate"), STATS_I("packetLossRate"), STATS_I("rxStreamType"),
+		STATS_I("totalFrozenTime"), STATS_I("frozenRate"), STATS_I("totalActiveTime"), STATS_I("publishDuration"), { NULL, 0 } } },
+	{ STATS_LOCAL_AUDIO, "local_audio", "uid", { STATS_I("numChannels"), STATS_I("sentSampleRate"), STATS_I("sentBitrate"),
+		STATS_I("txPacketLossRate"), { NULL, 0 } } },
+	{ STATS_REMOTE_AUDIO, "remote_audio", "uid", { STATS_I("quality"), STATS_I("networkTransportDelay"), STATS_I("jitterBufferDelay"),
+		STATS_I("audioLossRate"), STATS_I("numChannels"), STATS_I("receivedSampleRate"), STATS_I("receivedBitrate"),
+		STATS_I("totalFrozenTime"), STATS_I("frozenRate"), STATS_I("totalActiveTime"), STATS_I("publishDuration"), { NULL, 0 } } },
+	{ STATS_RTC, "rtc", "uid", { STATS_I("txKBitRate"), STATS_I("rxKBitRate"), STATS_I("txVideoKBitRate"), STATS_I("rxVideoKBitRate"),
+		STATS_I("lastmileDelay"), STATS_I("gatewayRtt"), STATS_I("txPacketLossRate"), STATS_I("rxPacketLossRate"), STATS_I("userCount"),
+		STATS_D("cpuAppUsage"), STATS_I("memoryAppUsageInKbytes"), { NULL, 0 } } },
+};
+
+const STATS_SCHEMA_SET g_agoraStatsSchemas = { "agora", g_statsSchemas, sizeof(g_statsSchemas) / sizeof(g_statsSchemas[0]) };
@@ -0,0 +1,94 @@
+#include "CommandQueue.h"
+#include "AgoraObject.h"
+#include "CircleBuffer.h"
+#include "Logger.h"
+#include "Singleton.h"
+
+RTC_DEFINE_SINGLETON(CCommandQueue)
+
+/**
+	post config items, they are checked here so a bad batch is refused
+	before anything reaches the engine
+Parameters:
+@param lpItems	items to copy into the queue
+@param nCount	number of items
+@return ticket of the last item, or a negative AGORA_CONFIG_RESULT
+*/
+int64_t CCommandQueue::PostConfig(const AGORA_CONFIG_ITEM* lpItems, int nCount)
+{
+	if (nCount <= 0 || lpItems == nullptr)
+		return AGORA_CONFIG_ERR_INVALID_ARG;
+
+	for (int i = 0; i < nCount; i++)
+	{
+		int nResult = CAgoraConfig::Validate(lpItems[i]);
+		if (nResult != AGORA_CONFIG_OK)
+			return nResult;
+	}
+
+	return PostItems(lpItems, nCount);
+}
+
+bool CCommandQueue::TakesText(int nType)
+{
+	return nType == ENGINE_COMMAND_SET_PARAMETERS || nType == ENGINE_COMMAND_RECORDING_DEVICE
+		|| nType == ENGINE_COMMAND_VIDEO_DEVICE;
+}
+
+int CCommandQueue::Execute(ENGINE_COMMAND& command)
+{
+	switch (command.nType)
+	{
+	case ENGINE_COMMAND_CONFIG:
+		return CAgoraConfig::Apply(command.item);
+	case ENGINE_COMMAND_CONFIG_BATCH:
+		return CAgoraConfig::ApplyBatch(command.lpItems, command.nCount);
+	case ENGINE_COMMAND_LEAVE_CHANNEL:
+		return CAgoraObject::GetAgoraObject(nullptr)->LeaveChannel() ? AGORA_CONFIG_OK : AGORA_CONFIG_ERR_SDK;
+	}
+
+	CAgoraObject* lpAgoraObject = CAgoraObject::GetAgoraObject(nullptr);
+	BOOL bResult = FALSE;
+	switch (command.nType)
+	{
+	case ENGINE_COMMAND_SET_PARAMETERS:
+		LOG_INFO("setParameters:%s", command.lpText);
+		bResult = lpAgoraObject->SetParameters(command.lpText);
+		break;
+	case ENGINE_COMMAND_MUTE_ALL_REMOTE_VIDEO:
+		bResult = lpAgoraObject->MuteAllRemoteVideo(TRUE);
+		break;
+	case ENGINE_COMMAND_MUTE_ALL_REMOTE_AUDIO:
+		bResult = lpAgoraObject->MuteAllRemoteAudio(TRUE);
+		break;
+	case ENGINE_COMMAND_STOP_PREVIEW:
+		bResult = lpAgoraObject->StopPreview();
+		break;
+	case ENGINE_COMMAND_CUSTOM_VIDEO_CAPTURE:
+		// the external camera index makes the SDK take its frames from the video observer
+		bResult = lpAgoraObject->SetParameters("{\"che.video.local.camera_index\":1024}")
+			&& lpAgoraObject->EnableCustomVideoCapture();
+		break;
+	case ENGINE_COMMAND_CUSTOM_AUDIO_CAPTURE:
+		CircleBuffer::GetInstance()->setAudioInfo(command.nArgs[0], command.nArgs[1]);
+		bResult = lpAgoraObject->EnableCustomAudioCapture();
+		break;
+	case ENGINE_COMMAND_RECORDING_DEVICE:
+		bResult = lpAgoraObject->SetRecordingDevice(command.lpText);
+		break;
+	case ENGINE_COMMAND_VIDEO_DEVICE:
+		bResult = lpAgoraObject->SetVideoDevice(command.lpText);
+		break;
+	case ENGINE_COMMAND_LOG_RECORDING_DEVICES:
+		lpAgoraObject->LogRecordingDevices();
+		bResult = TRUE;
+		break;
+	case ENGINE_COMMAND_LOG_VIDEO_DEVICES:
+		lpAgoraObject->LogVideoDevices();
+		bResult = TRUE;
+		break;
+	default:
+		return AGORA_CONFIG_ERR_TYPE;
+	}
+	return bResult ? AGORA_CONFIG_OK : AGORA_CONFIG_ERR_SDK;
+}
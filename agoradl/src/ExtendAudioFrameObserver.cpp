@@ -1,8 +1,11 @@
 #include "ExtendAudioFrameObserver.h"
-#include <chrono>
+#include "AudioRecorder.h"
+#include "MediaClock.h"
+#include <stdio.h>
 
 
 CExtendAudioFrameObserver::CExtendAudioFrameObserver()
+	: m_bCustomCapture(true)
 {
 }
 
@@ -13,12 +16,22 @@ CExtendAudioFrameObserver::~CExtendAudioFrameObserver()
 
 bool CExtendAudioFrameObserver::onRecordAudioFrame(AudioFrame& audioFrame)
 {
+	// the microphone goes out as it is
+	if (!m_bCustomCapture)
+		return true;
+
 	CircleBuffer::GetInstance()->getAudioInfo(audioFrame.samplesPerSec, audioFrame.channels);
 	unsigned int nSize = audioFrame.channels*audioFrame.samples * 2;
-    unsigned int readByte = 0;
-    int timestamp = timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
-    CircleBuffer::GetInstance()->readBuffer(audioFrame.buffer, nSize, &readByte, timestamp);
-    audioFrame.renderTimeMs = timestamp;
+	unsigned int readByte = 0;
+	int timestamp = (int)CMediaClock::NowMs();
+	LATENCY_STAMP stamp = { 0, 0, 0 };
+	// an underrun goes out as silence instead of the previous frame
+	bool bRead = CircleBuffer::GetInstance()->readBuffer(audioFrame.buffer, nSize, &readByte, stamp);
+	if (!bRead)
+		memset(audioFrame.buffer, 0, nSize);
+	audioFrame.renderTimeMs = timestamp;
+	if (bRead)
+		CLatencyStats::GetInstance()->RecordAudio(stamp, CMediaClock::NowNs());
 	return true;
 }
 
@@ -29,10 +42,18 @@ bool CExtendAudioFrameObserver::onPlaybackAudioFrame(AudioFrame& audioFrame)
 
 bool CExtendAudioFrameObserver::onMixedAudioFrame(AudioFrame& audioFrame)
 {
+	if (CAudioRecorder::IsRecording() && audioFrame.bytesPerSample == 2)
+		CAudioRecorder::GetInstance()->PutFrame("mixed", audioFrame.buffer, audioFrame.samples, audioFrame.channels, audioFrame.samplesPerSec);
 	return true;
 }
 
 bool CExtendAudioFrameObserver::onPlaybackAudioFrameBeforeMixing(unsigned int uid, AudioFrame& audioFrame)
 {
+	if (!CAudioRecorder::IsRecording() || audioFrame.bytesPerSample != 2)
+		return true;
+
+	char szUid[16];
+	snprintf(szUid, sizeof(szUid), "%u", uid);
+	CAudioRecorder::GetInstance()->PutFrame(szUid, audioFrame.buffer, audioFrame.samples, audioFrame.channels, audioFrame.samplesPerSec);
 	return true;
 }
@@ -1,9 +1,15 @@
 #include "ExtendVideoFrameObserver.h"
 
-#include <iostream>
+#include "Logger.h"
+#include "MediaClock.h"
+#include "VideoCompositor.h"
+#include "VideoFrameExport.h"
+#include <string>
 
 VIDEO_BUFFER		buffer;
 CExtendVideoFrameObserver::CExtendVideoFrameObserver()
+	: m_bCustomCapture(true)
+	, m_nLastPublishNs(0)
 {
 	m_lpImageBuffer = new BYTE[VIDEO_BUF_SIZE];
 }
@@ -19,15 +25,21 @@ CExtendVideoFrameObserver::~CExtendVideoFrameObserver()
 
 bool CExtendVideoFrameObserver::onCaptureVideoFrame(VideoFrame& videoFrame)
 {
+	// the camera frame goes out as it is
+	if (!m_bCustomCapture)
+		return true;
+
 	memset(videoFrame.yBuffer, 0, videoFrame.height*videoFrame.width);
 	memset(videoFrame.uBuffer, 128, videoFrame.height*videoFrame.width/4);
 	memset(videoFrame.vBuffer, 128, videoFrame.height*videoFrame.width/4);
-    if (CAgVideoBuffer::GetInstance()->readBuffer(m_lpImageBuffer, buffer.timestamp, videoFrame.width, videoFrame.height)) {
+    LATENCY_STAMP stamp = { 0, 0, 0 };
+    if (CAgVideoBuffer::GetInstance()->readBuffer(m_lpImageBuffer, stamp, videoFrame.width, videoFrame.height)) {
+        buffer.timestamp = (int)(stamp.nPublishNs / 1000000);
         int bufSize = videoFrame.width*videoFrame.height * 1.5;
         memcpy_s(buffer.m_lpImageBuffer, bufSize, m_lpImageBuffer, bufSize);
     }
     else
-        std::cout<<"readBuffer failed"<<std::endl;
+        LOG_WARN("readBuffer failed");
 
 	/*BOOL bSuccess = CVideoPackageQueue::GetInstance()->PopVideoPackage(m_lpImageBuffer, &nBufferSize);
 	if (!bSuccess)
@@ -47,10 +59,26 @@ bool CExtendVideoFrameObserver::onCaptureVideoFrame(VideoFrame& videoFrame)
 	videoFrame.type = FRAME_TYPE_YUV420;
 	videoFrame.rotation = 0;
 
+	// a repeated frame was handed over before, only its first handoff is latency
+	if (stamp.nPublishNs != 0 && stamp.nPublishNs != m_nLastPublishNs) {
+		m_nLastPublishNs = stamp.nPublishNs;
+		CLatencyStats::GetInstance()->RecordVideo(stamp, CMediaClock::NowNs());
+	}
 	return true;
 }
 
 bool CExtendVideoFrameObserver::onRenderVideoFrame(unsigned int uid, VideoFrame& videoFrame)
 {
+	CVideoCompositor* lpCompositor = CVideoCompositor::GetInstance();
+	CVideoFrameExport* lpExport = CVideoFrameExport::GetInstance();
+	if ((!lpCompositor->IsRunning() && !lpExport->IsRunning()) || videoFrame.type != FRAME_TYPE_YUV420)
+		return true;
+
+	std::string strUid = std::to_string(uid);
+	const BYTE* lpY = (const BYTE*)videoFrame.yBuffer;
+	const BYTE* lpU = (const BYTE*)videoFrame.uBuffer;
+	const BYTE* lpV = (const BYTE*)videoFrame.vBuffer;
+	lpCompositor->PutFrame(strUid, lpY, videoFrame.yStride, lpU, videoFrame.uStride, lpV, videoFrame.vStride, videoFrame.width, videoFrame.height);
+	lpExport->PutFrame(strUid, lpY, videoFrame.yStride, lpU, videoFrame.uStride, lpV, videoFrame.vStride, videoFrame.width, videoFrame.height);
 	return true;
 }
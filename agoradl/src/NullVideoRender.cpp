@@ -0,0 +1,38 @@
+#include "NullVideoRender.h"
+#include "Logger.h"
+#include "Singleton.h"
+
+CNullVideoRender::CNullVideoRender(void* hView)
+	: m_hView(hView)
+	, m_nFrames(0)
+{
+}
+
+// the SDK releases an instance when the canvas of its view is removed
+void CNullVideoRender::release()
+{
+	LOG_DEBUG("null renderer of view %p dropped %lld frames", m_hView, (long long)m_nFrames.load());
+	delete this;
+}
+
+int CNullVideoRender::initialize()
+{
+	return 0;
+}
+
+int CNullVideoRender::deliverFrame(const agora::media::IVideoFrame& /*videoFrame*/, int /*rotation*/, bool /*mirrored*/)
+{
+	m_nFrames.fetch_add(1, std::memory_order_relaxed);
+	return 0;
+}
+
+RTC_DEFINE_SINGLETON(CNullVideoRenderFactory)
+
+CNullVideoRenderFactory::CNullVideoRenderFactory()
+{
+}
+
+agora::media::IExternalVideoRender* CNullVideoRenderFactory::createRenderInstance(const agora::media::ExternalVideoRenerContext& context)
+{
+	return new CNullVideoRender(context.view);
+}
@@ -0,0 +1,272 @@
+#include "RemoteVideoSubscriber.h"
+#include "Logger.h"
+#include "MediaClock.h"
+#include <stdlib.h>
+
+static std::string UidKey(uid_t uid)
+{
+	return std::to_string(uid);
+}
+
+static uid_t KeyUid(const std::string& strKey)
+{
+	return (uid_t)strtoul(strKey.c_str(), NULL, 10);
+}
+
+static int64_t NowMs()
+{
+	return CMediaClock::NowUs() / 1000;
+}
+
+static REMOTE_VIDEO_STREAM_TYPE ViewStreamType(VHANDLE hView)
+{
+	return CAGExtInfoManager::GetAGExtInfoManager()->IsSmallView(hView) ? REMOTE_VIDEO_STREAM_LOW : REMOTE_VIDEO_STREAM_HIGH;
+}
+
+// the stream type in nFlags is the one the SDK was asked for
+static bool IsStreamSelected(const PARTICIPANT_INFO& info, REMOTE_VIDEO_STREAM_TYPE type)
+{
+	return (info.nFlags & PARTICIPANT_FLAG_STREAM_SELECTED) != 0
+		&& ((info.nFlags & PARTICIPANT_FLAG_LOW_STREAM) != 0) == (type == REMOTE_VIDEO_STREAM_LOW);
+}
+
+CRemoteVideoSubscriber::CRemoteVideoSubscriber()
+	: m_lpEngine(NULL)
+	, m_lpRegistry(CParticipantRegistry::GetInstance())
+{
+}
+
+/**
+	forget the users of the last channel and mute the video of every user of
+	the next one until it gets a view
+*/
+void CRemoteVideoSubscriber::Reset(IRtcEngine* lpEngine)
+{
+	Clear();
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_lpEngine = lpEngine;
+	}
+	m_lpRegistry->SetBatchHandler([this](const std::vector<PARTICIPANT_EVENT>& vecEvents) { OnBatch(vecEvents); });
+	lpEngine->setDefaultMuteAllRemoteVideoStreams(true);
+}
+
+void CRemoteVideoSubscriber::OnUserJoined(uid_t uid)
+{
+	m_lpRegistry->Post(PARTICIPANT_EVENT_JOINED, UidKey(uid));
+}
+
+void CRemoteVideoSubscriber::OnUserOffline(uid_t uid)
+{
+	m_lpRegistry->Post(PARTICIPANT_EVENT_LEFT, UidKey(uid));
+}
+
+// the joins and leaves of one PARTICIPANT_BATCH_MS, on the worker of the registry
+void CRemoteVideoSubscriber::OnBatch(const std::vector<PARTICIPANT_EVENT>& vecEvents)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (auto& event : vecEvents)
+	{
+		// posted for the channel before Clear
+		if (event.nGeneration != m_lpRegistry->GetGeneration() || m_lpEngine == NULL)
+			continue;
+		if (event.nType == PARTICIPANT_EVENT_JOINED)
+			Join(KeyUid(event.strId));
+		else
+			Leave(KeyUid(event.strId));
+	}
+}
+
+// under m_mutex
+void CRemoteVideoSubscriber::Join(uid_t uid)
+{
+	// a user that rejoins after a network drop keeps its place
+	std::string strKey = UidKey(uid);
+	if (m_lpRegistry->Contains(strKey))
+		return;
+
+	VHANDLE hView = CAGExtInfoManager::GetAGExtInfoManager()->GetOneFreeView();
+	PARTICIPANT_INFO info = { NULL, NULL, 0 };
+	if (!m_lpRegistry->Add(strKey, info))
+	{
+		if (hView != NULL)
+			CAGExtInfoManager::GetAGExtInfoManager()->FreeView(hView);
+		return;
+	}
+	m_scheduler.Add(strKey, hView != NULL, NowMs());
+	if (hView == NULL)
+	{
+		// the default mute already holds its video back
+		LOG_DEBUG("uid %u waits for a view", uid);
+		return;
+	}
+	Subscribe(uid, hView);
+}
+
+/**
+	under m_mutex, free the view of uid and hand it to the loudest waiting user
+*/
+void CRemoteVideoSubscriber::Leave(uid_t uid)
+{
+	std::string strKey = UidKey(uid);
+	PARTICIPANT_INFO info;
+	bool bKnown = m_lpRegistry->Get(strKey, info);
+	m_scheduler.Remove(strKey);
+	if (!bKnown)
+		return;
+
+	m_lpRegistry->Remove(strKey);
+	if (info.hView == NULL)
+		return;
+
+	std::string strNext;
+	if (!m_scheduler.PickWaiting(NowMs(), strNext))
+	{
+		CAGExtInfoManager::GetAGExtInfoManager()->FreeView(info.hView);
+		return;
+	}
+
+	LOG_DEBUG("uid %s takes the view of uid %u", strNext.c_str(), uid);
+	Subscribe(KeyUid(strNext), info.hView);
+}
+
+/**
+	the stats go to the registry without a lock, the lock is only taken when
+	the view of uid was resized across VIEW_HIGH_STREAM_MIN_WIDTH x
+	VIEW_HIGH_STREAM_MIN_HEIGHT
+*/
+void CRemoteVideoSubscriber::OnRemoteVideoStats(const RemoteVideoStats& stats)
+{
+	std::string strKey = UidKey(stats.uid);
+	m_lpRegistry->SetStat(strKey, PARTICIPANT_STAT_WIDTH, stats.width);
+	m_lpRegistry->SetStat(strKey, PARTICIPANT_STAT_HEIGHT, stats.height);
+	m_lpRegistry->SetStat(strKey, PARTICIPANT_STAT_VIDEO_KBPS, stats.receivedBitrate);
+	m_lpRegistry->SetStat(strKey, PARTICIPANT_STAT_VIDEO_FPS, stats.rendererOutputFrameRate);
+	m_lpRegistry->SetStat(strKey, PARTICIPANT_STAT_DELAY_MS, stats.delay);
+
+	PARTICIPANT_INFO info;
+	if (!m_lpRegistry->Get(strKey, info) || info.hView == NULL || IsStreamSelected(info, ViewStreamType(info.hView)))
+		return;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_lpEngine != NULL && m_lpRegistry->Get(strKey, info) && info.hView != NULL)
+	{
+		SelectStream(stats.uid, info);
+		m_lpRegistry->Update(strKey, info);
+	}
+}
+
+void CRemoteVideoSubscriber::OnRemoteAudioStats(const RemoteAudioStats& stats)
+{
+	m_lpRegistry->SetStat(UidKey(stats.uid), PARTICIPANT_STAT_AUDIO_KBPS, stats.receivedBitrate);
+}
+
+/**
+	smooth the levels and move views from the quiet users to the speakers
+Parameters:
+@param speakers	the loudest remote users, volume 0..255
+@param speakerNumber	number of speakers, 0 when nobody speaks
+*/
+void CRemoteVideoSubscriber::OnAudioVolumeIndication(const AudioVolumeInfo* speakers, unsigned int speakerNumber)
+{
+	// the local report comes in its own callback with only uid 0
+	if (speakerNumber == 1 && speakers[0].uid == 0)
+		return;
+
+	std::vector<std::pair<std::string, float>> vecLevels;
+	for (unsigned int i = 0; i < speakerNumber; i++)
+	{
+		if (speakers[i].uid == 0)
+			continue;
+		float fLevel = speakers[i].volume * 100.0f / 255;
+		vecLevels.push_back(std::make_pair(UidKey(speakers[i].uid), fLevel));
+		m_lpRegistry->SetStat(vecLevels.back().first, PARTICIPANT_STAT_AUDIO_LEVEL, (int32_t)fLevel);
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_lpEngine == NULL)
+		return;
+	m_scheduler.UpdateLevels(vecLevels);
+
+	std::vector<std::pair<std::string, std::string>> vecSwaps;
+	m_scheduler.Schedule(NowMs(), vecSwaps);
+	for (auto& swap : vecSwaps)
+	{
+		PARTICIPANT_INFO info;
+		if (!m_lpRegistry->Get(swap.first, info) || info.hView == NULL)
+			continue;
+
+		uid_t uidOut = KeyUid(swap.first);
+		uid_t uidIn = KeyUid(swap.second);
+		Unsubscribe(uidOut);
+		LOG_DEBUG("uid %u speaks, takes the view of uid %u", uidIn, uidOut);
+		Subscribe(uidIn, info.hView);
+	}
+}
+
+void CRemoteVideoSubscriber::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_lpRegistry->Clear();
+	m_scheduler.Clear();
+}
+
+bool CRemoteVideoSubscriber::IsKnown(uid_t uid)
+{
+	return m_lpRegistry->Contains(UidKey(uid));
+}
+
+// under m_mutex
+void CRemoteVideoSubscriber::Subscribe(uid_t uid, VHANDLE hView)
+{
+	std::string strKey = UidKey(uid);
+	PARTICIPANT_INFO info;
+	if (!m_lpRegistry->Get(strKey, info))
+		return;
+
+	info.hView = hView;
+	info.nFlags &= ~PARTICIPANT_FLAG_STREAM_SELECTED;
+	SelectStream(uid, info);
+
+	VideoCanvas canvas;
+	canvas.renderMode = RENDER_MODE_FIT;
+	canvas.uid = uid;
+	canvas.view = hView;
+	m_lpEngine->setupRemoteVideo(canvas);
+	m_lpEngine->muteRemoteVideoStream(uid, false);
+
+	info.hRenderView = hView;
+	info.nFlags = (info.nFlags | PARTICIPANT_FLAG_PLAYING) & ~PARTICIPANT_FLAG_VIDEO_MUTED;
+	m_lpRegistry->Update(strKey, info);
+}
+
+// under m_mutex, unbinds the view before an other user is drawn into it
+void CRemoteVideoSubscriber::Unsubscribe(uid_t uid)
+{
+	m_lpEngine->muteRemoteVideoStream(uid, true);
+
+	VideoCanvas canvas;
+	canvas.renderMode = RENDER_MODE_FIT;
+	canvas.uid = uid;
+	canvas.view = NULL;
+	m_lpEngine->setupRemoteVideo(canvas);
+
+	PARTICIPANT_INFO info = { NULL, NULL, PARTICIPANT_FLAG_VIDEO_MUTED };
+	m_lpRegistry->Update(UidKey(uid), info);
+}
+
+// under m_mutex, only calls the SDK when the stream changes, the caller updates the registry
+void CRemoteVideoSubscriber::SelectStream(uid_t uid, PARTICIPANT_INFO& info)
+{
+	REMOTE_VIDEO_STREAM_TYPE type = ViewStreamType(info.hView);
+	if (IsStreamSelected(info, type))
+		return;
+
+	info.nFlags |= PARTICIPANT_FLAG_STREAM_SELECTED;
+	if (type == REMOTE_VIDEO_STREAM_LOW)
+		info.nFlags |= PARTICIPANT_FLAG_LOW_STREAM;
+	else
+		info.nFlags &= ~PARTICIPANT_FLAG_LOW_STREAM;
+	m_lpEngine->setRemoteVideoStreamType(uid, type);
+	LOG_DEBUG("uid %u gets the %s stream", uid, type == REMOTE_VIDEO_STREAM_LOW ? "low" : "high");
+}
@@ -10,7 +10,15 @@
 
 #include <iostream>
 #include "AgoraObject.h"
+#include "AgoraConfig.h"
+#include "CommandQueue.h"
+#include "AgoraEvent.h"
+#include "AgoraBackend.h"
+#include "StatsRecorder.h"
+#include "Logger.h"
 #include "AGExtInfoManager.h"
+#include "AgoraChurnTarget.h"
+#include "JsonArgs.h"
 #include "json/json.h"
 using namespace std;
 
@@ -40,23 +48,20 @@ BOOL APIENTRY DllMain( HMODULE hModule,
 
 extern "C" void AGORADL_API HelloWorld()
 {
-	cout << "hello world" << endl;
+	LOG_INFO("hello world");
 }
 
 extern "C" void AGORADL_API createEngine(LPVOID lpExtInfo)
 {
-	cout << "createEngine" << endl;
-	string out;
-	CAgoraObject::GetAgoraObject((char*)lpExtInfo);
-	cout << out << endl;
+	LOG_INFO("createEngine");
+	CAgoraBackend::GetInstance()->CreateEngine((char*)lpExtInfo);
 }
 
 extern "C" void AGORADL_API destroyEngine()
 {
-	cout << "destroyEngine" << endl;
-	string out;
-	CAgoraObject::CloseAgoraObject();
-	cout << out << endl;
+	LOG_INFO("destroyEngine");
+	CAgoraBackend::GetInstance()->DestroyEngine();
+	CLogger::GetInstance()->Flush();
 }
 
 bool ParseJson(LPVOID lpExtInfo, Json::Value &root)
@@ -70,212 +75,339 @@ bool ParseJson(LPVOID lpExtInfo, Json::Value &root)
 		&err)) {
 		return false;
 	}
+	return root.isObject();
+}
+
+static bool JsonInt(const Json::Value &root, const char* lpKey, int32_t &nValue)
+{
+	int64_t nParsed = nValue;
+	if (!CJsonArgs::JsonInteger(root, lpKey, INT32_MIN, INT32_MAX, nParsed))
+		return false;
+	nValue = (int32_t)nParsed;
 	return true;
 }
-extern "C" void AGORADL_API joinChannel(LPVOID lpExtInfo)
+
+// "enable" is the string "true"/"false" or a json bool, missing means false
+static bool JsonEnable(const Json::Value &root, int32_t &bEnable)
+{
+	const Json::Value &value = root["enable"];
+	if (value.isBool())
+		bEnable = value.asBool() ? 1 : 0;
+	else if (value.isNull() || (value.isString() && value.asString() == "false"))
+		bEnable = 0;
+	else if (value.isString() && value.asString() == "true")
+		bEnable = 1;
+	else
+		return false;
+	return true;
+}
+
+static AGORA_CONFIG_ITEM MakeConfigItem(AGORA_CONFIG_TYPE type)
+{
+	AGORA_CONFIG_ITEM item;
+	memset(&item, 0, sizeof(item));
+	item.nType = type;
+	return item;
+}
+
+/**
+	version of the typed config ABI in AgoraConfig.h
+*/
+extern "C" int AGORADL_API getConfigAbiVersion()
+{
+	return AGORA_CONFIG_ABI_VERSION;
+}
+
+/**
+	sizeof(AGORA_CONFIG_ITEM), lets a ctypes mirror check its layout
+*/
+extern "C" int AGORADL_API getConfigItemSize()
+{
+	return sizeof(AGORA_CONFIG_ITEM);
+}
+
+/**
+	apply a batch of typed config items, see AgoraConfig.h. it runs on the
+	engine thread after whatever was posted before and blocks until it is done
+Parameters:
+@param nAbiVersion	AGORA_CONFIG_ABI_VERSION the caller was built against
+@param lpItems	array of AGORA_CONFIG_ITEM, nResult and nSdkError are filled in
+@param nCount	number of items
+@return AGORA_CONFIG_OK or the AGORA_CONFIG_RESULT of the first failed item
+*/
+extern "C" int AGORADL_API applyConfig(int nAbiVersion, AGORA_CONFIG_ITEM* lpItems, int nCount)
+{
+	if (nAbiVersion != AGORA_CONFIG_ABI_VERSION)
+		return AGORA_CONFIG_ERR_VERSION;
+	return CCommandQueue::GetInstance()->Run(lpItems, nCount);
+}
+
+/**
+	queue a batch of typed config items for the engine thread and return at once.
+	the items are copied, a bad field refuses the whole batch before it is queued.
+	a failed item skips the rest of its batch
+Parameters:
+@param nAbiVersion	AGORA_CONFIG_ABI_VERSION the caller was built against
+@param lpItems	array of AGORA_CONFIG_ITEM, left untouched
+@param nCount	number of items
+@return ticket (>0) for pollCommand/waitCommand, or a negative AGORA_CONFIG_RESULT
+*/
+extern "C" int64_t AGORADL_API postConfig(int nAbiVersion, const AGORA_CONFIG_ITEM* lpItems, int nCount)
+{
+	if (nAbiVersion != AGORA_CONFIG_ABI_VERSION)
+		return AGORA_CONFIG_ERR_VERSION;
+	return CCommandQueue::GetInstance()->PostConfig(lpItems, nCount);
+}
+
+/**
+	queue leaveChannel, returns its ticket
+*/
+extern "C" int64_t AGORADL_API postLeaveChannel()
+{
+	return CCommandQueue::GetInstance()->PostLeaveChannel();
+}
+
+/**
+	state of a posted command, never blocks
+@return AGORA_CONFIG_PENDING (1) while queued or running, else its AGORA_CONFIG_RESULT
+*/
+extern "C" int AGORADL_API pollCommand(int64_t nTicket)
+{
+	return CCommandQueue::GetInstance()->Poll(nTicket);
+}
+
+/**
+	wait for a posted command, commands finish in the order they were posted
+	so this also waits for everything posted before it
+Parameters:
+@param nTicket	ticket from a post* export
+@param nTimeoutMs	maximum time to wait, <0 waits forever
+@return its AGORA_CONFIG_RESULT, or AGORA_CONFIG_ERR_TIMEOUT
+*/
+extern "C" int AGORADL_API waitCommand(int64_t nTicket, int nTimeoutMs)
+{
+	return CCommandQueue::GetInstance()->Wait(nTicket, nTimeoutMs);
+}
+
+extern "C" int AGORADL_API getEventAbiVersion()
+{
+	return AGORA_EVENT_ABI_VERSION;
+}
+
+extern "C" int AGORADL_API getEventSize()
+{
+	return sizeof(AGORA_EVENT);
+}
+
+/**
+	drain the SDK events, never waits for new ones
+Parameters:
+@param lpEvents	array of nMax AGORA_EVENTs owned by the caller
+@param nMax	size of lpEvents
+@return number of events written, AGORA_CONFIG_ERR_INVALID_ARG for a bad buffer
+*/
+extern "C" int AGORADL_API pollEvents(AGORA_EVENT* lpEvents, int nMax)
+{
+	if (lpEvents == nullptr || nMax <= 0)
+		return AGORA_CONFIG_ERR_INVALID_ARG;
+	return CAgoraEventRing::GetInstance()->Poll(lpEvents, nMax);
+}
+
+/**
+	record the local/remote audio/video stats callbacks to a binary file until
+	stopStatsRecording, it keeps running across createEngine/destroyEngine.
+	stats_csv.py converts the file to csv
+Parameters:
+@param lpPath	file to create
+@return 0, or -1 when already recording or the file can not be created
+*/
+extern "C" int AGORADL_API startStatsRecording(const char* lpPath)
+{
+	return CStatsRecorder::GetInstance()->Start(lpPath, CAgoraBackend::GetInstance()->GetStatsSchemas());
+}
+
+/**
+	flush and close the stats file
+@return number of samples written, -1 when not recording
+*/
+extern "C" int64_t AGORADL_API stopStatsRecording()
+{
+	return CStatsRecorder::GetInstance()->Stop();
+}
+
+/**
+	{"channelId":"test","uid":"1"}
+	the json config exports below return an AGORA_CONFIG_RESULT
+*/
+extern "C" int AGORADL_API joinChannel(LPVOID lpExtInfo)
 {
 	Json::Value root;
-	ParseJson(lpExtInfo, root);
-	
+	if (!ParseJson(lpExtInfo, root))
+		return AGORA_CONFIG_ERR_INVALID_ARG;
+
+	AGORA_CONFIG_ITEM item = MakeConfigItem(AGORA_CONFIG_JOIN_CHANNEL);
+	int64_t nUID = -1;
 	auto channelName = root["channelId"].asString();
-	auto nUID = stoul(root["uid"].asString());
-	CAgoraObject::GetAgoraObject(nullptr)->JoinChannel(channelName.c_str(), nUID, nullptr);
+	if (!CJsonArgs::JsonInteger(root, "uid", 0, UINT32_MAX, nUID) || nUID < 0 || channelName.size() > AGORA_MAX_CHANNEL_ID)
+		return AGORA_CONFIG_ERR_INVALID_ARG;
+
+	item.config.join.nUID = (uint32_t)nUID;
+	strcpy_s(item.config.join.szChannelId, sizeof(item.config.join.szChannelId), channelName.c_str());
+	return CCommandQueue::GetInstance()->Run(&item, 1);
 }
 
-extern "C" void AGORADL_API leaveChannel()
+extern "C" int AGORADL_API waitJoinChannel(int timeoutMs)
 {
-	CAgoraObject::GetAgoraObject(nullptr)->LeaveChannel();
+	return CAgoraObject::GetAgoraObject(nullptr)->WaitJoinChannel(timeoutMs);
 }
 
-extern "C" void AGORADL_API enableVideo(LPVOID lpExtInfo)
+extern "C" int AGORADL_API leaveChannel()
 {
-	Json::Value root;
-	ParseJson(lpExtInfo, root);
+	return CCommandQueue::GetInstance()->RunLeaveChannel();
+}
 
-	auto enable = root["enable"].asString();
-	auto bEnable = enable == "true";
-	CAgoraObject::GetAgoraObject(nullptr)->EnableVideo(bEnable);
+extern "C" int AGORADL_API enableVideo(LPVOID lpExtInfo)
+{
+	Json::Value root;
+	AGORA_CONFIG_ITEM item = MakeConfigItem(AGORA_CONFIG_ENABLE_VIDEO);
+	if (!ParseJson(lpExtInfo, root) || !JsonEnable(root, item.config.enable.bEnable))
+		return AGORA_CONFIG_ERR_INVALID_ARG;
 
+	return CCommandQueue::GetInstance()->Run(&item, 1);
 }
 
-extern "C" void AGORADL_API enableAudio(LPVOID lpExtInfo)
+extern "C" int AGORADL_API enableAudio(LPVOID lpExtInfo)
 {
 	Json::Value root;
-	ParseJson(lpExtInfo, root);
+	AGORA_CONFIG_ITEM item = MakeConfigItem(AGORA_CONFIG_ENABLE_AUDIO);
+	if (!ParseJson(lpExtInfo, root) || !JsonEnable(root, item.config.enable.bEnable))
+		return AGORA_CONFIG_ERR_INVALID_ARG;
 
-	auto enable = root["enable"].asString();
-	auto bEnable = enable == "true";
-	if (bEnable)
-	{
-		CAgoraObject::GetAgoraObject(nullptr)->GetEngine()->enableAudio();
-	}
-	else
-	{
-		CAgoraObject::GetAgoraObject(nullptr)->GetEngine()->disableAudio();
-	}
-	
+	return CCommandQueue::GetInstance()->Run(&item, 1);
 }
 
+/**
+	the void exports below post their SDK call to the engine thread and return
+	at once, it runs after everything posted before. a failure is only logged
+*/
 extern "C" void AGORADL_API setParameters(LPVOID lpExtInfo)
 {
-	std::cout<<"setParameters:"<<(char*)lpExtInfo<<endl;
-	AParameter msp(CAgoraObject::GetAgoraObject(nullptr)->GetEngine());
-	msp->setParameters((char*)lpExtInfo);
+	CCommandQueue::GetInstance()->PostCommand(ENGINE_COMMAND_SET_PARAMETERS, (const char*)lpExtInfo);
 }
 
 
-extern "C" void AGORADL_API setVideoProfile(LPVOID lpExtInfo)
+// {"resolution":"640*480","bitrate":"1000","fps":"15"}, missing keys keep 360*640 600kbps 15fps
+extern "C" int AGORADL_API setVideoProfile(LPVOID lpExtInfo)
 {
 	Json::Value root;
-	ParseJson(lpExtInfo, root);
+	if (!ParseJson(lpExtInfo, root))
+		return AGORA_CONFIG_ERR_INVALID_ARG;
 
-	VideoEncoderConfiguration vec;
-	vec.dimensions.width = 360;
-	vec.dimensions.height = 640;
-	vec.frameRate = static_cast<FRAME_RATE>(15);
-	vec.bitrate = 600;
+	AGORA_CONFIG_ITEM item = MakeConfigItem(AGORA_CONFIG_VIDEO_PROFILE);
+	AGORA_VIDEO_PROFILE_CONFIG &profile = item.config.videoProfile;
+	profile.nWidth = 360;
+	profile.nHeight = 640;
+	profile.nFps = 15;
+	profile.nBitrate = 600;
 
 	if (!root["resolution"].isNull()) {
 		std::string sDimensions = root["resolution"].asString();
 		string::size_type pos = sDimensions.find("*");
-		if (pos < sDimensions.size())
-		{
-			std::string swidth = sDimensions.substr(0, pos);
-			std::string sheight = sDimensions.substr(pos + 1, sDimensions.size() - 1);
-			vec.dimensions.width = atoi(swidth.c_str());
-			vec.dimensions.height = atoi(sheight.c_str());
-		}
+		if (pos >= sDimensions.size())
+			return AGORA_CONFIG_ERR_INVALID_ARG;
+
+		int64_t nWidth = 0, nHeight = 0;
+		if (!CJsonArgs::ParseInteger(sDimensions.substr(0, pos), nWidth) || !CJsonArgs::ParseInteger(sDimensions.substr(pos + 1), nHeight)
+			|| nWidth < 1 || nWidth > AGORA_MAX_VIDEO_DIMENSION || nHeight < 1 || nHeight > AGORA_MAX_VIDEO_DIMENSION)
+			return AGORA_CONFIG_ERR_INVALID_ARG;
+		profile.nWidth = (int32_t)nWidth;
+		profile.nHeight = (int32_t)nHeight;
 	}
 
-	if (!root["bitrate"].isNull())
-	{
-		vec.bitrate = stoi(root["bitrate"].asString());
-	}
-	if (!root["fps"].isNull())
-	{
-		vec.frameRate = static_cast<FRAME_RATE>(stoi(root["fps"].asString()));
-	}
-	
-	CAgoraObject::GetAgoraObject(nullptr)->setVideoEncoderConfig(vec);
+	if (!JsonInt(root, "bitrate", profile.nBitrate) || !JsonInt(root, "fps", profile.nFps))
+		return AGORA_CONFIG_ERR_INVALID_ARG;
 
+	return CCommandQueue::GetInstance()->Run(&item, 1);
 }
 
 extern "C" void AGORADL_API addView(LPVOID lpExtInfo)
 {
-	CAGExtInfoManager::GetAGExtInfoManager()->AddView((AHANDLE)lpExtInfo);
+	CAGExtInfoManager::GetAGExtInfoManager()->AddView((VHANDLE)lpExtInfo);
 }
 
-extern "C" void AGORADL_API setChannelProfile(LPVOID lpExtInfo)
+extern "C" int AGORADL_API setChannelProfile(LPVOID lpExtInfo)
 {
-	
 	Json::Value root;
-	ParseJson(lpExtInfo, root);
+	AGORA_CONFIG_ITEM item = MakeConfigItem(AGORA_CONFIG_CHANNEL_PROFILE);
+	item.config.channelProfile.nProfile = CHANNEL_PROFILE_LIVE_BROADCASTING;
+	if (!ParseJson(lpExtInfo, root) || !JsonInt(root, "channelprofile", item.config.channelProfile.nProfile))
+		return AGORA_CONFIG_ERR_INVALID_ARG;
 
-	CHANNEL_PROFILE_TYPE profile = CHANNEL_PROFILE_LIVE_BROADCASTING;
-	if (!root["channelprofile"].isNull())
-	{
-		profile = (CHANNEL_PROFILE_TYPE)stoi(root["channelprofile"].asString());
-	}
-	
-	CAgoraObject::GetAgoraObject(nullptr)->GetEngine()->setChannelProfile(profile);
+	return CCommandQueue::GetInstance()->Run(&item, 1);
 }
 
-extern "C" void AGORADL_API setClientRole(LPVOID lpExtInfo)
+extern "C" int AGORADL_API setClientRole(LPVOID lpExtInfo)
 {
 	Json::Value root;
-	ParseJson(lpExtInfo, root);
-
-	CLIENT_ROLE_TYPE role = CLIENT_ROLE_BROADCASTER;
-	if (!root["clientrole"].isNull())
-	{
-		role = (CLIENT_ROLE_TYPE)stoi(root["clientrole"].asString());
-	}
+	AGORA_CONFIG_ITEM item = MakeConfigItem(AGORA_CONFIG_CLIENT_ROLE);
+	item.config.clientRole.nRole = CLIENT_ROLE_BROADCASTER;
+	if (!ParseJson(lpExtInfo, root) || !JsonInt(root, "clientrole", item.config.clientRole.nRole))
+		return AGORA_CONFIG_ERR_INVALID_ARG;
 
-	CAgoraObject::GetAgoraObject(nullptr)->GetEngine()->setClientRole(role);
+	return CCommandQueue::GetInstance()->Run(&item, 1);
 }
 
 extern "C" void AGORADL_API enumerateRecordingDevices()
 {
-	IRtcEngine *rtcEngine = CAgoraObject::GetAgoraObject(nullptr)->GetEngine();
-	AAudioDeviceManager *adm= new AAudioDeviceManager(rtcEngine);
-	IAudioDeviceCollection* adc = adm->get()->enumerateRecordingDevices();
-	char deviceName[MAX_DEVICE_ID_LENGTH] = { 0 };
-	char deviceId[MAX_DEVICE_ID_LENGTH] = { 0 };
-	SetConsoleOutputCP(65001);
-	cout <<"Audio Recording Devices"<<endl;
-	for (auto i = 0; i < adc->getCount(); i++)
-	{
-		adc->getDevice(i, deviceName, deviceId);
-		cout << "deviceName:" << deviceName << " deviceId:" << deviceId << endl;
-	}
+	CCommandQueue::GetInstance()->PostCommand(ENGINE_COMMAND_LOG_RECORDING_DEVICES);
 }
 
 extern "C" void AGORADL_API setRecordingDevice(LPVOID lpExtInfo)
 {
-	IRtcEngine *rtcEngine = CAgoraObject::GetAgoraObject(nullptr)->GetEngine();
-	AAudioDeviceManager *adm = new AAudioDeviceManager(rtcEngine);
-	if (auto res=adm->get()->setRecordingDevice((const char*)lpExtInfo) !=0 )
-	{
-		cout << "[error] setRecordingDevice failed :%d"<< res << endl;
-	}
+	CCommandQueue::GetInstance()->PostCommand(ENGINE_COMMAND_RECORDING_DEVICE, (const char*)lpExtInfo);
 }
 
-
 extern "C" void AGORADL_API enumerateVideoDevices()
 {
-	IRtcEngine *rtcEngine = CAgoraObject::GetAgoraObject(nullptr)->GetEngine();
-	AVideoDeviceManager *vdm = new AVideoDeviceManager(rtcEngine);
-	IVideoDeviceCollection* adc = vdm->get()->enumerateVideoDevices();
-	char deviceName[MAX_DEVICE_ID_LENGTH] = { 0 };
-	char deviceId[MAX_DEVICE_ID_LENGTH] = { 0 };
-	SetConsoleOutputCP(65001);
-	cout << "Video Devices" << endl;
-	for (auto i = 0; i < adc->getCount(); i++)
-	{
-		adc->getDevice(i, deviceName, deviceId);
-		cout << "deviceName:" << deviceName << " deviceId:" << deviceId << endl;
-	}
+	CCommandQueue::GetInstance()->PostCommand(ENGINE_COMMAND_LOG_VIDEO_DEVICES);
 }
 
 extern "C" void AGORADL_API setVideoDevice(LPVOID lpExtInfo)
 {
-	IRtcEngine *rtcEngine = CAgoraObject::GetAgoraObject(nullptr)->GetEngine();
-	AVideoDeviceManager *vdm = new AVideoDeviceManager(rtcEngine);
-	if (auto res = vdm->get()->setDevice((const char*)lpExtInfo) != 0)
-	{
-		cout << "[error] Video setDevice failed :%d" << res << endl;
-	}
+	CCommandQueue::GetInstance()->PostCommand(ENGINE_COMMAND_VIDEO_DEVICE, (const char*)lpExtInfo);
 }
 
 extern "C" void AGORADL_API  enableVideoCustomCap()
 {
-    agora::util::AutoPtr<agora::media::IMediaEngine> mediaEngine;
-    mediaEngine.queryInterface(CAgoraObject::GetAgoraObject(nullptr)->GetEngine(), agora::AGORA_IID_MEDIA_ENGINE);
-    /*
-    mediaEngine->setExternalVideoSource(true, false);
-    */
-    AParameter apm(CAgoraObject::GetAgoraObject(nullptr)->GetEngine());
-
-    apm->setParameters("{\"che.video.local.camera_index\":1024}");
-	mediaEngine->registerVideoFrameObserver(&CAgoraObject::m_CExtendVideoFrameObserver);
+	CCommandQueue::GetInstance()->PostCommand(ENGINE_COMMAND_CUSTOM_VIDEO_CAPTURE);
 }
 
+// a frame that does not fit the capture buffer is dropped, pushVideoFrameStrided reports it
 extern "C" void AGORADL_API pushVideoFrame(char *buff, int w, int h)
 {
-    CAgVideoBuffer::GetInstance()->writeBuffer((BYTE*)buff, w, h);
+	if (buff != nullptr)
+		CAgVideoBuffer::GetInstance()->writeBuffer((const BYTE*)buff, w, h, w);
 }
 
-
-extern "C" void AGORADL_API  enableAudioCustomCap(int nSampleRate, int nChannels)
+/**
+	pushVideoFrame for an I420 frame whose rows are not packed, e.g. a numpy
+	view into a larger image
+Parameters:
+@param buff	first row of the (h*3/2, w) frame
+@param nStride	bytes from one row to the next, at least w
+@return AGORA_CONFIG_OK, or AGORA_CONFIG_ERR_INVALID_ARG when the frame does not fit the capture buffer
+*/
+extern "C" int AGORADL_API pushVideoFrameStrided(const char* buff, int w, int h, int nStride)
 {
-	agora::util::AutoPtr<agora::media::IMediaEngine> mediaEngine;
-	mediaEngine.queryInterface(CAgoraObject::GetAgoraObject(nullptr)->GetEngine(), agora::AGORA_IID_MEDIA_ENGINE);
+	if (buff == nullptr || !CAgVideoBuffer::GetInstance()->writeBuffer((const BYTE*)buff, w, h, nStride))
+		return AGORA_CONFIG_ERR_INVALID_ARG;
+	return AGORA_CONFIG_OK;
+}
 
-	RtcEngineParameters rep(CAgoraObject::GetAgoraObject(nullptr)->GetEngine());
-//	rep.setExternalAudioSource(true, nSampleRate, nChannels);
 
-	CircleBuffer::GetInstance()->setAudioInfo(nSampleRate, nChannels);
-	mediaEngine->registerAudioFrameObserver(&CAgoraObject::m_CExtendAudioFrameObserver);
+extern "C" void AGORADL_API  enableAudioCustomCap(int nSampleRate, int nChannels)
+{
+	CCommandQueue::GetInstance()->PostCommand(ENGINE_COMMAND_CUSTOM_AUDIO_CAPTURE, nullptr, nSampleRate, nChannels);
 }
 
 extern "C" void AGORADL_API pushAudioFrame(char *buff, int size)
@@ -285,29 +417,75 @@ extern "C" void AGORADL_API pushAudioFrame(char *buff, int size)
 
 extern "C" void AGORADL_API muteAllRemoteVideoStreams()
 {
-	CAgoraObject::GetAgoraObject(nullptr)->GetEngine()->muteAllRemoteVideoStreams(true);
+	CCommandQueue::GetInstance()->PostCommand(ENGINE_COMMAND_MUTE_ALL_REMOTE_VIDEO);
 }
 
 extern "C" void AGORADL_API muteAllRemoteAudioStreams()
 {
-	CAgoraObject::GetAgoraObject(nullptr)->GetEngine()->muteAllRemoteAudioStreams(true);
+	CCommandQueue::GetInstance()->PostCommand(ENGINE_COMMAND_MUTE_ALL_REMOTE_AUDIO);
 }
 
 //在有高音质需求的场景（例如音乐教学场景）中，建议将 profile 设置为 AUDIO_PROFILE_MUSIC_HIGH_QUALITY (4)
 //，scenario 设置为 AUDIO_SCENARIO_GAME_STREAMING (3)。
-extern "C" void AGORADL_API setAudioProfile(int profile, int scenario)
+extern "C" int AGORADL_API setAudioProfile(int profile, int scenario)
 {
-	CAgoraObject::GetAgoraObject(nullptr)->GetEngine()->setAudioProfile((AUDIO_PROFILE_TYPE)profile, (AUDIO_SCENARIO_TYPE)scenario);
+	AGORA_CONFIG_ITEM item = MakeConfigItem(AGORA_CONFIG_AUDIO_PROFILE);
+	item.config.audioProfile.nProfile = profile;
+	item.config.audioProfile.nScenario = scenario;
+	return CCommandQueue::GetInstance()->Run(&item, 1);
 }
 
 extern "C" void AGORADL_API stopPreview()
 {
-	CAgoraObject::GetAgoraObject(nullptr)->GetEngine()->stopPreview();
+	CCommandQueue::GetInstance()->PostCommand(ENGINE_COMMAND_STOP_PREVIEW);
+}
+
+/**
+	join/leave churn benchmark, blocks until every cycle is done
+	{"channelId":"test","uid":"1","cycles":"100","holdms":"1000","timeoutms":"10000","output":"churn.hist"}
+	returns the number of failed cycles
+*/
+extern "C" int AGORADL_API runChurnBenchmark(LPVOID lpExtInfo)
+{
+	Json::Value root;
+	if (!ParseJson(lpExtInfo, root))
+		return -1;
+
+	auto channelName = root["channelId"].asString();
+	int64_t nUID = 0, nCycles = 100, nHoldMs = 1000, nTimeoutMs = 10000;
+	if (!CJsonArgs::JsonInteger(root, "uid", 0, UINT32_MAX, nUID) || !CJsonArgs::JsonInteger(root, "cycles", 1, INT32_MAX, nCycles)
+		|| !CJsonArgs::JsonInteger(root, "holdms", 0, INT32_MAX, nHoldMs) || !CJsonArgs::JsonInteger(root, "timeoutms", 1, INT32_MAX, nTimeoutMs))
+	{
+		LOG_ERROR("runChurnBenchmark: bad uid, cycles, holdms or timeoutms");
+		return -1;
+	}
+
+	CChurnBench *lpChurnBench = CChurnBench::GetInstance();
+	CAgoraChurnTarget target(channelName.c_str(), (unsigned int)nUID);
+	int nFailed = lpChurnBench->Run(&target, (int)nCycles, (int)nHoldMs, (int)nTimeoutMs);
+	// the report goes straight to cout, the lines logged during the run come first
+	CLogger::GetInstance()->Flush();
+	lpChurnBench->Report(cout);
+
+	if (!root["output"].isNull() && !lpChurnBench->Dump(root["output"].asString().c_str()))
+		LOG_ERROR("runChurnBenchmark can not write %s", root["output"].asString().c_str());
+
+	return nFailed;
 }
 
 extern "C" void AGORADL_API logOff()
 {
-	g_Logon = false;
+	CLogger::SetLevel(LOG_LEVEL_OFF);
+}
+
+/**
+	print the wrapper log from nLevel up, info by default
+Parameters:
+@param nLevel	LOG_LEVEL, 0 debug 1 info 2 warn 3 error 4 off
+*/
+extern "C" void AGORADL_API setLogLevel(int nLevel)
+{
+	CLogger::SetLevel(nLevel);
 }
 
 
@@ -1,7 +1,11 @@
 #pragma once
 #include "../agora/include/IAgoraRtcEngine.h"
 #include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 #include "types.h"
+#include "RemoteVideoSubscriber.h"
 using namespace agora::rtc;
 
 
@@ -13,8 +17,11 @@ public:
 	CAGEngineEventHandler(void);
 	~CAGEngineEventHandler(void);
 
-	void SetMsgReceiver(HWND hWnd = NULL);
-	HWND GetMsgReceiver() { return m_hMainWnd; };
+	void ResetJoinState();
+	// mute every remote video until CRemoteVideoSubscriber gives the user a view
+	void ResetSubscriptions(IRtcEngine* lpEngine);
+	int WaitJoinChannel(int nTimeoutMs);
+	bool WaitLeaveChannel(int nTimeoutMs);
 
 	virtual void onJoinChannelSuccess(const char* channel, uid_t uid, int elapsed);
 	virtual void onRejoinChannelSuccess(const char* channel, uid_t uid, int elapsed);
@@ -59,6 +66,11 @@ public:
 private:
 	void clearViews();
 private:
-	HWND		m_hMainWnd;
-	std::unordered_map<int, void*> m_mapViews;
+	CRemoteVideoSubscriber m_subscriber;
+
+	std::mutex	m_joinMutex;
+	std::condition_variable m_joinCond;
+	bool		m_bJoined = false;
+	bool		m_bLeft = false;
+	int			m_nJoinElapsed = -1;
 };
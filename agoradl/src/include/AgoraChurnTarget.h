@@ -0,0 +1,24 @@
+#pragma once
+#include "ChurnBench.h"
+#include "types.h"
+#include <string>
+
+/**
+	the CChurnBench join/leave of CAgoraObject, JoinChannel waits for
+	onJoinChannelSuccess and LeaveChannel for onLeaveChannel
+*/
+class CAgoraChurnTarget : public IChurnTarget
+{
+public:
+	CAgoraChurnTarget(const char* lpChannelName, UINT nUID);
+
+	virtual const char* GetName() override { return "agora"; }
+	virtual void Join() override;
+	virtual bool WaitJoin(int nTimeoutMs) override;
+	virtual void Leave() override;
+	virtual int WaitLeave(int nTimeoutMs) override;
+
+private:
+	std::string	m_strChannelName;
+	UINT		m_nUID;
+};
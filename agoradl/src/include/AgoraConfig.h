@@ -0,0 +1,131 @@
+#pragma once
+#include <stdint.h>
+
+/**
+	typed C ABI of the config exports. everything here is plain C so ctypes
+	mirrors it field by field, no json is parsed and nothing is allocated on
+	the way to the SDK.
+	bump AGORA_CONFIG_ABI_VERSION whenever a struct below changes its layout,
+	applyConfig refuses a batch built against another version
+*/
+#define AGORA_CONFIG_ABI_VERSION	1
+
+// agora channel names are at most 64 bytes
+#define AGORA_MAX_CHANNEL_ID		64
+
+#define AGORA_MAX_VIDEO_DIMENSION	4096
+#define AGORA_MAX_VIDEO_FPS			60
+
+enum AGORA_CONFIG_RESULT
+{
+	AGORA_CONFIG_PENDING = 1,			// pollCommand: still queued or running
+	AGORA_CONFIG_OK = 0,
+	AGORA_CONFIG_ERR_VERSION = -1,		// built against another AGORA_CONFIG_ABI_VERSION
+	AGORA_CONFIG_ERR_TYPE = -2,			// unknown nType
+	AGORA_CONFIG_ERR_INVALID_ARG = -3,	// a field is out of range, or the json did not parse
+	AGORA_CONFIG_ERR_SDK = -4,			// the SDK call failed, nSdkError holds its return value
+	AGORA_CONFIG_ERR_SKIPPED = -5,		// not applied, an earlier item of the batch failed
+	AGORA_CONFIG_ERR_TIMEOUT = -6,		// waitCommand gave up, the command stays queued
+	AGORA_CONFIG_ERR_EXPIRED = -7,		// the command ran, its result was overwritten by later ones
+};
+
+enum AGORA_CONFIG_TYPE
+{
+	AGORA_CONFIG_VIDEO_PROFILE = 1,		// setVideoEncoderConfiguration
+	AGORA_CONFIG_ENABLE_VIDEO,			// enableVideo / disableVideo
+	AGORA_CONFIG_ENABLE_AUDIO,			// enableAudio / disableAudio
+	AGORA_CONFIG_CHANNEL_PROFILE,		// setChannelProfile
+	AGORA_CONFIG_CLIENT_ROLE,			// setClientRole
+	AGORA_CONFIG_AUDIO_PROFILE,			// setAudioProfile
+	AGORA_CONFIG_JOIN_CHANNEL,			// joinChannel, keep it last in a batch
+	AGORA_CONFIG_DUAL_STREAM,			// enableDualStreamMode
+	AGORA_CONFIG_HEADLESS,				// null renderer and no preview, before joinChannel
+	AGORA_CONFIG_REMOTE_VIDEO_FRAMES,	// onRenderVideoFrame feeds CVideoCompositor, before joinChannel
+	AGORA_CONFIG_AUDIO_SINK,			// setExternalAudioSink, the playout is pulled by CAudioSink, before joinChannel
+	AGORA_CONFIG_AUDIO_RECORDING,		// the audio observer copies every user before mixing and the mix into CAudioRecorder
+};
+
+typedef struct _AGORA_VIDEO_PROFILE_CONFIG
+{
+	int32_t nWidth;
+	int32_t nHeight;
+	int32_t nFps;
+	int32_t nBitrate;	// kbps, 0 is STANDARD_BITRATE and -1 COMPATIBLE_BITRATE
+} AGORA_VIDEO_PROFILE_CONFIG;
+
+typedef struct _AGORA_ENABLE_CONFIG
+{
+	int32_t bEnable;
+} AGORA_ENABLE_CONFIG;
+
+typedef struct _AGORA_CHANNEL_PROFILE_CONFIG
+{
+	int32_t nProfile;	// CHANNEL_PROFILE_TYPE
+} AGORA_CHANNEL_PROFILE_CONFIG;
+
+typedef struct _AGORA_CLIENT_ROLE_CONFIG
+{
+	int32_t nRole;		// CLIENT_ROLE_TYPE
+} AGORA_CLIENT_ROLE_CONFIG;
+
+typedef struct _AGORA_AUDIO_PROFILE_CONFIG
+{
+	int32_t nProfile;	// AUDIO_PROFILE_TYPE
+	int32_t nScenario;	// AUDIO_SCENARIO_TYPE
+} AGORA_AUDIO_PROFILE_CONFIG;
+
+typedef struct _AGORA_AUDIO_SINK_CONFIG
+{
+	int32_t bEnable;
+	int32_t nSampleRate;	// 8000, 16000, 32000, 44100 or 48000
+	int32_t nChannels;		// 1 or 2
+} AGORA_AUDIO_SINK_CONFIG;
+
+typedef struct _AGORA_AUDIO_RECORDING_CONFIG
+{
+	int32_t bEnable;
+	int32_t nSampleRate;	// of the mix, 8000, 16000, 32000, 44100 or 48000. the users come as decoded
+} AGORA_AUDIO_RECORDING_CONFIG;
+
+typedef struct _AGORA_JOIN_CONFIG
+{
+	uint32_t nUID;
+	char szChannelId[AGORA_MAX_CHANNEL_ID + 1];
+} AGORA_JOIN_CONFIG;
+
+/**
+	one entry of an applyConfig batch, nType selects the member of config.
+	nResult and nSdkError are written back by applyConfig
+*/
+typedef struct _AGORA_CONFIG_ITEM
+{
+	int32_t nType;		// AGORA_CONFIG_TYPE
+	int32_t nResult;	// AGORA_CONFIG_RESULT
+	int32_t nSdkError;	// return value of the SDK call, 0 when it was not reached
+	union
+	{
+		AGORA_VIDEO_PROFILE_CONFIG videoProfile;
+		AGORA_ENABLE_CONFIG enable;
+		AGORA_CHANNEL_PROFILE_CONFIG channelProfile;
+		AGORA_CLIENT_ROLE_CONFIG clientRole;
+		AGORA_AUDIO_PROFILE_CONFIG audioProfile;
+		AGORA_JOIN_CONFIG join;
+		AGORA_AUDIO_SINK_CONFIG audioSink;
+		AGORA_AUDIO_RECORDING_CONFIG audioRecording;
+	} config;
+} AGORA_CONFIG_ITEM;
+
+#ifdef __cplusplus
+/**
+	checks and applies AGORA_CONFIG_ITEMs. a batch is validated as a whole
+	first so a bad field leaves the engine untouched, then applied in order
+	up to the first SDK failure
+*/
+class CAgoraConfig
+{
+public:
+	static int Validate(const AGORA_CONFIG_ITEM& item);
+	static int Apply(AGORA_CONFIG_ITEM& item);
+	static int ApplyBatch(AGORA_CONFIG_ITEM* lpItems, int nCount);
+};
+#endif
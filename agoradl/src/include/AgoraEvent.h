@@ -0,0 +1,103 @@
+#pragma once
+#include <stdint.h>
+
+/**
+	typed C ABI of the SDK events. the event handler writes one fixed size
+	record per callback into a preallocated ring, python drains it in batches
+	with pollEvents. nothing is allocated and no SDK thread ever waits on the
+	way in, a full ring drops the event and counts it.
+	bump AGORA_EVENT_ABI_VERSION whenever AGORA_EVENT changes its layout
+*/
+#define AGORA_EVENT_ABI_VERSION		1
+
+// power of two, 4096 records are 512KB
+#define AGORA_EVENT_CAPACITY		4096
+
+// bytes of szText including the terminating 0
+#define AGORA_EVENT_TEXT			96
+
+/**
+	nUID is the remote user of the event, 0 for local ones. the nArgs and
+	szText of every type are listed next to it
+*/
+enum AGORA_EVENT_TYPE
+{
+	AGORA_EVENT_DROPPED = 1,				// nArgs[0] events lost since the last poll, the ring was full
+	AGORA_EVENT_JOIN_CHANNEL_SUCCESS,		// nArgs[0] elapsed, szText channel
+	AGORA_EVENT_REJOIN_CHANNEL_SUCCESS,		// nArgs[0] elapsed, szText channel
+	AGORA_EVENT_WARNING,					// nArgs[0] warn, szText msg
+	AGORA_EVENT_ERROR,						// nArgs[0] err, szText msg
+	AGORA_EVENT_AUDIO_QUALITY,				// nArgs[0] quality, [1] delay, [2] lost
+	AGORA_EVENT_AUDIO_VOLUME_INDICATION,	// one per speaker, nArgs[0] volume, [1] vad, [2] totalVolume
+	AGORA_EVENT_LEAVE_CHANNEL,				// nArgs[0] duration (s), [1] txKBitRate, [2] rxKBitRate, [3] userCount
+	AGORA_EVENT_MEDIA_ENGINE_EVENT,			// nArgs[0] evt
+	AGORA_EVENT_AUDIO_DEVICE_STATE_CHANGED,	// nArgs[0] deviceType, [1] deviceState, szText deviceId
+	AGORA_EVENT_VIDEO_DEVICE_STATE_CHANGED,	// nArgs[0] deviceType, [1] deviceState, szText deviceId
+	AGORA_EVENT_LASTMILE_QUALITY,			// nArgs[0] quality
+	AGORA_EVENT_FIRST_LOCAL_VIDEO_FRAME,	// nArgs[0] width, [1] height, [2] elapsed
+	AGORA_EVENT_FIRST_REMOTE_VIDEO_DECODED,	// nArgs[0] width, [1] height, [2] elapsed
+	AGORA_EVENT_FIRST_REMOTE_VIDEO_FRAME,	// nArgs[0] width, [1] height, [2] elapsed
+	AGORA_EVENT_USER_JOINED,				// nArgs[0] elapsed
+	AGORA_EVENT_USER_OFFLINE,				// nArgs[0] USER_OFFLINE_REASON_TYPE
+	AGORA_EVENT_USER_MUTE_AUDIO,			// nArgs[0] muted
+	AGORA_EVENT_USER_MUTE_VIDEO,			// nArgs[0] muted
+	AGORA_EVENT_STREAM_MESSAGE,				// nArgs[0] streamId, [1] length, szText the first bytes of data, not terminated
+	AGORA_EVENT_APICALL_EXECUTED,			// nArgs[0] error, szText api
+	AGORA_EVENT_LOCAL_VIDEO_STAT,			// nArgs[0] sentBitrate, [1] sentFrameRate, [2] encodedFrameWidth, [3] encodedFrameHeight
+	AGORA_EVENT_REMOTE_VIDEO_STAT,			// nArgs[0] width, [1] height, [2] receivedBitrate, [3] decoderOutputFrameRate
+	AGORA_EVENT_CAMERA_READY,
+	AGORA_EVENT_VIDEO_STOPPED,
+	AGORA_EVENT_CONNECTION_LOST,
+	AGORA_EVENT_CONNECTION_INTERRUPTED,
+	AGORA_EVENT_USER_ENABLE_VIDEO,			// nArgs[0] enabled
+	AGORA_EVENT_START_RECORDING_SERVICE,	// nArgs[0] error
+	AGORA_EVENT_STOP_RECORDING_SERVICE,		// nArgs[0] error
+	AGORA_EVENT_RECORDING_SERVICE_STATUS,	// nArgs[0] status
+};
+
+// 128 bytes, no padding on any of the targets
+typedef struct _AGORA_EVENT
+{
+	int32_t nType;			// AGORA_EVENT_TYPE
+	uint32_t nUID;
+	int64_t nTimestampUs;	// CMediaClock time the callback arrived
+	int32_t nArgs[4];
+	char szText[AGORA_EVENT_TEXT];
+} AGORA_EVENT;
+
+#ifdef __cplusplus
+#include "DropRing.h"
+#include <mutex>
+
+/**
+	AGORA_EVENTs on a CDropRing. the SDK threads never wait for the reader:
+	when the ring is full the event is dropped and the next poll starts with
+	an AGORA_EVENT_DROPPED.
+	the records are allocated once with the ring, GetInstance is called from
+	createEngine so that happens before the first callback
+*/
+class CAgoraEventRing
+{
+public:
+	static CAgoraEventRing* GetInstance();
+
+	// fills nType, nUID and nTimestampUs, zeroes the rest
+	static void Init(AGORA_EVENT& event, int nType, uint32_t nUID);
+	// copies at most AGORA_EVENT_TEXT - 1 bytes and terminates, lpText may be NULL
+	static void SetText(AGORA_EVENT& event, const char* lpText);
+
+	// called on the SDK threads, false when the ring is full and the event was dropped
+	bool Push(const AGORA_EVENT& event) { return m_ring.Push(event); }
+	int Poll(AGORA_EVENT* lpEvents, int nMax);
+	uint64_t GetDropped() { return m_ring.GetDropped(); }
+
+private:
+	CAgoraEventRing();
+
+	CDropRing<AGORA_EVENT, AGORA_EVENT_CAPACITY> m_ring;
+
+	// the reader side, python may poll from more than one thread
+	std::mutex m_lockPoll;
+	uint64_t m_nDroppedReported;
+};
+#endif
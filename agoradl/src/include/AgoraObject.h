@@ -2,7 +2,9 @@
 #include "../agora/include/IAgoraRtcEngine.h"
 #include "../agora/include/IAgoraMediaEngine.h"
 #include "../agora/include/IAgoraRtcChannel.h"
-#ifdef _M_IX86
+#ifdef AGORADL_MOCK_SDK
+// createAgoraRtcEngine comes from mock/MockRtcEngine.cpp
+#elif defined _M_IX86
 #pragma comment(lib, "../agora/lib/agora_rtc_sdk.lib")
 #elif defined _M_X64
 #pragma comment(lib, "../agora/lib/x64/agora_rtc_sdk.lib")
@@ -18,7 +20,6 @@
 //#include "AgoraPlayoutManager.h"
 //#include "AgoraCameraManager.h"
 //#include "ExtendVideoFrameObserver.h"
-#include <atlcoll.h>
 //#include "AudioPlayPackageQueue.h"
 #include <map>
 #include <string>
@@ -39,23 +40,32 @@ using namespace agora;
 
 using namespace agora::rtc;
 
-extern std::atomic<bool> g_Logon;
-
 class CAgoraObject
 {
 public:
 	~CAgoraObject(void);
 
-	void SetMsgHandlerWnd(AHANDLE hWnd);
-	AHANDLE GetMsgHandlerWnd();
-
 	BOOL JoinChannel(const char* lpChannelName, UINT nUID = 0, const char* lpToken = NULL);
+	int WaitJoinChannel(int nTimeoutMs);
 	BOOL LeaveChannel();
+	bool WaitLeaveChannel(int nTimeoutMs);
 	string GetChanelName();
 
 	BOOL EnableVideo(BOOL bEnable = TRUE);
 	BOOL IsVideoEnabled();
 
+	BOOL EnableDualStream(BOOL bEnable = TRUE);
+	BOOL EnableHeadless(BOOL bEnable = TRUE);
+	BOOL IsHeadless();
+	// the two users of m_CExtendVideoFrameObserver, it stays registered while one of them is on
+	BOOL EnableCustomVideoCapture(BOOL bEnable = TRUE);
+	BOOL EnableRemoteVideoFrames(BOOL bEnable = TRUE);
+	// the two users of m_CExtendAudioFrameObserver, it stays registered while one of them is on
+	BOOL EnableCustomAudioCapture(BOOL bEnable = TRUE);
+	BOOL EnableAudioRecording(BOOL bEnable, int nSampleRate);
+	BOOL EnableAudioSink(BOOL bEnable, int nSampleRate, int nChannels);
+	BOOL PullAudioFrame(int16_t* lpPcm, int nSamples, int nSampleRate, int nChannels);
+
 	BOOL setVideoEncoderConfig(const VideoEncoderConfiguration &config);
 
 	BOOL MuteLocalAudio(BOOL bMuted = TRUE);
@@ -64,6 +74,17 @@ public:
 	BOOL MuteLocalVideo(BOOL bMuted = TRUE);
 	BOOL IsLocalVideoMuted();
 
+	// run by CCommandQueue on the engine thread
+	BOOL SetParameters(const char* lpParameters);
+	BOOL MuteAllRemoteVideo(BOOL bMuted = TRUE);
+	BOOL MuteAllRemoteAudio(BOOL bMuted = TRUE);
+	BOOL StopPreview();
+	BOOL SetRecordingDevice(const char* lpDeviceId);
+	BOOL SetVideoDevice(const char* lpDeviceId);
+	// logs name and id of every device
+	void LogRecordingDevices();
+	void LogVideoDevices();
+
 	static IRtcEngine *GetEngine();
 
 	static string GetSDKVersion();
@@ -78,12 +99,21 @@ private:
 
 	string		m_strChannelName;
 	BOOL		m_bVideoEnable;
+	BOOL		m_bDualStream;
+	BOOL		m_bHeadless;
+	BOOL		m_bCustomVideoCapture;
+	BOOL		m_bRemoteVideoFrames;
+	BOOL		m_bCustomAudioCapture;
+	BOOL		m_bAudioRecording;
 
 	BOOL		m_bLocalAudioMuted;
 	BOOL		m_bLocalVideoMuted;
 
 	void*       m_localView = nullptr;
 
+	BOOL UpdateVideoFrameObserver();
+	BOOL UpdateAudioFrameObserver();
+
 public:
 	static CAgoraObject *GetAgoraObject(char* lpVendorKey);
 	static void CloseAgoraObject();
@@ -0,0 +1,17 @@
+#pragma once
+#include "StatsRecorder.h"
+
+enum STATS_KIND
+{
+	STATS_LOCAL_VIDEO = 1,	// LocalVideoStats
+	STATS_REMOTE_VIDEO,		// RemoteVideoStats, keyed by uid
+	STATS_LOCAL_AUDIO,		// LocalAudioStats
+	STATS_REMOTE_AUDIO,		// RemoteAudioStats, keyed by uid
+	STATS_RTC,				// RtcStats, the whole call
+};
+
+/**
+	the columns of every kind, the callbacks in AGEngineEventHandler.cpp fill
+	nValues in this order
+*/
+extern const STATS_SCHEMA_SET g_agoraStatsSchemas;
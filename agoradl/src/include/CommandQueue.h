@@ -0,0 +1,42 @@
+#pragma once
+#include "AgoraConfig.h"
+#include "EngineQueue.h"
+
+enum ENGINE_COMMAND_TYPE
+{
+	ENGINE_COMMAND_SET_PARAMETERS = ENGINE_COMMAND_VENDOR,	// lpText, the json of setParameters
+	ENGINE_COMMAND_MUTE_ALL_REMOTE_VIDEO,
+	ENGINE_COMMAND_MUTE_ALL_REMOTE_AUDIO,
+	ENGINE_COMMAND_STOP_PREVIEW,
+	ENGINE_COMMAND_CUSTOM_VIDEO_CAPTURE,
+	ENGINE_COMMAND_RECORDING_DEVICE,		// lpText, the device id
+	ENGINE_COMMAND_VIDEO_DEVICE,			// lpText, the device id
+	ENGINE_COMMAND_LOG_RECORDING_DEVICES,
+	ENGINE_COMMAND_LOG_VIDEO_DEVICES,
+	ENGINE_COMMAND_CUSTOM_AUDIO_CAPTURE,	// nArgs, sample rate and channels
+};
+
+static_assert((int)AGORA_CONFIG_PENDING == ENGINE_PENDING && (int)AGORA_CONFIG_ERR_EXPIRED == ENGINE_ERR_EXPIRED,
+	"the queue reports AGORA_CONFIG_RESULT");
+
+/**
+	the agora engine thread. every config export posts its command here, so
+	the python threads never sit in a slow SDK call.
+	createEngine/destroyEngine stay on the caller thread, destroyEngine stops
+	the executor after it has drained the queue
+*/
+class CCommandQueue : public CEngineQueue<AGORA_CONFIG_ITEM>
+{
+public:
+	static CCommandQueue* GetInstance();
+
+	// >0 ticket, <0 AGORA_CONFIG_RESULT when the batch is refused before posting
+	int64_t PostConfig(const AGORA_CONFIG_ITEM* lpItems, int nCount);
+
+protected:
+	int Execute(ENGINE_COMMAND& command) override;
+	bool TakesText(int nType) override;
+
+private:
+	CCommandQueue() {}
+};
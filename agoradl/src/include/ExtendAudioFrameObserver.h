@@ -1,6 +1,7 @@
 #pragma once
 #include "../agora/include/IAgoraMediaEngine.h"
-#include "CirCleBuffer.h"
+#include "CircleBuffer.h"
+#include <atomic>
 //#include "XAudioPlayout.h"
 
 class CExtendAudioFrameObserver :
@@ -12,7 +13,15 @@ public:
 
 	virtual bool onRecordAudioFrame(AudioFrame& audioFrame);
 	virtual bool onPlaybackAudioFrame(AudioFrame& audioFrame);
+	// the mix of the recorded and the played audio, and every remote user
+	// before mixing, copied into CAudioRecorder while it records
 	virtual bool onMixedAudioFrame(AudioFrame& audioFrame);
 	virtual bool onPlaybackAudioFrameBeforeMixing(unsigned int uid, AudioFrame& audioFrame);
+
+	// on by default, off when the observer is only registered for the recording
+	void EnableCustomCapture(bool bEnable) { m_bCustomCapture = bEnable; }
+
+private:
+	std::atomic<bool>	m_bCustomCapture;
 };
 
@@ -3,6 +3,7 @@
 #include "types.h"
 //#include "VideoPackageQueue.h"
 #include "AgVideoBuffer.h"
+#include <atomic>
 typedef struct _VIDEO_BUFFER {
     BYTE m_lpImageBuffer[VIDEO_BUF_SIZE];
     int  timestamp;
@@ -16,9 +17,16 @@ public:
 
 	virtual bool onCaptureVideoFrame(VideoFrame& videoFrame);
     virtual VIDEO_FRAME_TYPE getVideoFormatPreference() { return FRAME_TYPE_YUV420; }
+	// every decoded remote frame, drawn into CVideoCompositor while it runs
 	virtual bool onRenderVideoFrame(unsigned int uid, VideoFrame& videoFrame);
 
+	// on by default, off when the observer is only registered for the remote frames
+	void EnableCustomCapture(bool bEnable) { m_bCustomCapture = bEnable; }
+
 private:
+    std::atomic<bool>	m_bCustomCapture;
     BYTE*				m_lpImageBuffer;
+    // the frame read last, the SDK asks again at its own frame rate
+    int64_t				m_nLastPublishNs;
 };
 
@@ -0,0 +1,34 @@
+#pragma once
+#include "../agora/include/IAgoraMediaEngine.h"
+#include <atomic>
+
+/**
+	the renderer of a headless robot: the SDK still decodes every subscribed
+	stream and hands the frames to deliverFrame, which only counts them, so
+	no window, GDI or D3D surface is created. the view of the canvas is then
+	only the key the SDK creates a render instance for
+*/
+class CNullVideoRender final : public agora::media::IExternalVideoRender
+{
+public:
+	explicit CNullVideoRender(void* hView);
+
+	virtual void release() override;
+	virtual int initialize() override;
+	virtual int deliverFrame(const agora::media::IVideoFrame& videoFrame, int rotation, bool mirrored) override;
+
+private:
+	void* m_hView;
+	std::atomic<int64_t> m_nFrames;		// logged when the SDK releases the instance
+};
+
+class CNullVideoRenderFactory : public agora::media::IExternalVideoRenderFactory
+{
+public:
+	static CNullVideoRenderFactory* GetInstance();
+
+	virtual agora::media::IExternalVideoRender* createRenderInstance(const agora::media::ExternalVideoRenerContext& context) override;
+
+private:
+	CNullVideoRenderFactory();
+};
@@ -0,0 +1,64 @@
+#pragma once
+#include "../agora/include/IAgoraRtcEngine.h"
+#include "AGExtInfoManager.h"
+#include "ParticipantRegistry.h"
+#include "SpeakerScheduler.h"
+#include <mutex>
+#include <vector>
+
+using namespace agora::rtc;
+
+/**
+	subscribes to the video of the remote users that hold a view and nothing
+	else. the engine joins with every remote video muted, a user that joins
+	while a view of CAGExtInfoManager is free gets it and is unmuted, the
+	others wait with their video muted. CSpeakerScheduler moves the views to
+	the users that speak most by the onAudioVolumeIndication reports, and
+	when a user holding a view goes offline the view passes to the loudest
+	waiting user, so a big channel only downloads and decodes the streams of
+	the active speakers.
+	a view smaller than VIEW_HIGH_STREAM_MIN_WIDTH x VIEW_HIGH_STREAM_MIN_HEIGHT
+	gets the low stream of a dual stream sender, the large ones the high stream.
+	the users live in CParticipantRegistry, the joins and leaves are posted to
+	it and come back as one batch per PARTICIPANT_BATCH_MS, so joining a
+	channel of a thousand users takes the lock once and not a thousand times.
+	the stats callbacks read the registry without the lock.
+	called from the SDK callback thread, Reset from the thread that joins
+*/
+class CRemoteVideoSubscriber
+{
+public:
+	CRemoteVideoSubscriber();
+
+	// before joinChannel, the users of the last channel are forgotten
+	void Reset(IRtcEngine* lpEngine);
+	// queued for the next batch
+	void OnUserJoined(uid_t uid);
+	void OnUserOffline(uid_t uid);
+	// keeps the stats of uid and switches the stream when the size of the view changed
+	void OnRemoteVideoStats(const RemoteVideoStats& stats);
+	void OnRemoteAudioStats(const RemoteAudioStats& stats);
+	// the remote speakers report, the local one (uid 0) is ignored
+	void OnAudioVolumeIndication(const AudioVolumeInfo* speakers, unsigned int speakerNumber);
+	// the views are freed by the caller with FreeAllView
+	void Clear();
+
+	// shown or waiting for a view, lock free. false while the join waits for its batch
+	bool IsKnown(uid_t uid);
+
+private:
+	void OnBatch(const std::vector<PARTICIPANT_EVENT>& vecEvents);
+	void Join(uid_t uid);
+	void Leave(uid_t uid);
+	void Subscribe(uid_t uid, VHANDLE hView);
+	// the view of uid is handed to an other user
+	void Unsubscribe(uid_t uid);
+	void SelectStream(uid_t uid, PARTICIPANT_INFO& info);
+
+	std::mutex m_mutex;
+	// the engine of the channel, set by Reset
+	IRtcEngine* m_lpEngine;
+	CParticipantRegistry* m_lpRegistry;
+	// every remote user, shown or waiting
+	CSpeakerScheduler m_scheduler;
+};
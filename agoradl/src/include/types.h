@@ -1,7 +1,6 @@
 #ifndef TYPES_H
 #define TYPES_H
+#include "Platform.h"
 
-#define AHANDLE void*
 #define AGORADL_EXPORTS
-typedef unsigned char BYTE;
 #endif
\ No newline at end of file
@@ -0,0 +1,86 @@
+'''
+compares a google benchmark json (--benchmark_out=x.json) against the
+checked in baseline, e.g.
+    python bench_compare.py agoradl/bench/baseline/media_bench.json media.json
+exits with 1 when the mean or the p99 of a benchmark got slower than --threshold %
+'''
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        report = json.load(f)
+    runs = {}
+    for run in report.get("benchmarks", []):
+        # skip the mean/median/stddev rows of --benchmark_repetitions
+        if run.get("run_type", "iteration") != "iteration":
+            continue
+        runs[run["name"]] = run
+    return report.get("context", {}), runs
+
+
+def ns(run, key):
+    value = run.get(key)
+    if value is None:
+        return None
+    if key in ("real_time", "cpu_time"):
+        scale = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}[run.get("time_unit", "ns")]
+        value *= scale
+    return value
+
+
+def change(old, new):
+    if old is None or new is None or old == 0:
+        return None
+    return (new - old) * 100.0 / old
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=10.0, help="allowed slowdown in percent")
+    args = parser.parse_args()
+
+    base_context, base = load(args.baseline)
+    cur_context, cur = load(args.current)
+    if base_context.get("host_name") != cur_context.get("host_name"):
+        print("note: baseline is from %s, numbers are only comparable on the same machine" % base_context.get("host_name"))
+    if base_context.get("num_cpus") != cur_context.get("num_cpus"):
+        print("note: baseline ran on %s cpus, this run on %s, the threads:2 numbers are not comparable" % (
+            base_context.get("num_cpus"), cur_context.get("num_cpus")))
+
+    regressions = 0
+    print("%-66s %12s %8s %12s %8s" % ("benchmark", "ns/op", "delta", "p99 ns", "delta"))
+    for name, run in cur.items():
+        old = base.get(name)
+        time_ns = ns(run, "real_time")
+        p99 = ns(run, "p99_ns")
+        if old is None:
+            print("%-66s %12.0f %8s %12s %8s" % (name, time_ns, "new", "%.0f" % p99 if p99 is not None else "-", ""))
+            continue
+
+        time_delta = change(ns(old, "real_time"), time_ns)
+        p99_delta = change(ns(old, "p99_ns"), p99)
+        slower = [d for d in (time_delta, p99_delta) if d is not None and d > args.threshold]
+        if slower:
+            regressions += 1
+        print("%-66s %12.0f %8s %12s %8s%s" % (
+            name, time_ns,
+            "%+.1f%%" % time_delta if time_delta is not None else "-",
+            "%.0f" % p99 if p99 is not None else "-",
+            "%+.1f%%" % p99_delta if p99_delta is not None else "",
+            "  REGRESSION" if slower else ""))
+
+    for name in base:
+        if name not in cur:
+            print("%-66s missing" % name)
+
+    print("%d of %d benchmarks slower than %.0f%%" % (regressions, len(cur), args.threshold))
+    return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,366 @@
+'''
+ctypes mirror of the typed config ABI (agoradl/src/include/AgoraConfig.h and
+zegodl/src/include/ZegoConfig.h). a whole robot setup goes to the wrapper in
+one applyConfig call, no json is built or parsed, e.g.
+    items = config_abi.agora_items([
+        config_abi.agora_video_profile(640, 480, 15, 1000),
+        config_abi.agora_enable_video(True),
+        config_abi.agora_join("test", 1)])
+    config_abi.apply(agora, config_abi.AGORA_ABI_VERSION, items)
+apply blocks until the engine thread ran the batch, post returns a ticket at
+once to wait on or poll later, commands run in the order they were posted:
+    ticket = config_abi.post(agora, config_abi.AGORA_ABI_VERSION, items)
+    ...
+    config_abi.wait(agora, ticket)
+agora is the ctypes handle of the wrapper or the agora_native module
+'''
+import ctypes
+
+# same values in both wrappers
+CONFIG_PENDING = 1
+CONFIG_OK = 0
+CONFIG_ERR_VERSION = -1
+CONFIG_ERR_TYPE = -2
+CONFIG_ERR_INVALID_ARG = -3
+CONFIG_ERR_SDK = -4
+CONFIG_ERR_SKIPPED = -5
+CONFIG_ERR_TIMEOUT = -6
+CONFIG_ERR_EXPIRED = -7
+
+RESULT_NAMES = {
+    CONFIG_PENDING: "pending",
+    CONFIG_OK: "ok",
+    CONFIG_ERR_VERSION: "abi version mismatch",
+    CONFIG_ERR_TYPE: "unknown config type",
+    CONFIG_ERR_INVALID_ARG: "invalid argument",
+    CONFIG_ERR_SDK: "sdk error",
+    CONFIG_ERR_SKIPPED: "skipped",
+    CONFIG_ERR_TIMEOUT: "timeout",
+    CONFIG_ERR_EXPIRED: "done, result expired",
+}
+
+
+class ConfigError(Exception):
+    pass
+
+
+# ---- agora ----
+AGORA_ABI_VERSION = 1
+AGORA_MAX_CHANNEL_ID = 64
+
+AGORA_CONFIG_VIDEO_PROFILE = 1
+AGORA_CONFIG_ENABLE_VIDEO = 2
+AGORA_CONFIG_ENABLE_AUDIO = 3
+AGORA_CONFIG_CHANNEL_PROFILE = 4
+AGORA_CONFIG_CLIENT_ROLE = 5
+AGORA_CONFIG_AUDIO_PROFILE = 6
+AGORA_CONFIG_JOIN_CHANNEL = 7
+AGORA_CONFIG_DUAL_STREAM = 8
+AGORA_CONFIG_HEADLESS = 9
+AGORA_CONFIG_REMOTE_VIDEO_FRAMES = 10
+AGORA_CONFIG_AUDIO_SINK = 11
+AGORA_CONFIG_AUDIO_RECORDING = 12
+
+
+class AgoraVideoProfile(ctypes.Structure):
+    _fields_ = [("nWidth", ctypes.c_int32), ("nHeight", ctypes.c_int32),
+                ("nFps", ctypes.c_int32), ("nBitrate", ctypes.c_int32)]
+
+
+class Enable(ctypes.Structure):
+    _fields_ = [("bEnable", ctypes.c_int32)]
+
+
+class AgoraChannelProfile(ctypes.Structure):
+    _fields_ = [("nProfile", ctypes.c_int32)]
+
+
+class AgoraClientRole(ctypes.Structure):
+    _fields_ = [("nRole", ctypes.c_int32)]
+
+
+class AgoraAudioProfile(ctypes.Structure):
+    _fields_ = [("nProfile", ctypes.c_int32), ("nScenario", ctypes.c_int32)]
+
+
+class AgoraJoin(ctypes.Structure):
+    _fields_ = [("nUID", ctypes.c_uint32), ("szChannelId", ctypes.c_char * (AGORA_MAX_CHANNEL_ID + 1))]
+
+
+class AgoraAudioSink(ctypes.Structure):
+    _fields_ = [("bEnable", ctypes.c_int32), ("nSampleRate", ctypes.c_int32), ("nChannels", ctypes.c_int32)]
+
+
+class AgoraAudioRecording(ctypes.Structure):
+    _fields_ = [("bEnable", ctypes.c_int32), ("nSampleRate", ctypes.c_int32)]
+
+
+class AgoraConfigUnion(ctypes.Union):
+    _fields_ = [("videoProfile", AgoraVideoProfile), ("enable", Enable),
+                ("channelProfile", AgoraChannelProfile), ("clientRole", AgoraClientRole),
+                ("audioProfile", AgoraAudioProfile), ("join", AgoraJoin), ("audioSink", AgoraAudioSink),
+                ("audioRecording", AgoraAudioRecording)]
+
+
+class AgoraConfigItem(ctypes.Structure):
+    _fields_ = [("nType", ctypes.c_int32), ("nResult", ctypes.c_int32),
+                ("nSdkError", ctypes.c_int32), ("config", AgoraConfigUnion)]
+
+
+def _agora_item(config_type, member, value):
+    item = AgoraConfigItem()
+    item.nType = config_type
+    setattr(item.config, member, value)
+    return item
+
+
+def agora_video_profile(width, height, fps, bitrate):
+    return _agora_item(AGORA_CONFIG_VIDEO_PROFILE, "videoProfile", AgoraVideoProfile(width, height, fps, bitrate))
+
+
+def agora_enable_video(enable):
+    return _agora_item(AGORA_CONFIG_ENABLE_VIDEO, "enable", Enable(1 if enable else 0))
+
+
+def agora_enable_audio(enable):
+    return _agora_item(AGORA_CONFIG_ENABLE_AUDIO, "enable", Enable(1 if enable else 0))
+
+
+def agora_channel_profile(profile):
+    return _agora_item(AGORA_CONFIG_CHANNEL_PROFILE, "channelProfile", AgoraChannelProfile(profile))
+
+
+def agora_client_role(role):
+    return _agora_item(AGORA_CONFIG_CLIENT_ROLE, "clientRole", AgoraClientRole(role))
+
+
+def agora_audio_profile(profile, scenario):
+    return _agora_item(AGORA_CONFIG_AUDIO_PROFILE, "audioProfile", AgoraAudioProfile(profile, scenario))
+
+
+def agora_join(channel, uid):
+    # longer names are left unterminated on purpose, the wrapper refuses them
+    return _agora_item(AGORA_CONFIG_JOIN_CHANNEL, "join", AgoraJoin(uid, bytes(channel, 'utf-8')[:AGORA_MAX_CHANNEL_ID + 1]))
+
+
+def agora_dual_stream(enable):
+    return _agora_item(AGORA_CONFIG_DUAL_STREAM, "enable", Enable(1 if enable else 0))
+
+
+def agora_headless(enable):
+    '''before agora_join, the views are then only slots'''
+    return _agora_item(AGORA_CONFIG_HEADLESS, "enable", Enable(1 if enable else 0))
+
+
+def agora_remote_video_frames(enable):
+    '''before agora_join, the decoded remote frames go to the compositor'''
+    return _agora_item(AGORA_CONFIG_REMOTE_VIDEO_FRAMES, "enable", Enable(1 if enable else 0))
+
+
+def agora_audio_sink(enable, sample_rate=48000, channels=1):
+    '''before agora_join, the playout goes to the external sink, rtc.RtcEngine.start_audio_sink pulls it'''
+    return _agora_item(AGORA_CONFIG_AUDIO_SINK, "audioSink", AgoraAudioSink(1 if enable else 0, sample_rate, channels))
+
+
+def agora_audio_recording(enable, sample_rate=48000):
+    '''the audio observer feeds the recorder of rtc.RtcEngine.start_audio_recording, which sends this itself'''
+    return _agora_item(AGORA_CONFIG_AUDIO_RECORDING, "audioRecording", AgoraAudioRecording(1 if enable else 0, sample_rate))
+
+
+def agora_items(items):
+    return (AgoraConfigItem * len(items))(*items)
+
+
+# ---- zego ----
+ZEGO_ABI_VERSION = 1
+ZEGO_MAX_ROOM_ID = 128
+ZEGO_MAX_USER_ID = 64
+
+ZEGO_CONFIG_VIDEO = 1
+ZEGO_CONFIG_ENABLE_VIDEO = 2
+ZEGO_CONFIG_HARDWARE_ENCODER = 3
+ZEGO_CONFIG_HARDWARE_DECODER = 4
+ZEGO_CONFIG_AUDIO = 5
+ZEGO_CONFIG_AUDIO_PROCESSING = 6
+ZEGO_CONFIG_LOGIN_ROOM = 7
+ZEGO_CONFIG_DUAL_STREAM = 8
+ZEGO_CONFIG_HEADLESS = 9
+ZEGO_CONFIG_REMOTE_VIDEO_FRAMES = 10
+ZEGO_CONFIG_AUDIO_SINK = 11
+ZEGO_CONFIG_AUDIO_RECORDING = 12
+
+
+class ZegoVideo(ctypes.Structure):
+    _fields_ = [("nWidth", ctypes.c_int32), ("nHeight", ctypes.c_int32),
+                ("nFps", ctypes.c_int32), ("nBitrate", ctypes.c_int32)]
+
+
+class ZegoAudio(ctypes.Structure):
+    _fields_ = [("nPreset", ctypes.c_int32), ("nCodecID", ctypes.c_int32)]
+
+
+class ZegoAudioProcessing(ctypes.Structure):
+    _fields_ = [("bAEC", ctypes.c_int32), ("bANS", ctypes.c_int32), ("bAGC", ctypes.c_int32)]
+
+
+class ZegoLogin(ctypes.Structure):
+    _fields_ = [("szRoomId", ctypes.c_char * (ZEGO_MAX_ROOM_ID + 1)),
+                ("szUserId", ctypes.c_char * (ZEGO_MAX_USER_ID + 1))]
+
+
+class ZegoAudioRecording(ctypes.Structure):
+    _fields_ = [("bEnable", ctypes.c_int32), ("nSampleRate", ctypes.c_int32), ("nChannels", ctypes.c_int32)]
+
+
+class ZegoConfigUnion(ctypes.Union):
+    _fields_ = [("video", ZegoVideo), ("enable", Enable), ("audio", ZegoAudio),
+                ("audioProcessing", ZegoAudioProcessing), ("login", ZegoLogin),
+                ("audioRecording", ZegoAudioRecording)]
+
+
+class ZegoConfigItem(ctypes.Structure):
+    _fields_ = [("nType", ctypes.c_int32), ("nResult", ctypes.c_int32), ("config", ZegoConfigUnion)]
+
+
+def _zego_item(config_type, member, value):
+    item = ZegoConfigItem()
+    item.nType = config_type
+    setattr(item.config, member, value)
+    return item
+
+
+def zego_video(width, height, fps, bitrate):
+    return _zego_item(ZEGO_CONFIG_VIDEO, "video", ZegoVideo(width, height, fps, bitrate))
+
+
+def zego_enable_video(enable):
+    return _zego_item(ZEGO_CONFIG_ENABLE_VIDEO, "enable", Enable(1 if enable else 0))
+
+
+def zego_hardware_encoder(enable):
+    return _zego_item(ZEGO_CONFIG_HARDWARE_ENCODER, "enable", Enable(1 if enable else 0))
+
+
+def zego_hardware_decoder(enable):
+    return _zego_item(ZEGO_CONFIG_HARDWARE_DECODER, "enable", Enable(1 if enable else 0))
+
+
+def zego_audio(preset, codec_id):
+    return _zego_item(ZEGO_CONFIG_AUDIO, "audio", ZegoAudio(preset, codec_id))
+
+
+def zego_audio_processing(aec, ans, agc):
+    return _zego_item(ZEGO_CONFIG_AUDIO_PROCESSING, "audioProcessing",
+                      ZegoAudioProcessing(1 if aec else 0, 1 if ans else 0, 1 if agc else 0))
+
+
+def zego_login(room, user):
+    return _zego_item(ZEGO_CONFIG_LOGIN_ROOM, "login",
+                      ZegoLogin(bytes(room, 'utf-8')[:ZEGO_MAX_ROOM_ID + 1], bytes(user, 'utf-8')[:ZEGO_MAX_USER_ID + 1]))
+
+
+def zego_dual_stream(enable):
+    return _zego_item(ZEGO_CONFIG_DUAL_STREAM, "enable", Enable(1 if enable else 0))
+
+
+def zego_headless(enable):
+    '''before zego_login, the views are then only slots'''
+    return _zego_item(ZEGO_CONFIG_HEADLESS, "enable", Enable(1 if enable else 0))
+
+
+def zego_remote_video_frames(enable):
+    '''before zego_login, the decoded remote frames go to the compositor'''
+    return _zego_item(ZEGO_CONFIG_REMOTE_VIDEO_FRAMES, "enable", Enable(1 if enable else 0))
+
+
+def zego_audio_sink(enable):
+    '''before zego_login, custom audio IO for rtc.RtcEngine.start_audio_sink, the capture is custom as well'''
+    return _zego_item(ZEGO_CONFIG_AUDIO_SINK, "enable", Enable(1 if enable else 0))
+
+
+def zego_audio_recording(enable, sample_rate=48000, channels=1):
+    '''the audio data callbacks feed the recorder of rtc.RtcEngine.start_audio_recording, which sends this itself'''
+    return _zego_item(ZEGO_CONFIG_AUDIO_RECORDING, "audioRecording",
+                      ZegoAudioRecording(1 if enable else 0, sample_rate, channels))
+
+
+def zego_items(items):
+    return (ZegoConfigItem * len(items))(*items)
+
+
+def _check(wrapper, abi_version, items):
+    if wrapper.getConfigAbiVersion() != abi_version:
+        raise ConfigError("wrapper config abi is %d, config_abi.py is %d" % (wrapper.getConfigAbiVersion(), abi_version))
+    if wrapper.getConfigItemSize() != ctypes.sizeof(items._type_):
+        raise ConfigError("wrapper config item is %d bytes, config_abi.py has %d" % (wrapper.getConfigItemSize(), ctypes.sizeof(items._type_)))
+    bind(wrapper)
+
+
+def bind(wrapper):
+    # tickets are 64 bit, the ctypes default would cut them to int. the
+    # agora_native module converts on its own
+    if not isinstance(wrapper, ctypes.CDLL):
+        return
+    wrapper.postConfig.restype = ctypes.c_int64
+    wrapper.postLeaveChannel.restype = ctypes.c_int64
+    wrapper.pollCommand.argtypes = [ctypes.c_int64]
+    wrapper.waitCommand.argtypes = [ctypes.c_int64, ctypes.c_int]
+
+
+def apply(wrapper, abi_version, items):
+    '''
+    hands a ctypes array of config items to wrapper.applyConfig, raises
+    ConfigError naming the first failed item, the wrapper fills every nResult
+    '''
+    _check(wrapper, abi_version, items)
+    result = wrapper.applyConfig(abi_version, items, len(items))
+    if result != CONFIG_OK:
+        failed = [i for i, item in enumerate(items) if item.nResult not in (CONFIG_OK, CONFIG_ERR_SKIPPED)]
+        raise ConfigError("applyConfig: %s at item %s" % (RESULT_NAMES.get(result, result), failed[0] if failed else "?"))
+
+
+def post(wrapper, abi_version, items):
+    '''
+    queues the items for the engine thread and returns the ticket of the
+    batch, raises ConfigError when the batch is refused up front
+    '''
+    _check(wrapper, abi_version, items)
+    ticket = wrapper.postConfig(abi_version, items, len(items))
+    if ticket < 0:
+        raise ConfigError("postConfig: %s" % RESULT_NAMES.get(ticket, ticket))
+    return ticket
+
+
+def wait(wrapper, ticket, timeout_ms=-1):
+    '''
+    waits for a ticket and everything posted before it, raises ConfigError
+    when the batch failed or the wait timed out
+    '''
+    result = wrapper.waitCommand(ticket, timeout_ms)
+    if result not in (CONFIG_OK, CONFIG_ERR_EXPIRED):
+        raise ConfigError("ticket %d: %s" % (ticket, RESULT_NAMES.get(result, result)))
+
+
+def poll(wrapper, ticket):
+    '''
+    True once the ticket is done, raises ConfigError when it failed
+    '''
+    result = wrapper.pollCommand(ticket)
+    if result == CONFIG_PENDING:
+        return False
+    if result not in (CONFIG_OK, CONFIG_ERR_EXPIRED):
+        raise ConfigError("ticket %d: %s" % (ticket, RESULT_NAMES.get(result, result)))
+    return True
+
+
+def poll_all(wrapper, tickets):
+    '''
+    True once every ticket is done, raises ConfigError for the first that
+    failed. for a ui loop (tkinter after) that must not block on the engine
+    thread, the tickets that are done are taken out of the list
+    '''
+    while len(tickets) > 0:
+        if not poll(wrapper, tickets[0]):
+            return False
+        tickets.pop(0)
+    return True
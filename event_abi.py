@@ -0,0 +1,101 @@
+'''
+ctypes mirror of the SDK event records (agoradl/src/include/AgoraEvent.h and
+zegodl/src/include/ZegoEvent.h). the wrappers queue every callback in a
+preallocated ring, drain it in batches from a loop of your own, e.g.
+    events = event_abi.EventReader(agora, event_abi.AgoraEvent, event_abi.AGORA_EVENT_ABI_VERSION)
+    for event in events.poll():
+        if event.nType == event_abi.AGORA_EVENT_USER_JOINED:
+            print(event.nUID, event.nArgs[0])
+'''
+import ctypes
+
+# ---- agora ----
+AGORA_EVENT_ABI_VERSION = 1
+AGORA_EVENT_TEXT = 96
+
+(AGORA_EVENT_DROPPED,
+ AGORA_EVENT_JOIN_CHANNEL_SUCCESS,
+ AGORA_EVENT_REJOIN_CHANNEL_SUCCESS,
+ AGORA_EVENT_WARNING,
+ AGORA_EVENT_ERROR,
+ AGORA_EVENT_AUDIO_QUALITY,
+ AGORA_EVENT_AUDIO_VOLUME_INDICATION,
+ AGORA_EVENT_LEAVE_CHANNEL,
+ AGORA_EVENT_MEDIA_ENGINE_EVENT,
+ AGORA_EVENT_AUDIO_DEVICE_STATE_CHANGED,
+ AGORA_EVENT_VIDEO_DEVICE_STATE_CHANGED,
+ AGORA_EVENT_LASTMILE_QUALITY,
+ AGORA_EVENT_FIRST_LOCAL_VIDEO_FRAME,
+ AGORA_EVENT_FIRST_REMOTE_VIDEO_DECODED,
+ AGORA_EVENT_FIRST_REMOTE_VIDEO_FRAME,
+ AGORA_EVENT_USER_JOINED,
+ AGORA_EVENT_USER_OFFLINE,
+ AGORA_EVENT_USER_MUTE_AUDIO,
+ AGORA_EVENT_USER_MUTE_VIDEO,
+ AGORA_EVENT_STREAM_MESSAGE,
+ AGORA_EVENT_APICALL_EXECUTED,
+ AGORA_EVENT_LOCAL_VIDEO_STAT,
+ AGORA_EVENT_REMOTE_VIDEO_STAT,
+ AGORA_EVENT_CAMERA_READY,
+ AGORA_EVENT_VIDEO_STOPPED,
+ AGORA_EVENT_CONNECTION_LOST,
+ AGORA_EVENT_CONNECTION_INTERRUPTED,
+ AGORA_EVENT_USER_ENABLE_VIDEO,
+ AGORA_EVENT_START_RECORDING_SERVICE,
+ AGORA_EVENT_STOP_RECORDING_SERVICE,
+ AGORA_EVENT_RECORDING_SERVICE_STATUS) = range(1, 32)
+
+
+class AgoraEvent(ctypes.Structure):
+    _fields_ = [("nType", ctypes.c_int32), ("nUID", ctypes.c_uint32),
+                ("nTimestampUs", ctypes.c_int64), ("nArgs", ctypes.c_int32 * 4),
+                ("szText", ctypes.c_char * AGORA_EVENT_TEXT)]
+
+
+# ---- zego ----
+ZEGO_EVENT_ABI_VERSION = 1
+ZEGO_EVENT_TEXT = 232
+
+(ZEGO_EVENT_DROPPED,
+ ZEGO_EVENT_DEBUG_ERROR,
+ ZEGO_EVENT_ENGINE_STATE,
+ ZEGO_EVENT_ROOM_STATE,
+ ZEGO_EVENT_ROOM_USER_ADD,
+ ZEGO_EVENT_ROOM_USER_DELETE,
+ ZEGO_EVENT_ROOM_STREAM_ADD,
+ ZEGO_EVENT_ROOM_STREAM_DELETE,
+ ZEGO_EVENT_PLAYER_FIRST_VIDEO_FRAME,
+ ZEGO_EVENT_PUBLISHER_VIDEO_SIZE,
+ ZEGO_EVENT_PLAYER_VIDEO_SIZE,
+ ZEGO_EVENT_PUBLISHER_QUALITY,
+ ZEGO_EVENT_PLAYER_QUALITY) = range(1, 14)
+
+
+class ZegoEvent(ctypes.Structure):
+    _fields_ = [("nType", ctypes.c_int32), ("nArgs", ctypes.c_int32 * 3),
+                ("nTimestampUs", ctypes.c_int64), ("szText", ctypes.c_char * ZEGO_EVENT_TEXT)]
+
+
+class EventError(Exception):
+    pass
+
+
+class EventReader(object):
+    '''
+    owns the buffer pollEvents copies into, poll() returns the records that
+    were pending, they are overwritten by the next poll
+    '''
+    def __init__(self, wrapper, event_type, abi_version, batch=256):
+        if wrapper.getEventAbiVersion() != abi_version:
+            raise EventError("wrapper event abi is %d, event_abi.py is %d" % (wrapper.getEventAbiVersion(), abi_version))
+        if wrapper.getEventSize() != ctypes.sizeof(event_type):
+            raise EventError("wrapper event is %d bytes, event_abi.py has %d" % (wrapper.getEventSize(), ctypes.sizeof(event_type)))
+        self.wrapper = wrapper
+        self.buf = (event_type * batch)()
+        self.batch = batch
+
+    def poll(self):
+        count = self.wrapper.pollEvents(self.buf, self.batch)
+        if count < 0:
+            raise EventError("pollEvents returned %d" % count)
+        return self.buf[:count]
@@ -0,0 +1,288 @@
+import ctypes
+import glob
+import json
+import os
+import socket
+import subprocess
+import sys
+import threading
+import time
+
+# set by start.py in every robot it spawns: "host:port" of the launcher barrier
+FLEET_ENV = "FLEET_LAUNCHER"
+# set by start.py --churn: "cycles:holdms:outdir", the robot cycles join/leave
+# instead of staying in the channel and leaves its histograms in outdir
+CHURN_ENV = "FLEET_CHURN"
+# how long a churn cycle waits for the join and for the leave
+CHURN_TIMEOUT_MS = 10000
+
+
+def launched():
+    return os.environ.get(FLEET_ENV) is not None
+
+
+def wait_ready(wrapper, timeout_ms=30000):
+    '''
+    robot side of the barrier: wait for the wrapper to report the join,
+    tell the launcher and block until the whole fleet is up.
+    must run on a worker thread, zego delivers room state on the ui thread
+    '''
+    elapsed = wrapper.waitJoinChannel(ctypes.c_int(timeout_ms))
+    addr = os.environ.get(FLEET_ENV)
+    if addr is None:
+        return elapsed
+
+    host, port = addr.rsplit(":", 1)
+    sock = socket.create_connection((host, int(port)))
+    sock.sendall(bytes("READY %d %d\n" % (os.getpid(), elapsed), 'utf-8'))
+    # the launcher answers GO once every robot is ready (or the ramp timed out)
+    sock.makefile('r').readline()
+    sock.close()
+    return elapsed
+
+
+def run_headless(done=None, poll=None):
+    '''
+    stands in for window.mainloop() in a robot without windows until done
+    is set or ctrl-c. on windows it pumps the messages of this thread,
+    zego delivers room state through them.
+    poll is called about every 100ms until it returns True, as window.after
+    would call it
+    '''
+    if sys.platform != "win32":
+        while done is None or not done.wait(0.1):
+            if poll is not None and poll():
+                poll = None
+        return
+
+    import ctypes.wintypes
+    user32 = ctypes.windll.user32
+    msg = ctypes.wintypes.MSG()
+    PM_REMOVE = 1
+    nextPoll = time.time()
+    while done is None or not done.is_set():
+        while user32.PeekMessageW(ctypes.byref(msg), None, 0, 0, PM_REMOVE):
+            user32.TranslateMessage(ctypes.byref(msg))
+            user32.DispatchMessageW(ctypes.byref(msg))
+        if poll is not None and time.time() >= nextPoll:
+            nextPoll = time.time() + 0.1
+            if poll():
+                poll = None
+        time.sleep(0.01)
+
+
+def churn():
+    return os.environ.get(CHURN_ENV) is not None
+
+
+def run_churn(wrapper, channel, uid):
+    '''
+    robot side of the churn benchmark, blocks until every cycle is done.
+    zego must not call it from the ui thread either
+    '''
+    cycles, holdms, outdir = os.environ[CHURN_ENV].split(":", 2)
+    params = json.dumps({"channelId": channel, "uid": str(uid), "cycles": cycles, "holdms": holdms,
+                         "timeoutms": str(CHURN_TIMEOUT_MS),
+                         "output": os.path.join(outdir, "churn_%d.hist" % os.getpid())})
+    return wrapper.runChurnBenchmark(ctypes.c_char_p(bytes(params, 'utf-8')))
+
+
+def churn_duration(cycles, holdms):
+    '''
+    seconds a robot needs for its churn run when every join and leave times out
+    '''
+    return cycles * (holdms + 2 * CHURN_TIMEOUT_MS) / 1000.0
+
+
+def merge_churn(outdir):
+    '''
+    sums the histograms every robot dumped, counts are added per bucket so
+    the merged percentiles are as exact as a single robot's
+    '''
+    cycles = failed = robots = 0
+    metrics = {}
+    order = []
+    for path in glob.glob(os.path.join(outdir, "churn_*.hist")):
+        robots += 1
+        counts = None
+        with open(path) as f:
+            for line in f:
+                fields = line.split()
+                if len(fields) == 0:
+                    continue
+                if fields[0] == "cycles":
+                    cycles += int(fields[1])
+                    failed += int(fields[2])
+                elif fields[0] == "#":
+                    name = "%s(%s)" % (fields[1], fields[2])
+                    if name not in metrics:
+                        metrics[name] = {}
+                        order.append(name)
+                    counts = metrics[name]
+                elif counts is not None:
+                    value = int(fields[0])
+                    counts[value] = counts.get(value, 0) + int(fields[1])
+    return robots, cycles, failed, [(name, metrics[name]) for name in order]
+
+
+def count_percentile(counts, p):
+    total = sum(counts.values())
+    if total == 0:
+        return 0
+    rank = max(1, int(p / 100.0 * total + 0.5))
+    cumulative = 0
+    for value in sorted(counts):
+        cumulative += counts[value]
+        if cumulative >= rank:
+            return value
+    return max(counts)
+
+
+def report_churn(outdir):
+    robots, cycles, failed, metrics = merge_churn(outdir)
+    print("churn: %d robots, %d cycles, %d failed" % (robots, cycles, failed))
+    for name, counts in metrics:
+        print("  %-26s n:%-7d p50:%-8d p90:%-8d p99:%-8d p99.9:%-8d max:%d" % (
+            name, sum(counts.values()), count_percentile(counts, 50), count_percentile(counts, 90),
+            count_percentile(counts, 99), count_percentile(counts, 99.9), max(counts) if counts else 0))
+
+
+def percentile(values, p):
+    if len(values) == 0:
+        return 0
+    values = sorted(values)
+    rank = int(round(p / 100.0 * (len(values) - 1)))
+    return values[rank]
+
+
+class FleetLauncher(object):
+    '''
+    starts robots at a fixed ramp rate (joins per second), never keeps more
+    than max_pending robots waiting for their join, and holds every robot
+    on a barrier until the fleet is up
+    '''
+
+    def __init__(self, cmd, count, rate, max_pending=0, timeout=60):
+        self.cmd = cmd
+        self.count = count
+        self.rate = rate
+        self.max_pending = max_pending
+        self.timeout = timeout
+
+        self.processes = []
+        self.spawnTime = {}
+        self.readyTime = {}
+        self.joinElapsed = {}
+        self.failed = []
+        self.conns = []
+        # set by release, a robot that gets ready later is let go at once
+        self.released = False
+        self.cond = threading.Condition()
+
+        self.server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        self.server.bind(("127.0.0.1", 0))
+        self.server.listen(count)
+        self.acceptTask = threading.Thread(target=self._serve, daemon=True)
+        self.acceptTask.start()
+
+    def _serve(self):
+        while True:
+            try:
+                conn, _ = self.server.accept()
+            except OSError:
+                break
+            line = conn.makefile('r').readline().split()
+            if len(line) != 3 or line[0] != "READY":
+                conn.close()
+                continue
+            pid = int(line[1])
+            elapsed = int(line[2])
+            with self.cond:
+                self.readyTime[pid] = time.time()
+                if self.released:
+                    self._go(conn)
+                else:
+                    self.conns.append(conn)
+                if elapsed < 0:
+                    self.failed.append(pid)
+                else:
+                    self.joinElapsed[pid] = elapsed
+                self.cond.notify_all()
+
+    def _pending(self):
+        exited = [p for p in self.processes if p.poll() is not None and p.pid not in self.readyTime]
+        return len(self.processes) - len(self.readyTime) - len(exited)
+
+    def launch(self, extra_env=None):
+        env = dict(os.environ)
+        env[FLEET_ENV] = "127.0.0.1:%d" % self.server.getsockname()[1]
+        if extra_env is not None:
+            env.update(extra_env)
+        interval = 1.0 / self.rate if self.rate > 0 else 0
+
+        start = time.time()
+        nextSpawn = start
+        for i in range(self.count):
+            with self.cond:
+                while self.max_pending > 0 and self._pending() >= self.max_pending:
+                    self.cond.wait(0.1)
+            now = time.time()
+            if now < nextSpawn:
+                time.sleep(nextSpawn - now)
+            nextSpawn = max(nextSpawn, time.time()) + interval
+
+            p = subprocess.Popen(self.cmd, env=env)
+            self.spawnTime[p.pid] = time.time()
+            self.processes.append(p)
+
+        deadline = time.time() + self.timeout
+        with self.cond:
+            while len(self.readyTime) < self.count and time.time() < deadline:
+                if self._pending() == 0:
+                    break
+                self.cond.wait(0.1)
+        self.rampTime = time.time() - start
+
+    @staticmethod
+    def _go(conn):
+        try:
+            conn.sendall(b"GO\n")
+            conn.close()
+        except OSError:
+            pass
+
+    def release(self):
+        with self.cond:
+            self.released = True
+            for conn in self.conns:
+                self._go(conn)
+            self.conns = []
+
+    def report(self):
+        spawnToReady = [(self.readyTime[pid] - self.spawnTime[pid]) * 1000
+                        for pid in self.readyTime if pid in self.spawnTime and pid not in self.failed]
+        elapsed = list(self.joinElapsed.values())
+        print("fleet: %d/%d robots ready, %d failed, ramp %.1f s (%.2f joins/s)" % (
+            len(elapsed), self.count, len(self.failed) + self.count - len(self.readyTime),
+            self.rampTime, len(elapsed) / self.rampTime if self.rampTime > 0 else 0))
+        for name, values in (("join elapsed(ms)", elapsed), ("spawn->ready(ms)", spawnToReady)):
+            print("  %-17s p50:%-7d p90:%-7d p99:%-7d max:%d" % (
+                name, percentile(values, 50), percentile(values, 90), percentile(values, 99),
+                max(values) if values else 0))
+
+    def wait_exit(self, timeout=None):
+        '''
+        waits for every robot to exit, up to timeout seconds or the spawn timeout
+        '''
+        deadline = time.time() + (self.timeout if timeout is None else timeout)
+        for p in self.processes:
+            try:
+                p.wait(max(0, deadline - time.time()))
+            except subprocess.TimeoutExpired:
+                pass
+
+    def kill(self):
+        self.release()
+        self.server.close()
+        for p in self.processes:
+            p.kill()
@@ -0,0 +1,170 @@
+'''
+reads the remote video rings of rtc_startFrameExport
+(rtccore/src/include/VideoFrameExport.h) from any process. every remote
+participant has its own shared memory block <prefix>_<uid or stream id>,
+rtc.RtcEngine.frame_export_names() lists them, on linux they are also in
+/dev/shm. a frame is handed out as numpy views of the mapping without a
+copy, e.g.
+    ring = frame_ring.FrameRing("rtc_1234_56")
+    frame = ring.latest()
+    if frame is not None:
+        level = frame.y.mean()
+        if frame.valid():
+            print(ring.id, frame.index, level)
+the wrapper overwrites a slot once nSlots - 1 newer frames were sampled,
+frame.valid() tells whether the views still hold the frame; frame.copy()
+takes a copy and checks it. run on its own it prints the frame rate and the
+mean luma of rings, e.g.
+    python frame_ring.py --prefix rtc_1234
+'''
+import argparse
+import mmap
+import os
+import struct
+import sys
+import time
+
+import numpy as np
+
+MAGIC = 0x46435452
+VERSION = 1
+
+# FRAME_EXPORT_HEADER up to szId, and FRAME_EXPORT_SLOT
+HEADER_FORMAT = "<10IQ232s"
+HEADER_SIZE = 320
+FRAMES_OFFSET = 40
+SLOT_FORMAT = "<QQqIIII"
+
+
+class Frame(object):
+    '''one sampled I420 frame, y, u and v are views of the ring'''
+
+    def __init__(self, ring, offset, seq, index, timestamp_us, width, height, source_width, source_height):
+        self.ring = ring
+        self.offset = offset
+        self.seq = seq
+        self.index = index
+        self.timestamp_us = timestamp_us
+        self.width = width
+        self.height = height
+        self.source_width = source_width
+        self.source_height = source_height
+        data = offset + ring.slot_header_size
+        luma = width * height
+        self.y = np.frombuffer(ring.map, np.uint8, luma, data).reshape(height, width)
+        self.u = np.frombuffer(ring.map, np.uint8, luma // 4, data + luma).reshape(height // 2, width // 2)
+        self.v = np.frombuffer(ring.map, np.uint8, luma // 4, data + luma * 5 // 4).reshape(height // 2, width // 2)
+
+    def valid(self):
+        '''False once the wrapper started to overwrite the slot'''
+        return struct.unpack_from("<Q", self.ring.map, self.offset)[0] == self.seq
+
+    def copy(self):
+        '''(y, u, v) copies of the frame, None when it was overwritten meanwhile'''
+        planes = (self.y.copy(), self.u.copy(), self.v.copy())
+        return planes if self.valid() else None
+
+
+class FrameRing(object):
+    '''the ring of one remote participant'''
+
+    def __init__(self, name):
+        self.name = name
+        self.map = self._open(name)
+        (magic, version, self.header_size, self.slot_header_size, self.slots, self.slot_size,
+         self.max_width, self.max_height, self.interval_ms, _, _, raw_id) = struct.unpack_from(HEADER_FORMAT, self.map, 0)
+        if magic != MAGIC or version != VERSION:
+            self.map.close()
+            raise ValueError("%s is not a frame ring of version %d" % (name, VERSION))
+        self.id = raw_id.split(b"\0", 1)[0].decode(errors="replace")
+
+    @staticmethod
+    def _open(name):
+        if sys.platform == "win32":
+            # the size is only known from the header
+            header = mmap.mmap(-1, HEADER_SIZE, tagname="Local\\" + name, access=mmap.ACCESS_READ)
+            values = struct.unpack_from(HEADER_FORMAT, header, 0)
+            header.close()
+            return mmap.mmap(-1, values[2] + values[4] * values[5], tagname="Local\\" + name, access=mmap.ACCESS_READ)
+        with open(os.path.join("/dev/shm", name), "rb") as file:
+            return mmap.mmap(file.fileno(), 0, access=mmap.ACCESS_READ)
+
+    def close(self):
+        '''views of frames still alive keep the mapping until they go'''
+        try:
+            self.map.close()
+        except BufferError:
+            pass
+
+    @property
+    def frames(self):
+        '''frames written so far'''
+        return struct.unpack_from("<Q", self.map, FRAMES_OFFSET)[0]
+
+    @property
+    def closed(self):
+        '''the export stopped, no frame follows'''
+        return struct.unpack_from("<I", self.map, 36)[0] != 0
+
+    def get(self, index):
+        '''frame number index, None when it is overwritten, being written or not there yet'''
+        if index < 0 or index >= self.frames:
+            return None
+        offset = self.header_size + self.slot_size * (index % self.slots)
+        seq, frame, timestamp_us, width, height, source_width, source_height = struct.unpack_from(SLOT_FORMAT, self.map, offset)
+        if seq & 1 or frame != index:
+            return None
+        result = Frame(self, offset, seq, frame, timestamp_us, width, height, source_width, source_height)
+        # the slot header may have been read while the writer moved on
+        return result if result.valid() else None
+
+    def latest(self):
+        return self.get(self.frames - 1)
+
+
+def find_rings(prefix):
+    '''the rings of a prefix, only linux lists shared memory'''
+    if not os.path.isdir("/dev/shm"):
+        return []
+    return sorted(name for name in os.listdir("/dev/shm") if name.startswith(prefix + "_"))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="frame rate and mean luma of the frame rings")
+    parser.add_argument("names", nargs="*", help="ring names, see rtc.RtcEngine.frame_export_names()")
+    parser.add_argument("--prefix", help="every ring of this prefix in /dev/shm, rings that show up later are added")
+    parser.add_argument("--seconds", type=float, default=10.0)
+    args = parser.parse_args()
+    if not args.names and not args.prefix:
+        parser.error("names or --prefix")
+
+    rings = {}
+    last = {}
+    deadline = time.time() + args.seconds
+    while time.time() < deadline:
+        for name in list(args.names) + (find_rings(args.prefix) if args.prefix else []):
+            if name not in rings:
+                try:
+                    rings[name] = FrameRing(name)
+                    last[name] = rings[name].frames
+                except (OSError, ValueError) as e:
+                    print("%s: %s" % (name, e))
+                    args.names = [n for n in args.names if n != name]
+        time.sleep(1.0)
+        for name, ring in sorted(rings.items()):
+            frames = ring.frames
+            frame = ring.latest()
+            level = frame.y.mean() if frame is not None else float("nan")
+            if frame is not None and not frame.valid():
+                level = float("nan")
+            size = "%dx%d" % (frame.width, frame.height) if frame is not None else "-"
+            print("%-24s %-10s %3d fps  %9s  luma %6.1f%s" % (name, ring.id, frames - last[name], size, level,
+                                                              "  closed" if ring.closed else ""))
+            last[name] = frames
+            frame = None
+    for ring in rings.values():
+        ring.close()
+
+
+if __name__ == "__main__":
+    main()
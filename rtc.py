@@ -0,0 +1,321 @@
+'''
+vendor neutral binding of the rtc_ exports every wrapper dll has
+(rtccore/engine/RtcEngine.cpp). the same script drives either vendor, only
+the dll differs, e.g.
+    engine = rtc.RtcEngine("agoradl/bin/agorawrapper.dll")
+    engine.create(appid)
+    engine.enable_custom_video_capture()
+    engine.set_video_profile(640, 480, 15, 800)
+    engine.join("test", "1")
+    engine.wait_join(10000)
+    engine.push_video_frame(i420, 640, 480)
+a uid is a decimal string for agora and any id for zego
+'''
+import ctypes
+
+RTC_OK = 0
+RTC_ERR_INVALID_ARG = -3
+RTC_ERR_SDK = -4
+RTC_ERR_TIMEOUT = -6
+RTC_ERR_NO_ENGINE = -8
+RTC_ERR_UNSUPPORTED = -9
+
+# LATENCY_STAGE of rtccore/src/include/LatencyStats.h, ns between two stamps of a pushed frame
+LATENCY_STAGES = [
+    "video.pushToPublish",
+    "video.publishToRead",
+    "video.readToHandoff",
+    "video.pushToHandoff",
+    "audio.pushToPublish",
+    "audio.publishToRead",
+    "audio.readToHandoff",
+    "audio.pushToHandoff",
+]
+
+# PARTICIPANT_STAT of rtccore/src/include/ParticipantRegistry.h, the last report of a remote participant
+PARTICIPANT_STATS = [
+    "width",
+    "height",
+    "videoKbps",
+    "videoFps",
+    "delayMs",
+    "audioKbps",
+    "audioLevel",
+]
+
+# AUDIO_SINK_STAT of rtccore/src/include/AudioSink.h, counted since start_audio_sink
+AUDIO_SINK_STATS = [
+    "frames",
+    "failed",
+    "late",
+    "lost",
+    "silent",
+    "glitches",
+    "level",
+    "peak",
+]
+
+# of rtccore/src/include/VideoCompositor.h
+COMPOSITOR_MAX_TILES = 64
+
+RESULT_NAMES = {
+    RTC_OK: "RTC_OK",
+    -1: "ERR_VERSION",
+    -2: "ERR_TYPE",
+    RTC_ERR_INVALID_ARG: "RTC_ERR_INVALID_ARG",
+    RTC_ERR_SDK: "RTC_ERR_SDK",
+    -5: "ERR_SKIPPED",
+    RTC_ERR_TIMEOUT: "RTC_ERR_TIMEOUT",
+    -7: "ERR_EXPIRED",
+    RTC_ERR_NO_ENGINE: "RTC_ERR_NO_ENGINE",
+    RTC_ERR_UNSUPPORTED: "RTC_ERR_UNSUPPORTED",
+}
+
+
+class RtcError(Exception):
+    pass
+
+
+def _check(name, result):
+    if result < 0:
+        raise RtcError("%s: %s" % (name, RESULT_NAMES.get(result, result)))
+    return result
+
+
+class RtcEngine(object):
+    '''one wrapper dll, the engine of its backend'''
+
+    def __init__(self, dllpath):
+        self.dll = ctypes.CDLL(dllpath)
+        dll = self.dll
+        dll.rtc_getBackendName.restype = ctypes.c_char_p
+        dll.rtc_createEngine.argtypes = [ctypes.c_char_p]
+        dll.rtc_joinChannel.argtypes = [ctypes.c_char_p, ctypes.c_char_p]
+        dll.rtc_setAudioProfile.argtypes = [ctypes.c_int, ctypes.c_char_p]
+        dll.rtc_addView.argtypes = [ctypes.c_void_p]
+        dll.rtc_setViewSize.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int]
+        dll.rtc_pushVideoFrame.argtypes = [ctypes.c_char_p, ctypes.c_int, ctypes.c_int, ctypes.c_int]
+        dll.rtc_pushAudioFrame.argtypes = [ctypes.c_char_p, ctypes.c_int]
+        dll.rtc_startStatsRecording.argtypes = [ctypes.c_char_p]
+        dll.rtc_stopStatsRecording.restype = ctypes.c_int64
+        dll.rtc_getLatency.argtypes = [ctypes.c_int, ctypes.c_double]
+        dll.rtc_getLatency.restype = ctypes.c_int64
+        dll.rtc_getLatencyCount.restype = ctypes.c_int64
+        dll.rtc_startLatencyDump.argtypes = [ctypes.c_char_p, ctypes.c_int]
+        dll.rtc_getParticipantStat.argtypes = [ctypes.c_char_p, ctypes.c_int, ctypes.POINTER(ctypes.c_int)]
+        dll.rtc_composite.argtypes = [ctypes.POINTER(ctypes.c_int), ctypes.c_int]
+        dll.rtc_getCompositorSurface.argtypes = [ctypes.POINTER(ctypes.c_int), ctypes.POINTER(ctypes.c_int)]
+        dll.rtc_getCompositorSurface.restype = ctypes.c_void_p
+        dll.rtc_startFrameExport.argtypes = [ctypes.c_char_p, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int]
+        dll.rtc_getFrameExportNames.argtypes = [ctypes.c_char_p, ctypes.c_int]
+        dll.rtc_getAudioSinkStat.argtypes = [ctypes.c_int, ctypes.POINTER(ctypes.c_int64)]
+        dll.rtc_startAudioRecording.argtypes = [ctypes.c_char_p, ctypes.c_int, ctypes.c_int]
+        dll.rtc_stopAudioRecording.restype = ctypes.c_int64
+        dll.rtc_getAudioRecordingDropped.restype = ctypes.c_int64
+        self.backend = dll.rtc_getBackendName().decode()
+
+    def create(self, appid=None):
+        _check("rtc_createEngine", self.dll.rtc_createEngine(appid.encode() if appid else None))
+
+    def destroy(self):
+        self.dll.rtc_destroyEngine()
+
+    def join(self, channel, uid):
+        _check("rtc_joinChannel", self.dll.rtc_joinChannel(channel.encode(), str(uid).encode()))
+
+    def wait_join(self, timeout_ms):
+        '''ms the join took, None on timeout'''
+        result = self.dll.rtc_waitJoinChannel(timeout_ms)
+        return None if result == RTC_ERR_TIMEOUT else _check("rtc_waitJoinChannel", result)
+
+    def leave(self):
+        _check("rtc_leaveChannel", self.dll.rtc_leaveChannel())
+
+    def enable_video(self, enable=True):
+        _check("rtc_enableVideo", self.dll.rtc_enableVideo(int(enable)))
+
+    def enable_audio(self, enable=True):
+        _check("rtc_enableAudio", self.dll.rtc_enableAudio(int(enable)))
+
+    def enable_dual_stream(self, enable=True):
+        '''on by default, small views then play the low stream of the senders'''
+        _check("rtc_enableDualStream", self.dll.rtc_enableDualStream(int(enable)))
+
+    def set_video_profile(self, width, height, fps, bitrate_kbps):
+        _check("rtc_setVideoProfile", self.dll.rtc_setVideoProfile(width, height, fps, bitrate_kbps))
+
+    def set_audio_profile(self, profile, codec=None):
+        '''
+        vendor numbering: AUDIO_PROFILE_TYPE and a che.audio.specify.codec name
+        for agora, ZegoAudioConfigPreset and ZegoAudioCodecID for zego
+        '''
+        _check("rtc_setAudioProfile", self.dll.rtc_setAudioProfile(profile, str(codec).encode() if codec is not None else None))
+
+    def add_view(self, hwnd):
+        self.dll.rtc_addView(hwnd)
+
+    def enable_headless(self, enable=True):
+        '''
+        before join: no preview and no window, the remote video is decoded into
+        a null renderer. the views are only slots then, add_view(1), add_view(2), ...
+        '''
+        _check("rtc_enableHeadless", self.dll.rtc_enableHeadless(int(enable)))
+
+    def set_view_size(self, hwnd, width, height):
+        '''views under 640x360 get the low stream'''
+        _check("rtc_setViewSize", self.dll.rtc_setViewSize(hwnd, width, height))
+
+    def enable_custom_video_capture(self):
+        _check("rtc_enableCustomVideoCapture", self.dll.rtc_enableCustomVideoCapture())
+
+    def enable_custom_audio_capture(self, sample_rate, channels):
+        _check("rtc_enableCustomAudioCapture", self.dll.rtc_enableCustomAudioCapture(sample_rate, channels))
+
+    def push_video_frame(self, i420, width, height, stride=None):
+        '''i420 holds height*3/2 rows of stride bytes'''
+        _check("rtc_pushVideoFrame", self.dll.rtc_pushVideoFrame(i420, width, height, stride or width))
+
+    def push_audio_frame(self, pcm):
+        '''16 bit PCM, blocks while the capture buffer is full'''
+        _check("rtc_pushAudioFrame", self.dll.rtc_pushAudioFrame(pcm, len(pcm)))
+
+    def start_stats_recording(self, path):
+        if self.dll.rtc_startStatsRecording(path.encode()) != 0:
+            raise RtcError("rtc_startStatsRecording: can not record to %s" % path)
+
+    def stop_stats_recording(self):
+        return self.dll.rtc_stopStatsRecording()
+
+    def latency(self, stage, percentile):
+        '''ns, stage is an index or a name of LATENCY_STAGES'''
+        if not isinstance(stage, int):
+            stage = LATENCY_STAGES.index(stage)
+        return _check("rtc_getLatency", self.dll.rtc_getLatency(stage, percentile))
+
+    def latency_report(self, percentiles=(50, 90, 99, 99.9)):
+        '''{stage name: {"count": n, "p50": ns, ...}} of every stage'''
+        report = {}
+        for i, name in enumerate(LATENCY_STAGES):
+            stage = {"count": _check("rtc_getLatencyCount", self.dll.rtc_getLatencyCount(i))}
+            for p in percentiles:
+                stage["p%g" % p] = self.latency(i, p)
+            report[name] = stage
+        return report
+
+    def reset_latency(self):
+        self.dll.rtc_resetLatency()
+
+    def start_latency_dump(self, path, interval_ms=1000):
+        if self.dll.rtc_startLatencyDump(path.encode(), interval_ms) != 0:
+            raise RtcError("rtc_startLatencyDump: can not dump to %s" % path)
+
+    def stop_latency_dump(self):
+        self.dll.rtc_stopLatencyDump()
+
+    def participant_count(self):
+        return self.dll.rtc_getParticipantCount()
+
+    def participant_stats(self, uid):
+        '''{stat name: value} of a remote uid or stream id, None when it is not in the channel'''
+        stats = {}
+        value = ctypes.c_int()
+        for i, name in enumerate(PARTICIPANT_STATS):
+            if self.dll.rtc_getParticipantStat(str(uid).encode(), i, ctypes.byref(value)) != RTC_OK:
+                return None
+            stats[name] = value.value
+        return stats
+
+    def start_compositor(self, cols, rows, tile_width, tile_height):
+        '''
+        before join: the remote video of every view is drawn into one I420
+        gallery, the tile of a view is its place in the add_view order. with
+        enable_headless no window renders the streams
+        '''
+        _check("rtc_startCompositor", self.dll.rtc_startCompositor(cols, rows, tile_width, tile_height))
+
+    def stop_compositor(self):
+        self.dll.rtc_stopCompositor()
+
+    def composite(self, max_rects=COMPOSITOR_MAX_TILES):
+        '''bring the surface up to date, [(x, y, width, height)] of the tiles that changed'''
+        rects = (ctypes.c_int * (4 * max_rects))()
+        count = self.dll.rtc_composite(rects, max_rects)
+        return [tuple(rects[4 * i:4 * i + 4]) for i in range(count)]
+
+    def compositor_surface(self):
+        '''
+        (buffer, width, height) of the I420 gallery without a copy, e.g.
+        numpy.frombuffer(buffer, numpy.uint8). the content changes in composite
+        and the buffer is gone after stop_compositor; None while stopped
+        '''
+        width = ctypes.c_int()
+        height = ctypes.c_int()
+        address = self.dll.rtc_getCompositorSurface(ctypes.byref(width), ctypes.byref(height))
+        if not address:
+            return None
+        size = width.value * height.value * 3 // 2
+        return (ctypes.c_ubyte * size).from_address(address), width.value, height.value
+
+    def start_frame_export(self, prefix, max_width, max_height, interval_ms, slots=4):
+        '''
+        before join: the remote video of every participant is sampled into a
+        shared memory ring <prefix>_<uid or stream id>, at most one frame per
+        interval_ms scaled down to fit max_width x max_height. frame_ring.py
+        maps the rings in this or any other process
+        '''
+        _check("rtc_startFrameExport", self.dll.rtc_startFrameExport(prefix.encode(), max_width, max_height, interval_ms, slots))
+
+    def stop_frame_export(self):
+        self.dll.rtc_stopFrameExport()
+
+    def frame_export_names(self):
+        '''the rings created so far, frame_ring.FrameRing(name) opens one'''
+        size = self.dll.rtc_getFrameExportNames(None, 0) + 1
+        while True:
+            buffer = ctypes.create_string_buffer(size)
+            length = self.dll.rtc_getFrameExportNames(buffer, size)
+            # a ring was created in between
+            if length < size:
+                break
+            size = length + 1
+        return [name for name in buffer.value.decode().split("\n") if name]
+
+    def start_audio_sink(self, sample_rate=48000, channels=1, measure=True):
+        '''
+        before join: the remote audio is played into no device, a thread of
+        the wrapper pulls it every 10ms like a sound card would. with measure
+        the level, silent frames and glitches go to audio_sink_stats. on zego
+        the capture turns custom as well, only push_audio_frame is published
+        '''
+        _check("rtc_startAudioSink", self.dll.rtc_startAudioSink(sample_rate, channels, 1 if measure else 0))
+
+    def stop_audio_sink(self):
+        self.dll.rtc_stopAudioSink()
+
+    def audio_sink_stats(self):
+        '''{stat name: value}, level and peak of the last second in dBFS'''
+        stats = {}
+        value = ctypes.c_int64()
+        for i, name in enumerate(AUDIO_SINK_STATS):
+            _check("rtc_getAudioSinkStat", self.dll.rtc_getAudioSinkStat(i, ctypes.byref(value)))
+            stats[name] = value.value / 100.0 if name in ("level", "peak") else value.value
+        return stats
+
+    def start_audio_recording(self, directory, sample_rate=48000, channels=1):
+        '''
+        one wav per remote participant (<uid>.wav on agora) and per mix
+        (mixed.wav, and remote.wav on zego, which has no audio per stream)
+        into an existing directory. sample_rate and channels are those of
+        the mixes, the participants are written as decoded
+        '''
+        _check("rtc_startAudioRecording", self.dll.rtc_startAudioRecording(directory.encode(), sample_rate, channels))
+
+    def stop_audio_recording(self):
+        '''bytes of PCM written, the frames that found no room are in audio_recording_dropped'''
+        return self.dll.rtc_stopAudioRecording()
+
+    def audio_recording_dropped(self):
+        return self.dll.rtc_getAudioRecordingDropped()
+
+    def set_log_level(self, level):
+        self.dll.rtc_setLogLevel(level)
@@ -0,0 +1,514 @@
+// the vendor neutral exports, built into each wrapper dll next to the
+// GetRtcBackend of its vendor. rtc.py in the repo root binds them
+#include "Platform.h"
+#include "RtcBackend.h"
+#include "AgVideoBuffer.h"
+#include "CircleBuffer.h"
+#include "AGExtInfoManager.h"
+#include "StatsRecorder.h"
+#include "LatencyStats.h"
+#include "ParticipantRegistry.h"
+#include "VideoCompositor.h"
+#include "VideoFrameExport.h"
+#include "AudioSink.h"
+#include "AudioRecorder.h"
+#include "Logger.h"
+
+#define RTC_API __declspec(dllexport)
+
+#define RTC_CHECK_ENGINE(lpBackend) \
+	do \
+	{ \
+		if (!(lpBackend)->HasEngine()) \
+			return RTC_ERR_NO_ENGINE; \
+	} while (0)
+
+/**
+	the vendor of this dll, "agora" or "zego"
+*/
+extern "C" RTC_API const char* rtc_getBackendName()
+{
+	return GetRtcBackend()->GetName();
+}
+
+/**
+	create the engine of the backend and its event ring
+Parameters:
+@param lpAppId	app id, NULL keeps the id the backend has built in
+@return RTC_RESULT
+*/
+extern "C" RTC_API int rtc_createEngine(const char* lpAppId)
+{
+	LOG_INFO("rtc_createEngine %s", GetRtcBackend()->GetName());
+	return GetRtcBackend()->CreateEngine(lpAppId);
+}
+
+extern "C" RTC_API void rtc_destroyEngine()
+{
+	LOG_INFO("rtc_destroyEngine");
+	// the puller calls into the engine
+	CAudioSink::GetInstance()->Stop();
+	CAudioRecorder::GetInstance()->Stop();
+	GetRtcBackend()->DestroyEngine();
+	CLogger::GetInstance()->Flush();
+}
+
+/**
+	join a channel (agora) or log into a room and publish (zego)
+Parameters:
+@param lpChannelId	channel or room id
+@param lpUserId	uid as a decimal string for agora, user and stream id for zego
+@return RTC_RESULT
+*/
+extern "C" RTC_API int rtc_joinChannel(const char* lpChannelId, const char* lpUserId)
+{
+	IRtcBackend* lpBackend = GetRtcBackend();
+	RTC_CHECK_ENGINE(lpBackend);
+	if (lpChannelId == NULL || lpUserId == NULL)
+		return RTC_ERR_INVALID_ARG;
+	return lpBackend->JoinChannel(lpChannelId, lpUserId);
+}
+
+// ms from rtc_joinChannel to joined, or RTC_ERR_TIMEOUT. <0 waits forever
+extern "C" RTC_API int rtc_waitJoinChannel(int nTimeoutMs)
+{
+	IRtcBackend* lpBackend = GetRtcBackend();
+	RTC_CHECK_ENGINE(lpBackend);
+	return lpBackend->WaitJoinChannel(nTimeoutMs);
+}
+
+extern "C" RTC_API int rtc_leaveChannel()
+{
+	IRtcBackend* lpBackend = GetRtcBackend();
+	RTC_CHECK_ENGINE(lpBackend);
+	return lpBackend->LeaveChannel();
+}
+
+extern "C" RTC_API int rtc_enableVideo(int bEnable)
+{
+	IRtcBackend* lpBackend = GetRtcBackend();
+	RTC_CHECK_ENGINE(lpBackend);
+	return lpBackend->EnableVideo(bEnable != 0);
+}
+
+extern "C" RTC_API int rtc_enableAudio(int bEnable)
+{
+	IRtcBackend* lpBackend = GetRtcBackend();
+	RTC_CHECK_ENGINE(lpBackend);
+	return lpBackend->EnableAudio(bEnable != 0);
+}
+
+/**
+	capture and encode size, frame rate and bitrate of the published video
+Parameters:
+@param nBitrate	kbps
+@return RTC_RESULT
+*/
+extern "C" RTC_API int rtc_setVideoProfile(int nWidth, int nHeight, int nFps, int nBitrate)
+{
+	IRtcBackend* lpBackend = GetRtcBackend();
+	RTC_CHECK_ENGINE(lpBackend);
+	return lpBackend->SetVideoProfile(nWidth, nHeight, nFps, nBitrate);
+}
+
+/**
+	audio preset and codec of the published audio, numbered by the vendor
+Parameters:
+@param nProfile	AUDIO_PROFILE_TYPE (agora), ZegoAudioConfigPreset (zego)
+@param lpCodec	NULL for the codec of the profile, a che.audio.specify.codec name
+				such as "OPUSFB" (agora) or a decimal ZegoAudioCodecID (zego)
+@return RTC_RESULT
+*/
+extern "C" RTC_API int rtc_setAudioProfile(int nProfile, const char* lpCodec)
+{
+	IRtcBackend* lpBackend = GetRtcBackend();
+	RTC_CHECK_ENGINE(lpBackend);
+	return lpBackend->SetAudioProfile(nProfile, lpCodec);
+}
+
+/**
+	add a render target, the first one shows the local preview and the next
+	ones the remote users in the order they arrive
+*/
+extern "C" RTC_API void rtc_addView(void* hView)
+{
+	CAGExtInfoManager::GetAGExtInfoManager()->AddView((VHANDLE)hView);
+}
+
+/**
+	the size the view is shown at, a remote stream in a view smaller than
+	VIEW_HIGH_STREAM_MIN_WIDTH x VIEW_HIGH_STREAM_MIN_HEIGHT is played from the
+	low stream. on windows the client rect of a view without a size is used
+*/
+extern "C" RTC_API int rtc_setViewSize(void* hView, int nWidth, int nHeight)
+{
+	if (hView == NULL || nWidth <= 0 || nHeight <= 0)
+		return RTC_ERR_INVALID_ARG;
+	CAGExtInfoManager::GetAGExtInfoManager()->SetViewSize((VHANDLE)hView, nWidth, nHeight);
+	return RTC_OK;
+}
+
+// publish the low stream next to the normal one, on unless turned off before joining
+extern "C" RTC_API int rtc_enableDualStream(int bEnable)
+{
+	IRtcBackend* lpBackend = GetRtcBackend();
+	RTC_CHECK_ENGINE(lpBackend);
+	return lpBackend->EnableDualStream(bEnable != 0);
+}
+
+/**
+	a robot without windows: no preview, the remote streams are decoded into
+	a null renderer. call before joining, the views added are then only
+	slots for the remote streams, any distinct non NULL handles will do
+*/
+extern "C" RTC_API int rtc_enableHeadless(int bEnable)
+{
+	IRtcBackend* lpBackend = GetRtcBackend();
+	RTC_CHECK_ENGINE(lpBackend);
+	return lpBackend->EnableHeadless(bEnable != 0);
+}
+
+/**
+	draw the remote video of every view into one I420 gallery of nCols x nRows
+	tiles, the tile of a view is its place in the rtc_addView order. call
+	before joining, with rtc_enableHeadless no window renders the streams
+Parameters:
+@param nTileWidth	tile size, even, the gallery is at most COMPOSITOR_MAX_WIDTH x COMPOSITOR_MAX_HEIGHT
+@return RTC_RESULT
+*/
+extern "C" RTC_API int rtc_startCompositor(int nCols, int nRows, int nTileWidth, int nTileHeight)
+{
+	IRtcBackend* lpBackend = GetRtcBackend();
+	RTC_CHECK_ENGINE(lpBackend);
+	if (!CVideoCompositor::GetInstance()->Start(nCols, nRows, nTileWidth, nTileHeight))
+		return RTC_ERR_INVALID_ARG;
+
+	int nRet = lpBackend->EnableRemoteVideoFrames(true);
+	if (nRet != RTC_OK)
+		CVideoCompositor::GetInstance()->Stop();
+	return nRet;
+}
+
+// the remote frames stay on while the frame export still takes them
+extern "C" RTC_API void rtc_stopCompositor()
+{
+	IRtcBackend* lpBackend = GetRtcBackend();
+	if (lpBackend->HasEngine() && !CVideoFrameExport::GetInstance()->IsRunning())
+		lpBackend->EnableRemoteVideoFrames(false);
+	CVideoCompositor::GetInstance()->Stop();
+}
+
+/**
+	bring the gallery up to date, the surface does not change until the next call
+Parameters:
+@param lpRects	nMaxRects times x, y, width, height of the tiles that changed
+@return number of rects, a single rect of the whole gallery when more changed
+*/
+extern "C" RTC_API int rtc_composite(int* lpRects, int nMaxRects)
+{
+	static_assert(sizeof(COMPOSITOR_RECT) == 4 * sizeof(int), "rtc_composite hands out COMPOSITOR_RECT as ints");
+	return CVideoCompositor::GetInstance()->Composite((COMPOSITOR_RECT*)lpRects, nMaxRects);
+}
+
+/**
+	the I420 gallery, width x height luma then the two quarter size chroma
+	planes. NULL while stopped, the pointer is good until rtc_stopCompositor
+*/
+extern "C" RTC_API const void* rtc_getCompositorSurface(int* lpWidth, int* lpHeight)
+{
+	int nWidth = 0, nHeight = 0;
+	const BYTE* lpSurface = CVideoCompositor::GetInstance()->GetSurface(nWidth, nHeight);
+	if (lpWidth != NULL)
+		*lpWidth = nWidth;
+	if (lpHeight != NULL)
+		*lpHeight = nHeight;
+	return lpSurface;
+}
+
+/**
+	sample the decoded video of every remote participant into a shared memory
+	ring of its own named <prefix>_<uid or stream id>, frame_ring.py maps it.
+	call before joining, it runs beside the compositor
+Parameters:
+@param lpPrefix	letters, digits, '_' and '-', e.g. rtc_<pid>
+@param nMaxWidth	frames larger than nMaxWidth x nMaxHeight are scaled down to fit
+@param nIntervalMs	at most one frame per participant and interval, 0 for every frame
+@param nSlots	frames kept per participant, FRAME_EXPORT_MIN_SLOTS..FRAME_EXPORT_MAX_SLOTS
+@return RTC_RESULT
+*/
+extern "C" RTC_API int rtc_startFrameExport(const char* lpPrefix, int nMaxWidth, int nMaxHeight, int nIntervalMs, int nSlots)
+{
+	IRtcBackend* lpBackend = GetRtcBackend();
+	RTC_CHECK_ENGINE(lpBackend);
+	if (!CVideoFrameExport::GetInstance()->Start(lpPrefix, nMaxWidth, nMaxHeight, nIntervalMs, nSlots))
+		return RTC_ERR_INVALID_ARG;
+
+	int nRet = lpBackend->EnableRemoteVideoFrames(true);
+	if (nRet != RTC_OK)
+		CVideoFrameExport::GetInstance()->Stop();
+	return nRet;
+}
+
+// the rings are marked closed and their names removed, mapped readers keep them
+extern "C" RTC_API void rtc_stopFrameExport()
+{
+	IRtcBackend* lpBackend = GetRtcBackend();
+	if (lpBackend->HasEngine() && !CVideoCompositor::GetInstance()->IsRunning())
+		lpBackend->EnableRemoteVideoFrames(false);
+	CVideoFrameExport::GetInstance()->Stop();
+}
+
+/**
+	the names of the rings created so far, one per line
+Parameters:
+@param lpBuffer	gets as much as fits, 0 terminated
+@return length of all names without the 0, larger than nSize - 1 when cut
+*/
+extern "C" RTC_API int rtc_getFrameExportNames(char* lpBuffer, int nSize)
+{
+	std::string strNames = CVideoFrameExport::GetInstance()->GetNames();
+	if (lpBuffer != NULL && nSize > 0)
+	{
+		size_t nCopy = strNames.size() < (size_t)nSize - 1 ? strNames.size() : (size_t)nSize - 1;
+		memcpy(lpBuffer, strNames.data(), nCopy);
+		lpBuffer[nCopy] = '\0';
+	}
+	return (int)strNames.size();
+}
+
+/**
+	play the remote audio into no device: the SDK mixes it into an external
+	sink and a thread of the dll pulls 10ms frames from it in real time, so
+	a robot decodes the audio of the channel without a sound card. call
+	before joining. on zego this is the custom audio IO, which also takes
+	the capture, a robot that publishes audio pushes it with rtc_pushAudioFrame
+Parameters:
+@param nSampleRate	8000, 16000, 32000, 44100 or 48000
+@param nChannels	1 or 2
+@param bMeasure	0 throws the audio away, otherwise level, silence and glitches go to rtc_getAudioSinkStat
+@return RTC_RESULT
+*/
+extern "C" RTC_API int rtc_startAudioSink(int nSampleRate, int nChannels, int bMeasure)
+{
+	IRtcBackend* lpBackend = GetRtcBackend();
+	RTC_CHECK_ENGINE(lpBackend);
+	if (nSampleRate <= 0 || nSampleRate % 100 != 0 || (nChannels != 1 && nChannels != 2))
+		return RTC_ERR_INVALID_ARG;
+
+	int nRet = lpBackend->EnableAudioSink(true, nSampleRate, nChannels);
+	if (nRet != RTC_OK)
+		return nRet;
+
+	auto pull = [lpBackend, nSampleRate, nChannels](int16_t* lpPcm, int nSamples) {
+		return lpBackend->PullAudioFrame(lpPcm, nSamples, nSampleRate, nChannels);
+	};
+	if (!CAudioSink::GetInstance()->Start(nSampleRate, nChannels, bMeasure ? AUDIO_SINK_MEASURE : AUDIO_SINK_DISCARD, pull))
+	{
+		lpBackend->EnableAudioSink(false, nSampleRate, nChannels);
+		return RTC_ERR_INVALID_ARG;
+	}
+	return RTC_OK;
+}
+
+// the counters keep their last values until the next start
+extern "C" RTC_API void rtc_stopAudioSink()
+{
+	CAudioSink::GetInstance()->Stop();
+	IRtcBackend* lpBackend = GetRtcBackend();
+	if (lpBackend->HasEngine())
+		lpBackend->EnableAudioSink(false, 0, 0);
+}
+
+/**
+Parameters:
+@param nStat	AUDIO_SINK_STAT
+@param lpValue	gets the counter, levels in dBFS * 100
+@return RTC_OK, or RTC_ERR_INVALID_ARG for an unknown stat
+*/
+extern "C" RTC_API int rtc_getAudioSinkStat(int nStat, int64_t* lpValue)
+{
+	if (nStat < 0 || nStat >= AUDIO_SINK_STAT_COUNT || lpValue == NULL)
+		return RTC_ERR_INVALID_ARG;
+	*lpValue = CAudioSink::GetInstance()->GetStat(nStat);
+	return RTC_OK;
+}
+
+/**
+	record the remote audio to disk, one wav file per track in lpDir:
+	<uid>.wav per participant and mixed.wav on agora, remote.wav (the mix of
+	the played streams) and mixed.wav on zego. the audio callbacks only copy
+	into a ring, a thread of the dll writes the files. works in and out of
+	a channel, a participant's file starts with its first frame
+Parameters:
+@param lpDir	existing directory, files of the same tracks in it are overwritten
+@param nSampleRate	of the mixes, 8000, 16000, 32000, 44100 or 48000. participants are recorded as decoded
+@param nChannels	of the mixes on zego, 1 or 2. agora mixes in the channels of the SDK
+@return RTC_RESULT
+*/
+extern "C" RTC_API int rtc_startAudioRecording(const char* lpDir, int nSampleRate, int nChannels)
+{
+	IRtcBackend* lpBackend = GetRtcBackend();
+	RTC_CHECK_ENGINE(lpBackend);
+	if (nSampleRate <= 0 || nSampleRate % 100 != 0 || (nChannels != 1 && nChannels != 2))
+		return RTC_ERR_INVALID_ARG;
+	if (CAudioRecorder::GetInstance()->Start(lpDir) != 0)
+		return RTC_ERR_INVALID_ARG;
+
+	int nRet = lpBackend->EnableAudioRecording(true, nSampleRate, nChannels);
+	if (nRet != RTC_OK)
+		CAudioRecorder::GetInstance()->Stop();
+	return nRet;
+}
+
+/**
+	close the files of rtc_startAudioRecording
+@return bytes of PCM written, -1 when not recording
+*/
+extern "C" RTC_API int64_t rtc_stopAudioRecording()
+{
+	IRtcBackend* lpBackend = GetRtcBackend();
+	if (lpBackend->HasEngine())
+		lpBackend->EnableAudioRecording(false, 0, 0);
+	return CAudioRecorder::GetInstance()->Stop();
+}
+
+// frames of the current or last recording that found no room
+extern "C" RTC_API int64_t rtc_getAudioRecordingDropped()
+{
+	return CAudioRecorder::GetInstance()->GetDroppedCount();
+}
+
+extern "C" RTC_API int rtc_enableCustomVideoCapture()
+{
+	IRtcBackend* lpBackend = GetRtcBackend();
+	RTC_CHECK_ENGINE(lpBackend);
+	return lpBackend->EnableCustomVideoCapture();
+}
+
+extern "C" RTC_API int rtc_enableCustomAudioCapture(int nSampleRate, int nChannels)
+{
+	IRtcBackend* lpBackend = GetRtcBackend();
+	RTC_CHECK_ENGINE(lpBackend);
+	if (nSampleRate <= 0 || (nChannels != 1 && nChannels != 2))
+		return RTC_ERR_INVALID_ARG;
+	return lpBackend->EnableCustomAudioCapture(nSampleRate, nChannels);
+}
+
+/**
+	replace the frame the custom video capture publishes next, both backends
+	read it from the same buffer
+Parameters:
+@param buff	first row of the (h*3/2, w) I420 frame
+@param nStride	bytes from one row to the next, at least w
+@return RTC_OK, or RTC_ERR_INVALID_ARG when the frame does not fit the capture buffer
+*/
+extern "C" RTC_API int rtc_pushVideoFrame(const char* buff, int w, int h, int nStride)
+{
+	if (buff == NULL || !CAgVideoBuffer::GetInstance()->writeBuffer((const BYTE*)buff, w, h, nStride))
+		return RTC_ERR_INVALID_ARG;
+	return RTC_OK;
+}
+
+/**
+	queue 16 bit PCM for the custom audio capture, blocks while the buffer is full
+Parameters:
+@param nSize	bytes, at most half of the buffer
+@return RTC_OK, or RTC_ERR_INVALID_ARG
+*/
+extern "C" RTC_API int rtc_pushAudioFrame(const char* buff, int nSize)
+{
+	if (buff == NULL || nSize <= 0 || !CircleBuffer::GetInstance()->writeBuffer(buff, nSize))
+		return RTC_ERR_INVALID_ARG;
+	return RTC_OK;
+}
+
+/**
+	record the stats callbacks of the backend to a binary file until
+	rtc_stopStatsRecording, stats_csv.py converts it
+@return 0, or -1 when already recording or the file can not be created
+*/
+extern "C" RTC_API int rtc_startStatsRecording(const char* lpPath)
+{
+	return CStatsRecorder::GetInstance()->Start(lpPath, GetRtcBackend()->GetStatsSchemas());
+}
+
+// number of samples written, -1 when not recording
+extern "C" RTC_API int64_t rtc_stopStatsRecording()
+{
+	return CStatsRecorder::GetInstance()->Stop();
+}
+
+/**
+	a percentile of one stage of the pushed frames on their way into the SDK
+Parameters:
+@param nStage	LATENCY_STAGE
+@param dPercentile	0 to 100
+@return ns, 0 before the first frame, RTC_ERR_INVALID_ARG for an unknown stage
+*/
+extern "C" RTC_API int64_t rtc_getLatency(int nStage, double dPercentile)
+{
+	const CHdrHistogram* lpHistogram = CLatencyStats::GetInstance()->GetHistogram(nStage);
+	if (lpHistogram == NULL || dPercentile < 0 || dPercentile > 100)
+		return RTC_ERR_INVALID_ARG;
+	return lpHistogram->getValueAtPercentile(dPercentile);
+}
+
+// frames recorded for nStage, RTC_ERR_INVALID_ARG for an unknown stage
+extern "C" RTC_API int64_t rtc_getLatencyCount(int nStage)
+{
+	const CHdrHistogram* lpHistogram = CLatencyStats::GetInstance()->GetHistogram(nStage);
+	if (lpHistogram == NULL)
+		return RTC_ERR_INVALID_ARG;
+	return lpHistogram->getTotalCount();
+}
+
+extern "C" RTC_API void rtc_resetLatency()
+{
+	CLatencyStats::GetInstance()->Reset();
+}
+
+/**
+	rewrite a file with the latency histograms every nIntervalMs until
+	rtc_stopLatencyDump, "# name ns" and "value count" lines per stage like
+	the churn histograms
+@return 0, or -1 when already dumping or the file can not be created
+*/
+extern "C" RTC_API int rtc_startLatencyDump(const char* lpPath, int nIntervalMs)
+{
+	return CLatencyStats::GetInstance()->StartDump(lpPath, nIntervalMs);
+}
+
+// writes the file a last time
+extern "C" RTC_API void rtc_stopLatencyDump()
+{
+	CLatencyStats::GetInstance()->StopDump();
+}
+
+// remote participants of the channel, shown or waiting for a view
+extern "C" RTC_API int rtc_getParticipantCount()
+{
+	return CParticipantRegistry::GetInstance()->GetCount();
+}
+
+/**
+	the last value the stats callbacks reported for a participant, read
+	without a lock
+Parameters:
+@param lpId	the uid as a decimal string for agora, the stream id for zego
+@param nStat	PARTICIPANT_STAT
+@return RTC_OK, RTC_ERR_INVALID_ARG for an unknown participant or stat
+*/
+extern "C" RTC_API int rtc_getParticipantStat(const char* lpId, int nStat, int* lpValue)
+{
+	int32_t nValue = 0;
+	if (lpId == NULL || lpValue == NULL || !CParticipantRegistry::GetInstance()->GetStat(lpId, nStat, nValue))
+		return RTC_ERR_INVALID_ARG;
+	*lpValue = nValue;
+	return RTC_OK;
+}
+
+// LOG_LEVEL, 0 debug 1 info 2 warn 3 error 4 off
+extern "C" RTC_API void rtc_setLogLevel(int nLevel)
+{
+	CLogger::SetLevel(nLevel);
+}
@@ -0,0 +1,58 @@
+#include "MockCadence.h"
+
+CMockCadence::CMockCadence()
+	: m_bRunning(false)
+	, m_nTicks(0)
+	, m_nDropped(0)
+{
+}
+
+CMockCadence::~CMockCadence()
+{
+	Stop();
+}
+
+void CMockCadence::Start(int64_t nPeriodUs, std::function<void()> fn)
+{
+	Stop();
+	m_nTicks = 0;
+	m_nDropped = 0;
+	m_bRunning = true;
+	m_thread = std::thread(&CMockCadence::Run, this, nPeriodUs, std::move(fn));
+}
+
+void CMockCadence::Stop()
+{
+	m_bRunning = false;
+	if (!m_thread.joinable())
+		return;
+	if (m_thread.get_id() != std::this_thread::get_id())
+		m_thread.join();
+	else
+		m_thread.detach();
+}
+
+void CMockCadence::Run(int64_t nPeriodUs, std::function<void()> fn)
+{
+	const std::chrono::microseconds period(nPeriodUs > 0 ? nPeriodUs : 1);
+	auto next = std::chrono::steady_clock::now() + period;
+
+	while (m_bRunning)
+	{
+		std::this_thread::sleep_until(next);
+		if (!m_bRunning)
+			break;
+
+		fn();
+		m_nTicks++;
+
+		next += period;
+		auto now = std::chrono::steady_clock::now();
+		if (now >= next + period)
+		{
+			int64_t nMissed = (now - next) / period;
+			m_nDropped += nMissed;
+			next += period * nMissed;
+		}
+	}
+}
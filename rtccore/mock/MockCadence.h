@@ -0,0 +1,33 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+/**
+	calls fn every nPeriodUs on its own thread, like a capture device or the
+	10ms audio clock. ticks are scheduled on absolute deadlines so the cadence
+	does not drift; when the callback overruns a whole period the missed ticks
+	are dropped and counted, the same way a camera drops frames
+*/
+class CMockCadence
+{
+public:
+	CMockCadence();
+	~CMockCadence();
+
+	void Start(int64_t nPeriodUs, std::function<void()> fn);
+	void Stop();
+	bool IsRunning() { return m_bRunning; }
+
+	int64_t GetTicks() { return m_nTicks; }
+	int64_t GetDropped() { return m_nDropped; }
+
+private:
+	void Run(int64_t nPeriodUs, std::function<void()> fn);
+
+	std::atomic<bool>		m_bRunning;
+	std::atomic<int64_t>	m_nTicks;
+	std::atomic<int64_t>	m_nDropped;
+	std::thread				m_thread;
+};
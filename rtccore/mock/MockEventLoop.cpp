@@ -0,0 +1,68 @@
+#include "MockEventLoop.h"
+
+CMockEventLoop::CMockEventLoop()
+	: m_nSeq(0)
+	, m_bStop(false)
+{
+	m_thread = std::thread(&CMockEventLoop::Run, this);
+}
+
+CMockEventLoop::~CMockEventLoop()
+{
+	Stop();
+}
+
+void CMockEventLoop::Post(int nDelayMs, std::function<void()> fn)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_bStop)
+		return;
+
+	m_queue.push({ std::chrono::steady_clock::now() + std::chrono::milliseconds(nDelayMs), m_nSeq++, std::move(fn) });
+	m_cond.notify_one();
+}
+
+/**
+	pending events are dropped, an event already running is finished first
+*/
+void CMockEventLoop::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bStop = true;
+		m_cond.notify_one();
+	}
+	if (!m_thread.joinable())
+		return;
+	if (m_thread.get_id() != std::this_thread::get_id())
+		m_thread.join();
+	else
+		m_thread.detach();
+}
+
+void CMockEventLoop::Run()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (!m_bStop)
+	{
+		if (m_queue.empty())
+		{
+			m_cond.wait(lock);
+			continue;
+		}
+
+		auto due = m_queue.top().due;
+		if (std::chrono::steady_clock::now() < due)
+		{
+			m_cond.wait_until(lock, due);
+			continue;
+		}
+
+		auto fn = std::move(const_cast<MOCK_EVENT&>(m_queue.top()).fn);
+		m_queue.pop();
+
+		lock.unlock();
+		fn();
+		lock.lock();
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+	single thread that runs delayed callbacks in due order, stands in for
+	the SDK callback thread of the mock engines
+*/
+class CMockEventLoop
+{
+public:
+	CMockEventLoop();
+	~CMockEventLoop();
+
+	void Post(int nDelayMs, std::function<void()> fn);
+	void Stop();
+
+private:
+	void Run();
+
+	struct MOCK_EVENT
+	{
+		std::chrono::steady_clock::time_point due;
+		unsigned long long seq;
+		std::function<void()> fn;
+	};
+
+	struct CLater
+	{
+		bool operator()(const MOCK_EVENT& a, const MOCK_EVENT& b) const
+		{
+			return a.due != b.due ? a.due > b.due : a.seq > b.seq;
+		}
+	};
+
+	std::mutex m_mutex;
+	std::condition_variable m_cond;
+	std::priority_queue<MOCK_EVENT, std::vector<MOCK_EVENT>, CLater> m_queue;
+	unsigned long long m_nSeq;
+	bool m_bStop;
+	std::thread m_thread;
+};
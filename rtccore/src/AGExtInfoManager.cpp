@@ -0,0 +1,167 @@
+#include "AGExtInfoManager.h"
+
+
+CAGExtInfoManager *CAGExtInfoManager::m_lpExtInfoManager = NULL;
+
+CAGExtInfoManager::CAGExtInfoManager()
+{
+}
+
+
+CAGExtInfoManager::~CAGExtInfoManager()
+{
+}
+
+CAGExtInfoManager *CAGExtInfoManager::GetAGExtInfoManager()
+{
+	if (m_lpExtInfoManager == NULL)
+		m_lpExtInfoManager = new CAGExtInfoManager();
+
+	return m_lpExtInfoManager;
+}
+
+void CAGExtInfoManager::CloseAGExtInfoManager()
+{
+	if (m_lpExtInfoManager){
+		delete m_lpExtInfoManager;
+		m_lpExtInfoManager = NULL;
+	}
+}
+
+void CAGExtInfoManager::AddView(VHANDLE hWnd)
+{
+	std::lock_guard<std::mutex> lock(m_lockView);
+	if (m_wndFreeView.count(hWnd) != 0 || m_wndBusyView.count(hWnd) != 0)
+		return;
+
+	if (m_mapViewIndex.find(hWnd) == m_mapViewIndex.end())
+	{
+		m_mapViewIndex[hWnd] = (int)m_wnds.size();
+		m_wnds.push_back(hWnd);
+	}
+	m_wndFreeView.insert(hWnd);
+	m_wndFreeQueue.push_back(hWnd);
+}
+
+void CAGExtInfoManager::RemoveView(VHANDLE hView)
+{
+	std::lock_guard<std::mutex> lock(m_lockView);
+	m_wndFreeView.erase(hView);
+}
+
+// skips the views that were taken or removed since they were queued
+VHANDLE CAGExtInfoManager::PopFreeView()
+{
+	while (!m_wndFreeQueue.empty())
+	{
+		VHANDLE hView = m_wndFreeQueue.front();
+		m_wndFreeQueue.pop_front();
+		if (m_wndFreeView.erase(hView) != 0)
+			return hView;
+	}
+	return NULL;
+}
+
+VHANDLE CAGExtInfoManager::AllocView()
+{
+	std::lock_guard<std::mutex> lock(m_lockView);
+	VHANDLE hView = PopFreeView();
+	if (hView != NULL)
+		m_wndBusyView.insert(hView);
+
+	return hView;
+}
+
+void CAGExtInfoManager::FreeView(VHANDLE hView)
+{
+	std::lock_guard<std::mutex> lock(m_lockView);
+	if (m_wndBusyView.erase(hView) == 0)
+		return;
+
+	m_wndFreeView.insert(hView);
+	m_wndFreeQueue.push_back(hView);
+}
+
+void CAGExtInfoManager::FreeAllView()
+{
+	std::lock_guard<std::mutex> lock(m_lockView);
+	m_wndFreeQueue.clear();
+	m_wndFreeView.clear();
+	m_wndBusyView.clear();
+	for (size_t i = 0; i < m_wnds.size(); i++){
+		if (m_wndFreeView.insert(m_wnds[i]).second)
+			m_wndFreeQueue.push_back(m_wnds[i]);
+	}
+}
+
+VHANDLE CAGExtInfoManager::GetOneFreeView()
+{
+	return AllocView();
+}
+
+VHANDLE CAGExtInfoManager::GetFirstView()
+{
+	std::lock_guard<std::mutex> lock(m_lockView);
+	if (m_wnds.empty())
+		return NULL;
+
+	// left in the queue, PopFreeView drops it
+	if (m_wndFreeView.erase(m_wnds[0]) != 0)
+		m_wndBusyView.insert(m_wnds[0]);
+
+	return  m_wnds[0];
+}
+
+VHANDLE CAGExtInfoManager::GetViewAt(int i)
+{
+	std::lock_guard<std::mutex> lock(m_lockView);
+	if (i < 0 || i >= (int)m_wnds.size())
+		return NULL;
+
+	return m_wnds[i];
+}
+
+int CAGExtInfoManager::GetViewIndex(VHANDLE hView)
+{
+	std::lock_guard<std::mutex> lock(m_lockView);
+	auto it = m_mapViewIndex.find(hView);
+	return it != m_mapViewIndex.end() ? it->second : -1;
+}
+
+void CAGExtInfoManager::SetViewSize(VHANDLE hView, int nWidth, int nHeight)
+{
+	std::lock_guard<std::mutex> lock(m_lockSize);
+	m_mapViewSize[hView] = std::make_pair(nWidth, nHeight);
+}
+
+bool CAGExtInfoManager::GetViewSize(VHANDLE hView, int& nWidth, int& nHeight)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_lockSize);
+		auto it = m_mapViewSize.find(hView);
+		if (it != m_mapViewSize.end())
+		{
+			nWidth = it->second.first;
+			nHeight = it->second.second;
+			return true;
+		}
+	}
+#ifdef _WIN32
+	RECT rect;
+	if (hView != NULL && ::IsWindow((HWND)hView) && ::GetClientRect((HWND)hView, &rect))
+	{
+		nWidth = rect.right - rect.left;
+		nHeight = rect.bottom - rect.top;
+		return true;
+	}
+#endif
+	return false;
+}
+
+bool CAGExtInfoManager::IsSmallView(VHANDLE hView)
+{
+	int nWidth = 0, nHeight = 0;
+	if (!GetViewSize(hView, nWidth, nHeight))
+		return false;
+	return nWidth < VIEW_HIGH_STREAM_MIN_WIDTH || nHeight < VIEW_HIGH_STREAM_MIN_HEIGHT;
+}
@@ -0,0 +1,83 @@
+#include "AgVideoBuffer.h"
+#include "MediaClock.h"
+#include <mutex>
+
+std::mutex buf_mutex;
+BYTE CAgVideoBuffer::videoBuffer[VIDEO_BUF_SIZE] = { 0 };
+
+CAgVideoBuffer* CAgVideoBuffer::GetInstance()
+{
+    static CAgVideoBuffer agVideoBuffer;
+    return &agVideoBuffer;
+}
+
+CAgVideoBuffer::CAgVideoBuffer()
+    : timestamp(0)
+    , m_nPushNs(0)
+    , m_nPublishNs(0)
+    , m_w(0)
+    , m_h(0)
+{
+
+}
+
+CAgVideoBuffer::~CAgVideoBuffer()
+{
+
+}
+
+bool CAgVideoBuffer::writeBuffer(BYTE* buffer, int w, int h)
+{
+    int64_t nPushNs = CMediaClock::NowNs();
+    std::lock_guard<std::mutex> buf_lock(buf_mutex);
+ 
+	memcpy(videoBuffer, buffer, w*h*1.5);
+    timestamp = (int)CMediaClock::NowMs();
+    m_nPushNs = nPushNs;
+    m_nPublishNs = CMediaClock::NowNs();
+    m_w = w;
+    m_h = h;
+    return true;
+}
+bool CAgVideoBuffer::writeBuffer(const BYTE* buffer, int w, int h, int nStride)
+{
+    if (w <= 0 || h <= 0 || nStride < w || (int64_t)w * h * 3 / 2 > VIDEO_BUF_SIZE)
+        return false;
+
+    // the wait for a reader holding the buffer counts as push to publish
+    int64_t nPushNs = CMediaClock::NowNs();
+    std::lock_guard<std::mutex> buf_lock(buf_mutex);
+    if (nStride == w)
+        memcpy(videoBuffer, buffer, (size_t)w * h * 3 / 2);
+    else
+        for (int row = 0; row < h * 3 / 2; row++)
+            memcpy(videoBuffer + row * w, buffer + (int64_t)row * nStride, w);
+    timestamp = (int)CMediaClock::NowMs();
+    m_nPushNs = nPushNs;
+    m_nPublishNs = CMediaClock::NowNs();
+    m_w = w;
+    m_h = h;
+    return true;
+}
+
+bool CAgVideoBuffer::readBuffer(BYTE* buffer, int& ts, int &w, int &h)
+{
+    std::lock_guard<std::mutex> buf_lock(buf_mutex);
+    memcpy(buffer, videoBuffer, m_w*m_h*1.5);
+    ts = timestamp;
+    w = m_w;
+    h = m_h;
+    return true;
+}
+
+bool CAgVideoBuffer::readBuffer(BYTE* buffer, LATENCY_STAMP& stamp, int &w, int &h)
+{
+    std::lock_guard<std::mutex> buf_lock(buf_mutex);
+    memcpy(buffer, videoBuffer, m_w*m_h*1.5);
+    stamp.nPushNs = m_nPushNs;
+    stamp.nPublishNs = m_nPublishNs;
+    stamp.nReadNs = CMediaClock::NowNs();
+    w = m_w;
+    h = m_h;
+    return true;
+}
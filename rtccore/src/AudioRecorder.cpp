@@ -0,0 +1,307 @@
+#include "AudioRecorder.h"
+#include "Logger.h"
+#include "Platform.h"
+#include "Singleton.h"
+#include <chrono>
+#include <string.h>
+#include <thread>
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+static bool IsDirectory(const char* lpPath)
+{
+#ifdef _WIN32
+	DWORD dwAttributes = GetFileAttributesA(lpPath);
+	return dwAttributes != INVALID_FILE_ATTRIBUTES && (dwAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+#else
+	struct stat st;
+	return stat(lpPath, &st) == 0 && S_ISDIR(st.st_mode);
+#endif
+}
+
+static bool IsNameChar(char c)
+{
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '-';
+}
+
+static void PutLE(uint8_t* lpOut, uint32_t nValue, int nBytes)
+{
+	for (int i = 0; i < nBytes; i++)
+		lpOut[i] = (uint8_t)(nValue >> (i * 8));
+}
+
+std::atomic<bool> CAudioRecorder::m_bRecording(false);
+
+RTC_DEFINE_SINGLETON(CAudioRecorder)
+
+// the rings are allocated once and never initialized, untouched pages cost nothing
+CAudioRecorder::CAudioRecorder()
+	: m_nDropped(0)
+	, m_nWritten(0)
+	, m_bStop(false)
+{
+	for (AUDIO_TRACK& track : m_tracks)
+	{
+		track.nState.store(TRACK_FREE, std::memory_order_relaxed);
+		track.szId[0] = '\0';
+		track.nSampleRate = 0;
+		track.nChannels = 0;
+		track.lpRing.reset(new uint8_t[AUDIO_RECORD_RING_BYTES]);
+		track.nWritePos.store(0, std::memory_order_relaxed);
+		track.nReadPos.store(0, std::memory_order_relaxed);
+		track.lpFile = NULL;
+		track.bFailed = false;
+		track.nDataBytes = 0;
+	}
+}
+
+int CAudioRecorder::Start(const char* lpDir)
+{
+	std::lock_guard<std::mutex> lock(m_lockControl);
+	if (m_thread.joinable() || lpDir == NULL || !IsDirectory(lpDir))
+		return -1;
+
+	for (AUDIO_TRACK& track : m_tracks)
+	{
+		track.nState.store(TRACK_FREE, std::memory_order_relaxed);
+		track.nWritePos.store(0, std::memory_order_relaxed);
+		track.nReadPos.store(0, std::memory_order_relaxed);
+		track.bFailed = false;
+		track.nDataBytes = 0;
+	}
+	m_nDropped.store(0, std::memory_order_relaxed);
+	m_nWritten = 0;
+	m_strDir = lpDir;
+
+	m_bStop = false;
+	m_thread = std::thread(&CAudioRecorder::ThreadProc, this);
+	m_bRecording.store(true, std::memory_order_release);
+	LOG_INFO("audio recording into %s", lpDir);
+	return 0;
+}
+
+int64_t CAudioRecorder::Stop()
+{
+	std::lock_guard<std::mutex> lock(m_lockControl);
+	if (!m_thread.joinable())
+		return -1;
+
+	m_bRecording.store(false, std::memory_order_relaxed);
+	{
+		std::lock_guard<std::mutex> lockWriter(m_lockWriter);
+		m_bStop = true;
+	}
+	m_condWriter.notify_one();
+	m_thread.join();
+
+	int nTracks = 0;
+	for (AUDIO_TRACK& track : m_tracks)
+	{
+		if (track.lpFile == NULL)
+			continue;
+		CloseFile(track);
+		nTracks++;
+	}
+	LOG_INFO("audio recording stopped, %d tracks, %lld bytes, %lld frames dropped", nTracks,
+		(long long)m_nWritten, (long long)m_nDropped.load());
+	return m_nWritten;
+}
+
+void CAudioRecorder::PutFrame(const char* lpId, const void* lpPcm, int nSamples, int nChannels, int nSampleRate)
+{
+	if (!IsRecording() || lpId == NULL || lpPcm == NULL || nSamples <= 0 || nChannels < 1 || nSampleRate <= 0)
+		return;
+
+	AUDIO_TRACK* lpTrack = FindTrack(lpId, nChannels, nSampleRate);
+	size_t nBytes = (size_t)nSamples * nChannels * sizeof(int16_t);
+	if (lpTrack == NULL || lpTrack->nChannels != nChannels || lpTrack->nSampleRate != nSampleRate)
+	{
+		m_nDropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	uint64_t nWrite = lpTrack->nWritePos.load(std::memory_order_relaxed);
+	uint64_t nRead = lpTrack->nReadPos.load(std::memory_order_acquire);
+	if (AUDIO_RECORD_RING_BYTES - (nWrite - nRead) < nBytes)
+	{
+		m_nDropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	size_t nOffset = (size_t)(nWrite & (AUDIO_RECORD_RING_BYTES - 1));
+	size_t nFirst = nBytes < AUDIO_RECORD_RING_BYTES - nOffset ? nBytes : AUDIO_RECORD_RING_BYTES - nOffset;
+	memcpy(lpTrack->lpRing.get() + nOffset, lpPcm, nFirst);
+	memcpy(lpTrack->lpRing.get(), (const uint8_t*)lpPcm + nFirst, nBytes - nFirst);
+	lpTrack->nWritePos.store(nWrite + nBytes, std::memory_order_release);
+}
+
+/**
+	a scan of the slots in order, a few dozen short compares. a new id takes
+	the first free slot with a CAS and publishes it once id and format are in.
+	a scan waits for a slot another producer is filling, so two first frames
+	of one id end in the same slot
+*/
+CAudioRecorder::AUDIO_TRACK* CAudioRecorder::FindTrack(const char* lpId, int nChannels, int nSampleRate)
+{
+	for (AUDIO_TRACK& track : m_tracks)
+	{
+		int nState = track.nState.load(std::memory_order_acquire);
+		if (nState == TRACK_FREE)
+		{
+			if (track.nState.compare_exchange_strong(nState, TRACK_CLAIMED, std::memory_order_acquire, std::memory_order_acquire))
+			{
+				strncpy(track.szId, lpId, AUDIO_RECORD_ID_TEXT - 1);
+				track.szId[AUDIO_RECORD_ID_TEXT - 1] = '\0';
+				track.nChannels = nChannels;
+				track.nSampleRate = nSampleRate;
+				track.nState.store(TRACK_READY, std::memory_order_release);
+				return &track;
+			}
+		}
+		while (nState == TRACK_CLAIMED)
+		{
+			std::this_thread::yield();
+			nState = track.nState.load(std::memory_order_acquire);
+		}
+		if (nState == TRACK_READY && strncmp(track.szId, lpId, AUDIO_RECORD_ID_TEXT - 1) == 0)
+			return &track;
+	}
+	return NULL;
+}
+
+void CAudioRecorder::ThreadProc()
+{
+	std::unique_lock<std::mutex> lock(m_lockWriter);
+	while (!m_bStop)
+	{
+		m_condWriter.wait_for(lock, std::chrono::milliseconds(AUDIO_RECORD_FLUSH_MS), [this] { return m_bStop; });
+		lock.unlock();
+		Flush();
+		lock.lock();
+	}
+	lock.unlock();
+
+	// what the callbacks copied while the last flush ran
+	Flush();
+}
+
+/**
+	whatever a ring holds goes out in at most two writes, the second one when
+	it wraps. a PutFrame that ran past Stop may store its position after Start
+	reset the ring, then the ring holds more than it can and is dropped
+*/
+void CAudioRecorder::Flush()
+{
+	for (AUDIO_TRACK& track : m_tracks)
+	{
+		if (track.nState.load(std::memory_order_acquire) != TRACK_READY)
+			continue;
+
+		uint64_t nRead = track.nReadPos.load(std::memory_order_relaxed);
+		uint64_t nWrite = track.nWritePos.load(std::memory_order_acquire);
+		if (nWrite == nRead)
+			continue;
+		if (nWrite - nRead > AUDIO_RECORD_RING_BYTES)
+		{
+			LOG_WARN("audio recording of %s lost its ring position, %llu bytes dropped", track.szId, (unsigned long long)(nWrite - nRead));
+			m_nDropped.fetch_add(1, std::memory_order_relaxed);
+			track.nReadPos.store(nWrite, std::memory_order_release);
+			continue;
+		}
+
+		if (track.lpFile != NULL || (!track.bFailed && OpenFile(track)))
+		{
+			size_t nBytes = (size_t)(nWrite - nRead);
+			size_t nOffset = (size_t)(nRead & (AUDIO_RECORD_RING_BYTES - 1));
+			size_t nFirst = nBytes < AUDIO_RECORD_RING_BYTES - nOffset ? nBytes : AUDIO_RECORD_RING_BYTES - nOffset;
+			size_t nDone = fwrite(track.lpRing.get() + nOffset, 1, nFirst, track.lpFile);
+			if (nDone == nFirst && nBytes > nFirst)
+				nDone += fwrite(track.lpRing.get(), 1, nBytes - nFirst, track.lpFile);
+			if (fflush(track.lpFile) != 0)
+				nDone = 0;
+			track.nDataBytes += nDone;
+			m_nWritten += nDone;
+			if (nDone != nBytes)
+			{
+				// a full disk, the rest of the track is dropped and the file keeps what it got
+				LOG_WARN("audio recording can not write %s, %s is dropped", track.strPath.c_str(), track.szId);
+				CloseFile(track);
+				track.bFailed = true;
+			}
+		}
+		track.nReadPos.store(nWrite, std::memory_order_release);
+	}
+}
+
+/**
+	<dir>/<id>.wav, other characters of the id become '_' and a name an
+	earlier track took gets the number of the slot
+*/
+bool CAudioRecorder::OpenFile(AUDIO_TRACK& track)
+{
+	std::string strName;
+	for (const char* lpChar = track.szId; *lpChar != '\0'; lpChar++)
+		strName += IsNameChar(*lpChar) ? *lpChar : '_';
+	if (strName.empty())
+		strName = "_";
+
+	std::string strPath = m_strDir + "/" + strName + ".wav";
+	for (AUDIO_TRACK* lpOther = m_tracks; lpOther < &track; lpOther++)
+	{
+		if (lpOther->lpFile != NULL && lpOther->strPath == strPath)
+		{
+			strPath = m_strDir + "/" + strName + "_" + std::to_string(&track - m_tracks) + ".wav";
+			break;
+		}
+	}
+
+	track.lpFile = fopen(strPath.c_str(), "wb");
+	if (track.lpFile == NULL)
+	{
+		LOG_WARN("audio recording can not create %s, %s is dropped", strPath.c_str(), track.szId);
+		track.bFailed = true;
+		return false;
+	}
+	track.strPath = strPath;
+
+	// the sizes are the largest possible until CloseFile knows them
+	uint8_t header[AUDIO_RECORD_WAV_HEADER];
+	uint32_t nBlockAlign = (uint32_t)track.nChannels * sizeof(int16_t);
+	memcpy(header, "RIFF", 4);
+	PutLE(header + 4, 0xffffffff, 4);
+	memcpy(header + 8, "WAVEfmt ", 8);
+	PutLE(header + 16, 16, 4);
+	PutLE(header + 20, 1, 2);					// PCM
+	PutLE(header + 22, track.nChannels, 2);
+	PutLE(header + 24, track.nSampleRate, 4);
+	PutLE(header + 28, track.nSampleRate * nBlockAlign, 4);
+	PutLE(header + 32, nBlockAlign, 2);
+	PutLE(header + 34, 16, 2);
+	memcpy(header + 36, "data", 4);
+	PutLE(header + 40, 0xffffffff - 36, 4);
+	if (fwrite(header, 1, sizeof(header), track.lpFile) != sizeof(header))
+	{
+		LOG_WARN("audio recording can not write %s, %s is dropped", strPath.c_str(), track.szId);
+		fclose(track.lpFile);
+		track.lpFile = NULL;
+		track.bFailed = true;
+		return false;
+	}
+	LOG_DEBUG("audio recording %s for %s, %dHz %dch", strPath.c_str(), track.szId, track.nSampleRate, track.nChannels);
+	return true;
+}
+
+void CAudioRecorder::CloseFile(AUDIO_TRACK& track)
+{
+	uint64_t nMax = 0xffffffff - 36;
+	uint32_t nDataBytes = (uint32_t)(track.nDataBytes < nMax ? track.nDataBytes : nMax);
+	uint8_t riff[4], data[4];
+	PutLE(riff, nDataBytes + 36, 4);
+	PutLE(data, nDataBytes, 4);
+	bool bFixed = fseek(track.lpFile, 4, SEEK_SET) == 0 && fwrite(riff, 1, 4, track.lpFile) == 4
+		&& fseek(track.lpFile, 40, SEEK_SET) == 0 && fwrite(data, 1, 4, track.lpFile) == 4;
+	if (fclose(track.lpFile) != 0 || !bFixed)
+		LOG_WARN("audio recording can not fix the header of %s, it keeps the maximum size", track.strPath.c_str());
+	track.lpFile = NULL;
+}
@@ -0,0 +1,166 @@
+#include "AudioSink.h"
+#include "Logger.h"
+#include "Singleton.h"
+#include <chrono>
+#include <math.h>
+#include <stdlib.h>
+
+// dBFS * 100 of a 16 bit amplitude
+static int64_t CentiDbfs(double dAmplitude)
+{
+	if (dAmplitude <= 0)
+		return AUDIO_SINK_FLOOR_DBFS * 100;
+	double dDbfs = 20 * log10(dAmplitude / 32768);
+	if (dDbfs < AUDIO_SINK_FLOOR_DBFS)
+		dDbfs = AUDIO_SINK_FLOOR_DBFS;
+	return (int64_t)(dDbfs * 100 + (dDbfs < 0 ? -0.5 : 0.5));
+}
+
+RTC_DEFINE_SINGLETON(CAudioSink)
+
+CAudioSink::CAudioSink()
+	: m_bRunning(false)
+	, m_nSampleRate(0)
+	, m_nChannels(0)
+	, m_nMode(AUDIO_SINK_DISCARD)
+	, m_bPulled(false)
+	, m_bSound(false)
+	, m_nZeroFrames(0)
+	, m_nWindowFrames(0)
+	, m_dWindowSquares(0)
+	, m_nWindowSamples(0)
+	, m_nWindowPeak(0)
+{
+	for (auto& nStat : m_nStats)
+		nStat.store(0, std::memory_order_relaxed);
+}
+
+bool CAudioSink::Start(int nSampleRate, int nChannels, int nMode, PULL_FUNC pull)
+{
+	if (nSampleRate <= 0 || nSampleRate % 100 != 0 || nChannels < 1 || nChannels > AUDIO_SINK_MAX_CHANNELS
+		|| (nMode != AUDIO_SINK_DISCARD && nMode != AUDIO_SINK_MEASURE) || !pull)
+		return false;
+
+	std::lock_guard<std::mutex> lock(m_lockControl);
+	if (m_thread.joinable())
+	{
+		m_bRunning = false;
+		m_thread.join();
+	}
+
+	m_pull = pull;
+	m_nSampleRate = nSampleRate;
+	m_nChannels = nChannels;
+	m_nMode = nMode;
+	m_vecFrame.assign((size_t)nSampleRate * AUDIO_SINK_FRAME_MS / 1000 * nChannels, 0);
+	m_bPulled = false;
+	m_bSound = false;
+	m_nZeroFrames = 0;
+	m_nWindowFrames = 0;
+	m_dWindowSquares = 0;
+	m_nWindowSamples = 0;
+	m_nWindowPeak = 0;
+	for (auto& nStat : m_nStats)
+		nStat.store(0, std::memory_order_relaxed);
+	m_nStats[AUDIO_SINK_STAT_LEVEL] = AUDIO_SINK_FLOOR_DBFS * 100;
+	m_nStats[AUDIO_SINK_STAT_PEAK] = AUDIO_SINK_FLOOR_DBFS * 100;
+
+	m_bRunning = true;
+	m_thread = std::thread(&CAudioSink::ThreadProc, this);
+	LOG_INFO("audio sink %dHz %dch, %s", nSampleRate, nChannels, nMode == AUDIO_SINK_MEASURE ? "measured" : "discarded");
+	return true;
+}
+
+void CAudioSink::Stop()
+{
+	std::lock_guard<std::mutex> lock(m_lockControl);
+	if (!m_thread.joinable())
+		return;
+
+	m_bRunning = false;
+	m_thread.join();
+	m_pull = nullptr;
+	LOG_INFO("audio sink stopped, %lld frames, %lld failed, %lld late, %lld lost, %lld glitches",
+		(long long)GetStat(AUDIO_SINK_STAT_FRAMES), (long long)GetStat(AUDIO_SINK_STAT_FAILED),
+		(long long)GetStat(AUDIO_SINK_STAT_LATE), (long long)GetStat(AUDIO_SINK_STAT_LOST),
+		(long long)GetStat(AUDIO_SINK_STAT_GLITCHES));
+}
+
+void CAudioSink::ThreadProc()
+{
+	const std::chrono::microseconds frame(AUDIO_SINK_FRAME_MS * 1000);
+	auto next = std::chrono::steady_clock::now();
+	while (m_bRunning)
+	{
+		std::this_thread::sleep_until(next);
+		// frames due since the last wakeup, one when on time
+		int64_t nDue = (std::chrono::steady_clock::now() - next) / frame + 1;
+		if (nDue > 1)
+			Add(AUDIO_SINK_STAT_LATE);
+		int64_t nPulls = nDue < AUDIO_SINK_MAX_CATCHUP ? nDue : AUDIO_SINK_MAX_CATCHUP;
+		if (nDue > nPulls)
+			Add(AUDIO_SINK_STAT_LOST, nDue - nPulls);
+		for (int64_t i = 0; i < nPulls && m_bRunning; i++)
+			Pull();
+		next += frame * nDue;
+	}
+}
+
+void CAudioSink::Pull()
+{
+	if (!m_pull(m_vecFrame.data(), m_nSampleRate * AUDIO_SINK_FRAME_MS / 1000))
+	{
+		if (m_bPulled)
+			Add(AUDIO_SINK_STAT_FAILED);
+		return;
+	}
+
+	m_bPulled = true;
+	Add(AUDIO_SINK_STAT_FRAMES);
+	if (m_nMode == AUDIO_SINK_MEASURE)
+		Measure(m_vecFrame.data(), (int)m_vecFrame.size());
+}
+
+void CAudioSink::Measure(const int16_t* lpPcm, int nCount)
+{
+	int nPeak = 0;
+	int64_t nSquares = 0;
+	for (int i = 0; i < nCount; i++)
+	{
+		int nSample = abs((int)lpPcm[i]);
+		nPeak = nSample > nPeak ? nSample : nPeak;
+		nSquares += (int64_t)nSample * nSample;
+	}
+
+	if (nPeak < AUDIO_SINK_SILENCE_PEAK)
+		Add(AUDIO_SINK_STAT_SILENT);
+	if (nPeak == 0)
+		m_nZeroFrames++;
+	else if (nPeak >= AUDIO_SINK_SILENCE_PEAK)
+	{
+		// sound again after a short hole of exact zeros, a decoder that ran dry
+		if (m_bSound && m_nZeroFrames > 0 && m_nZeroFrames <= AUDIO_SINK_GLITCH_FRAMES)
+			Add(AUDIO_SINK_STAT_GLITCHES);
+		m_bSound = true;
+		m_nZeroFrames = 0;
+	}
+	else
+	{
+		// comfort noise, a pause and not a hole
+		m_bSound = false;
+		m_nZeroFrames = 0;
+	}
+
+	m_dWindowSquares += (double)nSquares;
+	m_nWindowSamples += nCount;
+	m_nWindowPeak = nPeak > m_nWindowPeak ? nPeak : m_nWindowPeak;
+	if (++m_nWindowFrames < AUDIO_SINK_LEVEL_FRAMES)
+		return;
+
+	m_nStats[AUDIO_SINK_STAT_LEVEL].store(CentiDbfs(sqrt(m_dWindowSquares / m_nWindowSamples)), std::memory_order_relaxed);
+	m_nStats[AUDIO_SINK_STAT_PEAK].store(CentiDbfs(m_nWindowPeak), std::memory_order_relaxed);
+	m_nWindowFrames = 0;
+	m_dWindowSquares = 0;
+	m_nWindowSamples = 0;
+	m_nWindowPeak = 0;
+}
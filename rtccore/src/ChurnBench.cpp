@@ -0,0 +1,133 @@
+#include "ChurnBench.h"
+#include <fstream>
+#include <thread>
+
+static const char* g_lpMetricName[CHURN_METRIC_COUNT][2] = {
+	{ "join.call", "us" },
+	{ "join.ready", "us" },
+	{ "join.elapsed", "ms" },
+	{ "userJoined.elapsed", "ms" },
+	{ "firstVideo.elapsed", "ms" },
+	{ "userJoined.handler", "us" },
+	{ "firstVideo.handler", "us" },
+	{ "userOffline.handler", "us" },
+	{ "leave.call", "us" },
+	{ "leave.ready", "us" },
+};
+
+// one hour in us, anything slower is clamped
+#define CHURN_HIGHEST_TRACKABLE	(3600LL * 1000 * 1000)
+
+static int64_t ElapsedUs(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+CChurnBench* CChurnBench::GetInstance()
+{
+	static CChurnBench churnBench;
+	return &churnBench;
+}
+
+CChurnBench::CChurnBench()
+	: m_bRunning(false)
+	, m_strName("churn")
+	, m_nCycles(0)
+	, m_nFailed(0)
+{
+	for (int i = 0; i < CHURN_METRIC_COUNT; i++)
+		m_lpHistograms[i] = new CHdrHistogram(CHURN_HIGHEST_TRACKABLE, 3);
+}
+
+CChurnBench::~CChurnBench()
+{
+	for (int i = 0; i < CHURN_METRIC_COUNT; i++)
+		delete m_lpHistograms[i];
+}
+
+void CChurnBench::Record(CHURN_METRIC metric, int64_t value)
+{
+	if (m_bRunning)
+		m_lpHistograms[metric]->record(value);
+}
+
+CChurnBench::CScopedTimer::CScopedTimer(CHURN_METRIC metric)
+	: m_metric(metric)
+	, m_start(std::chrono::steady_clock::now())
+{
+}
+
+CChurnBench::CScopedTimer::~CScopedTimer()
+{
+	CChurnBench::GetInstance()->Record(m_metric, ElapsedUs(m_start));
+}
+
+/**
+	run nCycles of join, stay nHoldMs in the channel, leave
+Parameters:
+	@param lpTarget	the SDK to churn, used from the calling thread only
+	@param nTimeoutMs	how long to wait for the join and the leave to complete
+	@return number of cycles where the SDK did not confirm the join or the leave
+*/
+int CChurnBench::Run(IChurnTarget* lpTarget, int nCycles, int nHoldMs, int nTimeoutMs)
+{
+	for (int i = 0; i < CHURN_METRIC_COUNT; i++)
+		m_lpHistograms[i]->reset();
+	m_strName = lpTarget->GetName();
+	m_nCycles = 0;
+	m_nFailed = 0;
+	m_bRunning = true;
+
+	for (int i = 0; i < nCycles; i++)
+	{
+		auto joinStart = std::chrono::steady_clock::now();
+		lpTarget->Join();
+		Record(CHURN_JOIN_CALL, ElapsedUs(joinStart));
+
+		bool bJoined = lpTarget->WaitJoin(nTimeoutMs);
+		if (bJoined)
+			Record(CHURN_JOIN_READY, ElapsedUs(joinStart));
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(nHoldMs));
+
+		auto leaveStart = std::chrono::steady_clock::now();
+		lpTarget->Leave();
+		Record(CHURN_LEAVE_CALL, ElapsedUs(leaveStart));
+
+		int nLeft = lpTarget->WaitLeave(nTimeoutMs);
+		if (nLeft > 0)
+			Record(CHURN_LEAVE_READY, ElapsedUs(leaveStart));
+
+		if (!bJoined || nLeft < 0)
+			m_nFailed++;
+		m_nCycles++;
+	}
+
+	m_bRunning = false;
+	return m_nFailed;
+}
+
+void CChurnBench::Report(std::ostream& os)
+{
+	os << m_strName << " churn: " << m_nCycles << " cycles, " << m_nFailed << " failed" << std::endl;
+	for (int i = 0; i < CHURN_METRIC_COUNT; i++)
+		m_lpHistograms[i]->printPercentiles(os, g_lpMetricName[i][0], g_lpMetricName[i][1]);
+}
+
+/**
+	write the raw histograms so start.py can merge the whole fleet
+*/
+bool CChurnBench::Dump(const char* lpPath)
+{
+	std::ofstream file(lpPath);
+	if (!file)
+		return false;
+
+	file << "cycles " << m_nCycles << " " << m_nFailed << "\n";
+	for (int i = 0; i < CHURN_METRIC_COUNT; i++)
+	{
+		file << "# " << g_lpMetricName[i][0] << " " << g_lpMetricName[i][1] << "\n";
+		m_lpHistograms[i]->dump(file);
+	}
+	return true;
+}
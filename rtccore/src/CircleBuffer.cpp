@@ -1,6 +1,7 @@
 
 #include "CircleBuffer.h"
-#include <iostream>
+#include "Logger.h"
+#include "MediaClock.h"
 CircleBuffer* CircleBuffer::GetInstance()
 {
 	static CircleBuffer circleBuffer(MAX_AUDIO_SAMPLE_SIZE, 0);
@@ -48,18 +49,22 @@ unsigned int CircleBuffer::getUsedSize()
 }
 
 
-void CircleBuffer::writeBuffer(const void* pSourceBuffer, const unsigned int iNumBytes)
+bool CircleBuffer::writeBuffer(const void* pSourceBuffer, const unsigned int iNumBytes)
 {
 	if (iNumBytes > this->m_iBufferSize / 2)
 	{
-		std::cout << "error iNumBytes: "<< iNumBytes <<" is greater than half of buffer size" << std::endl;
-		return;
+		LOG_ERROR("iNumBytes: %u is greater than half of buffer size", iNumBytes);
+		return false;
 	}
 		
 	unsigned int iBytesToWrite = iNumBytes;
 	BYTE* pSourceReadCursor = (BYTE*)pSourceBuffer;
+	int64_t nPushNs = CMediaClock::NowNs();
 
-	auto cur = freeSpace.acquire(iNumBytes);
+	// the pusher is paced by this wait when the buffer is full
+	unsigned int cur = 0;
+	if (!freeSpace.tryAcquire(iNumBytes, wait_timeout, cur))
+		return false;
 
 	unsigned int iChunkSize = this->m_iBufferSize - cur;
 	if (iChunkSize > iBytesToWrite)
@@ -77,21 +82,40 @@ void CircleBuffer::writeBuffer(const void* pSourceBuffer, const unsigned int iNu
 		memcpy(this->m_pBuffer + cur, pSourceReadCursor, iBytesToWrite);
 	}
 
+	// queued before the bytes are released so a reader always finds the stamp of its first byte
+	{
+		std::lock_guard<std::mutex> buf_lock(m_mutex);
+		m_nWritten += iNumBytes;
+		m_stamps.push_back({ m_nWritten, nPushNs, CMediaClock::NowNs() });
+	}
 	usedSpace.release(iNumBytes);
+	return true;
+}
+
+// the legacy overload never set audioTime, the stamp of the other one carries the times
+bool CircleBuffer::readBuffer(void* pDestBuffer, const unsigned int iBytesToRead, unsigned int* pbBytesRead, int& /*audioTime*/)
+{
+	LATENCY_STAMP stamp;
+	return readBuffer(pDestBuffer, iBytesToRead, pbBytesRead, stamp);
 }
 
-bool CircleBuffer::readBuffer(void* pDestBuffer, const unsigned int _iBytesToRead, unsigned int* pbBytesRead, int& audioTime)
+bool CircleBuffer::readBuffer(void* pDestBuffer, const unsigned int _iBytesToRead, unsigned int* pbBytesRead, LATENCY_STAMP& stamp)
 {
 	if (_iBytesToRead > this->m_iBufferSize/2 )
 	{
-		std::cout << "error _iBytesToRead: " << _iBytesToRead << " is greater than half of buffer size" << std::endl;
+		LOG_ERROR("_iBytesToRead: %u is greater than half of buffer size", _iBytesToRead);
 		return false;
 	}
 
 	unsigned int iBytesToRead = _iBytesToRead;
 	unsigned int iBytesRead = 0;
 
-	auto cur = usedSpace.acquire(_iBytesToRead);
+	unsigned int cur = 0;
+	if (!usedSpace.tryAcquire(_iBytesToRead, wait_timeout, cur))
+	{
+		*pbBytesRead = 0;
+		return false;
+	}
 
 	unsigned int iChunkSize = this->m_iBufferSize - cur;
 	if (iChunkSize > iBytesToRead)
@@ -107,7 +131,19 @@ bool CircleBuffer::readBuffer(void* pDestBuffer, const unsigned int _iBytesToRea
 	if (iBytesToRead)
 	{
 		memcpy((BYTE*)pDestBuffer + iBytesRead, this->m_pBuffer + cur, iBytesToRead);
+		iBytesRead += iBytesToRead;
+	}
+
+	{
+		// the stamps of writes read to the end are gone, the front one holds the first byte
+		std::lock_guard<std::mutex> buf_lock(m_mutex);
+		stamp.nPushNs = m_stamps.empty() ? 0 : m_stamps.front().nPushNs;
+		stamp.nPublishNs = m_stamps.empty() ? 0 : m_stamps.front().nPublishNs;
+		m_nRead += _iBytesToRead;
+		while (!m_stamps.empty() && m_stamps.front().nEnd <= m_nRead)
+			m_stamps.pop_front();
 	}
+	stamp.nReadNs = CMediaClock::NowNs();
 
 	freeSpace.release(_iBytesToRead);
 	
@@ -0,0 +1,215 @@
+#include "HdrHistogram.h"
+#include <limits>
+#include <cmath>
+#include <iomanip>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+static int HighestBit(uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return 63 - __builtin_clzll(value);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	unsigned long index = 0;
+	_BitScanReverse64(&index, value);
+	return (int)index;
+#else
+	int bit = 0;
+	while (value >>= 1)
+		bit++;
+	return bit;
+#endif
+}
+
+CHdrHistogram::CHdrHistogram(int64_t nHighestTrackable, int nSignificantDigits)
+	: m_nHighestTrackable(nHighestTrackable)
+	, m_nTotalCount(0)
+	, m_nSum(0)
+	, m_nMin(std::numeric_limits<int64_t>::max())
+	, m_nMax(0)
+{
+	int64_t largestSingleUnitResolution = 2 * (int64_t)std::pow(10.0, nSignificantDigits);
+	int subBucketCountMagnitude = (int)std::ceil(std::log2((double)largestSingleUnitResolution));
+
+	m_nSubBucketHalfCountMagnitude = (subBucketCountMagnitude > 1 ? subBucketCountMagnitude : 1) - 1;
+	m_nSubBucketCount = 1 << (m_nSubBucketHalfCountMagnitude + 1);
+	m_nSubBucketHalfCount = m_nSubBucketCount / 2;
+	m_nSubBucketMask = (int64_t)m_nSubBucketCount - 1;
+
+	int64_t smallestUntrackable = (int64_t)m_nSubBucketCount;
+	int nBucketCount = 1;
+	while (smallestUntrackable <= nHighestTrackable)
+	{
+		if (smallestUntrackable > std::numeric_limits<int64_t>::max() / 2)
+		{
+			nBucketCount++;
+			break;
+		}
+		smallestUntrackable <<= 1;
+		nBucketCount++;
+	}
+
+	m_nCountsLen = (nBucketCount + 1) * m_nSubBucketHalfCount;
+	m_pCounts = new std::atomic<int64_t>[m_nCountsLen];
+	for (int i = 0; i < m_nCountsLen; i++)
+		m_pCounts[i].store(0, std::memory_order_relaxed);
+}
+
+CHdrHistogram::~CHdrHistogram()
+{
+	delete[] m_pCounts;
+}
+
+int CHdrHistogram::bucketIndexOf(int64_t value) const
+{
+	return HighestBit((uint64_t)(value | m_nSubBucketMask)) + 1 - (m_nSubBucketHalfCountMagnitude + 1);
+}
+
+int CHdrHistogram::countsIndexOf(int64_t value) const
+{
+	int bucketIndex = bucketIndexOf(value);
+	int subBucketIndex = (int)(value >> bucketIndex);
+	return ((bucketIndex + 1) << m_nSubBucketHalfCountMagnitude) + (subBucketIndex - m_nSubBucketHalfCount);
+}
+
+int64_t CHdrHistogram::valueFromIndex(int index) const
+{
+	int bucketIndex = (index >> m_nSubBucketHalfCountMagnitude) - 1;
+	int subBucketIndex = (index & (m_nSubBucketHalfCount - 1)) + m_nSubBucketHalfCount;
+	if (bucketIndex < 0)
+	{
+		subBucketIndex -= m_nSubBucketHalfCount;
+		bucketIndex = 0;
+	}
+	return (int64_t)subBucketIndex << bucketIndex;
+}
+
+int64_t CHdrHistogram::highestEquivalentValue(int64_t value) const
+{
+	int bucketIndex = bucketIndexOf(value);
+	int subBucketIndex = (int)(value >> bucketIndex);
+	int adjustedBucket = (subBucketIndex >= m_nSubBucketCount) ? bucketIndex + 1 : bucketIndex;
+	int64_t lowest = (int64_t)subBucketIndex << bucketIndex;
+	return lowest + ((int64_t)1 << adjustedBucket) - 1;
+}
+
+void CHdrHistogram::record(int64_t value)
+{
+	if (value < 0)
+		value = 0;
+	if (value > m_nHighestTrackable)
+		value = m_nHighestTrackable;
+
+	m_pCounts[countsIndexOf(value)].fetch_add(1, std::memory_order_relaxed);
+	m_nTotalCount.fetch_add(1, std::memory_order_relaxed);
+	m_nSum.fetch_add(value, std::memory_order_relaxed);
+
+	int64_t cur = m_nMin.load(std::memory_order_relaxed);
+	while (value < cur && !m_nMin.compare_exchange_weak(cur, value, std::memory_order_relaxed));
+	cur = m_nMax.load(std::memory_order_relaxed);
+	while (value > cur && !m_nMax.compare_exchange_weak(cur, value, std::memory_order_relaxed));
+}
+
+void CHdrHistogram::reset()
+{
+	for (int i = 0; i < m_nCountsLen; i++)
+		m_pCounts[i].store(0, std::memory_order_relaxed);
+	m_nTotalCount = 0;
+	m_nSum = 0;
+	m_nMin = std::numeric_limits<int64_t>::max();
+	m_nMax = 0;
+}
+
+void CHdrHistogram::add(const CHdrHistogram& other)
+{
+	for (int i = 0; i < other.m_nCountsLen; i++)
+	{
+		int64_t count = other.m_pCounts[i].load(std::memory_order_relaxed);
+		if (count == 0)
+			continue;
+
+		int64_t value = other.valueFromIndex(i);
+		if (value > m_nHighestTrackable)
+			value = m_nHighestTrackable;
+		m_pCounts[countsIndexOf(value)].fetch_add(count, std::memory_order_relaxed);
+	}
+	m_nTotalCount.fetch_add(other.getTotalCount(), std::memory_order_relaxed);
+	m_nSum.fetch_add(other.m_nSum.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	if (other.getTotalCount() > 0)
+	{
+		if (other.getMin() < getMin())
+			m_nMin = other.getMin();
+		if (other.getMax() > getMax())
+			m_nMax = other.getMax();
+	}
+}
+
+int64_t CHdrHistogram::getTotalCount() const
+{
+	return m_nTotalCount.load(std::memory_order_relaxed);
+}
+
+int64_t CHdrHistogram::getMin() const
+{
+	return getTotalCount() == 0 ? 0 : m_nMin.load(std::memory_order_relaxed);
+}
+
+int64_t CHdrHistogram::getMax() const
+{
+	return m_nMax.load(std::memory_order_relaxed);
+}
+
+double CHdrHistogram::getMean() const
+{
+	int64_t total = getTotalCount();
+	return total == 0 ? 0.0 : (double)m_nSum.load(std::memory_order_relaxed) / total;
+}
+
+int64_t CHdrHistogram::getValueAtPercentile(double percentile) const
+{
+	int64_t total = getTotalCount();
+	if (total == 0)
+		return 0;
+
+	if (percentile > 100.0)
+		percentile = 100.0;
+	int64_t countAtPercentile = (int64_t)(percentile / 100.0 * total + 0.5);
+	if (countAtPercentile < 1)
+		countAtPercentile = 1;
+
+	int64_t cumulative = 0;
+	for (int i = 0; i < m_nCountsLen; i++)
+	{
+		cumulative += m_pCounts[i].load(std::memory_order_relaxed);
+		if (cumulative >= countAtPercentile)
+		{
+			int64_t value = highestEquivalentValue(valueFromIndex(i));
+			return value < getMax() ? value : getMax();
+		}
+	}
+	return getMax();
+}
+
+void CHdrHistogram::dump(std::ostream& os) const
+{
+	for (int i = 0; i < m_nCountsLen; i++)
+	{
+		int64_t count = m_pCounts[i].load(std::memory_order_relaxed);
+		if (count != 0)
+			os << highestEquivalentValue(valueFromIndex(i)) << " " << count << "\n";
+	}
+}
+
+void CHdrHistogram::printPercentiles(std::ostream& os, const char* lpName, const char* lpUnit) const
+{
+	os << std::left << std::setw(24) << lpName << std::right
+		<< " n:" << std::setw(7) << getTotalCount()
+		<< " min:" << std::setw(8) << getMin()
+		<< " p50:" << std::setw(8) << getValueAtPercentile(50.0)
+		<< " p90:" << std::setw(8) << getValueAtPercentile(90.0)
+		<< " p99:" << std::setw(8) << getValueAtPercentile(99.0)
+		<< " p99.9:" << std::setw(8) << getValueAtPercentile(99.9)
+		<< " max:" << std::setw(8) << getMax()
+		<< " (" << lpUnit << ")" << std::endl;
+}
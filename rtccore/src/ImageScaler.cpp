@@ -0,0 +1,173 @@
+#include "ImageScaler.h"
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IMAGE_SCALER_SSE2
+#include <emmintrin.h>
+#endif
+
+bool CImageScaler::HasSimd()
+{
+#ifdef IMAGE_SCALER_SSE2
+	return true;
+#else
+	return false;
+#endif
+}
+
+void CImageScaler::CopyPlane(const BYTE* lpSrc, int nSrcStride, BYTE* lpDst, int nDstStride, int nWidth, int nHeight)
+{
+	for (int y = 0; y < nHeight; y++)
+		memcpy(lpDst + (size_t)y * nDstStride, lpSrc + (size_t)y * nSrcStride, nWidth);
+}
+
+void CImageScaler::FillPlane(BYTE* lpDst, int nDstStride, int nWidth, int nHeight, BYTE nValue)
+{
+	for (int y = 0; y < nHeight; y++)
+		memset(lpDst + (size_t)y * nDstStride, nValue, nWidth);
+}
+
+void CImageScaler::ScalePlane(const BYTE* lpSrc, int nSrcStride, int nSrcWidth, int nSrcHeight,
+	BYTE* lpDst, int nDstStride, int nDstWidth, int nDstHeight)
+{
+	if (lpSrc == NULL || lpDst == NULL || nSrcWidth <= 0 || nSrcHeight <= 0 || nDstWidth <= 0 || nDstHeight <= 0)
+		return;
+
+	// the SDK threads scale concurrently, each one keeps its own halves
+	thread_local std::vector<BYTE> vecHalf[2];
+	const BYTE* lpPlane = lpSrc;
+	int nStride = nSrcStride;
+	int nWidth = nSrcWidth;
+	int nHeight = nSrcHeight;
+	int nHalf = 0;
+	while (nWidth >= 2 * nDstWidth && nHeight >= 2 * nDstHeight)
+	{
+		nWidth /= 2;
+		nHeight /= 2;
+		if (nWidth == nDstWidth && nHeight == nDstHeight)
+		{
+			HalvePlane(lpPlane, nStride, lpDst, nDstStride, nWidth, nHeight);
+			return;
+		}
+		vecHalf[nHalf].resize((size_t)nWidth * nHeight);
+		HalvePlane(lpPlane, nStride, vecHalf[nHalf].data(), nWidth, nWidth, nHeight);
+		lpPlane = vecHalf[nHalf].data();
+		nStride = nWidth;
+		nHalf ^= 1;
+	}
+
+	if (nWidth == nDstWidth && nHeight == nDstHeight)
+		CopyPlane(lpPlane, nStride, lpDst, nDstStride, nWidth, nHeight);
+	else
+		BilinearPlane(lpPlane, nStride, nWidth, nHeight, lpDst, nDstStride, nDstWidth, nDstHeight);
+}
+
+// the average of every 2x2 block, the last column and row of an odd plane are dropped
+void CImageScaler::HalvePlane(const BYTE* lpSrc, int nSrcStride, BYTE* lpDst, int nDstStride, int nDstWidth, int nDstHeight)
+{
+	for (int y = 0; y < nDstHeight; y++)
+	{
+		const BYTE* lpRow0 = lpSrc + (size_t)y * 2 * nSrcStride;
+		const BYTE* lpRow1 = lpRow0 + nSrcStride;
+		BYTE* lpOut = lpDst + (size_t)y * nDstStride;
+		int x = 0;
+#ifdef IMAGE_SCALER_SSE2
+		const __m128i mask = _mm_set1_epi16(0x00ff);
+		for (; x + 16 <= nDstWidth; x += 16)
+		{
+			__m128i v0 = _mm_avg_epu8(_mm_loadu_si128((const __m128i*)(lpRow0 + 2 * x)), _mm_loadu_si128((const __m128i*)(lpRow1 + 2 * x)));
+			__m128i v1 = _mm_avg_epu8(_mm_loadu_si128((const __m128i*)(lpRow0 + 2 * x + 16)), _mm_loadu_si128((const __m128i*)(lpRow1 + 2 * x + 16)));
+			// even and odd columns side by side in 16 bit lanes
+			__m128i h0 = _mm_avg_epu16(_mm_and_si128(v0, mask), _mm_srli_epi16(v0, 8));
+			__m128i h1 = _mm_avg_epu16(_mm_and_si128(v1, mask), _mm_srli_epi16(v1, 8));
+			_mm_storeu_si128((__m128i*)(lpOut + x), _mm_packus_epi16(h0, h1));
+		}
+#endif
+		// rounded like _mm_avg_epu8 then _mm_avg_epu16, so the tail matches the SIMD columns
+		for (; x < nDstWidth; x++)
+		{
+			int nLeft = (lpRow0[2 * x] + lpRow1[2 * x] + 1) >> 1;
+			int nRight = (lpRow0[2 * x + 1] + lpRow1[2 * x + 1] + 1) >> 1;
+			lpOut[x] = (BYTE)((nLeft + nRight + 1) >> 1);
+		}
+	}
+}
+
+void CImageScaler::BlendRows(const BYTE* lpRow0, const BYTE* lpRow1, int nWeight, BYTE* lpDst, int nWidth)
+{
+	if (nWeight == 0)
+	{
+		memcpy(lpDst, lpRow0, nWidth);
+		return;
+	}
+
+	int x = 0;
+#ifdef IMAGE_SCALER_SSE2
+	// 255 * 256 + 128 still fits an unsigned 16 bit lane
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i weight0 = _mm_set1_epi16((short)(256 - nWeight));
+	const __m128i weight1 = _mm_set1_epi16((short)nWeight);
+	const __m128i round = _mm_set1_epi16(128);
+	for (; x + 16 <= nWidth; x += 16)
+	{
+		__m128i a = _mm_loadu_si128((const __m128i*)(lpRow0 + x));
+		__m128i b = _mm_loadu_si128((const __m128i*)(lpRow1 + x));
+		__m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), weight0), _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), weight1));
+		__m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), weight0), _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), weight1));
+		lo = _mm_srli_epi16(_mm_add_epi16(lo, round), 8);
+		hi = _mm_srli_epi16(_mm_add_epi16(hi, round), 8);
+		_mm_storeu_si128((__m128i*)(lpDst + x), _mm_packus_epi16(lo, hi));
+	}
+#endif
+	for (; x < nWidth; x++)
+		lpDst[x] = (BYTE)((lpRow0[x] * (256 - nWeight) + lpRow1[x] * nWeight + 128) >> 8);
+}
+
+/**
+	every target pixel samples the source at its center with 8 bit weights,
+	the two source rows are blended first and the row is then sampled
+*/
+void CImageScaler::BilinearPlane(const BYTE* lpSrc, int nSrcStride, int nSrcWidth, int nSrcHeight,
+	BYTE* lpDst, int nDstStride, int nDstWidth, int nDstHeight)
+{
+	thread_local std::vector<int32_t> vecTaps;
+	thread_local std::vector<BYTE> vecRow;
+
+	// source column << 8 | weight of the next column, for every target column
+	vecTaps.resize(nDstWidth);
+	// the byte stores below may alias the vectors, plain pointers keep the loads out of the loops
+	int32_t* lpTaps = vecTaps.data();
+	int64_t nStepX = ((int64_t)nSrcWidth << 16) / nDstWidth;
+	int64_t nMaxX = (int64_t)(nSrcWidth - 1) << 16;
+	for (int x = 0; x < nDstWidth; x++)
+	{
+		int64_t nPos = nStepX * x + nStepX / 2 - 0x8000;
+		nPos = nPos < 0 ? 0 : (nPos > nMaxX ? nMaxX : nPos);
+		lpTaps[x] = (int32_t)(((nPos >> 16) << 8) | ((nPos >> 8) & 0xff));
+	}
+
+	// one more column, the last tap may read its right neighbour
+	vecRow.resize(nSrcWidth + 1);
+	BYTE* lpRow = vecRow.data();
+	int64_t nStepY = ((int64_t)nSrcHeight << 16) / nDstHeight;
+	int64_t nMaxY = (int64_t)(nSrcHeight - 1) << 16;
+	for (int y = 0; y < nDstHeight; y++)
+	{
+		int64_t nPos = nStepY * y + nStepY / 2 - 0x8000;
+		nPos = nPos < 0 ? 0 : (nPos > nMaxY ? nMaxY : nPos);
+		int y0 = (int)(nPos >> 16);
+		int y1 = y0 + 1 < nSrcHeight ? y0 + 1 : y0;
+		BlendRows(lpSrc + (size_t)y0 * nSrcStride, lpSrc + (size_t)y1 * nSrcStride, (int)((nPos >> 8) & 0xff), lpRow, nSrcWidth);
+		lpRow[nSrcWidth] = lpRow[nSrcWidth - 1];
+
+		BYTE* lpOut = lpDst + (size_t)y * nDstStride;
+		for (int x = 0; x < nDstWidth; x++)
+		{
+			int x0 = lpTaps[x] >> 8;
+			int nWeight = lpTaps[x] & 0xff;
+			lpOut[x] = (BYTE)((lpRow[x0] * (256 - nWeight) + lpRow[x0 + 1] * nWeight + 128) >> 8);
+		}
+	}
+}
@@ -0,0 +1,30 @@
+#include "JsonArgs.h"
+#include <errno.h>
+#include <stdlib.h>
+
+bool CJsonArgs::ParseInteger(const std::string& str, int64_t& nValue)
+{
+	char* lpEnd = nullptr;
+	errno = 0;
+	nValue = strtoll(str.c_str(), &lpEnd, 10);
+	return !str.empty() && *lpEnd == '\0' && errno != ERANGE;
+}
+
+bool CJsonArgs::JsonInteger(const Json::Value& root, const char* lpKey, int64_t nMin, int64_t nMax, int64_t& nValue)
+{
+	const Json::Value& value = root[lpKey];
+	int64_t nParsed = 0;
+
+	if (value.isNull())
+		return true;
+
+	if (value.isIntegral())
+		nParsed = value.asInt64();
+	else if (!value.isString() || !ParseInteger(value.asString(), nParsed))
+		return false;
+
+	if (nParsed < nMin || nParsed > nMax)
+		return false;
+	nValue = nParsed;
+	return true;
+}
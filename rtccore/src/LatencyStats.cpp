@@ -0,0 +1,170 @@
+#include "LatencyStats.h"
+#include "Logger.h"
+#include "Platform.h"
+#include "Singleton.h"
+#include <fstream>
+#include <stdio.h>
+
+static const char* g_lpStageName[LATENCY_STAGE_NUM] = {
+	"video.pushToPublish",
+	"video.publishToRead",
+	"video.readToHandoff",
+	"video.pushToHandoff",
+	"audio.pushToPublish",
+	"audio.publishToRead",
+	"audio.readToHandoff",
+	"audio.pushToHandoff",
+};
+
+RTC_DEFINE_SINGLETON(CLatencyStats)
+
+CLatencyStats::CLatencyStats()
+	: m_nDumpIntervalMs(0)
+	, m_bStop(false)
+{
+	for (int i = 0; i < LATENCY_STAGE_NUM; i++)
+		m_lpHistograms[i] = new CHdrHistogram(LATENCY_HIGHEST_TRACKABLE, 3);
+}
+
+void CLatencyStats::RecordVideo(const LATENCY_STAMP& stamp, int64_t nHandoffNs)
+{
+	Record(LATENCY_VIDEO_PUSH_PUBLISH, stamp, nHandoffNs);
+}
+
+void CLatencyStats::RecordAudio(const LATENCY_STAMP& stamp, int64_t nHandoffNs)
+{
+	Record(LATENCY_AUDIO_PUSH_PUBLISH, stamp, nHandoffNs);
+}
+
+// the four stages of one path start at nFirstStage in the order of LATENCY_STAGE
+void CLatencyStats::Record(int nFirstStage, const LATENCY_STAMP& stamp, int64_t nHandoffNs)
+{
+	if (stamp.nPushNs != 0 && stamp.nPublishNs != 0)
+		m_lpHistograms[nFirstStage]->record(stamp.nPublishNs - stamp.nPushNs);
+	if (stamp.nPublishNs != 0 && stamp.nReadNs != 0)
+		m_lpHistograms[nFirstStage + 1]->record(stamp.nReadNs - stamp.nPublishNs);
+	if (stamp.nReadNs != 0)
+		m_lpHistograms[nFirstStage + 2]->record(nHandoffNs - stamp.nReadNs);
+	if (stamp.nPushNs != 0)
+		m_lpHistograms[nFirstStage + 3]->record(nHandoffNs - stamp.nPushNs);
+}
+
+const CHdrHistogram* CLatencyStats::GetHistogram(int nStage) const
+{
+	if (nStage < 0 || nStage >= LATENCY_STAGE_NUM)
+		return NULL;
+	return m_lpHistograms[nStage];
+}
+
+const char* CLatencyStats::GetStageName(int nStage)
+{
+	if (nStage < 0 || nStage >= LATENCY_STAGE_NUM)
+		return NULL;
+	return g_lpStageName[nStage];
+}
+
+void CLatencyStats::Reset()
+{
+	for (int i = 0; i < LATENCY_STAGE_NUM; i++)
+		m_lpHistograms[i]->reset();
+}
+
+void CLatencyStats::Dump(std::ostream& os) const
+{
+	for (int i = 0; i < LATENCY_STAGE_NUM; i++)
+	{
+		os << "# " << g_lpStageName[i] << " ns\n";
+		m_lpHistograms[i]->dump(os);
+	}
+}
+
+void CLatencyStats::PrintPercentiles(std::ostream& os) const
+{
+	for (int i = 0; i < LATENCY_STAGE_NUM; i++)
+		m_lpHistograms[i]->printPercentiles(os, g_lpStageName[i], "ns");
+}
+
+/**
+	rewrite lpPath with the histograms every nIntervalMs until StopDump, a run
+	killed mid-way keeps the dump of the last interval
+Parameters:
+@param nIntervalMs	at least LATENCY_MIN_DUMP_INTERVAL_MS
+@return 0, or -1 when a dump is running or the file can not be created
+*/
+int CLatencyStats::StartDump(const char* lpPath, int nIntervalMs)
+{
+	std::lock_guard<std::mutex> lock(m_lockControl);
+	if (m_thread.joinable() || lpPath == NULL)
+		return -1;
+
+	m_strDumpPath = lpPath;
+	m_nDumpIntervalMs = nIntervalMs < LATENCY_MIN_DUMP_INTERVAL_MS ? LATENCY_MIN_DUMP_INTERVAL_MS : nIntervalMs;
+	if (!WriteDump())
+		return -1;
+
+	m_bStop = false;
+	m_thread = std::thread(&CLatencyStats::ThreadProc, this);
+	return 0;
+}
+
+// writes the file a last time
+void CLatencyStats::StopDump()
+{
+	std::lock_guard<std::mutex> lock(m_lockControl);
+	if (!m_thread.joinable())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lockDump(m_lockDump);
+		m_bStop = true;
+	}
+	m_condDump.notify_one();
+	m_thread.join();
+}
+
+// into <path>.tmp and renamed over the dump, a reader never sees a half written file
+bool CLatencyStats::WriteDump()
+{
+	std::string strTmpPath = m_strDumpPath + ".tmp";
+	{
+		std::ofstream file(strTmpPath.c_str());
+		if (!file)
+		{
+			LOG_WARN("can not write the latency dump %s", strTmpPath.c_str());
+			return false;
+		}
+		Dump(file);
+		file.close();
+		if (file.fail())
+		{
+			LOG_WARN("can not write the latency dump %s", strTmpPath.c_str());
+			remove(strTmpPath.c_str());
+			return false;
+		}
+	}
+
+#ifdef _WIN32
+	bool bRenamed = MoveFileExA(strTmpPath.c_str(), m_strDumpPath.c_str(), MOVEFILE_REPLACE_EXISTING) != FALSE;
+#else
+	bool bRenamed = rename(strTmpPath.c_str(), m_strDumpPath.c_str()) == 0;
+#endif
+	if (!bRenamed)
+	{
+		LOG_WARN("can not replace the latency dump %s", m_strDumpPath.c_str());
+		remove(strTmpPath.c_str());
+		return false;
+	}
+	return true;
+}
+
+void CLatencyStats::ThreadProc()
+{
+	std::unique_lock<std::mutex> lock(m_lockDump);
+	while (!m_bStop)
+	{
+		m_condDump.wait_for(lock, std::chrono::milliseconds(m_nDumpIntervalMs), [this] { return m_bStop; });
+		lock.unlock();
+		WriteDump();
+		lock.lock();
+	}
+}
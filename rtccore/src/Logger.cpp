@@ -0,0 +1,186 @@
+#include "Logger.h"
+#include "MediaClock.h"
+#include "Singleton.h"
+#include <algorithm>
+#include <chrono>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+
+/**
+	single producer ring of one thread. nHead is only moved by the owning
+	thread, nTail only by the drain
+*/
+struct LOG_BUFFER
+{
+	LOG_RECORD records[LOG_BUFFER_CAPACITY];
+	std::atomic<uint64_t> nHead;
+	std::atomic<uint64_t> nTail;
+	std::atomic<uint64_t> nDropped;
+	std::atomic<bool> bOwned;
+	LOG_BUFFER* lpNext;
+
+	LOG_BUFFER() : nHead(0), nTail(0), nDropped(0), bOwned(true), lpNext(NULL) {}
+};
+
+// hands the buffer back when its thread exits, the pending lines are still drained
+struct LOG_THREAD_BUFFER
+{
+	LOG_BUFFER* lpBuffer;
+
+	LOG_THREAD_BUFFER() : lpBuffer(NULL) {}
+	~LOG_THREAD_BUFFER()
+	{
+		if (lpBuffer != NULL)
+			lpBuffer->bOwned.store(false, std::memory_order_release);
+	}
+};
+
+static thread_local LOG_THREAD_BUFFER t_logBuffer;
+
+static const char* g_logLevelNames[] = { "debug", "info", "warn", "error" };
+
+std::atomic<int> CLogger::m_nLevel(LOG_LEVEL_INFO);
+
+RTC_DEFINE_SINGLETON(CLogger)
+
+CLogger::CLogger()
+	: m_lpBuffers(NULL)
+{
+	m_batch.reserve(LOG_BUFFER_CAPACITY * 4);
+	std::thread(&CLogger::ThreadProc, this).detach();
+}
+
+/**
+	format a line into the calling thread's ring, called through the LOG_ macros
+Parameters:
+@param site	rate limit state of the call site
+@param nLevel	LOG_LEVEL of the line
+@param lpFormat	printf format
+*/
+void CLogger::Write(LOG_SITE& site, int nLevel, const char* lpFormat, ...)
+{
+	int64_t nNowUs = CMediaClock::NowUs();
+	uint32_t nSuppressed = 0;
+	if (!Admit(site, nNowUs, nSuppressed))
+		return;
+
+	LOG_BUFFER* lpBuffer = GetThreadBuffer();
+	uint64_t nHead = lpBuffer->nHead.load(std::memory_order_relaxed);
+	if (nHead - lpBuffer->nTail.load(std::memory_order_acquire) >= LOG_BUFFER_CAPACITY)
+	{
+		lpBuffer->nDropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	LOG_RECORD& record = lpBuffer->records[nHead & (LOG_BUFFER_CAPACITY - 1)];
+	record.nTimestampUs = nNowUs;
+	record.nLevel = nLevel;
+	record.nSuppressed = nSuppressed;
+
+	va_list args;
+	va_start(args, lpFormat);
+	vsnprintf(record.szText, LOG_TEXT, lpFormat, args);
+	va_end(args);
+
+	lpBuffer->nHead.store(nHead + 1, std::memory_order_release);
+}
+
+void CLogger::Flush()
+{
+	Drain();
+}
+
+// true when the call site is still within its burst, nSuppressed is set on the first line of a new window
+bool CLogger::Admit(LOG_SITE& site, int64_t nNowUs, uint32_t& nSuppressed)
+{
+	int64_t nWindowUs = site.nWindowUs.load(std::memory_order_relaxed);
+	if (nNowUs - nWindowUs >= LOG_SITE_WINDOW_MS * 1000LL
+		&& site.nWindowUs.compare_exchange_strong(nWindowUs, nNowUs, std::memory_order_relaxed))
+	{
+		site.nCount.store(1, std::memory_order_relaxed);
+		nSuppressed = site.nSuppressed.exchange(0, std::memory_order_relaxed);
+		return true;
+	}
+
+	if (site.nCount.fetch_add(1, std::memory_order_relaxed) < LOG_SITE_BURST)
+		return true;
+
+	site.nSuppressed.fetch_add(1, std::memory_order_relaxed);
+	return false;
+}
+
+// the ring of the calling thread, a free one of an exited thread or a new one on the first line
+LOG_BUFFER* CLogger::GetThreadBuffer()
+{
+	if (t_logBuffer.lpBuffer != NULL)
+		return t_logBuffer.lpBuffer;
+
+	for (LOG_BUFFER* lpBuffer = m_lpBuffers.load(std::memory_order_acquire); lpBuffer != NULL; lpBuffer = lpBuffer->lpNext)
+	{
+		bool bOwned = false;
+		if (lpBuffer->bOwned.compare_exchange_strong(bOwned, true, std::memory_order_acquire))
+			return t_logBuffer.lpBuffer = lpBuffer;
+	}
+
+	LOG_BUFFER* lpBuffer = new LOG_BUFFER();
+	lpBuffer->lpNext = m_lpBuffers.load(std::memory_order_relaxed);
+	while (!m_lpBuffers.compare_exchange_weak(lpBuffer->lpNext, lpBuffer, std::memory_order_release, std::memory_order_relaxed))
+		;
+	return t_logBuffer.lpBuffer = lpBuffer;
+}
+
+void CLogger::ThreadProc()
+{
+	for (;;)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(LOG_DRAIN_INTERVAL_MS));
+		Drain();
+	}
+}
+
+/**
+	copy out the pending lines of every ring, sort them by time and print
+	them with one write and one flush
+*/
+void CLogger::Drain()
+{
+	std::lock_guard<std::mutex> lock(m_lockDrain);
+
+	m_batch.clear();
+	uint64_t nDropped = 0;
+	for (LOG_BUFFER* lpBuffer = m_lpBuffers.load(std::memory_order_acquire); lpBuffer != NULL; lpBuffer = lpBuffer->lpNext)
+	{
+		uint64_t nTail = lpBuffer->nTail.load(std::memory_order_relaxed);
+		uint64_t nHead = lpBuffer->nHead.load(std::memory_order_acquire);
+		for (; nTail != nHead; nTail++)
+			m_batch.push_back(lpBuffer->records[nTail & (LOG_BUFFER_CAPACITY - 1)]);
+		lpBuffer->nTail.store(nTail, std::memory_order_release);
+		nDropped += lpBuffer->nDropped.exchange(0, std::memory_order_relaxed);
+	}
+
+	if (m_batch.empty() && nDropped == 0)
+		return;
+
+	std::stable_sort(m_batch.begin(), m_batch.end(),
+		[](const LOG_RECORD& a, const LOG_RECORD& b) { return a.nTimestampUs < b.nTimestampUs; });
+
+	m_output.clear();
+	char szLine[LOG_TEXT + 64];
+	for (const LOG_RECORD& record : m_batch)
+	{
+		int nLen = record.nSuppressed > 0
+			? snprintf(szLine, sizeof(szLine), "[%s] %s (%u similar lines suppressed)\n", g_logLevelNames[record.nLevel], record.szText, record.nSuppressed)
+			: snprintf(szLine, sizeof(szLine), "[%s] %s\n", g_logLevelNames[record.nLevel], record.szText);
+		m_output.insert(m_output.end(), szLine, szLine + std::min<int>(nLen, sizeof(szLine) - 1));
+	}
+	if (nDropped > 0)
+	{
+		int nLen = snprintf(szLine, sizeof(szLine), "[warn] %llu log lines dropped, a thread logged faster than the drain\n", (unsigned long long)nDropped);
+		m_output.insert(m_output.end(), szLine, szLine + nLen);
+	}
+
+	fwrite(m_output.data(), 1, m_output.size(), stdout);
+	fflush(stdout);
+}
@@ -0,0 +1,25 @@
+#include "MediaClock.h"
+#include <chrono>
+
+std::atomic<IMediaClock*> CMediaClock::m_lpClock(nullptr);
+
+void CMediaClock::SetClock(IMediaClock* lpClock)
+{
+	m_lpClock = lpClock;
+}
+
+int64_t CMediaClock::NowUs()
+{
+	IMediaClock* lpClock = m_lpClock.load(std::memory_order_acquire);
+	if (lpClock)
+		return lpClock->NowUs();
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t CMediaClock::NowNs()
+{
+	IMediaClock* lpClock = m_lpClock.load(std::memory_order_acquire);
+	if (lpClock)
+		return lpClock->NowUs() * 1000;
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
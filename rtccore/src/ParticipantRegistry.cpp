@@ -0,0 +1,417 @@
+#include "ParticipantRegistry.h"
+#include "Logger.h"
+#include "Singleton.h"
+#include <chrono>
+#include <unordered_map>
+
+#define PARTICIPANT_KEY_EMPTY		0ULL
+#define PARTICIPANT_KEY_DELETED		(~0ULL)
+#define PARTICIPANT_SLOT_MASK		(PARTICIPANT_TABLE_SIZE - 1)
+
+RTC_DEFINE_SINGLETON(CParticipantRegistry)
+
+CParticipantRegistry::CParticipantRegistry()
+	: m_nCount(0)
+	, m_nGeneration(0)
+	, m_nDeleted(0)
+	, m_bStop(false)
+{
+	for (int i = 0; i < PARTICIPANT_TABLE_SIZE; i++)
+	{
+		PARTICIPANT_SLOT& slot = m_slots[i];
+		slot.nKey.store(PARTICIPANT_KEY_EMPTY, std::memory_order_relaxed);
+		slot.nSeq.store(0, std::memory_order_relaxed);
+		slot.hView.store(NULL, std::memory_order_relaxed);
+		slot.hRenderView.store(NULL, std::memory_order_relaxed);
+		slot.nFlags.store(0, std::memory_order_relaxed);
+		for (int j = 0; j < PARTICIPANT_STAT_NUM; j++)
+			slot.nStats[j].store(0, std::memory_order_relaxed);
+	}
+}
+
+// 64 bit FNV-1a, the two marker keys are moved aside
+uint64_t CParticipantRegistry::Hash(const std::string& strId)
+{
+	uint64_t nHash = 14695981039346656037ULL;
+	for (size_t i = 0; i < strId.size(); i++)
+	{
+		nHash ^= (unsigned char)strId[i];
+		nHash *= 1099511628211ULL;
+	}
+	if (nHash == PARTICIPANT_KEY_EMPTY || nHash == PARTICIPANT_KEY_DELETED)
+		nHash = 1;
+	return nHash;
+}
+
+int CParticipantRegistry::Find(uint64_t nKey) const
+{
+	int nSlot = (int)(nKey & PARTICIPANT_SLOT_MASK);
+	for (int i = 0; i < PARTICIPANT_TABLE_SIZE; i++)
+	{
+		uint64_t nSlotKey = m_slots[nSlot].nKey.load(std::memory_order_acquire);
+		if (nSlotKey == PARTICIPANT_KEY_EMPTY)
+			return -1;
+		if (nSlotKey == nKey)
+			return nSlot;
+		nSlot = (nSlot + 1) & PARTICIPANT_SLOT_MASK;
+	}
+	return -1;
+}
+
+// the owner and SetStat both write a slot, only one of them holds it odd at a time
+uint32_t CParticipantRegistry::Claim(int nSlot)
+{
+	PARTICIPANT_SLOT& slot = m_slots[nSlot];
+	uint32_t nSeq = slot.nSeq.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		if (nSeq & 1)
+		{
+			std::this_thread::yield();
+			nSeq = slot.nSeq.load(std::memory_order_relaxed);
+			continue;
+		}
+		if (slot.nSeq.compare_exchange_weak(nSeq, nSeq + 1, std::memory_order_acquire, std::memory_order_relaxed))
+			break;
+	}
+	std::atomic_thread_fence(std::memory_order_release);
+	return nSeq;
+}
+
+// the sequence is odd while the slot changes, a reader that saw it change retries
+void CParticipantRegistry::Write(int nSlot, uint64_t nKey, const PARTICIPANT_INFO& info, bool bResetStats)
+{
+	PARTICIPANT_SLOT& slot = m_slots[nSlot];
+	uint32_t nSeq = Claim(nSlot);
+
+	slot.hView.store(info.hView, std::memory_order_relaxed);
+	slot.hRenderView.store(info.hRenderView, std::memory_order_relaxed);
+	slot.nFlags.store(info.nFlags, std::memory_order_relaxed);
+	if (bResetStats)
+	{
+		for (int i = 0; i < PARTICIPANT_STAT_NUM; i++)
+			slot.nStats[i].store(0, std::memory_order_relaxed);
+	}
+	slot.nKey.store(nKey, std::memory_order_release);
+
+	slot.nSeq.store(nSeq + 2, std::memory_order_release);
+}
+
+bool CParticipantRegistry::Add(const std::string& strId, const PARTICIPANT_INFO& info)
+{
+	uint64_t nKey = Hash(strId);
+	std::lock_guard<std::mutex> lock(m_lockWrite);
+	int nFound = Find(nKey);
+	if (nFound >= 0)
+	{
+		if (m_strIds[nFound] != strId)
+			LOG_WARN("participant %s has the hash of %s, not added", strId.c_str(), m_strIds[nFound].c_str());
+		return false;
+	}
+	if (m_nCount.load(std::memory_order_relaxed) >= PARTICIPANT_MAX)
+	{
+		LOG_WARN("%d participants, %s is not added", PARTICIPANT_MAX, strId.c_str());
+		return false;
+	}
+
+	// the first deleted or empty slot of the probe, the key is not behind it
+	int nSlot = (int)(nKey & PARTICIPANT_SLOT_MASK);
+	uint64_t nSlotKey = m_slots[nSlot].nKey.load(std::memory_order_relaxed);
+	while (nSlotKey != PARTICIPANT_KEY_EMPTY && nSlotKey != PARTICIPANT_KEY_DELETED)
+	{
+		nSlot = (nSlot + 1) & PARTICIPANT_SLOT_MASK;
+		nSlotKey = m_slots[nSlot].nKey.load(std::memory_order_relaxed);
+	}
+	if (nSlotKey == PARTICIPANT_KEY_DELETED)
+		m_nDeleted--;
+
+	m_strIds[nSlot] = strId;
+	Write(nSlot, nKey, info, true);
+	m_nCount.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+bool CParticipantRegistry::Remove(const std::string& strId)
+{
+	std::lock_guard<std::mutex> lock(m_lockWrite);
+	int nSlot = Find(Hash(strId));
+	if (nSlot < 0 || m_strIds[nSlot] != strId)
+		return false;
+
+	PARTICIPANT_INFO info = { NULL, NULL, 0 };
+	m_strIds[nSlot].clear();
+	Write(nSlot, PARTICIPANT_KEY_DELETED, info, true);
+	m_nDeleted++;
+	m_nCount.fetch_sub(1, std::memory_order_relaxed);
+
+	// the deleted slots only end a probe when they are gone
+	if (m_nDeleted > PARTICIPANT_TABLE_SIZE / 4)
+		Rebuild();
+	return true;
+}
+
+bool CParticipantRegistry::Update(const std::string& strId, const PARTICIPANT_INFO& info)
+{
+	uint64_t nKey = Hash(strId);
+	std::lock_guard<std::mutex> lock(m_lockWrite);
+	int nSlot = Find(nKey);
+	if (nSlot < 0 || m_strIds[nSlot] != strId)
+		return false;
+
+	Write(nSlot, nKey, info, false);
+	return true;
+}
+
+/**
+	a new generation, the events posted before are dropped by the handler
+*/
+void CParticipantRegistry::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_lockWrite);
+	PARTICIPANT_INFO info = { NULL, NULL, 0 };
+	for (int i = 0; i < PARTICIPANT_TABLE_SIZE; i++)
+	{
+		if (m_slots[i].nKey.load(std::memory_order_relaxed) == PARTICIPANT_KEY_EMPTY)
+			continue;
+		m_strIds[i].clear();
+		Write(i, PARTICIPANT_KEY_EMPTY, info, true);
+	}
+	m_nCount.store(0, std::memory_order_relaxed);
+	m_nDeleted = 0;
+	m_nGeneration.fetch_add(1, std::memory_order_release);
+}
+
+/**
+	under m_lockWrite, puts every participant back at the start of its probe
+	without the deleted slots in between. a reader may miss a participant
+	while it moves and takes it as gone for that one lookup
+*/
+void CParticipantRegistry::Rebuild()
+{
+	struct PARTICIPANT_COPY
+	{
+		uint64_t nKey;
+		std::string strId;
+		PARTICIPANT_INFO info;
+		int32_t nStats[PARTICIPANT_STAT_NUM];
+	};
+	std::vector<PARTICIPANT_COPY> vecCopies;
+	vecCopies.reserve(m_nCount.load(std::memory_order_relaxed));
+
+	PARTICIPANT_INFO empty = { NULL, NULL, 0 };
+	for (int i = 0; i < PARTICIPANT_TABLE_SIZE; i++)
+	{
+		PARTICIPANT_SLOT& slot = m_slots[i];
+		uint64_t nKey = slot.nKey.load(std::memory_order_relaxed);
+		if (nKey == PARTICIPANT_KEY_EMPTY)
+			continue;
+		if (nKey != PARTICIPANT_KEY_DELETED)
+		{
+			PARTICIPANT_COPY copy;
+			copy.nKey = nKey;
+			copy.strId.swap(m_strIds[i]);
+			copy.info.hView = slot.hView.load(std::memory_order_relaxed);
+			copy.info.hRenderView = slot.hRenderView.load(std::memory_order_relaxed);
+			copy.info.nFlags = slot.nFlags.load(std::memory_order_relaxed);
+			for (int j = 0; j < PARTICIPANT_STAT_NUM; j++)
+				copy.nStats[j] = slot.nStats[j].load(std::memory_order_relaxed);
+			vecCopies.push_back(copy);
+		}
+		Write(i, PARTICIPANT_KEY_EMPTY, empty, true);
+	}
+	m_nDeleted = 0;
+
+	for (auto& copy : vecCopies)
+	{
+		int nSlot = (int)(copy.nKey & PARTICIPANT_SLOT_MASK);
+		while (m_slots[nSlot].nKey.load(std::memory_order_relaxed) != PARTICIPANT_KEY_EMPTY)
+			nSlot = (nSlot + 1) & PARTICIPANT_SLOT_MASK;
+
+		m_strIds[nSlot].swap(copy.strId);
+		for (int j = 0; j < PARTICIPANT_STAT_NUM; j++)
+			m_slots[nSlot].nStats[j].store(copy.nStats[j], std::memory_order_relaxed);
+		Write(nSlot, copy.nKey, copy.info, false);
+	}
+}
+
+void CParticipantRegistry::GetIds(std::vector<std::string>& vecIds)
+{
+	std::lock_guard<std::mutex> lock(m_lockWrite);
+	vecIds.clear();
+	vecIds.reserve(m_nCount.load(std::memory_order_relaxed));
+	for (int i = 0; i < PARTICIPANT_TABLE_SIZE; i++)
+	{
+		uint64_t nKey = m_slots[i].nKey.load(std::memory_order_relaxed);
+		if (nKey != PARTICIPANT_KEY_EMPTY && nKey != PARTICIPANT_KEY_DELETED)
+			vecIds.push_back(m_strIds[i]);
+	}
+}
+
+bool CParticipantRegistry::Get(const std::string& strId, PARTICIPANT_INFO& info) const
+{
+	uint64_t nKey = Hash(strId);
+	for (;;)
+	{
+		int nSlot = Find(nKey);
+		if (nSlot < 0)
+			return false;
+
+		const PARTICIPANT_SLOT& slot = m_slots[nSlot];
+		uint32_t nSeq = slot.nSeq.load(std::memory_order_acquire);
+		if (nSeq & 1)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+		info.hView = slot.hView.load(std::memory_order_relaxed);
+		info.hRenderView = slot.hRenderView.load(std::memory_order_relaxed);
+		info.nFlags = slot.nFlags.load(std::memory_order_relaxed);
+		uint64_t nSlotKey = slot.nKey.load(std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (slot.nSeq.load(std::memory_order_relaxed) == nSeq && nSlotKey == nKey)
+			return true;
+	}
+}
+
+bool CParticipantRegistry::Contains(const std::string& strId) const
+{
+	return Find(Hash(strId)) >= 0;
+}
+
+/**
+	a stats callback stores the value without the owner's lock. the slot is
+	looked up by the hash and claimed, the key is checked again before the
+	store: the owner may have removed or moved the participant after Find.
+	a report racing the leave of its participant is lost
+*/
+void CParticipantRegistry::SetStat(const std::string& strId, int nStat, int32_t nValue)
+{
+	if (nStat < 0 || nStat >= PARTICIPANT_STAT_NUM)
+		return;
+
+	uint64_t nKey = Hash(strId);
+	for (;;)
+	{
+		int nSlot = Find(nKey);
+		if (nSlot < 0)
+			return;
+
+		PARTICIPANT_SLOT& slot = m_slots[nSlot];
+		uint32_t nSeq = Claim(nSlot);
+		bool bStored = slot.nKey.load(std::memory_order_relaxed) == nKey;
+		if (bStored)
+			slot.nStats[nStat].store(nValue, std::memory_order_relaxed);
+		slot.nSeq.store(nSeq + 2, std::memory_order_release);
+		if (bStored)
+			return;
+	}
+}
+
+bool CParticipantRegistry::GetStat(const std::string& strId, int nStat, int32_t& nValue) const
+{
+	if (nStat < 0 || nStat >= PARTICIPANT_STAT_NUM)
+		return false;
+
+	uint64_t nKey = Hash(strId);
+	for (;;)
+	{
+		int nSlot = Find(nKey);
+		if (nSlot < 0)
+			return false;
+
+		const PARTICIPANT_SLOT& slot = m_slots[nSlot];
+		uint32_t nSeq = slot.nSeq.load(std::memory_order_acquire);
+		if (nSeq & 1)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+		nValue = slot.nStats[nStat].load(std::memory_order_relaxed);
+		uint64_t nSlotKey = slot.nKey.load(std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (slot.nSeq.load(std::memory_order_relaxed) == nSeq && nSlotKey == nKey)
+			return true;
+	}
+}
+
+void CParticipantRegistry::SetBatchHandler(const BATCH_HANDLER& fnHandler)
+{
+	std::lock_guard<std::mutex> lock(m_lockBatch);
+	m_fnHandler = fnHandler;
+}
+
+/**
+	queue a join or leave for the batch handler, the worker starts with the
+	first event after SetBatchHandler. dropped while no handler is set
+*/
+void CParticipantRegistry::Post(int nType, const std::string& strId)
+{
+	std::lock_guard<std::mutex> lockControl(m_lockControl);
+	{
+		std::lock_guard<std::mutex> lock(m_lockBatch);
+		if (!m_fnHandler)
+			return;
+
+		PARTICIPANT_EVENT event;
+		event.nType = nType;
+		event.strId = strId;
+		event.nGeneration = GetGeneration();
+		m_vecEvents.push_back(event);
+		if (!m_thread.joinable())
+		{
+			m_bStop = false;
+			m_thread = std::thread(&CParticipantRegistry::ThreadProc, this);
+		}
+	}
+	m_condBatch.notify_one();
+}
+
+void CParticipantRegistry::StopBatching()
+{
+	std::lock_guard<std::mutex> lockControl(m_lockControl);
+	{
+		std::lock_guard<std::mutex> lock(m_lockBatch);
+		// a late Post of an SDK thread must not start the worker on the handler of a gone engine
+		m_fnHandler = nullptr;
+		if (!m_thread.joinable())
+			return;
+		m_bStop = true;
+		m_vecEvents.clear();
+	}
+	m_condBatch.notify_one();
+	m_thread.join();
+}
+
+void CParticipantRegistry::ThreadProc()
+{
+	std::unique_lock<std::mutex> lock(m_lockBatch);
+	while (!m_bStop)
+	{
+		m_condBatch.wait(lock, [this] { return m_bStop || !m_vecEvents.empty(); });
+		// the rest of a storm arrives meanwhile
+		if (m_condBatch.wait_for(lock, std::chrono::milliseconds(PARTICIPANT_BATCH_MS), [this] { return m_bStop; }))
+			break;
+
+		std::vector<PARTICIPANT_EVENT> vecEvents;
+		vecEvents.swap(m_vecEvents);
+		BATCH_HANDLER fnHandler = m_fnHandler;
+		lock.unlock();
+
+		// a join and a leave of the same id cancel out to the last one, in the order of the last events
+		std::unordered_map<std::string, size_t> mapLast;
+		for (size_t i = 0; i < vecEvents.size(); i++)
+			mapLast[vecEvents[i].strId] = i;
+		std::vector<PARTICIPANT_EVENT> vecBatch;
+		vecBatch.reserve(mapLast.size());
+		for (size_t i = 0; i < vecEvents.size(); i++)
+		{
+			if (mapLast[vecEvents[i].strId] == i)
+				vecBatch.push_back(vecEvents[i]);
+		}
+		if (vecBatch.size() < vecEvents.size())
+			LOG_DEBUG("%u participant events coalesced to %u", (unsigned)vecEvents.size(), (unsigned)vecBatch.size());
+		fnHandler(vecBatch);
+
+		lock.lock();
+	}
+}
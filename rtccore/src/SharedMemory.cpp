@@ -0,0 +1,102 @@
+#include "SharedMemory.h"
+#include "Logger.h"
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+CSharedMemory::CSharedMemory()
+	: m_lpData(NULL)
+	, m_nSize(0)
+#ifdef _WIN32
+	, m_hMapping(NULL)
+#endif
+{
+}
+
+CSharedMemory::~CSharedMemory()
+{
+	Close();
+}
+
+#ifdef _WIN32
+bool CSharedMemory::Create(const std::string& strName, size_t nSize)
+{
+	Close();
+	std::string strPath = "Local\\" + strName;
+	m_hMapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, (DWORD)((uint64_t)nSize >> 32), (DWORD)nSize, strPath.c_str());
+	if (m_hMapping == NULL)
+	{
+		LOG_ERROR("CreateFileMapping %s failed, error %u", strPath.c_str(), (unsigned)GetLastError());
+		return false;
+	}
+	// the pages of a new mapping are zero, an old one still mapped by a reader is not
+	bool bExisting = GetLastError() == ERROR_ALREADY_EXISTS;
+	m_lpData = (BYTE*)MapViewOfFile(m_hMapping, FILE_MAP_ALL_ACCESS, 0, 0, nSize);
+	if (m_lpData == NULL)
+	{
+		LOG_ERROR("MapViewOfFile %s failed, error %u", strPath.c_str(), (unsigned)GetLastError());
+		CloseHandle(m_hMapping);
+		m_hMapping = NULL;
+		return false;
+	}
+	if (bExisting)
+		memset(m_lpData, 0, nSize);
+	m_strName = strName;
+	m_nSize = nSize;
+	return true;
+}
+
+void CSharedMemory::Close()
+{
+	if (m_lpData != NULL)
+		UnmapViewOfFile(m_lpData);
+	if (m_hMapping != NULL)
+		CloseHandle(m_hMapping);
+	m_lpData = NULL;
+	m_hMapping = NULL;
+	m_nSize = 0;
+	m_strName.clear();
+}
+#else
+bool CSharedMemory::Create(const std::string& strName, size_t nSize)
+{
+	Close();
+	// a new inode, a reader of a block left behind keeps its own pages instead of faulting on a truncate
+	std::string strPath = "/" + strName;
+	shm_unlink(strPath.c_str());
+	int fd = shm_open(strPath.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+	if (fd < 0)
+	{
+		LOG_ERROR("shm_open %s failed, errno %d", strPath.c_str(), errno);
+		return false;
+	}
+	void* lpData = MAP_FAILED;
+	if (ftruncate(fd, (off_t)nSize) == 0)
+		lpData = mmap(NULL, nSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	int nError = errno;
+	close(fd);
+	if (lpData == MAP_FAILED)
+	{
+		LOG_ERROR("mapping %s of %zu bytes failed, errno %d", strPath.c_str(), nSize, nError);
+		shm_unlink(strPath.c_str());
+		return false;
+	}
+	m_lpData = (BYTE*)lpData;
+	m_strName = strName;
+	m_nSize = nSize;
+	return true;
+}
+
+void CSharedMemory::Close()
+{
+	if (m_lpData == NULL)
+		return;
+	munmap(m_lpData, m_nSize);
+	shm_unlink(("/" + m_strName).c_str());
+	m_lpData = NULL;
+	m_nSize = 0;
+	m_strName.clear();
+}
+#endif
@@ -0,0 +1,125 @@
+#include "SpeakerScheduler.h"
+#include <algorithm>
+
+CSpeakerScheduler::CSpeakerScheduler()
+	: m_nSeq(0)
+{
+}
+
+void CSpeakerScheduler::Clear()
+{
+	m_mapStates.clear();
+}
+
+void CSpeakerScheduler::Add(const std::string& strKey, bool bShown, int64_t nNowMs)
+{
+	if (m_mapStates.find(strKey) != m_mapStates.end())
+		return;
+
+	SPEAKER_STATE& state = m_mapStates[strKey];
+	state.dLevel = 0;
+	state.bReported = false;
+	state.nSeq = m_nSeq++;
+	Show(state, bShown, nNowMs);
+}
+
+void CSpeakerScheduler::Remove(const std::string& strKey)
+{
+	m_mapStates.erase(strKey);
+}
+
+bool CSpeakerScheduler::IsKnown(const std::string& strKey) const
+{
+	return m_mapStates.find(strKey) != m_mapStates.end();
+}
+
+bool CSpeakerScheduler::IsWaiting(const std::string& strKey) const
+{
+	auto it = m_mapStates.find(strKey);
+	return it != m_mapStates.end() && !it->second.bShown;
+}
+
+void CSpeakerScheduler::UpdateLevels(const std::vector<std::pair<std::string, float>>& vecLevels)
+{
+	for (auto& level : vecLevels)
+	{
+		auto it = m_mapStates.find(level.first);
+		if (it == m_mapStates.end())
+			continue;
+		double dLevel = std::min(100.0, std::max(0.0, (double)level.second));
+		it->second.dLevel += SPEAKER_LEVEL_SMOOTHING * (dLevel - it->second.dLevel);
+		it->second.bReported = true;
+	}
+
+	for (auto& item : m_mapStates)
+	{
+		if (!item.second.bReported)
+			item.second.dLevel -= SPEAKER_LEVEL_SMOOTHING * item.second.dLevel;
+		item.second.bReported = false;
+	}
+}
+
+bool CSpeakerScheduler::PickWaiting(int64_t nNowMs, std::string& strKey)
+{
+	auto best = m_mapStates.end();
+	for (auto it = m_mapStates.begin(); it != m_mapStates.end(); ++it)
+	{
+		if (it->second.bShown)
+			continue;
+		if (best == m_mapStates.end() || it->second.dLevel > best->second.dLevel
+			|| (it->second.dLevel == best->second.dLevel && it->second.nSeq < best->second.nSeq))
+			best = it;
+	}
+	if (best == m_mapStates.end())
+		return false;
+
+	Show(best->second, true, nNowMs);
+	strKey = best->first;
+	return true;
+}
+
+/**
+	pair the loudest waiting participants with the quietest shown ones that
+	held their view long enough, as long as the margin holds
+Parameters:
+@param nNowMs	CMediaClock time in ms
+@param vecSwaps	filled with (shown, waiting), the first loses its view to the second
+*/
+void CSpeakerScheduler::Schedule(int64_t nNowMs, std::vector<std::pair<std::string, std::string>>& vecSwaps)
+{
+	typedef std::unordered_map<std::string, SPEAKER_STATE>::iterator STATE_ITER;
+	std::vector<STATE_ITER> vecShown, vecWaiting;
+	for (auto it = m_mapStates.begin(); it != m_mapStates.end(); ++it)
+	{
+		if (!it->second.bShown)
+			vecWaiting.push_back(it);
+		else if (nNowMs - it->second.nShownMs >= SPEAKER_MIN_HOLD_MS)
+			vecShown.push_back(it);
+	}
+	if (vecShown.empty() || vecWaiting.empty())
+		return;
+
+	// quietest shown first, the later arrival loses a tie
+	std::sort(vecShown.begin(), vecShown.end(), [](const STATE_ITER& a, const STATE_ITER& b) {
+		return a->second.dLevel != b->second.dLevel ? a->second.dLevel < b->second.dLevel : a->second.nSeq > b->second.nSeq;
+	});
+	// loudest waiting first, the earlier arrival wins a tie
+	std::sort(vecWaiting.begin(), vecWaiting.end(), [](const STATE_ITER& a, const STATE_ITER& b) {
+		return a->second.dLevel != b->second.dLevel ? a->second.dLevel > b->second.dLevel : a->second.nSeq < b->second.nSeq;
+	});
+
+	for (size_t i = 0; i < vecShown.size() && i < vecWaiting.size(); i++)
+	{
+		if (vecWaiting[i]->second.dLevel < vecShown[i]->second.dLevel + SPEAKER_SWITCH_MARGIN)
+			break;
+		Show(vecShown[i]->second, false, nNowMs);
+		Show(vecWaiting[i]->second, true, nNowMs);
+		vecSwaps.push_back(std::make_pair(vecShown[i]->first, vecWaiting[i]->first));
+	}
+}
+
+void CSpeakerScheduler::Show(SPEAKER_STATE& state, bool bShown, int64_t nNowMs)
+{
+	state.bShown = bShown;
+	state.nShownMs = nNowMs;
+}
@@ -0,0 +1,271 @@
+#include "StatsRecorder.h"
+#include "MediaClock.h"
+#include "Singleton.h"
+#include <chrono>
+#include <string.h>
+
+#define STATS_FILE_MAGIC	"RTCSTATS"
+#define STATS_FILE_VERSION	1
+
+enum STATS_BLOCK_TYPE
+{
+	STATS_BLOCK_KEY = 1,		// key, name. written before the first sample of a named key, numbered keys have none
+	STATS_BLOCK_SAMPLES,		// kind, count, then every column as zigzag varint deltas
+	STATS_BLOCK_DROPPED,		// samples lost since the last block because the ring was full
+};
+
+static void PutVarint(std::vector<uint8_t>& buffer, uint64_t nValue)
+{
+	while (nValue >= 0x80)
+	{
+		buffer.push_back((uint8_t)(nValue | 0x80));
+		nValue >>= 7;
+	}
+	buffer.push_back((uint8_t)nValue);
+}
+
+// small deltas of either sign become small unsigned numbers
+static void PutDelta(std::vector<uint8_t>& buffer, int64_t nDelta)
+{
+	PutVarint(buffer, ((uint64_t)nDelta << 1) ^ (uint64_t)(nDelta >> 63));
+}
+
+static void PutString(std::vector<uint8_t>& buffer, const char* lpText)
+{
+	size_t nLen = strlen(lpText);
+	PutVarint(buffer, nLen);
+	buffer.insert(buffer.end(), lpText, lpText + nLen);
+}
+
+static void PutInt64(std::vector<uint8_t>& buffer, int64_t nValue)
+{
+	for (int i = 0; i < 8; i++)
+		buffer.push_back((uint8_t)((uint64_t)nValue >> (i * 8)));
+}
+
+std::atomic<bool> CStatsRecorder::m_bRecording(false);
+
+RTC_DEFINE_SINGLETON(CStatsRecorder)
+
+CStatsRecorder::CStatsRecorder()
+	: m_nDroppedWritten(0)
+	, m_lpFile(NULL)
+	, m_schemas()
+	, m_nWritten(0)
+	, m_bStop(false)
+{
+	memset(m_nFieldCount, 0, sizeof(m_nFieldCount));
+}
+
+void CStatsRecorder::Init(STATS_SAMPLE& sample, int nKind, uint32_t nKey)
+{
+	memset(&sample, 0, sizeof(sample));
+	sample.nTimestampUs = CMediaClock::NowUs();
+	sample.nKind = nKind;
+	sample.nKey = nKey;
+}
+
+void CStatsRecorder::Init(STATS_SAMPLE& sample, int nKind, const std::string& strKey)
+{
+	Init(sample, nKind, 0);
+	size_t nLen = strKey.size() < STATS_KEY_TEXT - 1 ? strKey.size() : STATS_KEY_TEXT - 1;
+	memcpy(sample.szKey, strKey.data(), nLen);
+}
+
+/**
+	start writing the stats callbacks to a file
+Parameters:
+@param lpPath	file to create, an existing one is overwritten
+@param schemas	the kinds of the backend, the samples of any other kind are skipped
+@return 0, or -1 when already recording or the file can not be created
+*/
+int CStatsRecorder::Start(const char* lpPath, const STATS_SCHEMA_SET& schemas)
+{
+	std::lock_guard<std::mutex> lock(m_lockControl);
+	if (m_lpFile != NULL || lpPath == NULL || schemas.nCount < 0 || schemas.nCount > STATS_MAX_KINDS)
+		return -1;
+
+	m_lpFile = fopen(lpPath, "wb");
+	if (m_lpFile == NULL)
+		return -1;
+
+	// whatever a callback pushed after the last Stop belongs to no file
+	STATS_SAMPLE sample;
+	while (m_ring.Pop(sample))
+		;
+	m_nDroppedWritten = m_ring.GetDropped();
+	m_nWritten = 0;
+	m_keys.clear();
+	m_schemas = schemas;
+	memset(m_nFieldCount, 0, sizeof(m_nFieldCount));
+	for (int i = 0; i < schemas.nCount; i++)
+	{
+		const STATS_SCHEMA& schema = schemas.lpSchemas[i];
+		if (schema.nKind < 1 || schema.nKind > STATS_MAX_KINDS)
+			continue;
+		while (schema.fields[m_nFieldCount[schema.nKind]].lpName != NULL)
+			m_nFieldCount[schema.nKind]++;
+	}
+	WriteHeader();
+
+	m_bStop = false;
+	m_thread = std::thread(&CStatsRecorder::ThreadProc, this);
+	m_bRecording.store(true, std::memory_order_relaxed);
+	return 0;
+}
+
+int64_t CStatsRecorder::Stop()
+{
+	std::lock_guard<std::mutex> lock(m_lockControl);
+	if (m_lpFile == NULL)
+		return -1;
+
+	m_bRecording.store(false, std::memory_order_relaxed);
+	{
+		std::lock_guard<std::mutex> lockWriter(m_lockWriter);
+		m_bStop = true;
+	}
+	m_condWriter.notify_one();
+	m_thread.join();
+
+	fclose(m_lpFile);
+	m_lpFile = NULL;
+	return m_nWritten;
+}
+
+void CStatsRecorder::ThreadProc()
+{
+	std::unique_lock<std::mutex> lock(m_lockWriter);
+	while (!m_bStop)
+	{
+		m_condWriter.wait_for(lock, std::chrono::milliseconds(STATS_FLUSH_INTERVAL_MS), [this] { return m_bStop; });
+		lock.unlock();
+		Flush();
+		lock.lock();
+	}
+	lock.unlock();
+
+	// what the callbacks pushed while the last flush ran
+	Flush();
+}
+
+// the number of a named key, a new one is announced with a key block ahead of its samples
+uint32_t CStatsRecorder::GetKey(const char* lpKey)
+{
+	auto it = m_keys.find(lpKey);
+	if (it != m_keys.end())
+		return it->second;
+
+	uint32_t nKey = (uint32_t)m_keys.size() + 1;
+	m_keys.emplace(lpKey, nKey);
+	m_buffer.push_back(STATS_BLOCK_KEY);
+	PutVarint(m_buffer, nKey);
+	PutString(m_buffer, lpKey);
+	return nKey;
+}
+
+void CStatsRecorder::Flush()
+{
+	m_buffer.clear();
+
+	STATS_SAMPLE sample;
+	while (m_ring.Pop(sample))
+	{
+		if (sample.nKind < 1 || sample.nKind > STATS_MAX_KINDS || m_nFieldCount[sample.nKind] == 0)
+			continue;
+		if (sample.szKey[0] != '\0')
+			sample.nKey = GetKey(sample.szKey);
+		m_pending[sample.nKind].push_back(sample);
+	}
+
+	uint64_t nDropped = m_ring.GetDropped();
+	if (nDropped != m_nDroppedWritten)
+	{
+		m_buffer.push_back(STATS_BLOCK_DROPPED);
+		PutVarint(m_buffer, nDropped - m_nDroppedWritten);
+		m_nDroppedWritten = nDropped;
+	}
+
+	for (int nKind = 1; nKind <= STATS_MAX_KINDS; nKind++)
+	{
+		if (m_pending[nKind].empty())
+			continue;
+		WriteSamples(nKind, m_pending[nKind]);
+		m_nWritten += m_pending[nKind].size();
+		m_pending[nKind].clear();
+	}
+
+	if (m_buffer.empty())
+		return;
+	fwrite(m_buffer.data(), 1, m_buffer.size(), m_lpFile);
+	fflush(m_lpFile);
+}
+
+/**
+	magic, version, vendor, the clocks to turn sample times into wall time,
+	then the name, key name and columns with their scale of every kind
+*/
+void CStatsRecorder::WriteHeader()
+{
+	m_buffer.assign(STATS_FILE_MAGIC, STATS_FILE_MAGIC + 8);
+	m_buffer.push_back(STATS_FILE_VERSION);
+	PutString(m_buffer, m_schemas.lpVendor);
+	PutInt64(m_buffer, CMediaClock::NowUs());
+	PutInt64(m_buffer, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+
+	m_buffer.push_back((uint8_t)m_schemas.nCount);
+	for (int nSchema = 0; nSchema < m_schemas.nCount; nSchema++)
+	{
+		const STATS_SCHEMA& schema = m_schemas.lpSchemas[nSchema];
+		int nFieldCount = 0;
+		while (schema.fields[nFieldCount].lpName != NULL)
+			nFieldCount++;
+
+		m_buffer.push_back((uint8_t)schema.nKind);
+		PutString(m_buffer, schema.lpName);
+		PutString(m_buffer, schema.lpKeyName);
+		m_buffer.push_back((uint8_t)nFieldCount);
+		for (int i = 0; i < nFieldCount; i++)
+		{
+			PutString(m_buffer, schema.fields[i].lpName);
+			PutVarint(m_buffer, schema.fields[i].nScale);
+		}
+	}
+
+	fwrite(m_buffer.data(), 1, m_buffer.size(), m_lpFile);
+	fflush(m_lpFile);
+}
+
+// column by column, each one starting from 0 so the block decodes on its own
+void CStatsRecorder::WriteSamples(int nKind, const std::vector<STATS_SAMPLE>& samples)
+{
+	int nFieldCount = m_nFieldCount[nKind];
+
+	m_buffer.push_back(STATS_BLOCK_SAMPLES);
+	m_buffer.push_back((uint8_t)nKind);
+	PutVarint(m_buffer, samples.size());
+
+	int64_t nPrev = 0;
+	for (const STATS_SAMPLE& sample : samples)
+	{
+		PutDelta(m_buffer, sample.nTimestampUs - nPrev);
+		nPrev = sample.nTimestampUs;
+	}
+
+	nPrev = 0;
+	for (const STATS_SAMPLE& sample : samples)
+	{
+		PutDelta(m_buffer, (int64_t)sample.nKey - nPrev);
+		nPrev = sample.nKey;
+	}
+
+	for (int nField = 0; nField < nFieldCount; nField++)
+	{
+		nPrev = 0;
+		for (const STATS_SAMPLE& sample : samples)
+		{
+			PutDelta(m_buffer, sample.nValues[nField] - nPrev);
+			nPrev = sample.nValues[nField];
+		}
+	}
+}
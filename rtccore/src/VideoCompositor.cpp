@@ -0,0 +1,229 @@
+#include "VideoCompositor.h"
+#include "AGExtInfoManager.h"
+#include "ImageScaler.h"
+#include "Logger.h"
+#include "MediaClock.h"
+#include "ParticipantRegistry.h"
+#include "Singleton.h"
+
+RTC_DEFINE_SINGLETON(CVideoCompositor)
+
+CVideoCompositor::CVideoCompositor()
+	: m_bRunning(false)
+	, m_nCols(0)
+	, m_nTiles(0)
+	, m_nTileWidth(0)
+	, m_nTileHeight(0)
+	, m_nWidth(0)
+	, m_nHeight(0)
+	, m_nFrames(0)
+	, m_nDropped(0)
+{
+	memset(m_tiles, 0, sizeof(m_tiles));
+}
+
+bool CVideoCompositor::Start(int nCols, int nRows, int nTileWidth, int nTileHeight)
+{
+	nTileWidth &= ~1;
+	nTileHeight &= ~1;
+	if (nCols <= 0 || nRows <= 0 || nCols * nRows > COMPOSITOR_MAX_TILES || nTileWidth < 2 || nTileHeight < 2
+		|| nCols * nTileWidth > COMPOSITOR_MAX_WIDTH || nRows * nTileHeight > COMPOSITOR_MAX_HEIGHT)
+		return false;
+
+	std::lock_guard<std::mutex> lock(m_lockLayout);
+	for (int i = 0; i < COMPOSITOR_MAX_TILES; i++)
+		m_lockTiles[i].lock();
+
+	m_nCols = nCols;
+	m_nTiles = nCols * nRows;
+	m_nTileWidth = nTileWidth;
+	m_nTileHeight = nTileHeight;
+	m_nWidth = nCols * nTileWidth;
+	m_nHeight = nRows * nTileHeight;
+	size_t nLumaSize = (size_t)m_nWidth * m_nHeight;
+	m_vecBack.assign(nLumaSize * 3 / 2, COMPOSITOR_BLACK_UV);
+	memset(m_vecBack.data(), COMPOSITOR_BLACK_Y, nLumaSize);
+	m_vecSurface = m_vecBack;
+	memset(m_tiles, 0, sizeof(m_tiles));
+	m_nFrames = 0;
+	m_nDropped = 0;
+	m_bRunning = true;
+
+	for (int i = 0; i < COMPOSITOR_MAX_TILES; i++)
+		m_lockTiles[i].unlock();
+
+	LOG_INFO("compositor %dx%d tiles of %dx%d, simd %d", nCols, nRows, nTileWidth, nTileHeight, CImageScaler::HasSimd() ? 1 : 0);
+	return true;
+}
+
+void CVideoCompositor::Stop()
+{
+	std::lock_guard<std::mutex> lock(m_lockLayout);
+	if (!m_bRunning)
+		return;
+
+	for (int i = 0; i < COMPOSITOR_MAX_TILES; i++)
+		m_lockTiles[i].lock();
+
+	m_bRunning = false;
+	m_nTiles = 0;
+	std::vector<BYTE>().swap(m_vecBack);
+	std::vector<BYTE>().swap(m_vecSurface);
+
+	for (int i = 0; i < COMPOSITOR_MAX_TILES; i++)
+		m_lockTiles[i].unlock();
+
+	LOG_INFO("compositor stopped, %lld frames, %lld dropped", (long long)m_nFrames.load(), (long long)m_nDropped.load());
+}
+
+void CVideoCompositor::PutFrame(const std::string& strId, const BYTE* lpY, int nYStride, const BYTE* lpU, int nUStride,
+	const BYTE* lpV, int nVStride, int nWidth, int nHeight)
+{
+	if (!IsRunning() || lpY == NULL || lpU == NULL || lpV == NULL || nWidth < 2 || nHeight < 2)
+		return;
+
+	PARTICIPANT_INFO info;
+	int nTile = -1;
+	if (CParticipantRegistry::GetInstance()->Get(strId, info) && info.hView != NULL)
+		nTile = CAGExtInfoManager::GetAGExtInfoManager()->GetViewIndex(info.hView);
+	if (nTile < 0 || nTile >= COMPOSITOR_MAX_TILES)
+	{
+		m_nDropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_lockTiles[nTile]);
+	if (!m_bRunning || nTile >= m_nTiles)
+	{
+		m_nDropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	// fit the frame into the tile, even sizes and offsets keep the chroma aligned
+	int nFitWidth = m_nTileWidth;
+	int nFitHeight = m_nTileHeight;
+	if ((int64_t)nWidth * m_nTileHeight > (int64_t)nHeight * m_nTileWidth)
+		nFitHeight = (int)((int64_t)nHeight * m_nTileWidth / nWidth) & ~1;
+	else
+		nFitWidth = (int)((int64_t)nWidth * m_nTileHeight / nHeight) & ~1;
+	nFitWidth = nFitWidth < 2 ? 2 : nFitWidth;
+	nFitHeight = nFitHeight < 2 ? 2 : nFitHeight;
+	int nFitX = ((m_nTileWidth - nFitWidth) / 2) & ~1;
+	int nFitY = ((m_nTileHeight - nFitHeight) / 2) & ~1;
+
+	COMPOSITOR_TILE& tile = m_tiles[nTile];
+	if (tile.bDrawn && (tile.nFitX != nFitX || tile.nFitY != nFitY || tile.nFitWidth != nFitWidth || tile.nFitHeight != nFitHeight))
+		ClearTile(m_vecBack, nTile);
+
+	int nX = 0, nY = 0;
+	GetTileOrigin(nTile, nX, nY);
+	nX += nFitX;
+	nY += nFitY;
+	BYTE* lpBackY = m_vecBack.data();
+	BYTE* lpBackU = lpBackY + (size_t)m_nWidth * m_nHeight;
+	BYTE* lpBackV = lpBackU + (size_t)m_nWidth * m_nHeight / 4;
+	int nChromaStride = m_nWidth / 2;
+	size_t nChromaOffset = (size_t)(nY / 2) * nChromaStride + nX / 2;
+	CImageScaler::ScalePlane(lpY, nYStride, nWidth, nHeight, lpBackY + (size_t)nY * m_nWidth + nX, m_nWidth, nFitWidth, nFitHeight);
+	CImageScaler::ScalePlane(lpU, nUStride, (nWidth + 1) / 2, (nHeight + 1) / 2, lpBackU + nChromaOffset, nChromaStride, nFitWidth / 2, nFitHeight / 2);
+	CImageScaler::ScalePlane(lpV, nVStride, (nWidth + 1) / 2, (nHeight + 1) / 2, lpBackV + nChromaOffset, nChromaStride, nFitWidth / 2, nFitHeight / 2);
+
+	tile.nFitX = nFitX;
+	tile.nFitY = nFitY;
+	tile.nFitWidth = nFitWidth;
+	tile.nFitHeight = nFitHeight;
+	tile.bDirty = true;
+	tile.bDrawn = true;
+	tile.nLastFrameMs = CMediaClock::NowUs() / 1000;
+	m_nFrames.fetch_add(1, std::memory_order_relaxed);
+}
+
+int CVideoCompositor::Composite(COMPOSITOR_RECT* lpRects, int nMaxRects)
+{
+	std::lock_guard<std::mutex> lock(m_lockLayout);
+	if (!m_bRunning)
+		return 0;
+
+	int64_t nNowMs = CMediaClock::NowUs() / 1000;
+	int nRects = 0;
+	for (int i = 0; i < m_nTiles; i++)
+	{
+		std::lock_guard<std::mutex> lockTile(m_lockTiles[i]);
+		COMPOSITOR_TILE& tile = m_tiles[i];
+		if (tile.bDirty)
+		{
+			CopyTile(i);
+			tile.bDirty = false;
+		}
+		else if (tile.bDrawn && nNowMs - tile.nLastFrameMs > COMPOSITOR_STALE_MS)
+		{
+			ClearTile(m_vecBack, i);
+			ClearTile(m_vecSurface, i);
+			tile.bDrawn = false;
+		}
+		else
+			continue;
+
+		if (lpRects != NULL && nRects < nMaxRects)
+		{
+			GetTileOrigin(i, lpRects[nRects].nX, lpRects[nRects].nY);
+			lpRects[nRects].nWidth = m_nTileWidth;
+			lpRects[nRects].nHeight = m_nTileHeight;
+		}
+		nRects++;
+	}
+
+	if (lpRects != NULL && nMaxRects > 0 && nRects > nMaxRects)
+	{
+		lpRects[0].nX = 0;
+		lpRects[0].nY = 0;
+		lpRects[0].nWidth = m_nWidth;
+		lpRects[0].nHeight = m_nHeight;
+		return 1;
+	}
+	return nRects;
+}
+
+const BYTE* CVideoCompositor::GetSurface(int& nWidth, int& nHeight)
+{
+	std::lock_guard<std::mutex> lock(m_lockLayout);
+	if (!m_bRunning)
+		return NULL;
+
+	nWidth = m_nWidth;
+	nHeight = m_nHeight;
+	return m_vecSurface.data();
+}
+
+void CVideoCompositor::GetTileOrigin(int nTile, int& nX, int& nY) const
+{
+	nX = (nTile % m_nCols) * m_nTileWidth;
+	nY = (nTile / m_nCols) * m_nTileHeight;
+}
+
+void CVideoCompositor::ClearTile(std::vector<BYTE>& vecBuffer, int nTile)
+{
+	int nX = 0, nY = 0;
+	GetTileOrigin(nTile, nX, nY);
+	BYTE* lpY = vecBuffer.data();
+	BYTE* lpU = lpY + (size_t)m_nWidth * m_nHeight;
+	BYTE* lpV = lpU + (size_t)m_nWidth * m_nHeight / 4;
+	size_t nChromaOffset = (size_t)(nY / 2) * (m_nWidth / 2) + nX / 2;
+	CImageScaler::FillPlane(lpY + (size_t)nY * m_nWidth + nX, m_nWidth, m_nTileWidth, m_nTileHeight, COMPOSITOR_BLACK_Y);
+	CImageScaler::FillPlane(lpU + nChromaOffset, m_nWidth / 2, m_nTileWidth / 2, m_nTileHeight / 2, COMPOSITOR_BLACK_UV);
+	CImageScaler::FillPlane(lpV + nChromaOffset, m_nWidth / 2, m_nTileWidth / 2, m_nTileHeight / 2, COMPOSITOR_BLACK_UV);
+}
+
+void CVideoCompositor::CopyTile(int nTile)
+{
+	int nX = 0, nY = 0;
+	GetTileOrigin(nTile, nX, nY);
+	size_t nLumaOffset = (size_t)nY * m_nWidth + nX;
+	size_t nLumaSize = (size_t)m_nWidth * m_nHeight;
+	size_t nChromaOffset = (size_t)(nY / 2) * (m_nWidth / 2) + nX / 2;
+	const BYTE* lpBack = m_vecBack.data();
+	BYTE* lpSurface = m_vecSurface.data();
+	CImageScaler::CopyPlane(lpBack + nLumaOffset, m_nWidth, lpSurface + nLumaOffset, m_nWidth, m_nTileWidth, m_nTileHeight);
+	CImageScaler::CopyPlane(lpBack + nLumaSize + nChromaOffset, m_nWidth / 2, lpSurface + nLumaSize + nChromaOffset, m_nWidth / 2, m_nTileWidth / 2, m_nTileHeight / 2);
+	CImageScaler::CopyPlane(lpBack + nLumaSize * 5 / 4 + nChromaOffset, m_nWidth / 2, lpSurface + nLumaSize * 5 / 4 + nChromaOffset, m_nWidth / 2, m_nTileWidth / 2, m_nTileHeight / 2);
+}
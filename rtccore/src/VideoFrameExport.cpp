@@ -0,0 +1,248 @@
+#include "VideoFrameExport.h"
+#include "ImageScaler.h"
+#include "Logger.h"
+#include "MediaClock.h"
+#include "Singleton.h"
+#include <new>
+
+static bool IsNameChar(char c)
+{
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '-';
+}
+
+RTC_DEFINE_SINGLETON(CVideoFrameExport)
+
+CVideoFrameExport::CVideoFrameExport()
+	: m_bRunning(false)
+	, m_nMaxWidth(0)
+	, m_nMaxHeight(0)
+	, m_nIntervalUs(0)
+	, m_nSlots(0)
+	, m_nSlotSize(0)
+	, m_nFrames(0)
+	, m_nDropped(0)
+{
+}
+
+bool CVideoFrameExport::Start(const char* lpPrefix, int nMaxWidth, int nMaxHeight, int nIntervalMs, int nSlots)
+{
+	nMaxWidth &= ~1;
+	nMaxHeight &= ~1;
+	if (lpPrefix == NULL || lpPrefix[0] == '\0' || strlen(lpPrefix) >= FRAME_EXPORT_PREFIX_TEXT
+		|| nMaxWidth < 2 || nMaxHeight < 2 || nMaxWidth > FRAME_EXPORT_MAX_WIDTH || nMaxHeight > FRAME_EXPORT_MAX_HEIGHT
+		|| nIntervalMs < 0 || nSlots < FRAME_EXPORT_MIN_SLOTS || nSlots > FRAME_EXPORT_MAX_SLOTS)
+		return false;
+	for (const char* lpChar = lpPrefix; *lpChar != '\0'; lpChar++)
+	{
+		if (!IsNameChar(*lpChar))
+			return false;
+	}
+
+	std::lock_guard<std::mutex> lockControl(m_lockControl);
+	if (m_bRunning)
+		return false;
+
+	std::lock_guard<std::mutex> lock(m_lockRings);
+	m_strPrefix = lpPrefix;
+	m_nMaxWidth = nMaxWidth;
+	m_nMaxHeight = nMaxHeight;
+	m_nIntervalUs = (int64_t)nIntervalMs * 1000;
+	m_nSlots = nSlots;
+	// the planes of the largest frame, slots stay 64 byte aligned
+	size_t nFrameSize = (size_t)nMaxWidth * nMaxHeight * 3 / 2;
+	m_nSlotSize = (sizeof(FRAME_EXPORT_SLOT) + nFrameSize + 63) & ~(size_t)63;
+	m_nFrames = 0;
+	m_nDropped = 0;
+	m_bRunning = true;
+
+	LOG_INFO("frame export %s, %dx%d every %dms, %d slots", lpPrefix, nMaxWidth, nMaxHeight, nIntervalMs, nSlots);
+	return true;
+}
+
+void CVideoFrameExport::Stop()
+{
+	std::lock_guard<std::mutex> lockControl(m_lockControl);
+	if (!m_bRunning)
+		return;
+
+	std::unordered_map<std::string, std::shared_ptr<FRAME_RING>> rings;
+	{
+		std::lock_guard<std::mutex> lock(m_lockRings);
+		m_bRunning = false;
+		rings.swap(m_rings);
+	}
+
+	// a ring a render thread still writes goes away with its last reference
+	for (auto& item : rings)
+	{
+		if (!item.second)
+			continue;
+		std::lock_guard<std::mutex> lockRing(item.second->lock);
+		((FRAME_EXPORT_HEADER*)item.second->memory.GetData())->nClosed = 1;
+	}
+	LOG_INFO("frame export stopped, %zu rings, %lld frames, %lld dropped", rings.size(),
+		(long long)m_nFrames.load(), (long long)m_nDropped.load());
+}
+
+void CVideoFrameExport::PutFrame(const std::string& strId, const BYTE* lpY, int nYStride, const BYTE* lpU, int nUStride,
+	const BYTE* lpV, int nVStride, int nWidth, int nHeight)
+{
+	if (!IsRunning() || lpY == NULL || lpU == NULL || lpV == NULL || nWidth < 2 || nHeight < 2)
+		return;
+
+	std::shared_ptr<FRAME_RING> lpRing;
+	int64_t nIntervalUs = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_lockRings);
+		if (!m_bRunning)
+			return;
+		auto it = m_rings.find(strId);
+		if (it != m_rings.end())
+			lpRing = it->second;
+		else
+			lpRing = CreateRing(strId);
+		nIntervalUs = m_nIntervalUs;
+	}
+	if (!lpRing)
+	{
+		m_nDropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	int64_t nNowUs = CMediaClock::NowUs();
+	std::lock_guard<std::mutex> lockRing(lpRing->lock);
+	if (lpRing->nFrames > 0 && nNowUs < lpRing->nNextSampleUs)
+		return;
+	// on a schedule, sampling the first frame after each interval would lose a frame period every time
+	lpRing->nNextSampleUs += nIntervalUs;
+	if (lpRing->nNextSampleUs <= nNowUs)
+		lpRing->nNextSampleUs = nNowUs + nIntervalUs;
+	WriteFrame(*lpRing, lpY, nYStride, lpU, nUStride, lpV, nVStride, nWidth, nHeight, nNowUs);
+	m_nFrames.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::string CVideoFrameExport::GetNames()
+{
+	std::lock_guard<std::mutex> lock(m_lockRings);
+	std::string strNames;
+	for (auto& item : m_rings)
+	{
+		if (!item.second)
+			continue;
+		strNames += item.second->memory.GetName();
+		strNames += '\n';
+	}
+	return strNames;
+}
+
+/**
+	the first frame of a participant maps its block on the render thread,
+	once per participant and channel. a failed block is remembered as empty
+	so it is not retried every frame
+*/
+std::shared_ptr<CVideoFrameExport::FRAME_RING> CVideoFrameExport::CreateRing(const std::string& strId)
+{
+	std::shared_ptr<FRAME_RING> lpRing;
+	if (m_rings.size() < FRAME_EXPORT_MAX_RINGS)
+	{
+		lpRing = std::make_shared<FRAME_RING>();
+		size_t nSize = sizeof(FRAME_EXPORT_HEADER) + m_nSlotSize * m_nSlots;
+		if (lpRing->memory.Create(MakeName(strId), nSize))
+		{
+			lpRing->nNextSampleUs = 0;
+			lpRing->nFrames = 0;
+			FRAME_EXPORT_HEADER* lpHeader = new (lpRing->memory.GetData()) FRAME_EXPORT_HEADER();
+			lpHeader->nMagic = FRAME_EXPORT_MAGIC;
+			lpHeader->nVersion = FRAME_EXPORT_VERSION;
+			lpHeader->nHeaderSize = sizeof(FRAME_EXPORT_HEADER);
+			lpHeader->nSlotHeaderSize = sizeof(FRAME_EXPORT_SLOT);
+			lpHeader->nSlots = m_nSlots;
+			lpHeader->nSlotSize = (uint32_t)m_nSlotSize;
+			lpHeader->nMaxWidth = m_nMaxWidth;
+			lpHeader->nMaxHeight = m_nMaxHeight;
+			lpHeader->nIntervalMs = (uint32_t)(m_nIntervalUs / 1000);
+			lpHeader->nFrames.store(0, std::memory_order_relaxed);
+			strcpy_s(lpHeader->szId, FRAME_EXPORT_ID_TEXT, strId.substr(0, FRAME_EXPORT_ID_TEXT - 1).c_str());
+			for (int i = 0; i < m_nSlots; i++)
+				new (lpRing->memory.GetData() + sizeof(FRAME_EXPORT_HEADER) + m_nSlotSize * i) FRAME_EXPORT_SLOT();
+			LOG_DEBUG("frame ring %s for %s", lpRing->memory.GetName().c_str(), strId.c_str());
+		}
+		else
+			lpRing.reset();
+	}
+	else
+		LOG_WARN("%d frame rings, %s gets none", FRAME_EXPORT_MAX_RINGS, strId.c_str());
+
+	m_rings[strId] = lpRing;
+	return lpRing;
+}
+
+// <prefix>_<id>, other characters of the id become '_', a taken name gets the number of the ring
+std::string CVideoFrameExport::MakeName(const std::string& strId) const
+{
+	std::string strName = m_strPrefix + "_";
+	for (size_t i = 0; i < strId.size() && i < FRAME_EXPORT_NAME_ID; i++)
+		strName += IsNameChar(strId[i]) ? strId[i] : '_';
+
+	for (auto& item : m_rings)
+	{
+		if (item.second && item.second->memory.GetName() == strName)
+			return strName + "_" + std::to_string(m_rings.size());
+	}
+	return strName;
+}
+
+/**
+	under the lock of the ring, the seqlock of the slot is odd while the
+	planes are written and the frame count moves on once it is even again
+*/
+void CVideoFrameExport::WriteFrame(FRAME_RING& ring, const BYTE* lpY, int nYStride, const BYTE* lpU, int nUStride,
+	const BYTE* lpV, int nVStride, int nWidth, int nHeight, int64_t nNowUs)
+{
+	FRAME_EXPORT_HEADER* lpHeader = (FRAME_EXPORT_HEADER*)ring.memory.GetData();
+	int nMaxWidth = (int)lpHeader->nMaxWidth;
+	int nMaxHeight = (int)lpHeader->nMaxHeight;
+
+	// fit without upscaling, even sizes keep the chroma aligned
+	int nOutWidth = nWidth & ~1;
+	int nOutHeight = nHeight & ~1;
+	if (nOutWidth > nMaxWidth || nOutHeight > nMaxHeight)
+	{
+		if ((int64_t)nWidth * nMaxHeight > (int64_t)nHeight * nMaxWidth)
+		{
+			nOutWidth = nMaxWidth;
+			nOutHeight = (int)((int64_t)nHeight * nMaxWidth / nWidth) & ~1;
+		}
+		else
+		{
+			nOutHeight = nMaxHeight;
+			nOutWidth = (int)((int64_t)nWidth * nMaxHeight / nHeight) & ~1;
+		}
+		nOutWidth = nOutWidth < 2 ? 2 : nOutWidth;
+		nOutHeight = nOutHeight < 2 ? 2 : nOutHeight;
+	}
+
+	uint64_t nFrame = ring.nFrames;
+	BYTE* lpSlotData = ring.memory.GetData() + lpHeader->nHeaderSize + (size_t)lpHeader->nSlotSize * (nFrame % lpHeader->nSlots);
+	FRAME_EXPORT_SLOT* lpSlot = (FRAME_EXPORT_SLOT*)lpSlotData;
+	uint64_t nSeq = lpSlot->nSeq.load(std::memory_order_relaxed);
+	lpSlot->nSeq.store(nSeq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	lpSlot->nFrame = nFrame;
+	lpSlot->nTimestampUs = nNowUs;
+	lpSlot->nWidth = nOutWidth;
+	lpSlot->nHeight = nOutHeight;
+	lpSlot->nSourceWidth = nWidth;
+	lpSlot->nSourceHeight = nHeight;
+	BYTE* lpOutY = lpSlotData + sizeof(FRAME_EXPORT_SLOT);
+	BYTE* lpOutU = lpOutY + (size_t)nOutWidth * nOutHeight;
+	BYTE* lpOutV = lpOutU + (size_t)nOutWidth * nOutHeight / 4;
+	CImageScaler::ScalePlane(lpY, nYStride, nWidth, nHeight, lpOutY, nOutWidth, nOutWidth, nOutHeight);
+	CImageScaler::ScalePlane(lpU, nUStride, (nWidth + 1) / 2, (nHeight + 1) / 2, lpOutU, nOutWidth / 2, nOutWidth / 2, nOutHeight / 2);
+	CImageScaler::ScalePlane(lpV, nVStride, (nWidth + 1) / 2, (nHeight + 1) / 2, lpOutV, nOutWidth / 2, nOutWidth / 2, nOutHeight / 2);
+
+	lpSlot->nSeq.store(nSeq + 2, std::memory_order_release);
+	lpHeader->nFrames.store(nFrame + 1, std::memory_order_release);
+	ring.nFrames = nFrame + 1;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include<deque>
+#include<vector>
+#include<mutex>
+#include<unordered_map>
+#include<unordered_set>
+#include "Platform.h"
+
+// the window or render target handed to addView, a HWND on windows
+#define VHANDLE void*
+
+// a remote stream shown in a view smaller than this gets the low stream of a dual stream sender
+#define VIEW_HIGH_STREAM_MIN_WIDTH	640
+#define VIEW_HIGH_STREAM_MIN_HEIGHT	360
+
+using namespace std;
+/**
+	the views a script added, each one free or busy. a view is handed out
+	from the SDK callbacks while the script adds views, so every call locks.
+	the free views wait in a queue in the order they got free and the sets
+	tell free and busy apart, a view removed from the queue is only dropped
+	when it comes to its front, so no call walks the views
+*/
+class CAGExtInfoManager
+{
+protected:
+	CAGExtInfoManager();
+	~CAGExtInfoManager();
+
+public:
+	void AddView(VHANDLE hWnd);
+	void RemoveView(VHANDLE hView);
+	VHANDLE AllocView();
+	void FreeView(VHANDLE hView);
+	void FreeAllView();
+	VHANDLE GetOneFreeView();
+	VHANDLE GetFirstView();
+	VHANDLE GetViewAt(int i);
+	// the place of the view in the order it was added, -1 for an unknown view
+	int GetViewIndex(VHANDLE hView);
+
+	// the size a script gave the view, it wins over the client rect of a window
+	void SetViewSize(VHANDLE hView, int nWidth, int nHeight);
+	// false when the size is not known
+	bool GetViewSize(VHANDLE hView, int& nWidth, int& nHeight);
+	// a view of unknown size counts as large
+	bool IsSmallView(VHANDLE hView);
+
+public:
+	static CAGExtInfoManager *GetAGExtInfoManager();
+	void CloseAGExtInfoManager();
+
+private:
+	static  CAGExtInfoManager	*m_lpExtInfoManager;
+
+private:
+	// under m_lockView, the free view at the front of the queue or NULL
+	VHANDLE PopFreeView();
+
+	std::mutex			m_lockView;
+	deque<VHANDLE>		m_wndFreeQueue;
+	unordered_set<VHANDLE>	m_wndFreeView;
+	unordered_set<VHANDLE>	m_wndBusyView;
+	vector<VHANDLE>      m_wnds;
+	unordered_map<VHANDLE, int>	m_mapViewIndex;
+
+	// set from the script thread, read from the SDK callbacks
+	std::mutex			m_lockSize;
+	std::unordered_map<VHANDLE, std::pair<int, int>> m_mapViewSize;
+};
+
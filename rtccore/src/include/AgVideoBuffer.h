@@ -1,5 +1,6 @@
 #pragma once
-#include "types.h"
+#include "Platform.h"
+#include "LatencyStats.h"
 #define VIDEO_BUF_SIZE 4*4*1920*1080//
 class CAgVideoBuffer
 {
@@ -9,12 +10,18 @@ public:
 
 
     bool writeBuffer(BYTE* buffer, int w, int h);
+    // the h*3/2 rows of w bytes of the I420 frame start nStride bytes apart
+    bool writeBuffer(const BYTE* buffer, int w, int h, int nStride);
     bool readBuffer(BYTE* buffer, int& ts, int &w, int &h);
+    // stamp gets the push and publish time of the frame and the time it was read
+    bool readBuffer(BYTE* buffer, LATENCY_STAMP& stamp, int &w, int &h);
 
     static CAgVideoBuffer* GetInstance();
 private:
     static BYTE videoBuffer[VIDEO_BUF_SIZE];
     int                 timestamp;
+    int64_t             m_nPushNs;
+    int64_t             m_nPublishNs;
     int                 m_w;
     int                 m_h;
 };
@@ -0,0 +1,115 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <thread>
+
+// participants and mixes recorded at once, the audio of further ones is dropped
+#define AUDIO_RECORD_MAX_TRACKS		32
+// power of two, 2.7s of 48kHz stereo. only the pages a track touches are committed
+#define AUDIO_RECORD_RING_BYTES		(512 * 1024)
+#define AUDIO_RECORD_FLUSH_MS		250
+// bytes of szId including the terminating 0
+#define AUDIO_RECORD_ID_TEXT		128
+#define AUDIO_RECORD_WAV_HEADER		44
+
+/**
+	records the remote audio for call quality investigations, one wav file
+	per track: a remote participant before mixing, or a mix the SDK hands
+	out. the audio callback only copies its frame into the preallocated ring
+	of its track and returns, a writer thread drains every ring each
+	AUDIO_RECORD_FLUSH_MS into <dir>/<track>.wav with one large sequential
+	write per ring (two when it wraps), so twenty participants add no file
+	I/O to the SDK thread.
+	the first frame of a track claims one of AUDIO_RECORD_MAX_TRACKS slots
+	with a CAS and fixes its format, frames of another format or that
+	find the ring full are dropped and counted.
+	a track is written by one SDK thread at a time, as the audio callbacks
+	of both SDKs are. the wav header carries the maximum size until Stop
+	puts the real one, a recording killed mid-run still reads to its end.
+*/
+class CAudioRecorder
+{
+public:
+	static CAudioRecorder* GetInstance();
+
+	// checked by the callbacks before they look up their track
+	static bool IsRecording() { return m_bRecording.load(std::memory_order_relaxed); }
+
+	/**
+		start recording into a directory
+	Parameters:
+	@param lpDir	existing directory, files of the same tracks in it are overwritten
+	@return 0, or -1 when recording or lpDir is not a directory
+	*/
+	int Start(const char* lpDir);
+	// drains the rings, fixes the wav headers and closes the files. bytes of PCM written, -1 when not recording
+	int64_t Stop();
+
+	/**
+		from an SDK audio thread, 16 bit interleaved PCM
+	Parameters:
+	@param lpId	names the track and its file, characters other than letters, digits, '_' and '-' become '_'
+	@param nSamples	samples per channel
+	*/
+	void PutFrame(const char* lpId, const void* lpPcm, int nSamples, int nChannels, int nSampleRate);
+
+	// frames lost since Start: ring full, another format, no track left, or a ring that lost its position
+	int64_t GetDroppedCount() const { return m_nDropped.load(std::memory_order_relaxed); }
+
+private:
+	CAudioRecorder();
+
+	enum TRACK_STATE
+	{
+		TRACK_FREE = 0,
+		TRACK_CLAIMED,		// the producer fills in id and format
+		TRACK_READY,
+	};
+
+	struct AUDIO_TRACK
+	{
+		std::atomic<int> nState;
+		char szId[AUDIO_RECORD_ID_TEXT];
+		int nSampleRate;
+		int nChannels;
+		std::unique_ptr<uint8_t[]> lpRing;
+		// the producer moves nWritePos, the writer nReadPos, both only grow
+		std::atomic<uint64_t> nWritePos;
+		std::atomic<uint64_t> nReadPos;
+
+		// only touched by the writer
+		FILE* lpFile;
+		std::string strPath;
+		bool bFailed;				// the file could not be created, the audio is dropped
+		uint64_t nDataBytes;
+	};
+
+	// the track of lpId, claimed on its first frame. NULL when every slot is taken
+	AUDIO_TRACK* FindTrack(const char* lpId, int nChannels, int nSampleRate);
+	void ThreadProc();
+	// every ready track into its file
+	void Flush();
+	bool OpenFile(AUDIO_TRACK& track);
+	void CloseFile(AUDIO_TRACK& track);
+
+	static std::atomic<bool> m_bRecording;
+
+	// claimed in order, the free ones follow the last claimed
+	AUDIO_TRACK m_tracks[AUDIO_RECORD_MAX_TRACKS];
+	std::atomic<int64_t> m_nDropped;
+
+	// only touched by Start/Stop and the writer thread
+	std::string m_strDir;
+	int64_t m_nWritten;
+
+	std::mutex m_lockControl;
+	std::mutex m_lockWriter;
+	std::condition_variable m_condWriter;
+	bool m_bStop;
+	std::thread m_thread;
+};
@@ -0,0 +1,102 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+#define AUDIO_SINK_FRAME_MS			10
+#define AUDIO_SINK_MAX_CHANNELS		2
+// a frame whose peak stays below this is silent, about -60 dBFS
+#define AUDIO_SINK_SILENCE_PEAK		32
+// digital silence at most this long between two frames with sound is an underrun, longer is a pause
+#define AUDIO_SINK_GLITCH_FRAMES	5
+// frames one wakeup pulls at most to catch up, the ones further behind are lost
+#define AUDIO_SINK_MAX_CATCHUP		10
+// levels are published once per window
+#define AUDIO_SINK_LEVEL_FRAMES		100
+#define AUDIO_SINK_FLOOR_DBFS		-96
+
+enum AUDIO_SINK_MODE
+{
+	AUDIO_SINK_DISCARD = 0,		// only pull, the audio is thrown away
+	AUDIO_SINK_MEASURE,			// level, silence and glitches of every frame
+};
+
+// the order of AUDIO_SINK_STATS in rtc.py
+enum AUDIO_SINK_STAT
+{
+	AUDIO_SINK_STAT_FRAMES = 0,		// frames pulled
+	AUDIO_SINK_STAT_FAILED,			// pulls the SDK refused after its first frame
+	AUDIO_SINK_STAT_LATE,			// wakeups a frame or more behind the clock
+	AUDIO_SINK_STAT_LOST,			// frames not pulled, the puller was more than AUDIO_SINK_MAX_CATCHUP behind
+	AUDIO_SINK_STAT_SILENT,			// measured frames below AUDIO_SINK_SILENCE_PEAK
+	AUDIO_SINK_STAT_GLITCHES,		// runs of digital silence of at most AUDIO_SINK_GLITCH_FRAMES between sound
+	AUDIO_SINK_STAT_LEVEL,			// rms of the last window, dBFS * 100
+	AUDIO_SINK_STAT_PEAK,			// peak of the last window, dBFS * 100
+	AUDIO_SINK_STAT_COUNT
+};
+
+/**
+	plays the part of the sound card for a robot: the remote audio goes to
+	the external sink of the SDK instead of a device, and a thread of ours
+	pulls a 10ms frame from it on the steady clock the way a device would,
+	so the downlink and the decoder run without device I/O. a wakeup that is
+	late pulls the frames it missed, like a device draining its buffer.
+	the frames are thrown away, or measured without allocating: rms and
+	peak per window, silent frames, and glitches, which are short runs of
+	exact zeros between frames with sound, the mark of an SDK that had
+	nothing decoded in time.
+*/
+class CAudioSink
+{
+public:
+	// false when the SDK has no frame, lpPcm holds nSamples interleaved 16 bit samples per channel
+	typedef std::function<bool(int16_t* lpPcm, int nSamples)> PULL_FUNC;
+
+	static CAudioSink* GetInstance();
+
+	/**
+		start the puller, a running one is stopped first
+	Parameters:
+	@param nSampleRate	of the pulled PCM, a multiple of 100
+	@param nMode	AUDIO_SINK_MODE
+	@param pull	called on the puller thread every AUDIO_SINK_FRAME_MS
+	@return false when the format is out of range
+	*/
+	bool Start(int nSampleRate, int nChannels, int nMode, PULL_FUNC pull);
+	void Stop();
+	bool IsRunning() const { return m_bRunning.load(std::memory_order_relaxed); }
+
+	// AUDIO_SINK_STAT, counters start at 0 with every Start
+	int64_t GetStat(int nStat) const { return m_nStats[nStat].load(std::memory_order_relaxed); }
+
+private:
+	CAudioSink();
+
+	void ThreadProc();
+	void Pull();
+	void Measure(const int16_t* lpPcm, int nCount);
+	void Add(int nStat, int64_t nValue = 1) { m_nStats[nStat].fetch_add(nValue, std::memory_order_relaxed); }
+
+	std::mutex m_lockControl;
+	std::atomic<bool> m_bRunning;
+	std::thread m_thread;
+
+	// only touched by the puller thread while it runs
+	PULL_FUNC m_pull;
+	int m_nSampleRate;
+	int m_nChannels;
+	int m_nMode;
+	std::vector<int16_t> m_vecFrame;
+	bool m_bPulled;				// the SDK handed out a frame, failures count from then on
+	bool m_bSound;				// the last frame that was not digital silence had sound
+	int m_nZeroFrames;			// digital silence since the last frame with sound
+	int m_nWindowFrames;
+	double m_dWindowSquares;
+	int64_t m_nWindowSamples;
+	int m_nWindowPeak;
+
+	std::atomic<int64_t> m_nStats[AUDIO_SINK_STAT_COUNT];
+};
@@ -0,0 +1,82 @@
+#pragma once
+#include "HdrHistogram.h"
+#include <atomic>
+#include <chrono>
+#include <ostream>
+#include <string>
+
+// the *.elapsed metrics are what the SDK reports, or the wrapper side ms since
+// the join call when the SDK has none, so both wrappers line up in one report
+enum CHURN_METRIC
+{
+	CHURN_JOIN_CALL = 0,		// us spent inside the join call
+	CHURN_JOIN_READY,			// us from the join call to the waiter seeing the join
+	CHURN_JOIN_ELAPSED,			// ms from the join call to the joined callback
+	CHURN_USER_JOINED_ELAPSED,	// ms from the join call to a remote user or stream
+	CHURN_FIRST_VIDEO_ELAPSED,	// ms from the join call to the first remote video frame
+	CHURN_USER_JOINED_HANDLER,	// us spent inside our remote user joined callback
+	CHURN_FIRST_VIDEO_HANDLER,	// us spent inside our first remote video callback
+	CHURN_USER_OFFLINE_HANDLER,	// us spent inside our remote user left callback
+	CHURN_LEAVE_CALL,			// us spent inside the leave call
+	CHURN_LEAVE_READY,			// us from the leave call to the left callback
+	CHURN_METRIC_COUNT
+};
+
+/**
+	the join/leave calls of one SDK, CChurnBench::Run drives them from the
+	calling thread
+*/
+class IChurnTarget
+{
+public:
+	virtual ~IChurnTarget() {}
+
+	// "agora" or "zego", heads the report
+	virtual const char* GetName() = 0;
+	virtual void Join() = 0;
+	// returns false when the join did not complete within nTimeoutMs
+	virtual bool WaitJoin(int nTimeoutMs) = 0;
+	virtual void Leave() = 0;
+	// returns 1 once left, 0 when the SDK has no left callback to wait for, -1 on timeout
+	virtual int WaitLeave(int nTimeoutMs) = 0;
+};
+
+/**
+	join/leave churn benchmark, cycles the join and leave of an IChurnTarget
+	and keeps HDR histograms of the SDK reported elapsed and the wrapper side
+	wall time. the event handlers of both wrappers record into the one instance
+*/
+class CChurnBench
+{
+public:
+	static CChurnBench* GetInstance();
+
+	bool IsRunning() { return m_bRunning; }
+	void Record(CHURN_METRIC metric, int64_t value);
+
+	int Run(IChurnTarget* lpTarget, int nCycles, int nHoldMs, int nTimeoutMs);
+	void Report(std::ostream& os);
+	bool Dump(const char* lpPath);
+
+	// records the time spent in a callback while the benchmark is running
+	class CScopedTimer
+	{
+	public:
+		CScopedTimer(CHURN_METRIC metric);
+		~CScopedTimer();
+	private:
+		CHURN_METRIC m_metric;
+		std::chrono::steady_clock::time_point m_start;
+	};
+
+protected:
+	CChurnBench();
+	~CChurnBench();
+
+private:
+	std::atomic<bool>	m_bRunning;
+	std::string			m_strName;
+	int					m_nCycles;
+	int					m_nFailed;
+	CHdrHistogram*		m_lpHistograms[CHURN_METRIC_COUNT];
+};
@@ -1,10 +1,13 @@
 #pragma once
-#include "types.h"
-#include <queue>
+#include "Platform.h"
+#include "LatencyStats.h"
+#include <deque>
 #include <mutex>
 #include <condition_variable>
+#include <chrono>
 
-#define CIC_WAITTIMEOUT		0
+#define CIC_WAITTIMEOUT		0	// read/write block until there is data/space
+#define CIC_NOWAIT			-1	// read/write fail at once, the pipeline simulator drives the waits itself
 #define AUDIO_CALLBACK_TIMES  100
 #define MAX_AUDIO_SAMPLE_SIZE (48000*2*2/AUDIO_CALLBACK_TIMES)*10//sampleRate*sizeof(16bit)*channel+ AUDIO_CALLBACK_TIMES*sizeof(timestamp)=max_s
 
@@ -23,6 +26,26 @@ public:
 		m_cursor %= m_maxcount;
 		return cursor;
 	}
+	/**
+		acquire with a bound, timeoutMs > 0 waits that long, CIC_WAITTIMEOUT
+		waits forever and CIC_NOWAIT does not wait at all
+	Parameters:
+		@param cursor	the cursor acquire() would have returned
+		@return false when count was not available in time
+	*/
+	bool tryAcquire(int count, int timeoutMs, unsigned int& cursor) {
+		std::unique_lock<std::mutex> locker(m_mutex);
+		auto ready = [this, count] {return m_count >= count; };
+		if (timeoutMs == CIC_WAITTIMEOUT)
+			m_condition.wait(locker, ready);
+		else if (timeoutMs < 0 ? !ready() : !m_condition.wait_for(locker, std::chrono::milliseconds(timeoutMs), ready))
+			return false;
+		m_count -= count;
+		cursor = m_cursor;
+		m_cursor += count;
+		m_cursor %= m_maxcount;
+		return true;
+	}
 	void release(int count=1) {
 		{
 			std::lock_guard<std::mutex> locker(m_mutex);
@@ -47,6 +70,14 @@ private:
 	std::condition_variable m_condition;
 };
 
+// the stamps of one writeBuffer, nEnd counts every byte ever written up to its last byte
+struct AUDIO_WRITE_STAMP
+{
+	uint64_t nEnd;
+	int64_t nPushNs;
+	int64_t nPublishNs;
+};
+
 class CircleBuffer
 {
 private:
@@ -61,7 +92,10 @@ private:
 	int wait_timeout;
 	int m_nSampleRate = 44100;
 	int m_nChannels = 2;
-    std::queue<int> audioTimeQueue;
+	// under m_mutex, one pusher writes in the order of the byte cursor
+	std::deque<AUDIO_WRITE_STAMP> m_stamps;
+	uint64_t m_nWritten = 0;
+	uint64_t m_nRead = 0;
 public:
     CircleBuffer(const unsigned int iBufferSize,int waittimeout);
 	~CircleBuffer(void);
@@ -69,8 +103,11 @@ public:
 	void SetComplete();
 	unsigned int getFreeSize();
 	unsigned int getUsedSize();
-	void writeBuffer(const void* pSourceBuffer, const unsigned int iNumBytes);
+	bool writeBuffer(const void* pSourceBuffer, const unsigned int iNumBytes);
 	bool readBuffer(void* pDestBuffer, const unsigned int iBytesToRead, unsigned int* pbBytesRead, int& audioTime);
+	// stamp gets the push and publish time of the write the first byte read came from
+	bool readBuffer(void* pDestBuffer, const unsigned int iBytesToRead, unsigned int* pbBytesRead, LATENCY_STAMP& stamp);
+	void setWaitTimeout(int waittimeout) { wait_timeout = waittimeout; }
 	void setAudioInfo(int nSampleRate, int nChannels) 
 	{ 
 		m_nSampleRate = nSampleRate;
@@ -0,0 +1,84 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+
+/**
+	bounded MPSC ring of POD records for the SDK callback threads. a producer
+	claims its slot with one compare-exchange and never waits: when the ring
+	is full the record is dropped and counted. one consumer at a time pops,
+	callers with several reader threads serialize them on their own lock.
+	nCapacity must be a power of two, the slots live inside the object so a
+	ring allocated up front never allocates again
+*/
+template <typename T, uint64_t nCapacity>
+class CDropRing
+{
+	static_assert((nCapacity & (nCapacity - 1)) == 0, "capacity must be a power of two");
+
+public:
+	CDropRing()
+		: m_nEnqueuePos(0)
+		, m_nDropped(0)
+		, m_nDequeuePos(0)
+	{
+		for (uint64_t i = 0; i < nCapacity; i++)
+			m_slots[i].nSequence.store(i, std::memory_order_relaxed);
+	}
+
+	// false when the ring is full and the record was dropped
+	bool Push(const T& record)
+	{
+		uint64_t nPos = m_nEnqueuePos.load(std::memory_order_relaxed);
+		RING_SLOT* lpSlot;
+		for (;;)
+		{
+			lpSlot = &m_slots[nPos & (nCapacity - 1)];
+			int64_t nDiff = (int64_t)lpSlot->nSequence.load(std::memory_order_acquire) - (int64_t)nPos;
+			if (nDiff == 0)
+			{
+				if (m_nEnqueuePos.compare_exchange_weak(nPos, nPos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (nDiff < 0)
+			{
+				m_nDropped.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			else
+			{
+				nPos = m_nEnqueuePos.load(std::memory_order_relaxed);
+			}
+		}
+
+		lpSlot->record = record;
+		lpSlot->nSequence.store(nPos + 1, std::memory_order_release);
+		return true;
+	}
+
+	// single consumer, false when nothing is pending
+	bool Pop(T& record)
+	{
+		RING_SLOT& slot = m_slots[m_nDequeuePos & (nCapacity - 1)];
+		if (slot.nSequence.load(std::memory_order_acquire) != m_nDequeuePos + 1)
+			return false;
+
+		record = slot.record;
+		slot.nSequence.store(m_nDequeuePos + nCapacity, std::memory_order_release);
+		m_nDequeuePos++;
+		return true;
+	}
+
+	uint64_t GetDropped() { return m_nDropped.load(std::memory_order_relaxed); }
+
+private:
+	struct RING_SLOT
+	{
+		std::atomic<uint64_t> nSequence;	// pos when free, pos + 1 once written
+		T record;
+	};
+
+	RING_SLOT m_slots[nCapacity];
+	std::atomic<uint64_t> m_nEnqueuePos;
+	std::atomic<uint64_t> m_nDropped;
+	uint64_t m_nDequeuePos;
+};
@@ -0,0 +1,380 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+
+// power of two, a post waits for a free slot only with this many commands behind
+#define ENGINE_COMMAND_CAPACITY		1024
+#define ENGINE_COMMAND_MASK			(ENGINE_COMMAND_CAPACITY - 1)
+
+// the same numbers as AGORA_CONFIG_RESULT and ZEGO_CONFIG_RESULT
+enum ENGINE_RESULT
+{
+	ENGINE_PENDING = 1,				// still queued or running
+	ENGINE_OK = 0,
+	ENGINE_ERR_TYPE = -2,			// the vendor has no such command
+	ENGINE_ERR_INVALID_ARG = -3,	// refused before posting
+	ENGINE_ERR_SKIPPED = -5,		// not run, an earlier command of the batch failed
+	ENGINE_ERR_TIMEOUT = -6,		// Wait gave up, the command stays queued
+	ENGINE_ERR_EXPIRED = -7,		// the command ran, its result was overwritten by later ones
+};
+
+// the commands every vendor has, its own types follow ENGINE_COMMAND_VENDOR
+enum ENGINE_COMMAND_BASE_TYPE
+{
+	ENGINE_COMMAND_CONFIG = 0,		// item, copied in at post time
+	ENGINE_COMMAND_CONFIG_BATCH,	// lpItems/nCount of a caller blocked in Run
+	ENGINE_COMMAND_LEAVE_CHANNEL,
+	ENGINE_COMMAND_VENDOR,
+};
+
+template <typename TItem>
+struct ENGINE_COMMAND_T
+{
+	int nType;
+	uint64_t nBatchLast;	// ticket of the last command posted together with this one
+	TItem item;
+	TItem* lpItems;
+	int nCount;
+	char* lpText;			// copied by PostCommand, freed by the executor
+	int nArgs[2];			// the numbers of a command that takes them
+};
+
+/**
+	single threaded engine executor. every config export posts its command
+	here and the engine thread runs them one by one in the order they were
+	posted, so the python threads never sit in a slow SDK call.
+	the queue is a bounded lock-free MPSC ring: a post reserves its slots with
+	one fetch_add, the reserved position is the ticket, and the executor
+	marks tickets done in order. a ticket can be polled or waited on.
+	the vendor CCommandQueue runs the commands in Execute and names the ones
+	that take a string in TakesText. TItem is its POD config item
+*/
+template <typename TItem>
+class CEngineQueue
+{
+public:
+	typedef ENGINE_COMMAND_T<TItem> ENGINE_COMMAND;
+
+	/**
+		post config items the caller has validated
+	Parameters:
+	@param lpItems	items to copy into the queue
+	@param nCount	number of items
+	@return ticket of the last item, or ENGINE_ERR_INVALID_ARG
+	*/
+	int64_t PostItems(const TItem* lpItems, int nCount)
+	{
+		if (nCount <= 0 || lpItems == nullptr)
+			return ENGINE_ERR_INVALID_ARG;
+
+		uint64_t nFirst = Reserve(nCount);
+		uint64_t nLast = nFirst + nCount;
+		for (int i = 0; i < nCount; i++)
+		{
+			ENGINE_COMMAND& command = Acquire(nFirst + i);
+			command.nType = ENGINE_COMMAND_CONFIG;
+			command.nBatchLast = nLast;
+			command.item = lpItems[i];
+			Publish(nFirst + i);
+		}
+		WakeExecutor();
+		return (int64_t)nLast;
+	}
+
+	int64_t PostLeaveChannel()
+	{
+		return PostCommand(ENGINE_COMMAND_LEAVE_CHANNEL);
+	}
+
+	/**
+		post a command that is not a config item
+	Parameters:
+	@param nType	ENGINE_COMMAND_LEAVE_CHANNEL or a vendor type, Execute refuses the unknown ones
+	@param lpText	copied for the commands that take a string
+	@param nArg0, nArg1	the numbers of the commands that take them
+	@return ticket, or ENGINE_ERR_INVALID_ARG when lpText is missing
+	*/
+	int64_t PostCommand(int nType, const char* lpText = nullptr, int nArg0 = 0, int nArg1 = 0)
+	{
+		bool bText = TakesText(nType);
+		if (nType < ENGINE_COMMAND_LEAVE_CHANNEL || (bText && lpText == nullptr))
+			return ENGINE_ERR_INVALID_ARG;
+
+		char* lpCopy = nullptr;
+		if (bText && lpText != nullptr)
+		{
+			size_t nSize = strlen(lpText) + 1;
+			lpCopy = (char*)malloc(nSize);
+			memcpy(lpCopy, lpText, nSize);
+		}
+		uint64_t nPos = Reserve(1);
+		ENGINE_COMMAND& command = Acquire(nPos);
+		command.nType = nType;
+		command.nBatchLast = nPos + 1;
+		command.lpText = lpCopy;
+		command.nArgs[0] = nArg0;
+		command.nArgs[1] = nArg1;
+		Publish(nPos);
+		WakeExecutor();
+		return (int64_t)(nPos + 1);
+	}
+
+	/**
+		run a batch on the engine thread and wait for it. lpItems stays owned by
+		the caller, which is blocked here until the executor is done with it
+	*/
+	int Run(TItem* lpItems, int nCount)
+	{
+		if (nCount < 0 || (nCount > 0 && lpItems == nullptr))
+			return ENGINE_ERR_INVALID_ARG;
+
+		uint64_t nPos = Reserve(1);
+		ENGINE_COMMAND& command = Acquire(nPos);
+		command.nType = ENGINE_COMMAND_CONFIG_BATCH;
+		command.nBatchLast = nPos + 1;
+		command.lpItems = lpItems;
+		command.nCount = nCount;
+		Publish(nPos);
+		WakeExecutor();
+		return Wait((int64_t)(nPos + 1), -1);
+	}
+
+	int RunLeaveChannel()
+	{
+		return Wait(PostLeaveChannel(), -1);
+	}
+
+	// PostCommand and wait for it, a refused post returns its error
+	int RunCommand(int nType, const char* lpText = nullptr, int nArg0 = 0, int nArg1 = 0)
+	{
+		return Wait(PostCommand(nType, lpText, nArg0, nArg1), -1);
+	}
+
+	/**
+		state of a ticket
+	@return ENGINE_PENDING while it is queued or running, else its result.
+		a batch ticket reports the first failure of the batch
+	*/
+	int Poll(int64_t nTicket)
+	{
+		if (nTicket <= 0 || (uint64_t)nTicket > m_nEnqueuePos.load(std::memory_order_acquire))
+			return ENGINE_ERR_INVALID_ARG;
+
+		if ((uint64_t)nTicket > m_nCompleted.load(std::memory_order_acquire))
+			return ENGINE_PENDING;
+
+		uint64_t nValue = m_results[nTicket & ENGINE_COMMAND_MASK].load(std::memory_order_acquire);
+		if ((nValue >> 8) != (uint64_t)nTicket)
+			return ENGINE_ERR_EXPIRED;
+		return (int8_t)(nValue & 0xff);
+	}
+
+	/**
+		wait for a ticket
+	Parameters:
+	@param nTicket	ticket returned by a post
+	@param nTimeoutMs	maximum time to wait, <0 waits forever
+	@return as Poll, ENGINE_ERR_TIMEOUT when the ticket is still pending
+	*/
+	int Wait(int64_t nTicket, int nTimeoutMs)
+	{
+		int nResult = Poll(nTicket);
+		if (nResult != ENGINE_PENDING)
+			return nResult;
+
+		std::unique_lock<std::mutex> lock(m_lockDone);
+		auto done = [this, nTicket] { return m_nCompleted.load(std::memory_order_acquire) >= (uint64_t)nTicket; };
+		if (nTimeoutMs < 0)
+			m_condDone.wait(lock, done);
+		else if (!m_condDone.wait_for(lock, std::chrono::milliseconds(nTimeoutMs), done))
+			return ENGINE_ERR_TIMEOUT;
+		lock.unlock();
+
+		return Poll(nTicket);
+	}
+
+	/**
+		run what is queued and stop the engine thread, the next post starts it again.
+		nothing may be posted while it stops
+	*/
+	void Stop()
+	{
+		std::lock_guard<std::mutex> lockThread(m_lockThread);
+		if (!m_bRunning.load(std::memory_order_acquire))
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(m_lockExecutor);
+			m_bStop = true;
+			m_bSleeping = false;
+		}
+		m_condExecutor.notify_one();
+		m_thread.join();
+
+		m_bStop = false;
+		m_bRunning.store(false, std::memory_order_release);
+	}
+
+protected:
+	CEngineQueue()
+		: m_nEnqueuePos(0)
+		, m_nCompleted(0)
+		, m_nDequeuePos(0)
+		, m_nSkipUntil(0)
+		, m_nSkipResult(ENGINE_OK)
+		, m_bSleeping(false)
+		, m_bRunning(false)
+		, m_bStop(false)
+	{
+		for (uint64_t i = 0; i < ENGINE_COMMAND_CAPACITY; i++)
+		{
+			m_slots[i].nSequence.store(i, std::memory_order_relaxed);
+			m_results[i].store(0, std::memory_order_relaxed);
+		}
+	}
+
+	// the owner must Stop before the queue goes away
+	virtual ~CEngineQueue() {}
+
+	// runs on the engine thread, returns ENGINE_OK or a negative vendor result
+	virtual int Execute(ENGINE_COMMAND& command) = 0;
+	// true for the vendor types whose lpText must not be null
+	virtual bool TakesText(int nType) = 0;
+
+private:
+	// reserves nCount consecutive positions, they are this post's tickets - 1
+	uint64_t Reserve(int nCount)
+	{
+		StartThread();
+		return m_nEnqueuePos.fetch_add(nCount, std::memory_order_acq_rel);
+	}
+
+	// the slot of nPos once the executor has freed it, only waits when the ring is full
+	ENGINE_COMMAND& Acquire(uint64_t nPos)
+	{
+		COMMAND_SLOT& slot = m_slots[nPos & ENGINE_COMMAND_MASK];
+		while (slot.nSequence.load(std::memory_order_acquire) != nPos)
+			std::this_thread::yield();
+
+		memset(&slot.command, 0, sizeof(slot.command));
+		return slot.command;
+	}
+
+	void Publish(uint64_t nPos)
+	{
+		m_slots[nPos & ENGINE_COMMAND_MASK].nSequence.store(nPos + 1, std::memory_order_seq_cst);
+	}
+
+	void StartThread()
+	{
+		if (m_bRunning.load(std::memory_order_acquire))
+			return;
+
+		std::lock_guard<std::mutex> lockThread(m_lockThread);
+		if (m_bRunning.load(std::memory_order_relaxed))
+			return;
+
+		m_thread = std::thread(&CEngineQueue::ThreadProc, this);
+		m_bRunning.store(true, std::memory_order_release);
+	}
+
+	// producers only take the lock when the executor went to sleep
+	void WakeExecutor()
+	{
+		if (m_bSleeping.exchange(false, std::memory_order_seq_cst))
+		{
+			std::lock_guard<std::mutex> lock(m_lockExecutor);
+			m_condExecutor.notify_one();
+		}
+	}
+
+	bool IsReady(uint64_t nPos)
+	{
+		return m_slots[nPos & ENGINE_COMMAND_MASK].nSequence.load(std::memory_order_seq_cst) == nPos + 1;
+	}
+
+	void ThreadProc()
+	{
+		for (;;)
+		{
+			if (!IsReady(m_nDequeuePos))
+			{
+				std::unique_lock<std::mutex> lock(m_lockExecutor);
+				m_bSleeping.store(true, std::memory_order_seq_cst);
+				if (!IsReady(m_nDequeuePos))
+				{
+					if (m_bStop)
+						break;
+					m_condExecutor.wait(lock, [this] { return !m_bSleeping.load() || m_bStop; });
+				}
+				m_bSleeping.store(false);
+				continue;
+			}
+
+			COMMAND_SLOT& slot = m_slots[m_nDequeuePos & ENGINE_COMMAND_MASK];
+			ENGINE_COMMAND command = slot.command;
+			slot.nSequence.store(m_nDequeuePos + ENGINE_COMMAND_CAPACITY, std::memory_order_release);
+			uint64_t nTicket = ++m_nDequeuePos;
+
+			int nResult = ENGINE_ERR_SKIPPED;
+			if (nTicket > m_nSkipUntil)
+			{
+				nResult = Execute(command);
+				if (nResult != ENGINE_OK && command.nBatchLast > nTicket)
+				{
+					m_nSkipUntil = command.nBatchLast;
+					m_nSkipResult = nResult;
+				}
+			}
+			else if (nTicket == m_nSkipUntil)
+			{
+				nResult = m_nSkipResult;
+			}
+			free(command.lpText);
+
+			m_results[nTicket & ENGINE_COMMAND_MASK].store((nTicket << 8) | (uint8_t)nResult, std::memory_order_release);
+			m_nCompleted.store(nTicket, std::memory_order_release);
+			{
+				std::lock_guard<std::mutex> lock(m_lockDone);
+			}
+			m_condDone.notify_all();
+		}
+		m_bSleeping.store(false);
+	}
+
+	struct COMMAND_SLOT
+	{
+		std::atomic<uint64_t> nSequence;	// pos + 1 once posted, pos + capacity once executed
+		ENGINE_COMMAND command;
+	};
+
+	COMMAND_SLOT m_slots[ENGINE_COMMAND_CAPACITY];
+	// ticket << 8 | (uint8_t)result, one word so a reader never sees a torn pair
+	std::atomic<uint64_t> m_results[ENGINE_COMMAND_CAPACITY];
+
+	std::atomic<uint64_t> m_nEnqueuePos;
+	std::atomic<uint64_t> m_nCompleted;
+	uint64_t m_nDequeuePos;
+
+	// a failed command skips the rest of its batch
+	uint64_t m_nSkipUntil;
+	int m_nSkipResult;
+
+	std::atomic<bool> m_bSleeping;
+	std::atomic<bool> m_bRunning;
+	bool m_bStop;
+	std::mutex m_lockExecutor;
+	std::condition_variable m_condExecutor;
+
+	std::mutex m_lockDone;
+	std::condition_variable m_condDone;
+
+	std::mutex m_lockThread;
+	std::thread m_thread;
+};
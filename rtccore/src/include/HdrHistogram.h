@@ -0,0 +1,54 @@
+#pragma once
+#include <atomic>
+#include <ostream>
+#include <stdint.h>
+
+/**
+	log-linear histogram using the HdrHistogram bucket layout.
+	values keep nSignificantDigits of precision from 1 up to nHighestTrackable,
+	larger values are clamped. record() is lock free and may be called from
+	any SDK callback thread while the histogram is being read.
+*/
+class CHdrHistogram
+{
+public:
+	CHdrHistogram(int64_t nHighestTrackable, int nSignificantDigits = 3);
+	~CHdrHistogram();
+
+	void record(int64_t value);
+	void reset();
+	void add(const CHdrHistogram& other);
+
+	int64_t getTotalCount() const;
+	int64_t getMin() const;
+	int64_t getMax() const;
+	double getMean() const;
+	int64_t getValueAtPercentile(double percentile) const;
+
+	// one "value count" line per non empty bucket, values are the bucket upper bound
+	void dump(std::ostream& os) const;
+	void printPercentiles(std::ostream& os, const char* lpName, const char* lpUnit) const;
+
+private:
+	CHdrHistogram(const CHdrHistogram&) = delete;
+	CHdrHistogram& operator=(const CHdrHistogram&) = delete;
+
+	int bucketIndexOf(int64_t value) const;
+	int countsIndexOf(int64_t value) const;
+	int64_t valueFromIndex(int index) const;
+	int64_t highestEquivalentValue(int64_t value) const;
+
+private:
+	int64_t		m_nHighestTrackable;
+	int			m_nSubBucketHalfCountMagnitude;
+	int			m_nSubBucketHalfCount;
+	int64_t		m_nSubBucketMask;
+	int			m_nSubBucketCount;
+	int			m_nCountsLen;
+
+	std::atomic<int64_t>*	m_pCounts;
+	std::atomic<int64_t>	m_nTotalCount;
+	std::atomic<int64_t>	m_nSum;
+	std::atomic<int64_t>	m_nMin;
+	std::atomic<int64_t>	m_nMax;
+};
@@ -0,0 +1,37 @@
+#pragma once
+#include "Platform.h"
+
+/**
+	scaling of 8 bit planes for the video that is composited or sampled.
+	a plane is halved with a 2x2 box filter as long as it stays at least
+	twice the target, so a big downscale does not alias, and the rest is
+	bilinear. the box filter and the vertical pass of the bilinear filter
+	run 16 pixels at a time with SSE2 where the compiler targets it, the
+	horizontal pass and the tails are plain C
+*/
+class CImageScaler
+{
+public:
+	/**
+		scale a plane into an other one
+	Parameters:
+	@param lpSrc	first row of the source
+	@param nSrcStride	bytes between two source rows
+	@param lpDst	first row of the target, may not overlap the source
+	*/
+	static void ScalePlane(const BYTE* lpSrc, int nSrcStride, int nSrcWidth, int nSrcHeight,
+		BYTE* lpDst, int nDstStride, int nDstWidth, int nDstHeight);
+
+	static void CopyPlane(const BYTE* lpSrc, int nSrcStride, BYTE* lpDst, int nDstStride, int nWidth, int nHeight);
+	static void FillPlane(BYTE* lpDst, int nDstStride, int nWidth, int nHeight, BYTE nValue);
+
+	// true when ScalePlane uses the SSE2 kernels
+	static bool HasSimd();
+
+private:
+	static void HalvePlane(const BYTE* lpSrc, int nSrcStride, BYTE* lpDst, int nDstStride, int nDstWidth, int nDstHeight);
+	static void BilinearPlane(const BYTE* lpSrc, int nSrcStride, int nSrcWidth, int nSrcHeight,
+		BYTE* lpDst, int nDstStride, int nDstWidth, int nDstHeight);
+	// lpDst = lpRow0 + (lpRow1 - lpRow0) * nWeight / 256
+	static void BlendRows(const BYTE* lpRow0, const BYTE* lpRow1, int nWeight, BYTE* lpDst, int nWidth);
+};
@@ -0,0 +1,27 @@
+#pragma once
+#include "json/json.h"
+#include <stdint.h>
+#include <string>
+
+/**
+	the integers of the json the scripts send to the old exports. unlike
+	stoi/atoi nothing throws through an extern "C" export, a bad field comes
+	back as false and the export returns its error
+*/
+class CJsonArgs
+{
+public:
+	// the whole string has to be a decimal integer
+	static bool ParseInteger(const std::string& str, int64_t& nValue);
+
+	/**
+		read an integer the scripts send either as a json number or as a string
+	Parameters:
+	@param root		parsed json object
+	@param lpKey	key to read, when it is missing nValue is left as it is
+	@param nMin, nMax	accepted range
+	@param nValue	receives the value
+	@return false when the value is there but is not an integer in range
+	*/
+	static bool JsonInteger(const Json::Value& root, const char* lpKey, int64_t nMin, int64_t nMax, int64_t& nValue);
+};
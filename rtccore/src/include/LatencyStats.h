@@ -0,0 +1,92 @@
+#pragma once
+#include "HdrHistogram.h"
+#include <condition_variable>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+// ten seconds in ns, anything slower is clamped
+#define LATENCY_HIGHEST_TRACKABLE	(10LL * 1000 * 1000 * 1000)
+#define LATENCY_MIN_DUMP_INTERVAL_MS	100
+
+/**
+	the stages a pushed frame passes on its way into the SDK, stamped with
+	CMediaClock::NowNs:
+	push		rtc_pushVideoFrame/rtc_pushAudioFrame entered, or the zego media
+				player handed a frame to ZegoCustomVideoSourceMedia
+	publish		the frame is in CAgVideoBuffer/CircleBuffer or the media queue,
+				for audio this includes the wait for free space
+	read		the capture observer (agora) or capture thread (zego) took it
+	handoff		the frame is given to the SDK
+*/
+enum LATENCY_STAGE
+{
+	LATENCY_VIDEO_PUSH_PUBLISH = 0,
+	LATENCY_VIDEO_PUBLISH_READ,
+	LATENCY_VIDEO_READ_HANDOFF,
+	LATENCY_VIDEO_PUSH_HANDOFF,
+	LATENCY_AUDIO_PUSH_PUBLISH,
+	LATENCY_AUDIO_PUBLISH_READ,
+	LATENCY_AUDIO_READ_HANDOFF,
+	LATENCY_AUDIO_PUSH_HANDOFF,
+	LATENCY_STAGE_NUM
+};
+
+/**
+	the stamps of one frame, 0 for a stage it did not pass
+*/
+struct LATENCY_STAMP
+{
+	int64_t nPushNs;
+	int64_t nPublishNs;
+	int64_t nReadNs;
+};
+
+/**
+	one lock free CHdrHistogram in ns per stage to stage latency of the video
+	and the audio path. the capture callbacks record a frame once it is handed
+	to the SDK, the script reads percentiles through the rtc_ exports or has a
+	thread rewrite a dump file every interval. the file has the "# name unit"
+	and "value count" lines of the churn histograms, fleet.py merges them
+*/
+class CLatencyStats
+{
+public:
+	static CLatencyStats* GetInstance();
+
+	// a frame read once, a stamp of 0 skips the stages it starts or ends
+	void RecordVideo(const LATENCY_STAMP& stamp, int64_t nHandoffNs);
+	void RecordAudio(const LATENCY_STAMP& stamp, int64_t nHandoffNs);
+
+	// NULL for a stage out of range
+	const CHdrHistogram* GetHistogram(int nStage) const;
+	static const char* GetStageName(int nStage);
+	void Reset();
+
+	void Dump(std::ostream& os) const;
+	void PrintPercentiles(std::ostream& os) const;
+
+	// 0, or -1 when a dump is running or lpPath can not be created
+	int StartDump(const char* lpPath, int nIntervalMs);
+	void StopDump();
+
+private:
+	CLatencyStats();
+
+	void Record(int nFirstStage, const LATENCY_STAMP& stamp, int64_t nHandoffNs);
+	bool WriteDump();
+	void ThreadProc();
+
+	CHdrHistogram* m_lpHistograms[LATENCY_STAGE_NUM];
+
+	// only touched by StartDump/StopDump and the dump thread
+	std::string m_strDumpPath;
+	int m_nDumpIntervalMs;
+
+	std::mutex m_lockControl;
+	std::mutex m_lockDump;
+	std::condition_variable m_condDump;
+	bool m_bStop;
+	std::thread m_thread;
+};
@@ -0,0 +1,109 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+// records per thread, power of two. 256 records are 64KB
+#define LOG_BUFFER_CAPACITY		256
+// bytes of a formatted line including the terminating 0, longer lines are cut
+#define LOG_TEXT				240
+#define LOG_DRAIN_INTERVAL_MS	50
+// every call site prints at most LOG_SITE_BURST lines per LOG_SITE_WINDOW_MS
+#define LOG_SITE_WINDOW_MS		1000
+#define LOG_SITE_BURST			10
+
+enum LOG_LEVEL
+{
+	LOG_LEVEL_DEBUG = 0,
+	LOG_LEVEL_INFO,
+	LOG_LEVEL_WARN,
+	LOG_LEVEL_ERROR,
+	LOG_LEVEL_OFF,
+};
+
+struct LOG_RECORD
+{
+	int64_t nTimestampUs;	// CMediaClock, the drain thread prints in this order
+	int32_t nLevel;
+	uint32_t nSuppressed;	// lines of the same call site dropped by the rate limit before this one
+	char szText[LOG_TEXT];
+};
+
+/**
+	the rate limit state of one LOG_ macro, a function local static so every
+	call site has its own
+*/
+struct LOG_SITE
+{
+	std::atomic<int64_t> nWindowUs;
+	std::atomic<uint32_t> nCount;
+	std::atomic<uint32_t> nSuppressed;
+
+	constexpr LOG_SITE() : nWindowUs(0), nCount(0), nSuppressed(0) {}
+};
+
+struct LOG_BUFFER;
+
+#ifdef __GNUC__
+#define LOG_PRINTF_FORMAT(fmt, args)	__attribute__((format(printf, fmt, args)))
+#else
+#define LOG_PRINTF_FORMAT(fmt, args)
+#endif
+
+/**
+	asynchronous logger for the SDK and capture threads. a LOG_ line is
+	formatted on the calling thread into a fixed record of that thread's own
+	single producer ring, the caller never takes a lock, allocates or touches
+	stdout. a full ring drops the line and counts it. a drain thread collects
+	the rings every LOG_DRAIN_INTERVAL_MS, prints the lines in time order and
+	flushes stdout once per batch.
+	a call site over its LOG_SITE_BURST per window is muted until the next
+	window, the first line after that says how many were suppressed
+*/
+class CLogger
+{
+public:
+	static CLogger* GetInstance();
+
+	static bool IsEnabled(int nLevel) { return nLevel >= m_nLevel.load(std::memory_order_relaxed); }
+	// LOG_LEVEL, LOG_LEVEL_OFF silences everything
+	static void SetLevel(int nLevel) { m_nLevel.store(nLevel, std::memory_order_relaxed); }
+
+	void Write(LOG_SITE& site, int nLevel, const char* lpFormat, ...) LOG_PRINTF_FORMAT(4, 5);
+	// prints everything pushed so far before returning
+	void Flush();
+
+private:
+	CLogger();
+
+	static bool Admit(LOG_SITE& site, int64_t nNowUs, uint32_t& nSuppressed);
+	LOG_BUFFER* GetThreadBuffer();
+	void ThreadProc();
+	void Drain();
+
+	static std::atomic<int> m_nLevel;
+
+	// every buffer ever handed to a thread, a buffer whose thread exited is reused
+	std::atomic<LOG_BUFFER*> m_lpBuffers;
+
+	// the drain thread and Flush take turns as the single consumer
+	std::mutex m_lockDrain;
+	std::vector<LOG_RECORD> m_batch;
+	std::vector<char> m_output;
+};
+
+#define LOG_AT(level, ...) \
+	do \
+	{ \
+		if (CLogger::IsEnabled(level)) \
+		{ \
+			static LOG_SITE logSite; \
+			CLogger::GetInstance()->Write(logSite, level, __VA_ARGS__); \
+		} \
+	} while (0)
+
+#define LOG_DEBUG(...)	LOG_AT(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define LOG_INFO(...)	LOG_AT(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_WARN(...)	LOG_AT(LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOG_ERROR(...)	LOG_AT(LOG_LEVEL_ERROR, __VA_ARGS__)
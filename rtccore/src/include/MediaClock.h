@@ -0,0 +1,29 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+
+/**
+	time source of the media buffers. the wrapper runs on steady_clock, the
+	pipeline simulator installs a virtual clock so an hour of pushes and pulls
+	replays in seconds with the same timestamps every run
+*/
+class IMediaClock
+{
+public:
+	virtual ~IMediaClock() {}
+	virtual int64_t NowUs() = 0;
+};
+
+class CMediaClock
+{
+public:
+	// nullptr puts steady_clock back
+	static void SetClock(IMediaClock* lpClock);
+	static int64_t NowUs();
+	static int64_t NowMs() { return NowUs() / 1000; }
+	// the per frame latency stamps, a virtual clock only has us
+	static int64_t NowNs();
+
+private:
+	static std::atomic<IMediaClock*> m_lpClock;
+};
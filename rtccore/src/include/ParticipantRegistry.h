@@ -0,0 +1,146 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+// slots of the table, a power of two at least twice PARTICIPANT_MAX so a probe stays short
+#define PARTICIPANT_TABLE_SIZE		4096
+#define PARTICIPANT_MAX				2048
+// joins and leaves posted within this window reach the owner as one batch
+#define PARTICIPANT_BATCH_MS		20
+
+// what the SDK was last told about a participant, set by the owner
+enum PARTICIPANT_FLAG
+{
+	PARTICIPANT_FLAG_PLAYING = 0x01,			// subscribed, or played for zego
+	PARTICIPANT_FLAG_VIDEO_MUTED = 0x02,
+	PARTICIPANT_FLAG_AUDIO_MUTED = 0x04,
+	PARTICIPANT_FLAG_LOW_STREAM = 0x08,			// the low stream or the base layer
+	PARTICIPANT_FLAG_STREAM_SELECTED = 0x10,	// LOW_STREAM was sent to the SDK
+};
+
+// the last value a stats callback reported for a participant, 0 until then
+enum PARTICIPANT_STAT
+{
+	PARTICIPANT_STAT_WIDTH = 0,
+	PARTICIPANT_STAT_HEIGHT,
+	PARTICIPANT_STAT_VIDEO_KBPS,
+	PARTICIPANT_STAT_VIDEO_FPS,
+	PARTICIPANT_STAT_DELAY_MS,
+	PARTICIPANT_STAT_AUDIO_KBPS,
+	PARTICIPANT_STAT_AUDIO_LEVEL,	// 0..100
+	PARTICIPANT_STAT_NUM,
+};
+
+enum PARTICIPANT_EVENT_TYPE
+{
+	PARTICIPANT_EVENT_JOINED = 0,
+	PARTICIPANT_EVENT_LEFT,
+};
+
+struct PARTICIPANT_INFO
+{
+	void* hView;		// the view it should be shown in, NULL while it waits
+	void* hRenderView;	// the view the SDK draws it into
+	uint32_t nFlags;	// PARTICIPANT_FLAG
+};
+
+struct PARTICIPANT_EVENT
+{
+	int nType;				// PARTICIPANT_EVENT_TYPE
+	std::string strId;
+	uint32_t nGeneration;	// of the registry when it was posted
+};
+
+/**
+	every remote participant of the channel, keyed by the agora uid as a
+	decimal string or the zego stream id, with its view, what it is subscribed
+	to and its last stats. an open addressing table of PARTICIPANT_TABLE_SIZE
+	slots probed linearly by a 64 bit hash of the id, so a lookup costs the
+	same with 10 or 2000 participants.
+	the owner changes the participants under its own lock, the changes are
+	serialized by the registry too. the stats callbacks read a participant
+	and store its stats without any lock: every slot has a sequence number
+	that is odd while the slot is written, Get retries until it read a slot
+	that did not change under it. SetStat makes it odd itself, so the slot
+	can not be given to an other participant between its check and its store.
+	the SDK announces a whole room at once when joining a big channel, Post
+	queues the joins and leaves and a worker hands them to the batch handler
+	PARTICIPANT_BATCH_MS later, only the last event of an id is kept. Clear
+	starts a new generation, the handler drops the events posted before it
+*/
+class CParticipantRegistry
+{
+public:
+	typedef std::function<void(const std::vector<PARTICIPANT_EVENT>&)> BATCH_HANDLER;
+
+	static CParticipantRegistry* GetInstance();
+
+	// the owner calls these under its lock
+	// false when the id is known, PARTICIPANT_MAX is reached or an other id has the same hash
+	bool Add(const std::string& strId, const PARTICIPANT_INFO& info);
+	bool Remove(const std::string& strId);
+	bool Update(const std::string& strId, const PARTICIPANT_INFO& info);
+	void Clear();
+	// a snapshot of the ids, in no order
+	void GetIds(std::vector<std::string>& vecIds);
+
+	// lock free, from any thread
+	bool Get(const std::string& strId, PARTICIPANT_INFO& info) const;
+	bool Contains(const std::string& strId) const;
+	void SetStat(const std::string& strId, int nStat, int32_t nValue);
+	bool GetStat(const std::string& strId, int nStat, int32_t& nValue) const;
+	int GetCount() const { return m_nCount.load(std::memory_order_relaxed); }
+	uint32_t GetGeneration() const { return m_nGeneration.load(std::memory_order_acquire); }
+
+	// the handler runs on the worker thread, set before the first Post
+	void SetBatchHandler(const BATCH_HANDLER& fnHandler);
+	void Post(int nType, const std::string& strId);
+	// drops the queued events and the handler and joins the worker, before the engine the handler calls goes away
+	void StopBatching();
+
+private:
+	CParticipantRegistry();
+
+	struct PARTICIPANT_SLOT
+	{
+		std::atomic<uint64_t> nKey;		// PARTICIPANT_KEY_EMPTY, PARTICIPANT_KEY_DELETED or the hash
+		std::atomic<uint32_t> nSeq;		// odd while the slot is written
+		std::atomic<void*> hView;
+		std::atomic<void*> hRenderView;
+		std::atomic<uint32_t> nFlags;
+		std::atomic<int32_t> nStats[PARTICIPANT_STAT_NUM];
+	};
+
+	static uint64_t Hash(const std::string& strId);
+	// the slot of nKey or -1
+	int Find(uint64_t nKey) const;
+	// makes the sequence odd once no one else has it odd, returns the even value it had
+	uint32_t Claim(int nSlot);
+	// under m_lockWrite
+	void Write(int nSlot, uint64_t nKey, const PARTICIPANT_INFO& info, bool bResetStats);
+	void Rebuild();
+	void ThreadProc();
+
+	PARTICIPANT_SLOT m_slots[PARTICIPANT_TABLE_SIZE];
+	// the ids are only needed by the writers, to tell two ids with the same hash apart
+	std::string m_strIds[PARTICIPANT_TABLE_SIZE];
+	std::atomic<int> m_nCount;
+	std::atomic<uint32_t> m_nGeneration;
+	int m_nDeleted;
+	std::mutex m_lockWrite;
+
+	// serializes starting and joining the worker
+	std::mutex m_lockControl;
+	std::mutex m_lockBatch;
+	std::condition_variable m_condBatch;
+	std::vector<PARTICIPANT_EVENT> m_vecEvents;
+	BATCH_HANDLER m_fnHandler;
+	std::thread m_thread;
+	bool m_bStop;
+};
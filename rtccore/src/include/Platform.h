@@ -0,0 +1,75 @@
+#pragma once
+/**
+	the handful of win32 types and calls the core and the wrappers use. on
+	windows this is just <windows.h>, elsewhere they are mapped to portable
+	equivalents so both wrappers build against their mock engines on linux for
+	benchmarking. off windows the zego headers also need LINUX defined, which
+	zegodl/CMakeLists.txt does
+*/
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+typedef void*			HWND;
+typedef void*			HMODULE;
+typedef void*			LPVOID;
+typedef int				BOOL;
+typedef unsigned int	UINT;
+typedef uint32_t		DWORD;
+typedef unsigned char	BYTE;
+typedef uintptr_t		WPARAM;
+typedef intptr_t		LPARAM;
+
+#ifndef TRUE
+#define TRUE	1
+#endif
+#ifndef FALSE
+#define FALSE	0
+#endif
+
+#define APIENTRY
+#define __declspec(x)	__attribute__((visibility("default")))
+#define WM_USER			0x0400
+
+#define DLL_PROCESS_DETACH	0
+#define DLL_PROCESS_ATTACH	1
+#define DLL_THREAD_ATTACH	2
+#define DLL_THREAD_DETACH	3
+
+#define _T(x)			x
+#define _tcslen			strlen
+
+inline BOOL SetConsoleOutputCP(UINT /*wCodePageID*/)
+{
+	return TRUE;
+}
+
+inline int memcpy_s(void* dest, size_t destSize, const void* src, size_t count)
+{
+	if (count == 0)
+		return 0;
+	if (dest == NULL || src == NULL || destSize < count)
+		return EINVAL;
+	memcpy(dest, src, count);
+	return 0;
+}
+
+inline int strcpy_s(char* dest, size_t destSize, const char* src)
+{
+	if (dest == NULL || src == NULL || destSize == 0)
+		return EINVAL;
+	size_t len = strlen(src);
+	if (len >= destSize)
+	{
+		dest[0] = '\0';
+		return ERANGE;
+	}
+	memcpy(dest, src, len + 1);
+	return 0;
+}
+#endif
@@ -0,0 +1,87 @@
+#pragma once
+#include "StatsRecorder.h"
+#include <stdint.h>
+
+/**
+	results of the rtc_ exports, the same numbers as AGORA_CONFIG_RESULT and
+	ZEGO_CONFIG_RESULT so a backend passes those through unchanged
+*/
+enum RTC_RESULT
+{
+	RTC_OK = 0,
+	RTC_ERR_INVALID_ARG = -3,		// a parameter is out of range
+	RTC_ERR_SDK = -4,				// the SDK call failed
+	RTC_ERR_TIMEOUT = -6,			// rtc_waitJoinChannel gave up
+	RTC_ERR_NO_ENGINE = -8,			// rtc_createEngine was not called
+	RTC_ERR_UNSUPPORTED = -9,		// the backend has no such feature
+};
+
+/**
+	one vendor SDK behind the vendor neutral rtc_ exports of
+	rtccore/engine/RtcEngine.cpp. the core owns everything that does not
+	depend on the SDK: the pushed video frame in CAgVideoBuffer and the pushed
+	PCM in CircleBuffer, the views of CAGExtInfoManager, the stats file, the
+	log and the event ring template. a backend only maps these calls onto its
+	SDK and pulls its custom capture from the core buffers, so a workload
+	scripted against rtc_ runs unchanged on either vendor.
+	the calls come from the script thread, a backend queues whatever has to
+	run on its engine thread itself
+*/
+class IRtcBackend
+{
+public:
+	virtual ~IRtcBackend() {}
+
+	// "agora" or "zego", also the vendor of the stats file
+	virtual const char* GetName() = 0;
+	// the kinds the stats callbacks of this backend record
+	virtual const STATS_SCHEMA_SET& GetStatsSchemas() = 0;
+
+	// lpAppId may be NULL for a backend that has its id built in
+	virtual int CreateEngine(const char* lpAppId) = 0;
+	virtual void DestroyEngine() = 0;
+	virtual bool HasEngine() = 0;
+
+	// lpUserId is the uid as a decimal string for agora, any id for zego
+	virtual int JoinChannel(const char* lpChannelId, const char* lpUserId) = 0;
+	// ms from JoinChannel to joined, RTC_ERR_TIMEOUT. <0 waits forever
+	virtual int WaitJoinChannel(int nTimeoutMs) = 0;
+	virtual int LeaveChannel() = 0;
+
+	virtual int EnableVideo(bool bEnable) = 0;
+	virtual int EnableAudio(bool bEnable) = 0;
+	// nBitrate in kbps
+	virtual int SetVideoProfile(int nWidth, int nHeight, int nFps, int nBitrate) = 0;
+	// nProfile and lpCodec are the vendor's, lpCodec NULL keeps the codec of the profile
+	virtual int SetAudioProfile(int nProfile, const char* lpCodec) = 0;
+
+	// publish a low resolution stream or layer next to the normal one, on by default.
+	// the remote streams shown in small views are played from it
+	virtual int EnableDualStream(bool bEnable) = 0;
+
+	// no preview and the remote streams decoded into a null renderer, before
+	// joining. the views of rtc_addView are then only slots, no HWND is needed
+	virtual int EnableHeadless(bool bEnable) = 0;
+
+	// the SDK hands every decoded remote frame to the wrapper, which passes
+	// it on to CVideoCompositor. before joining
+	virtual int EnableRemoteVideoFrames(bool bEnable) = 0;
+	// the mixed remote audio goes to an external sink instead of the playout
+	// device, CAudioSink pulls it with PullAudioFrame. before joining
+	virtual int EnableAudioSink(bool bEnable, int nSampleRate, int nChannels) = 0;
+	// from the CAudioSink thread, nSamples per channel of interleaved 16 bit PCM. false when the SDK has none
+	virtual bool PullAudioFrame(int16_t* lpPcm, int nSamples, int nSampleRate, int nChannels) = 0;
+	// the SDK hands the decoded audio of every remote participant, and its
+	// mixes, to CAudioRecorder. nSampleRate and nChannels of the mixes
+	virtual int EnableAudioRecording(bool bEnable, int nSampleRate, int nChannels) = 0;
+
+	// publish the frames pushed into CAgVideoBuffer instead of a camera
+	virtual int EnableCustomVideoCapture() = 0;
+	// publish the PCM pushed into CircleBuffer instead of a microphone
+	virtual int EnableCustomAudioCapture(int nSampleRate, int nChannels) = 0;
+};
+
+/**
+	the backend of this dll, defined once by each wrapper
+*/
+IRtcBackend* GetRtcBackend();
@@ -0,0 +1,41 @@
+#pragma once
+#include "Platform.h"
+#include <string>
+
+/**
+	a named block of memory an other process maps by the same name: a file
+	mapping named Local\<name> on windows, /dev/shm/<name> elsewhere. the
+	creator owns the name, a block left behind by a killed process under the
+	same name is replaced. mappings of readers stay valid after Close
+*/
+class CSharedMemory
+{
+public:
+	CSharedMemory();
+	~CSharedMemory();
+
+	/**
+		create a zeroed block
+	Parameters:
+	@param strName	letters, digits, '_' and '-', without a prefix or a slash
+	@return false when the block can not be created or mapped
+	*/
+	bool Create(const std::string& strName, size_t nSize);
+	// unmaps the block and removes the name
+	void Close();
+
+	BYTE* GetData() const { return m_lpData; }
+	size_t GetSize() const { return m_nSize; }
+	const std::string& GetName() const { return m_strName; }
+
+private:
+	CSharedMemory(const CSharedMemory&) = delete;
+	CSharedMemory& operator=(const CSharedMemory&) = delete;
+
+	std::string m_strName;
+	BYTE* m_lpData;
+	size_t m_nSize;
+#ifdef _WIN32
+	HANDLE m_hMapping;
+#endif
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+/**
+	defines T::GetInstance for a singleton that runs a worker thread or is
+	called from the SDK threads. the instance is never destroyed: a static
+	destructor runs under the loader lock, where joining a thread deadlocks,
+	and an SDK thread may still call into it while the dll unloads.
+	the plain singletons use a static object, like CAgVideoBuffer
+*/
+#define RTC_DEFINE_SINGLETON(T) \
+	T* T::GetInstance() \
+	{ \
+		static T* lpInstance = new T(); \
+		return lpInstance; \
+	}
@@ -0,0 +1,60 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// weight of a new report in the smoothed level, the rest is the history
+#define SPEAKER_LEVEL_SMOOTHING		0.3
+// a waiting participant must be this much louder (0..100) than the one it replaces
+#define SPEAKER_SWITCH_MARGIN		15.0
+// a participant keeps a view it got at least this long
+#define SPEAKER_MIN_HOLD_MS			3000
+// onAudioVolumeIndication period asked from agora, zego reports every 100ms
+#define SPEAKER_REPORT_INTERVAL_MS	200
+
+/**
+	decides which remote participants hold the limited views by how much they
+	speak. every level report (0..100) is smoothed per participant and those
+	missing from a report fade out. a waiting participant replaces the quietest
+	one shown only when it is SPEAKER_SWITCH_MARGIN louder and the shown one had
+	its view for SPEAKER_MIN_HOLD_MS, so two similar speakers do not flip the
+	views every report. ties go to the earlier arrival. the owner maps the keys
+	(agora uids, zego stream ids) to views and subscriptions and locks around it
+*/
+class CSpeakerScheduler
+{
+public:
+	CSpeakerScheduler();
+
+	void Clear();
+	// a participant that is already known keeps its state
+	void Add(const std::string& strKey, bool bShown, int64_t nNowMs);
+	void Remove(const std::string& strKey);
+
+	bool IsKnown(const std::string& strKey) const;
+	bool IsWaiting(const std::string& strKey) const;
+
+	// one report of the remote levels, the participants missing from it count as silent
+	void UpdateLevels(const std::vector<std::pair<std::string, float>>& vecLevels);
+	// the loudest waiting participant for a view that got free, it is shown from now on
+	bool PickWaiting(int64_t nNowMs, std::string& strKey);
+	// (shown, waiting) pairs to swap, both already have their new state
+	void Schedule(int64_t nNowMs, std::vector<std::pair<std::string, std::string>>& vecSwaps);
+
+private:
+	struct SPEAKER_STATE
+	{
+		double dLevel;
+		bool bShown;
+		bool bReported;
+		int64_t nShownMs;	// when it got its view
+		uint64_t nSeq;		// arrival order
+	};
+
+	void Show(SPEAKER_STATE& state, bool bShown, int64_t nNowMs);
+
+	std::unordered_map<std::string, SPEAKER_STATE> m_mapStates;
+	uint64_t m_nSeq;
+};
@@ -0,0 +1,127 @@
+#pragma once
+#include "DropRing.h"
+#include <condition_variable>
+#include <mutex>
+#include <stdio.h>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// power of two, 4096 samples are 1.6MB and hold minutes of stats callbacks
+#define STATS_RING_CAPACITY			4096
+#define STATS_MAX_FIELDS			20
+// kinds are numbered from 1, every backend has at most this many
+#define STATS_MAX_KINDS				8
+#define STATS_FLUSH_INTERVAL_MS		500
+
+// bytes of szKey including the terminating 0, room for a zego stream id
+#define STATS_KEY_TEXT				232
+
+// doubles of the stats callbacks are stored as integers of 1/1000
+#define STATS_DOUBLE_SCALE			1000
+
+struct STATS_FIELD
+{
+	const char* lpName;
+	int nScale;		// the stored integer is value * nScale
+};
+
+#define STATS_D(name)	{ name, STATS_DOUBLE_SCALE }
+#define STATS_I(name)	{ name, 1 }
+
+/**
+	the columns of one kind of sample, a backend fills nValues of its samples
+	in this order
+*/
+struct STATS_SCHEMA
+{
+	int nKind;					// 1..STATS_MAX_KINDS
+	const char* lpName;
+	const char* lpKeyName;
+	STATS_FIELD fields[STATS_MAX_FIELDS + 1];	// NULL name terminated
+};
+
+/**
+	every kind a backend records, written into the file header
+*/
+struct STATS_SCHEMA_SET
+{
+	const char* lpVendor;
+	const STATS_SCHEMA* lpSchemas;
+	int nCount;
+};
+
+/**
+	one stats callback. a sample is keyed either by a number (agora uid, 0 for
+	the local stats) or by a name in szKey (zego stream id), a backend uses one
+	or the other
+*/
+struct STATS_SAMPLE
+{
+	int64_t nTimestampUs;	// CMediaClock
+	int32_t nKind;
+	uint32_t nKey;			// the writer fills it from szKey when szKey is set
+	int64_t nValues[STATS_MAX_FIELDS];
+	char szKey[STATS_KEY_TEXT];
+};
+
+/**
+	records the stats callbacks of the backend as binary samples instead of
+	printing them. the callback copies a STATS_SAMPLE into a CDropRing and
+	returns, a writer thread drains the ring every STATS_FLUSH_INTERVAL_MS into
+	a columnar file: a header naming the vendor, every kind and column, then
+	blocks of samples of one kind with each column stored as zigzag varint
+	deltas. named keys are written once as a key block and referenced by
+	number afterwards. a block only depends on itself and the keys before it,
+	a soak test killed mid-run loses at most the last interval.
+	stats_csv.py in the repo root turns a file into one csv per kind
+*/
+class CStatsRecorder
+{
+public:
+	static CStatsRecorder* GetInstance();
+
+	// checked by the callbacks before they build a sample
+	static bool IsRecording() { return m_bRecording.load(std::memory_order_relaxed); }
+	// fill nTimestampUs, nKind and the key, zero the values
+	static void Init(STATS_SAMPLE& sample, int nKind, uint32_t nKey);
+	static void Init(STATS_SAMPLE& sample, int nKind, const std::string& strKey);
+	static int64_t Scale(double value) { return (int64_t)(value * STATS_DOUBLE_SCALE + (value < 0 ? -0.5 : 0.5)); }
+
+	// 0, or -1 when a recording is running or lpPath can not be created
+	int Start(const char* lpPath, const STATS_SCHEMA_SET& schemas);
+	// flushes and closes the file, returns the number of samples written, -1 when not recording
+	int64_t Stop();
+
+	void Record(const STATS_SAMPLE& sample) { m_ring.Push(sample); }
+
+private:
+	CStatsRecorder();
+
+	void ThreadProc();
+	void Flush();
+	uint32_t GetKey(const char* lpKey);
+	void WriteHeader();
+	void WriteSamples(int nKind, const std::vector<STATS_SAMPLE>& samples);
+
+	static std::atomic<bool> m_bRecording;
+
+	CDropRing<STATS_SAMPLE, STATS_RING_CAPACITY> m_ring;
+	uint64_t m_nDroppedWritten;
+
+	// only touched by Start/Stop and the writer thread
+	FILE* m_lpFile;
+	STATS_SCHEMA_SET m_schemas;
+	int m_nFieldCount[STATS_MAX_KINDS + 1];	// 0 for a kind the backend does not have
+	std::unordered_map<std::string, uint32_t> m_keys;
+	std::vector<STATS_SAMPLE> m_pending[STATS_MAX_KINDS + 1];
+	std::vector<uint8_t> m_buffer;
+	int64_t m_nWritten;
+
+	std::mutex m_lockControl;
+	std::mutex m_lockWriter;
+	std::condition_variable m_condWriter;
+	bool m_bStop;
+	std::thread m_thread;
+};
@@ -0,0 +1,112 @@
+#pragma once
+#include "Platform.h"
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#define COMPOSITOR_MAX_TILES		64
+#define COMPOSITOR_MAX_WIDTH		3840
+#define COMPOSITOR_MAX_HEIGHT		2160
+// a tile without a frame for this long is blanked, its participant left or lost the view
+#define COMPOSITOR_STALE_MS			1000
+#define COMPOSITOR_BLACK_Y			0
+#define COMPOSITOR_BLACK_UV			128
+
+// a tile Composite copied into the surface, in pixels of the luma plane
+struct COMPOSITOR_RECT
+{
+	int32_t nX;
+	int32_t nY;
+	int32_t nWidth;
+	int32_t nHeight;
+};
+
+/**
+	draws the decoded video of every remote participant that holds a view
+	into one I420 gallery, so a monitoring station shows dozens of streams
+	without a window and a render pipeline per stream. the tile of a
+	participant is the place of its view in the rtc_addView order, tiles
+	fill the gallery row by row, so the speakers keep moving between tiles
+	the way they move between views.
+	the render threads of the SDK scale their frame into the tile (fit, the
+	rest stays black) in a back buffer and mark the tile dirty, each tile
+	has its own lock so the streams scale in parallel. Composite copies the
+	dirty tiles into the surface the script reads and returns their rects,
+	the surface does not change between two calls of Composite
+*/
+class CVideoCompositor
+{
+public:
+	static CVideoCompositor* GetInstance();
+
+	/**
+		a gallery of nCols x nRows tiles, a running gallery is replaced and
+		the surface of the old one is gone
+	Parameters:
+	@param nTileWidth	rounded down to even, so is nTileHeight
+	@return false when the gallery is larger than COMPOSITOR_MAX_WIDTH x COMPOSITOR_MAX_HEIGHT or has too many tiles
+	*/
+	bool Start(int nCols, int nRows, int nTileWidth, int nTileHeight);
+	void Stop();
+	bool IsRunning() const { return m_bRunning.load(std::memory_order_relaxed); }
+
+	/**
+		from the render threads, a decoded I420 frame of a remote participant
+	Parameters:
+	@param strId	the participant, its view in CParticipantRegistry picks the tile
+	*/
+	void PutFrame(const std::string& strId, const BYTE* lpY, int nYStride, const BYTE* lpU, int nUStride,
+		const BYTE* lpV, int nVStride, int nWidth, int nHeight);
+
+	/**
+		copy the tiles drawn since the last call into the surface and blank the
+		stale ones
+	Parameters:
+	@param lpRects	gets the changed tiles, more than nMaxRects become one rect of the whole gallery
+	@return number of rects, 0 when nothing changed or the gallery is stopped
+	*/
+	int Composite(COMPOSITOR_RECT* lpRects, int nMaxRects);
+	// the I420 gallery of nWidth x nHeight, NULL when stopped. valid until Stop or the next Start
+	const BYTE* GetSurface(int& nWidth, int& nHeight);
+
+	int64_t GetFrameCount() const { return m_nFrames.load(std::memory_order_relaxed); }
+	// frames of a participant without a view or whose view has no tile
+	int64_t GetDroppedCount() const { return m_nDropped.load(std::memory_order_relaxed); }
+
+private:
+	CVideoCompositor();
+
+	struct COMPOSITOR_TILE
+	{
+		bool bDirty;			// drawn into the back buffer since the last Composite
+		bool bDrawn;			// not black
+		int64_t nLastFrameMs;
+		// the fitted picture, the border around it is black
+		int nFitX, nFitY, nFitWidth, nFitHeight;
+	};
+
+	// under the lock of the tile
+	void ClearTile(std::vector<BYTE>& vecBuffer, int nTile);
+	void CopyTile(int nTile);
+	void GetTileOrigin(int nTile, int& nX, int& nY) const;
+
+	std::atomic<bool> m_bRunning;
+	// the layout only changes with m_lockLayout and every tile lock held
+	std::mutex m_lockLayout;
+	std::mutex m_lockTiles[COMPOSITOR_MAX_TILES];
+	COMPOSITOR_TILE m_tiles[COMPOSITOR_MAX_TILES];
+	int m_nCols;
+	int m_nTiles;
+	int m_nTileWidth;
+	int m_nTileHeight;
+	int m_nWidth;
+	int m_nHeight;
+	// I420 of m_nWidth x m_nHeight, the render threads draw into the back buffer
+	std::vector<BYTE> m_vecBack;
+	std::vector<BYTE> m_vecSurface;
+
+	std::atomic<int64_t> m_nFrames;
+	std::atomic<int64_t> m_nDropped;
+};
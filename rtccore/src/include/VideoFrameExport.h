@@ -0,0 +1,145 @@
+#pragma once
+#include "Platform.h"
+#include "SharedMemory.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+
+#define FRAME_EXPORT_MAGIC			0x46435452		// "RTCF"
+#define FRAME_EXPORT_VERSION		1
+#define FRAME_EXPORT_MIN_SLOTS		2
+#define FRAME_EXPORT_MAX_SLOTS		64
+#define FRAME_EXPORT_MAX_WIDTH		1920
+#define FRAME_EXPORT_MAX_HEIGHT		1080
+// rings of further participants are not created, their frames are dropped
+#define FRAME_EXPORT_MAX_RINGS		128
+#define FRAME_EXPORT_PREFIX_TEXT	32
+// bytes of szId including the terminating 0, room for a zego stream id
+#define FRAME_EXPORT_ID_TEXT		232
+// characters of the id that go into the name of the block
+#define FRAME_EXPORT_NAME_ID		64
+
+/**
+	the start of every block, frame_ring.py reads the same layout. the slots
+	follow at nHeaderSize, nSlotSize bytes apart
+*/
+struct FRAME_EXPORT_HEADER
+{
+	uint32_t nMagic;
+	uint32_t nVersion;
+	uint32_t nHeaderSize;
+	uint32_t nSlotHeaderSize;
+	uint32_t nSlots;
+	uint32_t nSlotSize;
+	uint32_t nMaxWidth;			// no frame is larger, a smaller one is scaled down to fit
+	uint32_t nMaxHeight;
+	uint32_t nIntervalMs;		// at most one frame per interval is sampled
+	uint32_t nClosed;			// 1 after rtc_stopFrameExport, no frame follows
+	std::atomic<uint64_t> nFrames;	// frames written, the newest is in slot (nFrames - 1) % nSlots
+	char szId[FRAME_EXPORT_ID_TEXT];	// uid or stream id
+	uint8_t reserved[40];
+};
+
+/**
+	a seqlock around one frame: nSeq is odd while the frame is written. a
+	reader takes nSeq, reads, and keeps what it read when nSeq is still the
+	same even value. the I420 planes follow the slot header without padding,
+	each row is nWidth (nWidth / 2) bytes
+*/
+struct FRAME_EXPORT_SLOT
+{
+	std::atomic<uint64_t> nSeq;
+	uint64_t nFrame;			// number of the frame in the ring, from 0
+	int64_t nTimestampUs;		// CMediaClock when it was sampled
+	uint32_t nWidth;
+	uint32_t nHeight;
+	uint32_t nSourceWidth;		// the decoded size before scaling
+	uint32_t nSourceHeight;
+	uint8_t reserved[24];
+};
+
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "the shared layout needs a plain 64 bit atomic");
+static_assert(sizeof(FRAME_EXPORT_HEADER) == 320, "frame_ring.py reads this layout");
+static_assert(sizeof(FRAME_EXPORT_SLOT) == 64, "frame_ring.py reads this layout");
+
+/**
+	hands the decoded video of every remote participant to analysis scripts
+	in other processes without a copy on their side. the first sampled frame
+	of a participant creates its block <prefix>_<id> (CSharedMemory) with a
+	ring of nSlots frames, the render thread then scales (CImageScaler) at
+	most one frame per interval into the oldest slot. a reader that keeps a
+	frame longer than nSlots - 1 intervals sees nSeq move on and drops it.
+	the blocks of a channel stay until Stop, a participant that left keeps
+	its last frames
+*/
+class CVideoFrameExport
+{
+public:
+	static CVideoFrameExport* GetInstance();
+
+	/**
+		sample the remote video of every participant into shared memory
+	Parameters:
+	@param lpPrefix	letters, digits, '_' and '-', at most FRAME_EXPORT_PREFIX_TEXT - 1, starts the name of every block
+	@param nMaxWidth	frames are scaled down to fit nMaxWidth x nMaxHeight, rounded down to even
+	@param nIntervalMs	0 samples every frame
+	@param nSlots	frames kept per participant, FRAME_EXPORT_MIN_SLOTS..FRAME_EXPORT_MAX_SLOTS
+	@return false when running or an argument is out of range
+	*/
+	bool Start(const char* lpPrefix, int nMaxWidth, int nMaxHeight, int nIntervalMs, int nSlots);
+	// marks every block closed and removes the names, readers keep their mappings
+	void Stop();
+	bool IsRunning() const { return m_bRunning.load(std::memory_order_relaxed); }
+
+	/**
+		from the render threads, a decoded I420 frame of a remote participant
+	Parameters:
+	@param strId	uid or stream id, names the block
+	*/
+	void PutFrame(const std::string& strId, const BYTE* lpY, int nYStride, const BYTE* lpU, int nUStride,
+		const BYTE* lpV, int nVStride, int nWidth, int nHeight);
+
+	// the block names, one per line
+	std::string GetNames();
+
+	int64_t GetFrameCount() const { return m_nFrames.load(std::memory_order_relaxed); }
+	// frames of a participant whose block could not be created
+	int64_t GetDroppedCount() const { return m_nDropped.load(std::memory_order_relaxed); }
+
+private:
+	CVideoFrameExport();
+
+	struct FRAME_RING
+	{
+		CSharedMemory memory;
+		std::mutex lock;			// render threads of one participant may change
+		int64_t nNextSampleUs;
+		uint64_t nFrames;
+	};
+
+	// under m_lockRings
+	std::shared_ptr<FRAME_RING> CreateRing(const std::string& strId);
+	std::string MakeName(const std::string& strId) const;
+	// under the lock of the ring
+	void WriteFrame(FRAME_RING& ring, const BYTE* lpY, int nYStride, const BYTE* lpU, int nUStride,
+		const BYTE* lpV, int nVStride, int nWidth, int nHeight, int64_t nNowUs);
+
+	std::atomic<bool> m_bRunning;
+	std::mutex m_lockControl;
+
+	// a render thread holds its ring while it writes, Stop only drops the map's reference
+	std::mutex m_lockRings;
+	std::unordered_map<std::string, std::shared_ptr<FRAME_RING>> m_rings;
+	std::string m_strPrefix;
+	int m_nMaxWidth;
+	int m_nMaxHeight;
+	int64_t m_nIntervalUs;
+	int m_nSlots;
+	size_t m_nSlotSize;
+
+	std::atomic<int64_t> m_nFrames;
+	std::atomic<int64_t> m_nDropped;
+};
@@ -0,0 +1,202 @@
+// audio_recorder_test : the wav files and the rings of CAudioRecorder
+//
+//   audio_recorder_test
+//
+// a first session records a numbered stereo track through more than one
+// ring, so a flush has to wrap, and a mono track of frames too large for
+// two of them to fit at once. the wav header has to carry the format and
+// the real size, the samples have to come back in order and every frame is
+// either written or dropped. a second session in the same directory gets
+// eight threads putting the first frames of more ids than there are
+// tracks: each id has to end in one file and the rest counts as dropped
+#include "AudioRecorder.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef _WIN32
+#include <direct.h>
+#include <process.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define TEST_FRAME_SAMPLES	480			// 10ms of 48kHz
+#define TEST_FRAME_BYTES	(TEST_FRAME_SAMPLES * 2 * 2)
+#define TEST_BATCH_FRAMES	200			// less than a ring, more than half of one
+#define TEST_BIG_SAMPLES	100000		// mono, two fit into a ring and three do not
+#define TEST_BIG_FRAMES		6
+#define TEST_THREADS		8
+#define TEST_IDS			(AUDIO_RECORD_MAX_TRACKS + 8)
+
+static int g_nErrors = 0;
+
+static void Expect(const char* lpWhat, int64_t nValue, int64_t nExpected)
+{
+	if (nValue == nExpected)
+		return;
+	fprintf(stderr, "%s: %lld, expected %lld\n", lpWhat, (long long)nValue, (long long)nExpected);
+	g_nErrors++;
+}
+
+static uint32_t GetLE(const uint8_t* lpIn, int nBytes)
+{
+	uint32_t nValue = 0;
+	for (int i = nBytes - 1; i >= 0; i--)
+		nValue = (nValue << 8) | lpIn[i];
+	return nValue;
+}
+
+static std::vector<uint8_t> ReadFile(const std::string& strPath)
+{
+	std::vector<uint8_t> vecData;
+	FILE* lpFile = fopen(strPath.c_str(), "rb");
+	if (lpFile == NULL)
+		return vecData;
+	uint8_t buffer[65536];
+	size_t nRead;
+	while ((nRead = fread(buffer, 1, sizeof(buffer), lpFile)) > 0)
+		vecData.insert(vecData.end(), buffer, buffer + nRead);
+	fclose(lpFile);
+	return vecData;
+}
+
+// the bytes of PCM a wav holds by its header, -1 when the header is not the one of the format
+static int64_t CheckWav(const std::vector<uint8_t>& vecWav, int nChannels, int nSampleRate)
+{
+	if (vecWav.size() < AUDIO_RECORD_WAV_HEADER || memcmp(vecWav.data(), "RIFF", 4) != 0
+		|| memcmp(vecWav.data() + 8, "WAVEfmt ", 8) != 0 || memcmp(vecWav.data() + 36, "data", 4) != 0)
+		return -1;
+	const uint8_t* lpHeader = vecWav.data();
+	uint32_t nDataBytes = GetLE(lpHeader + 40, 4);
+	if (GetLE(lpHeader + 4, 4) != nDataBytes + 36 || GetLE(lpHeader + 16, 4) != 16 || GetLE(lpHeader + 20, 2) != 1
+		|| GetLE(lpHeader + 22, 2) != (uint32_t)nChannels || GetLE(lpHeader + 24, 4) != (uint32_t)nSampleRate
+		|| GetLE(lpHeader + 28, 4) != (uint32_t)(nSampleRate * nChannels * 2) || GetLE(lpHeader + 32, 2) != (uint32_t)(nChannels * 2)
+		|| GetLE(lpHeader + 34, 2) != 16 || vecWav.size() != AUDIO_RECORD_WAV_HEADER + (size_t)nDataBytes)
+		return -1;
+	return nDataBytes;
+}
+
+static void TestSession(const std::string& strDir)
+{
+	CAudioRecorder* lpRecorder = CAudioRecorder::GetInstance();
+	Expect("Start in a file", lpRecorder->Start((strDir + "/none").c_str()), -1);
+	Expect("Stop before Start", lpRecorder->Stop(), -1);
+	Expect("Start", lpRecorder->Start(strDir.c_str()), 0);
+	Expect("Start while recording", lpRecorder->Start(strDir.c_str()), -1);
+
+	// two batches with a flush between them, the second one wraps the ring
+	std::vector<int16_t> vecFrame(TEST_FRAME_SAMPLES * 2);
+	int16_t nSample = 0;
+	for (int nBatch = 0; nBatch < 2; nBatch++)
+	{
+		for (int i = 0; i < TEST_BATCH_FRAMES; i++)
+		{
+			for (int16_t& nValue : vecFrame)
+				nValue = nSample++;
+			lpRecorder->PutFrame("a b", vecFrame.data(), TEST_FRAME_SAMPLES, 2, 48000);
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(AUDIO_RECORD_FLUSH_MS * 2));
+	}
+	lpRecorder->PutFrame("a b", vecFrame.data(), TEST_FRAME_SAMPLES * 2, 1, 48000);
+	Expect("dropped frame of another format", lpRecorder->GetDroppedCount(), 1);
+
+	std::vector<int16_t> vecBig(TEST_BIG_SAMPLES, 1000);
+	for (int i = 0; i < TEST_BIG_FRAMES; i++)
+		lpRecorder->PutFrame("big", vecBig.data(), TEST_BIG_SAMPLES, 1, 16000);
+	int64_t nBigDropped = lpRecorder->GetDroppedCount() - 1;
+	if (nBigDropped < 1)
+		Expect("dropped frames of a full ring", nBigDropped, 1);
+	int64_t nWritten = lpRecorder->Stop();
+
+	std::vector<uint8_t> vecWav = ReadFile(strDir + "/a_b.wav");
+	Expect("data bytes of a_b.wav", CheckWav(vecWav, 2, 48000), 2 * TEST_BATCH_FRAMES * TEST_FRAME_BYTES);
+	if (vecWav.size() == AUDIO_RECORD_WAV_HEADER + 2 * TEST_BATCH_FRAMES * TEST_FRAME_BYTES)
+	{
+		for (size_t i = 0; i < (vecWav.size() - AUDIO_RECORD_WAV_HEADER) / 2; i++)
+		{
+			if ((int16_t)GetLE(vecWav.data() + AUDIO_RECORD_WAV_HEADER + i * 2, 2) != (int16_t)i)
+			{
+				Expect("sample out of order at", (int64_t)i, -1);
+				break;
+			}
+		}
+	}
+
+	int64_t nBigBytes = CheckWav(ReadFile(strDir + "/big.wav"), 1, 16000);
+	Expect("data bytes of big.wav", nBigBytes, (TEST_BIG_FRAMES - nBigDropped) * TEST_BIG_SAMPLES * 2);
+	Expect("bytes written by Stop", nWritten, 2 * TEST_BATCH_FRAMES * TEST_FRAME_BYTES + nBigBytes);
+	remove((strDir + "/a_b.wav").c_str());
+	remove((strDir + "/big.wav").c_str());
+}
+
+// every thread puts one frame of each id, the ids race for the tracks
+static void TestRestartAndClaim(const std::string& strDir)
+{
+	CAudioRecorder* lpRecorder = CAudioRecorder::GetInstance();
+	Expect("Start after Stop", lpRecorder->Start(strDir.c_str()), 0);
+	Expect("dropped after Start", lpRecorder->GetDroppedCount(), 0);
+
+	std::atomic<int> nReady(0);
+	std::vector<std::thread> vecThreads;
+	for (int t = 0; t < TEST_THREADS; t++)
+	{
+		vecThreads.emplace_back([&nReady] {
+			std::vector<int16_t> vecFrame(TEST_FRAME_SAMPLES, 500);
+			nReady++;
+			while (nReady < TEST_THREADS)
+				std::this_thread::yield();
+			for (int i = 0; i < TEST_IDS; i++)
+				CAudioRecorder::GetInstance()->PutFrame(("t" + std::to_string(i)).c_str(), vecFrame.data(), TEST_FRAME_SAMPLES, 1, 48000);
+		});
+	}
+	for (std::thread& thread : vecThreads)
+		thread.join();
+	Expect("dropped frames of ids without a track", lpRecorder->GetDroppedCount(), (int64_t)TEST_THREADS * (TEST_IDS - AUDIO_RECORD_MAX_TRACKS));
+	Expect("bytes written by Stop", lpRecorder->Stop(), (int64_t)AUDIO_RECORD_MAX_TRACKS * TEST_THREADS * TEST_FRAME_SAMPLES * 2);
+
+	for (int i = 0; i < TEST_IDS; i++)
+	{
+		std::string strPath = strDir + "/t" + std::to_string(i) + ".wav";
+		int64_t nBytes = CheckWav(ReadFile(strPath), 1, 48000);
+		if (i < AUDIO_RECORD_MAX_TRACKS)
+			Expect(("data bytes of " + strPath).c_str(), nBytes, (int64_t)TEST_THREADS * TEST_FRAME_SAMPLES * 2);
+		else
+			Expect(("file of an id without a track " + strPath).c_str(), nBytes, -1);
+		remove(strPath.c_str());
+		// a second slot of one id would write t<i>_<slot>.wav
+		for (int nSlot = 0; nSlot < AUDIO_RECORD_MAX_TRACKS; nSlot++)
+		{
+			std::string strCopy = strDir + "/t" + std::to_string(i) + "_" + std::to_string(nSlot) + ".wav";
+			if (remove(strCopy.c_str()) == 0)
+				Expect(("second track of one id " + strCopy).c_str(), 1, 0);
+		}
+	}
+}
+
+int main()
+{
+#ifdef _WIN32
+	std::string strDir = "audio_recorder_test." + std::to_string(_getpid());
+	_mkdir(strDir.c_str());
+#else
+	std::string strDir = "audio_recorder_test." + std::to_string(getpid());
+	mkdir(strDir.c_str(), 0755);
+#endif
+	TestSession(strDir);
+	TestRestartAndClaim(strDir);
+#ifdef _WIN32
+	_rmdir(strDir.c_str());
+#else
+	rmdir(strDir.c_str());
+#endif
+
+	printf("audio_recorder_test: %d errors\n", g_nErrors);
+	return g_nErrors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,118 @@
+// audio_sink_test : pacing and measuring of CAudioSink
+//
+//   audio_sink_test
+//
+// the pull function plays a script by the number of its call: refused pulls
+// before the first frame, a square wave with a short hole of zeros (one
+// glitch) and a long one (a pause), refused pulls after the first frame and
+// one call that stalls the puller past AUDIO_SINK_MAX_CATCHUP frames. the
+// pulls plus the lost frames have to follow the clock, the glitch, failure
+// and level counters have to match the script, and Start resets them
+#include "AudioSink.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#define TEST_SAMPLE_RATE	16000
+#define TEST_AMPLITUDE		1000
+#define TEST_REFUSED_FIRST	2			// calls refused before the first frame
+#define TEST_STALL_FRAME	30			// frame whose pull sleeps
+#define TEST_STALL_MS		(AUDIO_SINK_FRAME_MS * (AUDIO_SINK_MAX_CATCHUP + 5))
+#define TEST_RUN_MS			1500
+
+static std::atomic<int> g_nCalls(0);
+static std::atomic<int> g_nBadSize(0);
+static int g_nErrors = 0;
+
+static void Expect(const char* lpWhat, int64_t nValue, int64_t nMin, int64_t nMax)
+{
+	if (nValue >= nMin && nValue <= nMax)
+		return;
+	fprintf(stderr, "%s: %lld, expected %lld..%lld\n", lpWhat, (long long)nValue, (long long)nMin, (long long)nMax);
+	g_nErrors++;
+}
+
+// frames 0-19 sound, 20-22 zeros, 23-39 sound, 40-69 zeros, 70-89 sound, then zeros
+static bool IsSound(int nFrame)
+{
+	return nFrame < 20 || (nFrame >= 23 && nFrame < 40) || (nFrame >= 70 && nFrame < 90);
+}
+
+static bool Pull(int16_t* lpPcm, int nSamples)
+{
+	int nCall = g_nCalls++;
+	if (nSamples != TEST_SAMPLE_RATE * AUDIO_SINK_FRAME_MS / 1000)
+		g_nBadSize++;
+	if (nCall < TEST_REFUSED_FIRST)
+		return false;
+
+	int nFrame = nCall - TEST_REFUSED_FIRST;
+	if (nFrame >= 95 && nFrame < 98)
+		return false;
+	if (nFrame == TEST_STALL_FRAME)
+		std::this_thread::sleep_for(std::chrono::milliseconds(TEST_STALL_MS));
+	for (int i = 0; i < nSamples; i++)
+		lpPcm[i] = IsSound(nFrame) ? (int16_t)(i & 1 ? TEST_AMPLITUDE : -TEST_AMPLITUDE) : 0;
+	return true;
+}
+
+static int64_t CentiDbfs(double dAmplitude)
+{
+	return (int64_t)std::lround(20 * log10(dAmplitude / 32768) * 100);
+}
+
+int main()
+{
+	CAudioSink* lpSink = CAudioSink::GetInstance();
+	if (lpSink->Start(TEST_SAMPLE_RATE + 50, 1, AUDIO_SINK_MEASURE, Pull) || lpSink->Start(TEST_SAMPLE_RATE, 3, AUDIO_SINK_MEASURE, Pull)
+		|| lpSink->Start(TEST_SAMPLE_RATE, 1, AUDIO_SINK_MEASURE, nullptr))
+		Expect("started with a bad format", 1, 0, 0);
+
+	auto start = std::chrono::steady_clock::now();
+	if (!lpSink->Start(TEST_SAMPLE_RATE, 1, AUDIO_SINK_MEASURE, Pull))
+	{
+		fprintf(stderr, "can not start\n");
+		return EXIT_FAILURE;
+	}
+	std::this_thread::sleep_for(std::chrono::milliseconds(TEST_RUN_MS));
+	lpSink->Stop();
+	int64_t nElapsedFrames = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count()
+		/ AUDIO_SINK_FRAME_MS;
+
+	// every frame due by the clock is either pulled or counted lost
+	int64_t nCalls = g_nCalls.load();
+	int64_t nLost = lpSink->GetStat(AUDIO_SINK_STAT_LOST);
+	Expect("pulls and lost frames against the clock", nCalls + nLost, nElapsedFrames - 5, nElapsedFrames + 2);
+	Expect("frames", lpSink->GetStat(AUDIO_SINK_STAT_FRAMES), nCalls - TEST_REFUSED_FIRST - 3, nCalls - TEST_REFUSED_FIRST - 3);
+	Expect("failed after the first frame", lpSink->GetStat(AUDIO_SINK_STAT_FAILED), 3, 3);
+	Expect("late wakeups", lpSink->GetStat(AUDIO_SINK_STAT_LATE), 1, nElapsedFrames);
+	Expect("lost frames of the stall", nLost, TEST_STALL_MS / AUDIO_SINK_FRAME_MS - AUDIO_SINK_MAX_CATCHUP - 1, TEST_STALL_MS / AUDIO_SINK_FRAME_MS);
+	Expect("pulls of a wrong size", g_nBadSize.load(), 0, 0);
+
+	// the short hole is a glitch, the long one a pause
+	Expect("glitches", lpSink->GetStat(AUDIO_SINK_STAT_GLITCHES), 1, 1);
+	Expect("silent frames", lpSink->GetStat(AUDIO_SINK_STAT_SILENT), 3 + 30, nCalls);
+	// the first window holds 57 frames of sound, the second one none
+	int64_t nLevel = CentiDbfs(TEST_AMPLITUDE * sqrt(0.57)), nPeak = CentiDbfs(TEST_AMPLITUDE);
+	if (lpSink->GetStat(AUDIO_SINK_STAT_FRAMES) >= 2 * AUDIO_SINK_LEVEL_FRAMES)
+		nLevel = nPeak = AUDIO_SINK_FLOOR_DBFS * 100;
+	Expect("level of the last window", lpSink->GetStat(AUDIO_SINK_STAT_LEVEL), nLevel - 1, nLevel + 1);
+	Expect("peak of the last window", lpSink->GetStat(AUDIO_SINK_STAT_PEAK), nPeak - 1, nPeak + 1);
+
+	// a new run starts its counters from 0
+	g_nCalls = TEST_REFUSED_FIRST + 100;
+	if (!lpSink->Start(TEST_SAMPLE_RATE, 1, AUDIO_SINK_DISCARD, Pull))
+		Expect("restart", 0, 1, 1);
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	lpSink->Stop();
+	Expect("frames of the second run", lpSink->GetStat(AUDIO_SINK_STAT_FRAMES), 5, 15);
+	Expect("glitches of the second run", lpSink->GetStat(AUDIO_SINK_STAT_GLITCHES), 0, 0);
+	Expect("failed of the second run", lpSink->GetStat(AUDIO_SINK_STAT_FAILED), 0, 0);
+
+	printf("audio_sink_test: %lld frames due, %d errors\n", (long long)nElapsedFrames, g_nErrors);
+	return g_nErrors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
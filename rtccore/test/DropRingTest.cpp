@@ -0,0 +1,121 @@
+// drop_ring_test : round trip of CDropRing
+//
+//   drop_ring_test [records]
+//
+// first one thread fills the ring past its capacity and drains it, then
+// several producers push numbered records against one consumer. every
+// record has to come out once and in the order of its producer, or be
+// counted as dropped
+#include "DropRing.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#define TEST_CAPACITY		1024
+#define TEST_PRODUCERS		4
+
+struct TEST_RECORD
+{
+	uint32_t nProducer;
+	uint32_t nSeq;
+	uint64_t nCheck;	// derived from the two above, a torn copy shows
+};
+
+static uint64_t Check(uint32_t nProducer, uint32_t nSeq)
+{
+	return ((uint64_t)nProducer << 32 | nSeq) * 0x9e3779b97f4a7c15ULL;
+}
+
+static CDropRing<TEST_RECORD, TEST_CAPACITY> g_ring;
+
+static int TestFill()
+{
+	int nErrors = 0;
+	for (uint32_t i = 0; i < TEST_CAPACITY + 10; i++)
+	{
+		TEST_RECORD record = { 0, i, Check(0, i) };
+		if (g_ring.Push(record) != (i < TEST_CAPACITY))
+			nErrors++;
+	}
+	if (g_ring.GetDropped() != 10)
+		nErrors++;
+
+	TEST_RECORD record;
+	uint32_t nSeq = 0;
+	while (g_ring.Pop(record))
+	{
+		if (record.nSeq != nSeq || record.nCheck != Check(0, nSeq))
+			nErrors++;
+		nSeq++;
+	}
+	if (nSeq != TEST_CAPACITY)
+		nErrors++;
+	if (nErrors)
+		fprintf(stderr, "fill: %d errors, %u popped, %llu dropped\n", nErrors, nSeq, (unsigned long long)g_ring.GetDropped());
+	return nErrors;
+}
+
+static int TestProducers(uint32_t nRecords)
+{
+	uint64_t nDroppedBefore = g_ring.GetDropped();
+	std::atomic<int> nRunning(TEST_PRODUCERS);
+	std::vector<std::thread> vecProducers;
+	for (uint32_t p = 0; p < TEST_PRODUCERS; p++)
+	{
+		vecProducers.push_back(std::thread([p, nRecords, &nRunning] {
+			for (uint32_t i = 0; i < nRecords; i++)
+			{
+				TEST_RECORD record = { p, i, Check(p, i) };
+				g_ring.Push(record);
+			}
+			nRunning--;
+		}));
+	}
+
+	int nErrors = 0;
+	uint64_t nPopped = 0;
+	int64_t nLastSeq[TEST_PRODUCERS];
+	for (int p = 0; p < TEST_PRODUCERS; p++)
+		nLastSeq[p] = -1;
+
+	TEST_RECORD record;
+	for (;;)
+	{
+		// the producers are done before the last drain, nothing arrives after it
+		bool bDone = nRunning == 0;
+		while (g_ring.Pop(record))
+		{
+			nPopped++;
+			if (record.nProducer >= TEST_PRODUCERS || record.nCheck != Check(record.nProducer, record.nSeq)
+				|| (int64_t)record.nSeq <= nLastSeq[record.nProducer])
+				nErrors++;
+			else
+				nLastSeq[record.nProducer] = record.nSeq;
+		}
+		if (bDone)
+			break;
+		std::this_thread::yield();
+	}
+	for (auto& producer : vecProducers)
+		producer.join();
+
+	uint64_t nDropped = g_ring.GetDropped() - nDroppedBefore;
+	if (nPopped + nDropped != (uint64_t)nRecords * TEST_PRODUCERS)
+		nErrors++;
+	if (nErrors)
+		fprintf(stderr, "producers: %d errors, %llu popped, %llu dropped\n", nErrors, (unsigned long long)nPopped, (unsigned long long)nDropped);
+	return nErrors;
+}
+
+int main(int argc, char* argv[])
+{
+	uint32_t nRecords = argc > 1 ? (uint32_t)atoi(argv[1]) : 1000000;
+	int nErrors = TestFill();
+	nErrors += TestProducers(nRecords);
+
+	printf("drop_ring_test: %u records per producer, %d errors\n", nRecords, nErrors);
+	return nErrors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,183 @@
+// engine_queue_test : tickets of CEngineQueue
+//
+//   engine_queue_test [posts]
+//
+// a test queue whose items carry the result Execute gives them. one thread
+// checks polling, waiting, batch skipping and expiry with a blocked executor,
+// then several producers post numbered items and every ticket has to come
+// back with the result of its own item, run in the order of its producer
+#include "EngineQueue.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define TEST_PRODUCERS		4
+#define TEST_COMMAND_TEXT	ENGINE_COMMAND_VENDOR
+
+struct TEST_ITEM
+{
+	uint32_t nProducer;
+	uint32_t nSeq;
+	int nResult;	// what Execute returns for the item
+};
+
+class CTestQueue : public CEngineQueue<TEST_ITEM>
+{
+public:
+	CTestQueue()
+		: m_bBlocked(false)
+	{
+		for (int i = 0; i < TEST_PRODUCERS; i++)
+			m_nLastSeq[i] = -1;
+	}
+
+	~CTestQueue()
+	{
+		Stop();
+	}
+
+	// the executor spins in the next command until Unblock
+	void Block() { m_bBlocked = true; }
+	void Unblock() { m_bBlocked = false; }
+
+	int m_nErrors = 0;
+	int m_nExecuted = 0;
+	std::string m_strText;
+
+protected:
+	int Execute(ENGINE_COMMAND& command) override
+	{
+		while (m_bBlocked)
+			std::this_thread::yield();
+		m_nExecuted++;
+
+		switch (command.nType)
+		{
+		case ENGINE_COMMAND_CONFIG:
+		{
+			TEST_ITEM& item = command.item;
+			if (item.nProducer >= TEST_PRODUCERS || (int64_t)item.nSeq <= m_nLastSeq[item.nProducer])
+				m_nErrors++;
+			else
+				m_nLastSeq[item.nProducer] = item.nSeq;
+			return item.nResult;
+		}
+		case ENGINE_COMMAND_LEAVE_CHANNEL:
+			return ENGINE_OK;
+		case TEST_COMMAND_TEXT:
+			m_strText = command.lpText;
+			return command.nArgs[0];
+		}
+		return ENGINE_ERR_TYPE;
+	}
+
+	bool TakesText(int nType) override
+	{
+		return nType == TEST_COMMAND_TEXT;
+	}
+
+private:
+	std::atomic<bool> m_bBlocked;
+	int64_t m_nLastSeq[TEST_PRODUCERS];
+};
+
+static int g_nErrors = 0;
+
+static void Expect(const char* lpWhat, int nResult, int nExpected)
+{
+	if (nResult == nExpected)
+		return;
+	fprintf(stderr, "%s: %d, expected %d\n", lpWhat, nResult, nExpected);
+	g_nErrors++;
+}
+
+static void TestTickets()
+{
+	CTestQueue queue;
+	TEST_ITEM items[3] = { { 0, 0, ENGINE_OK }, { 0, 1, -4 }, { 0, 2, ENGINE_OK } };
+
+	Expect("post without items", (int)queue.PostItems(items, 0), ENGINE_ERR_INVALID_ARG);
+	Expect("text command without text", (int)queue.PostCommand(TEST_COMMAND_TEXT), ENGINE_ERR_INVALID_ARG);
+	Expect("poll of a ticket never posted", queue.Poll(1), ENGINE_ERR_INVALID_ARG);
+
+	// the executor holds the first command, the rest stay pending behind it
+	queue.Block();
+	int64_t nFirst = queue.PostItems(items, 1);
+	int64_t nBatch = queue.PostItems(items + 1, 2);
+	int64_t nText = queue.PostCommand(TEST_COMMAND_TEXT, "device", -3);
+	int64_t nUnknown = queue.PostCommand(TEST_COMMAND_TEXT + 1);
+	Expect("first ticket", (int)nFirst, 1);
+	Expect("batch ticket", (int)nBatch, 3);
+	Expect("poll while blocked", queue.Poll(nBatch), ENGINE_PENDING);
+	Expect("wait while blocked", queue.Wait(nBatch, 10), ENGINE_ERR_TIMEOUT);
+	queue.Unblock();
+
+	// the failed item skips the one after it, the batch ticket reports the failure
+	Expect("first", queue.Wait(nFirst, -1), ENGINE_OK);
+	Expect("batch", queue.Wait(nBatch, -1), -4);
+	Expect("failed item", queue.Poll(nBatch - 1), -4);
+	Expect("text", queue.Wait(nText, -1), -3);
+	Expect("unknown type", queue.Wait(nUnknown, -1), ENGINE_ERR_TYPE);
+	Expect("executed", queue.m_nExecuted, 4);
+	if (queue.m_strText != "device")
+	{
+		fprintf(stderr, "text: %s\n", queue.m_strText.c_str());
+		g_nErrors++;
+	}
+
+	// a whole ring later the first result slot belongs to an other ticket
+	for (int i = 0; i < ENGINE_COMMAND_CAPACITY; i++)
+		queue.PostLeaveChannel();
+	Expect("leave", queue.RunLeaveChannel(), ENGINE_OK);
+	Expect("expired", queue.Poll(nFirst), ENGINE_ERR_EXPIRED);
+
+	// a stopped queue starts again on the next post
+	queue.Stop();
+	Expect("after stop", queue.RunLeaveChannel(), ENGINE_OK);
+	g_nErrors += queue.m_nErrors;
+}
+
+static void TestProducers(uint32_t nPosts)
+{
+	CTestQueue queue;
+	std::atomic<int> nMismatch(0);
+	std::vector<std::thread> vecProducers;
+	for (uint32_t p = 0; p < TEST_PRODUCERS; p++)
+	{
+		vecProducers.push_back(std::thread([p, nPosts, &queue, &nMismatch] {
+			for (uint32_t i = 0; i < nPosts; i++)
+			{
+				TEST_ITEM item = { p, i, (i % 7) == 0 ? -4 : ENGINE_OK };
+				int64_t nTicket = queue.PostItems(&item, 1);
+				// only every 16th is waited on, a ring of later tickets may expire it meanwhile
+				if ((i & 15) != 0)
+					continue;
+				int nResult = queue.Wait(nTicket, -1);
+				if (nResult != item.nResult && nResult != ENGINE_ERR_EXPIRED)
+					nMismatch++;
+			}
+		}));
+	}
+	for (auto& producer : vecProducers)
+		producer.join();
+	queue.RunLeaveChannel();
+
+	if (nMismatch)
+		fprintf(stderr, "producers: %d tickets with the result of an other item\n", nMismatch.load());
+	Expect("producers executed", queue.m_nExecuted, (int)(nPosts * TEST_PRODUCERS + 1));
+	g_nErrors += nMismatch + queue.m_nErrors;
+}
+
+int main(int argc, char* argv[])
+{
+	uint32_t nPosts = argc > 1 ? (uint32_t)atoi(argv[1]) : 100000;
+	TestTickets();
+	TestProducers(nPosts);
+
+	printf("engine_queue_test: %u posts per producer, %d errors\n", nPosts, g_nErrors);
+	return g_nErrors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
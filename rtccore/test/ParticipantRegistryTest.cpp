@@ -0,0 +1,126 @@
+// participant_registry_test : lock free readers of CParticipantRegistry
+// against the owner adding and removing participants
+//
+//   participant_registry_test [rounds]
+//
+// the reader threads Get and SetStat/GetStat a fixed set of participants
+// while the owner adds a burst of TEST_CHURN_IDS others and removes them
+// again. the removes leave more than PARTICIPANT_TABLE_SIZE / 4 deleted
+// slots, so every round forces a Rebuild under the readers. a reader may
+// miss a participant while it moves, it must never see the view, flags or
+// stats of an other one
+#include "ParticipantRegistry.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define TEST_STABLE_IDS		256
+#define TEST_CHURN_IDS		1536
+#define TEST_READERS		4
+
+static std::atomic<bool> g_bStop(false);
+static std::atomic<int> g_nErrors(0);
+
+static std::string StableId(int nIndex)
+{
+	return "stable-" + std::to_string(nIndex);
+}
+
+static PARTICIPANT_INFO StableInfo(int nIndex)
+{
+	PARTICIPANT_INFO info;
+	info.hView = (void*)(uintptr_t)(nIndex + 1);
+	info.hRenderView = (void*)(uintptr_t)(nIndex + 0x10000);
+	info.nFlags = (uint32_t)nIndex;
+	return info;
+}
+
+// the owner of the stat is in the high bits so a value read from the wrong slot shows
+static int32_t StatValue(int nIndex, int nCount)
+{
+	return (int32_t)((nIndex << 16) | (nCount & 0xffff));
+}
+
+static void Fail(const char* lpWhat, int nIndex)
+{
+	if (g_nErrors.fetch_add(1) < 10)
+		fprintf(stderr, "%s of %s\n", lpWhat, StableId(nIndex).c_str());
+}
+
+static void ReaderProc(int nReader)
+{
+	CParticipantRegistry* lpRegistry = CParticipantRegistry::GetInstance();
+	int nCount = 0;
+	while (!g_bStop.load(std::memory_order_relaxed))
+	{
+		for (int i = nReader; i < TEST_STABLE_IDS; i += TEST_READERS)
+		{
+			std::string strId = StableId(i);
+			PARTICIPANT_INFO info;
+			PARTICIPANT_INFO expected = StableInfo(i);
+			if (lpRegistry->Get(strId, info) && (info.hView != expected.hView || info.hRenderView != expected.hRenderView
+				|| info.nFlags != expected.nFlags))
+				Fail("Get returned the participant of an other id", i);
+
+			lpRegistry->SetStat(strId, PARTICIPANT_STAT_VIDEO_KBPS, StatValue(i, ++nCount));
+			int32_t nValue;
+			if (lpRegistry->GetStat(strId, PARTICIPANT_STAT_VIDEO_KBPS, nValue) && nValue != 0 && (nValue >> 16) != i)
+				Fail("GetStat returned the stat of an other id", i);
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int nRounds = argc > 1 ? atoi(argv[1]) : 100;
+	CParticipantRegistry* lpRegistry = CParticipantRegistry::GetInstance();
+
+	for (int i = 0; i < TEST_STABLE_IDS; i++)
+	{
+		if (!lpRegistry->Add(StableId(i), StableInfo(i)))
+		{
+			fprintf(stderr, "can not add %s\n", StableId(i).c_str());
+			return EXIT_FAILURE;
+		}
+	}
+
+	std::vector<std::thread> vecReaders;
+	for (int i = 0; i < TEST_READERS; i++)
+		vecReaders.push_back(std::thread(ReaderProc, i));
+
+	PARTICIPANT_INFO churnInfo = { (void*)(uintptr_t)0xdead, NULL, 0 };
+	for (int i = 0; i < nRounds; i++)
+	{
+		for (int j = 0; j < TEST_CHURN_IDS; j++)
+			lpRegistry->Add("churn-" + std::to_string(i) + "-" + std::to_string(j), churnInfo);
+		for (int j = 0; j < TEST_CHURN_IDS; j++)
+			lpRegistry->Remove("churn-" + std::to_string(i) + "-" + std::to_string(j));
+	}
+
+	g_bStop = true;
+	for (auto& reader : vecReaders)
+		reader.join();
+
+	// the table is quiet now, every stable participant has to be found with its own stat
+	for (int i = 0; i < TEST_STABLE_IDS; i++)
+	{
+		PARTICIPANT_INFO info;
+		int32_t nValue;
+		if (!lpRegistry->Get(StableId(i), info) || info.hView != StableInfo(i).hView)
+			Fail("Get lost", i);
+		else if (!lpRegistry->GetStat(StableId(i), PARTICIPANT_STAT_VIDEO_KBPS, nValue) || (nValue != 0 && (nValue >> 16) != i))
+			Fail("GetStat lost", i);
+	}
+	if (lpRegistry->GetCount() != TEST_STABLE_IDS)
+	{
+		fprintf(stderr, "%d participants, expected %d\n", lpRegistry->GetCount(), TEST_STABLE_IDS);
+		g_nErrors++;
+	}
+
+	printf("participant_registry_test: %d rounds, %d errors\n", nRounds, g_nErrors.load());
+	return g_nErrors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
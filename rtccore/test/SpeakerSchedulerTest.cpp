@@ -0,0 +1,111 @@
+// speaker_scheduler_test : view scheduling of CSpeakerScheduler
+//
+//   speaker_scheduler_test
+//
+// two views and scripted level reports: a loud waiting speaker has to get a
+// view only after the hold time and only past the margin, ties go to the
+// earlier arrival, and a shown speaker that stops talking fades out
+#include "SpeakerScheduler.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+typedef std::vector<std::pair<std::string, float>> LEVELS;
+typedef std::vector<std::pair<std::string, std::string>> SWAPS;
+
+static int g_nErrors = 0;
+
+static void Check(const char* lpWhat, bool bOk)
+{
+	if (bOk)
+		return;
+	fprintf(stderr, "%s\n", lpWhat);
+	g_nErrors++;
+}
+
+// the same report n times, one SPEAKER_REPORT_INTERVAL_MS apart
+static void Report(CSpeakerScheduler& scheduler, const LEVELS& vecLevels, int nCount)
+{
+	for (int i = 0; i < nCount; i++)
+		scheduler.UpdateLevels(vecLevels);
+}
+
+static void TestHoldAndMargin()
+{
+	CSpeakerScheduler scheduler;
+	scheduler.Add("a", true, 0);
+	scheduler.Add("b", true, 0);
+	scheduler.Add("c", false, 0);
+	scheduler.Add("a", false, 0);
+	Check("Add of a known participant changed it", !scheduler.IsWaiting("a"));
+
+	// c speaks, a and b are silent, but they have not held their views long enough
+	Report(scheduler, { { "c", 80.0f } }, 10);
+	SWAPS vecSwaps;
+	scheduler.Schedule(SPEAKER_MIN_HOLD_MS - 1, vecSwaps);
+	Check("swapped before the hold time", vecSwaps.empty());
+
+	// b loses the tie of two silent views, it arrived later
+	scheduler.Schedule(SPEAKER_MIN_HOLD_MS, vecSwaps);
+	Check("no swap after the hold time", vecSwaps.size() == 1);
+	if (vecSwaps.size() == 1)
+		Check("swap is not (b, c)", vecSwaps[0].first == "b" && vecSwaps[0].second == "c");
+	Check("b not waiting or c not shown", scheduler.IsWaiting("b") && !scheduler.IsWaiting("c"));
+
+	// b is loud again, c just got its view and keeps it, the silent a gives its view up
+	Report(scheduler, { { "b", 100.0f } }, 10);
+	vecSwaps.clear();
+	scheduler.Schedule(SPEAKER_MIN_HOLD_MS + 100, vecSwaps);
+	Check("swapped a view before it was held", vecSwaps.size() == 1 && vecSwaps[0].first == "a" && vecSwaps[0].second == "b");
+}
+
+static void TestMargin()
+{
+	CSpeakerScheduler scheduler;
+	scheduler.Add("shown", true, 0);
+	scheduler.Add("waiting", false, 0);
+
+	// both settle close to their level, the waiting one is louder but within the margin
+	Report(scheduler, { { "shown", 40.0f }, { "waiting", (float)(40.0 + SPEAKER_SWITCH_MARGIN - 5) } }, 50);
+	SWAPS vecSwaps;
+	scheduler.Schedule(SPEAKER_MIN_HOLD_MS * 10, vecSwaps);
+	Check("swapped within the margin", vecSwaps.empty());
+
+	Report(scheduler, { { "shown", 40.0f }, { "waiting", (float)(40.0 + SPEAKER_SWITCH_MARGIN + 5) } }, 50);
+	scheduler.Schedule(SPEAKER_MIN_HOLD_MS * 10, vecSwaps);
+	Check("no swap past the margin", vecSwaps.size() == 1);
+}
+
+static void TestPickWaiting()
+{
+	CSpeakerScheduler scheduler;
+	std::string strKey;
+	Check("picked from nobody", !scheduler.PickWaiting(0, strKey));
+
+	scheduler.Add("first", false, 0);
+	scheduler.Add("second", false, 0);
+	scheduler.Add("loud", false, 0);
+	Report(scheduler, { { "loud", 50.0f }, { "first", 10.0f }, { "second", 10.0f } }, 5);
+
+	Check("loud not picked", scheduler.PickWaiting(0, strKey) && strKey == "loud");
+	Check("first not picked on the tie", scheduler.PickWaiting(0, strKey) && strKey == "first");
+	Check("second not picked", scheduler.PickWaiting(0, strKey) && strKey == "second");
+	Check("picked twice", !scheduler.PickWaiting(0, strKey));
+
+	scheduler.Remove("loud");
+	Check("removed is known", !scheduler.IsKnown("loud"));
+	scheduler.Clear();
+	Check("cleared is known", !scheduler.IsKnown("first"));
+}
+
+int main()
+{
+	TestHoldAndMargin();
+	TestMargin();
+	TestPickWaiting();
+
+	printf("speaker_scheduler_test: %d errors\n", g_nErrors);
+	return g_nErrors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,71 @@
+// stats_recorder_test : writes stats recordings with known values for
+// stats_roundtrip.py to read back through stats_csv.py
+//
+//   stats_recorder_test uid_output name_output [samples]
+//
+// a backend keys its samples either by number or by name, so there are two
+// recordings: kind 1 keyed by uid with an integer, a negative and a double
+// column like agora, kind 2 keyed by a stream id like zego. sample i of a
+// kind holds the values stats_roundtrip.py expects for i
+#include "StatsRecorder.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+static const STATS_SCHEMA g_schemas[] = {
+	{ 1, "video", "uid", { STATS_I("width"), STATS_I("delta"), STATS_D("fps"), { NULL, 0 } } },
+	{ 2, "stream", "stream_id", { STATS_I("kbps"), { NULL, 0 } } },
+};
+
+static const STATS_SCHEMA_SET g_schemaSet = { "test", g_schemas, sizeof(g_schemas) / sizeof(g_schemas[0]) };
+
+// one recording of nSamples samples of nKind, 0 when every sample was written
+static int Record(const char* lpPath, int nKind, int nSamples)
+{
+	CStatsRecorder* lpRecorder = CStatsRecorder::GetInstance();
+	if (lpRecorder->Start(lpPath, g_schemaSet) != 0)
+	{
+		fprintf(stderr, "can not start recording to %s\n", lpPath);
+		return -1;
+	}
+
+	STATS_SAMPLE sample;
+	for (int i = 0; i < nSamples; i++)
+	{
+		if (nKind == 1)
+		{
+			CStatsRecorder::Init(sample, 1, (uint32_t)(i % 3));
+			sample.nValues[0] = 640 + i;
+			sample.nValues[1] = -i * 1000;
+			sample.nValues[2] = CStatsRecorder::Scale(i * 0.5);
+		}
+		else
+		{
+			CStatsRecorder::Init(sample, 2, "stream-" + std::to_string(i % 2));
+			sample.nValues[0] = i * 1000 + 7;
+		}
+		lpRecorder->Record(sample);
+	}
+
+	int64_t nWritten = lpRecorder->Stop();
+	if (nWritten != nSamples)
+	{
+		fprintf(stderr, "%s: %lld samples written, expected %d\n", lpPath, (long long)nWritten, nSamples);
+		return -1;
+	}
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		fprintf(stderr, "usage: stats_recorder_test uid_output name_output [samples]\n");
+		return EXIT_FAILURE;
+	}
+	int nSamples = argc > 3 ? atoi(argv[3]) : 100;
+
+	if (Record(argv[1], 1, nSamples) != 0 || Record(argv[2], 2, nSamples) != 0)
+		return EXIT_FAILURE;
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,213 @@
+// video_compositor_test : CImageScaler planes and the CVideoCompositor gallery
+//
+//   video_compositor_test
+//
+// the scaler has to keep a flat plane flat through the SIMD columns and the
+// tails, halve a plane like the rounding of the C tail, stay between the
+// source values when it interpolates and never write outside the target.
+// the compositor gets frames of two registered participants and has to fit
+// them into their tiles, report the changed tiles, drop the frames without
+// a view and blank a tile that went stale
+#include "AGExtInfoManager.h"
+#include "ImageScaler.h"
+#include "ParticipantRegistry.h"
+#include "VideoCompositor.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#define TEST_SENTINEL		0xa5
+
+static int g_nErrors = 0;
+
+static void Fail(const char* lpWhat, int nValue)
+{
+	if (g_nErrors++ < 10)
+		fprintf(stderr, "%s: %d\n", lpWhat, nValue);
+}
+
+// scales a flat source into the middle of a sentinel canvas with a wider stride
+static void TestFlat(int nSrcWidth, int nSrcHeight, int nDstWidth, int nDstHeight)
+{
+	std::vector<BYTE> vecSrc((size_t)nSrcWidth * nSrcHeight, 77);
+	int nStride = nDstWidth + 32;
+	std::vector<BYTE> vecCanvas((size_t)nStride * (nDstHeight + 2), TEST_SENTINEL);
+	BYTE* lpDst = vecCanvas.data() + nStride + 16;
+	CImageScaler::ScalePlane(vecSrc.data(), nSrcWidth, nSrcWidth, nSrcHeight, lpDst, nStride, nDstWidth, nDstHeight);
+
+	for (int y = 0; y < nDstHeight + 2; y++)
+	{
+		for (int x = 0; x < nStride; x++)
+		{
+			bool bInside = y >= 1 && y <= nDstHeight && x >= 16 && x < 16 + nDstWidth;
+			BYTE nValue = vecCanvas[(size_t)y * nStride + x];
+			if (bInside && nValue != 77)
+				Fail("flat plane changed", nValue);
+			else if (!bInside && nValue != TEST_SENTINEL)
+				Fail("written outside the target", nSrcWidth * 10000 + nDstWidth);
+		}
+	}
+}
+
+static void TestHalve()
+{
+	// 2x2 blocks of a, b / c, d with every combination the low bits can round
+	int nWidth = 70, nHeight = 6;
+	std::vector<BYTE> vecSrc((size_t)nWidth * nHeight);
+	for (size_t i = 0; i < vecSrc.size(); i++)
+		vecSrc[i] = (BYTE)((i * 37 + i / nWidth * 11) & 0xff);
+	std::vector<BYTE> vecDst((size_t)(nWidth / 2) * (nHeight / 2));
+	CImageScaler::ScalePlane(vecSrc.data(), nWidth, nWidth, nHeight, vecDst.data(), nWidth / 2, nWidth / 2, nHeight / 2);
+
+	for (int y = 0; y < nHeight / 2; y++)
+	{
+		for (int x = 0; x < nWidth / 2; x++)
+		{
+			const BYTE* lpRow0 = vecSrc.data() + (size_t)y * 2 * nWidth + 2 * x;
+			const BYTE* lpRow1 = lpRow0 + nWidth;
+			int nLeft = (lpRow0[0] + lpRow1[0] + 1) >> 1;
+			int nRight = (lpRow0[1] + lpRow1[1] + 1) >> 1;
+			int nExpected = (nLeft + nRight + 1) >> 1;
+			if (vecDst[(size_t)y * (nWidth / 2) + x] != nExpected)
+				Fail("halved pixel differs from the C rounding at x", x);
+		}
+	}
+}
+
+static void TestBilinear()
+{
+	// a horizontal ramp scaled up stays a ramp between its end values
+	int nSrcWidth = 40, nDstWidth = 133, nHeight = 3;
+	std::vector<BYTE> vecSrc((size_t)nSrcWidth * nHeight);
+	for (int y = 0; y < nHeight; y++)
+		for (int x = 0; x < nSrcWidth; x++)
+			vecSrc[(size_t)y * nSrcWidth + x] = (BYTE)(20 + x * 5);
+	std::vector<BYTE> vecDst((size_t)nDstWidth * 7);
+	CImageScaler::ScalePlane(vecSrc.data(), nSrcWidth, nSrcWidth, nHeight, vecDst.data(), nDstWidth, nDstWidth, 7);
+
+	for (int y = 0; y < 7; y++)
+	{
+		const BYTE* lpRow = vecDst.data() + (size_t)y * nDstWidth;
+		for (int x = 0; x < nDstWidth; x++)
+		{
+			if (lpRow[x] < 20 || lpRow[x] > 20 + (nSrcWidth - 1) * 5)
+				Fail("interpolated outside the source values", lpRow[x]);
+			if (x > 0 && lpRow[x] < lpRow[x - 1])
+				Fail("ramp goes back at x", x);
+		}
+	}
+}
+
+// a frame of one Y, U and V value each
+struct TEST_FRAME
+{
+	int nWidth, nHeight;
+	std::vector<BYTE> vecY, vecU, vecV;
+
+	TEST_FRAME(int w, int h, BYTE y, BYTE u, BYTE v)
+		: nWidth(w), nHeight(h), vecY((size_t)w * h, y), vecU((size_t)w * h / 4, u), vecV((size_t)w * h / 4, v)
+	{
+	}
+};
+
+static void Put(const char* lpId, const TEST_FRAME& frame)
+{
+	CVideoCompositor::GetInstance()->PutFrame(lpId, frame.vecY.data(), frame.nWidth, frame.vecU.data(), frame.nWidth / 2,
+		frame.vecV.data(), frame.nWidth / 2, frame.nWidth, frame.nHeight);
+}
+
+static void TestCompositor()
+{
+	CVideoCompositor* lpCompositor = CVideoCompositor::GetInstance();
+	CParticipantRegistry* lpRegistry = CParticipantRegistry::GetInstance();
+	CAGExtInfoManager* lpViews = CAGExtInfoManager::GetAGExtInfoManager();
+
+	// tile i is the i-th view added
+	VHANDLE hViews[2] = { (VHANDLE)0x100, (VHANDLE)0x200 };
+	lpViews->AddView(hViews[0]);
+	lpViews->AddView(hViews[1]);
+	PARTICIPANT_INFO info = { hViews[0], NULL, 0 };
+	lpRegistry->Add("p0", info);
+	info.hView = hViews[1];
+	lpRegistry->Add("p1", info);
+
+	if (lpCompositor->Start(0, 2, 64, 48) || lpCompositor->Start(COMPOSITOR_MAX_TILES + 1, 1, 2, 2))
+		Fail("started a bad gallery", 0);
+	if (!lpCompositor->Start(2, 2, 64, 48))
+	{
+		Fail("can not start the gallery", 0);
+		return;
+	}
+
+	COMPOSITOR_RECT rects[4];
+	if (lpCompositor->Composite(rects, 4) != 0)
+		Fail("a new gallery has changed tiles", 0);
+
+	// 16:9 into 64x48 is 64x36 at y 6 of the first tile
+	Put("p0", TEST_FRAME(320, 180, 200, 50, 150));
+	Put("nobody", TEST_FRAME(320, 180, 200, 50, 150));
+	int nRects = lpCompositor->Composite(rects, 4);
+	if (nRects != 1 || rects[0].nX != 0 || rects[0].nY != 0 || rects[0].nWidth != 64 || rects[0].nHeight != 48)
+		Fail("rects after the first frame", nRects);
+	if (lpCompositor->GetFrameCount() != 1 || lpCompositor->GetDroppedCount() != 1)
+		Fail("frames and drops after the first frame", (int)lpCompositor->GetDroppedCount());
+
+	int nWidth = 0, nHeight = 0;
+	const BYTE* lpSurface = lpCompositor->GetSurface(nWidth, nHeight);
+	if (lpSurface == NULL || nWidth != 128 || nHeight != 96)
+	{
+		Fail("surface size", nWidth);
+		return;
+	}
+	const BYTE* lpU = lpSurface + nWidth * nHeight;
+	for (int y = 0; y < 48; y++)
+	{
+		BYTE nExpected = y >= 6 && y < 42 ? 200 : COMPOSITOR_BLACK_Y;
+		if (lpSurface[y * nWidth + 10] != nExpected)
+			Fail("luma of the first tile at y", y);
+		if (lpSurface[y * nWidth + 64 + 10] != COMPOSITOR_BLACK_Y)
+			Fail("second tile not black at y", y);
+	}
+	if (lpU[10 * (nWidth / 2) + 5] != 50 || lpU[1 * (nWidth / 2) + 5] != COMPOSITOR_BLACK_UV)
+		Fail("chroma of the first tile", lpU[10 * (nWidth / 2) + 5]);
+
+	// more changed tiles than rects become the whole gallery
+	Put("p0", TEST_FRAME(64, 48, 100, 128, 128));
+	Put("p1", TEST_FRAME(64, 48, 100, 128, 128));
+	nRects = lpCompositor->Composite(rects, 1);
+	if (nRects != 1 || rects[0].nWidth != nWidth || rects[0].nHeight != nHeight)
+		Fail("rects past nMaxRects", nRects);
+	if (lpCompositor->Composite(rects, 4) != 0)
+		Fail("tiles changed without a frame", 0);
+
+	// the participants stop sending, their tiles go black
+	std::this_thread::sleep_for(std::chrono::milliseconds(COMPOSITOR_STALE_MS + 100));
+	nRects = lpCompositor->Composite(rects, 4);
+	lpSurface = lpCompositor->GetSurface(nWidth, nHeight);
+	if (nRects != 2 || lpSurface[20 * nWidth + 10] != COMPOSITOR_BLACK_Y)
+		Fail("stale tiles", nRects);
+
+	lpCompositor->Stop();
+	if (lpCompositor->GetSurface(nWidth, nHeight) != NULL || lpCompositor->Composite(rects, 4) != 0)
+		Fail("stopped gallery", 0);
+	Put("p0", TEST_FRAME(64, 48, 100, 128, 128));
+	lpRegistry->Clear();
+}
+
+int main()
+{
+	// the SIMD columns are 16 wide, the odd sizes leave a tail
+	TestFlat(640, 360, 64, 36);
+	TestFlat(333, 101, 47, 13);
+	TestFlat(50, 30, 133, 77);
+	TestFlat(64, 48, 64, 48);
+	TestHalve();
+	TestBilinear();
+	TestCompositor();
+
+	printf("video_compositor_test: simd %d, %d errors\n", CImageScaler::HasSimd() ? 1 : 0, g_nErrors);
+	return g_nErrors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
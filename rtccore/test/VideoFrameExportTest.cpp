@@ -0,0 +1,195 @@
+// video_frame_export_test : the seqlock rings of CVideoFrameExport
+//
+//   video_frame_export_test [frames]
+//
+// a render thread puts numbered frames, every plane filled with a value
+// derived from the number, while a reader maps the block by its name like
+// frame_ring.py and copies the newest slot under the seqlock. a copy the
+// seqlock accepts must hold one frame: its planes, number and size agree.
+// then the scaling of a large frame, the sampling interval and Stop
+#include "VideoFrameExport.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define TEST_WIDTH		64
+#define TEST_HEIGHT		48
+#define TEST_SLOTS		4
+
+static std::atomic<int> g_nErrors(0);
+
+static void Fail(const char* lpWhat, long long nValue)
+{
+	if (g_nErrors.fetch_add(1) < 10)
+		fprintf(stderr, "%s: %lld\n", lpWhat, nValue);
+}
+
+// a read only mapping of a block, as a reader in an other process gets it
+static const BYTE* MapBlock(const std::string& strName, size_t nSize)
+{
+#ifdef _WIN32
+	HANDLE hMapping = OpenFileMappingA(FILE_MAP_READ, FALSE, ("Local\\" + strName).c_str());
+	return hMapping != NULL ? (const BYTE*)MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, nSize) : NULL;
+#else
+	int fd = open(("/dev/shm/" + strName).c_str(), O_RDONLY);
+	if (fd < 0)
+		return NULL;
+	void* lpData = mmap(NULL, nSize, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	return lpData != MAP_FAILED ? (const BYTE*)lpData : NULL;
+#endif
+}
+
+static std::string FirstName()
+{
+	std::string strNames = CVideoFrameExport::GetInstance()->GetNames();
+	return strNames.substr(0, strNames.find('\n'));
+}
+
+static void PutFrame(const std::string& strId, int nWidth, int nHeight, BYTE nValue)
+{
+	std::vector<BYTE> vecFrame((size_t)nWidth * nHeight * 3 / 2);
+	BYTE* lpY = vecFrame.data();
+	BYTE* lpU = lpY + (size_t)nWidth * nHeight;
+	BYTE* lpV = lpU + (size_t)nWidth * nHeight / 4;
+	memset(lpY, nValue, (size_t)nWidth * nHeight);
+	memset(lpU, (BYTE)(nValue + 1), (size_t)nWidth * nHeight / 4);
+	memset(lpV, (BYTE)(nValue + 2), (size_t)nWidth * nHeight / 4);
+	CVideoFrameExport::GetInstance()->PutFrame(strId, lpY, nWidth, lpU, nWidth / 2, lpV, nWidth / 2, nWidth, nHeight);
+}
+
+static void TestSeqlock(const std::string& strPrefix, uint64_t nFrames)
+{
+	CVideoFrameExport* lpExport = CVideoFrameExport::GetInstance();
+	if (!lpExport->Start(strPrefix.c_str(), TEST_WIDTH, TEST_HEIGHT, 0, TEST_SLOTS))
+	{
+		Fail("can not start", 0);
+		return;
+	}
+	PutFrame("reader", TEST_WIDTH, TEST_HEIGHT, 0);
+
+	const FRAME_EXPORT_HEADER* lpHeader = (const FRAME_EXPORT_HEADER*)MapBlock(FirstName(), sizeof(FRAME_EXPORT_HEADER));
+	if (lpHeader == NULL || lpHeader->nMagic != FRAME_EXPORT_MAGIC || lpHeader->nSlots != TEST_SLOTS
+		|| strcmp(lpHeader->szId, "reader") != 0)
+	{
+		Fail("no block header", 0);
+		lpExport->Stop();
+		return;
+	}
+	size_t nBlockSize = lpHeader->nHeaderSize + (size_t)lpHeader->nSlotSize * lpHeader->nSlots;
+	const BYTE* lpBlock = MapBlock(FirstName(), nBlockSize);
+	lpHeader = (const FRAME_EXPORT_HEADER*)lpBlock;
+
+	std::atomic<bool> bDone(false);
+	std::thread writer([nFrames, &bDone] {
+		for (uint64_t i = 1; i < nFrames; i++)
+			PutFrame("reader", TEST_WIDTH, TEST_HEIGHT, (BYTE)i);
+		bDone = true;
+	});
+
+	// the copy of the slot, taken the way frame_ring.py takes it
+	std::vector<BYTE> vecCopy(lpHeader->nSlotSize);
+	uint64_t nAccepted = 0;
+	while (!bDone)
+	{
+		uint64_t nFrame = lpHeader->nFrames.load(std::memory_order_acquire) - 1;
+		const BYTE* lpSlotData = lpBlock + lpHeader->nHeaderSize + (size_t)lpHeader->nSlotSize * (nFrame % lpHeader->nSlots);
+		const FRAME_EXPORT_SLOT* lpSlot = (const FRAME_EXPORT_SLOT*)lpSlotData;
+		uint64_t nSeq = lpSlot->nSeq.load(std::memory_order_acquire);
+		if (nSeq & 1)
+			continue;
+		memcpy(vecCopy.data(), lpSlotData, vecCopy.size());
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (lpSlot->nSeq.load(std::memory_order_relaxed) != nSeq)
+			continue;
+
+		const FRAME_EXPORT_SLOT* lpCopy = (const FRAME_EXPORT_SLOT*)vecCopy.data();
+		if (lpCopy->nFrame < nFrame || lpCopy->nWidth != TEST_WIDTH || lpCopy->nHeight != TEST_HEIGHT)
+		{
+			Fail("slot header of an other frame", (long long)lpCopy->nFrame);
+			continue;
+		}
+		const BYTE* lpY = vecCopy.data() + sizeof(FRAME_EXPORT_SLOT);
+		size_t nLuma = (size_t)TEST_WIDTH * TEST_HEIGHT;
+		BYTE nValue = (BYTE)lpCopy->nFrame;
+		for (size_t i = 0; i < nLuma * 3 / 2; i++)
+		{
+			if (lpY[i] != (BYTE)(nValue + (i < nLuma ? 0 : i < nLuma * 5 / 4 ? 1 : 2)))
+			{
+				Fail("torn frame accepted", (long long)lpCopy->nFrame);
+				break;
+			}
+		}
+		nAccepted++;
+	}
+	writer.join();
+
+	if (lpHeader->nFrames.load() != nFrames)
+		Fail("frames in the header", (long long)lpHeader->nFrames.load());
+	if (nAccepted == 0)
+		Fail("the reader never got a frame", 0);
+	lpExport->Stop();
+	if (lpHeader->nClosed != 1)
+		Fail("block not closed by Stop", lpHeader->nClosed);
+	printf("video_frame_export_test: %llu frames, %llu read\n", (unsigned long long)nFrames, (unsigned long long)nAccepted);
+}
+
+static void TestScaleAndInterval(const std::string& strPrefix)
+{
+	CVideoFrameExport* lpExport = CVideoFrameExport::GetInstance();
+	if (lpExport->Start("bad/prefix", 320, 240, 0, TEST_SLOTS) || lpExport->Start(strPrefix.c_str(), 320, 240, 0, 1))
+		Fail("started with a bad argument", 0);
+	if (!lpExport->Start(strPrefix.c_str(), 320, 240, 60000, TEST_SLOTS))
+	{
+		Fail("can not start", 0);
+		return;
+	}
+
+	// the first frame is sampled, the next ones wait for the interval
+	PutFrame("large", 1920, 1080, 9);
+	PutFrame("large", 1920, 1080, 10);
+	const FRAME_EXPORT_HEADER* lpHeader = (const FRAME_EXPORT_HEADER*)MapBlock(FirstName(), sizeof(FRAME_EXPORT_HEADER));
+	if (lpHeader == NULL)
+	{
+		Fail("no block", 0);
+		lpExport->Stop();
+		return;
+	}
+	const BYTE* lpBlock = MapBlock(FirstName(), lpHeader->nHeaderSize + (size_t)lpHeader->nSlotSize * lpHeader->nSlots);
+	const FRAME_EXPORT_SLOT* lpSlot = (const FRAME_EXPORT_SLOT*)(lpBlock + lpHeader->nHeaderSize);
+	if (lpHeader->nFrames.load() != 1 || lpExport->GetFrameCount() != 1)
+		Fail("frames within the interval", (long long)lpHeader->nFrames.load());
+	if (lpSlot->nWidth != 320 || lpSlot->nHeight != 180 || lpSlot->nSourceWidth != 1920 || lpSlot->nSourceHeight != 1080)
+		Fail("scaled size", lpSlot->nWidth * 10000 + lpSlot->nHeight);
+	else if (((const BYTE*)(lpSlot + 1))[320 * 90] != 9)
+		Fail("scaled luma", ((const BYTE*)(lpSlot + 1))[320 * 90]);
+	lpExport->Stop();
+}
+
+int main(int argc, char* argv[])
+{
+	uint64_t nFrames = argc > 1 ? (uint64_t)atoll(argv[1]) : 200000;
+#ifdef _WIN32
+	std::string strPrefix = "rtctest" + std::to_string(_getpid());
+#else
+	std::string strPrefix = "rtctest" + std::to_string(getpid());
+#endif
+	TestSeqlock(strPrefix, nFrames);
+	TestScaleAndInterval(strPrefix + "-scale");
+
+	printf("video_frame_export_test: %d errors\n", g_nErrors.load());
+	return g_nErrors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
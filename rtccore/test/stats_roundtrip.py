@@ -0,0 +1,79 @@
+'''
+round trip of CStatsRecorder through stats_csv.py, run by ctest:
+    python stats_roundtrip.py path/to/stats_recorder_test
+the test program records known samples keyed by uid and by name,
+stats_csv.read has to give every one of them back in order, and a copy cut
+inside the last block has to read up to the block before it
+'''
+import os
+import subprocess
+import sys
+import tempfile
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", ".."))
+import stats_csv
+
+SAMPLES = 100
+
+
+def expect(name, i):
+    # the values stats_recorder_test writes for sample i
+    if name == "video":
+        return [i % 3, 640 + i, -i * 1000, i * 0.5]
+    return ["stream-%d" % (i % 2), i * 1000 + 7]
+
+
+def check(header, name, kind, count):
+    rows = header["kinds"][kind]["rows"]
+    if len(rows) != count:
+        return ["%s: %d rows, expected %d" % (name, len(rows), count)]
+    errors = []
+    last = None
+    for i, row in enumerate(rows):
+        if row[1:] != expect(name, i):
+            errors.append("%s row %d: %r, expected %r" % (name, i, row[1:], expect(name, i)))
+        if last is not None and row[0] < last:
+            errors.append("%s row %d: unix_us goes back" % (name, i))
+        last = row[0]
+    return errors
+
+
+def roundtrip(tmp, path, name, kind):
+    errors = []
+    header, dropped = stats_csv.read(path)
+    if header["vendor"] != "test":
+        errors.append("%s: vendor %r" % (name, header["vendor"]))
+    if dropped:
+        errors.append("%s: %d dropped" % (name, dropped))
+    errors += check(header, name, kind, SAMPLES)
+
+    # a killed recorder leaves a partial block, the whole ones before it still read
+    with open(path, "rb") as f:
+        data = f.read()
+    cut = os.path.join(tmp, "cut.stats")
+    with open(cut, "wb") as f:
+        f.write(data[:-1])
+    header, _ = stats_csv.read(cut)
+    count = len(header["kinds"][kind]["rows"])
+    if count >= SAMPLES:
+        errors.append("cut %s: %d rows" % (name, count))
+    else:
+        errors += ["cut " + e for e in check(header, name, kind, count)]
+    return errors
+
+
+def main():
+    with tempfile.TemporaryDirectory() as tmp:
+        uid_path = os.path.join(tmp, "uid.stats")
+        name_path = os.path.join(tmp, "name.stats")
+        subprocess.check_call([sys.argv[1], uid_path, name_path, str(SAMPLES)])
+        errors = roundtrip(tmp, uid_path, "video", 1) + roundtrip(tmp, name_path, "stream", 2)
+
+    for error in errors:
+        print(error)
+    print("stats_roundtrip: %d samples per kind, %d errors" % (SAMPLES, len(errors)))
+    return 1 if errors else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -1,15 +1,41 @@
-import os
-import subprocess
-import time
+import argparse
+import sys
+import tempfile
 
-processes = []
+import fleet
+from fleet import FleetLauncher
+
+parser = argparse.ArgumentParser(description="start a fleet of robots")
+parser.add_argument("script", nargs="?", default="zego.py", help="robot script, agora.py or zego.py")
+parser.add_argument("-n", "--count", type=int, default=6, help="number of robots")
+parser.add_argument("-r", "--rate", type=float, default=2.0, help="ramp rate, robots started per second")
+parser.add_argument("-p", "--max-pending", type=int, default=4, help="max robots still waiting for their join, 0 for no limit")
+parser.add_argument("-t", "--timeout", type=float, default=60, help="seconds to wait for the fleet after the last spawn")
+parser.add_argument("--churn", type=int, default=0, metavar="CYCLES", help="join/leave churn benchmark, CYCLES per robot")
+parser.add_argument("--hold", type=int, default=1000, help="ms every churn cycle stays in the channel")
+args = parser.parse_args()
+
+if args.churn > 0:
+    # robots never report READY in churn mode, they just exit when done
+    outdir = tempfile.mkdtemp(prefix="churn_")
+    launcher = FleetLauncher([sys.executable, args.script], args.count, args.rate, 0, args.timeout)
+    try:
+        launcher.launch({fleet.CHURN_ENV: "%d:%d:%s" % (args.churn, args.hold, outdir)})
+        # the spawn timeout would kill a long run and lose its histograms
+        launcher.wait_exit(fleet.churn_duration(args.churn, args.hold) + args.timeout)
+        fleet.report_churn(outdir)
+        print("histograms in " + outdir)
+    finally:
+        launcher.kill()
+    sys.exit(0)
+
+launcher = FleetLauncher([sys.executable, args.script], args.count, args.rate, args.max_pending, args.timeout)
 try:
-    for i in range(6):
-        processes.append(subprocess.Popen(["python.exe", "zego.py"]))
-        time.sleep(5)
+    launcher.launch()
+    launcher.report()
+    # every robot waits on the barrier before it starts pushing media
+    launcher.release()
 
     a = input()
 finally:
-    for i in range(len(processes)):
-        processes[i].kill()
-
+    launcher.kill()
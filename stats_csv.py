@@ -0,0 +1,150 @@
+'''
+turns a stats recording of startStatsRecording/stopStatsRecording
+(agoradl/src/StatsRecorder.cpp, zegodl/src/StatsRecorder.cpp) into one csv
+per kind, e.g.
+    python stats_csv.py soak.stats soak
+writes soak.local_video.csv, soak.remote_video.csv, ... with the columns
+unix_us, the key (uid or stream id) and the fields of the kind.
+a file cut short by a killed process is read up to its last whole block
+'''
+import argparse
+import csv
+import sys
+
+MAGIC = b"RTCSTATS"
+VERSION = 1
+
+BLOCK_KEY = 1
+BLOCK_SAMPLES = 2
+BLOCK_DROPPED = 3
+
+
+class Truncated(Exception):
+    pass
+
+
+class Reader(object):
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def u8(self):
+        if self.pos >= len(self.data):
+            raise Truncated()
+        value = self.data[self.pos]
+        self.pos += 1
+        return value
+
+    def varint(self):
+        value = 0
+        shift = 0
+        while True:
+            byte = self.u8()
+            value |= (byte & 0x7f) << shift
+            if byte < 0x80:
+                return value
+            shift += 7
+
+    def delta(self):
+        value = self.varint()
+        return (value >> 1) ^ -(value & 1)
+
+    def string(self):
+        size = self.varint()
+        if self.pos + size > len(self.data):
+            raise Truncated()
+        value = self.data[self.pos:self.pos + size].decode("utf-8", "replace")
+        self.pos += size
+        return value
+
+    def i64(self):
+        if self.pos + 8 > len(self.data):
+            raise Truncated()
+        value = int.from_bytes(self.data[self.pos:self.pos + 8], "little", signed=True)
+        self.pos += 8
+        return value
+
+    def column(self, count):
+        values = []
+        prev = 0
+        for _ in range(count):
+            prev += self.delta()
+            values.append(prev)
+        return values
+
+
+def read_header(reader):
+    if reader.data[:len(MAGIC)] != MAGIC:
+        raise ValueError("not a stats recording")
+    reader.pos = len(MAGIC)
+    version = reader.u8()
+    if version != VERSION:
+        raise ValueError("stats file version %d, stats_csv.py reads %d" % (version, VERSION))
+    header = {"vendor": reader.string(), "steady_start": reader.i64(), "wall_start": reader.i64(), "kinds": {}}
+    for _ in range(reader.u8()):
+        kind = reader.u8()
+        name = reader.string()
+        key_name = reader.string()
+        fields = []
+        for _ in range(reader.u8()):
+            fields.append((reader.string(), reader.varint()))
+        header["kinds"][kind] = {"name": name, "key": key_name, "fields": fields, "rows": []}
+    return header
+
+
+def read(path):
+    with open(path, "rb") as f:
+        reader = Reader(f.read())
+    header = read_header(reader)
+    kinds = header["kinds"]
+    names = {}
+    dropped = 0
+    try:
+        while reader.pos < len(reader.data):
+            block = reader.u8()
+            if block == BLOCK_KEY:
+                key = reader.varint()
+                names[key] = reader.string()
+            elif block == BLOCK_DROPPED:
+                dropped += reader.varint()
+            elif block == BLOCK_SAMPLES:
+                kind = kinds[reader.u8()]
+                count = reader.varint()
+                times = reader.column(count)
+                keys = reader.column(count)
+                columns = []
+                for _, scale in kind["fields"]:
+                    values = reader.column(count)
+                    columns.append(values if scale == 1 else [v / float(scale) for v in values])
+                for i in range(count):
+                    unix_us = header["wall_start"] + times[i] - header["steady_start"]
+                    kind["rows"].append([unix_us, names.get(keys[i], keys[i])] + [c[i] for c in columns])
+            else:
+                raise ValueError("unknown block %d at %d" % (block, reader.pos - 1))
+    except Truncated:
+        print("%s: cut short, the last block is incomplete" % path, file=sys.stderr)
+    return header, dropped
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("stats", help="file written by startStatsRecording")
+    parser.add_argument("prefix", help="csv files are written as <prefix>.<kind>.csv")
+    args = parser.parse_args()
+
+    header, dropped = read(args.stats)
+    for kind in header["kinds"].values():
+        if not kind["rows"]:
+            continue
+        path = "%s.%s.csv" % (args.prefix, kind["name"])
+        with open(path, "w", newline="") as f:
+            writer = csv.writer(f)
+            writer.writerow(["unix_us", kind["key"]] + [name for name, _ in kind["fields"]])
+            writer.writerows(kind["rows"])
+        print("%s: %d rows" % (path, len(kind["rows"])))
+    if dropped:
+        print("%d samples dropped, the recorder ring was full" % dropped)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,133 @@
+'''
+encoder config sweep: publishes the deterministic source of ab_bench.py
+once for every cell of a matrix of video profiles and audio presets/codecs
+and puts what each cell achieved into one table, e.g.
+    python sweep_bench.py --backend zego -d 20 \
+        --profiles 640x480@15:600,640x480@15:1000,1280x720@30:2000 \
+        --audio-profiles 0,1,3 --audio-codecs default,1 -o sweep.csv
+a cell runs like one backend of ab_bench.py, by default a single robot
+that only publishes: encoder fps, video and audio bitrate against the
+target, cpu and rss of the robot process and the network quality stats.
+the audio numbers are the vendor's: AUDIO_PROFILE_TYPE and
+che.audio.specify.codec names for agora, ZegoAudioConfigPreset and
+ZegoAudioCodecID for zego. "default" leaves the profile or codec alone
+'''
+import argparse
+import csv
+import itertools
+import json
+import sys
+
+import ab_bench
+
+
+def split_list(text):
+    return [item.strip() for item in text.split(",") if item.strip()]
+
+
+def parse_profiles(text):
+    return [ab_bench.parse_profile(item) for item in split_list(text)]
+
+
+def parse_audio_profiles(text):
+    try:
+        return [None if item == "default" else int(item) for item in split_list(text)]
+    except ValueError:
+        raise argparse.ArgumentTypeError("audio profiles are numbers or default, e.g. 0,1,3")
+
+
+def parse_audio_codecs(text):
+    return [None if item == "default" else item for item in split_list(text)]
+
+
+def cell_name(profile, audio_profile, audio_codec):
+    return "%dx%d@%d:%d" % tuple(profile), "default" if audio_profile is None else str(audio_profile), \
+        "default" if audio_codec is None else audio_codec
+
+
+def value(result, metric, key="p50"):
+    summary = result["metrics"][metric]
+    return None if summary is None else summary[key]
+
+
+def format_value(v):
+    return "-" if v is None else "%.1f" % v
+
+
+# (header, metric, percentile) of the table, the csv has every percentile of every metric
+COLUMNS = [
+    ("enc fps", "encode_fps", "p50"),
+    ("video kbps", "send_kbps", "p50"),
+    ("audio kbps", "audio_kbps", "p50"),
+    ("cpu% p50", "cpu", "p50"),
+    ("cpu% p90", "cpu", "p90"),
+    ("rss MB", "rss", "p50"),
+    ("rtt p50", "rtt", "p50"),
+    ("loss% p90", "tx_loss", "p90"),
+    ("delay p50", "delay", "p50"),
+]
+
+
+def report(rows):
+    print("%-20s %-7s %-8s %s" % ("video", "audio", "codec", "".join("%-11s" % header for header, _, _ in COLUMNS)))
+    for (video, audio, codec), result in rows:
+        cells = []
+        for _, metric, key in COLUMNS:
+            cells.append("%-11s" % format_value(value(result, metric, key)))
+        failed = "  %d robots failed" % result["failed"] if result["failed"] else ""
+        print("%-20s %-7s %-8s %s%s" % (video, audio, codec, "".join(cells), failed))
+
+
+def write_csv(path, rows):
+    keys = ["p50", "p90", "p99", "mean"]
+    with open(path, "w", newline="") as f:
+        writer = csv.writer(f)
+        writer.writerow(["video", "audio_profile", "audio_codec", "robots", "failed"] +
+                        ["%s_%s" % (metric, key) for metric, _, _ in ab_bench.METRICS for key in keys])
+        for (video, audio, codec), result in rows:
+            writer.writerow([video, audio, codec, result["robots"], result["failed"]] +
+                            [value(result, metric, key) for metric, _, _ in ab_bench.METRICS for key in keys])
+
+
+def main():
+    parser = argparse.ArgumentParser(description="publish every cell of an encoder config matrix and tabulate the results")
+    parser.add_argument("--backend", type=ab_bench.parse_backend, default=("mock", ""), metavar="NAME[=DLL]",
+                        help="agora, zego or mock; the dll defaults to the build output")
+    parser.add_argument("--profiles", type=parse_profiles, default=[[640, 480, 15, 1000]],
+                        help="comma separated WxH@FPS:KBPS")
+    parser.add_argument("--audio-profiles", type=parse_audio_profiles, default=[None],
+                        help="comma separated vendor audio presets or default")
+    parser.add_argument("--audio-codecs", type=parse_audio_codecs, default=[None],
+                        help="comma separated vendor codecs or default")
+    parser.add_argument("-o", "--output", help="also write every percentile of every cell as csv (.csv) or json")
+    ab_bench.add_scenario_arguments(parser)
+    parser.set_defaults(robots=1, duration=20)
+    args = parser.parse_args()
+
+    name, dll = args.backend
+    if name == "agora" and not args.appid:
+        parser.error("agora needs --appid")
+
+    cells = list(itertools.product(args.profiles, args.audio_profiles, args.audio_codecs))
+    print("%s: %d cells x %ds, %d robots each" % (name, len(cells), args.duration, args.robots))
+    rows = []
+    for i, (profile, audio_profile, audio_codec) in enumerate(cells):
+        args.profile = profile
+        args.audio_profile = audio_profile
+        args.audio_codec = audio_codec
+        key = cell_name(profile, audio_profile, audio_codec)
+        result = ab_bench.run_scenario(args, name, dll, "%d/%d %s" % (i + 1, len(cells), " ".join(key)))
+        rows.append((key, result))
+
+    report(rows)
+    if args.output:
+        if args.output.endswith(".csv"):
+            write_csv(args.output, rows)
+        else:
+            with open(args.output, "w") as f:
+                json.dump([{"video": video, "audioProfile": audio, "audioCodec": codec, "result": result}
+                           for (video, audio, codec), result in rows], f, indent=2)
+
+
+if __name__ == '__main__':
+    main()
@@ -1,16 +1,25 @@
 import ctypes
 import os
-import tkinter
-import json
 import sys
 import random
 import time
+import threading
+import fleet
+import config_abi
 
 
 channelName = "test"
 profile = {"bitrate": "1000", "fps": "15", "resolution": "640*480"}
 
 isRobot = False
+# no window and no preview, the remote video goes to a custom renderer that drops it
+headless = False
+# the remote audio is fetched into no device every 10ms (rtc_startAudioSink) instead of played,
+# this turns on custom audio IO, so only pushed audio is published
+audioSink = False
+# an existing directory: the mix of the played streams goes to remote.wav and its mix with the
+# capture to mixed.wav (rtc_startAudioRecording), this sdk has no audio per stream
+audioRecordDir = None
 disableVideo = False
 
 #disableAudio does not work for zego
@@ -58,6 +67,21 @@ customVideoSrc = os.path.join(current_dir, customVideoSrc)
 
 if isRobot == True:
     enableCustomCapture = True
+    headless = True
+
+# tickets of the config posted to the engine thread, polled by the ui loop
+tickets = []
+
+def pollConfig(zego):
+    '''
+    True once every posted config is done, prints the first failure.
+    called from window.after / fleet.run_headless, never blocks on the engine
+    '''
+    try:
+        return config_abi.poll_all(zego, tickets)
+    except config_abi.ConfigError as e:
+        print(e)
+        return True
 
 try:
     current_dir = os.path.abspath(os.path.dirname(__file__))
@@ -69,22 +93,35 @@ try:
 
     zego = ctypes.cdll.LoadLibrary("zegowrapper.dll")
 
-    window = tkinter.Tk()
-    window.title("ZEGO for test")
-    window.geometry('480x960')
-
     NUMBER_OF_FRAMES = 8
-    relative_height = 1 / float(NUMBER_OF_FRAMES)
-
-    for number in range(NUMBER_OF_FRAMES):
-        display_frame = tkinter.Frame(window, bg='')
-        relative_y = number * relative_height
-        display_frame.place(relx = 0, rely = relative_y,
-                anchor = tkinter.NW, relwidth = 1, relheight = relative_height)
-        frame_id = display_frame.winfo_id()
-        zego.addView(ctypes.c_ulonglong(frame_id), ctypes.c_ulonglong(number))
+    window = None
+    if headless == True:
+        #the views are only slots of the remote streams
+        for number in range(NUMBER_OF_FRAMES):
+            zego.addView(ctypes.c_ulonglong(number + 1), ctypes.c_ulonglong(number))
+    else:
+        import tkinter
+        window = tkinter.Tk()
+        window.title("ZEGO for test")
+        window.geometry('480x960')
+
+        relative_height = 1 / float(NUMBER_OF_FRAMES)
+
+        for number in range(NUMBER_OF_FRAMES):
+            display_frame = tkinter.Frame(window, bg='')
+            relative_y = number * relative_height
+            display_frame.place(relx = 0, rely = relative_y,
+                    anchor = tkinter.NW, relwidth = 1, relheight = relative_height)
+            frame_id = display_frame.winfo_id()
+            zego.addView(ctypes.c_ulonglong(frame_id), ctypes.c_ulonglong(number))
     
     zego.createEngine()
+    if headless == True:
+        zego.rtc_enableHeadless(ctypes.c_int(1))
+    if audioSink == True:
+        zego.rtc_startAudioSink(ctypes.c_int(48000), ctypes.c_int(1), ctypes.c_int(1))
+    if audioRecordDir is not None:
+        zego.rtc_startAudioRecording(ctypes.c_char_p(bytes(audioRecordDir, 'utf-8')), ctypes.c_int(48000), ctypes.c_int(1))
 
     #zego.enumerateRecordingDevices()
     #zego.enumerateVideoDevices()
@@ -98,8 +135,10 @@ try:
         zego.enableCustomAudioIO()
     
 
-    vprofile = json.dumps(profile)
-    zego.setVideoProfile(ctypes.c_char_p(bytes(vprofile, 'utf-8')))
+    #the config and the login are posted, they run on the engine thread in this order
+    width, height = [int(v) for v in profile["resolution"].split("*")]
+    tickets.append(config_abi.post(zego, config_abi.ZEGO_ABI_VERSION, config_abi.zego_items([
+        config_abi.zego_video(width, height, int(profile["fps"]), int(profile["bitrate"]))])))
 
     if disableVideo == False:
         zego.enableVideo(ctypes.c_char_p(bytes("", 'utf-8')))
@@ -115,11 +154,34 @@ try:
         zego.disableeAGC()
 
     if audioProfile is not None:
-        zego.setAudioConfig(ctypes.c_int(audioProfile), ctypes.c_int(audioCodecId))
+        tickets.append(config_abi.post(zego, config_abi.ZEGO_ABI_VERSION, config_abi.zego_items([
+            config_abi.zego_audio(audioProfile, audioCodecId)])))
 
     uid = "fan"+str(random.randint(0,1000))
-    channel = json.dumps({"channelId":channelName,"uid":uid})
-    zego.joinChannel(ctypes.c_char_p(bytes(channel, 'utf-8')))
+
+    if fleet.churn():
+        #room state arrives on this thread, keep it pumping while a worker churns
+        churnDone = threading.Event()
+        def runChurn():
+            for ticket in tickets:
+                config_abi.wait(zego, ticket)
+            fleet.run_churn(zego, channelName, uid)
+            churnDone.set()
+        def pollChurn():
+            if churnDone.is_set():
+                window.quit()
+            else:
+                window.after(100, pollChurn)
+        threading.Thread(target=runChurn, daemon=True).start()
+        if window is not None:
+            pollChurn()
+            window.mainloop()
+        else:
+            fleet.run_headless(churnDone)
+        sys.exit(0)
+
+    tickets.append(config_abi.post(zego, config_abi.ZEGO_ABI_VERSION,
+                                   config_abi.zego_items([config_abi.zego_login(channelName, uid)])))
 
     if disableVideo == True:
         zego.disableVideo()
@@ -128,17 +190,40 @@ try:
      #   zego.disableAudio()
 
 
-    if enableCustomCapture == True:
+    def startCapMedia(barrier):
+        if barrier == True:
+            fleet.wait_ready(zego)
         zego.startCapMedia(ctypes.c_char_p(bytes(customVideoSrc, 'utf-8')))
 
+    if enableCustomCapture == True:
+        if fleet.launched():
+            #room state arrives on this thread, so wait for the fleet from a worker
+            threading.Thread(target=startCapMedia, args=(True,), daemon=True).start()
+        else:
+            startCapMedia(False)
+    elif fleet.launched():
+        threading.Thread(target=fleet.wait_ready, args=(zego,), daemon=True).start()
+
     if isRobot == True:
         zego.stopPreview()
-        zego.stopPlayingStream()
-        zego.muteSpeaker()
+        if audioSink == False:
+            zego.stopPlayingStream()
+            zego.muteSpeaker()
         zego.muteMicrophone()
         zego.logOff()
 
-    window.mainloop()
+    if window is not None:
+        def afterConfig():
+            if not pollConfig(zego):
+                window.after(100, afterConfig)
+        window.after(100, afterConfig)
+        window.mainloop()
+    else:
+        fleet.run_headless(poll=lambda: pollConfig(zego))
 finally:
-    zego.leaveChannel(ctypes.c_char_p(bytes("", 'utf-8')))
+    if audioRecordDir is not None:
+        # puts the real sizes into the wav headers
+        zego.rtc_stopAudioRecording()
+    #destroyZegoEngine runs the posted leave before the engine goes away
+    zego.postLeaveChannel()
     zego.destroyZegoEngine()
\ No newline at end of file
@@ -0,0 +1,38 @@
+// churn_bench : login/logout churn of one robot against zegowrapper.
+// the real SDK delivers room state through the message loop of the thread
+// that created the engine, which a console program does not have, so this
+// is meant for a ZEGODL_MOCK_SDK build; use start.py --churn with the real SDK
+//
+//   churn_bench [cycles] [holdms] [output]
+//
+// mock knobs come from RTC_MOCK_CONFIG, e.g. {"peers":16,"peerChurnMs":200}
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+extern "C" void createEngine();
+extern "C" void destroyZegoEngine();
+extern "C" int runChurnBenchmark(void* lpExtInfo);
+extern "C" void addView(void* lpExtInfo, int i);
+
+int main(int argc, char* argv[])
+{
+	std::string cycles = argc > 1 ? argv[1] : "100";
+	std::string holdms = argc > 2 ? argv[2] : "100";
+
+	std::string params = "{\"channelId\":\"churn\",\"uid\":\"churn_bench\",\"cycles\":\"" + cycles + "\",\"holdms\":\"" + holdms + "\"";
+	if (argc > 3)
+		params += ",\"output\":\"" + std::string(argv[3]) + "\"";
+	params += "}";
+
+	// placeholder views, the robot scripts add 8 tkinter frames the same way
+	for (int i = 0; i < 8; i++)
+		addView((void*)(uintptr_t)(i + 1), i);
+
+	createEngine();
+	int nFailed = runChurnBenchmark((void*)params.c_str());
+	destroyZegoEngine();
+
+	return nFailed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,202 @@
+// media_bench : google benchmark of the media player -> custom capture queue
+//
+//   ZegoCustomVideoSourceMedia::onVideoFrame -> getVideoFrame, bgra at 480p/720p/1080p
+//   ZegoCustomVideoSourceMedia::onAudioFrame -> getAudioFrame, 10ms pcm at 16/32/48k
+//   CImageScaler    one remote frame into a 320x240 tile of the compositor
+//
+// the */threads:2 runs put the media player thread and the capture thread on
+// the same source. every op is timed on its own so the counters carry the
+// p50/p99 latency next to the mean ns per op; the steady_clock read adds ~20ns.
+// no engine is created, the source then runs without a media player.
+//
+//   media_bench --benchmark_out=media.json --benchmark_out_format=json
+//   python bench_compare.py zegodl/bench/baseline/media_bench.json media.json
+#include <benchmark/benchmark.h>
+#include "ZegoCustomVideoSourceMedia.h"
+#include "HdrHistogram.h"
+#include "ImageScaler.h"
+#include <chrono>
+#include <vector>
+
+// 10s in ns, a blocked op longer than that is clamped
+#define BENCH_HIGHEST_TRACKABLE	(10LL * 1000 * 1000 * 1000)
+
+static const int g_nVideoSizes[][2] = { { 640, 480 }, { 1280, 720 }, { 1920, 1080 } };
+
+// times one op per iteration into a histogram and reports its percentiles
+class CBenchLatency
+{
+public:
+	CBenchLatency() : m_histogram(BENCH_HIGHEST_TRACKABLE, 3) {}
+
+	void Start() { m_start = std::chrono::steady_clock::now(); }
+	void Stop() { m_histogram.record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count()); }
+
+	void Report(benchmark::State& state)
+	{
+		state.counters["p50_ns"] = benchmark::Counter((double)m_histogram.getValueAtPercentile(50.0), benchmark::Counter::kAvgThreads);
+		state.counters["p99_ns"] = benchmark::Counter((double)m_histogram.getValueAtPercentile(99.0), benchmark::Counter::kAvgThreads);
+	}
+
+private:
+	CHdrHistogram m_histogram;
+	std::chrono::steady_clock::time_point m_start;
+};
+
+// one packed bgra plane, the format ZegoCustomVideoSourceMedia asks the player for
+struct BENCH_VIDEO_FRAME
+{
+	std::vector<unsigned char> buffer;
+	const unsigned char* data[4];
+	unsigned int dataLength[4];
+	ZegoVideoFrameParam param;
+
+	BENCH_VIDEO_FRAME(int nWidth, int nHeight)
+		: buffer(nWidth * nHeight * 4, 1)
+	{
+		memset(data, 0, sizeof(data));
+		memset(dataLength, 0, sizeof(dataLength));
+		memset(&param, 0, sizeof(param));
+		data[0] = buffer.data();
+		dataLength[0] = (unsigned int)buffer.size();
+		param.format = ZEGO_VIDEO_FRAME_FORMAT_BGRA32;
+		param.strides[0] = nWidth * 4;
+		param.width = nWidth;
+		param.height = nHeight;
+	}
+};
+
+static void VideoSizeArgs(benchmark::internal::Benchmark* b)
+{
+	for (auto& size : g_nVideoSizes)
+		b->Args({ size[0], size[1] });
+}
+
+static void BM_MediaSource_VideoFrame(benchmark::State& state)
+{
+	ZegoCustomVideoSourceMedia source;
+	BENCH_VIDEO_FRAME frame((int)state.range(0), (int)state.range(1));
+	std::shared_ptr<ZegoCustomVideoFrame> videoFrame;
+	CBenchLatency latency;
+
+	for (auto _ : state)
+	{
+		latency.Start();
+		source.onVideoFrame(nullptr, frame.data, frame.dataLength, frame.param);
+		source.getVideoFrame(videoFrame);
+		latency.Stop();
+		benchmark::DoNotOptimize(videoFrame);
+	}
+
+	state.SetBytesProcessed(state.iterations() * frame.buffer.size());
+	state.SetItemsProcessed(state.iterations());
+	latency.Report(state);
+}
+BENCHMARK(BM_MediaSource_VideoFrame)->Apply(VideoSizeArgs);
+
+// thread 0 is the media player decoding, thread 1 the capture loop pulling.
+// the queue drops frames past 3, both sides never block on each other
+static void BM_MediaSource_VideoPlayerCapture(benchmark::State& state)
+{
+	static ZegoCustomVideoSourceMedia* lpSource = nullptr;
+	if (state.thread_index() == 0)
+		lpSource = new ZegoCustomVideoSourceMedia();
+
+	BENCH_VIDEO_FRAME frame((int)state.range(0), (int)state.range(1));
+	std::shared_ptr<ZegoCustomVideoFrame> videoFrame;
+	CBenchLatency latency;
+	bool bPlayer = state.thread_index() == 0;
+	int64_t nFrames = 0;
+
+	for (auto _ : state)
+	{
+		latency.Start();
+		if (bPlayer)
+		{
+			lpSource->onVideoFrame(nullptr, frame.data, frame.dataLength, frame.param);
+		}
+		else
+		{
+			lpSource->getVideoFrame(videoFrame);
+			if (videoFrame)
+				nFrames++;
+		}
+		latency.Stop();
+	}
+
+	// bytes are the frames that made it through the queue
+	state.SetItemsProcessed(state.iterations());
+	if (!bPlayer)
+	{
+		state.SetBytesProcessed(nFrames * frame.buffer.size());
+		state.counters["hit_rate"] = benchmark::Counter((double)nFrames / state.iterations());
+	}
+	latency.Report(state);
+
+	if (state.thread_index() == 0)
+	{
+		delete lpSource;
+		lpSource = nullptr;
+	}
+}
+BENCHMARK(BM_MediaSource_VideoPlayerCapture)->Apply(VideoSizeArgs)->Threads(2)->UseRealTime();
+
+static void BM_MediaSource_AudioFrame(benchmark::State& state)
+{
+	ZegoCustomVideoSourceMedia source;
+	int nSampleRate = (int)state.range(0);
+	// 10ms of 16 bit stereo
+	std::vector<unsigned char> pcm(nSampleRate / 100 * 2 * 2, 1);
+	ZegoAudioFrameParam param;
+	param.sampleRate = (ZegoAudioSampleRate)nSampleRate;
+	param.channel = ZEGO_AUDIO_CHANNEL_STEREO;
+	std::shared_ptr<ZegoCustomAudioFrame> audioFrame;
+	CBenchLatency latency;
+
+	for (auto _ : state)
+	{
+		latency.Start();
+		source.onAudioFrame(nullptr, pcm.data(), (unsigned int)pcm.size(), param);
+		source.getAudioFrame(audioFrame);
+		latency.Stop();
+		benchmark::DoNotOptimize(audioFrame);
+	}
+
+	state.SetBytesProcessed(state.iterations() * pcm.size());
+	state.SetItemsProcessed(state.iterations());
+	latency.Report(state);
+}
+BENCHMARK(BM_MediaSource_AudioFrame)->Arg(16000)->Arg(32000)->Arg(48000);
+
+// the three planes of an I420 frame the way CVideoCompositor::PutFrame scales them
+static void BM_ImageScaler_ScaleI420(benchmark::State& state)
+{
+	int nWidth = (int)state.range(0), nHeight = (int)state.range(1);
+	int nTileWidth = 320, nTileHeight = 240;
+	int nBytes = nWidth * nHeight * 3 / 2;
+	std::vector<BYTE> frame(nBytes), tile(nTileWidth * nTileHeight * 3 / 2);
+	for (int i = 0; i < nBytes; i++)
+		frame[i] = (BYTE)(i * 7);
+	const BYTE* lpU = frame.data() + nWidth * nHeight;
+	const BYTE* lpV = lpU + nWidth * nHeight / 4;
+	BYTE* lpTileU = tile.data() + nTileWidth * nTileHeight;
+	BYTE* lpTileV = lpTileU + nTileWidth * nTileHeight / 4;
+	CBenchLatency latency;
+
+	for (auto _ : state)
+	{
+		latency.Start();
+		CImageScaler::ScalePlane(frame.data(), nWidth, nWidth, nHeight, tile.data(), nTileWidth, nTileWidth, nTileHeight);
+		CImageScaler::ScalePlane(lpU, nWidth / 2, nWidth / 2, nHeight / 2, lpTileU, nTileWidth / 2, nTileWidth / 2, nTileHeight / 2);
+		CImageScaler::ScalePlane(lpV, nWidth / 2, nWidth / 2, nHeight / 2, lpTileV, nTileWidth / 2, nTileWidth / 2, nTileHeight / 2);
+		latency.Stop();
+		benchmark::DoNotOptimize(tile.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * nBytes);
+	state.SetItemsProcessed(state.iterations());
+	latency.Report(state);
+}
+BENCHMARK(BM_ImageScaler_ScaleI420)->Apply(VideoSizeArgs);
+
+BENCHMARK_MAIN();
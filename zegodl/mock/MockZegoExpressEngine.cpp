@@ -0,0 +1,879 @@
+#include "MockZegoExpressEngine.h"
+#include "json/json.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+
+static IZegoExpressEngine* g_lpMockEngine = nullptr;
+
+bool MOCK_CONFIG::Parse(const char* lpJson)
+{
+	Json::Value root;
+	Json::CharReaderBuilder builder;
+	JSONCPP_STRING err;
+
+	std::string rawJson(lpJson);
+	const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+	if (!reader->parse(rawJson.c_str(), rawJson.c_str() + rawJson.length(), &root, &err) || !root.isObject())
+		return false;
+
+	struct { const char* lpName; int* pValue; } fields[] = {
+		{ "joinLatencyMs", &joinLatencyMs },
+		{ "leaveLatencyMs", &leaveLatencyMs },
+		{ "jitterMs", &jitterMs },
+		{ "peers", &peers },
+		{ "peerJoinMs", &peerJoinMs },
+		{ "firstFrameMs", &firstFrameMs },
+		{ "peerChurnMs", &peerChurnMs },
+		{ "captureWidth", &captureWidth },
+		{ "captureHeight", &captureHeight },
+		{ "captureFps", &captureFps },
+		{ "videoBitrate", &videoBitrate },
+		{ "audioBitrate", &audioBitrate },
+		{ "audioSampleRate", &audioSampleRate },
+		{ "audioChannels", &audioChannels },
+		{ "qualityIntervalMs", &qualityIntervalMs },
+		{ "speakerMs", &speakerMs },
+		{ "remoteFps", &remoteFps },
+		{ "audioDropPermille", &audioDropPermille },
+	};
+
+	for (auto& field : fields)
+	{
+		if (root[field.lpName].isNumeric())
+			*field.pValue = root[field.lpName].asInt();
+	}
+	return true;
+}
+
+CMockZegoMediaPlayer::CMockZegoMediaPlayer(int nIndex, CMockEventLoop* lpLoop, const MOCK_CONFIG& config)
+	: m_nIndex(nIndex)
+	, m_lpLoop(lpLoop)
+	, m_config(config)
+	, m_state(ZEGO_MEDIA_PLAYER_STATE_NO_PLAY)
+	, m_videoFormat(ZEGO_VIDEO_FRAME_FORMAT_BGRA32)
+{
+	memset(&m_videoParam, 0, sizeof(m_videoParam));
+	memset(&m_audioParam, 0, sizeof(m_audioParam));
+}
+
+CMockZegoMediaPlayer::~CMockZegoMediaPlayer()
+{
+	StopCadence();
+}
+
+void CMockZegoMediaPlayer::setEventHandler(std::shared_ptr<IZegoMediaPlayerEventHandler> handler)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_eventHandler = handler;
+}
+
+void CMockZegoMediaPlayer::setVideoHandler(std::shared_ptr<IZegoMediaPlayerVideoHandler> handler, ZegoVideoFrameFormat format)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_videoHandler = handler;
+	m_videoFormat = format;
+}
+
+void CMockZegoMediaPlayer::setAudioHandler(std::shared_ptr<IZegoMediaPlayerAudioHandler> handler)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_audioHandler = handler;
+}
+
+void CMockZegoMediaPlayer::loadResource(const std::string& path, ZegoMediaPlayerLoadResourceCallback callback)
+{
+	StopCadence();
+	m_state = ZEGO_MEDIA_PLAYER_STATE_NO_PLAY;
+	if (callback)
+		m_lpLoop->Post(0, [callback]() { callback(0); });
+}
+
+void CMockZegoMediaPlayer::start()
+{
+	StopCadence();
+	StartCadence();
+	SetState(ZEGO_MEDIA_PLAYER_STATE_PLAYING);
+}
+
+void CMockZegoMediaPlayer::stop()
+{
+	StopCadence();
+	SetState(ZEGO_MEDIA_PLAYER_STATE_NO_PLAY);
+}
+
+void CMockZegoMediaPlayer::pause()
+{
+	if (m_state != ZEGO_MEDIA_PLAYER_STATE_PLAYING)
+		return;
+	StopCadence();
+	SetState(ZEGO_MEDIA_PLAYER_STATE_PAUSING);
+}
+
+void CMockZegoMediaPlayer::resume()
+{
+	if (m_state != ZEGO_MEDIA_PLAYER_STATE_PAUSING)
+		return;
+	StartCadence();
+	SetState(ZEGO_MEDIA_PLAYER_STATE_PLAYING);
+}
+
+void CMockZegoMediaPlayer::SetState(ZegoMediaPlayerState state)
+{
+	if (m_state.exchange(state) == state)
+		return;
+
+	std::shared_ptr<IZegoMediaPlayerEventHandler> eventHandler;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		eventHandler = m_eventHandler;
+	}
+	if (eventHandler)
+		m_lpLoop->Post(0, [this, eventHandler, state]() { eventHandler->onMediaPlayerStateUpdate(this, state, 0); });
+}
+
+void CMockZegoMediaPlayer::StartCadence()
+{
+	int nFps = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		int nWidth = m_config.captureWidth & ~1;
+		int nHeight = m_config.captureHeight & ~1;
+		nFps = m_config.captureFps > 0 ? m_config.captureFps : 15;
+
+		memset(&m_videoParam, 0, sizeof(m_videoParam));
+		memset(m_videoPlanes, 0, sizeof(m_videoPlanes));
+		memset(m_videoPlaneLength, 0, sizeof(m_videoPlaneLength));
+		m_videoParam.format = m_videoFormat;
+		m_videoParam.width = nWidth;
+		m_videoParam.height = nHeight;
+		if (m_videoFormat == ZEGO_VIDEO_FRAME_FORMAT_I420)
+		{
+			m_videoBuffer.assign(nWidth * nHeight * 3 / 2, 0x80);
+			m_videoParam.strides[0] = nWidth;
+			m_videoParam.strides[1] = nWidth / 2;
+			m_videoParam.strides[2] = nWidth / 2;
+			m_videoPlanes[0] = m_videoBuffer.data();
+			m_videoPlanes[1] = m_videoBuffer.data() + nWidth * nHeight;
+			m_videoPlanes[2] = m_videoBuffer.data() + nWidth * nHeight * 5 / 4;
+			m_videoPlaneLength[0] = nWidth * nHeight;
+			m_videoPlaneLength[1] = nWidth * nHeight / 4;
+			m_videoPlaneLength[2] = nWidth * nHeight / 4;
+		}
+		else
+		{
+			// every packed 32 bit format is the same blank frame
+			m_videoBuffer.assign(nWidth * nHeight * 4, 0x80);
+			m_videoParam.strides[0] = nWidth * 4;
+			m_videoPlanes[0] = m_videoBuffer.data();
+			m_videoPlaneLength[0] = nWidth * nHeight * 4;
+		}
+
+		m_audioParam.sampleRate = (ZegoAudioSampleRate)m_config.audioSampleRate;
+		m_audioParam.channel = (ZegoAudioChannel)m_config.audioChannels;
+		m_audioBuffer.assign(m_config.audioSampleRate / 100 * m_config.audioChannels * 2, 0);
+	}
+
+	m_videoCadence.Start(1000000 / nFps, [this]() { RenderVideoFrame(); });
+	m_audioCadence.Start(10000, [this]() { RenderAudioFrame(); });
+}
+
+void CMockZegoMediaPlayer::StopCadence()
+{
+	if (m_videoCadence.IsRunning())
+	{
+		m_videoCadence.Stop();
+		LOG_INFO("mock media player video: %lld frames, %lld dropped", (long long)m_videoCadence.GetTicks(), (long long)m_videoCadence.GetDropped());
+	}
+	if (m_audioCadence.IsRunning())
+	{
+		m_audioCadence.Stop();
+		LOG_INFO("mock media player audio: %lld frames, %lld dropped", (long long)m_audioCadence.GetTicks(), (long long)m_audioCadence.GetDropped());
+	}
+}
+
+void CMockZegoMediaPlayer::RenderVideoFrame()
+{
+	std::shared_ptr<IZegoMediaPlayerVideoHandler> videoHandler;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		videoHandler = m_videoHandler;
+	}
+	if (videoHandler)
+		videoHandler->onVideoFrame(this, m_videoPlanes, m_videoPlaneLength, m_videoParam);
+}
+
+void CMockZegoMediaPlayer::RenderAudioFrame()
+{
+	std::shared_ptr<IZegoMediaPlayerAudioHandler> audioHandler;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		audioHandler = m_audioHandler;
+	}
+	if (audioHandler)
+		audioHandler->onAudioFrame(this, m_audioBuffer.data(), (unsigned int)m_audioBuffer.size(), m_audioParam);
+}
+
+CMockZegoExpressEngine::CMockZegoExpressEngine(std::shared_ptr<IZegoEventHandler> eventHandler)
+	: m_random(std::random_device()())
+	, m_eventHandler(eventHandler)
+	, m_nSoundLevelGeneration(0)
+	, m_nSpeakerElapsedMs(0)
+	, m_nGeneration(0)
+	, m_bCustomRender(false)
+	, m_nRenderTicks(0)
+	, m_bCustomCapture(false)
+	, m_nPublishGeneration(0)
+	, m_nSentVideoFrames(0)
+	, m_nSentAudioFrames(0)
+	, m_nSentVideoBytes(0)
+	, m_nSentAudioBytes(0)
+	, m_bCustomAudioIO(false)
+	, m_dRenderPhase(0)
+	, m_renderRandom(std::random_device()())
+	, m_nAudioDataMask(0)
+	, m_dAudioDataPhase(0)
+{
+	const char* lpConfig = getenv("RTC_MOCK_CONFIG");
+	if (lpConfig)
+		m_config.Parse(lpConfig);
+}
+
+CMockZegoExpressEngine::~CMockZegoExpressEngine()
+{
+	// the real engine stops publishing on destroy, the capture handler gets its onStop
+	stopPublishingStream();
+	m_renderCadence.Stop();
+	m_audioDataCadence.Stop();
+	for (auto lpPlayer : m_mediaPlayers)
+		delete lpPlayer;
+	m_mediaPlayers.clear();
+	m_loop.Stop();
+}
+
+void CMockZegoExpressEngine::setEventHandler(std::shared_ptr<IZegoEventHandler> eventHandler)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_eventHandler = eventHandler;
+}
+
+std::shared_ptr<IZegoEventHandler> CMockZegoExpressEngine::GetEventHandler()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_eventHandler;
+}
+
+int CMockZegoExpressEngine::Delay(int nMs)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_config.jitterMs <= 0)
+		return nMs;
+	return nMs + std::uniform_int_distribution<int>(0, m_config.jitterMs)(m_random);
+}
+
+void CMockZegoExpressEngine::loginRoom(const std::string& roomID, ZegoUser user)
+{
+	MOCK_CONFIG config;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		config = m_config;
+		m_roomID = roomID;
+		m_playingStreams.clear();
+		m_baseLayerStreams.clear();
+		m_videoMutedStreams.clear();
+	}
+	unsigned int nGeneration = ++m_nGeneration;
+
+	m_renderCadence.Stop();
+	if (config.remoteFps > 0)
+		m_renderCadence.Start(1000000 / config.remoteFps, [this, nGeneration]() { RenderRemoteVideo(nGeneration); });
+
+	if (auto eventHandler = GetEventHandler())
+		eventHandler->onRoomStateUpdate(roomID, ZEGO_ROOM_STATE_CONNECTING, 0, "{}");
+
+	int nJoinMs = Delay(config.joinLatencyMs);
+	m_loop.Post(nJoinMs, [this, nGeneration, roomID]() {
+		auto eventHandler = GetEventHandler();
+		if (nGeneration == m_nGeneration && eventHandler)
+			eventHandler->onRoomStateUpdate(roomID, ZEGO_ROOM_STATE_CONNECTED, 0, "{}");
+	});
+
+	for (int i = 0; i < config.peers; i++)
+		PeerJoin(nGeneration, "peer" + std::to_string(i), nJoinMs + Delay(config.peerJoinMs * (i + 1)));
+
+	if (config.qualityIntervalMs > 0)
+		m_loop.Post(nJoinMs + config.qualityIntervalMs, [this, nGeneration]() { PlayQuality(nGeneration); });
+}
+
+void CMockZegoExpressEngine::loginRoom(const std::string& roomID, ZegoUser user, ZegoRoomConfig config)
+{
+	loginRoom(roomID, user);
+}
+
+void CMockZegoExpressEngine::PeerUpdate(unsigned int nGeneration, const std::string& userID, ZegoUpdateType updateType)
+{
+	auto eventHandler = GetEventHandler();
+	if (nGeneration != m_nGeneration || !eventHandler)
+		return;
+
+	std::string roomID;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		roomID = m_roomID;
+		if (updateType == ZEGO_UPDATE_TYPE_DELETE)
+		{
+			m_playingStreams.erase(userID);
+			m_videoMutedStreams.erase(userID);
+		}
+	}
+
+	ZegoStream stream;
+	stream.user = ZegoUser(userID, userID);
+	stream.streamID = userID;
+	eventHandler->onRoomUserUpdate(roomID, updateType, { stream.user });
+	eventHandler->onRoomStreamUpdate(roomID, updateType, { stream });
+}
+
+void CMockZegoExpressEngine::PeerJoin(unsigned int nGeneration, const std::string& userID, int nDelayMs)
+{
+	int nChurnMs = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		nChurnMs = m_config.peerChurnMs;
+	}
+
+	m_loop.Post(nDelayMs, [this, nGeneration, userID]() {
+		PeerUpdate(nGeneration, userID, ZEGO_UPDATE_TYPE_ADD);
+	});
+
+	if (nChurnMs <= 0)
+		return;
+
+	// leave after nChurnMs and come back nChurnMs later
+	m_loop.Post(nDelayMs + Delay(nChurnMs), [this, nGeneration, userID, nChurnMs]() {
+		if (nGeneration != m_nGeneration)
+			return;
+		PeerUpdate(nGeneration, userID, ZEGO_UPDATE_TYPE_DELETE);
+		PeerJoin(nGeneration, userID, Delay(nChurnMs));
+	});
+}
+
+void CMockZegoExpressEngine::logoutRoom(const std::string& roomID)
+{
+	stopPublishingStream();
+
+	unsigned int nGeneration = ++m_nGeneration;
+	m_renderCadence.Stop();
+	int nLeaveMs = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		nLeaveMs = m_config.leaveLatencyMs;
+		m_playingStreams.clear();
+		m_baseLayerStreams.clear();
+		m_videoMutedStreams.clear();
+	}
+
+	m_loop.Post(Delay(nLeaveMs), [this, nGeneration, roomID]() {
+		auto eventHandler = GetEventHandler();
+		if (nGeneration == m_nGeneration && eventHandler)
+			eventHandler->onRoomStateUpdate(roomID, ZEGO_ROOM_STATE_DISCONNECTED, 0, "{}");
+	});
+}
+
+void CMockZegoExpressEngine::startPlayingStream(const std::string& streamID, ZegoCanvas* canvas)
+{
+	int nFirstFrameMs = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		// playing again only moves the canvas
+		if (!m_playingStreams.insert(streamID).second)
+			return;
+		nFirstFrameMs = m_config.firstFrameMs;
+	}
+
+	unsigned int nGeneration = m_nGeneration;
+	m_loop.Post(Delay(nFirstFrameMs), [this, nGeneration, streamID]() {
+		auto eventHandler = GetEventHandler();
+		if (nGeneration != m_nGeneration || !eventHandler)
+			return;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_playingStreams.find(streamID) == m_playingStreams.end())
+				return;
+		}
+		eventHandler->onPlayerStateUpdate(streamID, ZEGO_PLAYER_STATE_PLAYING, 0, "{}");
+		eventHandler->onPlayerRecvVideoFirstFrame(streamID);
+	});
+}
+
+void CMockZegoExpressEngine::startPlayingStream(const std::string& streamID, ZegoCanvas* canvas, ZegoPlayerConfig config)
+{
+	{
+		// like the canvas, the layer of a stream being played does not change
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_playingStreams.find(streamID) == m_playingStreams.end())
+		{
+			if (config.videoLayer == ZEGO_PLAYER_VIDEO_LAYER_BASE)
+				m_baseLayerStreams.insert(streamID);
+			else
+				m_baseLayerStreams.erase(streamID);
+		}
+	}
+	startPlayingStream(streamID, canvas);
+}
+
+void CMockZegoExpressEngine::enableCustomVideoRender(bool enable, ZegoCustomVideoRenderConfig* config)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_bCustomRender = enable;
+}
+
+void CMockZegoExpressEngine::setCustomVideoRenderHandler(std::shared_ptr<IZegoCustomVideoRenderHandler> handler)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_renderHandler = handler;
+}
+
+// horizontal bars moving down a frame per tick, tinted by the stream
+void CMockZegoExpressEngine::RenderRemoteVideo(unsigned int nGeneration)
+{
+	std::shared_ptr<IZegoCustomVideoRenderHandler> renderHandler;
+	std::vector<std::pair<std::string, bool>> vecStreams;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (nGeneration != m_nGeneration || !m_bCustomRender || !m_renderHandler)
+			return;
+		renderHandler = m_renderHandler;
+		for (auto& streamID : m_playingStreams)
+		{
+			if (m_videoMutedStreams.find(streamID) == m_videoMutedStreams.end())
+				vecStreams.push_back(std::make_pair(streamID, m_baseLayerStreams.find(streamID) != m_baseLayerStreams.end()));
+		}
+	}
+
+	for (auto& stream : vecStreams)
+	{
+		int nWidth = stream.second ? 160 : 640;
+		int nHeight = stream.second ? 120 : 480;
+		size_t nLumaSize = (size_t)nWidth * nHeight;
+		if (m_renderBuffer.size() < nLumaSize * 3 / 2)
+			m_renderBuffer.resize(nLumaSize * 3 / 2);
+		unsigned char* lpY = m_renderBuffer.data();
+		size_t nTint = std::hash<std::string>()(stream.first);
+		for (int y = 0; y < nHeight; y++)
+			memset(lpY + (size_t)y * nWidth, (int)((y + m_nRenderTicks) & 0xff), nWidth);
+		memset(lpY + nLumaSize, 64 + (int)(nTint % 128), nLumaSize / 4);
+		memset(lpY + nLumaSize * 5 / 4, 64 + (int)(nTint / 128 % 128), nLumaSize / 4);
+		m_nRenderTicks++;
+
+		ZegoVideoFrameParam param;
+		memset(&param, 0, sizeof(param));
+		param.format = ZEGO_VIDEO_FRAME_FORMAT_I420;
+		param.width = nWidth;
+		param.height = nHeight;
+		param.strides[0] = nWidth;
+		param.strides[1] = param.strides[2] = nWidth / 2;
+		unsigned char* planes[3] = { lpY, lpY + nLumaSize, lpY + nLumaSize * 5 / 4 };
+		unsigned int planeLengths[3] = { (unsigned int)nLumaSize, (unsigned int)nLumaSize / 4, (unsigned int)nLumaSize / 4 };
+		renderHandler->onRemoteVideoFrameRawData(planes, planeLengths, param, stream.first);
+	}
+}
+
+void CMockZegoExpressEngine::stopPlayingStream(const std::string& streamID)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_playingStreams.erase(streamID);
+	m_baseLayerStreams.erase(streamID);
+	m_videoMutedStreams.erase(streamID);
+}
+
+void CMockZegoExpressEngine::mutePlayStreamVideo(const std::string& streamID, bool mute)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (mute)
+		m_videoMutedStreams.insert(streamID);
+	else
+		m_videoMutedStreams.erase(streamID);
+}
+
+void CMockZegoExpressEngine::startSoundLevelMonitor()
+{
+	unsigned int nGeneration = ++m_nSoundLevelGeneration;
+	m_loop.Post(100, [this, nGeneration]() { SoundLevel(nGeneration); });
+}
+
+void CMockZegoExpressEngine::stopSoundLevelMonitor()
+{
+	++m_nSoundLevelGeneration;
+}
+
+// the active speaker loud, the other played streams near silence
+void CMockZegoExpressEngine::SoundLevel(unsigned int nGeneration)
+{
+	auto eventHandler = GetEventHandler();
+	if (nGeneration != m_nSoundLevelGeneration)
+		return;
+
+	std::unordered_map<std::string, float> soundLevels;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (!m_playingStreams.empty())
+		{
+			std::vector<std::string> streams(m_playingStreams.begin(), m_playingStreams.end());
+			m_nSpeakerElapsedMs += 100;
+			if (m_config.speakerMs > 0 && (m_playingStreams.find(m_activeSpeaker) == m_playingStreams.end() || m_nSpeakerElapsedMs >= m_config.speakerMs))
+			{
+				m_activeSpeaker = streams[std::uniform_int_distribution<size_t>(0, streams.size() - 1)(m_random)];
+				m_nSpeakerElapsedMs = 0;
+			}
+			for (auto& streamID : streams)
+			{
+				bool bSpeaking = m_config.speakerMs > 0 && streamID == m_activeSpeaker;
+				soundLevels[streamID] = (float)(bSpeaking ? std::uniform_int_distribution<int>(60, 90)(m_random)
+					: std::uniform_int_distribution<int>(0, 10)(m_random));
+			}
+		}
+	}
+	if (eventHandler && !soundLevels.empty())
+		eventHandler->onRemoteSoundLevelUpdate(soundLevels);
+
+	m_loop.Post(100, [this, nGeneration]() { SoundLevel(nGeneration); });
+}
+
+void CMockZegoExpressEngine::startPublishingStream(const std::string& streamID, ZegoPublishChannel channel)
+{
+	std::shared_ptr<IZegoCustomVideoCaptureHandler> captureHandler;
+	int nIntervalMs = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_bCustomCapture && !m_startedHandler)
+			m_startedHandler = captureHandler = m_captureHandler;
+		m_publishStreamID = streamID;
+		nIntervalMs = m_config.qualityIntervalMs;
+	}
+	unsigned int nGeneration = ++m_nPublishGeneration;
+	m_nSentVideoFrames = 0;
+	m_nSentAudioFrames = 0;
+	m_nSentVideoBytes = 0;
+	m_nSentAudioBytes = 0;
+
+	// called in place so onStart/onStop can never overlap on two threads
+	if (captureHandler)
+		captureHandler->onStart(channel);
+
+	if (nIntervalMs > 0)
+		m_loop.Post(nIntervalMs, [this, nGeneration, streamID]() { PublishQuality(nGeneration, streamID, 0, 0, 0, 0); });
+}
+
+void CMockZegoExpressEngine::stopPublishingStream(ZegoPublishChannel channel)
+{
+	std::shared_ptr<IZegoCustomVideoCaptureHandler> captureHandler;
+	bool bPublishing = false;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		captureHandler = m_startedHandler;
+		m_startedHandler = nullptr;
+		bPublishing = !m_publishStreamID.empty();
+		m_publishStreamID.clear();
+	}
+	++m_nPublishGeneration;
+
+	if (captureHandler)
+		captureHandler->onStop(channel);
+
+	if (bPublishing)
+		LOG_INFO("mock publish: %lld video frames, %lld audio frames, %lld bytes", (long long)m_nSentVideoFrames, (long long)m_nSentAudioFrames,
+			(long long)(m_nSentVideoBytes + m_nSentAudioBytes));
+}
+
+void CMockZegoExpressEngine::PublishQuality(unsigned int nGeneration, const std::string& streamID, int64_t nVideoFrames, int64_t nAudioFrames, int64_t nVideoBytes, int64_t nAudioBytes)
+{
+	auto eventHandler = GetEventHandler();
+	if (nGeneration != m_nPublishGeneration)
+		return;
+
+	// m_random is shared with Delay on the caller threads, the report draws from its own
+	int nIntervalMs = 0, nFps = 0, nBitrate = 0, nAudioBitrate = 0;
+	std::minstd_rand random;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		nIntervalMs = m_config.qualityIntervalMs;
+		nFps = m_config.captureFps;
+		nBitrate = m_config.videoBitrate;
+		nAudioBitrate = m_config.audioBitrate;
+		random.seed(m_random());
+	}
+
+	// fps of what the capture handler really sent during the last interval. there is no
+	// encoder, the video kbps is the target bitrate scaled by the share of frames that
+	// arrived and the audio kbps that of the audio config; the byte counters stay raw
+	int64_t nVideoCount = m_nSentVideoFrames, nAudioCount = m_nSentAudioFrames;
+	int64_t nVideo = m_nSentVideoBytes, nAudio = m_nSentAudioBytes;
+	double seconds = nIntervalMs / 1000.0;
+	if (eventHandler)
+	{
+		ZegoPublishStreamQuality quality;
+		memset(&quality, 0, sizeof(quality));
+		quality.videoCaptureFPS = quality.videoEncodeFPS = quality.videoSendFPS = (nVideoCount - nVideoFrames) / seconds;
+		quality.audioCaptureFPS = quality.audioSendFPS = (nAudioCount - nAudioFrames) / seconds;
+		quality.videoKBPS = nFps > 0 ? nBitrate * std::min(1.0, quality.videoSendFPS / nFps) : 0;
+		quality.audioKBPS = quality.audioSendFPS > 0 ? nAudioBitrate : 0;
+		quality.rtt = 20 + std::uniform_int_distribution<int>(0, 40)(random);
+		quality.level = ZEGO_STREAM_QUALITY_LEVEL_EXCELLENT;
+		quality.videoSendBytes = nVideo;
+		quality.audioSendBytes = nAudio;
+		quality.totalSendBytes = nVideo + nAudio;
+		eventHandler->onPublisherQualityUpdate(streamID, quality);
+	}
+
+	m_loop.Post(nIntervalMs, [this, nGeneration, streamID, nVideoCount, nAudioCount, nVideo, nAudio]() {
+		PublishQuality(nGeneration, streamID, nVideoCount, nAudioCount, nVideo, nAudio);
+	});
+}
+
+// one onPlayerQualityUpdate per stream being played, until the next login/logout
+void CMockZegoExpressEngine::PlayQuality(unsigned int nGeneration)
+{
+	auto eventHandler = GetEventHandler();
+	if (nGeneration != m_nGeneration)
+		return;
+
+	int nIntervalMs = 0;
+	std::vector<std::string> streams;
+	std::set<std::string> baseLayerStreams;
+	std::set<std::string> videoMutedStreams;
+	std::minstd_rand random;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		nIntervalMs = m_config.qualityIntervalMs;
+		streams.assign(m_playingStreams.begin(), m_playingStreams.end());
+		baseLayerStreams = m_baseLayerStreams;
+		videoMutedStreams = m_videoMutedStreams;
+		random.seed(m_random());
+	}
+
+	for (size_t i = 0; eventHandler && i < streams.size(); i++)
+	{
+		ZegoPlayStreamQuality quality;
+		memset(&quality, 0, sizeof(quality));
+		quality.videoRecvFPS = quality.videoDecodeFPS = quality.videoRenderFPS = 15;
+		quality.videoKBPS = 800 + std::uniform_int_distribution<int>(0, 400)(random);
+		if (baseLayerStreams.count(streams[i]))
+			quality.videoKBPS /= 4;
+		if (videoMutedStreams.count(streams[i]))
+			quality.videoRecvFPS = quality.videoDecodeFPS = quality.videoRenderFPS = quality.videoKBPS = 0;
+		quality.audioRecvFPS = quality.audioDecodeFPS = quality.audioRenderFPS = 50;
+		quality.audioKBPS = 48;
+		quality.rtt = 20 + std::uniform_int_distribution<int>(0, 40)(random);
+		quality.peerToPeerDelay = 10 + std::uniform_int_distribution<int>(0, 40)(random);
+		quality.delay = 30;
+		quality.level = ZEGO_STREAM_QUALITY_LEVEL_EXCELLENT;
+		eventHandler->onPlayerQualityUpdate(streams[i], quality);
+	}
+
+	m_loop.Post(nIntervalMs, [this, nGeneration]() { PlayQuality(nGeneration); });
+}
+
+void CMockZegoExpressEngine::setVideoConfig(ZegoVideoConfig config, ZegoPublishChannel channel)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_videoConfig = config;
+	if (config.captureWidth > 0 && config.captureHeight > 0)
+	{
+		m_config.captureWidth = config.captureWidth;
+		m_config.captureHeight = config.captureHeight;
+	}
+	if (config.fps > 0)
+		m_config.captureFps = config.fps;
+	if (config.bitrate > 0)
+		m_config.videoBitrate = config.bitrate;
+}
+
+ZegoVideoConfig CMockZegoExpressEngine::getVideoConfig(ZegoPublishChannel channel)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_videoConfig;
+}
+
+void CMockZegoExpressEngine::setAudioConfig(ZegoAudioConfig config)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (config.bitrate > 0)
+		m_config.audioBitrate = config.bitrate;
+}
+
+IZegoMediaPlayer* CMockZegoExpressEngine::createMediaPlayer()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	// same limit as the real engine
+	if (m_mediaPlayers.size() >= 4)
+		return nullptr;
+
+	auto lpPlayer = new CMockZegoMediaPlayer((int)m_mediaPlayers.size(), &m_loop, m_config);
+	m_mediaPlayers.push_back(lpPlayer);
+	return lpPlayer;
+}
+
+void CMockZegoExpressEngine::destroyMediaPlayer(IZegoMediaPlayer*& mediaPlayer)
+{
+	CMockZegoMediaPlayer* lpPlayer = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		auto it = std::find(m_mediaPlayers.begin(), m_mediaPlayers.end(), mediaPlayer);
+		if (it != m_mediaPlayers.end())
+		{
+			lpPlayer = *it;
+			m_mediaPlayers.erase(it);
+		}
+	}
+	delete lpPlayer;
+	mediaPlayer = nullptr;
+}
+
+void CMockZegoExpressEngine::enableCustomVideoCapture(bool enable, ZegoCustomVideoCaptureConfig* config, ZegoPublishChannel channel)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_bCustomCapture = enable;
+}
+
+void CMockZegoExpressEngine::setCustomVideoCaptureHandler(std::shared_ptr<IZegoCustomVideoCaptureHandler> handler)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_captureHandler = handler;
+}
+
+void CMockZegoExpressEngine::sendCustomVideoCaptureRawData(const unsigned char* data, unsigned int dataLength, ZegoVideoFrameParam params, unsigned long long referenceTimeMillisecond, ZegoPublishChannel channel)
+{
+	m_nSentVideoFrames++;
+	m_nSentVideoBytes += dataLength;
+}
+
+void CMockZegoExpressEngine::sendCustomAudioCapturePCMData(unsigned char * data, unsigned int dataLength, ZegoAudioFrameParam param, ZegoPublishChannel channel)
+{
+	m_nSentAudioFrames++;
+	m_nSentAudioBytes += dataLength;
+}
+
+void CMockZegoExpressEngine::enableCustomAudioIO(bool enable, ZegoCustomAudioConfig* config, ZegoPublishChannel channel)
+{
+	std::lock_guard<std::mutex> lock(m_lockAudioRender);
+	m_bCustomAudioIO = enable;
+	m_dRenderPhase = 0;
+}
+
+// the mix of the played streams is a tone at -12 dBFS, a dropped frame is all zeros like a decoder that ran dry
+void CMockZegoExpressEngine::fetchCustomAudioRenderPCMData(unsigned char * data, unsigned int dataLength, ZegoAudioFrameParam param)
+{
+	int nChannels = param.channel == ZEGO_AUDIO_CHANNEL_STEREO ? 2 : 1;
+	if (!data || param.sampleRate <= 0 || dataLength < (unsigned int)(2 * nChannels))
+		return;
+
+	bool bPlaying = false;
+	int nDropPermille = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		bPlaying = !m_playingStreams.empty();
+		nDropPermille = m_config.audioDropPermille;
+	}
+
+	std::lock_guard<std::mutex> lock(m_lockAudioRender);
+	int16_t* lpPcm = (int16_t*)data;
+	int nSamples = (int)(dataLength / 2 / nChannels);
+	double dStep = 2 * M_PI * 440 / param.sampleRate;
+	bool bDrop = nDropPermille > 0 && std::uniform_int_distribution<int>(0, 999)(m_renderRandom) < nDropPermille;
+	if (!m_bCustomAudioIO || !bPlaying || bDrop)
+		memset(data, 0, dataLength);
+	else
+	{
+		for (int i = 0; i < nSamples; i++)
+		{
+			int16_t nSample = (int16_t)(8192 * sin(m_dRenderPhase + dStep * i));
+			for (int c = 0; c < nChannels; c++)
+				lpPcm[i * nChannels + c] = nSample;
+		}
+	}
+	// the tone goes on through a dropped frame, like the talker does
+	m_dRenderPhase = fmod(m_dRenderPhase + dStep * nSamples, 2 * M_PI);
+}
+
+void CMockZegoExpressEngine::enableAudioDataCallback(bool enable, unsigned int callbackBitMask, ZegoAudioFrameParam param)
+{
+	m_audioDataCadence.Stop();
+	{
+		std::lock_guard<std::mutex> lock(m_lockAudioData);
+		m_nAudioDataMask = enable ? callbackBitMask : 0;
+		m_audioDataParam = param;
+		m_dAudioDataPhase = 0;
+	}
+	if (enable && param.sampleRate > 0)
+		m_audioDataCadence.Start(10000, [this]() { AudioData(); });
+}
+
+void CMockZegoExpressEngine::setAudioDataHandler(std::shared_ptr<IZegoAudioDataHandler> handler)
+{
+	std::lock_guard<std::mutex> lock(m_lockAudioData);
+	m_audioDataHandler = handler;
+}
+
+// the played streams and their mix with the capture both carry the tone of the render
+void CMockZegoExpressEngine::AudioData()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_playingStreams.empty())
+			return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_lockAudioData);
+	if (!m_audioDataHandler)
+		return;
+	int nChannels = m_audioDataParam.channel == ZEGO_AUDIO_CHANNEL_STEREO ? 2 : 1;
+	int nSamples = m_audioDataParam.sampleRate / 100;
+	double dStep = 2 * M_PI * 440 / m_audioDataParam.sampleRate;
+	m_audioDataBuffer.resize((size_t)nSamples * nChannels);
+	for (int i = 0; i < nSamples; i++)
+	{
+		int16_t nSample = (int16_t)(8192 * sin(m_dAudioDataPhase + dStep * i));
+		for (int c = 0; c < nChannels; c++)
+			m_audioDataBuffer[(size_t)i * nChannels + c] = nSample;
+	}
+	m_dAudioDataPhase = fmod(m_dAudioDataPhase + dStep * nSamples, 2 * M_PI);
+
+	const unsigned char* lpData = (const unsigned char*)m_audioDataBuffer.data();
+	unsigned int nLength = (unsigned int)(m_audioDataBuffer.size() * sizeof(int16_t));
+	if (m_nAudioDataMask & ZEGO_AUDIO_DATA_CALLBACK_BIT_MASK_REMOTE)
+		m_audioDataHandler->onRemoteAudioData(lpData, nLength, m_audioDataParam);
+	if (m_nAudioDataMask & ZEGO_AUDIO_DATA_CALLBACK_BIT_MASK_MIXED)
+		m_audioDataHandler->onMixedAudioData(lpData, nLength, m_audioDataParam);
+}
+
+IZegoExpressEngine* MockZegoExpressSDK::createEngine(unsigned int appID, const std::string& appSign, bool isTestEnv, ZegoScenario scenario, std::shared_ptr<IZegoEventHandler> eventHandler)
+{
+	if (!g_lpMockEngine)
+		g_lpMockEngine = new CMockZegoExpressEngine(eventHandler);
+	return g_lpMockEngine;
+}
+
+void MockZegoExpressSDK::destroyEngine(IZegoExpressEngine*& engine, ZegoDestroyCompletionCallback callback)
+{
+	if (engine && engine == g_lpMockEngine)
+	{
+		delete static_cast<CMockZegoExpressEngine*>(engine);
+		g_lpMockEngine = nullptr;
+	}
+	engine = nullptr;
+	if (callback)
+		callback();
+}
+
+IZegoExpressEngine* MockZegoExpressSDK::getEngine()
+{
+	return g_lpMockEngine;
+}
+
+std::string MockZegoExpressSDK::getVersion()
+{
+	return "mock";
+}
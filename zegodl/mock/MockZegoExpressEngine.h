@@ -0,0 +1,292 @@
+#pragma once
+#include <cstring>
+#include "../zego/include/ZegoExpressSDK.h"
+#include "MockEventLoop.h"
+#include "MockCadence.h"
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace ZEGO::EXPRESS;
+
+// knobs of the mock engine, read from the RTC_MOCK_CONFIG environment variable
+// when the engine is created, e.g. {"peers":8,"joinLatencyMs":50}
+struct MOCK_CONFIG
+{
+	int joinLatencyMs = 50;		// loginRoom -> ZEGO_ROOM_STATE_CONNECTED
+	int leaveLatencyMs = 10;	// logoutRoom -> ZEGO_ROOM_STATE_DISCONNECTED
+	int jitterMs = 0;			// uniform 0..jitterMs added to every delay
+	int peers = 0;				// remote publishers already in the room
+	int peerJoinMs = 20;		// stagger between two peers showing up after the login
+	int firstFrameMs = 100;		// startPlayingStream -> onPlayerRecvVideoFirstFrame
+	int peerChurnMs = 0;		// 0 keeps the peers, otherwise each peer leaves and comes back every peerChurnMs
+	int captureWidth = 640;		// media player frames, setVideoConfig overrides the size and fps
+	int captureHeight = 480;
+	int captureFps = 15;
+	int videoBitrate = 1200;	// kbps the publisher quality reports while frames arrive
+	int audioBitrate = 48;		// same for audio, setAudioConfig overrides it
+	int audioSampleRate = 48000;	// media player pcm, delivered every 10ms
+	int audioChannels = 2;
+	int qualityIntervalMs = 3000;	// onPublisherQualityUpdate period while publishing, onPlayerQualityUpdate while in the room
+	int speakerMs = 0;			// 0 keeps the peers silent, otherwise a random played stream becomes the active speaker every speakerMs
+	int remoteFps = 0;			// 0 is off, otherwise the custom render handler gets every played stream at this rate
+	int audioDropPermille = 0;	// fetched custom render frames that come out as digital silence, an underrun
+
+	bool Parse(const char* lpJson);
+};
+
+// media player that decodes nothing: once started it hands a blank frame to the
+// video handler at captureFps and 10ms of silence to the audio handler, each on
+// its own thread like the real decoder
+class CMockZegoMediaPlayer : public IZegoMediaPlayer
+{
+public:
+	CMockZegoMediaPlayer(int nIndex, CMockEventLoop* lpLoop, const MOCK_CONFIG& config);
+	~CMockZegoMediaPlayer();
+
+	virtual void setEventHandler(std::shared_ptr<IZegoMediaPlayerEventHandler> handler) override;
+	virtual void setVideoHandler(std::shared_ptr<IZegoMediaPlayerVideoHandler> handler, ZegoVideoFrameFormat format) override;
+	virtual void setAudioHandler(std::shared_ptr<IZegoMediaPlayerAudioHandler> handler) override;
+	virtual void loadResource(const std::string& path, ZegoMediaPlayerLoadResourceCallback callback) override;
+	virtual void start() override;
+	virtual void stop() override;
+	virtual void pause() override;
+	virtual void resume() override;
+	virtual ZegoMediaPlayerState getCurrentState() override { return m_state; }
+	virtual int getIndex() override { return m_nIndex; }
+
+private:
+	void StartCadence();
+	void StopCadence();
+	void SetState(ZegoMediaPlayerState state);
+	void RenderVideoFrame();
+	void RenderAudioFrame();
+
+	int					m_nIndex;
+	CMockEventLoop*		m_lpLoop;
+	MOCK_CONFIG			m_config;
+	std::mutex			m_mutex;
+	std::atomic<ZegoMediaPlayerState> m_state;
+
+	std::shared_ptr<IZegoMediaPlayerEventHandler>	m_eventHandler;
+	std::shared_ptr<IZegoMediaPlayerVideoHandler>	m_videoHandler;
+	std::shared_ptr<IZegoMediaPlayerAudioHandler>	m_audioHandler;
+
+	ZegoVideoFrameFormat	m_videoFormat;
+	ZegoVideoFrameParam		m_videoParam;
+	std::vector<unsigned char> m_videoBuffer;
+	const unsigned char*	m_videoPlanes[4];
+	unsigned int			m_videoPlaneLength[4];
+	CMockCadence			m_videoCadence;
+
+	ZegoAudioFrameParam		m_audioParam;
+	std::vector<unsigned char> m_audioBuffer;
+	CMockCadence			m_audioCadence;
+
+public:
+	// not simulated
+	virtual void seekTo(unsigned long long millisecond, ZegoMediaPlayerSeekToCallback callback) override {}
+	virtual void enableRepeat(bool enable) override {}
+	virtual void enableAux(bool enable) override {}
+	virtual void muteLocal(bool mute) override {}
+	virtual void setPlayerCanvas(ZegoCanvas* canvas) override {}
+	virtual void setVolume(int volume) override {}
+	virtual void setProgressInterval(unsigned long long millisecond) override {}
+	virtual int getVolume() override { return 100; }
+	virtual unsigned long long getTotalDuration() override { return 0; }
+	virtual unsigned long long getCurrentProgress() override { return 0; }
+};
+
+// in process stand in for the express engine, no network and no devices.
+// room and player events arrive on a private callback thread after the
+// configured latency. publishing with custom capture starts the capture
+// handler and counts what it sends, everything else does nothing.
+class CMockZegoExpressEngine : public IZegoExpressEngine
+{
+public:
+	CMockZegoExpressEngine(std::shared_ptr<IZegoEventHandler> eventHandler);
+	~CMockZegoExpressEngine();
+
+	virtual void setEventHandler(std::shared_ptr<IZegoEventHandler> eventHandler) override;
+	virtual void loginRoom(const std::string& roomID, ZegoUser user) override;
+	virtual void loginRoom(const std::string& roomID, ZegoUser user, ZegoRoomConfig config) override;
+	virtual void logoutRoom(const std::string& roomID) override;
+	virtual void startPlayingStream(const std::string& streamID, ZegoCanvas* canvas) override;
+	// the base layer is reported at a fraction of the bitrate
+	virtual void startPlayingStream(const std::string& streamID, ZegoCanvas* canvas, ZegoPlayerConfig config) override;
+	virtual void stopPlayingStream(const std::string& streamID) override;
+	virtual void startPublishingStream(const std::string& streamID, ZegoPublishChannel channel = ZEGO_PUBLISH_CHANNEL_MAIN) override;
+	virtual void stopPublishingStream(ZegoPublishChannel channel = ZEGO_PUBLISH_CHANNEL_MAIN) override;
+	virtual void setVideoConfig(ZegoVideoConfig config, ZegoPublishChannel channel = ZEGO_PUBLISH_CHANNEL_MAIN) override;
+	virtual ZegoVideoConfig getVideoConfig(ZegoPublishChannel channel = ZEGO_PUBLISH_CHANNEL_MAIN) override;
+	// a stream with its video muted reports no video bitrate
+	virtual void mutePlayStreamVideo(const std::string& streamID, bool mute) override;
+	// onRemoteSoundLevelUpdate of the played streams every 100ms until stopped
+	virtual void startSoundLevelMonitor() override;
+	virtual void stopSoundLevelMonitor() override;
+	virtual void setAudioConfig(ZegoAudioConfig config) override;
+	virtual IZegoMediaPlayer* createMediaPlayer() override;
+	virtual void destroyMediaPlayer(IZegoMediaPlayer*& mediaPlayer) override;
+	virtual void enableCustomVideoCapture(bool enable, ZegoCustomVideoCaptureConfig* config, ZegoPublishChannel channel = ZEGO_PUBLISH_CHANNEL_MAIN) override;
+	virtual void setCustomVideoCaptureHandler(std::shared_ptr<IZegoCustomVideoCaptureHandler> handler) override;
+	virtual void sendCustomVideoCaptureRawData(const unsigned char* data, unsigned int dataLength, ZegoVideoFrameParam params, unsigned long long referenceTimeMillisecond, ZegoPublishChannel channel = ZEGO_PUBLISH_CHANNEL_MAIN) override;
+	virtual void sendCustomAudioCapturePCMData(unsigned char * data, unsigned int dataLength, ZegoAudioFrameParam param, ZegoPublishChannel channel = ZEGO_PUBLISH_CHANNEL_MAIN) override;
+	// with custom render on, the handler gets the decoded I420 of the played streams at remoteFps
+	virtual void enableCustomVideoRender(bool enable, ZegoCustomVideoRenderConfig* config) override;
+	virtual void setCustomVideoRenderHandler(std::shared_ptr<IZegoCustomVideoRenderHandler> handler) override;
+	virtual void enableCustomAudioIO(bool enable, ZegoCustomAudioConfig* config, ZegoPublishChannel channel = ZEGO_PUBLISH_CHANNEL_MAIN) override;
+	// with custom audio IO on, a 440Hz tone while streams are played and digital silence otherwise
+	virtual void fetchCustomAudioRenderPCMData(unsigned char * data, unsigned int dataLength, ZegoAudioFrameParam param) override;
+	// onRemoteAudioData and onMixedAudioData of the mask every 10ms while streams are played, a 440Hz tone
+	virtual void enableAudioDataCallback(bool enable, unsigned int callbackBitMask, ZegoAudioFrameParam param) override;
+	virtual void setAudioDataHandler(std::shared_ptr<IZegoAudioDataHandler> handler) override;
+
+private:
+	int Delay(int nMs);
+	std::shared_ptr<IZegoEventHandler> GetEventHandler();
+	void PeerJoin(unsigned int nGeneration, const std::string& userID, int nDelayMs);
+	void PeerUpdate(unsigned int nGeneration, const std::string& userID, ZegoUpdateType updateType);
+	// the counters are cumulative, the values of the previous report come back in the arguments
+	void PublishQuality(unsigned int nGeneration, const std::string& streamID, int64_t nVideoFrames, int64_t nAudioFrames, int64_t nVideoBytes, int64_t nAudioBytes);
+	void PlayQuality(unsigned int nGeneration);
+	void SoundLevel(unsigned int nGeneration);
+	// one frame of every played stream with its video on, the base layer at 160x120
+	void RenderRemoteVideo(unsigned int nGeneration);
+	void AudioData();
+
+	CMockEventLoop		m_loop;
+	std::mutex			m_mutex;
+	MOCK_CONFIG			m_config;
+	std::mt19937		m_random;
+	std::shared_ptr<IZegoEventHandler> m_eventHandler;
+	std::string			m_roomID;
+	std::set<std::string> m_playingStreams;
+	std::set<std::string> m_baseLayerStreams;
+	std::set<std::string> m_videoMutedStreams;
+	// bumped by every start/stop of the sound level monitor
+	std::atomic<unsigned int> m_nSoundLevelGeneration;
+	std::string			m_activeSpeaker;
+	int					m_nSpeakerElapsedMs;
+	ZegoVideoConfig		m_videoConfig;
+	// bumped by every login/logout, stale callbacks of an earlier session are dropped
+	std::atomic<unsigned int> m_nGeneration;
+
+	// the decoder, at remoteFps while in the room
+	bool				m_bCustomRender;
+	std::shared_ptr<IZegoCustomVideoRenderHandler> m_renderHandler;
+	CMockCadence		m_renderCadence;
+	std::vector<unsigned char> m_renderBuffer;
+	int64_t				m_nRenderTicks;
+
+	std::vector<CMockZegoMediaPlayer*> m_mediaPlayers;
+	bool				m_bCustomCapture;
+	std::shared_ptr<IZegoCustomVideoCaptureHandler> m_captureHandler;
+	std::shared_ptr<IZegoCustomVideoCaptureHandler> m_startedHandler;
+	std::string			m_publishStreamID;
+	// bumped by every start/stop publishing, ends the quality reports
+	std::atomic<unsigned int> m_nPublishGeneration;
+	std::atomic<int64_t> m_nSentVideoFrames;
+	std::atomic<int64_t> m_nSentAudioFrames;
+	std::atomic<int64_t> m_nSentVideoBytes;
+	std::atomic<int64_t> m_nSentAudioBytes;
+
+	// the custom audio render, under m_lockAudioRender
+	std::mutex			m_lockAudioRender;
+	bool				m_bCustomAudioIO;
+	double				m_dRenderPhase;
+	std::mt19937		m_renderRandom;
+
+	// the audio data callbacks, under m_lockAudioData. the cadence is stopped before it changes
+	std::mutex			m_lockAudioData;
+	std::shared_ptr<IZegoAudioDataHandler> m_audioDataHandler;
+	unsigned int		m_nAudioDataMask;
+	ZegoAudioFrameParam	m_audioDataParam;
+	double				m_dAudioDataPhase;
+	std::vector<int16_t> m_audioDataBuffer;
+	CMockCadence		m_audioDataCadence;
+
+public:
+	// not simulated
+	virtual void uploadLog() override {}
+	virtual void setDebugVerbose(bool enable, ZegoLanguage language) override {}
+	virtual void loginMultiRoom(const std::string& roomID, ZegoRoomConfig* config = nullptr) override {}
+	virtual void setRoomExtraInfo(const std::string& roomID, const std::string& key, const std::string& value, ZegoRoomSetRoomExtraInfoCallback callback) override {}
+	virtual void setStreamExtraInfo(const std::string& extraInfo, ZegoPublisherSetStreamExtraInfoCallback callback, ZegoPublishChannel channel = ZEGO_PUBLISH_CHANNEL_MAIN) override {}
+	virtual void startPreview(ZegoCanvas* canvas, ZegoPublishChannel channel = ZEGO_PUBLISH_CHANNEL_MAIN) override {}
+	virtual void stopPreview(ZegoPublishChannel channel = ZEGO_PUBLISH_CHANNEL_MAIN) override {}
+	virtual void setVideoMirrorMode(ZegoVideoMirrorMode mirrorMode, ZegoPublishChannel channel = ZEGO_PUBLISH_CHANNEL_MAIN) override {}
+	virtual void setAppOrientation(ZegoOrientation orientation, ZegoPublishChannel channel = ZEGO_PUBLISH_CHANNEL_MAIN) override {}
+	virtual ZegoAudioConfig getAudioConfig() override { return {}; }
+	virtual void mutePublishStreamAudio(bool mute, ZegoPublishChannel channel = ZEGO_PUBLISH_CHANNEL_MAIN) override {}
+	virtual void mutePublishStreamVideo(bool mute, ZegoPublishChannel channel = ZEGO_PUBLISH_CHANNEL_MAIN) override {}
+	virtual void enableTrafficControl(bool enable, int property) override {}
+	virtual void setMinVideoBitrateForTrafficControl(int bitrate, ZegoTrafficControlMinVideoBitrateMode mode) override {}
+	virtual void setCaptureVolume(int volume) override {}
+	virtual void addPublishCdnUrl(const std::string& streamID, const std::string& targetURL, ZegoPublisherUpdateCdnUrlCallback callback) override {}
+	virtual void removePublishCdnUrl(const std::string& streamID, const std::string& targetURL, ZegoPublisherUpdateCdnUrlCallback callback) override {}
+	virtual void enablePublishDirectToCDN(bool enable, ZegoCDNConfig* config, ZegoPublishChannel channel = ZEGO_PUBLISH_CHANNEL_MAIN) override {}
+	virtual void setPublishWatermark(ZegoWatermark* watermark, bool isPreviewVisible, ZegoPublishChannel channel = ZEGO_PUBLISH_CHANNEL_MAIN) override {}
+	virtual void sendSEI(const unsigned char* data, unsigned int dataLength, ZegoPublishChannel channel = ZEGO_PUBLISH_CHANNEL_MAIN) override {}
+	virtual void enableHardwareEncoder(bool enable) override {}
+	virtual void setCapturePipelineScaleMode(ZegoCapturePipelineScaleMode mode) override {}
+	virtual void setPlayVolume(const std::string& streamID, int volume) override {}
+	virtual void mutePlayStreamAudio(const std::string& streamID, bool mute) override {}
+	virtual void enableHardwareDecoder(bool enable) override {}
+	virtual void enableCheckPoc(bool enable) override {}
+	virtual void startMixerTask(ZegoMixerTask task, ZegoMixerStartCallback callback) override {}
+	virtual void stopMixerTask(ZegoMixerTask task, ZegoMixerStopCallback callback) override {}
+	virtual void muteMicrophone(bool mute) override {}
+	virtual bool isMicrophoneMuted() override { return false; }
+	virtual void muteSpeaker(bool mute) override {}
+	virtual bool isSpeakerMuted() override { return false; }
+	virtual void useAudioDevice(ZegoAudioDeviceType deviceType, const std::string& deviceID) override {}
+	virtual std::vector<ZegoDeviceInfo> getAudioDeviceList(ZegoAudioDeviceType deviceType) override { return {}; }
+	virtual void enableAudioCaptureDevice(bool enable) override {}
+	virtual void enableCamera(bool enable, ZegoPublishChannel channel = ZEGO_PUBLISH_CHANNEL_MAIN) override {}
+	virtual void useVideoDevice(const std::string& deviceID, ZegoPublishChannel channel = ZEGO_PUBLISH_CHANNEL_MAIN) override {}
+	virtual std::vector<ZegoDeviceInfo> getVideoDeviceList() override { return {}; }
+	virtual void startAudioSpectrumMonitor() override {}
+	virtual void stopAudioSpectrumMonitor() override {}
+	virtual void enableHeadphoneMonitor(bool enable) override {}
+	virtual void setHeadphoneMonitorVolume(int volume) override {}
+	virtual void enableMixSystemPlayout(bool enable) override {}
+	virtual void enableAEC(bool enable) override {}
+	virtual void setAECMode(ZegoAECMode mode) override {}
+	virtual void enableAGC(bool enable) override {}
+	virtual void enableANS(bool enable) override {}
+	virtual void setANSMode(ZegoANSMode mode) override {}
+	virtual void enableAudioMixing(bool enable) override {}
+	virtual void setAudioMixingHandler(std::shared_ptr<IZegoAudioMixingHandler> handler) override {}
+	virtual void muteLocalAudioMixing(bool mute) override {}
+	virtual void setAudioMixingVolume(int volume, ZegoVolumeType type) override {}
+	virtual void setAudioEqualizerGain(int bandIndex, float bandGain) override {}
+	virtual void setVoiceChangerParam(ZegoVoiceChangerParam param) override {}
+	virtual void setReverbParam(ZegoReverbParam param) override {}
+	virtual void enableVirtualStereo(bool enable, int angle) override {}
+	virtual void sendBroadcastMessage(const std::string& roomID, const std::string& message, ZegoIMSendBroadcastMessageCallback callback) override {}
+	virtual void sendBarrageMessage(const std::string& roomID, const std::string& message, ZegoIMSendBarrageMessageCallback callback) override {}
+	virtual void sendCustomCommand(const std::string& roomID, const std::string& command, std::vector<ZegoUser> toUserList, ZegoIMSendCustomCommandCallback callback) override {}
+	virtual void startRecordingCapturedData(ZegoDataRecordConfig config, ZegoPublishChannel channel = ZEGO_PUBLISH_CHANNEL_MAIN) override {}
+	virtual void stopRecordingCapturedData(ZegoPublishChannel channel = ZEGO_PUBLISH_CHANNEL_MAIN) override {}
+	virtual void setDataRecordEventHandler(std::shared_ptr<IZegoDataRecordEventHandler> eventHandler) override {}
+	virtual void sendCustomVideoCaptureEncodedData(const unsigned char* data, unsigned int dataLength, ZegoVideoEncodedFrameParam params, unsigned long long referenceTimeMillisecond, ZegoPublishChannel channel = ZEGO_PUBLISH_CHANNEL_MAIN) override {}
+	virtual void setCustomVideoCaptureFillMode(ZegoViewMode mode, ZegoPublishChannel channel = ZEGO_PUBLISH_CHANNEL_MAIN) override {}
+	virtual void enableCustomAudioCaptureProcessing(bool enable, ZegoCustomAudioProcessConfig* config) override {}
+	virtual void enableCustomAudioRemoteProcessing(bool enable, ZegoCustomAudioProcessConfig* config) override {}
+	virtual void setCustomAudioProcessHandler(std::shared_ptr<IZegoCustomAudioProcessHandler> handler) override {}
+	virtual void sendCustomAudioCaptureAACData(unsigned char * data, unsigned int dataLength, unsigned int configLength, unsigned long long referenceTimeMillisecond, ZegoAudioFrameParam param, ZegoPublishChannel channel = ZEGO_PUBLISH_CHANNEL_MAIN) override {}
+	virtual void muteAudioOutput(bool mute) override {}
+};
+
+// same static surface as ZegoExpressSDK, picked by ZegoObject.h when ZEGODL_MOCK_SDK is set
+class MockZegoExpressSDK
+{
+public:
+	static IZegoExpressEngine* createEngine(unsigned int appID, const std::string& appSign, bool isTestEnv, ZegoScenario scenario, std::shared_ptr<IZegoEventHandler> eventHandler);
+	static void destroyEngine(IZegoExpressEngine*& engine, ZegoDestroyCompletionCallback callback = nullptr);
+	static IZegoExpressEngine* getEngine();
+	static std::string getVersion();
+};
@@ -0,0 +1,148 @@
+#include "CommandQueue.h"
+#include "ZegoObject.h"
+#include "ZegoBackend.h"
+#include "CircleBuffer.h"
+#include "Logger.h"
+#include "Singleton.h"
+
+RTC_DEFINE_SINGLETON(CCommandQueue)
+
+// post config items, they are checked here so a bad batch is refused
+// before anything reaches the engine
+// lpItems: items to copy into the queue
+// nCount: number of items
+// returns ticket of the last item, or a negative ZEGO_CONFIG_RESULT
+int64_t CCommandQueue::PostConfig(const ZEGO_CONFIG_ITEM* lpItems, int nCount)
+{
+	if (nCount <= 0 || lpItems == nullptr)
+		return ZEGO_CONFIG_ERR_INVALID_ARG;
+
+	for (int i = 0; i < nCount; i++)
+	{
+		int nResult = CZegoConfig::Validate(lpItems[i]);
+		if (nResult != ZEGO_CONFIG_OK)
+			return nResult;
+	}
+
+	return PostItems(lpItems, nCount);
+}
+
+bool CCommandQueue::TakesText(int nType)
+{
+	return nType == ENGINE_COMMAND_CAP_MEDIA || nType == ENGINE_COMMAND_RECORDING_DEVICE
+		|| nType == ENGINE_COMMAND_VIDEO_DEVICE;
+}
+
+int CCommandQueue::Execute(ENGINE_COMMAND& command)
+{
+	switch (command.nType)
+	{
+	case ENGINE_COMMAND_CONFIG:
+		return CZegoConfig::Apply(command.item);
+	case ENGINE_COMMAND_CONFIG_BATCH:
+		return CZegoConfig::ApplyBatch(command.lpItems, command.nCount);
+	case ENGINE_COMMAND_LEAVE_CHANNEL:
+		CZegoObject::GetZegoObject()->logoutRoom();
+		return ZEGO_CONFIG_OK;
+	}
+	return ExecuteEngineCommand(command);
+}
+
+// the engine must exist already, getEngine would create it on this thread and
+// zego delivers its callbacks to the thread that created the engine
+int CCommandQueue::ExecuteEngineCommand(ENGINE_COMMAND& command)
+{
+	if (command.nType < ENGINE_COMMAND_VENDOR || command.nType > ENGINE_COMMAND_CUSTOM_AUDIO_PUSH)
+		return ZEGO_CONFIG_ERR_TYPE;
+	if (!CZegoBackend::GetInstance()->HasEngine())
+	{
+		LOG_WARN("engine command %d before createEngine, dropped", command.nType);
+		return ZEGO_CONFIG_ERR_SDK;
+	}
+
+	CZegoObject* lpZegoObject = CZegoObject::GetZegoObject();
+	IZegoExpressEngine* lpEngine = lpZegoObject->getEngine();
+	switch (command.nType)
+	{
+	case ENGINE_COMMAND_ENABLE_VIDEO:
+	{
+		string strOutput;
+		lpZegoObject->enableVideo(nullptr, strOutput);
+		break;
+	}
+	case ENGINE_COMMAND_DISABLE_VIDEO:
+		lpZegoObject->disableVideo();
+		break;
+	case ENGINE_COMMAND_DISABLE_AUDIO:
+		lpZegoObject->disableAudio();
+		break;
+	case ENGINE_COMMAND_DISABLE_AEC:
+		lpEngine->enableAEC(false);
+		break;
+	case ENGINE_COMMAND_DISABLE_ANS:
+		lpEngine->enableANS(false);
+		break;
+	case ENGINE_COMMAND_DISABLE_AGC:
+		lpEngine->enableAGC(false);
+		break;
+	case ENGINE_COMMAND_MUTE_MICROPHONE:
+		lpEngine->muteMicrophone(true);
+		break;
+	case ENGINE_COMMAND_MUTE_SPEAKER:
+		lpEngine->muteSpeaker(true);
+		break;
+	case ENGINE_COMMAND_STOP_PREVIEW:
+		lpEngine->stopPreview(ZEGO::EXPRESS::ZEGO_PUBLISH_CHANNEL_MAIN);
+		break;
+	case ENGINE_COMMAND_STOP_PLAYING_STREAM:
+		lpZegoObject->stopPlayingStream();
+		break;
+	case ENGINE_COMMAND_CUSTOM_VIDEO_CAPTURE:
+		lpZegoObject->enableCustomVideoCapture();
+		break;
+	case ENGINE_COMMAND_CUSTOM_AUDIO_IO:
+		lpZegoObject->enableCustomAudioIO();
+		break;
+	case ENGINE_COMMAND_CAP_MEDIA:
+		lpZegoObject->startCapMedia(command.lpText);
+		break;
+	case ENGINE_COMMAND_RECORDING_DEVICE:
+		lpEngine->useAudioDevice(ZEGO_AUDIO_DEVICE_TYPE_INPUT, command.lpText);
+		break;
+	case ENGINE_COMMAND_VIDEO_DEVICE:
+		lpEngine->useVideoDevice(command.lpText);
+		break;
+	case ENGINE_COMMAND_LOG_RECORDING_DEVICES:
+	{
+		auto adl = lpEngine->getAudioDeviceList(ZEGO_AUDIO_DEVICE_TYPE_INPUT);
+		SetConsoleOutputCP(65001);
+		LOG_INFO("Audio Recording Devices");
+		for (auto& device : adl)
+			LOG_INFO("deviceName:%s deviceId:%s", device.deviceName.c_str(), device.deviceID.c_str());
+		break;
+	}
+	case ENGINE_COMMAND_LOG_VIDEO_DEVICES:
+	{
+		auto vdl = lpEngine->getVideoDeviceList();
+		SetConsoleOutputCP(65001);
+		LOG_INFO("Video Recording Devices");
+		for (auto& device : vdl)
+			LOG_INFO("deviceName:%s deviceId:%s", device.deviceName.c_str(), device.deviceID.c_str());
+		break;
+	}
+	case ENGINE_COMMAND_ENABLE_AUDIO:
+		lpZegoObject->enableAudio(true);
+		break;
+	case ENGINE_COMMAND_CUSTOM_VIDEO_PUSH:
+		lpZegoObject->enableCustomVideoCapture();
+		lpZegoObject->startCapPush();
+		break;
+	case ENGINE_COMMAND_CUSTOM_AUDIO_PUSH:
+		// the capture thread sends the pushed PCM in 20ms frames
+		CircleBuffer::GetInstance()->setAudioInfo(command.nArgs[0], command.nArgs[1]);
+		lpZegoObject->enableCustomAudioIO(ZEGO_AUDIO_SOURCE_TYPE_CUSTOM);
+		lpZegoObject->startCapPush();
+		break;
+	}
+	return ZEGO_CONFIG_OK;
+}
@@ -0,0 +1,181 @@
+#include "ZegoBackend.h"
+#include "ZegoObject.h"
+#include "ZegoConfig.h"
+#include "ZegoEvent.h"
+#include "ZegoStatsSchema.h"
+#include "CommandQueue.h"
+#include "Logger.h"
+#include "Singleton.h"
+#include <stdlib.h>
+#include <string.h>
+
+IRtcBackend* GetRtcBackend()
+{
+	return CZegoBackend::GetInstance();
+}
+
+RTC_DEFINE_SINGLETON(CZegoBackend)
+
+CZegoBackend::CZegoBackend()
+	: m_bEngine(false)
+{
+}
+
+const STATS_SCHEMA_SET& CZegoBackend::GetStatsSchemas()
+{
+	return g_zegoStatsSchemas;
+}
+
+static ZEGO_CONFIG_ITEM MakeConfigItem(ZEGO_CONFIG_TYPE type)
+{
+	ZEGO_CONFIG_ITEM item;
+	memset(&item, 0, sizeof(item));
+	item.nType = type;
+	return item;
+}
+
+// the app id and sign are built into CZegoObject, lpAppId is not used
+int CZegoBackend::CreateEngine(const char* /*lpAppId*/)
+{
+	string strOutput;
+	// the event ring is allocated here, before the engine can call back
+	CZegoEventRing::GetInstance();
+	CZegoObject::GetZegoObject()->createEngine(nullptr, strOutput);
+	if (!strOutput.empty())
+		LOG_INFO("%s", strOutput.c_str());
+
+	LOG_INFO("zego version:%s", ZegoSDK::getVersion().c_str());
+	m_bEngine = true;
+	return RTC_OK;
+}
+
+void CZegoBackend::DestroyEngine()
+{
+	// whatever is still queued runs against the engine before it goes away
+	CCommandQueue::GetInstance()->Stop();
+	CZegoObject::GetZegoObject()->destroyZegoEngine();
+	m_bEngine = false;
+}
+
+// lpUserId is the user id, user name and stream id at once
+int CZegoBackend::JoinChannel(const char* lpChannelId, const char* lpUserId)
+{
+	ZEGO_CONFIG_ITEM item = MakeConfigItem(ZEGO_CONFIG_LOGIN_ROOM);
+	CZegoConfig::CopyId(item.config.login.szRoomId, sizeof(item.config.login.szRoomId), lpChannelId);
+	CZegoConfig::CopyId(item.config.login.szUserId, sizeof(item.config.login.szUserId), lpUserId);
+	return CCommandQueue::GetInstance()->Run(&item, 1);
+}
+
+int CZegoBackend::WaitJoinChannel(int nTimeoutMs)
+{
+	int nElapsedMs = CZegoObject::GetZegoObject()->waitLoginRoom(nTimeoutMs);
+	return nElapsedMs < 0 ? RTC_ERR_TIMEOUT : nElapsedMs;
+}
+
+int CZegoBackend::LeaveChannel()
+{
+	return CCommandQueue::GetInstance()->RunLeaveChannel();
+}
+
+int CZegoBackend::EnableVideo(bool bEnable)
+{
+	ZEGO_CONFIG_ITEM item = MakeConfigItem(ZEGO_CONFIG_ENABLE_VIDEO);
+	item.config.enable.bEnable = bEnable ? 1 : 0;
+	return CCommandQueue::GetInstance()->Run(&item, 1);
+}
+
+// there is no config item for it, the calls only set flags in the sdk
+int CZegoBackend::EnableAudio(bool bEnable)
+{
+	return CCommandQueue::GetInstance()->RunCommand(bEnable ? ENGINE_COMMAND_ENABLE_AUDIO : ENGINE_COMMAND_DISABLE_AUDIO);
+}
+
+int CZegoBackend::EnableDualStream(bool bEnable)
+{
+	ZEGO_CONFIG_ITEM item = MakeConfigItem(ZEGO_CONFIG_DUAL_STREAM);
+	item.config.enable.bEnable = bEnable ? 1 : 0;
+	return CCommandQueue::GetInstance()->Run(&item, 1);
+}
+
+int CZegoBackend::EnableHeadless(bool bEnable)
+{
+	ZEGO_CONFIG_ITEM item = MakeConfigItem(ZEGO_CONFIG_HEADLESS);
+	item.config.enable.bEnable = bEnable ? 1 : 0;
+	return CCommandQueue::GetInstance()->Run(&item, 1);
+}
+
+int CZegoBackend::EnableRemoteVideoFrames(bool bEnable)
+{
+	ZEGO_CONFIG_ITEM item = MakeConfigItem(ZEGO_CONFIG_REMOTE_VIDEO_FRAMES);
+	item.config.enable.bEnable = bEnable ? 1 : 0;
+	return CCommandQueue::GetInstance()->Run(&item, 1);
+}
+
+// the format is only given to each fetch, it has to be a ZegoAudioSampleRate
+int CZegoBackend::EnableAudioSink(bool bEnable, int nSampleRate, int /*nChannels*/)
+{
+	if (bEnable && nSampleRate != ZEGO_AUDIO_SAMPLE_RATE_8K && nSampleRate != ZEGO_AUDIO_SAMPLE_RATE_16K
+		&& nSampleRate != ZEGO_AUDIO_SAMPLE_RATE_22K && nSampleRate != ZEGO_AUDIO_SAMPLE_RATE_24K
+		&& nSampleRate != ZEGO_AUDIO_SAMPLE_RATE_32K && nSampleRate != ZEGO_AUDIO_SAMPLE_RATE_44K
+		&& nSampleRate != ZEGO_AUDIO_SAMPLE_RATE_48K)
+		return RTC_ERR_INVALID_ARG;
+
+	ZEGO_CONFIG_ITEM item = MakeConfigItem(ZEGO_CONFIG_AUDIO_SINK);
+	item.config.enable.bEnable = bEnable ? 1 : 0;
+	return CCommandQueue::GetInstance()->Run(&item, 1);
+}
+
+// not through the queue, the puller calls every 10ms
+bool CZegoBackend::PullAudioFrame(int16_t* lpPcm, int nSamples, int nSampleRate, int nChannels)
+{
+	CZegoObject::GetZegoObject()->fetchAudioSink(lpPcm, nSamples, nSampleRate, nChannels);
+	return true;
+}
+
+int CZegoBackend::EnableAudioRecording(bool bEnable, int nSampleRate, int nChannels)
+{
+	ZEGO_CONFIG_ITEM item = MakeConfigItem(ZEGO_CONFIG_AUDIO_RECORDING);
+	item.config.audioRecording.bEnable = bEnable ? 1 : 0;
+	item.config.audioRecording.nSampleRate = nSampleRate;
+	item.config.audioRecording.nChannels = nChannels;
+	return CCommandQueue::GetInstance()->Run(&item, 1);
+}
+
+int CZegoBackend::SetVideoProfile(int nWidth, int nHeight, int nFps, int nBitrate)
+{
+	ZEGO_CONFIG_ITEM item = MakeConfigItem(ZEGO_CONFIG_VIDEO);
+	item.config.video.nWidth = nWidth;
+	item.config.video.nHeight = nHeight;
+	item.config.video.nFps = nFps;
+	item.config.video.nBitrate = nBitrate;
+	return CCommandQueue::GetInstance()->Run(&item, 1);
+}
+
+// lpCodec is a decimal ZegoAudioCodecID, the queue validates both numbers
+int CZegoBackend::SetAudioProfile(int nProfile, const char* lpCodec)
+{
+	ZEGO_CONFIG_ITEM item = MakeConfigItem(ZEGO_CONFIG_AUDIO);
+	item.config.audio.nPreset = nProfile;
+	item.config.audio.nCodecID = ZEGO_AUDIO_CODEC_ID_DEFAULT;
+	if (lpCodec != NULL)
+	{
+		char* lpEnd = nullptr;
+		long nCodecID = strtol(lpCodec, &lpEnd, 10);
+		if (*lpCodec == '\0' || *lpEnd != '\0' || nCodecID < INT32_MIN || nCodecID > INT32_MAX)
+			return RTC_ERR_INVALID_ARG;
+		item.config.audio.nCodecID = (int32_t)nCodecID;
+	}
+	return CCommandQueue::GetInstance()->Run(&item, 1);
+}
+
+// before JoinChannel, the capturer starts with the publishing
+int CZegoBackend::EnableCustomVideoCapture()
+{
+	return CCommandQueue::GetInstance()->RunCommand(ENGINE_COMMAND_CUSTOM_VIDEO_PUSH);
+}
+
+// the capture thread sends the pushed PCM in 20ms frames, before JoinChannel
+int CZegoBackend::EnableCustomAudioCapture(int nSampleRate, int nChannels)
+{
+	return CCommandQueue::GetInstance()->RunCommand(ENGINE_COMMAND_CUSTOM_AUDIO_PUSH, nullptr, nSampleRate, nChannels);
+}
@@ -0,0 +1,23 @@
+#include "ZegoChurnTarget.h"
+#include "ZegoObject.h"
+
+CZegoChurnTarget::CZegoChurnTarget(const std::string& roomID, const std::string& userID)
+	: m_strRoomID(roomID)
+	, m_strUserID(userID)
+{
+}
+
+void CZegoChurnTarget::Join()
+{
+	CZegoObject::GetZegoObject()->loginRoom(m_strRoomID, m_strUserID);
+}
+
+bool CZegoChurnTarget::WaitJoin(int nTimeoutMs)
+{
+	return CZegoObject::GetZegoObject()->waitLoginRoom(nTimeoutMs) >= 0;
+}
+
+void CZegoChurnTarget::Leave()
+{
+	CZegoObject::GetZegoObject()->logoutRoom();
+}
@@ -0,0 +1,170 @@
+#include "ZegoConfig.h"
+#include "ZegoObject.h"
+#include <string.h>
+
+static bool InRange(int32_t nValue, int32_t nMin, int32_t nMax)
+{
+	return nValue >= nMin && nValue <= nMax;
+}
+
+// terminated inside the array and not empty
+static bool IsId(const char* lpId, size_t nSize)
+{
+	size_t nLen = strnlen(lpId, nSize);
+	return nLen > 0 && nLen < nSize;
+}
+
+void CZegoConfig::CopyId(char* lpId, size_t nSize, const char* lpText)
+{
+	size_t nLen = strnlen(lpText, nSize);
+	memcpy(lpId, lpText, nLen < nSize ? nLen + 1 : nSize);
+}
+
+// checks the fields of one item without touching the engine
+int CZegoConfig::Validate(const ZEGO_CONFIG_ITEM& item)
+{
+	bool bValid = false;
+
+	switch (item.nType)
+	{
+	case ZEGO_CONFIG_VIDEO:
+	{
+		const ZEGO_VIDEO_CONFIG& video = item.config.video;
+		bValid = InRange(video.nWidth, 1, ZEGO_MAX_VIDEO_DIMENSION)
+			&& InRange(video.nHeight, 1, ZEGO_MAX_VIDEO_DIMENSION)
+			&& InRange(video.nFps, 1, ZEGO_MAX_VIDEO_FPS)
+			&& video.nBitrate > 0;
+		break;
+	}
+	case ZEGO_CONFIG_ENABLE_VIDEO:
+	case ZEGO_CONFIG_HARDWARE_ENCODER:
+	case ZEGO_CONFIG_HARDWARE_DECODER:
+	case ZEGO_CONFIG_DUAL_STREAM:
+	case ZEGO_CONFIG_HEADLESS:
+	case ZEGO_CONFIG_REMOTE_VIDEO_FRAMES:
+	case ZEGO_CONFIG_AUDIO_SINK:
+		bValid = InRange(item.config.enable.bEnable, 0, 1);
+		break;
+	case ZEGO_CONFIG_AUDIO:
+		bValid = InRange(item.config.audio.nPreset, ZEGO_AUDIO_CONFIG_PRESET_BASIC_QUALITY, ZEGO_AUDIO_CONFIG_PRESET_HIGH_QUALITY_STEREO)
+			&& InRange(item.config.audio.nCodecID, ZEGO_AUDIO_CODEC_ID_DEFAULT, ZEGO_AUDIO_CODEC_ID_LOW3);
+		break;
+	case ZEGO_CONFIG_AUDIO_PROCESSING:
+		bValid = InRange(item.config.audioProcessing.bAEC, 0, 1)
+			&& InRange(item.config.audioProcessing.bANS, 0, 1)
+			&& InRange(item.config.audioProcessing.bAGC, 0, 1);
+		break;
+	case ZEGO_CONFIG_AUDIO_RECORDING:
+	{
+		const ZEGO_AUDIO_RECORDING_CONFIG& recording = item.config.audioRecording;
+		bValid = InRange(recording.bEnable, 0, 1)
+			&& (!recording.bEnable || ((recording.nSampleRate == ZEGO_AUDIO_SAMPLE_RATE_8K || recording.nSampleRate == ZEGO_AUDIO_SAMPLE_RATE_16K
+				|| recording.nSampleRate == ZEGO_AUDIO_SAMPLE_RATE_22K || recording.nSampleRate == ZEGO_AUDIO_SAMPLE_RATE_24K
+				|| recording.nSampleRate == ZEGO_AUDIO_SAMPLE_RATE_32K || recording.nSampleRate == ZEGO_AUDIO_SAMPLE_RATE_44K
+				|| recording.nSampleRate == ZEGO_AUDIO_SAMPLE_RATE_48K) && InRange(recording.nChannels, 1, 2)));
+		break;
+	}
+	case ZEGO_CONFIG_LOGIN_ROOM:
+		bValid = IsId(item.config.login.szRoomId, sizeof(item.config.login.szRoomId))
+			&& IsId(item.config.login.szUserId, sizeof(item.config.login.szUserId));
+		break;
+	default:
+		return ZEGO_CONFIG_ERR_TYPE;
+	}
+
+	return bValid ? ZEGO_CONFIG_OK : ZEGO_CONFIG_ERR_INVALID_ARG;
+}
+
+// validates one item and hands it to the engine, returns item.nResult
+int CZegoConfig::Apply(ZEGO_CONFIG_ITEM& item)
+{
+	item.nResult = Validate(item);
+	if (item.nResult != ZEGO_CONFIG_OK)
+		return item.nResult;
+
+	CZegoObject* lpZegoObject = CZegoObject::GetZegoObject();
+	IZegoExpressEngine* lpEngine = lpZegoObject->getEngine();
+	string strOutput;
+
+	switch (item.nType)
+	{
+	case ZEGO_CONFIG_VIDEO:
+		lpZegoObject->setVideoConfig(item.config.video.nWidth, item.config.video.nHeight, item.config.video.nFps, item.config.video.nBitrate);
+		break;
+	case ZEGO_CONFIG_ENABLE_VIDEO:
+		if (item.config.enable.bEnable)
+			lpZegoObject->enableVideo(nullptr, strOutput);
+		else
+			lpZegoObject->disableVideo();
+		break;
+	case ZEGO_CONFIG_HARDWARE_ENCODER:
+		lpEngine->enableHardwareEncoder(item.config.enable.bEnable != 0);
+		break;
+	case ZEGO_CONFIG_HARDWARE_DECODER:
+		lpEngine->enableHardwareDecoder(item.config.enable.bEnable != 0);
+		break;
+	case ZEGO_CONFIG_AUDIO:
+	{
+		ZegoAudioConfig audioConfig((ZegoAudioConfigPreset)item.config.audio.nPreset);
+		audioConfig.codecID = (ZegoAudioCodecID)item.config.audio.nCodecID;
+		lpEngine->setAudioConfig(audioConfig);
+		break;
+	}
+	case ZEGO_CONFIG_AUDIO_PROCESSING:
+		lpEngine->enableAEC(item.config.audioProcessing.bAEC != 0);
+		lpEngine->enableANS(item.config.audioProcessing.bANS != 0);
+		lpEngine->enableAGC(item.config.audioProcessing.bAGC != 0);
+		break;
+	case ZEGO_CONFIG_LOGIN_ROOM:
+		lpZegoObject->loginRoom(item.config.login.szRoomId, item.config.login.szUserId);
+		break;
+	case ZEGO_CONFIG_DUAL_STREAM:
+		lpZegoObject->enableDualStream(item.config.enable.bEnable != 0);
+		break;
+	case ZEGO_CONFIG_HEADLESS:
+		lpZegoObject->enableHeadless(item.config.enable.bEnable != 0);
+		break;
+	case ZEGO_CONFIG_REMOTE_VIDEO_FRAMES:
+		lpZegoObject->enableRemoteVideoFrames(item.config.enable.bEnable != 0);
+		break;
+	case ZEGO_CONFIG_AUDIO_SINK:
+		lpZegoObject->enableAudioSink(item.config.enable.bEnable != 0);
+		break;
+	case ZEGO_CONFIG_AUDIO_RECORDING:
+		lpZegoObject->enableAudioRecording(item.config.audioRecording.bEnable != 0, item.config.audioRecording.nSampleRate,
+			item.config.audioRecording.nChannels);
+		break;
+	}
+
+	return item.nResult;
+}
+
+// validates the whole batch, then applies it in order. returns ZEGO_CONFIG_OK
+// or the nResult of the first invalid item, the valid ones are then skipped
+int CZegoConfig::ApplyBatch(ZEGO_CONFIG_ITEM* lpItems, int nCount)
+{
+	if (nCount < 0 || (nCount > 0 && lpItems == nullptr))
+		return ZEGO_CONFIG_ERR_INVALID_ARG;
+
+	int nFailed = -1;
+	for (int i = 0; i < nCount; i++)
+	{
+		lpItems[i].nResult = Validate(lpItems[i]);
+		if (lpItems[i].nResult != ZEGO_CONFIG_OK && nFailed < 0)
+			nFailed = i;
+	}
+
+	if (nFailed >= 0)
+	{
+		for (int i = 0; i < nCount; i++)
+		{
+			if (lpItems[i].nResult == ZEGO_CONFIG_OK)
+				lpItems[i].nResult = ZEGO_CONFIG_ERR_SKIPPED;
+		}
+		return lpItems[nFailed].nResult;
+	}
+
+	for (int i = 0; i < nCount; i++)
+		Apply(lpItems[i]);
+	return ZEGO_CONFIG_OK;
+}
@@ -1,11 +1,14 @@
 #ifndef ZEGOCUSTOMVIDEOSOURCEBASE_H
 #define ZEGOCUSTOMVIDEOSOURCEBASE_H
 
+#include "types.h"
+#include "LatencyStats.h"
 #include "../../zego/include/ZegoExpressSDK.h"
 
 enum ZegoCustomVideoSourceType{
     ZegoCustomVideoSourceType_Image = 1,
     ZegoCustomVideoSourceType_Media = 2,
+    ZegoCustomVideoSourceType_Push = 3,
 };
 
 struct ZegoCustomVideoFrame
@@ -14,6 +17,8 @@ struct ZegoCustomVideoFrame
     unsigned int dataLength = 0;
     ZEGO::EXPRESS::ZegoVideoFrameParam param;
     unsigned long long referenceTimeMillsecond = 0;
+    // CMediaClock::NowNs stamps, all 0 for a source that is not measured
+    LATENCY_STAMP latency = { 0, 0, 0 };
 };
 
 struct ZegoCustomAudioFrame
@@ -22,6 +27,8 @@ struct ZegoCustomAudioFrame
     unsigned int dataLength = 0;
     ZEGO::EXPRESS::ZegoAudioFrameParam param;
     unsigned long long referenceTimeMillsecond = 0;
+    // CMediaClock::NowNs stamps, all 0 for a source that is not measured
+    LATENCY_STAMP latency = { 0, 0, 0 };
 };
 
 class ZegoCustomVideoSourceBase
@@ -24,7 +24,7 @@ void ZegoCustomVideoSourceContext::getVideoFrame(std::shared_ptr<ZegoCustomVideo
 void ZegoCustomVideoSourceContext::getAudioFrame(std::shared_ptr<ZegoCustomAudioFrame> & audioFrame)
 {
     std::lock_guard<std::mutex> lock(mVideoSouceMutex);
-    if(currentVideoSource && currentVideoSource->videoSourceType() == ZegoCustomVideoSourceType_Media){
+    if(currentVideoSource && currentVideoSource->videoSourceType() != ZegoCustomVideoSourceType_Image){
         currentVideoSource->getAudioFrame(audioFrame);
     }
 }
@@ -48,6 +48,9 @@ ZegoCustomVideoSourceBase *ZegoCustomVideoSourceContext::getVideoSource(ZegoCust
     case ZegoCustomVideoSourceType_Media:
         currentVideoSource = new ZegoCustomVideoSourceMedia;
         break;
+    case ZegoCustomVideoSourceType_Push:
+        currentVideoSource = new ZegoCustomVideoSourcePush;
+        break;
     }
     return currentVideoSource;
 }
@@ -4,6 +4,7 @@
 #include "ZegoCustomVideoSourceBase.h"
 #include "ZegoCustomVideoSourceImage.h"
 #include "ZegoCustomVideoSourceMedia.h"
+#include "ZegoCustomVideoSourcePush.h"
 
 class ZegoCustomVideoSourceContext
 {
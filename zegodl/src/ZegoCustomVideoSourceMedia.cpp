@@ -1,9 +1,10 @@
 #include "ZegoCustomVideoSourceMedia.h"
 #include "ZegoObject.h"
+#include "MediaClock.h"
 
 ZegoCustomVideoSourceMedia::ZegoCustomVideoSourceMedia()
 {
-    auto engine = ZegoExpressSDK::getEngine();
+    auto engine = ZegoSDK::getEngine();
     if(engine == nullptr){
         return;
     }
@@ -21,7 +22,7 @@ ZegoCustomVideoSourceMedia::ZegoCustomVideoSourceMedia()
 
 ZegoCustomVideoSourceMedia::~ZegoCustomVideoSourceMedia()
 {
-    auto engine = ZegoExpressSDK::getEngine();
+    auto engine = ZegoSDK::getEngine();
     if(engine){
         engine->destroyMediaPlayer(mediaPlayer);
     }
@@ -38,6 +39,7 @@ void ZegoCustomVideoSourceMedia::getVideoFrame(std::shared_ptr<ZegoCustomVideoFr
     if(mVideoFrameQueue.size()>0){
          videoFrame = mVideoFrameQueue.front();
          mVideoFrameQueue.pop();
+         videoFrame->latency.nReadNs = CMediaClock::NowNs();
     }else{
         videoFrame = nullptr;
     }
@@ -78,6 +80,7 @@ void ZegoCustomVideoSourceMedia::onMediaPlayerStateUpdate(IZegoMediaPlayer *medi
 
 void ZegoCustomVideoSourceMedia::onVideoFrame(IZegoMediaPlayer *mediaPlayer, const unsigned char **data, unsigned int *dataLength, ZegoVideoFrameParam param)
 {
+    long long pushNs = CMediaClock::NowNs();
     std::lock_guard<std::mutex> lock(mediaMutex);
     if(mVideoFrameQueue.size() <= 2 ){
         auto videoFrame = std::make_shared<ZegoCustomVideoFrame>();
@@ -86,6 +89,8 @@ void ZegoCustomVideoSourceMedia::onVideoFrame(IZegoMediaPlayer *mediaPlayer, con
         memcpy(videoFrame->data.get(), data[0], videoFrame->dataLength);
         videoFrame->param = param;
         videoFrame->referenceTimeMillsecond = this->getCurrentTimestampMS();
+        videoFrame->latency.nPushNs = pushNs;
+        videoFrame->latency.nPublishNs = CMediaClock::NowNs();
 
         mVideoFrameQueue.push(videoFrame);
     }
@@ -93,6 +98,7 @@ void ZegoCustomVideoSourceMedia::onVideoFrame(IZegoMediaPlayer *mediaPlayer, con
 
 void ZegoCustomVideoSourceMedia::onAudioFrame(IZegoMediaPlayer* mediaPlayer, const unsigned char* data, unsigned int dataLength, ZegoAudioFrameParam param)
 {
+    long long pushNs = CMediaClock::NowNs();
     std::lock_guard<std::mutex> lock(audioMutex);
     if(mAudioFrameQueue.size() <= 2 ){
         auto audioFrame = std::make_shared<ZegoCustomAudioFrame>();
@@ -101,6 +107,8 @@ void ZegoCustomVideoSourceMedia::onAudioFrame(IZegoMediaPlayer* mediaPlayer, con
         memcpy(audioFrame->data.get(), data, audioFrame->dataLength);
         audioFrame->param = param;
         audioFrame->referenceTimeMillsecond = this->getCurrentTimestampMS();
+        audioFrame->latency.nPushNs = pushNs;
+        audioFrame->latency.nPublishNs = CMediaClock::NowNs();
 
         mAudioFrameQueue.push(audioFrame);
     }
@@ -108,10 +116,11 @@ void ZegoCustomVideoSourceMedia::onAudioFrame(IZegoMediaPlayer* mediaPlayer, con
 
 void ZegoCustomVideoSourceMedia::getAudioFrame(std::shared_ptr<ZegoCustomAudioFrame> &audioFrame)
 {
-    std::lock_guard<std::mutex> lock(mediaMutex);
+    std::lock_guard<std::mutex> lock(audioMutex);
     if(mAudioFrameQueue.size()>0){
          audioFrame = mAudioFrameQueue.front();
          mAudioFrameQueue.pop();
+         audioFrame->latency.nReadNs = CMediaClock::NowNs();
     }else{
         audioFrame = nullptr;
     }
@@ -0,0 +1,72 @@
+#include "ZegoCustomVideoSourcePush.h"
+#include "AgVideoBuffer.h"
+#include "CircleBuffer.h"
+
+// the pacing of ZegoCustomVideoSourceContext's capture thread
+#define PUSH_AUDIO_FRAME_MS 20
+
+ZegoCustomVideoSourcePush::ZegoCustomVideoSourcePush()
+    : frameBuffer(VIDEO_BUF_SIZE)
+{
+
+}
+
+ZegoCustomVideoSourcePush::~ZegoCustomVideoSourcePush()
+{
+
+}
+
+ZegoCustomVideoSourceType ZegoCustomVideoSourcePush::videoSourceType()
+{
+    return ZegoCustomVideoSourceType_Push;
+}
+
+void ZegoCustomVideoSourcePush::getVideoFrame(std::shared_ptr<ZegoCustomVideoFrame> &videoFrame)
+{
+    LATENCY_STAMP latency = { 0, 0, 0 };
+    int width = 0, height = 0;
+    CAgVideoBuffer::GetInstance()->readBuffer(frameBuffer.data(), latency, width, height);
+    if (width <= 0 || height <= 0 || latency.nPublishNs == lastPublishNs)
+        return;
+    lastPublishNs = latency.nPublishNs;
+
+    videoFrame = std::make_shared<ZegoCustomVideoFrame>();
+    videoFrame->dataLength = (unsigned int)(width * height * 3 / 2);
+    videoFrame->data = std::unique_ptr<unsigned char[]>(new unsigned char[videoFrame->dataLength]);
+    memcpy(videoFrame->data.get(), frameBuffer.data(), videoFrame->dataLength);
+
+    videoFrame->param.format = ZEGO::EXPRESS::ZEGO_VIDEO_FRAME_FORMAT_I420;
+    videoFrame->param.width = width;
+    videoFrame->param.height = height;
+    videoFrame->param.strides[0] = width;
+    videoFrame->param.strides[1] = width / 2;
+    videoFrame->param.strides[2] = width / 2;
+    videoFrame->param.strides[3] = 0;
+    videoFrame->param.rotation = 0;
+
+    videoFrame->referenceTimeMillsecond = this->getCurrentTimestampMS();
+    videoFrame->latency = latency;
+}
+
+void ZegoCustomVideoSourcePush::getAudioFrame(std::shared_ptr<ZegoCustomAudioFrame> &audioFrame)
+{
+    CircleBuffer *lpCircleBuffer = CircleBuffer::GetInstance();
+    int sampleRate = 0, channels = 0;
+    lpCircleBuffer->getAudioInfo(sampleRate, channels);
+    unsigned int bytes = (unsigned int)(sampleRate / (1000 / PUSH_AUDIO_FRAME_MS) * channels * 2);
+    // the capture thread must not wait for the pusher, only read what is there
+    if (bytes == 0 || lpCircleBuffer->getUsedSize() < bytes)
+        return;
+
+    audioFrame = std::make_shared<ZegoCustomAudioFrame>();
+    audioFrame->data = std::unique_ptr<unsigned char[]>(new unsigned char[bytes]);
+    if (!lpCircleBuffer->readBuffer(audioFrame->data.get(), bytes, &audioFrame->dataLength, audioFrame->latency))
+    {
+        audioFrame = nullptr;
+        return;
+    }
+
+    audioFrame->param.sampleRate = (ZEGO::EXPRESS::ZegoAudioSampleRate)sampleRate;
+    audioFrame->param.channel = (ZEGO::EXPRESS::ZegoAudioChannel)channels;
+    audioFrame->referenceTimeMillsecond = this->getCurrentTimestampMS();
+}
@@ -0,0 +1,27 @@
+#ifndef ZEGOCUSTOMVIDEOSOURCEPUSH_H
+#define ZEGOCUSTOMVIDEOSOURCEPUSH_H
+
+#include "ZegoCustomVideoSourceBase.h"
+#include <vector>
+
+// the frames and PCM the script pushes through rtc_pushVideoFrame and
+// rtc_pushAudioFrame. they land in the core CAgVideoBuffer and CircleBuffer,
+// the same ones the agora observers read, the capture thread takes the
+// newest frame and 20ms of PCM from there on every tick
+class ZegoCustomVideoSourcePush: public ZegoCustomVideoSourceBase
+{
+public:
+    ZegoCustomVideoSourcePush();
+    ~ZegoCustomVideoSourcePush() override;
+
+    ZegoCustomVideoSourceType videoSourceType() override;
+    void getVideoFrame(std::shared_ptr<ZegoCustomVideoFrame> & videoFrame) override;
+    void getAudioFrame(std::shared_ptr<ZegoCustomAudioFrame> &audioFrame) override;
+
+private:
+    // CAgVideoBuffer publish time of the last frame sent, a frame is sent once
+    int64_t lastPublishNs = -1;
+    std::vector<unsigned char> frameBuffer;
+};
+
+#endif // ZEGOCUSTOMVIDEOSOURCEPUSH_H
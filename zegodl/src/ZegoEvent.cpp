@@ -0,0 +1,50 @@
+#include "ZegoEvent.h"
+#include <chrono>
+#include <string.h>
+
+// the ring lives for the whole process, a callback still running while the
+// dll unloads must not write into freed memory
+CZegoEventRing* CZegoEventRing::GetInstance()
+{
+	static CZegoEventRing* lpEventRing = new CZegoEventRing();
+	return lpEventRing;
+}
+
+CZegoEventRing::CZegoEventRing()
+	: m_nDroppedReported(0)
+{
+}
+
+void CZegoEventRing::Init(ZEGO_EVENT& event, int nType)
+{
+	memset(&event, 0, sizeof(event));
+	event.nType = nType;
+	event.nTimestampUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void CZegoEventRing::SetText(ZEGO_EVENT& event, const std::string& strText)
+{
+	size_t nLen = strText.size() < ZEGO_EVENT_TEXT - 1 ? strText.size() : ZEGO_EVENT_TEXT - 1;
+	memcpy(event.szText, strText.data(), nLen);
+	event.szText[nLen] = 0;
+}
+
+// copies out up to nMax pending events in the order they were pushed, returns how many
+int CZegoEventRing::Poll(ZEGO_EVENT* lpEvents, int nMax)
+{
+	std::lock_guard<std::mutex> lock(m_lockPoll);
+
+	int nCount = 0;
+	uint64_t nDropped = m_ring.GetDropped();
+	if (nDropped != m_nDroppedReported && nMax > 0)
+	{
+		Init(lpEvents[nCount], ZEGO_EVENT_DROPPED);
+		lpEvents[nCount].nArgs[0] = (int32_t)(nDropped - m_nDroppedReported);
+		m_nDroppedReported = nDropped;
+		nCount++;
+	}
+
+	while (nCount < nMax && m_ring.Pop(lpEvents[nCount]))
+		nCount++;
+	return nCount;
+}
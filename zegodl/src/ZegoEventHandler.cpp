@@ -1,5 +1,11 @@
 #include "ZegoEventHandler.h"
 #include "ZegoObject.h"
+#include "ChurnBench.h"
+#include "ZegoEvent.h"
+#include "ZegoStatsSchema.h"
+#include "Logger.h"
+#include "MediaClock.h"
+#include <cmath>
 #include <iostream>
 
 CZegoEventHandler::CZegoEventHandler(void)
@@ -10,80 +16,224 @@ CZegoEventHandler::~CZegoEventHandler(void)
 {
 }
 
-void CZegoEventHandler::SetMsgReceiver(HWND hWnd)
+// called right before loginRoom, zego does not report elapsed so the login time is kept here
+void CZegoEventHandler::ResetJoinState()
 {
-	m_hMainWnd = hWnd;
+	std::lock_guard<std::mutex> locker(m_joinMutex);
+	m_bJoined = false;
+	m_nJoinElapsed = -1;
+	m_loginTime = std::chrono::steady_clock::now();
 }
 
+// returns ms from loginRoom to ZEGO_ROOM_STATE_CONNECTED, or -1 on timeout (<0 waits forever)
+// ZEGO_DISABLE_SWTICH_THREAD keeps the callbacks on the SDK thread, waiting here never blocks them
+int CZegoEventHandler::WaitJoinChannel(int nTimeoutMs)
+{
+	std::unique_lock<std::mutex> locker(m_joinMutex);
+	if (nTimeoutMs < 0)
+		m_joinCond.wait(locker, [this] {return m_bJoined; });
+	else if (!m_joinCond.wait_for(locker, std::chrono::milliseconds(nTimeoutMs), [this] {return m_bJoined; }))
+		return -1;
+
+	return m_nJoinElapsed;
+}
+
+// ms since the last loginRoom
+int CZegoEventHandler::GetLoginElapsed()
+{
+	std::lock_guard<std::mutex> locker(m_joinMutex);
+	return (int)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_loginTime).count();
+}
 
 void CZegoEventHandler::onDebugError(int errorCode, const std::string& funcName, const std::string& info)
 {
+	ZEGO_EVENT event;
+	CZegoEventRing::Init(event, ZEGO_EVENT_DEBUG_ERROR);
+	event.nArgs[0] = errorCode;
+	CZegoEventRing::SetText(event, funcName);
+	CZegoEventRing::GetInstance()->Push(event);
 }
 
 void CZegoEventHandler::onEngineStateUpdate(ZegoEngineState state)
 {
-
+	ZEGO_EVENT event;
+	CZegoEventRing::Init(event, ZEGO_EVENT_ENGINE_STATE);
+	event.nArgs[0] = state;
+	CZegoEventRing::GetInstance()->Push(event);
 }
 
 void CZegoEventHandler::onRoomStateUpdate(const std::string& roomID, ZegoRoomState state, int errorCode, const std::string& extendedData)
 {
-	std::string sroomID = roomID;
+	ZEGO_EVENT event;
+	CZegoEventRing::Init(event, ZEGO_EVENT_ROOM_STATE);
+	event.nArgs[0] = state;
+	event.nArgs[1] = errorCode;
+	CZegoEventRing::SetText(event, roomID);
+	CZegoEventRing::GetInstance()->Push(event);
+
+	std::lock_guard<std::mutex> locker(m_joinMutex);
+	if (state == ZEGO_ROOM_STATE_CONNECTED && !m_bJoined)
+	{
+		m_bJoined = true;
+		m_nJoinElapsed = (int)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_loginTime).count();
+		CChurnBench::GetInstance()->Record(CHURN_JOIN_ELAPSED, m_nJoinElapsed);
+		m_joinCond.notify_all();
+	}
+	else if (state == ZEGO_ROOM_STATE_DISCONNECTED)
+	{
+		m_bJoined = false;
+	}
 }
 
 void CZegoEventHandler::onRoomUserUpdate(const std::string& roomID, ZegoUpdateType updateType, const std::vector<ZegoUser>& userList)
 {
-	std::string sroomID = roomID;
+	CZegoEventRing *lpEventRing = CZegoEventRing::GetInstance();
+	for (size_t i = 0; i < userList.size(); i++)
+	{
+		ZEGO_EVENT event;
+		CZegoEventRing::Init(event, updateType == ZEGO_UPDATE_TYPE_ADD ? ZEGO_EVENT_ROOM_USER_ADD : ZEGO_EVENT_ROOM_USER_DELETE);
+		CZegoEventRing::SetText(event, userList[i].userID);
+		lpEventRing->Push(event);
+	}
 }
 
 void CZegoEventHandler::onRoomStreamUpdate(const std::string &roomID, ZegoUpdateType updateType, const std::vector<ZegoStream> &streamList)
 {
+	CZegoEventRing *lpEventRing = CZegoEventRing::GetInstance();
+	for (size_t i = 0; i < streamList.size(); i++)
+	{
+		ZEGO_EVENT event;
+		CZegoEventRing::Init(event, updateType == ZEGO_UPDATE_TYPE_ADD ? ZEGO_EVENT_ROOM_STREAM_ADD : ZEGO_EVENT_ROOM_STREAM_DELETE);
+		CZegoEventRing::SetText(event, streamList[i].streamID);
+		lpEventRing->Push(event);
+	}
+
+	CChurnBench *lpChurnBench = CChurnBench::GetInstance();
+	if (lpChurnBench->IsRunning() && updateType == ZEGO_UPDATE_TYPE_ADD)
+	{
+		int nElapsed = GetLoginElapsed();
+		for (size_t i = 0; i < streamList.size(); i++)
+			lpChurnBench->Record(CHURN_USER_JOINED_ELAPSED, nElapsed);
+	}
+
+	CChurnBench::CScopedTimer timer(updateType == ZEGO_UPDATE_TYPE_ADD ? CHURN_USER_JOINED_HANDLER : CHURN_USER_OFFLINE_HANDLER);
 	CZegoObject::GetZegoObject()->onRoomStreamUpdate(roomID, updateType, streamList);
 }
 
+void CZegoEventHandler::onPlayerRecvVideoFirstFrame(const std::string& streamID)
+{
+	CChurnBench::CScopedTimer timer(CHURN_FIRST_VIDEO_HANDLER);
+	CChurnBench *lpChurnBench = CChurnBench::GetInstance();
+	if (lpChurnBench->IsRunning())
+		lpChurnBench->Record(CHURN_FIRST_VIDEO_ELAPSED, GetLoginElapsed());
+
+	ZEGO_EVENT event;
+	CZegoEventRing::Init(event, ZEGO_EVENT_PLAYER_FIRST_VIDEO_FRAME);
+	CZegoEventRing::SetText(event, streamID);
+	CZegoEventRing::GetInstance()->Push(event);
+}
+
 void CZegoEventHandler::onPublisherVideoSizeChanged(int width, int height, ZegoPublishChannel channel)
 {
-	if (g_Logon == true)
-	{
-		std::cout << "zego capture w:" << width << " h:" << height << " channel" << channel << std::endl;
-	}
+	ZEGO_EVENT event;
+	CZegoEventRing::Init(event, ZEGO_EVENT_PUBLISHER_VIDEO_SIZE);
+	event.nArgs[0] = width;
+	event.nArgs[1] = height;
+	event.nArgs[2] = channel;
+	CZegoEventRing::GetInstance()->Push(event);
+
+	LOG_INFO("zego capture w:%d h:%d channel%d", width, height, (int)channel);
 }
 
 void CZegoEventHandler::onPlayerVideoSizeChanged(const std::string & streamID, int width, int height)
 {
-	if (g_Logon == true)
-	{
-		std::cout << "zego play streamID:" << streamID <<" w:"<< width << " h:" << height << std::endl;
-	}
+	ZEGO_EVENT event;
+	CZegoEventRing::Init(event, ZEGO_EVENT_PLAYER_VIDEO_SIZE);
+	event.nArgs[0] = width;
+	event.nArgs[1] = height;
+	CZegoEventRing::SetText(event, streamID);
+	CZegoEventRing::GetInstance()->Push(event);
+
+	CParticipantRegistry::GetInstance()->SetStat(streamID, PARTICIPANT_STAT_WIDTH, width);
+	CParticipantRegistry::GetInstance()->SetStat(streamID, PARTICIPANT_STAT_HEIGHT, height);
+	LOG_INFO("zego play streamID:%s w:%d h:%d", streamID.c_str(), width, height);
 }
 
 void CZegoEventHandler::onPublisherQualityUpdate(const std::string &streamID, const ZegoPublishStreamQuality& quality)
 {
-	if (g_Logon == true)
-	{
-		std::cout << "zego Publisher Quality streamID:" << streamID << " vcap fps:" << quality.videoCaptureFPS //<< std::endl
-			<< " venc fps:" << quality.videoEncodeFPS << " vsend fps:" << quality.videoSendFPS << " vsend kbps:" << quality.videoKBPS //<< std::endl
-			<< " acap fps:" << quality.audioCaptureFPS << " asend fps:" << quality.audioSendFPS << " asend kbps:" << quality.audioKBPS// << std::endl
-			<< " rtt(ms):" << quality.rtt << " packetLostRate fps:" << quality.packetLostRate << " quality level:" << quality.level //<< std::endl
-			<< " isHardwareEncode:" << quality.isHardwareEncode << " totalSendBytes:" << quality.totalSendBytes << " audioSendBytes:" << quality.audioSendBytes
-			<< " videoSendBytes:" << quality.videoSendBytes << std::endl;
-	}
+	ZEGO_EVENT event;
+	CZegoEventRing::Init(event, ZEGO_EVENT_PUBLISHER_QUALITY);
+	event.nArgs[0] = (int32_t)std::lround(quality.videoKBPS);
+	event.nArgs[1] = (int32_t)std::lround(quality.videoSendFPS);
+	event.nArgs[2] = quality.rtt;
+	CZegoEventRing::SetText(event, streamID);
+	CZegoEventRing::GetInstance()->Push(event);
+
+	if (!CStatsRecorder::IsRecording())
+		return;
 
+	STATS_SAMPLE sample;
+	CStatsRecorder::Init(sample, STATS_PUBLISHER, streamID);
+	sample.nValues[0] = CStatsRecorder::Scale(quality.videoCaptureFPS);
+	sample.nValues[1] = CStatsRecorder::Scale(quality.videoEncodeFPS);
+	sample.nValues[2] = CStatsRecorder::Scale(quality.videoSendFPS);
+	sample.nValues[3] = CStatsRecorder::Scale(quality.videoKBPS);
+	sample.nValues[4] = CStatsRecorder::Scale(quality.audioCaptureFPS);
+	sample.nValues[5] = CStatsRecorder::Scale(quality.audioSendFPS);
+	sample.nValues[6] = CStatsRecorder::Scale(quality.audioKBPS);
+	sample.nValues[7] = quality.rtt;
+	sample.nValues[8] = CStatsRecorder::Scale(quality.packetLostRate);
+	sample.nValues[9] = quality.level;
+	sample.nValues[10] = quality.isHardwareEncode;
+	sample.nValues[11] = CStatsRecorder::Scale(quality.totalSendBytes);
+	sample.nValues[12] = CStatsRecorder::Scale(quality.audioSendBytes);
+	sample.nValues[13] = CStatsRecorder::Scale(quality.videoSendBytes);
+	CStatsRecorder::GetInstance()->Record(sample);
 }
 
 void CZegoEventHandler::onPlayerQualityUpdate(const std::string &streamID, const ZegoPlayStreamQuality& quality)
 {
-	if (g_Logon == true)
-	{
-		std::cout << "zego Play Quality streamID:" << streamID << " vRecv fps:" << quality.videoRecvFPS //<< std::endl
-			<< " vdec fps:" << quality.videoDecodeFPS << " vRend fps:" << quality.videoRenderFPS << " v kbps:" << quality.videoKBPS //<< std::endl
-			<< " aRecv fps:" << quality.audioRecvFPS << " aDec fps:" << quality.audioDecodeFPS << " aRend fps:" << quality.audioRenderFPS 
-			<<" aKBPS:"<< quality.audioKBPS //<< std::endl
-			<< " rtt(ms):" << quality.rtt << " packetLostRate fps:" << quality.packetLostRate << " peerToPeerDelay:" 
-			<< quality.peerToPeerDelay << " peerToPeerPacketLostRate:" << quality.peerToPeerPacketLostRate << " quality level:" << quality.level //<< std::endl
-			<< " delay:" << quality.delay << " isHardwareDecode:" << quality.isHardwareDecode
-			<< " totalRecvBytes:" << quality.totalRecvBytes << " audioRecvBytes:" << quality.audioRecvBytes
-			<< " videoRecvBytes:" << quality.videoRecvBytes << std::endl;
-	}
+	ZEGO_EVENT event;
+	CZegoEventRing::Init(event, ZEGO_EVENT_PLAYER_QUALITY);
+	event.nArgs[0] = (int32_t)std::lround(quality.videoKBPS);
+	event.nArgs[1] = (int32_t)std::lround(quality.videoRenderFPS);
+	event.nArgs[2] = quality.rtt;
+	CZegoEventRing::SetText(event, streamID);
+	CZegoEventRing::GetInstance()->Push(event);
+
+	// a script may resize the view at any time, the quality comes every few seconds
+	CZegoObject::GetZegoObject()->onPlayerQualityUpdate(streamID, quality);
+
+	if (!CStatsRecorder::IsRecording())
+		return;
+
+	STATS_SAMPLE sample;
+	CStatsRecorder::Init(sample, STATS_PLAYER, streamID);
+	sample.nValues[0] = CStatsRecorder::Scale(quality.videoRecvFPS);
+	sample.nValues[1] = CStatsRecorder::Scale(quality.videoDecodeFPS);
+	sample.nValues[2] = CStatsRecorder::Scale(quality.videoRenderFPS);
+	sample.nValues[3] = CStatsRecorder::Scale(quality.videoKBPS);
+	sample.nValues[4] = CStatsRecorder::Scale(quality.audioRecvFPS);
+	sample.nValues[5] = CStatsRecorder::Scale(quality.audioDecodeFPS);
+	sample.nValues[6] = CStatsRecorder::Scale(quality.audioRenderFPS);
+	sample.nValues[7] = CStatsRecorder::Scale(quality.audioKBPS);
+	sample.nValues[8] = quality.rtt;
+	sample.nValues[9] = CStatsRecorder::Scale(quality.packetLostRate);
+	sample.nValues[10] = quality.peerToPeerDelay;
+	sample.nValues[11] = CStatsRecorder::Scale(quality.peerToPeerPacketLostRate);
+	sample.nValues[12] = quality.level;
+	sample.nValues[13] = quality.delay;
+	sample.nValues[14] = quality.isHardwareDecode;
+	sample.nValues[15] = CStatsRecorder::Scale(quality.totalRecvBytes);
+	sample.nValues[16] = CStatsRecorder::Scale(quality.audioRecvBytes);
+	sample.nValues[17] = CStatsRecorder::Scale(quality.videoRecvBytes);
+	CStatsRecorder::GetInstance()->Record(sample);
+}
+
+// every 100ms while the sound level monitor runs, the views follow the speakers
+void CZegoEventHandler::onRemoteSoundLevelUpdate(const std::unordered_map<std::string, float>& soundLevels)
+{
+	CZegoObject::GetZegoObject()->onRemoteSoundLevelUpdate(soundLevels);
 }
 
 void CustomVideoCapturer::onStart(ZegoPublishChannel channel)
@@ -116,6 +266,7 @@ void CustomVideoCapturer::collectVideoFrameAndSendToEngine()
         this->getVideoFrame(videoFrame);
         if (videoFrame)
         {
+            CLatencyStats::GetInstance()->RecordVideo(videoFrame->latency, CMediaClock::NowNs());
             CZegoObject::GetZegoObject()->getEngine()->sendCustomVideoCaptureRawData(videoFrame->data.get(), videoFrame->dataLength, videoFrame->param, videoFrame->referenceTimeMillsecond);
         }
 
@@ -123,6 +274,7 @@ void CustomVideoCapturer::collectVideoFrameAndSendToEngine()
         this->getAudioFrame(audioFrame);
         if (audioFrame)
         {
+            CLatencyStats::GetInstance()->RecordAudio(audioFrame->latency, CMediaClock::NowNs());
             CZegoObject::GetZegoObject()->getEngine()->sendCustomAudioCapturePCMData(audioFrame->data.get(), audioFrame->dataLength, 
 			audioFrame->param);
         }
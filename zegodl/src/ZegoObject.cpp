@@ -1,14 +1,86 @@
 #include "ZegoObject.h"
+#include "ZegoConfig.h"
+#include "CommandQueue.h"
 #include "AGExtInfoManager.h"
+#include "MediaClock.h"
+#include "Logger.h"
 
+#include "JsonArgs.h"
 #include "json/json.h"
-#include <tchar.h>
+#include <algorithm>
 
 
 CZegoObject *CZegoObject::m_lpZegoObject = NULL;
-std::atomic<bool> g_Logon = true;
+
+static bool ParseJson(LPVOID lpExtInfo, Json::Value &root)
+{
+	string rawJson((char*)lpExtInfo);
+	Json::CharReaderBuilder builder;
+	JSONCPP_STRING err;
+
+	const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+	if (!reader->parse(rawJson.c_str(), rawJson.c_str() + rawJson.length(), &root,
+		&err)) {
+		return false;
+	}
+	return root.isObject();
+}
+
+// the whole string has to be a decimal int, unlike stoi/atoi
+static bool ParseInt(const string &str, int32_t &nValue)
+{
+	int64_t nParsed = 0;
+	if (!CJsonArgs::ParseInteger(str, nParsed) || nParsed < INT32_MIN || nParsed > INT32_MAX)
+		return false;
+	nValue = (int32_t)nParsed;
+	return true;
+}
+
+// an int the scripts send as a json number or a string, a missing key keeps nValue.
+// false when the value is there but is not an int
+static bool JsonInt(const Json::Value &root, const char* lpKey, int32_t &nValue)
+{
+	int64_t nParsed = nValue;
+	if (!CJsonArgs::JsonInteger(root, lpKey, INT32_MIN, INT32_MAX, nParsed))
+		return false;
+	nValue = (int32_t)nParsed;
+	return true;
+}
+
+// a json bool or "true"/"false", missing is false
+static bool JsonBool(const Json::Value &root, const char* lpKey, int32_t &bValue)
+{
+	const Json::Value &value = root[lpKey];
+	if (value.isBool())
+		bValue = value.asBool() ? 1 : 0;
+	else if (value.isNull() || (value.isString() && value.asString() == "false"))
+		bValue = 0;
+	else if (value.isString() && value.asString() == "true")
+		bValue = 1;
+	else
+		return false;
+	return true;
+}
+
+static ZEGO_CONFIG_ITEM MakeConfigItem(ZEGO_CONFIG_TYPE type)
+{
+	ZEGO_CONFIG_ITEM item;
+	memset(&item, 0, sizeof(item));
+	item.nType = type;
+	return item;
+}
+
+// json exports go through the typed path on the engine thread, strOutput is "error" when it is refused
+static int ApplyJsonItem(bool bParsed, ZEGO_CONFIG_ITEM &item, string &strOutput)
+{
+	int nResult = bParsed ? CCommandQueue::GetInstance()->Run(&item, 1) : ZEGO_CONFIG_ERR_INVALID_ARG;
+	if (nResult != ZEGO_CONFIG_OK)
+		strOutput = "error";
+	return nResult;
+}
 
 CZegoObject::CZegoObject(void)
+	: m_lpRegistry(CParticipantRegistry::GetInstance())
 {
 	m_pgEventHandler = std::make_shared<CZegoEventHandler>();
 	m_pgVideoRenderer = std::make_shared<CZegoCustomVideoRenderer>();
@@ -23,8 +95,10 @@ CZegoObject::~CZegoObject(void)
 
 void CZegoObject::destroyZegoEngine()
 {
+	// the batched room updates call the engine and this object
+	m_lpRegistry->StopBatching();
 	if (m_lpZegoEngine) {
-		ZegoExpressSDK::destroyEngine(m_lpZegoEngine);
+		ZegoSDK::destroyEngine(m_lpZegoEngine);
 		m_lpZegoEngine = nullptr;
 	}
 	if (m_lpZegoObject) {
@@ -43,11 +117,6 @@ CZegoObject *CZegoObject::GetZegoObject()
 	return m_lpZegoObject;
 }
 
-void CZegoObject::SetMainWnd(HWND hMainWnd)
-{
-	m_pgEventHandler->SetMsgReceiver(hMainWnd);
-}
-
 int CZegoObject::createEngine(LPVOID lpExtInfo, string &strOutput)
 {
 	createZegoEngine();
@@ -100,41 +169,17 @@ int CZegoObject::destroy(LPVOID lpExtInfo, string &strOutput)
 }
 int CZegoObject::enableEncoder(LPVOID lpExtInfo, string &strOutput)
 {
-	string rawJson((char*)lpExtInfo);
-	Json::CharReaderBuilder builder;
-	JSONCPP_STRING err;
 	Json::Value root;
-
-	const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
-	if (!reader->parse(rawJson.c_str(), rawJson.c_str() + rawJson.length(), &root,
-		&err)) {
-		strOutput = "error";
-		return EXIT_FAILURE;
-	}
-
-	bool bEnable = root["enableEncoder"].asBool();
-
-	m_lpZegoEngine->enableHardwareEncoder(bEnable);
-	return 0;
+	ZEGO_CONFIG_ITEM item = MakeConfigItem(ZEGO_CONFIG_HARDWARE_ENCODER);
+	bool bParsed = ParseJson(lpExtInfo, root) && JsonBool(root, "enableEncoder", item.config.enable.bEnable);
+	return ApplyJsonItem(bParsed, item, strOutput);
 }
 int CZegoObject::enableDecoder(LPVOID lpExtInfo, string &strOutput)
 {
-	string rawJson((char*)lpExtInfo);
-	Json::CharReaderBuilder builder;
-	JSONCPP_STRING err;
 	Json::Value root;
-
-	const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
-	if (!reader->parse(rawJson.c_str(), rawJson.c_str() + rawJson.length(), &root,
-		&err)) {
-		strOutput = "error";
-		return EXIT_FAILURE;
-	}
-
-	bool bEnable = root["enableDecoder"].asBool();
-
-	m_lpZegoEngine->enableHardwareDecoder(bEnable);
-	return 0;
+	ZEGO_CONFIG_ITEM item = MakeConfigItem(ZEGO_CONFIG_HARDWARE_DECODER);
+	bool bParsed = ParseJson(lpExtInfo, root) && JsonBool(root, "enableDecoder", item.config.enable.bEnable);
+	return ApplyJsonItem(bParsed, item, strOutput);
 }
 
 
@@ -145,7 +190,7 @@ void CZegoObject::createZegoEngine()
 		unsigned int appID = 928464678;
 		std::string appSign = "2a485d1d1fe964eb7255d3c65ab1131fc8ad374a12231a1c7566827912096770";
 		bool isTest = true;
-		m_lpZegoEngine = ZegoExpressSDK::createEngine(appID, appSign, isTest, ZEGO_SCENARIO_GENERAL, nullptr);
+		m_lpZegoEngine = ZegoSDK::createEngine(appID, appSign, isTest, ZEGO_SCENARIO_GENERAL, nullptr);
 
 		m_lpZegoEngine->setEventHandler(m_pgEventHandler);
 	}
@@ -164,7 +209,7 @@ int CZegoObject::initialize(string &strOutput)
 int CZegoObject::destroyEngine()
 {
 	if (m_lpZegoEngine) {
-		ZegoExpressSDK::destroyEngine(m_lpZegoEngine);
+		ZegoSDK::destroyEngine(m_lpZegoEngine);
 		m_lpZegoEngine = NULL;
 	}
 	
@@ -172,39 +217,51 @@ int CZegoObject::destroyEngine()
 }
 
 
+// {"channelId":"test","uid":"fan1"}
 int CZegoObject::loginRoom(LPVOID lpExtInfo, string &strOutput)
 {
 	//API_CHECK_ENGINE_INITIAZE(m_lpAgoraEngine, bInitialize, strOutput);
-	string rawJson((char*)lpExtInfo);
-	Json::CharReaderBuilder builder;
-	JSONCPP_STRING err;
 	Json::Value root;
-
-	const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
-	if (!reader->parse(rawJson.c_str(), rawJson.c_str() + rawJson.length(), &root,
-		&err)) {
-		strOutput = "error";
-		return EXIT_FAILURE;
+	ZEGO_CONFIG_ITEM item = MakeConfigItem(ZEGO_CONFIG_LOGIN_ROOM);
+	bool bParsed = ParseJson(lpExtInfo, root) && root["channelId"].isString() && root["uid"].isString();
+	if (bParsed)
+	{
+		CZegoConfig::CopyId(item.config.login.szRoomId, sizeof(item.config.login.szRoomId), root["channelId"].asCString());
+		CZegoConfig::CopyId(item.config.login.szUserId, sizeof(item.config.login.szUserId), root["uid"].asCString());
 	}
+	return ApplyJsonItem(bParsed, item, strOutput);
+}
 
-	auto channelId = root["channelId"].asString();
-	auto cuid = root["uid"].asString();
-
-	std::string roomId = channelId;
+int CZegoObject::loginRoom(const std::string &roomId, const std::string &userId)
+{
 	m_roomId = roomId;
 	ZegoUser user;
-	user.userID = cuid;
-	user.userName = cuid;
+	user.userID = userId;
+	user.userName = userId;
 	m_localUserID = user.userID;
 
-	m_lpZegoEngine->loginRoom(roomId, user);
+	// logoutRoom detaches the handler, attach it again for every login
+	m_lpZegoEngine->setEventHandler(m_pgEventHandler);
+	m_pgEventHandler->ResetJoinState();
+	m_lpRegistry->SetBatchHandler([this](const std::vector<PARTICIPANT_EVENT> &events) { onStreamBatch(events); });
+	getEngine()->loginRoom(roomId, user);
 
-	startPreview();
+	// a headless robot publishes its capture without showing it
+	if (!m_bHeadless)
+		startPreview();
 
+	applyVideoCodec();
 	m_lpZegoEngine->startPublishingStream(user.userID);
+	// the views follow the remote sound levels
+	m_lpZegoEngine->startSoundLevelMonitor();
 	return 0;
 }
 
+int CZegoObject::waitLoginRoom(int nTimeoutMs)
+{
+	return m_pgEventHandler->WaitJoinChannel(nTimeoutMs);
+}
+
 int CZegoObject::startPreview()
 {
 	CAGExtInfoManager *lpExtInfoManager = CAGExtInfoManager::GetAGExtInfoManager();
@@ -218,91 +275,222 @@ int CZegoObject::startPreview()
 	return 0;
 }
 
+// {"resolution":"640*480","bitrate":"1000","fps":"15"}, missing keys keep the 360p preset
 int CZegoObject::setVideoConfig(LPVOID lpExtInfo, string &strOutput)
 {
 	//API_CHECK_ENGINE_INITIAZE(m_lpAgoraEngine, bInitialize, strOutput);
-	string rawJson((char*)lpExtInfo);
-	Json::CharReaderBuilder builder;
-	JSONCPP_STRING err;
 	Json::Value root;
-
-	const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
-	if (!reader->parse(rawJson.c_str(), rawJson.c_str() + rawJson.length(), &root,
-		&err)) {
-		strOutput =  "error";
-		return EXIT_FAILURE;
+	ZEGO_CONFIG_ITEM item = MakeConfigItem(ZEGO_CONFIG_VIDEO);
+	ZegoVideoConfig preset;
+	item.config.video.nWidth = preset.captureWidth;
+	item.config.video.nHeight = preset.captureHeight;
+	item.config.video.nFps = preset.fps;
+	item.config.video.nBitrate = preset.bitrate;
+
+	bool bParsed = ParseJson(lpExtInfo, root)
+		&& JsonInt(root, "bitrate", item.config.video.nBitrate)
+		&& JsonInt(root, "fps", item.config.video.nFps);
+	if (bParsed && !root["resolution"].isNull())
+	{
+		std::string sDimensions = root["resolution"].isString() ? root["resolution"].asString() : "";
+		string::size_type pos = sDimensions.find("*");
+		bParsed = pos < sDimensions.size()
+			&& ParseInt(sDimensions.substr(0, pos), item.config.video.nWidth)
+			&& ParseInt(sDimensions.substr(pos + 1), item.config.video.nHeight);
 	}
+	return ApplyJsonItem(bParsed, item, strOutput);
+}
 
+int CZegoObject::setVideoConfig(int nWidth, int nHeight, int nFps, int nBitrate)
+{
 	ZegoVideoConfig videoConfig;
-	auto cbitrate = root["bitrate"].asString();
-	videoConfig.bitrate = stoi(cbitrate);
-	auto cframeRate = root["fps"].asString();
-	videoConfig.fps = stoi(cframeRate);
-	std::string sDimensions = root["resolution"].asString();
-
-	string::size_type pos = sDimensions.find("*");
-	if (pos < sDimensions.size())
+	videoConfig.captureWidth = nWidth;
+	videoConfig.captureHeight = nHeight;
+	videoConfig.encodeWidth = nWidth;
+	videoConfig.encodeHeight = nHeight;
+	videoConfig.fps = nFps;
+	videoConfig.bitrate = nBitrate;
+	videoConfig.codecID = m_bDualStream ? ZEGO_VIDEO_CODEC_ID_SVC : ZEGO_VIDEO_CODEC_ID_DEFAULT;
+
+	getEngine()->setVideoConfig(videoConfig);
+	return 0;
+}
+
+void CZegoObject::enableDualStream(bool bEnable)
+{
+	m_bDualStream = bEnable;
+	applyVideoCodec();
+}
+
+/**
+	a robot without windows: the engine renders nothing, the decoded remote
+	frames go to CZegoCustomVideoRenderer, and loginRoom skips the preview.
+	the views are then only slots, the streams holding one are played
+	without a canvas and with their video
+*/
+void CZegoObject::enableHeadless(bool bEnable)
+{
 	{
-		std::string swidth = sDimensions.substr(0, pos);
-		std::string sheight = sDimensions.substr(pos + 1, sDimensions.size() - 1);
-		videoConfig.captureWidth = atoi(swidth.c_str());
-		videoConfig.captureHeight = atoi(sheight.c_str());
-		videoConfig.encodeWidth = videoConfig.captureWidth;
-		videoConfig.encodeHeight = videoConfig.captureHeight;
+		std::lock_guard<std::mutex> lock(m_lockStreams);
+		m_bHeadless = bEnable;
 	}
-	
-	m_lpZegoEngine->setVideoConfig(videoConfig);
-	return 0;
+	applyCustomRender();
 }
 
+// CZegoCustomVideoRenderer hands the decoded remote frames to CVideoCompositor, the engine keeps rendering the views
+void CZegoObject::enableRemoteVideoFrames(bool bEnable)
+{
+	m_bRemoteVideoFrames = bEnable;
+	applyCustomRender();
+}
 
-int CZegoObject::logoutRoom()
+// custom render is on while headless or while the remote frames are wanted, before loginRoom
+void CZegoObject::applyCustomRender()
 {
-	m_bstopPlayingStream = false;
-	m_bDisableVideo = false;
-	m_bDisableAudio = false;
+	bool bHeadless = false;
+	{
+		std::lock_guard<std::mutex> lock(m_lockStreams);
+		bHeadless = m_bHeadless;
+	}
+	bool bCustomRender = bHeadless || m_bRemoteVideoFrames;
+
+	ZegoCustomVideoRenderConfig customVideoRenderConfig;
+	customVideoRenderConfig.bufferType = ZEGO_VIDEO_BUFFER_TYPE_RAW_DATA;
+	// i420 as decoded, no color conversion for the compositor or for frames that are dropped
+	customVideoRenderConfig.frameFormatSeries = ZEGO_VIDEO_FRAME_FORMAT_SERIES_YUV;
+	customVideoRenderConfig.enableEngineRender = !bHeadless;
+	m_lpZegoEngine->enableCustomVideoRender(bCustomRender, &customVideoRenderConfig);
+	m_lpZegoEngine->setCustomVideoRenderHandler(bCustomRender ? m_pgVideoRenderer : nullptr);
+}
+
+// svc carries the base layer the small views play, it only applies to the next publish
+void CZegoObject::applyVideoCodec()
+{
+	ZegoVideoConfig videoConfig = getEngine()->getVideoConfig();
+	ZegoVideoCodecID codecID = m_bDualStream ? ZEGO_VIDEO_CODEC_ID_SVC : ZEGO_VIDEO_CODEC_ID_DEFAULT;
+	if (videoConfig.codecID == codecID)
+		return;
+
+	videoConfig.codecID = codecID;
+	getEngine()->setVideoConfig(videoConfig);
+}
 
+
+int CZegoObject::logoutRoom()
+{
 	m_lpZegoEngine->logoutRoom(m_roomId);
 	getEngine()->enableCustomVideoCapture(false, nullptr);
     getEngine()->setCustomVideoCaptureHandler(nullptr);
     getEngine()->setEventHandler(nullptr);
-	getEngine()->enableCustomAudioIO(false, nullptr);
-    getEngine()->setAudioDataHandler(nullptr);
-	m_zegoStreamList.clear();
+	// the sink stays for the next room, a robot keeps pulling through it
+	if (!m_bAudioSink)
+		getEngine()->enableCustomAudioIO(false, nullptr);
+	m_bCustomAudioIO = false;
+	// the recording goes on into the next room
+	if (!m_bAudioRecording)
+		getEngine()->setAudioDataHandler(nullptr);
+	m_lpZegoEngine->stopSoundLevelMonitor();
+
+	std::lock_guard<std::mutex> lock(m_lockStreams);
+	m_bstopPlayingStream = false;
+	m_bDisableVideo = false;
+	m_bDisableAudio = false;
+	freeStreamViews();
+	m_lpRegistry->Clear();
 	return 0;
 }
 
+// queued, a login into a big room announces every stream at once
 void CZegoObject::onRoomStreamUpdate(const std::string &roomID, ZegoUpdateType updateType, const std::vector<ZegoStream> &streamList)
 {
 	if (m_roomId != roomID)
 		return;
 
-	int size = streamList.size();
-	for ( int i = 0; i < size; i++ ) {
-		ZegoStream stream = streamList.at(i);
-		auto it = std::find_if(m_zegoStreamList.begin(), m_zegoStreamList.end(), [&](ZegoStream const &_stream) {
-			return _stream.streamID == stream.streamID;
-		});
+	for (auto &stream : streamList) {
+		if (updateType == ZEGO_UPDATE_TYPE_ADD)
+			m_lpRegistry->Post(PARTICIPANT_EVENT_JOINED, stream.streamID);
+		else if (updateType == ZEGO_UPDATE_TYPE_DELETE)
+			m_lpRegistry->Post(PARTICIPANT_EVENT_LEFT, stream.streamID);
+	}
+}
 
-		if (updateType == ZEGO_UPDATE_TYPE_ADD && it == m_zegoStreamList.end()) {
-			m_zegoStreamList.push_back(stream);
-		}
+// the room updates of one PARTICIPANT_BATCH_MS, on the worker of the registry
+void CZegoObject::onStreamBatch(const std::vector<PARTICIPANT_EVENT> &events)
+{
+	std::lock_guard<std::mutex> lock(m_lockStreams);
+	for (auto &event : events) {
+		// posted before logoutRoom
+		if (event.nGeneration != m_lpRegistry->GetGeneration())
+			continue;
+		if (event.nType == PARTICIPANT_EVENT_JOINED)
+			addStream(event.strId);
+		else
+			removeStream(event.strId);
+	}
+}
 
-		if (updateType == ZEGO_UPDATE_TYPE_DELETE && it != m_zegoStreamList.end()) {
-			m_lpZegoEngine->stopPlayingStream(stream.streamID);
-			m_zegoStreamList.erase(it);
-		}
+// under m_lockStreams, a free view or a wait for one, the audio is played either way
+void CZegoObject::addStream(const std::string &streamID)
+{
+	if (m_lpRegistry->Contains(streamID))
+		return;
+
+	PARTICIPANT_INFO info = { NULL, NULL, 0 };
+	info.hView = CAGExtInfoManager::GetAGExtInfoManager()->GetOneFreeView();
+	if (!m_lpRegistry->Add(streamID, info)) {
+		if (info.hView != NULL)
+			CAGExtInfoManager::GetAGExtInfoManager()->FreeView(info.hView);
+		return;
 	}
+	m_scheduler.Add(streamID, info.hView != NULL, CMediaClock::NowUs() / 1000);
+	reconcileStream(streamID, info);
+}
 
-	updateStatus();
+// under m_lockStreams, the view goes to the loudest waiting stream
+void CZegoObject::removeStream(const std::string &streamID)
+{
+	PARTICIPANT_INFO info;
+	if (!m_lpRegistry->Get(streamID, info))
+		return;
+
+	if (info.nFlags & PARTICIPANT_FLAG_PLAYING)
+		m_lpZegoEngine->stopPlayingStream(streamID);
+	m_lpRegistry->Remove(streamID);
+	m_scheduler.Remove(streamID);
+	if (info.hView == NULL)
+		return;
+
+	std::string next;
+	PARTICIPANT_INFO nextInfo;
+	if (!m_scheduler.PickWaiting(CMediaClock::NowUs() / 1000, next) || !m_lpRegistry->Get(next, nextInfo)) {
+		CAGExtInfoManager::GetAGExtInfoManager()->FreeView(info.hView);
+		return;
+	}
+	nextInfo.hView = info.hView;
+	reconcileStream(next, nextInfo);
+}
+
+// under m_lockStreams
+void CZegoObject::freeStreamViews()
+{
+	std::vector<std::string> streamIDs;
+	m_lpRegistry->GetIds(streamIDs);
+	for (auto &streamID : streamIDs) {
+		PARTICIPANT_INFO info;
+		if (!m_lpRegistry->Get(streamID, info) || info.hView == NULL)
+			continue;
+		CAGExtInfoManager::GetAGExtInfoManager()->FreeView(info.hView);
+		info.hView = NULL;
+		m_lpRegistry->Update(streamID, info);
+	}
+	m_scheduler.Clear();
 }
 
 int CZegoObject::stopPlayingStream()
 {
+	std::lock_guard<std::mutex> lock(m_lockStreams);
 	m_bstopPlayingStream = true;
-	for( auto stream:m_zegoStreamList) {
-		m_lpZegoEngine->stopPlayingStream(stream.streamID);
-	}
+	updateStatusLocked();
 	return 0;
 }
 
@@ -317,10 +505,68 @@ void CZegoObject::enableCustomVideoCapture()
 }
 
 void CZegoObject::enableCustomAudioIO()
+{
+	enableCustomAudioIO(ZEGO_AUDIO_SOURCE_TYPE_MEDIA_PLAYER);
+}
+
+void CZegoObject::enableCustomAudioIO(ZegoAudioSourceType sourceType)
 {
 	ZegoCustomAudioConfig audioConfig;
-	audioConfig.sourceType = ZEGO_AUDIO_SOURCE_TYPE_MEDIA_PLAYER;
+	audioConfig.sourceType = sourceType;
 	getEngine()->enableCustomAudioIO(true, &audioConfig);
+	m_bCustomAudioIO = true;
+}
+
+/**
+	the custom audio IO of this SDK version renders and captures together, so
+	the sink turns on custom capture as well. without rtc_pushAudioFrame
+	nothing is published, which suits a robot that only listens
+*/
+void CZegoObject::enableAudioSink(bool bEnable)
+{
+	m_bAudioSink = bEnable;
+	if (m_bCustomAudioIO)
+		return;
+
+	if (bEnable) {
+		ZegoCustomAudioConfig audioConfig;
+		audioConfig.sourceType = ZEGO_AUDIO_SOURCE_TYPE_CUSTOM;
+		getEngine()->enableCustomAudioIO(true, &audioConfig);
+	}
+	else
+		getEngine()->enableCustomAudioIO(false, nullptr);
+}
+
+// from the CAudioSink thread, the SDK fills silence when it has nothing decoded
+void CZegoObject::fetchAudioSink(int16_t* lpPcm, int nSamples, int nSampleRate, int nChannels)
+{
+	ZegoAudioFrameParam param;
+	param.sampleRate = (ZegoAudioSampleRate)nSampleRate;
+	param.channel = nChannels == 2 ? ZEGO_AUDIO_CHANNEL_STEREO : ZEGO_AUDIO_CHANNEL_MONO;
+	m_lpZegoEngine->fetchCustomAudioRenderPCMData((unsigned char*)lpPcm, (unsigned int)(nSamples * nChannels * 2), param);
+}
+
+/**
+	the SDK copies what it plays and what it mixes into the audio data
+	handler, which hands it to CAudioRecorder. the callbacks run while a
+	stream is published or played
+*/
+void CZegoObject::enableAudioRecording(bool bEnable, int nSampleRate, int nChannels)
+{
+	m_bAudioRecording = bEnable;
+	if (!bEnable) {
+		getEngine()->enableAudioDataCallback(false, 0, ZegoAudioFrameParam());
+		getEngine()->setAudioDataHandler(nullptr);
+		return;
+	}
+
+	if (!m_pgAudioDataHandler)
+		m_pgAudioDataHandler = std::make_shared<CZegoAudioDataHandler>();
+	ZegoAudioFrameParam param;
+	param.sampleRate = (ZegoAudioSampleRate)nSampleRate;
+	param.channel = nChannels == 2 ? ZEGO_AUDIO_CHANNEL_STEREO : ZEGO_AUDIO_CHANNEL_MONO;
+	getEngine()->setAudioDataHandler(m_pgAudioDataHandler);
+	getEngine()->enableAudioDataCallback(true, ZEGO_AUDIO_DATA_CALLBACK_BIT_MASK_REMOTE | ZEGO_AUDIO_DATA_CALLBACK_BIT_MASK_MIXED, param);
 }
 
 void CZegoObject::startCapMedia(string path)
@@ -331,16 +577,26 @@ void CZegoObject::startCapMedia(string path)
     theMediaSource->startPlayMedia(path);
 }
 
+// publish what rtc_pushVideoFrame and rtc_pushAudioFrame put into the core buffers
+void CZegoObject::startCapPush()
+{
+	m_pgVideoCap->getVideoSource(ZegoCustomVideoSourceType_Push);
+}
+
 int CZegoObject::disableAudio()
 {
-	m_bDisableAudio = true;
+	return enableAudio(false);
+}
+
+// microphone, audio publishing and the audio of every played stream
+int CZegoObject::enableAudio(bool bEnable)
+{
+	std::lock_guard<std::mutex> lock(m_lockStreams);
+	m_bDisableAudio = !bEnable;
 
 	m_lpZegoEngine->enableAudioCaptureDevice(!m_bDisableAudio);
 	m_lpZegoEngine->mutePublishStreamAudio(m_bDisableAudio);
-
-	for (auto stream : m_zegoStreamList) {
-		m_lpZegoEngine->mutePlayStreamAudio(stream.streamID, m_bDisableAudio);
-	}
+	updateStatusLocked();
 
 	/*
 	ZegoCustomAudioConfig audioConfig;
@@ -352,48 +608,138 @@ int CZegoObject::disableAudio()
 
 int CZegoObject::disableVideo()
 {
+	std::lock_guard<std::mutex> lock(m_lockStreams);
 	m_bDisableVideo = true;
 
 	m_lpZegoEngine->mutePublishStreamVideo(m_bDisableVideo);
-	for (auto stream : m_zegoStreamList) {
-		m_lpZegoEngine->mutePlayStreamVideo(stream.streamID, m_bDisableVideo);
-	}
+	updateStatusLocked();
 	m_lpZegoEngine->enableCamera(!m_bDisableVideo);
 	return 0;
 }
 
 void CZegoObject::updateStatus()
 {
-	if (m_bstopPlayingStream == true)
+	std::lock_guard<std::mutex> lock(m_lockStreams);
+	updateStatusLocked();
+}
+
+// under m_lockStreams
+void CZegoObject::updateStatusLocked()
+{
+	std::vector<std::string> streamIDs;
+	m_lpRegistry->GetIds(streamIDs);
+	for (auto &streamID : streamIDs) {
+		PARTICIPANT_INFO info;
+		if (m_lpRegistry->Get(streamID, info))
+			reconcileStream(streamID, info);
+	}
+}
+
+/**
+	under m_lockStreams, bring the SDK to the state the stream should have:
+	played unless stopPlayingStream was called, drawn into its view or with
+	the video muted while it waits, the base layer for a small view or none,
+	the audio muted with disableAudio. playing again only moves the canvas, a
+	new layer or losing the view restarts the play. nothing is called when
+	the stream is already there, info is written back to the registry
+*/
+void CZegoObject::reconcileStream(const std::string &streamID, PARTICIPANT_INFO &info)
+{
+	if (m_bstopPlayingStream == true) {
+		if (info.nFlags & PARTICIPANT_FLAG_PLAYING)
+			m_lpZegoEngine->stopPlayingStream(streamID);
+		info.nFlags &= ~PARTICIPANT_FLAG_PLAYING;
+		m_lpRegistry->Update(streamID, info);
 		return;
+	}
 
-	CAGExtInfoManager *lpExtInfoManager = CAGExtInfoManager::GetAGExtInfoManager();
+	ZegoPlayerConfig config;
+	config.videoLayer = info.hView == NULL || CAGExtInfoManager::GetAGExtInfoManager()->IsSmallView(info.hView)
+		? ZEGO_PLAYER_VIDEO_LAYER_BASE : ZEGO_PLAYER_VIDEO_LAYER_AUTO;
+	ZegoPlayerVideoLayer layer = (info.nFlags & PARTICIPANT_FLAG_LOW_STREAM) ? ZEGO_PLAYER_VIDEO_LAYER_BASE : ZEGO_PLAYER_VIDEO_LAYER_AUTO;
 
-	HWND hWnd = NULL;
-	int nViewPos = 1;//0 for local view
-	for (int j = 0; j < m_zegoStreamList.size(); j++) {
-		auto stream = m_zegoStreamList.at(j);
-
-		HWND hWnd = (HWND)lpExtInfoManager->GetViewAt(nViewPos);
-		if (hWnd != NULL)
-		{
-			ZegoCanvas canvas(hWnd, ZEGO_VIEW_MODE_ASPECT_FIT);
-			m_lpZegoEngine->startPlayingStream(stream.streamID, &canvas);
-			nViewPos++;
-		}
+	if ((info.nFlags & PARTICIPANT_FLAG_PLAYING) && (layer != config.videoLayer || (info.hRenderView != NULL && info.hView == NULL))) {
+		m_lpZegoEngine->stopPlayingStream(streamID);
+		info.nFlags &= ~PARTICIPANT_FLAG_PLAYING;
 	}
 
-	if (m_bDisableVideo == true)
-	{
-		for (auto stream : m_zegoStreamList) {
-			m_lpZegoEngine->mutePlayStreamVideo(stream.streamID, m_bDisableVideo);
+	if (!(info.nFlags & PARTICIPANT_FLAG_PLAYING) || info.hRenderView != info.hView) {
+		if (info.hView != NULL && !m_bHeadless) {
+			ZegoCanvas canvas(info.hView, ZEGO_VIEW_MODE_ASPECT_FIT);
+			m_lpZegoEngine->startPlayingStream(streamID, &canvas, config);
 		}
+		else
+			m_lpZegoEngine->startPlayingStream(streamID, nullptr, config);
+
+		// a new play starts unmuted
+		if (!(info.nFlags & PARTICIPANT_FLAG_PLAYING))
+			info.nFlags &= ~(PARTICIPANT_FLAG_VIDEO_MUTED | PARTICIPANT_FLAG_AUDIO_MUTED);
+		info.nFlags |= PARTICIPANT_FLAG_PLAYING;
+		info.hRenderView = info.hView;
+		if (config.videoLayer == ZEGO_PLAYER_VIDEO_LAYER_BASE)
+			info.nFlags |= PARTICIPANT_FLAG_LOW_STREAM;
+		else
+			info.nFlags &= ~PARTICIPANT_FLAG_LOW_STREAM;
 	}
-	if (m_bDisableAudio == true)
-	{
-		for (auto stream : m_zegoStreamList) {
-			m_lpZegoEngine->mutePlayStreamAudio(stream.streamID, m_bDisableAudio);
-		}
+
+	bool bVideoMuted = info.hView == NULL || m_bDisableVideo;
+	if (((info.nFlags & PARTICIPANT_FLAG_VIDEO_MUTED) != 0) != bVideoMuted) {
+		m_lpZegoEngine->mutePlayStreamVideo(streamID, bVideoMuted);
+		info.nFlags ^= PARTICIPANT_FLAG_VIDEO_MUTED;
+	}
+	if (((info.nFlags & PARTICIPANT_FLAG_AUDIO_MUTED) != 0) != m_bDisableAudio) {
+		m_lpZegoEngine->mutePlayStreamAudio(streamID, m_bDisableAudio);
+		info.nFlags ^= PARTICIPANT_FLAG_AUDIO_MUTED;
+	}
+	m_lpRegistry->Update(streamID, info);
+}
+
+/**
+	the quality goes to the registry without a lock, the lock is only taken
+	when the view of streamID plays a layer its size does not want any more
+*/
+void CZegoObject::onPlayerQualityUpdate(const std::string &streamID, const ZegoPlayStreamQuality &quality)
+{
+	m_lpRegistry->SetStat(streamID, PARTICIPANT_STAT_VIDEO_KBPS, (int32_t)quality.videoKBPS);
+	m_lpRegistry->SetStat(streamID, PARTICIPANT_STAT_VIDEO_FPS, (int32_t)quality.videoRenderFPS);
+	m_lpRegistry->SetStat(streamID, PARTICIPANT_STAT_DELAY_MS, quality.delay);
+	m_lpRegistry->SetStat(streamID, PARTICIPANT_STAT_AUDIO_KBPS, (int32_t)quality.audioKBPS);
+
+	PARTICIPANT_INFO info;
+	if (!m_lpRegistry->Get(streamID, info) || info.hView == NULL)
+		return;
+	bool bBase = CAGExtInfoManager::GetAGExtInfoManager()->IsSmallView(info.hView);
+	if (bBase == ((info.nFlags & PARTICIPANT_FLAG_LOW_STREAM) != 0))
+		return;
+
+	std::lock_guard<std::mutex> lock(m_lockStreams);
+	if (m_lpRegistry->Get(streamID, info) && info.hView != NULL)
+		reconcileStream(streamID, info);
+}
+
+void CZegoObject::onRemoteSoundLevelUpdate(const std::unordered_map<std::string, float> &soundLevels)
+{
+	std::vector<std::pair<std::string, float>> levels(soundLevels.begin(), soundLevels.end());
+	for (auto &level : levels)
+		m_lpRegistry->SetStat(level.first, PARTICIPANT_STAT_AUDIO_LEVEL, (int32_t)level.second);
+
+	std::lock_guard<std::mutex> lock(m_lockStreams);
+	m_scheduler.UpdateLevels(levels);
+	if (m_bstopPlayingStream == true)
+		return;
+
+	std::vector<std::pair<std::string, std::string>> swaps;
+	m_scheduler.Schedule(CMediaClock::NowUs() / 1000, swaps);
+	for (auto &swap : swaps) {
+		PARTICIPANT_INFO out, in;
+		if (!m_lpRegistry->Get(swap.first, out) || !m_lpRegistry->Get(swap.second, in) || out.hView == NULL)
+			continue;
+
+		LOG_DEBUG("zego stream %s speaks, takes the view of %s", swap.second.c_str(), swap.first.c_str());
+		in.hView = out.hView;
+		out.hView = NULL;
+		reconcileStream(swap.first, out);
+		reconcileStream(swap.second, in);
 	}
 }
 
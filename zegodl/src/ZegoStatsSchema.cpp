@@ -0,0 +1,16 @@
+#include "ZegoStatsSchema.h"
+
+static const STATS_SCHEMA g_statsSchemas[] =
+{
+	{ STATS_PUBLISHER, "publisher", "streamID", { STATS_D("videoCaptureFPS"), STATS_D("videoEncodeFPS"), STATS_D("videoSendFPS"),
+		STATS_D("videoKBPS"), STATS_D("audioCaptureFPS"), STATS_D("audioSendFPS"), STATS_D("audioKBPS"), STATS_I("rtt"),
+		STATS_D("packetLostRate"), STATS_I("level"), STATS_I("isHardwareEncode"), STATS_D("totalSendBytes"),
+		STATS_D("audioSendBytes"), STATS_D("videoSendBytes"), { NULL, 0 } } },
+	{ STATS_PLAYER, "player", "streamID", { STATS_D("videoRecvFPS"), STATS_D("videoDecodeFPS"), STATS_D("videoRenderFPS"),
+		STATS_D("videoKBPS"), STATS_D("audioRecvFPS"), STATS_D("audioDecodeFPS"), STATS_D("audioRenderFPS"), STATS_D("audioKBPS"),
+		STATS_I("rtt"), STATS_D("packetLostRate"), STATS_I("peerToPeerDelay"), STATS_D("peerToPeerPacketLostRate"),
+		STATS_I("level"), STATS_I("delay"), STATS_I("isHardwareDecode"), STATS_D("totalRecvBytes"), STATS_D("audioRecvBytes"),
+		STATS_D("videoRecvBytes"), { NULL, 0 } } },
+};
+
+const STATS_SCHEMA_SET g_zegoStatsSchemas = { "zego", g_statsSchemas, sizeof(g_statsSchemas) / sizeof(g_statsSchemas[0]) };
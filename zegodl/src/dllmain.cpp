@@ -8,7 +8,16 @@
 
 #include <iostream>
 #include "ZegoObject.h"
+#include "ZegoConfig.h"
+#include "CommandQueue.h"
+#include "ZegoEvent.h"
+#include "ZegoBackend.h"
+#include "StatsRecorder.h"
+#include "Logger.h"
 #include "AGExtInfoManager.h"
+#include "ZegoChurnTarget.h"
+#include "JsonArgs.h"
+#include "json/json.h"
 using namespace std;
 
 BOOL APIENTRY DllMain( HMODULE hModule,
@@ -48,181 +57,317 @@ BOOL APIENTRY DllMain( HMODULE hModule,
 
 extern "C" void ZEGODL_API HelloWorld()
 {
-	cout << "hello world" << endl;
+	LOG_INFO("hello world");
 }
 
+// the void exports post their SDK call to the engine thread and return at
+// once, it runs after everything posted before and needs createEngine first
 extern "C" void ZEGODL_API enableCustomVideoCapture()
 {
-	cout << "enableCustomVideoCapture" << endl;
-	CZegoObject::GetZegoObject()->enableCustomVideoCapture();
+	LOG_INFO("enableCustomVideoCapture");
+	CCommandQueue::GetInstance()->PostCommand(ENGINE_COMMAND_CUSTOM_VIDEO_CAPTURE);
 }
 
 extern "C" void ZEGODL_API enableCustomAudioIO()
 {
-	cout << "enableCustomAudioIO" << endl;
-	CZegoObject::GetZegoObject()->enableCustomAudioIO();
+	LOG_INFO("enableCustomAudioIO");
+	CCommandQueue::GetInstance()->PostCommand(ENGINE_COMMAND_CUSTOM_AUDIO_IO);
 }
 
 
 extern "C" void ZEGODL_API startCapMedia(LPVOID lpExtInfo)
 {
-	cout << "startCapMedia:" << lpExtInfo << endl;
-	CZegoObject::GetZegoObject()->startCapMedia((char*)lpExtInfo);
+	LOG_INFO("startCapMedia:%s", (char*)lpExtInfo);
+	CCommandQueue::GetInstance()->PostCommand(ENGINE_COMMAND_CAP_MEDIA, (const char*)lpExtInfo);
 }
 
 extern "C" void ZEGODL_API stopPreview()
 {
-	cout << "stopPreview:" << endl;
-	CZegoObject::GetZegoObject()->getEngine()->stopPreview(ZEGO::EXPRESS::ZEGO_PUBLISH_CHANNEL_MAIN);
+	LOG_INFO("stopPreview");
+	CCommandQueue::GetInstance()->PostCommand(ENGINE_COMMAND_STOP_PREVIEW);
 }
 
 extern "C" void ZEGODL_API stopPlayingStream()
 {
-	cout << "stopPlayingStream:" << endl;
-	CZegoObject::GetZegoObject()->stopPlayingStream();
+	LOG_INFO("stopPlayingStream");
+	CCommandQueue::GetInstance()->PostCommand(ENGINE_COMMAND_STOP_PLAYING_STREAM);
 }
 
 extern "C" void ZEGODL_API muteSpeaker()
 {
-	cout << "muteSpeaker:" << endl;
-	CZegoObject::GetZegoObject()->getEngine()->muteSpeaker(true);
+	LOG_INFO("muteSpeaker");
+	CCommandQueue::GetInstance()->PostCommand(ENGINE_COMMAND_MUTE_SPEAKER);
 }
 
 extern "C" void ZEGODL_API createEngine()
 {
-	cout << "createEngine" << endl;
-	string out;
-	CZegoObject::GetZegoObject()->createEngine(nullptr, out);
-	cout << out << endl;
-
-    cout <<"zego version:" << ZegoExpressSDK::getVersion() << endl;
+	LOG_INFO("createEngine");
+	CZegoBackend::GetInstance()->CreateEngine(nullptr);
 }
 
 extern "C" void ZEGODL_API destroyZegoEngine()
 {
-	CZegoObject::GetZegoObject()->destroyZegoEngine();
+	CZegoBackend::GetInstance()->DestroyEngine();
+	CLogger::GetInstance()->Flush();
 }
 
-extern "C" void ZEGODL_API joinChannel(LPVOID lpExtInfo)
+// version of the typed config ABI in ZegoConfig.h
+extern "C" int ZEGODL_API getConfigAbiVersion()
 {
-	string strOutput;
-	cout << lpExtInfo << endl;
-	CZegoObject::GetZegoObject()->joinChannel(lpExtInfo, strOutput);
-	cout << strOutput << endl;
+	return ZEGO_CONFIG_ABI_VERSION;
+}
+
+// sizeof(ZEGO_CONFIG_ITEM), lets a ctypes mirror check its layout
+extern "C" int ZEGODL_API getConfigItemSize()
+{
+	return sizeof(ZEGO_CONFIG_ITEM);
+}
+
+// applies a batch of typed config items, see ZegoConfig.h. nAbiVersion is the
+// ZEGO_CONFIG_ABI_VERSION the caller was built against, every nResult is filled in.
+// it runs on the engine thread after whatever was posted before and blocks until it is done.
+// returns ZEGO_CONFIG_OK or the ZEGO_CONFIG_RESULT of the first failed item
+extern "C" int ZEGODL_API applyConfig(int nAbiVersion, ZEGO_CONFIG_ITEM* lpItems, int nCount)
+{
+	if (nAbiVersion != ZEGO_CONFIG_ABI_VERSION)
+		return ZEGO_CONFIG_ERR_VERSION;
+	return CCommandQueue::GetInstance()->Run(lpItems, nCount);
+}
+
+// queues a batch of typed config items for the engine thread and returns at once.
+// the items are copied, a bad field refuses the whole batch before it is queued.
+// returns a ticket (>0) for pollCommand/waitCommand, or a negative ZEGO_CONFIG_RESULT
+extern "C" int64_t ZEGODL_API postConfig(int nAbiVersion, const ZEGO_CONFIG_ITEM* lpItems, int nCount)
+{
+	if (nAbiVersion != ZEGO_CONFIG_ABI_VERSION)
+		return ZEGO_CONFIG_ERR_VERSION;
+	return CCommandQueue::GetInstance()->PostConfig(lpItems, nCount);
+}
+
+// queues logoutRoom, returns its ticket
+extern "C" int64_t ZEGODL_API postLeaveChannel()
+{
+	return CCommandQueue::GetInstance()->PostLeaveChannel();
+}
+
+// state of a posted command, never blocks. ZEGO_CONFIG_PENDING (1) while it
+// is queued or running, else its ZEGO_CONFIG_RESULT
+extern "C" int ZEGODL_API pollCommand(int64_t nTicket)
+{
+	return CCommandQueue::GetInstance()->Poll(nTicket);
+}
+
+// waits for a posted command, <0 waits forever. commands finish in the order
+// they were posted so this also waits for everything posted before it.
+// returns its ZEGO_CONFIG_RESULT, or ZEGO_CONFIG_ERR_TIMEOUT
+extern "C" int ZEGODL_API waitCommand(int64_t nTicket, int nTimeoutMs)
+{
+	return CCommandQueue::GetInstance()->Wait(nTicket, nTimeoutMs);
+}
+
+// version and record size of the ZEGO_EVENT ABI in ZegoEvent.h
+extern "C" int ZEGODL_API getEventAbiVersion()
+{
+	return ZEGO_EVENT_ABI_VERSION;
+}
+
+extern "C" int ZEGODL_API getEventSize()
+{
+	return sizeof(ZEGO_EVENT);
+}
+
+// drains up to nMax SDK events into lpEvents without waiting for new ones,
+// returns how many were written or ZEGO_CONFIG_ERR_INVALID_ARG for a bad buffer
+extern "C" int ZEGODL_API pollEvents(ZEGO_EVENT* lpEvents, int nMax)
+{
+	if (lpEvents == nullptr || nMax <= 0)
+		return ZEGO_CONFIG_ERR_INVALID_ARG;
+	return CZegoEventRing::GetInstance()->Poll(lpEvents, nMax);
 }
 
-extern "C" void ZEGODL_API leaveChannel(LPVOID lpExtInfo)
+// records the publisher/player quality callbacks to a binary file at lpPath
+// until stopStatsRecording, it keeps running across createEngine/destroyEngine.
+// stats_csv.py converts the file to csv. 0, or -1 when already recording or
+// the file can not be created
+extern "C" int ZEGODL_API startStatsRecording(const char* lpPath)
+{
+	return CStatsRecorder::GetInstance()->Start(lpPath, CZegoBackend::GetInstance()->GetStatsSchemas());
+}
+
+// flushes and closes the stats file, returns the number of samples written or -1 when not recording
+extern "C" int64_t ZEGODL_API stopStatsRecording()
+{
+	return CStatsRecorder::GetInstance()->Stop();
+}
+
+// {"channelId":"test","uid":"fan1"}, the json config exports return a ZEGO_CONFIG_RESULT
+extern "C" int ZEGODL_API joinChannel(LPVOID lpExtInfo)
 {
 	string strOutput;
-	CZegoObject::GetZegoObject()->leaveChannel(lpExtInfo, strOutput);
-	cout << strOutput << endl;
+	LOG_INFO("joinChannel:%s", (char*)lpExtInfo);
+	int nResult = CZegoObject::GetZegoObject()->joinChannel(lpExtInfo, strOutput);
+	if (!strOutput.empty())
+		LOG_INFO("%s", strOutput.c_str());
+	return nResult;
+}
+
+extern "C" int ZEGODL_API waitJoinChannel(int timeoutMs)
+{
+	return CZegoObject::GetZegoObject()->waitLoginRoom(timeoutMs);
+}
+
+// join/leave churn benchmark, blocks until every cycle is done
+// {"channelId":"test","uid":"fan1","cycles":"100","holdms":"1000","timeoutms":"10000","output":"churn.hist"}
+// returns the number of failed cycles. room state is delivered on the thread
+// that created the engine, so call it from a worker thread
+extern "C" int ZEGODL_API runChurnBenchmark(LPVOID lpExtInfo)
+{
+	string rawJson((char*)lpExtInfo);
+	Json::CharReaderBuilder builder;
+	JSONCPP_STRING err;
+	Json::Value root;
+
+	const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+	if (!reader->parse(rawJson.c_str(), rawJson.c_str() + rawJson.length(), &root, &err))
+		return -1;
+
+	int64_t nCycles = 100, nHoldMs = 1000, nTimeoutMs = 10000;
+	if (!CJsonArgs::JsonInteger(root, "cycles", 1, INT32_MAX, nCycles) || !CJsonArgs::JsonInteger(root, "holdms", 0, INT32_MAX, nHoldMs)
+		|| !CJsonArgs::JsonInteger(root, "timeoutms", 1, INT32_MAX, nTimeoutMs))
+	{
+		LOG_ERROR("runChurnBenchmark: bad cycles, holdms or timeoutms");
+		return -1;
+	}
+
+	CChurnBench *lpChurnBench = CChurnBench::GetInstance();
+	CZegoChurnTarget target(root["channelId"].asString(), root["uid"].asString());
+	int nFailed = lpChurnBench->Run(&target, (int)nCycles, (int)nHoldMs, (int)nTimeoutMs);
+	// the report goes straight to cout, the lines logged during the run come first
+	CLogger::GetInstance()->Flush();
+	lpChurnBench->Report(cout);
+
+	if (!root["output"].isNull() && !lpChurnBench->Dump(root["output"].asString().c_str()))
+		LOG_ERROR("runChurnBenchmark can not write %s", root["output"].asString().c_str());
+
+	return nFailed;
+}
+
+extern "C" int ZEGODL_API leaveChannel(LPVOID /*lpExtInfo*/)
+{
+	return CCommandQueue::GetInstance()->RunLeaveChannel();
 }
 
 extern "C" void ZEGODL_API enableVideo(LPVOID lpExtInfo)
 {
-	string strOutput;
-	CZegoObject::GetZegoObject()->enableVideo(lpExtInfo, strOutput);
-	cout << strOutput << endl;
+	CCommandQueue::GetInstance()->PostCommand(ENGINE_COMMAND_ENABLE_VIDEO);
 }
 
 extern "C" void ZEGODL_API disableVideo()
 {
-	cout << "disableVideo" << endl;
-	CZegoObject::GetZegoObject()->disableVideo();
+	LOG_INFO("disableVideo");
+	CCommandQueue::GetInstance()->PostCommand(ENGINE_COMMAND_DISABLE_VIDEO);
 }
 
 extern "C" void ZEGODL_API disableAudio()
 {
-	cout << "disableAudio" << endl;
-	CZegoObject::GetZegoObject()->disableAudio();
+	LOG_INFO("disableAudio");
+	CCommandQueue::GetInstance()->PostCommand(ENGINE_COMMAND_DISABLE_AUDIO);
 }
 
-extern "C" void ZEGODL_API setVideoProfile(LPVOID lpExtInfo)
+extern "C" int ZEGODL_API setVideoProfile(LPVOID lpExtInfo)
 {
 	string strOutput;
-	CZegoObject::GetZegoObject()->setVideoProfile(lpExtInfo, strOutput);
-	cout << strOutput << endl;
+	int nResult = CZegoObject::GetZegoObject()->setVideoProfile(lpExtInfo, strOutput);
+	if (!strOutput.empty())
+		LOG_INFO("%s", strOutput.c_str());
+	return nResult;
 }
 
 extern "C" void ZEGODL_API addView(LPVOID lpExtInfo, int i)
 {
 	string strOutput;
-	CAGExtInfoManager::GetAGExtInfoManager()->AddView((HWND)lpExtInfo);
-	cout << strOutput << endl;
+	CAGExtInfoManager::GetAGExtInfoManager()->AddView((VHANDLE)lpExtInfo);
+	if (!strOutput.empty())
+		LOG_INFO("%s", strOutput.c_str());
 }
 
 extern "C" void ZEGODL_API enumerateRecordingDevices()
 {
-	auto adl = CZegoObject::GetZegoObject()->getEngine()->getAudioDeviceList(ZEGO_AUDIO_DEVICE_TYPE_INPUT);
-	SetConsoleOutputCP(65001);
-	cout << "Audio Recording Devices" << endl;
-	for (auto i : adl)
-	{
-		cout << "deviceName:" << i.deviceName << " deviceId:" << i.deviceID << endl;
-	}
+	CCommandQueue::GetInstance()->PostCommand(ENGINE_COMMAND_LOG_RECORDING_DEVICES);
 }
 
 extern "C" void ZEGODL_API setRecordingDevice(LPVOID lpExtInfo)
 {
-	CZegoObject::GetZegoObject()->getEngine()->useAudioDevice(ZEGO_AUDIO_DEVICE_TYPE_INPUT, (char*)lpExtInfo);
+	CCommandQueue::GetInstance()->PostCommand(ENGINE_COMMAND_RECORDING_DEVICE, (const char*)lpExtInfo);
 }
 
 extern "C" void ZEGODL_API enumerateVideoDevices()
 {
-	auto vdl = CZegoObject::GetZegoObject()->getEngine()->getVideoDeviceList();
-	SetConsoleOutputCP(65001);
-	cout << "Video Recording Devices" << endl;
-	for (auto i : vdl)
-	{
-		cout << "deviceName:" << i.deviceName << " deviceId:" << i.deviceID << endl;
-	}
+	CCommandQueue::GetInstance()->PostCommand(ENGINE_COMMAND_LOG_VIDEO_DEVICES);
 }
 
 extern "C" void ZEGODL_API setVideoDevice(LPVOID lpExtInfo)
 {
-	CZegoObject::GetZegoObject()->getEngine()->useVideoDevice((char*)lpExtInfo);
+	CCommandQueue::GetInstance()->PostCommand(ENGINE_COMMAND_VIDEO_DEVICE, (const char*)lpExtInfo);
 }
 
 extern "C" void ZEGODL_API enableHardwareEncoder()
 {
-	CZegoObject::GetZegoObject()->getEngine()->enableHardwareEncoder(true);
+	ZEGO_CONFIG_ITEM item;
+	memset(&item, 0, sizeof(item));
+	item.nType = ZEGO_CONFIG_HARDWARE_ENCODER;
+	item.config.enable.bEnable = 1;
+	CCommandQueue::GetInstance()->PostConfig(&item, 1);
 }
 
 extern "C" void ZEGODL_API enableHardwareDecoder()
 {
-	CZegoObject::GetZegoObject()->getEngine()->enableHardwareDecoder(true);
+	ZEGO_CONFIG_ITEM item;
+	memset(&item, 0, sizeof(item));
+	item.nType = ZEGO_CONFIG_HARDWARE_DECODER;
+	item.config.enable.bEnable = 1;
+	CCommandQueue::GetInstance()->PostConfig(&item, 1);
 }
 
 extern "C" void ZEGODL_API disableAEC()
 {
-	CZegoObject::GetZegoObject()->getEngine()->enableAEC(false);
+	CCommandQueue::GetInstance()->PostCommand(ENGINE_COMMAND_DISABLE_AEC);
 }
 
 extern "C" void ZEGODL_API disableANS()
 {
-	CZegoObject::GetZegoObject()->getEngine()->enableANS(false);
+	CCommandQueue::GetInstance()->PostCommand(ENGINE_COMMAND_DISABLE_ANS);
 }
 
 extern "C" void ZEGODL_API disableeAGC()
 {
-	CZegoObject::GetZegoObject()->getEngine()->enableAGC(false);
+	CCommandQueue::GetInstance()->PostCommand(ENGINE_COMMAND_DISABLE_AGC);
 }
 
 extern "C" void ZEGODL_API muteMicrophone()
 {
-	CZegoObject::GetZegoObject()->getEngine()->muteMicrophone(true);
+	CCommandQueue::GetInstance()->PostCommand(ENGINE_COMMAND_MUTE_MICROPHONE);
 }
 
-extern "C" void ZEGODL_API setAudioConfig(int profile, int codecid)
+extern "C" int ZEGODL_API setAudioConfig(int profile, int codecid)
 {
-	ZegoAudioConfig audioConfig = ZegoAudioConfig((ZegoAudioConfigPreset)profile);
-	audioConfig.codecID = (ZegoAudioCodecID)codecid;
-	CZegoObject::GetZegoObject()->getEngine()->setAudioConfig(audioConfig);
+	ZEGO_CONFIG_ITEM item;
+	memset(&item, 0, sizeof(item));
+	item.nType = ZEGO_CONFIG_AUDIO;
+	item.config.audio.nPreset = profile;
+	item.config.audio.nCodecID = codecid;
+	return CCommandQueue::GetInstance()->Run(&item, 1);
 }
 
 extern "C" void ZEGODL_API logOff()
 {
-	g_Logon = false;
+	CLogger::SetLevel(LOG_LEVEL_OFF);
+}
+
+// prints the wrapper log from nLevel up, LOG_LEVEL 0 debug 1 info (default) 2 warn 3 error 4 off
+extern "C" void ZEGODL_API setLogLevel(int nLevel)
+{
+	CLogger::SetLevel(nLevel);
 }
 
 
@@ -0,0 +1,54 @@
+#pragma once
+#include "ZegoConfig.h"
+#include "EngineQueue.h"
+
+enum ENGINE_COMMAND_TYPE
+{
+	ENGINE_COMMAND_ENABLE_VIDEO = ENGINE_COMMAND_VENDOR,
+	ENGINE_COMMAND_DISABLE_VIDEO,
+	ENGINE_COMMAND_DISABLE_AUDIO,
+	ENGINE_COMMAND_DISABLE_AEC,
+	ENGINE_COMMAND_DISABLE_ANS,
+	ENGINE_COMMAND_DISABLE_AGC,
+	ENGINE_COMMAND_MUTE_MICROPHONE,
+	ENGINE_COMMAND_MUTE_SPEAKER,
+	ENGINE_COMMAND_STOP_PREVIEW,
+	ENGINE_COMMAND_STOP_PLAYING_STREAM,
+	ENGINE_COMMAND_CUSTOM_VIDEO_CAPTURE,
+	ENGINE_COMMAND_CUSTOM_AUDIO_IO,
+	ENGINE_COMMAND_CAP_MEDIA,		// lpText, the media file
+	ENGINE_COMMAND_RECORDING_DEVICE,	// lpText, the device id
+	ENGINE_COMMAND_VIDEO_DEVICE,	// lpText, the device id
+	ENGINE_COMMAND_LOG_RECORDING_DEVICES,
+	ENGINE_COMMAND_LOG_VIDEO_DEVICES,
+	ENGINE_COMMAND_ENABLE_AUDIO,
+	ENGINE_COMMAND_CUSTOM_VIDEO_PUSH,	// custom video capture and the capture thread
+	ENGINE_COMMAND_CUSTOM_AUDIO_PUSH,	// nArgs, sample rate and channels of the pushed PCM
+};
+
+static_assert((int)ZEGO_CONFIG_PENDING == ENGINE_PENDING && (int)ZEGO_CONFIG_ERR_EXPIRED == ENGINE_ERR_EXPIRED,
+	"the queue reports ZEGO_CONFIG_RESULT");
+
+// the zego engine thread. every config export posts its command here, so
+// the python threads never sit in loginRoom/logoutRoom. ENGINE_COMMAND_LEAVE_CHANNEL
+// is logoutRoom.
+// createEngine/destroyZegoEngine stay on the caller thread, zego delivers its
+// callbacks to the thread that created the engine. destroyZegoEngine stops
+// the executor after it has drained the queue
+class CCommandQueue : public CEngineQueue<ZEGO_CONFIG_ITEM>
+{
+public:
+	static CCommandQueue* GetInstance();
+
+	// >0 ticket, <0 ZEGO_CONFIG_RESULT when the batch is refused before posting
+	int64_t PostConfig(const ZEGO_CONFIG_ITEM* lpItems, int nCount);
+
+protected:
+	int Execute(ENGINE_COMMAND& command) override;
+	bool TakesText(int nType) override;
+
+private:
+	CCommandQueue() {}
+
+	int ExecuteEngineCommand(ENGINE_COMMAND& command);
+};
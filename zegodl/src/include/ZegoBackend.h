@@ -0,0 +1,42 @@
+#pragma once
+#include "RtcBackend.h"
+#include <atomic>
+
+// the zego express engine behind the rtc_ exports. the config calls go
+// through CCommandQueue like the json exports, custom capture switches the
+// capturer to ZegoCustomVideoSourcePush which pulls from the core buffers
+class CZegoBackend : public IRtcBackend
+{
+public:
+	static CZegoBackend* GetInstance();
+
+	virtual const char* GetName() override { return "zego"; }
+	virtual const STATS_SCHEMA_SET& GetStatsSchemas() override;
+
+	virtual int CreateEngine(const char* lpAppId) override;
+	virtual void DestroyEngine() override;
+	virtual bool HasEngine() override { return m_bEngine.load(); }
+
+	virtual int JoinChannel(const char* lpChannelId, const char* lpUserId) override;
+	virtual int WaitJoinChannel(int nTimeoutMs) override;
+	virtual int LeaveChannel() override;
+
+	virtual int EnableVideo(bool bEnable) override;
+	virtual int EnableAudio(bool bEnable) override;
+	virtual int EnableDualStream(bool bEnable) override;
+	virtual int EnableHeadless(bool bEnable) override;
+	virtual int EnableRemoteVideoFrames(bool bEnable) override;
+	virtual int EnableAudioSink(bool bEnable, int nSampleRate, int nChannels) override;
+	virtual bool PullAudioFrame(int16_t* lpPcm, int nSamples, int nSampleRate, int nChannels) override;
+	virtual int EnableAudioRecording(bool bEnable, int nSampleRate, int nChannels) override;
+	virtual int SetVideoProfile(int nWidth, int nHeight, int nFps, int nBitrate) override;
+	virtual int SetAudioProfile(int nProfile, const char* lpCodec) override;
+
+	virtual int EnableCustomVideoCapture() override;
+	virtual int EnableCustomAudioCapture(int nSampleRate, int nChannels) override;
+
+private:
+	CZegoBackend();
+
+	std::atomic<bool> m_bEngine;
+};
@@ -0,0 +1,22 @@
+#pragma once
+#include "ChurnBench.h"
+#include <string>
+
+// the CChurnBench join/leave of CZegoObject, loginRoom waits for
+// ZEGO_ROOM_STATE_CONNECTED. logoutRoom detaches the event handler so there
+// is nothing to wait for after it and leave.ready stays empty
+class CZegoChurnTarget : public IChurnTarget
+{
+public:
+	CZegoChurnTarget(const std::string& roomID, const std::string& userID);
+
+	virtual const char* GetName() override { return "zego"; }
+	virtual void Join() override;
+	virtual bool WaitJoin(int nTimeoutMs) override;
+	virtual void Leave() override;
+	virtual int WaitLeave(int /*nTimeoutMs*/) override { return 0; }
+
+private:
+	std::string	m_strRoomID;
+	std::string	m_strUserID;
+};
@@ -0,0 +1,118 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// typed C ABI of the config exports. everything here is plain C so ctypes
+// mirrors it field by field, no json is parsed and nothing is allocated on
+// the way to the SDK.
+// bump ZEGO_CONFIG_ABI_VERSION whenever a struct below changes its layout,
+// applyConfig refuses a batch built against another version
+#define ZEGO_CONFIG_ABI_VERSION		1
+
+// express limits, room ids are at most 128 bytes and user ids 64
+#define ZEGO_MAX_ROOM_ID			128
+#define ZEGO_MAX_USER_ID			64
+
+#define ZEGO_MAX_VIDEO_DIMENSION	4096
+#define ZEGO_MAX_VIDEO_FPS			60
+
+// the values line up with AGORA_CONFIG_RESULT in agoradl so fleet scripts
+// share one table. the express setters return void, -4 (sdk error) never shows up
+enum ZEGO_CONFIG_RESULT
+{
+	ZEGO_CONFIG_PENDING = 1,			// pollCommand: still queued or running
+	ZEGO_CONFIG_OK = 0,
+	ZEGO_CONFIG_ERR_VERSION = -1,		// built against another ZEGO_CONFIG_ABI_VERSION
+	ZEGO_CONFIG_ERR_TYPE = -2,			// unknown nType
+	ZEGO_CONFIG_ERR_INVALID_ARG = -3,	// a field is out of range, or the json did not parse
+	ZEGO_CONFIG_ERR_SDK = -4,			// a posted engine command found no engine to run on
+	ZEGO_CONFIG_ERR_SKIPPED = -5,		// not applied, an other item of the batch is invalid
+	ZEGO_CONFIG_ERR_TIMEOUT = -6,		// waitCommand gave up, the command stays queued
+	ZEGO_CONFIG_ERR_EXPIRED = -7,		// the command ran, its result was overwritten by later ones
+};
+
+enum ZEGO_CONFIG_TYPE
+{
+	ZEGO_CONFIG_VIDEO = 1,				// setVideoConfig, capture and encode size are the same
+	ZEGO_CONFIG_ENABLE_VIDEO,			// camera and video publishing on/off
+	ZEGO_CONFIG_HARDWARE_ENCODER,		// enableHardwareEncoder
+	ZEGO_CONFIG_HARDWARE_DECODER,		// enableHardwareDecoder
+	ZEGO_CONFIG_AUDIO,					// setAudioConfig
+	ZEGO_CONFIG_AUDIO_PROCESSING,		// enableAEC / enableANS / enableAGC
+	ZEGO_CONFIG_LOGIN_ROOM,				// loginRoom and start publishing, keep it last in a batch
+	ZEGO_CONFIG_DUAL_STREAM,			// svc publishing, small views play the base layer
+	ZEGO_CONFIG_HEADLESS,				// custom render without engine render and no preview, before loginRoom
+	ZEGO_CONFIG_REMOTE_VIDEO_FRAMES,	// custom render feeds CVideoCompositor, before loginRoom
+	ZEGO_CONFIG_AUDIO_SINK,				// custom audio render pulled by CAudioSink, before loginRoom
+	ZEGO_CONFIG_AUDIO_RECORDING,		// the remote and the mixed audio data callbacks feed CAudioRecorder
+};
+
+typedef struct _ZEGO_VIDEO_CONFIG
+{
+	int32_t nWidth;
+	int32_t nHeight;
+	int32_t nFps;
+	int32_t nBitrate;	// kbps
+} ZEGO_VIDEO_CONFIG;
+
+typedef struct _ZEGO_ENABLE_CONFIG
+{
+	int32_t bEnable;
+} ZEGO_ENABLE_CONFIG;
+
+typedef struct _ZEGO_AUDIO_CONFIG
+{
+	int32_t nPreset;	// ZegoAudioConfigPreset
+	int32_t nCodecID;	// ZegoAudioCodecID
+} ZEGO_AUDIO_CONFIG;
+
+typedef struct _ZEGO_AUDIO_PROCESSING_CONFIG
+{
+	int32_t bAEC;
+	int32_t bANS;
+	int32_t bAGC;
+} ZEGO_AUDIO_PROCESSING_CONFIG;
+
+typedef struct _ZEGO_LOGIN_CONFIG
+{
+	char szRoomId[ZEGO_MAX_ROOM_ID + 1];
+	char szUserId[ZEGO_MAX_USER_ID + 1];	// also the user name and the stream id
+} ZEGO_LOGIN_CONFIG;
+
+typedef struct _ZEGO_AUDIO_RECORDING_CONFIG
+{
+	int32_t bEnable;
+	int32_t nSampleRate;	// 8000, 16000, 22050, 24000, 32000, 44100 or 48000
+	int32_t nChannels;		// 1 or 2
+} ZEGO_AUDIO_RECORDING_CONFIG;
+
+// one entry of an applyConfig batch, nType selects the member of config.
+// nResult is written back by applyConfig
+typedef struct _ZEGO_CONFIG_ITEM
+{
+	int32_t nType;		// ZEGO_CONFIG_TYPE
+	int32_t nResult;	// ZEGO_CONFIG_RESULT
+	union
+	{
+		ZEGO_VIDEO_CONFIG video;
+		ZEGO_ENABLE_CONFIG enable;
+		ZEGO_AUDIO_CONFIG audio;
+		ZEGO_AUDIO_PROCESSING_CONFIG audioProcessing;
+		ZEGO_LOGIN_CONFIG login;
+		ZEGO_AUDIO_RECORDING_CONFIG audioRecording;
+	} config;
+} ZEGO_CONFIG_ITEM;
+
+#ifdef __cplusplus
+// checks and applies ZEGO_CONFIG_ITEMs through CZegoObject. a batch is
+// validated as a whole first so a bad field leaves the engine untouched
+class CZegoConfig
+{
+public:
+	static int Validate(const ZEGO_CONFIG_ITEM& item);
+	static int Apply(ZEGO_CONFIG_ITEM& item);
+	static int ApplyBatch(ZEGO_CONFIG_ITEM* lpItems, int nCount);
+	// an id into a zeroed login array, a longer one fills it without a terminator and fails Validate
+	static void CopyId(char* lpId, size_t nSize, const char* lpText);
+};
+#endif
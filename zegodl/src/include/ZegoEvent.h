@@ -0,0 +1,80 @@
+#pragma once
+#include <stdint.h>
+
+// typed C ABI of the SDK events. the event handler writes one fixed size
+// record per callback into a preallocated ring, python drains it in batches
+// with pollEvents. nothing is allocated and no SDK thread ever waits on the
+// way in, a full ring drops the event and counts it.
+// bump ZEGO_EVENT_ABI_VERSION whenever ZEGO_EVENT changes its layout
+#define ZEGO_EVENT_ABI_VERSION		1
+
+// power of two, 4096 records are 1MB
+#define ZEGO_EVENT_CAPACITY			4096
+
+// bytes of szText including the terminating 0, fits the 128 byte room ids
+// and the 256 byte stream ids express allows up to 231 bytes
+#define ZEGO_EVENT_TEXT				232
+
+// the nArgs and szText of every type are listed next to it. the quality
+// callbacks report doubles, they are rounded to int
+enum ZEGO_EVENT_TYPE
+{
+	ZEGO_EVENT_DROPPED = 1,					// nArgs[0] events lost since the last poll, the ring was full
+	ZEGO_EVENT_DEBUG_ERROR,					// nArgs[0] errorCode, szText funcName
+	ZEGO_EVENT_ENGINE_STATE,				// nArgs[0] ZegoEngineState
+	ZEGO_EVENT_ROOM_STATE,					// nArgs[0] ZegoRoomState, [1] errorCode, szText roomID
+	ZEGO_EVENT_ROOM_USER_ADD,				// one per user, szText userID
+	ZEGO_EVENT_ROOM_USER_DELETE,			// one per user, szText userID
+	ZEGO_EVENT_ROOM_STREAM_ADD,				// one per stream, szText streamID
+	ZEGO_EVENT_ROOM_STREAM_DELETE,			// one per stream, szText streamID
+	ZEGO_EVENT_PLAYER_FIRST_VIDEO_FRAME,	// szText streamID
+	ZEGO_EVENT_PUBLISHER_VIDEO_SIZE,		// nArgs[0] width, [1] height, [2] ZegoPublishChannel
+	ZEGO_EVENT_PLAYER_VIDEO_SIZE,			// nArgs[0] width, [1] height, szText streamID
+	ZEGO_EVENT_PUBLISHER_QUALITY,			// nArgs[0] videoKBPS, [1] videoSendFPS, [2] rtt, szText streamID
+	ZEGO_EVENT_PLAYER_QUALITY,				// nArgs[0] videoKBPS, [1] videoRenderFPS, [2] rtt, szText streamID
+};
+
+// 256 bytes, no padding on any of the targets
+typedef struct _ZEGO_EVENT
+{
+	int32_t nType;			// ZEGO_EVENT_TYPE
+	int32_t nArgs[3];
+	int64_t nTimestampUs;	// steady_clock time the callback arrived
+	char szText[ZEGO_EVENT_TEXT];
+} ZEGO_EVENT;
+
+#ifdef __cplusplus
+#include "DropRing.h"
+#include <mutex>
+#include <string>
+
+// ZEGO_EVENTs on a CDropRing. the SDK threads never wait for the reader:
+// when the ring is full the event is dropped and the next poll starts with
+// a ZEGO_EVENT_DROPPED.
+// the records are allocated once with the ring, GetInstance is called from
+// createEngine so that happens before the first callback
+class CZegoEventRing
+{
+public:
+	static CZegoEventRing* GetInstance();
+
+	// fills nType and nTimestampUs, zeroes the rest
+	static void Init(ZEGO_EVENT& event, int nType);
+	// copies at most ZEGO_EVENT_TEXT - 1 bytes and terminates
+	static void SetText(ZEGO_EVENT& event, const std::string& strText);
+
+	// called on the SDK threads, false when the ring is full and the event was dropped
+	bool Push(const ZEGO_EVENT& event) { return m_ring.Push(event); }
+	int Poll(ZEGO_EVENT* lpEvents, int nMax);
+	uint64_t GetDropped() { return m_ring.GetDropped(); }
+
+private:
+	CZegoEventRing();
+
+	CDropRing<ZEGO_EVENT, ZEGO_EVENT_CAPACITY> m_ring;
+
+	// the reader side, python may poll from more than one thread
+	std::mutex m_lockPoll;
+	uint64_t m_nDroppedReported;
+};
+#endif
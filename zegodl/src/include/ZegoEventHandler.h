@@ -1,7 +1,14 @@
 #pragma once
 
+#include "types.h"
 #include "../zego/include/ZegoExpressSDK.h"
 #include "./ZegoCustomVideoSourceContext.h"
+#include "VideoCompositor.h"
+#include "VideoFrameExport.h"
+#include "AudioRecorder.h"
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 using namespace ZEGO::EXPRESS;
 
 
@@ -11,21 +18,28 @@ public:
 	CZegoEventHandler(void);
 	~CZegoEventHandler(void);
 
-	void SetMsgReceiver(HWND hWnd = NULL);
-	HWND GetMsgReceiver() { return m_hMainWnd; };
+	void ResetJoinState();
+	int WaitJoinChannel(int nTimeoutMs);
+	int GetLoginElapsed();
 
 	virtual void onDebugError(int errorCode, const std::string& funcName, const std::string& info)override;
 	virtual void onEngineStateUpdate(ZegoEngineState state);
 	virtual void onRoomStateUpdate(const std::string& roomID, ZegoRoomState state, int errorCode, const std::string& extendedData);
 	virtual void onRoomUserUpdate(const std::string& roomID, ZegoUpdateType updateType, const std::vector<ZegoUser>& userList);
 	virtual void onRoomStreamUpdate(const std::string &roomID, ZegoUpdateType updateType, const std::vector<ZegoStream> &streamList);
+	virtual void onPlayerRecvVideoFirstFrame(const std::string& streamID);
 	virtual void onPublisherVideoSizeChanged(int, int, ZegoPublishChannel);
 	virtual void onPlayerVideoSizeChanged(const std::string &, int width, int height);
 	virtual void onPublisherQualityUpdate(const std::string &streamID, const ZegoPublishStreamQuality& quality);
 	virtual void onPlayerQualityUpdate(const std::string &streamID, const ZegoPlayStreamQuality& quality);
+	virtual void onRemoteSoundLevelUpdate(const std::unordered_map<std::string, float>& soundLevels);
 
 private:
-	HWND  m_hMainWnd;
+	std::mutex m_joinMutex;
+	std::condition_variable m_joinCond;
+	bool m_bJoined = false;
+	int  m_nJoinElapsed = -1;
+	std::chrono::steady_clock::time_point m_loginTime;
 };
 
 
@@ -36,9 +50,14 @@ public:
 			//dataInterface->onCapturedVideoFrameRawData(data, dataLength, param, flipMode);
 		int i = 0;
 	}
+	// every decoded remote frame while custom render is on, for CVideoCompositor and CVideoFrameExport while they run
 	void onRemoteVideoFrameRawData(unsigned char ** data, unsigned int* dataLength, ZegoVideoFrameParam param, const std::string& streamID) override {
-		//dataInterface->onRemoteVideoFrameRawData(data, dataLength, param, streamID);
-		int i = 0;
+		CVideoCompositor* lpCompositor = CVideoCompositor::GetInstance();
+		CVideoFrameExport* lpExport = CVideoFrameExport::GetInstance();
+		if ((!lpCompositor->IsRunning() && !lpExport->IsRunning()) || param.format != ZEGO_VIDEO_FRAME_FORMAT_I420)
+			return;
+		lpCompositor->PutFrame(streamID, data[0], param.strides[0], data[1], param.strides[1], data[2], param.strides[2], param.width, param.height);
+		lpExport->PutFrame(streamID, data[0], param.strides[0], data[1], param.strides[1], data[2], param.strides[2], param.width, param.height);
 	}
 
 	void onRemoteVideoFrameEncodedData(const unsigned char* data, unsigned int dataLength, ZegoVideoEncodedFrameParam param, unsigned long long referenceTimeMillisecond, const std::string& streamID) override {
@@ -47,6 +66,28 @@ public:
 	}
 };
 
+// the audio data callbacks while CAudioRecorder records. this SDK hands out no
+// audio per stream, only the mix of every played stream and that mix with the capture
+class CZegoAudioDataHandler : public IZegoAudioDataHandler {
+public:
+
+	void onRemoteAudioData(const unsigned char* data, unsigned int dataLength, ZegoAudioFrameParam param) override {
+		putFrame("remote", data, dataLength, param);
+	}
+
+	void onMixedAudioData(const unsigned char* data, unsigned int dataLength, ZegoAudioFrameParam param) override {
+		putFrame("mixed", data, dataLength, param);
+	}
+
+private:
+	void putFrame(const char* lpId, const unsigned char* data, unsigned int dataLength, ZegoAudioFrameParam param) {
+		if (!CAudioRecorder::IsRecording())
+			return;
+		int nChannels = param.channel == ZEGO_AUDIO_CHANNEL_STEREO ? 2 : 1;
+		CAudioRecorder::GetInstance()->PutFrame(lpId, data, (int)(dataLength / (2 * nChannels)), nChannels, (int)param.sampleRate);
+	}
+};
+
 class CustomVideoCapturer: public IZegoCustomVideoCaptureHandler, public ZegoCustomVideoSourceContext{
 
 public:
@@ -1,22 +1,31 @@
 #pragma once
+#include "types.h"
 #include "../zego/include/ZegoExpressSDK.h"
 #include "ZegoEventHandler.h"
+#include "ParticipantRegistry.h"
+#include "SpeakerScheduler.h"
 #include <string>
-
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+#ifdef ZEGODL_MOCK_SDK
+#include "MockZegoExpressEngine.h"
+typedef MockZegoExpressSDK ZegoSDK;
+#else
+typedef ZEGO::EXPRESS::ZegoExpressSDK ZegoSDK;
 #ifdef _M_IX86
 #pragma comment(lib, "../zego/lib/ZegoExpressEngine.lib")
 #elif defined _M_X64
 #pragma comment(lib, "../zego/lib/x64/ZegoExpressEngine.lib")
 #endif
+#endif
 
-#include "types.h"
 
 using namespace ZEGO::EXPRESS;
 using namespace ZEGO;
 using namespace std;
 
-extern std::atomic<bool> g_Logon;
-
 class CZegoObject 
 {
 public:
@@ -25,7 +34,6 @@ public:
 	static CZegoObject *GetZegoObject();
 	void destroyZegoEngine();
 
-	void SetMainWnd(HWND hMainWnd);
 
 	virtual int createEngine(LPVOID lpExtInfo, string  &strOutput);
 	virtual int sharedEngine(LPVOID lpExtInfo, string &strOutput);
@@ -39,6 +47,7 @@ public:
 	virtual int enableEncoder(LPVOID lpExtInfo, string &strOutput);
 	virtual int enableDecoder(LPVOID lpExtInfo, string &strOutput);
 	virtual int disableAudio();
+	int enableAudio(bool bEnable);
 	virtual int disableVideo();
 	virtual int videoDrawing(LPVOID lpExtInfo, string &strOutput);
 
@@ -50,8 +59,11 @@ public:
 	int destroyEngine();
 
 	int setVideoConfig(LPVOID lpExtInfo, string &strOutput);
+	int setVideoConfig(int nWidth, int nHeight, int nFps, int nBitrate);
 	//int startLocalAudio();
 	int loginRoom(LPVOID lpExtInfo, string &strOutput);
+	int loginRoom(const std::string &roomId, const std::string &userId);
+	int waitLoginRoom(int nTimeoutMs);
 	int startPreview();
 
 	int logoutRoom();
@@ -60,9 +72,27 @@ public:
 
 	void enableCustomVideoCapture();
 	void startCapMedia(string path);
+	void startCapPush();
 
 	void enableCustomAudioIO();
+	void enableCustomAudioIO(ZegoAudioSourceType sourceType);
+	// reconciles every stream, the room updates only touch the streams they change
 	void updateStatus();
+	// publish the stream with svc layers, small views play the base layer
+	void enableDualStream(bool bEnable);
+	// no preview and the remote streams go to the custom renderer, before loginRoom
+	void enableHeadless(bool bEnable);
+	// the decoded remote frames go to CVideoCompositor, before loginRoom
+	void enableRemoteVideoFrames(bool bEnable);
+	// the remote audio is fetched by CAudioSink instead of played, before loginRoom
+	void enableAudioSink(bool bEnable);
+	void fetchAudioSink(int16_t* lpPcm, int nSamples, int nSampleRate, int nChannels);
+	// the remote mix and the mix with the capture go to CAudioRecorder, in and out of a room
+	void enableAudioRecording(bool bEnable, int nSampleRate, int nChannels);
+	// keeps the quality of streamID, plays the other layer if its view was resized
+	void onPlayerQualityUpdate(const std::string &streamID, const ZegoPlayStreamQuality &quality);
+	// moves the views to the streams that speak most
+	void onRemoteSoundLevelUpdate(const std::unordered_map<std::string, float> &soundLevels);
 
 	IZegoExpressEngine* getEngine();
 protected:
@@ -75,13 +105,39 @@ private:
 	std::shared_ptr<CZegoEventHandler> m_pgEventHandler;
 	std::shared_ptr<CZegoCustomVideoRenderer> m_pgVideoRenderer;
 	std::shared_ptr<CustomVideoCapturer> m_pgVideoCap;
+	std::shared_ptr<CZegoAudioDataHandler> m_pgAudioDataHandler;
+
+	void applyCustomRender();
 
 
 	std::string  m_roomId;
 	std::string  m_localUserID;
-	std::vector<ZegoStream> m_zegoStreamList;
 	bool m_bstopPlayingStream = false;
 	bool m_bDisableVideo = false;
 	bool m_bDisableAudio = false;
+	bool m_bDualStream = true;
+	bool m_bHeadless = false;
+	bool m_bRemoteVideoFrames = false;
+	// custom audio IO is on for the capture, the sink shares it
+	bool m_bCustomAudioIO = false;
+	bool m_bAudioSink = false;
+	bool m_bAudioRecording = false;
+	// every remote stream of the room: the view it should be shown in and what
+	// the SDK was last told, reconcileStream issues only the calls in between.
+	// hRenderView is the canvas of the running play, PARTICIPANT_FLAG_LOW_STREAM
+	// the base layer, a new layer needs a restart
+	CParticipantRegistry* m_lpRegistry;
+	// the room updates come in batches on the worker of the registry, the
+	// script thread and the SDK callbacks change the streams under this lock
+	std::mutex m_lockStreams;
+	CSpeakerScheduler m_scheduler;
+
+	void applyVideoCodec();
+	void onStreamBatch(const std::vector<PARTICIPANT_EVENT> &events);
+	void addStream(const std::string &streamID);
+	void removeStream(const std::string &streamID);
+	void reconcileStream(const std::string &streamID, PARTICIPANT_INFO &info);
+	void updateStatusLocked();
+	void freeStreamViews();
 };
 
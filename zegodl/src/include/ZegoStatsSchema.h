@@ -0,0 +1,12 @@
+#pragma once
+#include "StatsRecorder.h"
+
+enum STATS_KIND
+{
+	STATS_PUBLISHER = 1,	// ZegoPublishStreamQuality, keyed by stream id
+	STATS_PLAYER,			// ZegoPlayStreamQuality, keyed by stream id
+};
+
+// the columns of every kind, the callbacks in ZegoEventHandler.cpp fill
+// nValues in this order
+extern const STATS_SCHEMA_SET g_zegoStatsSchemas;
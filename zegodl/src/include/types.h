@@ -1,6 +1,6 @@
 #ifndef TYPES_H
 #define TYPES_H
+#include "Platform.h"
 
-#define ZHANDLE void*
 #define ZEGODL_EXPORTS
 #endif
\ No newline at end of file